@@ -333,6 +333,57 @@ typedef enum cyaml_flag {
 	 * and precedence.
 	 */
 	CYAML_FLAG_SCALAR_QUOTE_DOUBLE = (1 << 13),
+	/**
+	 * Store a sequence of mappings as columns.
+	 *
+	 * Normally a \ref CYAML_SEQUENCE of \ref CYAML_MAPPING entries is
+	 * stored as an array of structures.  With this flag, the sequence's
+	 * allocation is the same size, but it holds a contiguous array
+	 * (column) of each member of the structure, in member order.  For
+	 * a sequence with `count` entries, the column for a member starts
+	 * at `count` times the member's offset in the structure.  Use
+	 * \ref CYAML_COLUMN to get the address of a column.
+	 *
+	 * This may only be used on \ref CYAML_SEQUENCE values with
+	 * \ref CYAML_FLAG_POINTER, whose entries are non-pointer
+	 * \ref CYAML_MAPPING values with no validation callback.  Otherwise
+	 * loading, saving, and copying fail with
+	 * \ref CYAML_ERR_BAD_TYPE_IN_SCHEMA.
+	 *
+	 * The sequence's validation callback is given the columnar data.
+	 *
+	 * \note Columnar sequences are not loaded in parallel, even with
+	 *       \ref CYAML_CFG_PARALLEL set.
+	 */
+	CYAML_FLAG_COLUMNAR = (1 << 14),
+	/**
+	 * Load a mapping field's value lazily.
+	 *
+	 * By default, a value is fully decoded when it is loaded.  With this
+	 * flag, the loader skips over the value, and stores a
+	 * \ref cyaml_lazy_t in the field's structure member, recording where
+	 * the value's YAML is in the input.  The value can then be decoded on
+	 * demand with \ref cyaml_lazy_get.
+	 *
+	 * This may only be used on mapping fields with \ref CYAML_MAPPING,
+	 * \ref CYAML_SEQUENCE, or \ref CYAML_SEQUENCE_FIXED values, that have
+	 * \ref CYAML_FLAG_POINTER.  Use \ref CYAML_FIELD_MAPPING_LAZY or
+	 * \ref CYAML_FIELD_SEQUENCE_LAZY to create such fields.  Otherwise
+	 * loading and saving fail with \ref CYAML_ERR_BAD_TYPE_IN_SCHEMA.
+	 *
+	 * Lazy values refer to the client's input, so they can only be
+	 * loaded from data buffers, for example with \ref cyaml_load_data.
+	 * The input must stay valid and unchanged for as long as the lazy
+	 * values are used.  Loading a lazy value from a file fails with
+	 * \ref CYAML_ERR_LAZY_NO_INPUT.  Missing lazy values are left
+	 * absent; any default value in the schema is not used.
+	 *
+	 * \note A lazy value may not be an alias, or be inside an alias,
+	 *       and it may only contain aliases of anchors that it contains.
+	 *       Such aliases fail with \ref CYAML_ERR_ALIAS when loading, or
+	 *       \ref CYAML_ERR_INVALID_ALIAS when decoding, respectively.
+	 */
+	CYAML_FLAG_LAZY     = (1 << 15),
 } cyaml_flag_e;
 
 /**
@@ -356,6 +407,19 @@ typedef struct cyaml_bitdef {
 	uint8_t bits;     /**< Maximum bits available for value. */
 } cyaml_bitdef_t;
 
+/**
+ * A lazily loaded value.
+ *
+ * This is the client data for mapping fields with \ref CYAML_FLAG_LAZY.
+ * It records where the value's YAML is in the input, and is decoded with
+ * \ref cyaml_lazy_get.  An absent or null value has a NULL `input`.
+ */
+typedef struct cyaml_lazy {
+	const uint8_t *input; /**< Start of the value's YAML in the input. */
+	size_t len;           /**< Length of the value's YAML in bytes. */
+	size_t column;        /**< Column the value's YAML starts at. */
+} cyaml_lazy_t;
+
 /**
  * Value validation callback function for \ref CYAML_INT.
  *
@@ -876,6 +940,158 @@ typedef enum cyaml_cfg_flags {
 	 * Log any ignored mapping keys at \ref CYAML_LOG_WARNING level.
 	 */
 	CYAML_CFG_IGNORED_KEY_WARNING = (1 << 6),
+	/**
+	 * When loading, allocate the loaded data from an arena.
+	 *
+	 * Rather than making a separate allocation for every pointer value,
+	 * the loaded data is allocated from large chunks.  The chunk size
+	 * may be set with the \ref cyaml_config_t `arena_chunk_size` member.
+	 *
+	 * Data loaded with this flag set must be freed with
+	 * \ref cyaml_arena_free, rather than \ref cyaml_free, and it must
+	 * not be modified in ways that would require individual pointer values
+	 * to be freed or reallocated.
+	 *
+	 * \note This only affects loading.  For example, data created by
+	 *       \ref cyaml_copy is freed with \ref cyaml_free as normal,
+	 *       unless \ref CYAML_CFG_COPY_BLOCK is set.
+	 */
+	CYAML_CFG_ARENA               = (1 << 7),
+	/**
+	 * When loading, don't trim unused space from sequence allocations.
+	 *
+	 * The allocations for \ref CYAML_SEQUENCE values grow geometrically
+	 * while they're loaded, so they usually end up with space for more
+	 * entries than the sequence has.  By default the allocation is shrunk
+	 * to fit at the end of the sequence.  Setting this avoids the cost of
+	 * that reallocation, for clients that don't mind the extra memory.
+	 */
+	CYAML_CFG_SEQUENCE_SLACK      = (1 << 8),
+	/**
+	 * When loading a file, map it into memory rather than reading it.
+	 *
+	 * The mapped file is parsed in the same way as \ref cyaml_load_data
+	 * parses a buffer, which avoids copying the file through `stdio`
+	 * buffers.  This can make loading large files faster.
+	 *
+	 * Files that can't be mapped, such as pipes, are read as normal.
+	 * This flag is ignored on platforms without `mmap`.
+	 *
+	 * \note The file must not be truncated while it is being loaded.
+	 */
+	CYAML_CFG_MMAP                = (1 << 9),
+	/**
+	 * When loading, split a large top level sequence across threads.
+	 *
+	 * This applies to documents whose top level value is a
+	 * \ref CYAML_SEQUENCE, written as a block sequence.  The input is
+	 * split into chunks at top level sequence entries, the chunks are
+	 * loaded on separate threads, and the loaded entries are joined into
+	 * a single sequence allocation.  The number of threads is set with
+	 * the \ref cyaml_config_t `load_threads` member.
+	 *
+	 * If the document can't be split, or a chunk fails to load on its
+	 * own, the document is loaded serially as normal.  For example, an
+	 * alias to an anchor in a different chunk makes the document load
+	 * serially.  Loaded data is the same as it would be without the flag.
+	 *
+	 * This is only used by \ref cyaml_load_data and \ref cyaml_load_file,
+	 * and files are only split if \ref CYAML_CFG_MMAP is also set.  It is
+	 * ignored for \ref CYAML_CFG_ARENA loads, for top level sequences
+	 * with validation callbacks on the sequence or on any value within
+	 * its entries, and for loads with any of the \ref cyaml_config_t
+	 * resource limits set.  This means validation callbacks are only
+	 * ever called on the client's thread, once for each value.
+	 *
+	 * When copying with \ref CYAML_CFG_COPY_BLOCK also set, the entries
+	 * of large sequences at any depth are cloned across threads.  Each
+	 * thread clones into its own part of the single allocation, so the
+	 * allocator is only called from the client's thread.  Columnar
+	 * sequences are cloned serially.
+	 *
+	 * \note For loads, the \ref cyaml_config_t `mem_fn` must be
+	 *       thread-safe.
+	 * \note Nothing is logged for chunk loads, only for the serial load,
+	 *       and nothing is logged for entries cloned on other threads.
+	 */
+	CYAML_CFG_PARALLEL            = (1 << 10),
+	/**
+	 * When loading from memory, use CYAML's native scanner rather
+	 * than libyaml's parser.
+	 *
+	 * The native scanner handles a common subset of YAML: a single
+	 * document of block mappings and sequences, single line plain and
+	 * quoted scalars, single line flow collections, and comments.
+	 * It produces the same events as libyaml for that subset, with
+	 * less overhead.  Events are marked with the same lines and
+	 * columns, so errors are reported at the same positions.
+	 *
+	 * The whole input is checked before loading starts.  If it uses
+	 * anything else, for example tags, anchors, aliases, block scalars,
+	 * or multi-line scalars, it is loaded with libyaml as normal.
+	 *
+	 * This is used by \ref cyaml_load_data, by \ref cyaml_load_file
+	 * when \ref CYAML_CFG_MMAP is set, and by \ref cyaml_loader_load_data.
+	 * It is ignored for streams.
+	 */
+	CYAML_CFG_NATIVE_SCANNER      = (1 << 11),
+	/**
+	 * When copying, make the copy in a single allocation.
+	 *
+	 * \ref cyaml_copy walks the data once to find the size of everything
+	 * it would allocate, then it makes one allocation of that size and
+	 * clones everything into it.  This is much cheaper than making a
+	 * separate allocation for every pointer value.
+	 *
+	 * Data copied with this flag set must be freed with
+	 * \ref cyaml_arena_free, rather than \ref cyaml_free, and it must
+	 * not be modified in ways that would require individual pointer values
+	 * to be freed or reallocated.
+	 *
+	 * The top level schema value must have \ref CYAML_FLAG_POINTER set,
+	 * otherwise \ref cyaml_copy fails with
+	 * \ref CYAML_ERR_TOP_LEVEL_NON_PTR.
+	 *
+	 * If \ref CYAML_CFG_PARALLEL is also set, large sequences are
+	 * cloned across threads.
+	 */
+	CYAML_CFG_COPY_BLOCK          = (1 << 12),
+	/**
+	 * When loading with \ref CYAML_CFG_ARENA, intern string values.
+	 *
+	 * Every \ref CYAML_STRING value with \ref CYAML_FLAG_POINTER set
+	 * that has the same string as an earlier one in the document shares
+	 * the earlier value's allocation.  This saves memory for documents
+	 * that repeat the same strings many times.
+	 *
+	 * Interned strings must be treated as immutable, since changing one
+	 * value would change every value with the same string.  They are
+	 * freed along with the rest of the document by \ref cyaml_arena_free.
+	 *
+	 * This is ignored without \ref CYAML_CFG_ARENA, because the shared
+	 * allocations can't be freed individually by \ref cyaml_free.
+	 * Copies made by \ref cyaml_copy have their own copy of every string.
+	 */
+	CYAML_CFG_INTERN              = (1 << 13),
+	/**
+	 * When saving to memory, use CYAML's native emitter rather than
+	 * libyaml's emitter.
+	 *
+	 * The native emitter handles a common subset of YAML: a single
+	 * document with a mapping or sequence at the top level, block and
+	 * flow collections, and plain, single quoted and double quoted
+	 * scalars made of printable ASCII characters.  It writes the same
+	 * output as libyaml for that subset, straight into the output
+	 * buffer, without making a libyaml event for every value.
+	 *
+	 * If the document needs anything else, for example literal or
+	 * folded scalars, or scalars with other characters, the output is
+	 * thrown away and the document is saved with libyaml as normal.
+	 *
+	 * This is used by \ref cyaml_save_data and \ref cyaml_saver_save_data.
+	 * It is ignored for files and streams.
+	 */
+	CYAML_CFG_NATIVE_EMITTER      = (1 << 14),
 } cyaml_cfg_flags_t;
 
 /**
@@ -917,6 +1133,32 @@ typedef enum cyaml_err {
 	CYAML_ERR_LIBYAML_EVENT_INIT,    /**< Failed to initialise libyaml. */
 	CYAML_ERR_LIBYAML_EMITTER,       /**< Error inside libyaml emitter. */
 	CYAML_ERR_LIBYAML_PARSER,        /**< Error inside libyaml parser. */
+	CYAML_ERR_BAD_PARAM_NULL_LOADER, /**< Client gave NULL loader arg. */
+	CYAML_ERR_BAD_PARAM_NULL_SAVER,  /**< Client gave NULL saver arg. */
+	CYAML_ERR_BAD_PARAM_NULL_CALLBACK, /**< Client gave NULL callback. */
+	CYAML_ERR_BAD_LOADER_STATE,      /**< Loader can't do that right now. */
+	CYAML_NEED_MORE,                 /**< Loader needs more input. This
+	                                  *   is not an error; see
+	                                  *   \ref cyaml_loader_feed. */
+	CYAML_ERR_LAZY_NO_INPUT,         /**< Lazy value needs data input. */
+	CYAML_ERR_BINARY_INVALID,        /**< Binary image is not valid. */
+	CYAML_ERR_BINARY_SCHEMA,         /**< Binary image schema mismatch. */
+	CYAML_ERR_LIMIT_ALIAS_EVENTS,    /**< Too many alias events replayed.
+	                                  *   See `max_alias_events` in
+	                                  *   \ref cyaml_config_t. */
+	CYAML_ERR_LIMIT_MEMORY,          /**< Too many bytes allocated.
+	                                  *   See `max_alloc_bytes` in
+	                                  *   \ref cyaml_config_t. */
+	CYAML_ERR_LIMIT_DEPTH,           /**< Values nested too deeply.
+	                                  *   See `max_depth` in
+	                                  *   \ref cyaml_config_t. */
+	CYAML_ERR_LIMIT_INPUT_SIZE,      /**< Too much YAML input.
+	                                  *   See `max_input_size` in
+	                                  *   \ref cyaml_config_t. */
+	CYAML_ERR_PATCH_UNSUPPORTED,     /**< Changes can't be patched into
+	                                  *   the input.  See
+	                                  *   \ref cyaml_save_patch. */
+	CYAML_ERR_FILE_WRITE,            /**< Failed to write file. */
 	CYAML_ERR__COUNT,                /**< Count of CYAML return codes.
 	                                  *   This is **not a valid return
 	                                  *   code** itself.
@@ -1650,6 +1892,64 @@ typedef enum cyaml_err {
 		} \
 	)
 
+/**
+ * Mapping schema helper macro for lazily loaded keys with
+ * \ref CYAML_MAPPING type.
+ *
+ * The structure member must be a \ref cyaml_lazy_t.  The field's value
+ * schema is a \ref CYAML_FLAG_POINTER mapping, which can be given to
+ * \ref cyaml_lazy_get to decode the value.  See \ref CYAML_FLAG_LAZY.
+ *
+ * \param[in]  _key        String defining the YAML mapping key for this value.
+ * \param[in]  _flags      Any behavioural flags relevant to this value.
+ * \param[in]  _structure  The structure corresponding to the containing mapping.
+ * \param[in]  _member     The \ref cyaml_lazy_t member in _structure for this
+ *                         mapping value.
+ * \param[in]  _type       The C type of structure corresponding to mapping.
+ * \param[in]  _fields     Pointer to mapping fields schema array.
+ */
+#define CYAML_FIELD_MAPPING_LAZY( \
+		_key, _flags, _structure, _member, _type, _fields) \
+{ \
+	.key = _key, \
+	.data_offset = offsetof(_structure, _member), \
+	.value = { \
+		CYAML_VALUE_MAPPING((_flags) | CYAML_FLAG_POINTER | \
+				CYAML_FLAG_LAZY, _type, _fields), \
+	}, \
+}
+
+/**
+ * Mapping schema helper macro for lazily loaded keys with
+ * \ref CYAML_SEQUENCE type.
+ *
+ * The structure member must be a \ref cyaml_lazy_t.  The field's value
+ * schema is a \ref CYAML_FLAG_POINTER sequence, which can be given to
+ * \ref cyaml_lazy_get to decode the value.  The sequence's entry count
+ * is returned by \ref cyaml_lazy_get, rather than stored in the structure.
+ * See \ref CYAML_FLAG_LAZY.
+ *
+ * \param[in]  _key        String defining the YAML mapping key for this value.
+ * \param[in]  _flags      Any behavioural flags relevant to this value.
+ * \param[in]  _structure  The structure corresponding to the mapping.
+ * \param[in]  _member     The \ref cyaml_lazy_t member in _structure for this
+ *                         mapping value.
+ * \param[in]  _type       The C type of sequence **entries**.
+ * \param[in]  _entry      Pointer to schema for the **entries** in sequence.
+ * \param[in]  _min        Minimum number of sequence entries required.
+ * \param[in]  _max        Maximum number of sequence entries required.
+ */
+#define CYAML_FIELD_SEQUENCE_LAZY( \
+		_key, _flags, _structure, _member, _type, _entry, _min, _max) \
+{ \
+	.key = _key, \
+	.data_offset = offsetof(_structure, _member), \
+	.value = { \
+		CYAML_VALUE_SEQUENCE((_flags) | CYAML_FLAG_POINTER | \
+				CYAML_FLAG_LAZY, _type, _entry, _min, _max), \
+	}, \
+}
+
 /**
  * Mapping schema helper macro for keys with \ref CYAML_IGNORE type.
  *
@@ -1690,6 +1990,19 @@ typedef enum cyaml_err {
  */
 #define CYAML_ARRAY_LEN(_a) ((sizeof(_a)) / (sizeof(_a[0])))
 
+/**
+ * Helper macro for getting a column of a \ref CYAML_FLAG_COLUMNAR sequence.
+ *
+ * \param[in] _data       The sequence data.
+ * \param[in] _count      The sequence entry count.
+ * \param[in] _structure  The structure corresponding to the entry mapping.
+ * \param[in] _member     The member in _structure to get the column of.
+ * \return Pointer to the first of `_count` consecutive `_member` values.
+ */
+#define CYAML_COLUMN(_data, _count, _structure, _member) \
+	((void *)((char *)(_data) + \
+			(size_t)(_count) * offsetof(_structure, _member)))
+
 /** CYAML logging levels. */
 typedef enum cyaml_log_e {
 	CYAML_LOG_DEBUG,   /**< Debug level logging. */
@@ -1735,6 +2048,173 @@ typedef void * (*cyaml_mem_fn_t)(
 		void *ptr,
 		size_t size);
 
+/**
+ * YAML event types, for \ref cyaml_stats_t and \ref cyaml_trace_fn_t.
+ */
+typedef enum cyaml_event_type {
+	CYAML_EVENT_NONE,           /**< No event. */
+	CYAML_EVENT_STREAM_START,   /**< Start of stream. */
+	CYAML_EVENT_STREAM_END,     /**< End of stream. */
+	CYAML_EVENT_DOC_START,      /**< Start of document. */
+	CYAML_EVENT_DOC_END,        /**< End of document. */
+	CYAML_EVENT_ALIAS,          /**< Alias. */
+	CYAML_EVENT_SCALAR,         /**< Scalar value. */
+	CYAML_EVENT_SEQUENCE_START, /**< Start of sequence. */
+	CYAML_EVENT_SEQUENCE_END,   /**< End of sequence. */
+	CYAML_EVENT_MAPPING_START,  /**< Start of mapping. */
+	CYAML_EVENT_MAPPING_END,    /**< End of mapping. */
+	CYAML_EVENT__COUNT,         /**< Count of event types. */
+} cyaml_event_type_t;
+
+/**
+ * CYAML statistics.
+ *
+ * Given to CYAML in the \ref cyaml_config_t `stats` member.  CYAML adds
+ * to the counters as it loads, saves, copies and frees data, so the client
+ * should zero the structure before use, and can keep totals over many
+ * calls.  The structure must not be shared between calls that run at the
+ * same time.
+ *
+ * \note Statistics can be compiled out of the library entirely, in which
+ *       case the structure is not updated.
+ */
+typedef struct cyaml_stats {
+	/**
+	 * Count of events by type.
+	 *
+	 * When loading, this counts the events handled, including any that
+	 * were replayed for aliases.  When saving, it counts emitted events.
+	 */
+	uint64_t events[CYAML_EVENT__COUNT];
+	uint64_t allocs;       /**< Allocation and reallocation calls. */
+	uint64_t alloc_bytes;  /**< Bytes requested by `allocs`. */
+	uint64_t frees;        /**< Calls to free allocations. */
+	uint64_t anchors;      /**< Number of anchors recorded. */
+	uint64_t aliases;      /**< Number of aliases replayed. */
+	uint64_t ignored_keys; /**< Number of mapping keys ignored. */
+	/**
+	 * Number of chunks of sequence entries loaded or copied on
+	 * parallel threads.
+	 *
+	 * This stays zero for loads and copies that are done serially,
+	 * including parallel loads that fall back to loading serially.
+	 */
+	uint64_t parallel_chunks;
+	/** Total time spent in load and save calls, in nanoseconds. */
+	uint64_t total_ns;
+	/**
+	 * Time spent parsing and emitting YAML, in libyaml or the native
+	 * scanner, in nanoseconds.
+	 *
+	 * The rest of `total_ns` is time spent handling the schema and
+	 * client data.
+	 */
+	uint64_t libyaml_ns;
+	/** Maximum depth of the load or save state stack. */
+	uint32_t stack_max;
+} cyaml_stats_t;
+
+/** CYAML trace points, for \ref cyaml_trace_fn_t. */
+typedef enum cyaml_trace {
+	CYAML_TRACE_EVENT_BEGIN, /**< Started handling a loaded event. */
+	CYAML_TRACE_EVENT_END,   /**< Finished handling a loaded event. */
+} cyaml_trace_t;
+
+/**
+ * CYAML trace callback.
+ *
+ * Clients may implement this to feed tracing systems.  When loading, it
+ * is called before and after each event is handled.  Runs of entries in
+ * sequences of numbers may be handled between a single pair of calls.
+ *
+ * \param[in] trace  The trace point.
+ * \param[in] ctx    Client's private trace context.
+ * \param[in] type   The type of event being handled.
+ */
+typedef void (*cyaml_trace_fn_t)(
+		cyaml_trace_t trace,
+		void *ctx,
+		cyaml_event_type_t type);
+
+/**
+ * Opaque compiled CYAML schema.
+ *
+ * Created by \ref cyaml_schema_compile, and given to CYAML functions in
+ * the \ref cyaml_config_t `compiled_schema` member.
+ */
+typedef struct cyaml_schema_compiled cyaml_schema_compiled_t;
+
+/**
+ * Opaque CYAML loader.
+ *
+ * Created by \ref cyaml_loader_create, to load many documents while
+ * reusing the loader's internal allocations.
+ */
+typedef struct cyaml_loader cyaml_loader_t;
+
+/**
+ * Opaque CYAML saver.
+ *
+ * Created by \ref cyaml_saver_create, to save many documents while
+ * reusing the saver's internal allocations.
+ */
+typedef struct cyaml_saver cyaml_saver_t;
+
+/**
+ * CYAML stream document callback.
+ *
+ * Given to \ref cyaml_load_stream_file and \ref cyaml_load_stream_data,
+ * and called once for each document in the stream, as soon as the document
+ * has been loaded.
+ *
+ * The document's data is owned by the client from the point this is called,
+ * even if the callback returns an error.  It should be freed in the same way
+ * as data from \ref cyaml_load_data.
+ *
+ * \param[in] ctx        Client's private stream context.
+ * \param[in] data       The caller-owned loaded data for the document.
+ *                       May be `NULL`, as with \ref cyaml_load_data.
+ * \param[in] seq_count  If top level type is sequence, this is the entry
+ *                       count, otherwise it is zero.
+ * \return \ref CYAML_OK to continue loading the stream, or an error code
+ *         to stop loading.  Any error code is returned to the client.
+ */
+typedef cyaml_err_t (*cyaml_doc_fn_t)(
+		void *ctx,
+		cyaml_data_t *data,
+		unsigned seq_count);
+
+/**
+ * CYAML save output write callback.
+ *
+ * Given to \ref cyaml_save_stream, and called with each piece of the
+ * serialised YAML output, in order.  The output is buffered, so this is
+ * called with large pieces of output, rather than for every value.
+ *
+ * \param[in] ctx   Client's private write context.
+ * \param[in] data  The bytes to write.  Only valid during the call.
+ * \param[in] len   Number of bytes to write.
+ * \return \ref CYAML_OK if all the bytes were written, or an error code to
+ *         stop saving.  Any error code is returned to the client.
+ */
+typedef cyaml_err_t (*cyaml_write_fn_t)(
+		void *ctx,
+		const uint8_t *data,
+		size_t len);
+
+/**
+ * An edit to a YAML document's input.
+ *
+ * Made by \ref cyaml_save_patch, to replace the YAML of a value that has
+ * changed.
+ */
+typedef struct cyaml_patch_edit {
+	size_t offset;   /**< Offset of the bytes to replace in the input. */
+	size_t len;      /**< Number of bytes to replace in the input. */
+	char *text;      /**< Replacement YAML.  Not '\0' terminated. */
+	size_t text_len; /**< Length of the replacement YAML in bytes. */
+} cyaml_patch_edit_t;
+
 /**
  * Client CYAML configuration data.
  *
@@ -1804,6 +2284,121 @@ typedef struct cyaml_config {
 	cyaml_log_t log_level;
 	/** CYAML behaviour flags. */
 	cyaml_cfg_flags_t flags;
+	/**
+	 * Optional compiled schema, or NULL.
+	 *
+	 * This may be set to a compiled schema created by
+	 * \ref cyaml_schema_compile, to speed up the handling of the schema
+	 * it was compiled from.  It is used with the ordinary, uncompiled,
+	 * schema, which must still be passed to the CYAML functions.
+	 *
+	 * Any schema values that the compiled schema does not cover are
+	 * handled as normal.  For example, it is fine to share a config that
+	 * has a compiled schema between load calls that use other schemas.
+	 *
+	 * \note The compiled schema records the case sensitivity that was
+	 *       configured when it was compiled.  Mappings are handled as
+	 *       normal if the configured case sensitivity is different.
+	 */
+	const cyaml_schema_compiled_t *compiled_schema;
+	/**
+	 * Arena chunk size in bytes, when \ref CYAML_CFG_ARENA is set.
+	 *
+	 * Set to zero to use the default chunk size.  Larger chunks mean
+	 * fewer allocations, at the cost of more unused memory at the end
+	 * of a load.  Allocations larger than a quarter of the chunk size
+	 * are given their own chunk.
+	 */
+	size_t arena_chunk_size;
+	/**
+	 * Expected number of events to be recorded for anchors, or zero.
+	 *
+	 * When loading, the events that make up anchored values are recorded,
+	 * so that they can be replayed for aliases.  The recording buffers
+	 * grow as needed, but if the client expects to anchor large parts
+	 * of their documents, setting this allocates the recording buffers
+	 * with space for this many events up front.
+	 */
+	uint32_t anchor_events_hint;
+	/**
+	 * Maximum number of threads to load or copy with, when
+	 * \ref CYAML_CFG_PARALLEL is set.
+	 *
+	 * Set to zero to use the number of online processors.  Fewer threads
+	 * are used for small inputs.
+	 */
+	uint32_t load_threads;
+	/**
+	 * Expected size in bytes of documents saved to memory, or zero.
+	 *
+	 * The buffer that \ref cyaml_save_data returns grows geometrically
+	 * as the document is saved.  If the client knows roughly how big
+	 * their documents are, setting this allocates the buffer with this
+	 * much space up front, which avoids growing it.
+	 */
+	size_t save_size_hint;
+	/**
+	 * Client statistics structure, or NULL.
+	 *
+	 * If set, CYAML adds to the statistics counters as it works.
+	 * Collecting statistics makes things a little slower, so this should
+	 * be left as NULL unless they are wanted.
+	 */
+	cyaml_stats_t *stats;
+	/**
+	 * Client trace callback, or NULL.
+	 *
+	 * If set, this is called at each trace point while loading.  Loads
+	 * with a trace callback are not split across threads, even if
+	 * \ref CYAML_CFG_PARALLEL is set.
+	 */
+	cyaml_trace_fn_t trace_fn;
+	/**
+	 * Client trace context pointer.
+	 *
+	 * The client's trace callback is called with this trace context
+	 * pointer.
+	 */
+	void *trace_ctx;
+	/**
+	 * Maximum number of events a load may replay for aliases, or zero
+	 * for no limit.
+	 *
+	 * Each alias replays every event of its anchored value, so a small
+	 * document with aliases of anchors that themselves contain aliases
+	 * can expand into an enormous amount of work.  Loads that would
+	 * exceed this limit fail with \ref CYAML_ERR_LIMIT_ALIAS_EVENTS, before
+	 * the alias that would exceed it is replayed.
+	 */
+	uint64_t max_alias_events;
+	/**
+	 * Maximum number of bytes a load may allocate, or zero for no limit.
+	 *
+	 * Every byte requested by each allocation or reallocation call made
+	 * while loading counts towards the limit, so it is an upper bound on
+	 * the memory a load uses.  Memory allocated internally by `libyaml`
+	 * is not counted.  Loads that would exceed this limit fail with
+	 * \ref CYAML_ERR_LIMIT_MEMORY.
+	 */
+	uint64_t max_alloc_bytes;
+	/**
+	 * Maximum nesting depth of mappings and sequences when loading, or
+	 * zero for no limit.
+	 *
+	 * The top level value counts as depth one, if it is a mapping or a
+	 * sequence.  Mappings and sequences that are ignored by the schema
+	 * count too.  Loads of documents that nest deeper fail with
+	 * \ref CYAML_ERR_LIMIT_DEPTH.
+	 */
+	uint32_t max_depth;
+	/**
+	 * Maximum size of YAML input to load in bytes, or zero for no limit.
+	 *
+	 * Loads of larger input fail with \ref CYAML_ERR_LIMIT_INPUT_SIZE.
+	 * Where the input's size isn't known up front, such as when reading
+	 * from a file stream, the load fails once that much has been read.
+	 */
+	size_t max_input_size;
 } cyaml_config_t;
 
 /**
@@ -1905,6 +2500,85 @@ extern cyaml_err_t cyaml_load_data(
 		cyaml_data_t **data_out,
 		unsigned *seq_count_out);
 
+/**
+ * Load every YAML document in a stream from a file at the given path.
+ *
+ * Each document is given to the client's callback as soon as it has been
+ * loaded, so the memory used depends on the largest document in the stream,
+ * rather than the size of the whole stream.
+ *
+ * \param[in]  path     Path to YAML file to load.
+ * \param[in]  config   Client's CYAML configuration structure.
+ * \param[in]  schema   CYAML schema for each YAML document to be loaded.
+ * \param[in]  doc_fn   Client's callback, called with each loaded document.
+ * \param[in]  doc_ctx  Client's private context, passed to `doc_fn`.
+ * \return \ref CYAML_OK on success, or appropriate error code otherwise.
+ *         Documents given to `doc_fn` before an error remain client-owned.
+ */
+extern cyaml_err_t cyaml_load_stream_file(
+		const char *path,
+		const cyaml_config_t *config,
+		const cyaml_schema_value_t *schema,
+		cyaml_doc_fn_t doc_fn,
+		void *doc_ctx);
+
+/**
+ * Load every YAML document in a stream from a data buffer.
+ *
+ * Each document is given to the client's callback as soon as it has been
+ * loaded, so the memory used depends on the largest document in the stream,
+ * rather than the size of the whole stream.
+ *
+ * \param[in]  input      Buffer to load YAML data from.
+ * \param[in]  input_len  Length of input in bytes.
+ * \param[in]  config     Client's CYAML configuration structure.
+ * \param[in]  schema     CYAML schema for each YAML document to be loaded.
+ * \param[in]  doc_fn     Client's callback, called with each loaded document.
+ * \param[in]  doc_ctx    Client's private context, passed to `doc_fn`.
+ * \return \ref CYAML_OK on success, or appropriate error code otherwise.
+ *         Documents given to `doc_fn` before an error remain client-owned.
+ */
+extern cyaml_err_t cyaml_load_stream_data(
+		const uint8_t *input,
+		size_t input_len,
+		const cyaml_config_t *config,
+		const cyaml_schema_value_t *schema,
+		cyaml_doc_fn_t doc_fn,
+		void *doc_ctx);
+
+/**
+ * Decode a lazily loaded value.
+ *
+ * This loads a value that was skipped over by the loader because its
+ * mapping field has \ref CYAML_FLAG_LAZY.  The schema is normally the
+ * lazy field's value schema.  Any lazy fields inside the value are
+ * themselves loaded lazily, and refer to the original input.
+ *
+ * The loaded data is owned by the caller, and is freed with \ref cyaml_free
+ * as normal, using the same schema.  The lazy value itself may be decoded
+ * any number of times.
+ *
+ * \note If the lazy value is absent or null, this returns \ref CYAML_OK,
+ *       and `NULL` in the `data_out` parameter.
+ *
+ * \param[in]  config         Client's CYAML configuration structure.
+ * \param[in]  schema         CYAML schema for the value to be decoded.
+ * \param[in]  lazy           The lazy value to decode.
+ * \param[out] data_out       Returns the caller-owned loaded data on success.
+ *                            Untouched on failure.
+ * \param[out] seq_count_out  On success, returns the sequence entry count.
+ *                            Untouched on failure.
+ *                            Must be non-NULL if top-level schema type is
+ *                            \ref CYAML_SEQUENCE, otherwise, must be NULL.
+ * \return \ref CYAML_OK on success, or appropriate error code otherwise.
+ */
+extern cyaml_err_t cyaml_lazy_get(
+		const cyaml_config_t *config,
+		const cyaml_schema_value_t *schema,
+		const cyaml_lazy_t *lazy,
+		cyaml_data_t **data_out,
+		unsigned *seq_count_out);
+
 /**
  * Save a YAML document to a file at the given path.
  *
@@ -1967,6 +2641,203 @@ extern cyaml_err_t cyaml_save_data(
 		const cyaml_data_t *data,
 		unsigned seq_count);
 
+/**
+ * Save a YAML document to a client write callback.
+ *
+ * This allows clients to write the serialised YAML to their own outputs,
+ * such as sockets or ring buffers, without the whole document being held
+ * in memory.
+ *
+ * If the write callback returns an error, saving stops, and the error is
+ * returned.  Some of the document may already have been written.
+ *
+ * \param[in]  write_fn   Client's output write callback.
+ * \param[in]  write_ctx  Client's private context for write_fn.
+ * \param[in]  config     Client's CYAML configuration structure.
+ * \param[in]  schema     CYAML schema for the YAML to be saved.
+ * \param[in]  data       The caller-owned data to be saved.
+ * \param[in]  seq_count  If top level type is sequence, this should be the
+ *                        entry count, otherwise it is ignored.
+ * \return \ref CYAML_OK on success, or appropriate error code otherwise.
+ */
+extern cyaml_err_t cyaml_save_stream(
+		cyaml_write_fn_t write_fn,
+		void *write_ctx,
+		const cyaml_config_t *config,
+		const cyaml_schema_value_t *schema,
+		const cyaml_data_t *data,
+		unsigned seq_count);
+
+/**
+ * Save a document as a binary image in memory.
+ *
+ * The binary image is a snapshot of the client data, which can be turned
+ * back into client data with \ref cyaml_load_binary much faster than YAML
+ * can be loaded.  This makes it suitable for caching documents that are
+ * loaded often.
+ *
+ * The data is copied into a single allocation, as \ref cyaml_copy does
+ * with \ref CYAML_CFG_COPY_BLOCK, and the pointers in the copy are stored
+ * as offsets into it.  The image header records a fingerprint of the
+ * schema, so that an image is only loaded with the schema it was saved
+ * with.
+ *
+ * \note The image uses the host's byte order and pointer size, and it
+ *       can only be loaded on hosts that match.
+ *
+ * \note Schemas with \ref CYAML_FLAG_LAZY fields can't be saved as binary,
+ *       because lazy values refer to their input.  Saving fails with
+ *       \ref CYAML_ERR_LAZY_NO_INPUT.
+ *
+ * \param[out] output     Returns the caller-owned binary image on success,
+ *                        untouched on failure.  Clients should use the
+ *                        \ref cyaml_mem_fn_t function set in the \ref
+ *                        cyaml_config_t to free the data.
+ * \param[out] len        Returns the length of the data in output on success,
+ *                        untouched on failure.
+ * \param[in]  config     Client's CYAML configuration structure.
+ * \param[in]  schema     CYAML schema for the data to be saved.  The top
+ *                        level value must have \ref CYAML_FLAG_POINTER set,
+ *                        otherwise saving fails with
+ *                        \ref CYAML_ERR_TOP_LEVEL_NON_PTR.
+ * \param[in]  data       The caller-owned data to be saved.
+ * \param[in]  seq_count  If top level type is sequence, this should be the
+ *                        entry count, otherwise it is ignored.
+ * \return \ref CYAML_OK on success, or appropriate error code otherwise.
+ */
+extern cyaml_err_t cyaml_save_binary(
+		uint8_t **output,
+		size_t *len,
+		const cyaml_config_t *config,
+		const cyaml_schema_value_t *schema,
+		const cyaml_data_t *data,
+		unsigned seq_count);
+
+/**
+ * Load a document from a binary image in memory.
+ *
+ * The image must have been made by \ref cyaml_save_binary, with the same
+ * schema.  If the schema's fingerprint doesn't match the one in the image,
+ * loading fails with \ref CYAML_ERR_BINARY_SCHEMA, and the client should
+ * fall back to loading the YAML.
+ *
+ * The image is copied into a single allocation, and its offsets are turned
+ * back into pointers.  Every offset is checked against the image and the
+ * schema, so a truncated or corrupt image fails with
+ * \ref CYAML_ERR_BINARY_INVALID, rather than producing bad data.
+ * Schema validation callbacks are not called.
+ *
+ * The loaded data must be freed with \ref cyaml_arena_free, rather than
+ * \ref cyaml_free, and it must not be modified in ways that would require
+ * individual pointer values to be freed or reallocated.
+ *
+ * \param[in]  input          Input buffer containing the binary image.
+ * \param[in]  input_len      Length of input in bytes.
+ * \param[in]  config         Client's CYAML configuration structure.
+ * \param[in]  schema         CYAML schema the image was saved with.
+ * \param[out] data_out       Returns the caller-owned loaded data on
+ *                            success.  Untouched on failure.
+ * \param[out] seq_count_out  On success, returns the sequence entry count.
+ *                            Untouched on failure.
+ *                            Must be non-NULL if top-level schema type is
+ *                            \ref CYAML_SEQUENCE, otherwise, must be NULL.
+ * \return \ref CYAML_OK on success, or appropriate error code otherwise.
+ */
+extern cyaml_err_t cyaml_load_binary(
+		const uint8_t *input,
+		size_t input_len,
+		const cyaml_config_t *config,
+		const cyaml_schema_value_t *schema,
+		cyaml_data_t **data_out,
+		unsigned *seq_count_out);
+
+/**
+ * Work out the edits that update a document's YAML input to new data.
+ *
+ * The `prev` data must have been loaded from `input`, and `data` is a
+ * modified version of it.  The input is parsed again, alongside the
+ * schema, and the YAML of each scalar value that differs between the two
+ * is replaced in the existing style.  Comments, formatting, and the YAML
+ * of unchanged values are kept.  Unchanged subtrees are compared, but not
+ * saved, so this is much cheaper than saving the whole document for small
+ * changes.
+ *
+ * Only changed scalar values inside mappings and sequences can be edited.
+ * For other changes, such as sequence entries added or removed, a field
+ * that is missing from the input, a change to an aliased value, or a
+ * change between NULL and non-NULL, this fails with
+ * \ref CYAML_ERR_PATCH_UNSUPPORTED, and the client should save the whole
+ * document instead.
+ *
+ * The edits are returned in input order, and they don't overlap.  If they
+ * are all applied to the input, loading the result gives the same data as
+ * saving and loading `data`.
+ *
+ * \note The top level value must be a \ref CYAML_MAPPING with
+ *       \ref CYAML_FLAG_POINTER set, and the input must be UTF-8.  Only the
+ *       first document in the input is edited.
+ *
+ * \param[out] edits_out  Returns the caller-owned edits on success, or
+ *                        NULL if nothing changed.  Untouched on failure.
+ *                        Free them with \ref cyaml_free_patch.
+ * \param[out] count_out  Returns the number of edits on success.  Untouched
+ *                        on failure.
+ * \param[in]  input      Input buffer that `prev` was loaded from.
+ * \param[in]  input_len  Length of input in bytes.
+ * \param[in]  config     Client's CYAML configuration structure.
+ * \param[in]  schema     CYAML schema `prev` was loaded with.
+ * \param[in]  prev       The data loaded from `input`.
+ * \param[in]  data       The modified data to update `input` to.
+ * \return \ref CYAML_OK on success, or appropriate error code otherwise.
+ */
+extern cyaml_err_t cyaml_save_patch(
+		cyaml_patch_edit_t **edits_out,
+		unsigned *count_out,
+		const uint8_t *input,
+		size_t input_len,
+		const cyaml_config_t *config,
+		const cyaml_schema_value_t *schema,
+		const cyaml_data_t *prev,
+		const cyaml_data_t *data);
+
+/**
+ * Update a YAML file to new data, by writing only the parts that changed.
+ *
+ * The edits are made with \ref cyaml_save_patch, from the file's current
+ * contents.  If nothing changed, the file isn't written.  Otherwise the
+ * patched YAML is written to a temporary file in the same directory, which
+ * is flushed to storage and then renamed over the file.  If writing fails,
+ * the file is left as it was.
+ *
+ * If this fails with \ref CYAML_ERR_PATCH_UNSUPPORTED, the file is
+ * untouched, and the client should save it with \ref cyaml_save_file.
+ *
+ * \param[in] path    Path to YAML file that `prev` was loaded from.
+ * \param[in] config  Client's CYAML configuration structure.
+ * \param[in] schema  CYAML schema `prev` was loaded with.
+ * \param[in] prev    The data loaded from the file.
+ * \param[in] data    The modified data to update the file to.
+ * \return \ref CYAML_OK on success, or appropriate error code otherwise.
+ */
+extern cyaml_err_t cyaml_save_file_patch(
+		const char *path,
+		const cyaml_config_t *config,
+		const cyaml_schema_value_t *schema,
+		const cyaml_data_t *prev,
+		const cyaml_data_t *data);
+
+/**
+ * Free edits returned by \ref cyaml_save_patch.
+ *
+ * \param[in] config  The client's CYAML library config.
+ * \param[in] edits   The edits to free.  May be NULL.
+ * \param[in] count   The number of edits.
+ */
+extern void cyaml_free_patch(
+		const cyaml_config_t *config,
+		cyaml_patch_edit_t *edits,
+		unsigned count);
+
 /**
  * Copy a loaded document.
  *
@@ -1977,6 +2848,9 @@ extern cyaml_err_t cyaml_save_data(
  * is useful to clients.  Clients would be better off writing their own copy
  * function for the specific data once loaded.
  *
+ * If the config has \ref CYAML_CFG_COPY_BLOCK set, the copy is made in
+ * a single allocation, and it must be freed with \ref cyaml_arena_free.
+ *
  * \note The input `data` parameter may be NULL if it is allowed by the schema.
  *       For example, if there is a top level mapping, containing only optional
  *       fields, and none of them are set, the provided data may be NULL.
@@ -2021,6 +2895,337 @@ extern cyaml_err_t cyaml_free(
 		cyaml_data_t *data,
 		unsigned seq_count);
 
+/**
+ * Free data loaded with the \ref CYAML_CFG_ARENA config flag set, or
+ * copied with the \ref CYAML_CFG_COPY_BLOCK config flag set.
+ *
+ * This frees the whole document in one go, without walking the schema.
+ *
+ * \param[in] config  The client's CYAML library config.  Must use the same
+ *                    allocator as the config given to the CYAML load or
+ *                    copy function used to create the data.
+ * \param[in] data    The data structure to free, or NULL.
+ * \return \ref CYAML_OK on success, or appropriate error code otherwise.
+ */
+extern cyaml_err_t cyaml_arena_free(
+		const cyaml_config_t *config,
+		cyaml_data_t *data);
+
+/**
+ * Compile a CYAML schema.
+ *
+ * This walks the schema once, and builds a compiled schema which makes
+ * subsequent use of the schema cheaper.  For example, rather than matching
+ * mapping keys by comparing against each of a mapping's fields in turn, the
+ * compiled schema allows them to be found with a binary search.  Similarly,
+ * enum, flags, and bitfield names are found with a hash table lookup, and
+ * enum values are mapped back to their names with a binary search.
+ *
+ * To use the compiled schema, set it as the `compiled_schema` member of the
+ * \ref cyaml_config_t passed to the load, save, copy and free functions.
+ *
+ * \note The compiled schema references the given schema.  The schema must
+ *       remain valid and unchanged until the compiled schema is freed.
+ *
+ * \param[in]  config        Client's CYAML configuration structure.
+ *                           The case sensitivity flags are used to order
+ *                           mapping keys, and to hash enum, flags, and
+ *                           bitfield names.
+ * \param[in]  schema        CYAML schema to compile.
+ * \param[out] compiled_out  Returns the caller-owned compiled schema on
+ *                           success.  Untouched on failure.
+ * \return \ref CYAML_OK on success, or appropriate error code otherwise.
+ */
+extern cyaml_err_t cyaml_schema_compile(
+		const cyaml_config_t *config,
+		const cyaml_schema_value_t *schema,
+		cyaml_schema_compiled_t **compiled_out);
+
+/**
+ * Free a compiled schema created by \ref cyaml_schema_compile.
+ *
+ * \param[in] config    The client's CYAML library config.  Must use the same
+ *                      allocator as the config given to
+ *                      \ref cyaml_schema_compile.
+ * \param[in] compiled  The compiled schema to free, or NULL.
+ * \return \ref CYAML_OK on success, or appropriate error code otherwise.
+ */
+extern cyaml_err_t cyaml_schema_compiled_free(
+		const cyaml_config_t *config,
+		cyaml_schema_compiled_t *compiled);
+
+/**
+ * Create a loader, for loading many documents with the same config.
+ *
+ * Loading a document needs a number of internal allocations, such as the
+ * load state stack, the bitfields that track which mapping fields have been
+ * seen, and the buffers used to record anchored events for aliases.  A
+ * loader keeps these allocations between loads, so that loading a stream of
+ * documents doesn't pay for setting them up and tearing them down each time.
+ *
+ * Each load made with a loader starts from a clean state, so there is no
+ * need to reset the loader between documents, even after a failed load.
+ *
+ * \note A loader must only be used by one thread at a time.  Threads that
+ *       load documents concurrently should each create their own loader.
+ *
+ * \note The `libyaml` parser is still created for each load, because
+ *       `libyaml` has no way to reset a parser for new input.
+ *
+ * \param[in]  config      Client's CYAML configuration structure.  The
+ *                         config is used for every load made with the
+ *                         loader, and it must remain valid until the loader
+ *                         is freed.
+ * \param[out] loader_out  Returns the caller-owned loader on success.
+ *                         Untouched on failure.
+ * \return \ref CYAML_OK on success, or appropriate error code otherwise.
+ */
+extern cyaml_err_t cyaml_loader_create(
+		const cyaml_config_t *config,
+		cyaml_loader_t **loader_out);
+
+/**
+ * Load a YAML document from a file at the given path, using a loader.
+ *
+ * This is the same as \ref cyaml_load_file, except the config is the one
+ * the loader was created with, and the loader's allocations are reused.
+ *
+ * \param[in]  loader         Loader created by \ref cyaml_loader_create.
+ * \param[in]  path           Path to YAML file to load.
+ * \param[in]  schema         CYAML schema for the YAML to be loaded.
+ * \param[out] data_out       Returns the caller-owned loaded data on success.
+ *                            Untouched on failure.
+ * \param[out] seq_count_out  On success, returns the sequence entry count.
+ *                            Untouched on failure.
+ *                            Must be non-NULL if top-level schema type is
+ *                            \ref CYAML_SEQUENCE, otherwise, must be NULL.
+ * \return \ref CYAML_OK on success, or appropriate error code otherwise.
+ */
+extern cyaml_err_t cyaml_loader_load_file(
+		cyaml_loader_t *loader,
+		const char *path,
+		const cyaml_schema_value_t *schema,
+		cyaml_data_t **data_out,
+		unsigned *seq_count_out);
+
+/**
+ * Load a YAML document from a data buffer, using a loader.
+ *
+ * This is the same as \ref cyaml_load_data, except the config is the one
+ * the loader was created with, and the loader's allocations are reused.
+ *
+ * \param[in]  loader         Loader created by \ref cyaml_loader_create.
+ * \param[in]  input          Buffer to load YAML data from.
+ * \param[in]  input_len      Length of input in bytes.
+ * \param[in]  schema         CYAML schema for the YAML to be loaded.
+ * \param[out] data_out       Returns the caller-owned loaded data on success.
+ *                            Untouched on failure.
+ * \param[out] seq_count_out  On success, returns the sequence entry count.
+ *                            Untouched on failure.
+ *                            Must be non-NULL if top-level schema type is
+ *                            \ref CYAML_SEQUENCE, otherwise, must be NULL.
+ * \return \ref CYAML_OK on success, or appropriate error code otherwise.
+ */
+extern cyaml_err_t cyaml_loader_load_data(
+		cyaml_loader_t *loader,
+		const uint8_t *input,
+		size_t input_len,
+		const cyaml_schema_value_t *schema,
+		cyaml_data_t **data_out,
+		unsigned *seq_count_out);
+
+/**
+ * Start loading a YAML document incrementally, using a loader.
+ *
+ * This allows a document to be loaded as it arrives, for example from a
+ * non-blocking socket, without the client buffering the whole document.
+ * The input is given to the loader in pieces with \ref cyaml_loader_feed,
+ * and the end of the input is signalled with \ref cyaml_loader_feed_end,
+ * which returns the loaded data.  Each piece of input is decoded as it is
+ * fed, so errors are reported as soon as they are found.
+ *
+ * While an incremental load is in progress, the loader can't be used for
+ * other loads.  An incremental load can be abandoned by freeing the loader.
+ *
+ * \note `libyaml` can only pull input, so each incremental load in
+ *       progress has a thread of its own, created by the library, which
+ *       parses the input as the client feeds it.  The \ref cyaml_config_t
+ *       `mem_fn` and `log_fn`, and any schema validation callbacks, are
+ *       called on that thread rather than the client's thread.  They are
+ *       never called at the same time as on the client's thread, so they
+ *       need no locking, but they must not rely on thread-local storage,
+ *       and they run on a 256 KiB stack.  On platforms without threads,
+ *       the fed input is buffered and loaded on the client's thread by
+ *       \ref cyaml_loader_feed_end.
+ *
+ * \param[in]  loader  Loader created by \ref cyaml_loader_create.
+ * \param[in]  schema  CYAML schema for the YAML to be loaded.  Must remain
+ *                     valid until the load ends.
+ * \return \ref CYAML_OK on success, or appropriate error code otherwise.
+ */
+extern cyaml_err_t cyaml_loader_feed_start(
+		cyaml_loader_t *loader,
+		const cyaml_schema_value_t *schema);
+
+/**
+ * Feed input to an incremental load.
+ *
+ * The input is decoded before this returns, so the client may reuse the
+ * input buffer afterwards.
+ *
+ * If an error is found, the incremental load ends, and the loader can be
+ * used for new loads.
+ *
+ * \param[in]  loader     Loader with an incremental load started by
+ *                        \ref cyaml_loader_feed_start.
+ * \param[in]  input      Buffer of YAML data to feed.
+ * \param[in]  input_len  Length of input in bytes.
+ * \return \ref CYAML_NEED_MORE once the input has been decoded, or
+ *         appropriate error code otherwise.
+ */
+extern cyaml_err_t cyaml_loader_feed(
+		cyaml_loader_t *loader,
+		const uint8_t *input,
+		size_t input_len);
+
+/**
+ * End the input to an incremental load, and get the loaded data.
+ *
+ * If the parameters are bad, the incremental load continues, and this can
+ * be called again with good parameters.  Otherwise the incremental load
+ * ends, and the loader can be used for new loads.
+ *
+ * \param[in]  loader         Loader with an incremental load started by
+ *                            \ref cyaml_loader_feed_start.
+ * \param[out] data_out       Returns the caller-owned loaded data on success.
+ *                            Untouched on failure.
+ * \param[out] seq_count_out  On success, returns the sequence entry count.
+ *                            Untouched on failure.
+ *                            Must be non-NULL if top-level schema type is
+ *                            \ref CYAML_SEQUENCE, otherwise, must be NULL.
+ * \return \ref CYAML_OK on success, or appropriate error code otherwise.
+ */
+extern cyaml_err_t cyaml_loader_feed_end(
+		cyaml_loader_t *loader,
+		cyaml_data_t **data_out,
+		unsigned *seq_count_out);
+
+/**
+ * Free a loader created by \ref cyaml_loader_create.
+ *
+ * Data loaded with the loader is owned by the caller, and is not freed.
+ *
+ * \param[in] loader  The loader to free, or NULL.
+ * \return \ref CYAML_OK on success, or appropriate error code otherwise.
+ */
+extern cyaml_err_t cyaml_loader_free(
+		cyaml_loader_t *loader);
+
+/**
+ * Create a saver, for saving many documents with the same config.
+ *
+ * A saver keeps the internal allocations made while saving a document,
+ * such as the save state stack, so that they can be reused for subsequent
+ * documents.
+ *
+ * \note A saver must only be used by one thread at a time.  Threads that
+ *       save documents concurrently should each create their own saver.
+ *
+ * \note The `libyaml` emitter is still created for each save, because
+ *       `libyaml` has no way to reset an emitter for new output.
+ *
+ * \param[in]  config     Client's CYAML configuration structure.  The
+ *                        config is used for every save made with the
+ *                        saver, and it must remain valid until the saver
+ *                        is freed.
+ * \param[out] saver_out  Returns the caller-owned saver on success.
+ *                        Untouched on failure.
+ * \return \ref CYAML_OK on success, or appropriate error code otherwise.
+ */
+extern cyaml_err_t cyaml_saver_create(
+		const cyaml_config_t *config,
+		cyaml_saver_t **saver_out);
+
+/**
+ * Save a YAML document to a file at the given path, using a saver.
+ *
+ * This is the same as \ref cyaml_save_file, except the config is the one
+ * the saver was created with, and the saver's allocations are reused.
+ *
+ * \param[in] saver      Saver created by \ref cyaml_saver_create.
+ * \param[in] path       Path to YAML file to write.
+ * \param[in] schema     CYAML schema for the YAML to be saved.
+ * \param[in] data       The caller-owned data to be saved.
+ * \param[in] seq_count  If top level type is sequence, this should be the
+ *                       entry count, otherwise it is ignored.
+ * \return \ref CYAML_OK on success, or appropriate error code otherwise.
+ */
+extern cyaml_err_t cyaml_saver_save_file(
+		cyaml_saver_t *saver,
+		const char *path,
+		const cyaml_schema_value_t *schema,
+		const cyaml_data_t *data,
+		unsigned seq_count);
+
+/**
+ * Save a YAML document into a string in memory, using a saver.
+ *
+ * This is the same as \ref cyaml_save_data, except the config is the one
+ * the saver was created with, and the saver's allocations are reused.
+ *
+ * \param[in]  saver      Saver created by \ref cyaml_saver_create.
+ * \param[out] output     Returns the caller-owned serialised YAML data on
+ *                        success, untouched on failure.  Clients should use
+ *                        the \ref cyaml_mem_fn_t function set in the \ref
+ *                        cyaml_config_t to free the data.
+ * \param[out] len        Returns the length of the data in output on success,
+ *                        untouched on failure.
+ * \param[in]  schema     CYAML schema for the YAML to be saved.
+ * \param[in]  data       The caller-owned data to be saved.
+ * \param[in]  seq_count  If top level type is sequence, this should be the
+ *                        entry count, otherwise it is ignored.
+ * \return \ref CYAML_OK on success, or appropriate error code otherwise.
+ */
+extern cyaml_err_t cyaml_saver_save_data(
+		cyaml_saver_t *saver,
+		char **output,
+		size_t *len,
+		const cyaml_schema_value_t *schema,
+		const cyaml_data_t *data,
+		unsigned seq_count);
+
+/**
+ * Save a YAML document to a client write callback, using a saver.
+ *
+ * This is the same as \ref cyaml_save_stream, except the config is the one
+ * the saver was created with, and the saver's allocations are reused.
+ *
+ * \param[in]  saver      Saver created by \ref cyaml_saver_create.
+ * \param[in]  write_fn   Client's output write callback.
+ * \param[in]  write_ctx  Client's private context for write_fn.
+ * \param[in]  schema     CYAML schema for the YAML to be saved.
+ * \param[in]  data       The caller-owned data to be saved.
+ * \param[in]  seq_count  If top level type is sequence, this should be the
+ *                        entry count, otherwise it is ignored.
+ * \return \ref CYAML_OK on success, or appropriate error code otherwise.
+ */
+extern cyaml_err_t cyaml_saver_save_stream(
+		cyaml_saver_t *saver,
+		cyaml_write_fn_t write_fn,
+		void *write_ctx,
+		const cyaml_schema_value_t *schema,
+		const cyaml_data_t *data,
+		unsigned seq_count);
+
+/**
+ * Free a saver created by \ref cyaml_saver_create.
+ *
+ * \param[in] saver  The saver to free, or NULL.
+ * \return \ref CYAML_OK on success, or appropriate error code otherwise.
+ */
+extern cyaml_err_t cyaml_saver_free(
+		cyaml_saver_t *saver);
+
 /**
  * Convert a cyaml error code to a human-readable string.
  *
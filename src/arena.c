@@ -0,0 +1,358 @@
+/*
+ * SPDX-License-Identifier: ISC
+ *
+ * Copyright (C) 2026 Michael Drake <tlsa@netsurf-browser.org>
+ */
+
+/**
+ * \file
+ * \brief CYAML arena allocation for loaded client data.
+ *
+ * Loading a document using an arena turns the many small allocations that
+ * make up a loaded document into a few large ones, and lets the whole
+ * document be freed without walking the schema.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <assert.h>
+#include <string.h>
+
+#include "arena.h"
+#include "util.h"
+
+/**
+ * An arena chunk.
+ *
+ * The chunk's allocation space follows the chunk header.
+ */
+struct cyaml_arena_chunk {
+	struct cyaml_arena_chunk *next; /**< Next chunk in list, or NULL. */
+	struct cyaml_arena_chunk *prev; /**< Prev chunk in list, or NULL. */
+	size_t size; /**< Size of chunk's allocation space. */
+	size_t used; /**< Number of bytes of allocation space used. */
+};
+
+/** Size of the space reserved for the chunk header. */
+#define CYAML_ARENA_CHUNK_HDR \
+		cyaml__arena_align(sizeof(struct cyaml_arena_chunk))
+
+/** Size of the space reserved for the arena details, before the root. */
+#define CYAML_ARENA_ROOT_HDR \
+		cyaml__arena_align(sizeof(cyaml_arena_t))
+
+/**
+ * Get the allocation space for a chunk.
+ *
+ * \param[in]  chunk  The chunk to get the allocation space of.
+ * \return the chunk's allocation space.
+ */
+static inline uint8_t * cyaml__arena_chunk_data(
+		cyaml_arena_chunk_t *chunk)
+{
+	return ((uint8_t *)chunk) + CYAML_ARENA_CHUNK_HDR;
+}
+
+/**
+ * Check whether an allocation size gets its own arena chunk.
+ *
+ * \param[in]  arena  The arena.
+ * \param[in]  size   The allocation size.
+ * \return true if allocations of this size get their own chunk.
+ */
+static inline bool cyaml__arena_is_large(
+		const cyaml_arena_t *arena,
+		size_t size)
+{
+	return cyaml__arena_align(size) > arena->chunk_size / 4;
+}
+
+/**
+ * Allocate or resize the arena's root allocation.
+ *
+ * \param[in]  config    The CYAML client config.
+ * \param[in]  arena     The arena.
+ * \param[in]  new_size  The number of bytes to resize allocation to.
+ * \return Pointer to allocation on success, or `NULL` on failure.
+ */
+static uint8_t * cyaml__arena_root_realloc(
+		const cyaml_config_t *config,
+		cyaml_arena_t *arena,
+		size_t new_size)
+{
+	uint8_t *base = NULL;
+
+	if (arena->root != NULL) {
+		base = arena->root - CYAML_ARENA_ROOT_HDR;
+	}
+
+	cyaml__stats_mem(config, base, CYAML_ARENA_ROOT_HDR + new_size);
+	base = config->mem_fn(config->mem_ctx, base,
+			CYAML_ARENA_ROOT_HDR + new_size);
+	if (base == NULL) {
+		return NULL;
+	}
+
+	arena->root = base + CYAML_ARENA_ROOT_HDR;
+	return arena->root;
+}
+
+/**
+ * Allocate or resize a large allocation, which has a chunk to itself.
+ *
+ * Large chunks are kept after the current chunk in the chunk list.
+ *
+ * \param[in]  config    The CYAML client config.
+ * \param[in]  arena     The arena.
+ * \param[in]  ptr       The existing large allocation, or NULL.
+ * \param[in]  new_size  The number of bytes to resize allocation to.
+ * \return Pointer to allocation on success, or `NULL` on failure.
+ */
+static uint8_t * cyaml__arena_large_realloc(
+		const cyaml_config_t *config,
+		cyaml_arena_t *arena,
+		uint8_t *ptr,
+		size_t new_size)
+{
+	cyaml_arena_chunk_t *chunk = NULL;
+
+	if (ptr != NULL) {
+		chunk = (cyaml_arena_chunk_t *)(void *)
+				(ptr - CYAML_ARENA_CHUNK_HDR);
+	}
+
+	cyaml__stats_mem(config, chunk, CYAML_ARENA_CHUNK_HDR + new_size);
+	chunk = config->mem_fn(config->mem_ctx, chunk,
+			CYAML_ARENA_CHUNK_HDR + new_size);
+	if (chunk == NULL) {
+		return NULL;
+	}
+
+	if (ptr == NULL) {
+		/* New; insert after the current chunk. */
+		if (arena->chunks == NULL) {
+			chunk->prev = NULL;
+			chunk->next = NULL;
+			arena->chunks = chunk;
+			arena->last = NULL;
+		} else {
+			chunk->prev = arena->chunks;
+			chunk->next = arena->chunks->next;
+			arena->chunks->next = chunk;
+		}
+	} else if (chunk->prev == NULL) {
+		/* Resized chunk is the current chunk. */
+		arena->chunks = chunk;
+	} else {
+		chunk->prev->next = chunk;
+	}
+
+	if (chunk->next != NULL) {
+		chunk->next->prev = chunk;
+	}
+
+	chunk->size = new_size;
+	chunk->used = new_size;
+
+	return cyaml__arena_chunk_data(chunk);
+}
+
+/**
+ * Make a new bump allocation from the current chunk.
+ *
+ * A new current chunk is allocated if the allocation doesn't fit.
+ *
+ * \param[in]  config  The CYAML client config.
+ * \param[in]  arena   The arena.
+ * \param[in]  size    The number of bytes to allocate.
+ * \return Pointer to allocation on success, or `NULL` on failure.
+ */
+static uint8_t * cyaml__arena_bump(
+		const cyaml_config_t *config,
+		cyaml_arena_t *arena,
+		size_t size)
+{
+	cyaml_arena_chunk_t *chunk = arena->chunks;
+
+	size = cyaml__arena_align(size);
+
+	if (chunk == NULL || chunk->size - chunk->used < size) {
+		size_t chunk_size = cyaml__arena_align(arena->chunk_size);
+
+		chunk = cyaml__alloc(config,
+				CYAML_ARENA_CHUNK_HDR + chunk_size, false);
+		if (chunk == NULL) {
+			return NULL;
+		}
+
+		cyaml__log(config, CYAML_LOG_DEBUG,
+				"Arena: New chunk: %p (%zu bytes)\n",
+				chunk, chunk_size);
+
+		chunk->prev = NULL;
+		chunk->next = arena->chunks;
+		chunk->size = chunk_size;
+		chunk->used = 0;
+		if (arena->chunks != NULL) {
+			arena->chunks->prev = chunk;
+		}
+		arena->chunks = chunk;
+	}
+
+	arena->last = cyaml__arena_chunk_data(chunk) + chunk->used;
+	chunk->used += size;
+
+	return arena->last;
+}
+
+/**
+ * Try to resize the last bump allocation in place.
+ *
+ * \param[in]  arena     The arena.
+ * \param[in]  ptr       The existing allocation.
+ * \param[in]  new_size  The number of bytes to resize allocation to.
+ * \return true if the allocation was resized, false otherwise.
+ */
+static bool cyaml__arena_bump_resize(
+		cyaml_arena_t *arena,
+		const uint8_t *ptr,
+		size_t new_size)
+{
+	cyaml_arena_chunk_t *chunk = arena->chunks;
+	size_t offset;
+
+	if (ptr != arena->last || cyaml__arena_is_large(arena, new_size)) {
+		return false;
+	}
+
+	offset = (size_t)(ptr - cyaml__arena_chunk_data(chunk));
+	if (chunk->size - offset < cyaml__arena_align(new_size)) {
+		return false;
+	}
+
+	chunk->used = offset + cyaml__arena_align(new_size);
+	return true;
+}
+
+/* Exported function, documented in arena.h. */
+void * cyaml__arena_realloc(
+		const cyaml_config_t *config,
+		cyaml_arena_t *arena,
+		void *ptr,
+		size_t current_size,
+		size_t new_size,
+		bool clean)
+{
+	uint8_t *temp;
+
+	assert(new_size != 0);
+
+	if (ptr == arena->root) {
+		/* The first allocation is the root, and it always uses the
+		 * client's allocator directly. */
+		temp = cyaml__arena_root_realloc(config, arena, new_size);
+
+	} else if (ptr != NULL && new_size <= current_size) {
+		/* Shrinking; nothing to do. */
+		return ptr;
+
+	} else if (cyaml__arena_is_large(arena, current_size)) {
+		/* Allocation already has its own chunk; just resize it. */
+		temp = cyaml__arena_large_realloc(config, arena,
+				ptr, new_size);
+
+	} else if (ptr != NULL &&
+	           cyaml__arena_bump_resize(arena, ptr, new_size)) {
+		/* Resized in place. */
+		temp = ptr;
+
+	} else {
+		if (cyaml__arena_is_large(arena, new_size)) {
+			temp = cyaml__arena_large_realloc(config, arena,
+					NULL, new_size);
+		} else {
+			temp = cyaml__arena_bump(config, arena, new_size);
+		}
+		if (temp != NULL && ptr != NULL) {
+			memcpy(temp, ptr, current_size);
+		}
+	}
+
+	if (temp == NULL) {
+		return NULL;
+	}
+
+	if (clean && (new_size > current_size)) {
+		memset(temp + current_size, 0, new_size - current_size);
+	}
+
+	return temp;
+}
+
+/**
+ * Free an arena's chunks.
+ *
+ * \param[in]  config  The CYAML client config.
+ * \param[in]  chunk   The first chunk in the list to free.
+ */
+static void cyaml__arena_free_chunks(
+		const cyaml_config_t *config,
+		cyaml_arena_chunk_t *chunk)
+{
+	while (chunk != NULL) {
+		cyaml_arena_chunk_t *next = chunk->next;
+
+		cyaml__log(config, CYAML_LOG_DEBUG,
+				"Arena: Freeing chunk: %p\n", chunk);
+		cyaml__free(config, chunk);
+		chunk = next;
+	}
+}
+
+/* Exported function, documented in arena.h. */
+void cyaml__arena_destroy(
+		const cyaml_config_t *config,
+		cyaml_arena_t *arena)
+{
+	cyaml__arena_free_chunks(config, arena->chunks);
+	if (arena->root != NULL) {
+		cyaml__free(config, arena->root - CYAML_ARENA_ROOT_HDR);
+	}
+
+	cyaml__arena_init(arena, arena->chunk_size);
+}
+
+/* Exported function, documented in arena.h. */
+void cyaml__arena_finalise(
+		const cyaml_arena_t *arena)
+{
+	assert(arena->root != NULL);
+
+	memcpy(arena->root - CYAML_ARENA_ROOT_HDR, arena, sizeof(*arena));
+}
+
+/* Exported function, documented in include/cyaml/cyaml.h */
+cyaml_err_t cyaml_arena_free(
+		const cyaml_config_t *config,
+		cyaml_data_t *data)
+{
+	cyaml_arena_t arena;
+
+	if (config == NULL) {
+		return CYAML_ERR_BAD_PARAM_NULL_CONFIG;
+	}
+	if (config->mem_fn == NULL) {
+		return CYAML_ERR_BAD_CONFIG_NULL_MEMFN;
+	}
+	if (data == NULL) {
+		return CYAML_OK;
+	}
+
+	memcpy(&arena, (uint8_t *)data - CYAML_ARENA_ROOT_HDR, sizeof(arena));
+	assert(arena.root == data);
+
+	cyaml__log(config, CYAML_LOG_DEBUG, "Arena: Freeing: %p\n", data);
+	cyaml__arena_destroy(config, &arena);
+
+	return CYAML_OK;
+}
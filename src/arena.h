@@ -0,0 +1,173 @@
+/*
+ * SPDX-License-Identifier: ISC
+ *
+ * Copyright (C) 2026 Michael Drake <tlsa@netsurf-browser.org>
+ */
+
+/**
+ * \file
+ * \brief CYAML arena allocation for loaded client data.
+ */
+
+#ifndef CYAML_ARENA_H
+#define CYAML_ARENA_H
+
+#include <stddef.h>
+
+#include "cyaml/cyaml.h"
+
+#include "mem.h"
+
+/** Default arena chunk size, used if the client doesn't give one. */
+#define CYAML_ARENA_CHUNK_SIZE_DEFAULT (16 * 1024)
+
+/** Alignment of arena allocations. */
+#define CYAML_ARENA_ALIGN (_Alignof(max_align_t))
+
+/**
+ * Round a size up to the arena allocation alignment.
+ *
+ * \param[in]  size  The size to round up.
+ * \return the rounded up size.
+ */
+static inline size_t cyaml__arena_align(size_t size)
+{
+	return (size + CYAML_ARENA_ALIGN - 1) & ~(CYAML_ARENA_ALIGN - 1);
+}
+
+/** An arena chunk.  Opaque outside arena.c. */
+typedef struct cyaml_arena_chunk cyaml_arena_chunk_t;
+
+/**
+ * A CYAML arena.
+ *
+ * The first allocation made from an arena is the root allocation.  For a
+ * load, this is the top level value, which is returned to the client.  The
+ * root allocation is made directly with the client's allocator, and it is
+ * prefixed with space for the arena details, so that the whole arena can
+ * be found and freed given just the root allocation.
+ *
+ * All other allocations are made from chunks.  Most allocations are bump
+ * allocated from the current chunk.  Large allocations get a chunk of
+ * their own, so that they can be resized with the client's allocator.
+ */
+typedef struct cyaml_arena {
+	cyaml_arena_chunk_t *chunks; /**< List of chunks, current first. */
+	uint8_t *root;  /**< Root allocation, or NULL. */
+	uint8_t *last;  /**< Last bump allocation in current chunk, or NULL. */
+	size_t chunk_size; /**< Size of chunks to allocate. */
+} cyaml_arena_t;
+
+/**
+ * Initialise an arena.
+ *
+ * \param[in]  arena       The arena to initialise.
+ * \param[in]  chunk_size  Chunk size hint, or zero for default chunk size.
+ */
+static inline void cyaml__arena_init(
+		cyaml_arena_t *arena,
+		size_t chunk_size)
+{
+	*arena = (cyaml_arena_t) {
+		.chunk_size = (chunk_size != 0) ? chunk_size :
+				CYAML_ARENA_CHUNK_SIZE_DEFAULT,
+	};
+}
+
+/**
+ * Allocate or resize an allocation in an arena.
+ *
+ * \note On failure, any existing allocation is still valid.
+ *
+ * \param[in]  config        The CYAML client config.
+ * \param[in]  arena         The arena to allocate from.
+ * \param[in]  ptr           The existing allocation or NULL.
+ * \param[in]  current_size  Size of the current allocation.
+ * \param[in]  new_size      The number of bytes to resize allocation to.
+ *                           Must be non-zero.
+ * \param[in]  clean         Only applies if `new_size > current_size`.
+ *                           If `false`, the new memory is uninitialised,
+ *                           if `true`, the new memory is initialised to zero.
+ * \return Pointer to allocation on success, or `NULL` on failure.
+ */
+void * cyaml__arena_realloc(
+		const cyaml_config_t *config,
+		cyaml_arena_t *arena,
+		void *ptr,
+		size_t current_size,
+		size_t new_size,
+		bool clean);
+
+/**
+ * Free everything allocated from an arena, including the root allocation.
+ *
+ * \param[in]  config  The CYAML client config.
+ * \param[in]  arena   The arena to free.
+ */
+void cyaml__arena_destroy(
+		const cyaml_config_t *config,
+		cyaml_arena_t *arena);
+
+/**
+ * Store the arena details in the root allocation's prefix.
+ *
+ * This must be called once the arena is complete, before the root
+ * allocation is given to the client.  Afterwards, the arena can be freed
+ * with \ref cyaml_arena_free.
+ *
+ * \param[in]  arena  The arena to finalise.
+ */
+void cyaml__arena_finalise(
+		const cyaml_arena_t *arena);
+
+/**
+ * Helper for client data allocations, which may be from an arena.
+ *
+ * \param[in]  config        The CYAML client config.
+ * \param[in]  arena         Arena to allocate from, or NULL to use the
+ *                           client's allocator.
+ * \param[in]  ptr           The existing allocation or NULL.
+ * \param[in]  current_size  Size of the current allocation.
+ * \param[in]  new_size      The number of bytes to resize allocation to.
+ * \param[in]  clean         Only applies if `new_size > current_size`.
+ *                           If `false`, the new memory is uninitialised,
+ *                           if `true`, the new memory is initialised to zero.
+ * \return Pointer to allocation on success, or `NULL` on failure.
+ */
+static inline void * cyaml__data_realloc(
+		const cyaml_config_t *config,
+		cyaml_arena_t *arena,
+		void *ptr,
+		size_t current_size,
+		size_t new_size,
+		bool clean)
+{
+	if (arena != NULL) {
+		return cyaml__arena_realloc(config, arena, ptr,
+				current_size, new_size, clean);
+	}
+
+	return cyaml__realloc(config, ptr, current_size, new_size, clean);
+}
+
+/**
+ * Helper for freeing client data allocations, which may be from an arena.
+ *
+ * Arena allocations are not freed individually; they are all freed when
+ * the arena is destroyed.
+ *
+ * \param[in]  config  The CYAML client config.
+ * \param[in]  arena   Arena the allocation was made from, or NULL.
+ * \param[in]  ptr     Pointer to allocation to free.
+ */
+static inline void cyaml__data_free(
+		const cyaml_config_t *config,
+		const cyaml_arena_t *arena,
+		void *ptr)
+{
+	if (arena == NULL) {
+		cyaml__free(config, ptr);
+	}
+}
+
+#endif
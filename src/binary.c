@@ -0,0 +1,942 @@
+/*
+ * SPDX-License-Identifier: ISC
+ *
+ * Copyright (C) 2026 Michael Drake <tlsa@netsurf-browser.org>
+ */
+
+/**
+ * \file
+ * \brief Save and load client data as relocatable binary images.
+ *
+ * A binary image is a header, followed by a single allocation copy of the
+ * client data, as made by \ref cyaml__copy_block.  Every pointer in the copy
+ * is replaced with its offset into the copy, plus one, so that NULL pointers
+ * are stored as zero.  Loading copies the image data into a new allocation
+ * and turns the offsets back into pointers.
+ *
+ * The header has a fingerprint of the schema, which covers everything that
+ * affects the layout and the validity of the data.  Schema validation
+ * callbacks and default values are not covered, since they are addresses.
+ */
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <assert.h>
+#include <limits.h>
+#include <string.h>
+
+#include "mem.h"
+#include "data.h"
+#include "util.h"
+#include "copy.h"
+#include "arena.h"
+#include "schema.h"
+
+/** Identifies a CYAML binary image. */
+#define CYAML_BINARY_MAGIC "CYAMLBIN"
+
+/** Version of the binary image format. */
+#define CYAML_BINARY_VERSION 1
+
+/** Written in host byte order, to detect images from other hosts. */
+#define CYAML_BINARY_BYTE_ORDER 0x0102
+
+/** FNV-1a 64-bit offset basis, used for schema fingerprints. */
+#define CYAML_BINARY_FNV_OFFSET 0xcbf29ce484222325u
+
+/** FNV-1a 64-bit prime, used for schema fingerprints. */
+#define CYAML_BINARY_FNV_PRIME 0x100000001b3u
+
+/** Number of relocation stack entries to keep on the C stack. */
+#define CYAML_BINARY_STACK_LOCAL 32
+
+/**
+ * Header at the start of a binary image.
+ *
+ * The image data follows the header.
+ */
+typedef struct cyaml_binary_header {
+	char magic[8];         /**< \ref CYAML_BINARY_MAGIC. */
+	uint32_t version;      /**< \ref CYAML_BINARY_VERSION. */
+	uint16_t pointer_size; /**< Size of a pointer on the saving host. */
+	uint16_t byte_order;   /**< \ref CYAML_BINARY_BYTE_ORDER. */
+	uint64_t fingerprint;  /**< Fingerprint of the schema. */
+	uint64_t seq_count;    /**< Top level sequence entry count. */
+	uint64_t size;         /**< Size of the image data in bytes. */
+} cyaml_binary_header_t;
+
+/**
+ * Schema fingerprinting context.
+ */
+typedef struct cyaml_binary_print {
+	const cyaml_config_t *config; /**< Settings provided by client. */
+	/** Container schema values already fingerprinted, in walk order. */
+	const cyaml_schema_value_t **seen;
+	uint32_t seen_count; /**< Number of entries in `seen`. */
+	uint32_t seen_max;   /**< Current `seen` allocation limit. */
+	uint64_t hash;       /**< The fingerprint so far. */
+} cyaml_binary_print_t;
+
+/**
+ * An image relocation stack entry, for a mapping or sequence.
+ */
+typedef struct cyaml_binary_frame {
+	/** Schema for the mapping or sequence. */
+	const cyaml_schema_value_t *schema;
+	/** The mapping or sequence's data in the image. */
+	uint8_t *data;
+	/**
+	 * For sequences, the entry count.  For mappings which are entries
+	 * of a \ref CYAML_FLAG_COLUMNAR sequence, the sequence entry count,
+	 * or zero for other mappings.
+	 */
+	uint64_t count;
+	/** For columnar sequence entry mappings, index in the columns. */
+	uint64_t column;
+	/** Index of the next mapping field or sequence entry to relocate. */
+	uint64_t next;
+} cyaml_binary_frame_t;
+
+/**
+ * Image relocation context.
+ */
+typedef struct cyaml_binary_ctx {
+	const cyaml_config_t *config; /**< Settings provided by client. */
+	uint8_t *base; /**< Start of the image data. */
+	size_t size;   /**< Size of the image data in bytes. */
+	bool save;     /**< Whether pointers are being turned into offsets. */
+	cyaml_binary_frame_t *stack; /**< The relocation stack. */
+	uint32_t idx;  /**< Next (empty) stack slot. */
+	uint32_t max;  /**< Current stack allocation limit. */
+	/** Local stack, used until the stack needs to grow. */
+	cyaml_binary_frame_t local[CYAML_BINARY_STACK_LOCAL];
+} cyaml_binary_ctx_t;
+
+/**
+ * Add some bytes to a schema fingerprint.
+ *
+ * \param[in]  print  The schema fingerprinting context.
+ * \param[in]  data   The bytes to add.
+ * \param[in]  len    Number of bytes to add.
+ */
+static void cyaml__binary_hash(
+		cyaml_binary_print_t *print,
+		const void *data,
+		size_t len)
+{
+	const uint8_t *bytes = data;
+	uint64_t hash = print->hash;
+
+	for (size_t i = 0; i < len; i++) {
+		hash ^= bytes[i];
+		hash *= CYAML_BINARY_FNV_PRIME;
+	}
+
+	print->hash = hash;
+}
+
+/**
+ * Add a number to a schema fingerprint.
+ *
+ * \param[in]  print  The schema fingerprinting context.
+ * \param[in]  value  The number to add.
+ */
+static inline void cyaml__binary_hash_u64(
+		cyaml_binary_print_t *print,
+		uint64_t value)
+{
+	cyaml__binary_hash(print, &value, sizeof(value));
+}
+
+/**
+ * Add a string to a schema fingerprint.
+ *
+ * The terminating '\0' is included, so that adjacent strings can't be
+ * confused with each other.
+ *
+ * \param[in]  print  The schema fingerprinting context.
+ * \param[in]  str    The string to add, or NULL.
+ */
+static inline void cyaml__binary_hash_str(
+		cyaml_binary_print_t *print,
+		const char *str)
+{
+	if (str == NULL) {
+		cyaml__binary_hash_u64(print, 0);
+		return;
+	}
+
+	cyaml__binary_hash(print, str, strlen(str) + 1);
+}
+
+/**
+ * Add a container schema value to the list of values already fingerprinted.
+ *
+ * Recursive schemas refer back to container values that are already being
+ * fingerprinted.  Values that have been seen before are added to the
+ * fingerprint as a reference to where they were first seen, so the walk
+ * always terminates.
+ *
+ * \param[in]  print     The schema fingerprinting context.
+ * \param[in]  schema    The container schema value.
+ * \param[out] seen_out  Returns whether the value was seen before.
+ * \return \ref CYAML_OK on success, or appropriate error code otherwise.
+ */
+static cyaml_err_t cyaml__binary_print_seen(
+		cyaml_binary_print_t *print,
+		const cyaml_schema_value_t *schema,
+		bool *seen_out)
+{
+	for (uint32_t i = 0; i < print->seen_count; i++) {
+		if (print->seen[i] == schema) {
+			cyaml__binary_hash_u64(print, i + 1);
+			*seen_out = true;
+			return CYAML_OK;
+		}
+	}
+
+	if (print->seen_count == print->seen_max) {
+		uint32_t max = (print->seen_max == 0) ? 16 :
+				print->seen_max * 2;
+		const cyaml_schema_value_t **seen;
+
+		seen = cyaml__realloc(print->config, print->seen,
+				sizeof(*seen) * print->seen_max,
+				sizeof(*seen) * max, false);
+		if (seen == NULL) {
+			return CYAML_ERR_OOM;
+		}
+		print->seen = seen;
+		print->seen_max = max;
+	}
+
+	print->seen[print->seen_count++] = schema;
+	cyaml__binary_hash_u64(print, 0);
+	*seen_out = false;
+	return CYAML_OK;
+}
+
+static cyaml_err_t cyaml__binary_print_value(
+		cyaml_binary_print_t *print,
+		const cyaml_schema_value_t *schema);
+
+/**
+ * Add a mapping schema value's fields to a schema fingerprint.
+ *
+ * \param[in]  print   The schema fingerprinting context.
+ * \param[in]  schema  The mapping schema value.
+ * \return \ref CYAML_OK on success, or appropriate error code otherwise.
+ */
+static cyaml_err_t cyaml__binary_print_mapping(
+		cyaml_binary_print_t *print,
+		const cyaml_schema_value_t *schema)
+{
+	const cyaml_schema_field_t *field = schema->mapping.fields;
+	uint64_t count = 0;
+
+	for (; field->key != NULL; field++) {
+		cyaml_err_t err;
+
+		if (field->value.flags & CYAML_FLAG_LAZY) {
+			cyaml__log(print->config, CYAML_LOG_ERROR,
+					"Binary: Lazy field '%s' can't be "
+					"stored in binary image\n",
+					field->key);
+			return CYAML_ERR_LAZY_NO_INPUT;
+		}
+
+		cyaml__binary_hash_str(print, field->key);
+		cyaml__binary_hash_u64(print, field->data_offset);
+		cyaml__binary_hash_u64(print, field->count_offset);
+		cyaml__binary_hash_u64(print, field->count_size);
+
+		err = cyaml__binary_print_value(print, &field->value);
+		if (err != CYAML_OK) {
+			return err;
+		}
+		count++;
+	}
+
+	cyaml__binary_hash_u64(print, count);
+	return CYAML_OK;
+}
+
+/**
+ * Add a schema value to a schema fingerprint.
+ *
+ * \param[in]  print   The schema fingerprinting context.
+ * \param[in]  schema  The schema value.
+ * \return \ref CYAML_OK on success, or appropriate error code otherwise.
+ */
+static cyaml_err_t cyaml__binary_print_value(
+		cyaml_binary_print_t *print,
+		const cyaml_schema_value_t *schema)
+{
+	cyaml_err_t err;
+	bool seen;
+
+	cyaml__binary_hash_u64(print, schema->type);
+	cyaml__binary_hash_u64(print, schema->flags);
+	cyaml__binary_hash_u64(print, schema->data_size);
+
+	switch (schema->type) {
+	case CYAML_INT:
+		cyaml__binary_hash_u64(print, (uint64_t)schema->integer.min);
+		cyaml__binary_hash_u64(print, (uint64_t)schema->integer.max);
+		break;
+	case CYAML_UINT:
+		cyaml__binary_hash_u64(print, schema->unsigned_integer.min);
+		cyaml__binary_hash_u64(print, schema->unsigned_integer.max);
+		break;
+	case CYAML_STRING:
+		cyaml__binary_hash_u64(print, schema->string.min);
+		cyaml__binary_hash_u64(print, schema->string.max);
+		break;
+	case CYAML_ENUM: /* Fall through. */
+	case CYAML_FLAGS:
+		cyaml__binary_hash_u64(print, schema->enumeration.count);
+		for (uint32_t i = 0; i < schema->enumeration.count; i++) {
+			const cyaml_strval_t *strval =
+					schema->enumeration.strings + i;
+
+			cyaml__binary_hash_str(print, strval->str);
+			cyaml__binary_hash_u64(print, (uint64_t)strval->val);
+		}
+		break;
+	case CYAML_BITFIELD:
+		cyaml__binary_hash_u64(print, schema->bitfield.count);
+		for (uint32_t i = 0; i < schema->bitfield.count; i++) {
+			const cyaml_bitdef_t *bitdef =
+					schema->bitfield.bitdefs + i;
+
+			cyaml__binary_hash_str(print, bitdef->name);
+			cyaml__binary_hash_u64(print, bitdef->offset);
+			cyaml__binary_hash_u64(print, bitdef->bits);
+		}
+		break;
+	case CYAML_MAPPING:
+		err = cyaml__binary_print_seen(print, schema, &seen);
+		if (err != CYAML_OK || seen) {
+			return err;
+		}
+		return cyaml__binary_print_mapping(print, schema);
+	case CYAML_SEQUENCE: /* Fall through. */
+	case CYAML_SEQUENCE_FIXED:
+		cyaml__binary_hash_u64(print, schema->sequence.min);
+		cyaml__binary_hash_u64(print, schema->sequence.max);
+		err = cyaml__binary_print_seen(print, schema, &seen);
+		if (err != CYAML_OK || seen) {
+			return err;
+		}
+		return cyaml__binary_print_value(print,
+				schema->sequence.entry);
+	default:
+		break;
+	}
+
+	return CYAML_OK;
+}
+
+/**
+ * Get the fingerprint of a schema.
+ *
+ * \param[in]  config           The client's CYAML library config.
+ * \param[in]  schema           The top level schema value.
+ * \param[out] fingerprint_out  Returns the fingerprint on success.
+ * \return \ref CYAML_OK on success, or appropriate error code otherwise.
+ */
+static cyaml_err_t cyaml__binary_fingerprint(
+		const cyaml_config_t *config,
+		const cyaml_schema_value_t *schema,
+		uint64_t *fingerprint_out)
+{
+	cyaml_binary_print_t print = {
+		.config = config,
+		.hash = CYAML_BINARY_FNV_OFFSET,
+	};
+	cyaml_err_t err;
+
+	err = cyaml__binary_print_value(&print, schema);
+	cyaml__free(config, print.seen);
+	if (err != CYAML_OK) {
+		return err;
+	}
+
+	cyaml__log(config, CYAML_LOG_DEBUG,
+			"Binary: Schema fingerprint: %016"PRIx64"\n",
+			print.hash);
+
+	*fingerprint_out = print.hash;
+	return CYAML_OK;
+}
+
+/**
+ * Relocate a pointer in the image data.
+ *
+ * When saving, the pointer is replaced with its offset.  When loading, the
+ * offset is checked against the image data and the schema, and replaced
+ * with the pointer.
+ *
+ * \param[in]  ctx        The image relocation context.
+ * \param[in]  schema     The schema for the pointer value.
+ * \param[in]  slot       Where the pointer is stored.
+ * \param[in]  count      Entry count for sequence values.
+ * \param[out] value_out  Returns the pointer value, which may be NULL.
+ * \return \ref CYAML_OK on success, or appropriate error code otherwise.
+ */
+static cyaml_err_t cyaml__binary_pointer(
+		const cyaml_binary_ctx_t *ctx,
+		const cyaml_schema_value_t *schema,
+		uint8_t *slot,
+		uint64_t count,
+		uint8_t **value_out)
+{
+	uint64_t offset;
+	size_t avail;
+	cyaml_err_t err;
+
+	if (ctx->save) {
+		uint8_t *value = cyaml_data_read_pointer(slot);
+
+		offset = 0;
+		if (value != NULL) {
+			assert(value >= ctx->base);
+			assert(value <= ctx->base + ctx->size);
+			offset = (uint64_t)(value - ctx->base) + 1;
+		}
+
+		CYAML_UNUSED(cyaml_data_write(offset, sizeof(char *), slot));
+		*value_out = value;
+		return CYAML_OK;
+	}
+
+	offset = cyaml_data_read(sizeof(char *), slot, &err);
+	if (offset == 0) {
+		*value_out = NULL;
+		return CYAML_OK;
+	}
+
+	offset--;
+	if (offset > ctx->size ||
+	    offset != cyaml__arena_align((size_t)offset)) {
+		return CYAML_ERR_BINARY_INVALID;
+	}
+
+	avail = ctx->size - (size_t)offset;
+	switch (schema->type) {
+	case CYAML_STRING:
+		if (memchr(ctx->base + offset, '\0', avail) == NULL) {
+			return CYAML_ERR_BINARY_INVALID;
+		}
+		break;
+	case CYAML_SEQUENCE: /* Fall through. */
+	case CYAML_SEQUENCE_FIXED:
+		if (schema->data_size != 0 &&
+		    count > avail / schema->data_size) {
+			return CYAML_ERR_BINARY_INVALID;
+		}
+		break;
+	default:
+		if (schema->data_size > avail) {
+			return CYAML_ERR_BINARY_INVALID;
+		}
+		break;
+	}
+
+	*value_out = ctx->base + offset;
+	cyaml_data_write_pointer(*value_out, slot);
+	return CYAML_OK;
+}
+
+/**
+ * Push an entry onto the relocation stack.
+ *
+ * \param[in]  ctx    The image relocation context.
+ * \param[in]  frame  The entry to push.
+ * \return \ref CYAML_OK on success, or appropriate error code otherwise.
+ */
+static cyaml_err_t cyaml__binary_push(
+		cyaml_binary_ctx_t *ctx,
+		const cyaml_binary_frame_t *frame)
+{
+	if (ctx->idx == ctx->max) {
+		uint32_t max = ctx->max * 2;
+		cyaml_binary_frame_t *temp;
+
+		if (ctx->stack == ctx->local) {
+			temp = cyaml__alloc(ctx->config,
+					sizeof(*temp) * max, false);
+			if (temp != NULL) {
+				memcpy(temp, ctx->local, sizeof(ctx->local));
+			}
+		} else {
+			temp = cyaml__realloc(ctx->config, ctx->stack,
+					0, sizeof(*temp) * max, false);
+		}
+		if (temp == NULL) {
+			return CYAML_ERR_OOM;
+		}
+
+		ctx->stack = temp;
+		ctx->max = max;
+	}
+
+	ctx->stack[ctx->idx++] = *frame;
+	return CYAML_OK;
+}
+
+/**
+ * Relocate the pointers in a value.
+ *
+ * The value's own pointer is relocated immediately.  Mappings and
+ * sequences that hold pointers are pushed onto the stack, to be walked by
+ * \ref cyaml__binary_run.
+ *
+ * \param[in]  ctx       The image relocation context.
+ * \param[in]  schema    The schema for the value.
+ * \param[in]  data      The value's data in the image.
+ * \param[in]  count     Entry count for sequence values.  Unused for
+ *                       non-sequence values.
+ * \param[in]  optional  Whether the value's pointer may be NULL.
+ * \return \ref CYAML_OK on success, or appropriate error code otherwise.
+ */
+static cyaml_err_t cyaml__binary_value(
+		cyaml_binary_ctx_t *ctx,
+		const cyaml_schema_value_t *schema,
+		uint8_t *data,
+		uint64_t count,
+		bool optional)
+{
+	cyaml_binary_frame_t frame;
+	cyaml_err_t err;
+
+	if (schema->type == CYAML_SEQUENCE_FIXED) {
+		count = schema->sequence.max;
+	} else if (schema->type == CYAML_SEQUENCE && !ctx->save) {
+		if (count < schema->sequence.min ||
+		    count > schema->sequence.max) {
+			return CYAML_ERR_BINARY_INVALID;
+		}
+	}
+
+	if (schema->flags & CYAML_FLAG_POINTER) {
+		err = cyaml__binary_pointer(ctx, schema, data, count, &data);
+		if (err != CYAML_OK) {
+			return err;
+		}
+		if (data == NULL) {
+			return optional ? CYAML_OK : CYAML_ERR_BINARY_INVALID;
+		}
+	}
+
+	switch (schema->type) {
+	case CYAML_MAPPING:
+		if (!cyaml__schema_has_pointers(ctx->config, schema)) {
+			return CYAML_OK;
+		}
+		count = 0;
+		break;
+	case CYAML_SEQUENCE: /* Fall through. */
+	case CYAML_SEQUENCE_FIXED:
+		if (!(schema->sequence.entry->flags & CYAML_FLAG_POINTER) &&
+		    !cyaml__schema_has_pointers(ctx->config,
+				schema->sequence.entry)) {
+			return CYAML_OK;
+		}
+		break;
+	default:
+		return CYAML_OK;
+	}
+
+	frame = (cyaml_binary_frame_t) {
+		.schema = schema,
+		.data = data,
+		.count = count,
+	};
+	return cyaml__binary_push(ctx, &frame);
+}
+
+/**
+ * Relocate the next field of the mapping at the top of the stack.
+ *
+ * Fields whose values hold no pointers are skipped.
+ *
+ * \param[in]  ctx       The image relocation context.
+ * \param[out] more_out  Returns false if the mapping has no more fields
+ *                       to relocate, true otherwise.
+ * \return \ref CYAML_OK on success, or appropriate error code otherwise.
+ */
+static cyaml_err_t cyaml__binary_mapping_next(
+		cyaml_binary_ctx_t *ctx,
+		bool *more_out)
+{
+	cyaml_binary_frame_t *frame = &ctx->stack[ctx->idx - 1];
+	const cyaml_schema_field_t *field;
+	const cyaml_schema_value_t *value;
+	uint64_t count = 0;
+	cyaml_err_t err;
+
+	field = frame->schema->mapping.fields + frame->next;
+	for (; field->key != NULL; field++) {
+		value = &field->value;
+		if (value->type != CYAML_IGNORE &&
+		    ((value->flags & CYAML_FLAG_POINTER) ||
+		     cyaml__schema_has_pointers(ctx->config, value))) {
+			break;
+		}
+	}
+	if (field->key == NULL) {
+		*more_out = false;
+		return CYAML_OK;
+	}
+	frame->next = (uint64_t)(field - frame->schema->mapping.fields) + 1;
+	*more_out = true;
+
+	if (value->type == CYAML_SEQUENCE) {
+		count = cyaml_data_read(field->count_size,
+				frame->data + cyaml_data_member_offset(
+					field->count_offset,
+					field->count_size,
+					frame->count, frame->column), &err);
+		if (err != CYAML_OK) {
+			return err;
+		}
+	}
+
+	/* Note: `frame` isn't valid after this, since relocating the value
+	 *       may grow the stack. */
+	return cyaml__binary_value(ctx, value,
+			frame->data + cyaml_data_member_offset(
+				field->data_offset,
+				cyaml_data_member_size(value),
+				frame->count, frame->column),
+			count, value->flags & CYAML_FLAG_OPTIONAL);
+}
+
+/**
+ * Relocate the next entry of the sequence at the top of the stack.
+ *
+ * \param[in]  ctx       The image relocation context.
+ * \param[out] more_out  Returns false if the sequence has no more entries
+ *                       to relocate, true otherwise.
+ * \return \ref CYAML_OK on success, or appropriate error code otherwise.
+ */
+static cyaml_err_t cyaml__binary_entries_next(
+		cyaml_binary_ctx_t *ctx,
+		bool *more_out)
+{
+	cyaml_binary_frame_t *frame = &ctx->stack[ctx->idx - 1];
+	const cyaml_schema_value_t *schema = frame->schema;
+	const cyaml_schema_value_t *value = schema->sequence.entry;
+	uint64_t seq_count = 0;
+	uint64_t i = frame->next;
+	size_t data_size;
+
+	if (i >= frame->count) {
+		*more_out = false;
+		return CYAML_OK;
+	}
+	frame->next++;
+	*more_out = true;
+
+	if ((schema->flags & CYAML_FLAG_COLUMNAR) &&
+	    cyaml_data_columnar_valid(schema)) {
+		cyaml_binary_frame_t column = {
+			.schema = value,
+			.data = frame->data,
+			.count = frame->count,
+			.column = i,
+		};
+
+		return cyaml__binary_push(ctx, &column);
+	}
+
+	if (value->type == CYAML_SEQUENCE_FIXED) {
+		seq_count = value->sequence.max;
+	}
+
+	if (value->flags & CYAML_FLAG_POINTER) {
+		data_size = sizeof(NULL);
+	} else {
+		data_size = value->data_size;
+		if (value->type == CYAML_SEQUENCE_FIXED) {
+			data_size *= seq_count;
+		}
+	}
+
+	return cyaml__binary_value(ctx, value,
+			frame->data + data_size * i, seq_count, false);
+}
+
+/**
+ * Relocate the pointers in an image's data.
+ *
+ * This walks the data with an explicit stack, rather than recursion, since
+ * schemas for recursively nesting data structures don't bound the depth.
+ *
+ * \param[in]  ctx     The image relocation context.
+ * \param[in]  schema  The top level schema value.
+ * \param[in]  root    Where the pointer to the top level value is stored.
+ * \param[in]  count   Top level sequence entry count.
+ * \return \ref CYAML_OK on success, or appropriate error code otherwise.
+ */
+static cyaml_err_t cyaml__binary_run(
+		cyaml_binary_ctx_t *ctx,
+		const cyaml_schema_value_t *schema,
+		uint8_t *root,
+		uint64_t count)
+{
+	cyaml_err_t err;
+
+	ctx->stack = ctx->local;
+	ctx->idx = 0;
+	ctx->max = CYAML_BINARY_STACK_LOCAL;
+
+	err = cyaml__binary_value(ctx, schema, root, count, false);
+	while (err == CYAML_OK && ctx->idx > 0) {
+		const cyaml_binary_frame_t *frame = &ctx->stack[ctx->idx - 1];
+		bool more;
+
+		if (frame->schema->type == CYAML_MAPPING) {
+			err = cyaml__binary_mapping_next(ctx, &more);
+		} else {
+			err = cyaml__binary_entries_next(ctx, &more);
+		}
+		if (err == CYAML_OK && !more) {
+			ctx->idx--;
+		}
+	}
+
+	if (ctx->stack != ctx->local) {
+		cyaml__free(ctx->config, ctx->stack);
+		ctx->stack = ctx->local;
+	}
+	return err;
+}
+
+/**
+ * Check that common binary image params from client are valid.
+ *
+ * \param[in] config  The client's CYAML library config.
+ * \param[in] schema  The schema describing the content of data.
+ * \return \ref CYAML_OK on success, or appropriate error code otherwise.
+ */
+static inline cyaml_err_t cyaml__binary_validate_params(
+		const cyaml_config_t *config,
+		const cyaml_schema_value_t *schema)
+{
+	if (config == NULL) {
+		return CYAML_ERR_BAD_PARAM_NULL_CONFIG;
+	}
+	if (config->mem_fn == NULL) {
+		return CYAML_ERR_BAD_CONFIG_NULL_MEMFN;
+	}
+	if (schema == NULL) {
+		return CYAML_ERR_BAD_PARAM_NULL_SCHEMA;
+	}
+	if (!(schema->flags & CYAML_FLAG_POINTER)) {
+		return CYAML_ERR_TOP_LEVEL_NON_PTR;
+	}
+	return CYAML_OK;
+}
+
+/* Exported function, documented in include/cyaml/cyaml.h */
+cyaml_err_t cyaml_save_binary(
+		uint8_t **output,
+		size_t *len,
+		const cyaml_config_t *config,
+		const cyaml_schema_value_t *schema,
+		const cyaml_data_t *data,
+		unsigned seq_count)
+{
+	cyaml_binary_header_t header = {
+		.version = CYAML_BINARY_VERSION,
+		.pointer_size = sizeof(char *),
+		.byte_order = CYAML_BINARY_BYTE_ORDER,
+	};
+	cyaml_binary_ctx_t ctx;
+	cyaml_data_t *copy = NULL;
+	uint8_t *image;
+	uint8_t *root;
+	cyaml_err_t err;
+	size_t size;
+
+	err = cyaml__binary_validate_params(config, schema);
+	if (err != CYAML_OK) {
+		return err;
+	}
+	if (output == NULL || len == NULL) {
+		return CYAML_ERR_BAD_PARAM_NULL_DATA;
+	}
+
+	err = cyaml__binary_fingerprint(config, schema, &header.fingerprint);
+	if (err != CYAML_OK) {
+		return err;
+	}
+
+	err = cyaml__copy_block(config, schema, data, seq_count, &copy, &size);
+	if (err != CYAML_OK) {
+		return err;
+	}
+
+	memcpy(header.magic, CYAML_BINARY_MAGIC, sizeof(header.magic));
+	header.seq_count = (schema->type == CYAML_SEQUENCE) ? seq_count : 0;
+	header.size = size;
+
+	ctx = (cyaml_binary_ctx_t) {
+		.config = config,
+		.base = copy,
+		.size = size,
+		.save = true,
+	};
+	root = copy;
+	err = cyaml__binary_run(&ctx, schema, (uint8_t *)&root,
+			header.seq_count);
+	if (err != CYAML_OK) {
+		goto out;
+	}
+
+	image = cyaml__alloc(config, sizeof(header) + size, false);
+	if (image == NULL) {
+		err = CYAML_ERR_OOM;
+		goto out;
+	}
+	memcpy(image, &header, sizeof(header));
+	memcpy(image + sizeof(header), copy, size);
+
+	cyaml__log(config, CYAML_LOG_DEBUG,
+			"Binary: Saved image: (%zu bytes)\n",
+			sizeof(header) + size);
+
+	*output = image;
+	*len = sizeof(header) + size;
+out:
+	cyaml_arena_free(config, copy);
+	return err;
+}
+
+/**
+ * Check a binary image header.
+ *
+ * \param[in]  config  The client's CYAML library config.
+ * \param[in]  schema  The schema the image should have been saved with.
+ * \param[in]  header  The image header.
+ * \param[in]  size    Size of the image data after the header in bytes.
+ * \return \ref CYAML_OK on success, or appropriate error code otherwise.
+ */
+static cyaml_err_t cyaml__binary_check_header(
+		const cyaml_config_t *config,
+		const cyaml_schema_value_t *schema,
+		const cyaml_binary_header_t *header,
+		size_t size)
+{
+	uint64_t fingerprint;
+	cyaml_err_t err;
+
+	if (memcmp(header->magic, CYAML_BINARY_MAGIC,
+			sizeof(header->magic)) != 0 ||
+	    header->version != CYAML_BINARY_VERSION) {
+		cyaml__log(config, CYAML_LOG_ERROR,
+				"Binary: Not a binary image\n");
+		return CYAML_ERR_BINARY_INVALID;
+	}
+	if (header->pointer_size != sizeof(char *) ||
+	    header->byte_order != CYAML_BINARY_BYTE_ORDER) {
+		cyaml__log(config, CYAML_LOG_ERROR,
+				"Binary: Image is for a different host\n");
+		return CYAML_ERR_BINARY_INVALID;
+	}
+
+	err = cyaml__binary_fingerprint(config, schema, &fingerprint);
+	if (err != CYAML_OK) {
+		return err;
+	}
+	if (header->fingerprint != fingerprint) {
+		cyaml__log(config, CYAML_LOG_ERROR,
+				"Binary: Image saved with different schema\n");
+		return CYAML_ERR_BINARY_SCHEMA;
+	}
+
+	if (header->size != size ||
+	    header->seq_count > UINT_MAX ||
+	    (schema->type != CYAML_SEQUENCE && header->seq_count != 0)) {
+		cyaml__log(config, CYAML_LOG_ERROR,
+				"Binary: Bad image header\n");
+		return CYAML_ERR_BINARY_INVALID;
+	}
+
+	return CYAML_OK;
+}
+
+/* Exported function, documented in include/cyaml/cyaml.h */
+cyaml_err_t cyaml_load_binary(
+		const uint8_t *input,
+		size_t input_len,
+		const cyaml_config_t *config,
+		const cyaml_schema_value_t *schema,
+		cyaml_data_t **data_out,
+		unsigned *seq_count_out)
+{
+	cyaml_binary_header_t header;
+	cyaml_binary_ctx_t ctx;
+	cyaml_arena_t arena;
+	uint8_t *root;
+	cyaml_err_t err;
+	size_t size;
+
+	err = cyaml__binary_validate_params(config, schema);
+	if (err != CYAML_OK) {
+		return err;
+	}
+	if ((schema->type == CYAML_SEQUENCE) != (seq_count_out != NULL)) {
+		return CYAML_ERR_BAD_PARAM_SEQ_COUNT;
+	}
+	if (input == NULL || data_out == NULL) {
+		return CYAML_ERR_BAD_PARAM_NULL_DATA;
+	}
+
+	if (input_len < sizeof(header)) {
+		cyaml__log(config, CYAML_LOG_ERROR,
+				"Binary: Image too short\n");
+		return CYAML_ERR_BINARY_INVALID;
+	}
+	memcpy(&header, input, sizeof(header));
+	size = input_len - sizeof(header);
+
+	err = cyaml__binary_check_header(config, schema, &header, size);
+	if (err != CYAML_OK) {
+		return err;
+	}
+
+	cyaml__arena_init(&arena, 0);
+	ctx = (cyaml_binary_ctx_t) {
+		.config = config,
+		.base = cyaml__arena_realloc(config, &arena, NULL, 0,
+				(size != 0) ? size : 1, false),
+		.size = size,
+		.save = false,
+	};
+	if (ctx.base == NULL) {
+		return CYAML_ERR_OOM;
+	}
+	memcpy(ctx.base, input + sizeof(header), size);
+
+	/* The top level value is always at the start of the image data. */
+	CYAML_UNUSED(cyaml_data_write(1, sizeof(char *), (uint8_t *)&root));
+	err = cyaml__binary_run(&ctx, schema, (uint8_t *)&root,
+			header.seq_count);
+	if (err != CYAML_OK) {
+		cyaml__log(config, CYAML_LOG_ERROR,
+				"Binary: Bad image data\n");
+		cyaml__arena_destroy(config, &arena);
+		return err;
+	}
+	assert(root == ctx.base);
+
+	cyaml__arena_finalise(&arena);
+	*data_out = root;
+	if (seq_count_out != NULL) {
+		*seq_count_out = (unsigned)header.seq_count;
+	}
+	return CYAML_OK;
+}
@@ -20,6 +20,26 @@
 #include "mem.h"
 #include "data.h"
 #include "util.h"
+#include "copy.h"
+#include "arena.h"
+#include "parallel.h"
+#include "schema.h"
+
+/**
+ * Minimum number of sequence entries for each thread of a parallel copy.
+ */
+#define CYAML_COPY_PARALLEL_ENTRIES_MIN 256
+
+/**
+ * A single allocation that a copy's pointer values are carved from.
+ *
+ * The block is allocated clean, and it is sized before the copy starts, so
+ * allocations from it are never resized or freed individually.
+ */
+typedef struct cyaml_copy_block {
+	uint8_t *next; /**< Start of the unused part of the block. */
+	uint8_t *end;  /**< End of the block. */
+} cyaml_copy_block_t;
 
 /**
  * A CYAML copy state machine stack entry.
@@ -44,6 +64,12 @@ typedef struct cyaml_state {
 			uint8_t *data;
 			uint8_t *c;
 			const cyaml_schema_field_t *field;
+			/** For entries of a \ref CYAML_FLAG_COLUMNAR
+			 *  sequence, the sequence entry count, or zero for
+			 *  other mappings. */
+			uint64_t columns;
+			/** Index of this entry in the columns. */
+			uint64_t column;
 		} mapping;
 		/** Additional state for \ref CYAML_STATE_IN_SEQUENCE state. */
 		struct {
@@ -63,6 +89,9 @@ typedef struct cyaml_state {
  */
 typedef struct cyaml_ctx {
 	const cyaml_config_t *config; /**< Settings provided by client. */
+	cyaml_arena_t *arena;   /**< Arena for copied data, or NULL. */
+	cyaml_copy_block_t *block; /**< Block for copied data, or NULL. */
+	unsigned threads;       /**< Threads to copy sequences with, or zero. */
 	cyaml_state_t *state;   /**< Current entry in state stack, or NULL. */
 	cyaml_state_t *stack;   /**< State stack */
 	uint32_t stack_idx;     /**< Next (empty) state stack slot */
@@ -83,6 +112,38 @@ static inline bool cyaml__is_sequence(const cyaml_schema_value_t *schema)
 	        (schema->type == CYAML_SEQUENCE_FIXED));
 }
 
+/**
+ * Get the offset of a mapping field's sequence count in the client data.
+ *
+ * \param[in]  state  The mapping's CYAML copy state.
+ * \param[in]  field  The \ref CYAML_SEQUENCE field to get the count offset
+ *                    for.
+ * \return Offset of the field's sequence entry count.
+ */
+static inline size_t cyaml__field_count_offset(
+		const cyaml_state_t *state,
+		const cyaml_schema_field_t *field)
+{
+	return cyaml_data_member_offset(field->count_offset, field->count_size,
+			state->mapping.columns, state->mapping.column);
+}
+
+/**
+ * Get the offset of a mapping field's value in the client data.
+ *
+ * \param[in]  state  The mapping's CYAML copy state.
+ * \param[in]  field  The field to get the value offset for.
+ * \return Offset of the field's value.
+ */
+static inline size_t cyaml__field_value_offset(
+		const cyaml_state_t *state,
+		const cyaml_schema_field_t *field)
+{
+	return cyaml_data_member_offset(field->data_offset,
+			cyaml_data_member_size(&field->value),
+			state->mapping.columns, state->mapping.column);
+}
+
 /**
  * Ensure that the CYAML copy context has space for a new stack entry.
  *
@@ -93,7 +154,7 @@ static cyaml_err_t cyaml__stack_ensure(
 		cyaml_ctx_t *ctx)
 {
 	cyaml_state_t *temp;
-	uint32_t max = ctx->stack_max + 16;
+	uint32_t max = (ctx->stack_max == 0) ? 16 : ctx->stack_max * 2;
 
 	CYAML_UNUSED(ctx);
 
@@ -151,6 +212,12 @@ static cyaml_err_t cyaml__stack_push(
 		break;
 	case CYAML_STATE_IN_SEQUENCE:
 		assert(cyaml__is_sequence(schema));
+		if ((schema->flags & CYAML_FLAG_COLUMNAR) &&
+		    !cyaml_data_columnar_valid(schema)) {
+			cyaml__log(ctx->config, CYAML_LOG_ERROR,
+					"Copy: Bad columnar sequence schema\n");
+			return CYAML_ERR_BAD_TYPE_IN_SCHEMA;
+		}
 		if (schema->type == CYAML_SEQUENCE_FIXED) {
 			if (schema->sequence.min != schema->sequence.max) {
 				return CYAML_ERR_SEQUENCE_FIXED_COUNT;
@@ -164,7 +231,8 @@ static cyaml_err_t cyaml__stack_push(
 				const cyaml_schema_field_t *field =
 						ctx->state->mapping.field - 1;
 				s.sequence.count_data = ctx->state->copy +
-						field->count_offset;
+						cyaml__field_count_offset(
+							ctx->state, field);
 				s.sequence.count_size = field->count_size;
 			} else {
 				assert(ctx->state->state == CYAML_STATE_START);
@@ -214,6 +282,37 @@ static cyaml_err_t cyaml__stack_pop(
 	return CYAML_OK;
 }
 
+/**
+ * Make an allocation for a copied pointer value.
+ *
+ * \param[in]  ctx   The CYAML copying context.
+ * \param[in]  size  Size of the allocation in bytes.
+ * \return Pointer to clean allocation on success, or `NULL` on failure.
+ */
+static uint8_t * cyaml__copy_alloc(
+		const cyaml_ctx_t *ctx,
+		size_t size)
+{
+	if (ctx->block != NULL) {
+		cyaml_copy_block_t *block = ctx->block;
+		uint8_t *ptr = block->next;
+
+		size = cyaml__arena_align(size);
+		if ((size_t)(block->end - ptr) < size) {
+			/* The sizing pass disagrees with the copy; the client
+			 * data must have changed under us. */
+			assert(false);
+			return NULL;
+		}
+
+		block->next += size;
+		return ptr;
+	}
+
+	return cyaml__data_realloc(ctx->config, ctx->arena,
+			NULL, 0, size, true);
+}
+
 /**
  * Helper to handle \ref CYAML_FLAG_POINTER.
  *
@@ -269,7 +368,7 @@ static cyaml_err_t cyaml__data_handle_pointer(
 		cyaml__log(ctx->config, CYAML_LOG_DEBUG,
 				"Copy: Allocating: (%zu bytes)\n", delta);
 
-		value_copy = cyaml__alloc(ctx->config, delta, true);
+		value_copy = cyaml__copy_alloc(ctx, delta);
 		if (value_copy == NULL) {
 			return CYAML_ERR_OOM;
 		}
@@ -396,6 +495,383 @@ static cyaml_err_t cyaml__write_sequence_count(
 	return err;
 }
 
+static size_t cyaml__size_value(
+		const cyaml_config_t *config,
+		const cyaml_schema_value_t *schema,
+		const uint8_t *data,
+		uint64_t count,
+		uint32_t depth,
+		uint32_t *depth_max);
+
+/**
+ * Get the size of the allocations needed to copy a mapping.
+ *
+ * \param[in]  config     The client's CYAML library config.
+ * \param[in]  schema     The schema for the mapping.
+ * \param[in]  data       The mapping's client data.
+ * \param[in]  columns    For entries of a \ref CYAML_FLAG_COLUMNAR
+ *                        sequence, the sequence entry count, or zero.
+ * \param[in]  column     Index of this entry in the columns.
+ * \param[in]  depth      Copy state stack depth of the mapping.
+ * \param[out] depth_max  Updated to the deepest copy state stack depth.
+ * \return the size in bytes.
+ */
+static size_t cyaml__size_mapping(
+		const cyaml_config_t *config,
+		const cyaml_schema_value_t *schema,
+		const uint8_t *data,
+		uint64_t columns,
+		uint64_t column,
+		uint32_t depth,
+		uint32_t *depth_max)
+{
+	const cyaml_schema_field_t *field = schema->mapping.fields;
+	size_t size = 0;
+
+	for (; field->key != NULL; field++) {
+		uint64_t count = 0;
+
+		if (field->value.type == CYAML_IGNORE ||
+		    field->value.flags & CYAML_FLAG_LAZY) {
+			continue;
+		}
+		if (field->value.type == CYAML_SEQUENCE) {
+			cyaml_err_t err;
+			count = cyaml_data_read(field->count_size,
+					data + cyaml_data_member_offset(
+						field->count_offset,
+						field->count_size,
+						columns, column), &err);
+			if (err != CYAML_OK) {
+				return size;
+			}
+		}
+		size += cyaml__size_value(config, &field->value,
+				data + cyaml_data_member_offset(
+					field->data_offset,
+					cyaml_data_member_size(&field->value),
+					columns, column),
+				count, depth, depth_max);
+	}
+
+	return size;
+}
+
+/**
+ * Get the size of the allocations needed to copy a sequence's entries.
+ *
+ * \param[in]  config     The client's CYAML library config.
+ * \param[in]  schema     The schema for the sequence.
+ * \param[in]  data       The sequence's client data.
+ * \param[in]  first      Index of the first entry to size.
+ * \param[in]  end        Index after the last entry to size.
+ * \param[in]  depth      Copy state stack depth of the sequence.
+ * \param[out] depth_max  Updated to the deepest copy state stack depth.
+ * \return the size in bytes.
+ */
+static size_t cyaml__size_entries(
+		const cyaml_config_t *config,
+		const cyaml_schema_value_t *schema,
+		const uint8_t *data,
+		uint64_t first,
+		uint64_t end,
+		uint32_t depth,
+		uint32_t *depth_max)
+{
+	const cyaml_schema_value_t *value = schema->sequence.entry;
+	bool columnar = (schema->flags & CYAML_FLAG_COLUMNAR) &&
+			cyaml_data_columnar_valid(schema);
+	uint64_t seq_count = 0;
+	uint64_t last = end;
+	size_t data_size;
+	size_t size = 0;
+
+	if (value->type == CYAML_SEQUENCE_FIXED) {
+		seq_count = value->sequence.max;
+	}
+
+	if (value->flags & CYAML_FLAG_POINTER) {
+		data_size = sizeof(NULL);
+	} else {
+		data_size = value->data_size;
+		if (value->type == CYAML_SEQUENCE_FIXED) {
+			data_size *= seq_count;
+		}
+	}
+
+	if (!(value->flags & CYAML_FLAG_POINTER) &&
+	    !cyaml__schema_has_pointers(config, value)) {
+		/* Entries are stored in the sequence's own allocation,
+		 * so only one entry needs to be walked, for its depth. */
+		last = (first < end) ? first + 1 : end;
+	}
+
+	for (uint64_t i = first; i < last; i++) {
+		if (columnar) {
+			/* Columnar sequences are only sized whole, so the
+			 * end is the entry count. */
+			size += cyaml__size_mapping(config, value, data, end, i,
+					depth, depth_max);
+			continue;
+		}
+		size += cyaml__size_value(config, value, data + data_size * i,
+				seq_count, depth, depth_max);
+	}
+
+	return size;
+}
+
+/**
+ * Get the size of the allocations needed to copy a value.
+ *
+ * This mirrors the allocations that copying the value makes, with each
+ * allocation rounded up to the arena alignment.
+ *
+ * \param[in]  config     The client's CYAML library config.
+ * \param[in]  schema     The schema for the value.
+ * \param[in]  data       The value's client data.
+ * \param[in]  count      Entry count for sequence values.  Unused for
+ *                        non-sequence values.
+ * \param[in]  depth      Copy state stack depth of the value's parent.
+ * \param[out] depth_max  Updated to the deepest copy state stack depth.
+ * \return the size in bytes.
+ */
+static size_t cyaml__size_value(
+		const cyaml_config_t *config,
+		const cyaml_schema_value_t *schema,
+		const uint8_t *data,
+		uint64_t count,
+		uint32_t depth,
+		uint32_t *depth_max)
+{
+	size_t size = 0;
+
+	if (schema->type == CYAML_SEQUENCE_FIXED) {
+		count = schema->sequence.max;
+	}
+
+	if (schema->flags & CYAML_FLAG_POINTER) {
+		data = cyaml_data_read_pointer(data);
+		if (data == NULL) {
+			return 0;
+		}
+
+		switch (schema->type) {
+		case CYAML_STRING:
+			size = strlen((const char *)data) + 1;
+			break;
+		case CYAML_SEQUENCE: /* Fall through. */
+		case CYAML_SEQUENCE_FIXED:
+			size = schema->data_size * count;
+			break;
+		default:
+			size = schema->data_size;
+			break;
+		}
+		size = cyaml__arena_align(size);
+	}
+
+	if (schema->type == CYAML_MAPPING || cyaml__is_sequence(schema)) {
+		depth++;
+		if (*depth_max < depth) {
+			*depth_max = depth;
+		}
+	}
+
+	if (schema->type == CYAML_MAPPING) {
+		size += cyaml__size_mapping(config, schema, data, 0, 0,
+				depth, depth_max);
+	} else if (cyaml__is_sequence(schema)) {
+		size += cyaml__size_entries(config, schema, data, 0, count,
+				depth, depth_max);
+	}
+
+	return size;
+}
+
+/**
+ * Run the copy state machine to clone a value.
+ *
+ * \param[in]  ctx        The CYAML copying context.  Its stack must be empty.
+ * \param[in]  schema     CYAML schema for the value.
+ * \param[in]  data       The place to read the value from in the client data.
+ * \param[in]  seq_count  Entry count for sequence values.  Unused for
+ *                        non-sequence values.
+ * \param[in]  copy       Pointer to where value's data should be written.
+ * \return \ref CYAML_OK on success, or appropriate error code otherwise.
+ *         On failure, the stack is left as it was when the error happened.
+ */
+static cyaml_err_t cyaml__clone_run(
+		cyaml_ctx_t *ctx,
+		const cyaml_schema_value_t *schema,
+		const uint8_t *data,
+		unsigned seq_count,
+		uint8_t *copy);
+
+/**
+ * A parallel copy job, for a range of a sequence's entries.
+ */
+typedef struct cyaml_copy_job {
+	cyaml_ctx_t ctx;            /**< Copying context for the job. */
+	cyaml_config_t config;      /**< Client config, without logging. */
+	cyaml_copy_block_t block;   /**< Part of the block for the job. */
+	const cyaml_schema_value_t *schema; /**< The sequence's schema. */
+	const uint8_t *data; /**< The sequence's entries in the client data. */
+	uint8_t *copy;       /**< The sequence's entries in the copy. */
+	uint64_t first;      /**< Index of the job's first entry. */
+	uint64_t end;        /**< Index after the job's last entry. */
+	cyaml_err_t err;     /**< Result of the job. */
+} cyaml_copy_job_t;
+
+/**
+ * Parallel copy job function.
+ *
+ * \param[in]  job_in  The \ref cyaml_copy_job_t to run.
+ */
+static void cyaml__clone_job(void *job_in)
+{
+	cyaml_copy_job_t *job = job_in;
+	const cyaml_schema_value_t *value = job->schema->sequence.entry;
+	unsigned seq_count = 0;
+	size_t data_size;
+
+	if (value->type == CYAML_SEQUENCE_FIXED) {
+		seq_count = value->sequence.max;
+	}
+
+	if (value->flags & CYAML_FLAG_POINTER) {
+		data_size = sizeof(NULL);
+	} else {
+		data_size = value->data_size;
+		if (value->type == CYAML_SEQUENCE_FIXED) {
+			data_size *= seq_count;
+		}
+	}
+
+	for (uint64_t i = job->first; i < job->end; i++) {
+		job->err = cyaml__clone_run(&job->ctx, value,
+				job->data + data_size * i, seq_count,
+				job->copy + data_size * i);
+		if (job->err != CYAML_OK) {
+			return;
+		}
+	}
+}
+
+/**
+ * Clone the entries of the current sequence state across threads.
+ *
+ * Each thread clones a range of the entries into its own part of the
+ * block.  The parts are sized before the threads start, so the threads
+ * never allocate, or call any other client callbacks.
+ *
+ * Sequences that are too small, columnar sequences, and sequences of
+ * sequences are left for the copy state machine to clone serially.
+ *
+ * \param[in]  ctx  The CYAML copying context.
+ * \return \ref CYAML_OK on success, or appropriate error code otherwise.
+ */
+static cyaml_err_t cyaml__clone_parallel(
+		cyaml_ctx_t *ctx)
+{
+	cyaml_copy_job_t jobs[CYAML_PARALLEL_CHUNKS_MAX];
+	cyaml_state_t *state = ctx->state;
+	const cyaml_schema_value_t *schema = state->schema;
+	uint64_t count = state->sequence.count;
+	cyaml_err_t err = CYAML_OK;
+	cyaml_stats_t *stats;
+	uint64_t chunks_max;
+	unsigned count_jobs;
+
+	if ((schema->flags & CYAML_FLAG_COLUMNAR) ||
+	    (schema->sequence.entry->type == CYAML_SEQUENCE)) {
+		return CYAML_OK;
+	}
+
+	chunks_max = count / CYAML_COPY_PARALLEL_ENTRIES_MIN;
+	if (chunks_max > ctx->threads) {
+		chunks_max = ctx->threads;
+	}
+	if (chunks_max > CYAML_PARALLEL_CHUNKS_MAX) {
+		chunks_max = CYAML_PARALLEL_CHUNKS_MAX;
+	}
+	if (chunks_max < 2) {
+		return CYAML_OK;
+	}
+
+	count_jobs = (unsigned)chunks_max;
+	for (unsigned i = 0; i < count_jobs; i++) {
+		cyaml_copy_job_t *job = &jobs[i];
+		uint32_t depth_max = 1;
+		size_t size;
+
+		*job = (cyaml_copy_job_t) {
+			.config = *ctx->config,
+			.schema = schema,
+			.data = state->data,
+			.copy = state->copy,
+			.first = count * i / count_jobs,
+			.end = count * (i + 1) / count_jobs,
+		};
+		job->config.log_fn = NULL;
+
+		size = cyaml__size_entries(ctx->config, schema, state->data,
+				job->first, job->end, 1, &depth_max);
+		if ((size_t)(ctx->block->end - ctx->block->next) < size) {
+			assert(false);
+			err = CYAML_ERR_OOM;
+			count_jobs = i;
+			goto out;
+		}
+		job->block.next = ctx->block->next;
+		job->block.end = ctx->block->next + size;
+		ctx->block->next += size;
+
+		/* The job's stack is allocated up front, so that it never
+		 * needs to grow on the job's thread. */
+		job->ctx = (cyaml_ctx_t) {
+			.config = &job->config,
+			.block = &job->block,
+			.stack = cyaml__alloc(ctx->config,
+					sizeof(cyaml_state_t) * depth_max,
+					false),
+			.stack_max = depth_max,
+		};
+		if (job->ctx.stack == NULL) {
+			err = CYAML_ERR_OOM;
+			count_jobs = i;
+			goto out;
+		}
+	}
+
+	cyaml__log(ctx->config, CYAML_LOG_DEBUG,
+			"Copy: Parallel: Cloning %"PRIu64" entries "
+			"in %u chunks\n", count, count_jobs);
+
+	cyaml__parallel_run(cyaml__clone_job,
+			jobs, sizeof(*jobs), count_jobs);
+
+	for (unsigned i = 0; i < count_jobs; i++) {
+		if (jobs[i].err != CYAML_OK) {
+			err = jobs[i].err;
+			break;
+		}
+	}
+
+	stats = cyaml__stats(ctx->config);
+	if (stats != NULL) {
+		stats->parallel_chunks += count_jobs;
+	}
+
+	/* All of the entries are done. */
+	state->sequence.entry = count;
+out:
+	for (unsigned i = 0; i < count_jobs; i++) {
+		cyaml__free(ctx->config, jobs[i].ctx.stack);
+	}
+	return err;
+}
+
 /**
  * Handle a YAML event corresponding to a YAML data value.
  *
@@ -463,6 +939,9 @@ static cyaml_err_t cyaml__clone_value(
 		err = cyaml__write_sequence_count(ctx, schema, seq_count);
 		ctx->state->data = data;
 		ctx->state->copy = copy;
+		if (err == CYAML_OK && ctx->threads > 1) {
+			err = cyaml__clone_parallel(ctx);
+		}
 		break;
 	default:
 		err = CYAML_ERR_BAD_TYPE_IN_SCHEMA;
@@ -502,6 +981,7 @@ static cyaml_err_t cyaml__clone_mapping(
 
 	if (field != NULL && field->key != NULL) {
 		uint64_t seq_count = 0;
+		size_t offset;
 
 		if (field->value.type == CYAML_IGNORE) {
 			ctx->state->mapping.field++;
@@ -510,13 +990,23 @@ static cyaml_err_t cyaml__clone_mapping(
 		cyaml__log(ctx->config, CYAML_LOG_INFO,
 				"Copy: [%s]\n", field->key);
 
+		if (field->value.flags & CYAML_FLAG_LAZY) {
+			/* Lazy values refer to the input, which is shared. */
+			offset = cyaml__field_value_offset(state, field);
+			memcpy(state->copy + offset, state->data + offset,
+					sizeof(cyaml_lazy_t));
+			ctx->state->mapping.field++;
+			return CYAML_OK;
+		}
+
 		/* Advance the field before writing value, since writing the
 		 * value can put a new state entry on the stack. */
 		ctx->state->mapping.field++;
 
 		if (field->value.type == CYAML_SEQUENCE) {
 			seq_count = cyaml_data_read(field->count_size,
-					ctx->state->data + field->count_offset,
+					state->data + cyaml__field_count_offset(
+						state, field),
 					&err);
 			if (err != CYAML_OK) {
 				return err;
@@ -529,11 +1019,12 @@ static cyaml_err_t cyaml__clone_mapping(
 			seq_count = field->value.sequence.min;
 		}
 
+		offset = cyaml__field_value_offset(state, field);
 		err = cyaml__clone_value(ctx,
 				&field->value,
-				state->data + field->data_offset,
+				state->data + offset,
 				seq_count,
-				state->copy + field->data_offset);
+				state->copy + offset);
 		if (err == CYAML_ERR_BAD_PARAM_NULL_DATA) {
 			if (!(field->value.flags & CYAML_FLAG_OPTIONAL)) {
 				return CYAML_ERR_MAPPING_FIELD_MISSING;
@@ -588,6 +1079,20 @@ static cyaml_err_t cyaml__clone_sequence(
 		 * value can put a new state entry on the stack. */
 		ctx->state->sequence.entry++;
 
+		if (schema->flags & CYAML_FLAG_COLUMNAR) {
+			uint64_t columns = ctx->state->sequence.count;
+			uint64_t column = ctx->state->sequence.entry - 1;
+
+			err = cyaml__clone_value(ctx, value,
+					ctx->state->data, seq_count,
+					ctx->state->copy);
+			if (err == CYAML_OK) {
+				ctx->state->mapping.columns = columns;
+				ctx->state->mapping.column = column;
+			}
+			return err;
+		}
+
 		err = cyaml__clone_value(ctx, value,
 				ctx->state->data + offset,
 				seq_count,
@@ -660,19 +1165,14 @@ static size_t cyaml__get_data_len(
 	return len;
 }
 
-/* Exported function, documented in include/cyaml/cyaml.h */
-cyaml_err_t cyaml_copy(
-		const cyaml_config_t *config,
+/* This function is documented at the forward declaration above. */
+static cyaml_err_t cyaml__clone_run(
+		cyaml_ctx_t *ctx,
 		const cyaml_schema_value_t *schema,
-		const cyaml_data_t *data,
+		const uint8_t *data,
 		unsigned seq_count,
-		cyaml_data_t **data_out)
+		uint8_t *copy)
 {
-	cyaml_data_t *copy = NULL;
-	cyaml_ctx_t ctx = {
-		.config = config,
-		.seq_count = seq_count,
-	};
 	typedef cyaml_err_t (* const cyaml_clone_fn)(
 			cyaml_ctx_t *ctx);
 	static const cyaml_clone_fn fn[CYAML_STATE__COUNT] = {
@@ -681,6 +1181,65 @@ cyaml_err_t cyaml_copy(
 		[CYAML_STATE_IN_MAP_VALUE] = cyaml__clone_mapping,
 		[CYAML_STATE_IN_SEQUENCE]  = cyaml__clone_sequence,
 	};
+	cyaml_err_t err;
+
+	assert(ctx->stack_idx == 0);
+
+	ctx->seq_count = seq_count;
+	err = cyaml__stack_push(ctx, CYAML_STATE_START, schema, data, copy);
+	if (err != CYAML_OK) {
+		return err;
+	}
+
+	do {
+		cyaml__log(ctx->config, CYAML_LOG_DEBUG,
+				"Copy: Handle state %s\n",
+				cyaml__state_to_str(ctx->state->state));
+		err = fn[ctx->state->state](ctx);
+		if (err != CYAML_OK) {
+			return err;
+		}
+	} while (ctx->stack_idx > 1);
+
+	return cyaml__stack_pop(ctx);
+}
+
+/**
+ * Copy a document, optionally into an arena or a pre-sized block.
+ *
+ * \param[in]  config     Client's CYAML configuration structure.
+ * \param[in]  arena      Arena to allocate copied pointer values from,
+ *                        or NULL.
+ * \param[in]  block      Block to allocate copied pointer values from,
+ *                        or NULL.
+ * \param[in]  threads    Number of threads to clone large sequences with,
+ *                        or zero.  Only used with a block.
+ * \param[in]  schema     CYAML schema for the YAML to be copied.
+ * \param[in]  data       The caller-owned data to be copied.
+ * \param[in]  seq_count  If top level type is sequence, this should be the
+ *                        entry count, otherwise it is ignored.
+ * \param[out] data_out   Returns the caller-owned loaded data on success.
+ *                        Untouched on failure.
+ * \return \ref CYAML_OK on success, or appropriate error code otherwise.
+ */
+static cyaml_err_t cyaml__copy_internal(
+		const cyaml_config_t *config,
+		cyaml_arena_t *arena,
+		cyaml_copy_block_t *block,
+		unsigned threads,
+		const cyaml_schema_value_t *schema,
+		const cyaml_data_t *data,
+		unsigned seq_count,
+		cyaml_data_t **data_out)
+{
+	cyaml_data_t *copy = NULL;
+	cyaml_ctx_t ctx = {
+		.config = config,
+		.arena = arena,
+		.block = block,
+		.threads = (block != NULL) ? threads : 0,
+		.seq_count = seq_count,
+	};
 	cyaml_err_t err = CYAML_OK;
 
 	err = cyaml__validate_copy_params(config, schema, seq_count, data_out);
@@ -700,25 +1259,16 @@ cyaml_err_t cyaml_copy(
 		}
 	}
 
-	err = cyaml__stack_push(&ctx, CYAML_STATE_START, schema,
-			(schema->flags & CYAML_FLAG_POINTER) ? &data : data,
-			(schema->flags & CYAML_FLAG_POINTER) ? &copy : copy);
+	err = cyaml__clone_run(&ctx, schema,
+			(schema->flags & CYAML_FLAG_POINTER) ?
+					(const uint8_t *)&data : data,
+			seq_count,
+			(schema->flags & CYAML_FLAG_POINTER) ?
+					(uint8_t *)&copy : copy);
 	if (err != CYAML_OK) {
 		goto out;
 	}
 
-	do {
-		cyaml__log(ctx.config, CYAML_LOG_DEBUG,
-				"Copy: Handle state %s\n",
-				cyaml__state_to_str(ctx.state->state));
-		err = fn[ctx.state->state](&ctx);
-		if (err != CYAML_OK) {
-			goto out;
-		}
-	} while (ctx.stack_idx > 1);
-
-	cyaml__stack_pop(&ctx);
-
 	assert(ctx.stack_idx == 0);
 
 	if (!(schema->flags & CYAML_FLAG_POINTER)) {
@@ -733,7 +1283,9 @@ cyaml_err_t cyaml_copy(
 	}
 out:
 	if (err != CYAML_OK) {
-		cyaml_free(config, schema, copy, ctx.seq_count);
+		if (arena == NULL && block == NULL) {
+			cyaml_free(config, schema, copy, ctx.seq_count);
+		}
 		cyaml__backtrace(&ctx);
 	}
 	if (!(schema->flags & CYAML_FLAG_POINTER)) {
@@ -745,3 +1297,101 @@ out:
 	cyaml__free(config, ctx.stack);
 	return err;
 }
+
+/* Exported function, documented in copy.h. */
+cyaml_err_t cyaml__copy(
+		const cyaml_config_t *config,
+		cyaml_arena_t *arena,
+		const cyaml_schema_value_t *schema,
+		const cyaml_data_t *data,
+		unsigned seq_count,
+		cyaml_data_t **data_out)
+{
+	return cyaml__copy_internal(config, arena, NULL, 0,
+			schema, data, seq_count, data_out);
+}
+
+/* Exported function, documented in copy.h. */
+cyaml_err_t cyaml__copy_block(
+		const cyaml_config_t *config,
+		const cyaml_schema_value_t *schema,
+		const cyaml_data_t *data,
+		unsigned seq_count,
+		cyaml_data_t **data_out,
+		size_t *size_out)
+{
+	cyaml_copy_block_t block;
+	cyaml_arena_t arena;
+	uint32_t depth_max = 0;
+	unsigned threads = 0;
+	uint8_t *root;
+	cyaml_err_t err;
+	size_t size;
+
+	err = cyaml__validate_copy_params(config, schema, seq_count, data_out);
+	if (err != CYAML_OK) {
+		if (config != NULL) {
+			cyaml__log(config, CYAML_LOG_ERROR,
+					"Copy: Bad call parameters\n");
+		}
+		return err;
+	}
+	if (!(schema->flags & CYAML_FLAG_POINTER)) {
+		cyaml__log(config, CYAML_LOG_ERROR,
+				"Copy: Top level schema value must be pointer "
+				"for single allocation copy\n");
+		return CYAML_ERR_TOP_LEVEL_NON_PTR;
+	}
+
+	size = cyaml__size_value(config, schema,
+			(const uint8_t *)&data, seq_count,
+			0, &depth_max);
+
+	cyaml__log(config, CYAML_LOG_DEBUG,
+			"Copy: Allocating block: (%zu bytes)\n", size);
+
+	cyaml__arena_init(&arena, 0);
+	root = cyaml__arena_realloc(config, &arena, NULL, 0,
+			(size != 0) ? size : 1, true);
+	if (root == NULL) {
+		return CYAML_ERR_OOM;
+	}
+	block.next = root;
+	block.end = root + size;
+
+	if (config->flags & CYAML_CFG_PARALLEL) {
+		threads = cyaml__parallel_threads(config);
+	}
+
+	err = cyaml__copy_internal(config, NULL, &block, threads,
+			schema, data, seq_count, data_out);
+	if (err != CYAML_OK) {
+		cyaml__arena_destroy(config, &arena);
+		return err;
+	}
+
+	assert(*data_out == root);
+	assert(block.next == block.end);
+
+	cyaml__arena_finalise(&arena);
+	if (size_out != NULL) {
+		*size_out = size;
+	}
+	return CYAML_OK;
+}
+
+/* Exported function, documented in include/cyaml/cyaml.h */
+cyaml_err_t cyaml_copy(
+		const cyaml_config_t *config,
+		const cyaml_schema_value_t *schema,
+		const cyaml_data_t *data,
+		unsigned seq_count,
+		cyaml_data_t **data_out)
+{
+	if (config != NULL && (config->flags & CYAML_CFG_COPY_BLOCK)) {
+		return cyaml__copy_block(config, schema, data,
+				seq_count, data_out, NULL);
+	}
+
+	return cyaml__copy(config, NULL, schema, data, seq_count, data_out);
+}
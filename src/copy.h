@@ -0,0 +1,71 @@
+/*
+ * SPDX-License-Identifier: ISC
+ *
+ * Copyright (C) 2026 Michael Drake <tlsa@netsurf-browser.org>
+ */
+
+/**
+ * \file
+ * \brief CYAML internal data copying interface.
+ */
+
+#ifndef CYAML_COPY_H
+#define CYAML_COPY_H
+
+#include "cyaml/cyaml.h"
+
+#include "arena.h"
+
+/**
+ * Copy a loaded document, optionally allocating the copy from an arena.
+ *
+ * This is \ref cyaml_copy, with an additional arena parameter.
+ *
+ * \param[in]  config     Client's CYAML configuration structure.
+ * \param[in]  arena      Arena to allocate copied pointer values from,
+ *                        or NULL to use the client's allocator.
+ * \param[in]  schema     CYAML schema for the YAML to be copied.
+ * \param[in]  data       The caller-owned data to be copied.
+ * \param[in]  seq_count  If top level type is sequence, this should be the
+ *                        entry count, otherwise it is ignored.
+ * \param[out] data_out   Returns the caller-owned loaded data on success.
+ *                        Untouched on failure.
+ * \return \ref CYAML_OK on success, or appropriate error code otherwise.
+ */
+cyaml_err_t cyaml__copy(
+		const cyaml_config_t *config,
+		cyaml_arena_t *arena,
+		const cyaml_schema_value_t *schema,
+		const cyaml_data_t *data,
+		unsigned seq_count,
+		cyaml_data_t **data_out);
+
+/**
+ * Copy a document into a single allocation.
+ *
+ * The size of everything the copy allocates is found first, and the copy
+ * is made into one block of that size.  The block is the root allocation
+ * of an arena with no chunks, so that it can be freed with
+ * \ref cyaml_arena_free.
+ *
+ * \param[in]  config     Client's CYAML configuration structure.
+ * \param[in]  schema     CYAML schema for the YAML to be copied.  The top
+ *                        level value must have \ref CYAML_FLAG_POINTER.
+ * \param[in]  data       The caller-owned data to be copied.
+ * \param[in]  seq_count  If top level type is sequence, this should be the
+ *                        entry count, otherwise it is ignored.
+ * \param[out] data_out   Returns the caller-owned loaded data on success.
+ *                        Untouched on failure.
+ * \param[out] size_out   Returns the size of the block in bytes on success,
+ *                        or may be NULL.
+ * \return \ref CYAML_OK on success, or appropriate error code otherwise.
+ */
+cyaml_err_t cyaml__copy_block(
+		const cyaml_config_t *config,
+		const cyaml_schema_value_t *schema,
+		const cyaml_data_t *data,
+		unsigned seq_count,
+		cyaml_data_t **data_out,
+		size_t *size_out);
+
+#endif
@@ -12,6 +12,8 @@
 #ifndef CYAML_DATA_H
 #define CYAML_DATA_H
 
+#include <limits.h>
+
 #include "cyaml/cyaml.h"
 #include "util.h"
 
@@ -99,6 +101,30 @@ static inline uint64_t cyaml_data_read(
 	return ret;
 }
 
+/**
+ * Pad a signed value that's smaller than 64-bit to an int64_t.
+ *
+ * This sets all the bits in the padded region.
+ *
+ * \param[in]  raw   Contains a signed value of size bytes.
+ * \param[in]  size  Number of bytes used in raw.
+ * \return Value padded to 64-bit signed.
+ */
+static inline int64_t cyaml_data_sign_pad(
+		uint64_t raw,
+		size_t size)
+{
+	uint64_t sign_bit = (size == 0) ?
+			UINT64_MAX : ((uint64_t)1) << (size * CHAR_BIT - 1);
+	unsigned padding = ((unsigned)(sizeof(raw) - size)) * CHAR_BIT;
+
+	if ((sign_bit & raw) && (padding != 0)) {
+		raw |= (((uint64_t)1 << padding) - 1) << (size * CHAR_BIT);
+	}
+
+	return (int64_t)raw;
+}
+
 /**
  * Read a pointer from data.
  *
@@ -152,4 +178,84 @@ static inline const uint8_t * cyaml_data_save_handle_pointer(
 	return data_in;
 }
 
+/**
+ * Check whether a sequence schema is a valid \ref CYAML_FLAG_COLUMNAR one.
+ *
+ * \param[in]  schema  The \ref CYAML_FLAG_COLUMNAR sequence schema.
+ * \return true if the schema can be stored as columns, false otherwise.
+ */
+static inline bool cyaml_data_columnar_valid(
+		const cyaml_schema_value_t *schema)
+{
+	const cyaml_schema_value_t *entry = schema->sequence.entry;
+
+	return schema->type == CYAML_SEQUENCE &&
+			(schema->flags & CYAML_FLAG_POINTER) &&
+			entry->type == CYAML_MAPPING &&
+			!(entry->flags & CYAML_FLAG_POINTER) &&
+			entry->mapping.validation_cb == NULL;
+}
+
+/**
+ * Check whether a mapping field's value schema is a valid lazy one.
+ *
+ * \param[in]  schema  The \ref CYAML_FLAG_LAZY field value schema.
+ * \return true if the value can be loaded lazily, false otherwise.
+ */
+static inline bool cyaml_data_lazy_valid(
+		const cyaml_schema_value_t *schema)
+{
+	return (schema->type == CYAML_MAPPING ||
+	        schema->type == CYAML_SEQUENCE ||
+	        schema->type == CYAML_SEQUENCE_FIXED) &&
+			(schema->flags & CYAML_FLAG_POINTER);
+}
+
+/**
+ * Get the size of the client data for a mapping field's value.
+ *
+ * \param[in]  schema  The field's value schema.
+ * \return the size in bytes of the structure member for the value.
+ */
+static inline size_t cyaml_data_member_size(
+		const cyaml_schema_value_t *schema)
+{
+	if (schema->flags & CYAML_FLAG_LAZY) {
+		return sizeof(cyaml_lazy_t);
+	} else if (schema->flags & CYAML_FLAG_POINTER) {
+		return sizeof(NULL);
+	} else if (schema->type == CYAML_SEQUENCE_FIXED) {
+		return (size_t)schema->data_size * schema->sequence.max;
+	}
+
+	return schema->data_size;
+}
+
+/**
+ * Get the offset of a structure member in a mapping's client data.
+ *
+ * For mappings that are entries in a \ref CYAML_FLAG_COLUMNAR sequence,
+ * the mapping's client data is the start of the sequence data, and each
+ * member is found in its column.
+ *
+ * \param[in]  offset   Offset of the member in the structure.
+ * \param[in]  size     Size of the member.
+ * \param[in]  columns  Number of entries each column has space for, or
+ *                      zero if the mapping isn't stored as columns.
+ * \param[in]  column   The mapping's index in the columns.
+ * \return the offset of the member from the mapping's client data.
+ */
+static inline size_t cyaml_data_member_offset(
+		size_t offset,
+		size_t size,
+		size_t columns,
+		size_t column)
+{
+	if (columns == 0) {
+		return offset;
+	}
+
+	return offset * columns + size * column;
+}
+
 #endif
@@ -0,0 +1,1017 @@
+/*
+ * SPDX-License-Identifier: ISC
+ *
+ * Copyright (C) 2026 Michael Drake <tlsa@netsurf-browser.org>
+ */
+
+/**
+ * \file
+ * \brief CYAML native emitter.
+ *
+ * This handles a single document of block and flow mappings and sequences,
+ * with plain, single quoted and double quoted scalars of printable ASCII.
+ * Anything else, for example anchors, aliases, explicit tags, block scalars,
+ * complex keys, and scalars with other characters, is reported as
+ * unsupported, so the caller can use `libyaml` instead.
+ *
+ * It follows the `libyaml` emitter's state machine and formatting rules,
+ * with `libyaml`'s default settings, so that anything it writes is the same
+ * as `libyaml` would write, byte for byte.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "mem.h"
+#include "emitter.h"
+
+/** Indentation step, as `libyaml`'s default. */
+#define CYAML_EMITTER_INDENT 2
+
+/** Preferred line width, as `libyaml`'s default. */
+#define CYAML_EMITTER_WIDTH 80
+
+/** Maximum length of a simple key, as for `libyaml`. */
+#define CYAML_EMITTER_KEY_MAX 128
+
+/** Minimum size of the output buffer. */
+#define CYAML_EMITTER_BUF_MIN 1024
+
+/** The styles a scalar may be written in. */
+typedef struct cyaml_emitter_scalar {
+	bool flow_plain_allowed;  /**< Plain style allowed in flow context. */
+	bool block_plain_allowed; /**< Plain style allowed in block context. */
+} cyaml_emitter_scalar_t;
+
+/**
+ * Ensure a native emitter's output buffer has space for some more bytes.
+ *
+ * On failure the emitter is marked as out of memory, and nothing more is
+ * written.
+ *
+ * \param[in]  emitter  The native emitter.
+ * \param[in]  size     Number of bytes needed.
+ * \return true if there is space, false otherwise.
+ */
+static bool cyaml__emitter_reserve(
+		cyaml_emitter_t *emitter,
+		size_t size)
+{
+	size_t need = emitter->used + size;
+	size_t new_size;
+	char *temp;
+
+	if (need <= emitter->buf_size) {
+		return true;
+	}
+	if (emitter->oom || need < size) {
+		emitter->oom = true;
+		return false;
+	}
+
+	new_size = emitter->buf_size;
+	if (new_size == 0) {
+		new_size = emitter->config->save_size_hint;
+		if (new_size < CYAML_EMITTER_BUF_MIN) {
+			new_size = CYAML_EMITTER_BUF_MIN;
+		}
+	}
+	while (new_size < need) {
+		new_size = (new_size <= SIZE_MAX / 2) ? new_size * 2 : need;
+	}
+
+	temp = cyaml__realloc(emitter->config, emitter->buf,
+			emitter->buf_size, new_size, false);
+	if (temp == NULL) {
+		emitter->oom = true;
+		return false;
+	}
+
+	emitter->buf = temp;
+	emitter->buf_size = new_size;
+	return true;
+}
+
+/**
+ * Write bytes that don't include line breaks to the output.
+ *
+ * \param[in]  emitter  The native emitter.
+ * \param[in]  str      The bytes to write.
+ * \param[in]  len      Number of bytes to write.
+ */
+static inline void cyaml__emitter_write(
+		cyaml_emitter_t *emitter,
+		const char *str,
+		size_t len)
+{
+	if (cyaml__emitter_reserve(emitter, len)) {
+		memcpy(emitter->buf + emitter->used, str, len);
+		emitter->used += len;
+		emitter->column += len;
+	}
+}
+
+/**
+ * Write a byte that isn't a line break to the output.
+ *
+ * \param[in]  emitter  The native emitter.
+ * \param[in]  c        The byte to write.
+ */
+static inline void cyaml__emitter_put(
+		cyaml_emitter_t *emitter,
+		char c)
+{
+	if (cyaml__emitter_reserve(emitter, 1)) {
+		emitter->buf[emitter->used++] = c;
+		emitter->column++;
+	}
+}
+
+/**
+ * Write a line break to the output.
+ *
+ * \param[in]  emitter  The native emitter.
+ */
+static inline void cyaml__emitter_put_break(
+		cyaml_emitter_t *emitter)
+{
+	if (cyaml__emitter_reserve(emitter, 1)) {
+		emitter->buf[emitter->used++] = '\n';
+		emitter->column = 0;
+	}
+}
+
+/**
+ * Write an indicator to the output.
+ *
+ * \param[in]  emitter          The native emitter.
+ * \param[in]  indicator        The indicator to write.
+ * \param[in]  need_whitespace  Whether the indicator must follow a space.
+ * \param[in]  is_whitespace    Whether the indicator counts as a space.
+ * \param[in]  is_indention     Whether the indicator counts as indentation.
+ */
+static void cyaml__emitter_indicator(
+		cyaml_emitter_t *emitter,
+		const char *indicator,
+		bool need_whitespace,
+		bool is_whitespace,
+		bool is_indention)
+{
+	if (need_whitespace && !emitter->whitespace) {
+		cyaml__emitter_put(emitter, ' ');
+	}
+
+	cyaml__emitter_write(emitter, indicator, strlen(indicator));
+
+	emitter->whitespace = is_whitespace;
+	emitter->indention = emitter->indention && is_indention;
+}
+
+/**
+ * Start a new line at the current indentation, if needed.
+ *
+ * \param[in]  emitter  The native emitter.
+ */
+static void cyaml__emitter_indent(
+		cyaml_emitter_t *emitter)
+{
+	size_t indent = (emitter->indent >= 0) ? (size_t)emitter->indent : 0;
+
+	if (!emitter->indention || emitter->column > indent ||
+	    (emitter->column == indent && !emitter->whitespace)) {
+		cyaml__emitter_put_break(emitter);
+	}
+
+	while (emitter->column < indent && !emitter->oom) {
+		cyaml__emitter_put(emitter, ' ');
+	}
+
+	emitter->whitespace = true;
+	emitter->indention = true;
+}
+
+/**
+ * Push the current indentation, and increase it.
+ *
+ * \param[in]  emitter     The native emitter.
+ * \param[in]  flow        Whether the indentation is for a flow node.
+ * \param[in]  indentless  Whether to keep the current indentation.
+ * \return true on success, false if nesting is too deep.
+ */
+static bool cyaml__emitter_increase_indent(
+		cyaml_emitter_t *emitter,
+		bool flow,
+		bool indentless)
+{
+	if (emitter->indents_count == CYAML_EMITTER_DEPTH_MAX) {
+		return false;
+	}
+	emitter->indents[emitter->indents_count++] = emitter->indent;
+
+	if (emitter->indent < 0) {
+		emitter->indent = flow ? CYAML_EMITTER_INDENT : 0;
+	} else if (!indentless) {
+		emitter->indent += CYAML_EMITTER_INDENT;
+	}
+
+	return true;
+}
+
+/**
+ * Restore the indentation from before the last increase.
+ *
+ * \param[in]  emitter  The native emitter.
+ */
+static inline void cyaml__emitter_pop_indent(
+		cyaml_emitter_t *emitter)
+{
+	emitter->indent = emitter->indents[--emitter->indents_count];
+}
+
+/**
+ * Push a state to return to when the next node has been written.
+ *
+ * \param[in]  emitter  The native emitter.
+ * \param[in]  state    The state to return to.
+ * \return true on success, false if nesting is too deep.
+ */
+static bool cyaml__emitter_push_state(
+		cyaml_emitter_t *emitter,
+		cyaml_emitter_state_t state)
+{
+	if (emitter->states_count == CYAML_EMITTER_DEPTH_MAX) {
+		return false;
+	}
+	emitter->states[emitter->states_count++] = state;
+	return true;
+}
+
+/**
+ * Return to the state from before the node that has been written.
+ *
+ * \param[in]  emitter  The native emitter.
+ */
+static inline void cyaml__emitter_pop_state(
+		cyaml_emitter_t *emitter)
+{
+	emitter->state = emitter->states[--emitter->states_count];
+}
+
+/**
+ * Work out which styles a scalar may be written in.
+ *
+ * This follows `libyaml`'s scalar analysis, for scalars of printable ASCII.
+ *
+ * \param[in]  value     The scalar value.
+ * \param[in]  len       Length of `value` in bytes.
+ * \param[out] analysis  Returns the allowed styles.
+ * \return false if the scalar has other characters, true otherwise.
+ */
+static bool cyaml__emitter_analyse(
+		const uint8_t *value,
+		size_t len,
+		cyaml_emitter_scalar_t *analysis)
+{
+	bool block_indicators = false;
+	bool flow_indicators = false;
+	bool preceded_by_space = true;
+	bool space_at_ends;
+
+	if (len == 0) {
+		analysis->flow_plain_allowed = false;
+		analysis->block_plain_allowed = true;
+		return true;
+	}
+
+	if (len >= 3 &&
+	    ((value[0] == '-' && value[1] == '-' && value[2] == '-') ||
+	     (value[0] == '.' && value[1] == '.' && value[2] == '.'))) {
+		block_indicators = true;
+		flow_indicators = true;
+	}
+
+	for (size_t i = 0; i < len; i++) {
+		uint8_t c = value[i];
+		bool followed_by_space = (i + 1 == len) ||
+				(value[i + 1] == ' ');
+
+		if (c < 0x20 || c > 0x7e) {
+			return false;
+		}
+
+		if (i == 0) {
+			switch (c) {
+			case '#': case ',': case '[': case ']':
+			case '{': case '}': case '&': case '*':
+			case '!': case '|': case '>': case '\'':
+			case '"': case '%': case '@': case '`':
+				flow_indicators = true;
+				block_indicators = true;
+				break;
+			case '?': case ':':
+				flow_indicators = true;
+				block_indicators |= followed_by_space;
+				break;
+			case '-':
+				flow_indicators |= followed_by_space;
+				block_indicators |= followed_by_space;
+				break;
+			default:
+				break;
+			}
+		} else {
+			switch (c) {
+			case ',': case '?': case '[': case ']':
+			case '{': case '}':
+				flow_indicators = true;
+				break;
+			case ':':
+				flow_indicators = true;
+				block_indicators |= followed_by_space;
+				break;
+			case '#':
+				flow_indicators |= preceded_by_space;
+				block_indicators |= preceded_by_space;
+				break;
+			default:
+				break;
+			}
+		}
+
+		preceded_by_space = (c == ' ');
+	}
+
+	space_at_ends = (value[0] == ' ' || value[len - 1] == ' ');
+
+	analysis->flow_plain_allowed = !space_at_ends && !flow_indicators;
+	analysis->block_plain_allowed = !space_at_ends && !block_indicators;
+	return true;
+}
+
+/**
+ * Write a plain scalar.
+ *
+ * \param[in]  emitter       The native emitter.
+ * \param[in]  value         The scalar value.
+ * \param[in]  len           Length of `value` in bytes.
+ * \param[in]  allow_breaks  Whether long lines may be wrapped.
+ */
+static void cyaml__emitter_write_plain(
+		cyaml_emitter_t *emitter,
+		const uint8_t *value,
+		size_t len,
+		bool allow_breaks)
+{
+	bool spaces = false;
+
+	if (!emitter->whitespace && (len != 0 || emitter->flow_level != 0)) {
+		cyaml__emitter_put(emitter, ' ');
+	}
+
+	for (size_t i = 0; i < len; i++) {
+		if (value[i] == ' ') {
+			if (allow_breaks && !spaces &&
+			    emitter->column > CYAML_EMITTER_WIDTH &&
+			    (i + 1 == len || value[i + 1] != ' ')) {
+				cyaml__emitter_indent(emitter);
+			} else {
+				cyaml__emitter_put(emitter, ' ');
+			}
+			spaces = true;
+		} else {
+			cyaml__emitter_put(emitter, (char)value[i]);
+			emitter->indention = false;
+			spaces = false;
+		}
+	}
+
+	emitter->whitespace = false;
+	emitter->indention = false;
+}
+
+/**
+ * Write a single quoted scalar.
+ *
+ * \param[in]  emitter       The native emitter.
+ * \param[in]  value         The scalar value.
+ * \param[in]  len           Length of `value` in bytes.
+ * \param[in]  allow_breaks  Whether long lines may be wrapped.
+ */
+static void cyaml__emitter_write_single(
+		cyaml_emitter_t *emitter,
+		const uint8_t *value,
+		size_t len,
+		bool allow_breaks)
+{
+	bool spaces = false;
+
+	cyaml__emitter_indicator(emitter, "'", true, false, false);
+
+	for (size_t i = 0; i < len; i++) {
+		if (value[i] == ' ') {
+			if (allow_breaks && !spaces &&
+			    emitter->column > CYAML_EMITTER_WIDTH &&
+			    i != 0 && i + 1 != len && value[i + 1] != ' ') {
+				cyaml__emitter_indent(emitter);
+			} else {
+				cyaml__emitter_put(emitter, ' ');
+			}
+			spaces = true;
+		} else {
+			if (value[i] == '\'') {
+				cyaml__emitter_put(emitter, '\'');
+			}
+			cyaml__emitter_put(emitter, (char)value[i]);
+			emitter->indention = false;
+			spaces = false;
+		}
+	}
+
+	cyaml__emitter_indicator(emitter, "'", false, false, false);
+
+	emitter->whitespace = false;
+	emitter->indention = false;
+}
+
+/**
+ * Write a double quoted scalar.
+ *
+ * \param[in]  emitter       The native emitter.
+ * \param[in]  value         The scalar value.
+ * \param[in]  len           Length of `value` in bytes.
+ * \param[in]  allow_breaks  Whether long lines may be wrapped.
+ */
+static void cyaml__emitter_write_double(
+		cyaml_emitter_t *emitter,
+		const uint8_t *value,
+		size_t len,
+		bool allow_breaks)
+{
+	bool spaces = false;
+
+	cyaml__emitter_indicator(emitter, "\"", true, false, false);
+
+	for (size_t i = 0; i < len; i++) {
+		if (value[i] == '"' || value[i] == '\\') {
+			cyaml__emitter_put(emitter, '\\');
+			cyaml__emitter_put(emitter, (char)value[i]);
+			spaces = false;
+		} else if (value[i] == ' ') {
+			if (allow_breaks && !spaces &&
+			    emitter->column > CYAML_EMITTER_WIDTH &&
+			    i != 0 && i + 1 != len) {
+				cyaml__emitter_indent(emitter);
+				if (value[i + 1] == ' ') {
+					cyaml__emitter_put(emitter, '\\');
+				}
+			} else {
+				cyaml__emitter_put(emitter, ' ');
+			}
+			spaces = true;
+		} else {
+			cyaml__emitter_put(emitter, (char)value[i]);
+			spaces = false;
+		}
+	}
+
+	cyaml__emitter_indicator(emitter, "\"", false, false, false);
+
+	emitter->whitespace = false;
+	emitter->indention = false;
+}
+
+/**
+ * Write a scalar node.
+ *
+ * \param[in]  emitter  The native emitter.
+ * \param[in]  event    The scalar event.
+ * \return \ref CYAML_EMITTER_OK on success, or appropriate result code
+ *         otherwise.
+ */
+static cyaml_emitter_result_t cyaml__emitter_scalar(
+		cyaml_emitter_t *emitter,
+		const yaml_event_t *event)
+{
+	const uint8_t *value = event->data.scalar.value;
+	size_t len = event->data.scalar.length;
+	yaml_scalar_style_t style = event->data.scalar.style;
+	bool allow_breaks = !emitter->simple_key_context;
+	cyaml_emitter_scalar_t analysis;
+	bool plain_allowed;
+
+	if (event->data.scalar.anchor != NULL ||
+	    (!event->data.scalar.plain_implicit &&
+	     !event->data.scalar.quoted_implicit)) {
+		return CYAML_EMITTER_UNSUPPORTED;
+	}
+
+	if (!cyaml__emitter_analyse(value, len, &analysis)) {
+		return CYAML_EMITTER_UNSUPPORTED;
+	}
+
+	if (emitter->simple_key_context && len > CYAML_EMITTER_KEY_MAX) {
+		return CYAML_EMITTER_UNSUPPORTED;
+	}
+
+	/* Select the style, as `libyaml` does. */
+	if (style == YAML_ANY_SCALAR_STYLE) {
+		style = YAML_PLAIN_SCALAR_STYLE;
+	}
+	if (style == YAML_PLAIN_SCALAR_STYLE) {
+		plain_allowed = (emitter->flow_level != 0) ?
+				analysis.flow_plain_allowed :
+				analysis.block_plain_allowed;
+		if (!plain_allowed || !event->data.scalar.plain_implicit ||
+		    (len == 0 && (emitter->flow_level != 0 ||
+				  emitter->simple_key_context))) {
+			style = YAML_SINGLE_QUOTED_SCALAR_STYLE;
+		}
+	}
+	if (style != YAML_PLAIN_SCALAR_STYLE &&
+	    !event->data.scalar.quoted_implicit) {
+		return CYAML_EMITTER_UNSUPPORTED;
+	}
+
+	if (!cyaml__emitter_increase_indent(emitter, true, false)) {
+		return CYAML_EMITTER_UNSUPPORTED;
+	}
+
+	switch (style) {
+	case YAML_PLAIN_SCALAR_STYLE:
+		cyaml__emitter_write_plain(emitter, value, len, allow_breaks);
+		break;
+	case YAML_SINGLE_QUOTED_SCALAR_STYLE:
+		cyaml__emitter_write_single(emitter, value, len, allow_breaks);
+		break;
+	case YAML_DOUBLE_QUOTED_SCALAR_STYLE:
+		cyaml__emitter_write_double(emitter, value, len, allow_breaks);
+		break;
+	default:
+		return CYAML_EMITTER_UNSUPPORTED;
+	}
+
+	cyaml__emitter_pop_indent(emitter);
+	cyaml__emitter_pop_state(emitter);
+	return CYAML_EMITTER_OK;
+}
+
+/**
+ * Write a node.
+ *
+ * The caller must have pushed the state to return to after the node.
+ *
+ * Collections are left pending until the next event, which shows whether
+ * they are empty.
+ *
+ * \param[in]  emitter     The native emitter.
+ * \param[in]  event       The node's first event.
+ * \param[in]  mapping     Whether the node is a mapping key or value.
+ * \param[in]  simple_key  Whether the node is a simple mapping key.
+ * \return \ref CYAML_EMITTER_OK on success, or appropriate result code
+ *         otherwise.
+ */
+static cyaml_emitter_result_t cyaml__emitter_node(
+		cyaml_emitter_t *emitter,
+		const yaml_event_t *event,
+		bool mapping,
+		bool simple_key)
+{
+	emitter->mapping_context = mapping;
+	emitter->simple_key_context = simple_key;
+
+	switch (event->type) {
+	case YAML_SCALAR_EVENT:
+		return cyaml__emitter_scalar(emitter, event);
+	case YAML_SEQUENCE_START_EVENT:
+		if (simple_key || event->data.sequence_start.anchor != NULL ||
+		    !event->data.sequence_start.implicit) {
+			return CYAML_EMITTER_UNSUPPORTED;
+		}
+		emitter->pending_map = false;
+		emitter->pending_flow = (event->data.sequence_start.style ==
+				YAML_FLOW_SEQUENCE_STYLE);
+		break;
+	case YAML_MAPPING_START_EVENT:
+		if (simple_key || event->data.mapping_start.anchor != NULL ||
+		    !event->data.mapping_start.implicit) {
+			return CYAML_EMITTER_UNSUPPORTED;
+		}
+		emitter->pending_map = true;
+		emitter->pending_flow = (event->data.mapping_start.style ==
+				YAML_FLOW_MAPPING_STYLE);
+		break;
+	default:
+		return CYAML_EMITTER_UNSUPPORTED;
+	}
+
+	emitter->pending = true;
+	return CYAML_EMITTER_OK;
+}
+
+/**
+ * Start a pending collection, now that its first entry's event is known.
+ *
+ * \param[in]  emitter  The native emitter.
+ * \param[in]  event    The event after the collection start.
+ * \return true if the event was the collection end, and has been handled,
+ *         false otherwise.
+ */
+static bool cyaml__emitter_start_pending(
+		cyaml_emitter_t *emitter,
+		const yaml_event_t *event)
+{
+	bool flow = emitter->pending_flow || emitter->flow_level != 0;
+
+	emitter->pending = false;
+
+	if (emitter->pending_map) {
+		if (event->type == YAML_MAPPING_END_EVENT) {
+			cyaml__emitter_indicator(emitter, "{", true, true,
+					false);
+			cyaml__emitter_indicator(emitter, "}", false, false,
+					false);
+			cyaml__emitter_pop_state(emitter);
+			return true;
+		}
+		emitter->state = flow ?
+				CYAML_EMITTER_FLOW_MAP_FIRST_KEY :
+				CYAML_EMITTER_BLOCK_MAP_FIRST_KEY;
+	} else {
+		if (event->type == YAML_SEQUENCE_END_EVENT) {
+			cyaml__emitter_indicator(emitter, "[", true, true,
+					false);
+			cyaml__emitter_indicator(emitter, "]", false, false,
+					false);
+			cyaml__emitter_pop_state(emitter);
+			return true;
+		}
+		emitter->state = flow ?
+				CYAML_EMITTER_FLOW_SEQ_FIRST_ITEM :
+				CYAML_EMITTER_BLOCK_SEQ_FIRST_ITEM;
+	}
+
+	return false;
+}
+
+/**
+ * Handle an event in a document start state.
+ *
+ * \param[in]  emitter  The native emitter.
+ * \param[in]  event    The event to write.
+ * \param[in]  first    Whether this is the first document in the stream.
+ * \return \ref CYAML_EMITTER_OK on success, or appropriate result code
+ *         otherwise.
+ */
+static cyaml_emitter_result_t cyaml__emitter_doc_start(
+		cyaml_emitter_t *emitter,
+		const yaml_event_t *event,
+		bool first)
+{
+	switch (event->type) {
+	case YAML_DOCUMENT_START_EVENT:
+		if (!first ||
+		    event->data.document_start.version_directive != NULL ||
+		    event->data.document_start.tag_directives.start !=
+		    event->data.document_start.tag_directives.end) {
+			return CYAML_EMITTER_UNSUPPORTED;
+		}
+		if (!event->data.document_start.implicit) {
+			cyaml__emitter_indent(emitter);
+			cyaml__emitter_indicator(emitter, "---",
+					true, false, false);
+		}
+		emitter->state = CYAML_EMITTER_DOC_CONTENT;
+		return CYAML_EMITTER_OK;
+	case YAML_STREAM_END_EVENT:
+		emitter->state = CYAML_EMITTER_END;
+		return CYAML_EMITTER_OK;
+	default:
+		return CYAML_EMITTER_UNSUPPORTED;
+	}
+}
+
+/**
+ * Handle an event in a flow sequence state.
+ *
+ * \param[in]  emitter  The native emitter.
+ * \param[in]  event    The event to write.
+ * \param[in]  first    Whether this is the sequence's first event.
+ * \return \ref CYAML_EMITTER_OK on success, or appropriate result code
+ *         otherwise.
+ */
+static cyaml_emitter_result_t cyaml__emitter_flow_seq(
+		cyaml_emitter_t *emitter,
+		const yaml_event_t *event,
+		bool first)
+{
+	if (first) {
+		cyaml__emitter_indicator(emitter, "[", true, true, false);
+		if (!cyaml__emitter_increase_indent(emitter, true, false)) {
+			return CYAML_EMITTER_UNSUPPORTED;
+		}
+		emitter->flow_level++;
+	}
+
+	if (event->type == YAML_SEQUENCE_END_EVENT) {
+		emitter->flow_level--;
+		cyaml__emitter_pop_indent(emitter);
+		cyaml__emitter_indicator(emitter, "]", false, false, false);
+		cyaml__emitter_pop_state(emitter);
+		return CYAML_EMITTER_OK;
+	}
+
+	if (!first) {
+		cyaml__emitter_indicator(emitter, ",", false, false, false);
+	}
+	if (emitter->column > CYAML_EMITTER_WIDTH) {
+		cyaml__emitter_indent(emitter);
+	}
+
+	if (!cyaml__emitter_push_state(emitter,
+			CYAML_EMITTER_FLOW_SEQ_ITEM)) {
+		return CYAML_EMITTER_UNSUPPORTED;
+	}
+	return cyaml__emitter_node(emitter, event, false, false);
+}
+
+/**
+ * Handle an event in a flow mapping key state.
+ *
+ * \param[in]  emitter  The native emitter.
+ * \param[in]  event    The event to write.
+ * \param[in]  first    Whether this is the mapping's first event.
+ * \return \ref CYAML_EMITTER_OK on success, or appropriate result code
+ *         otherwise.
+ */
+static cyaml_emitter_result_t cyaml__emitter_flow_map_key(
+		cyaml_emitter_t *emitter,
+		const yaml_event_t *event,
+		bool first)
+{
+	if (first) {
+		cyaml__emitter_indicator(emitter, "{", true, true, false);
+		if (!cyaml__emitter_increase_indent(emitter, true, false)) {
+			return CYAML_EMITTER_UNSUPPORTED;
+		}
+		emitter->flow_level++;
+	}
+
+	if (event->type == YAML_MAPPING_END_EVENT) {
+		emitter->flow_level--;
+		cyaml__emitter_pop_indent(emitter);
+		cyaml__emitter_indicator(emitter, "}", false, false, false);
+		cyaml__emitter_pop_state(emitter);
+		return CYAML_EMITTER_OK;
+	}
+
+	if (!first) {
+		cyaml__emitter_indicator(emitter, ",", false, false, false);
+	}
+	if (emitter->column > CYAML_EMITTER_WIDTH) {
+		cyaml__emitter_indent(emitter);
+	}
+
+	if (!cyaml__emitter_push_state(emitter,
+			CYAML_EMITTER_FLOW_MAP_VALUE)) {
+		return CYAML_EMITTER_UNSUPPORTED;
+	}
+	return cyaml__emitter_node(emitter, event, true, true);
+}
+
+/**
+ * Handle an event in a block sequence state.
+ *
+ * \param[in]  emitter  The native emitter.
+ * \param[in]  event    The event to write.
+ * \param[in]  first    Whether this is the sequence's first event.
+ * \return \ref CYAML_EMITTER_OK on success, or appropriate result code
+ *         otherwise.
+ */
+static cyaml_emitter_result_t cyaml__emitter_block_seq(
+		cyaml_emitter_t *emitter,
+		const yaml_event_t *event,
+		bool first)
+{
+	if (first) {
+		bool indentless = emitter->mapping_context &&
+				!emitter->indention;
+
+		if (!cyaml__emitter_increase_indent(emitter,
+				false, indentless)) {
+			return CYAML_EMITTER_UNSUPPORTED;
+		}
+	}
+
+	if (event->type == YAML_SEQUENCE_END_EVENT) {
+		cyaml__emitter_pop_indent(emitter);
+		cyaml__emitter_pop_state(emitter);
+		return CYAML_EMITTER_OK;
+	}
+
+	cyaml__emitter_indent(emitter);
+	cyaml__emitter_indicator(emitter, "-", true, false, true);
+
+	if (!cyaml__emitter_push_state(emitter,
+			CYAML_EMITTER_BLOCK_SEQ_ITEM)) {
+		return CYAML_EMITTER_UNSUPPORTED;
+	}
+	return cyaml__emitter_node(emitter, event, false, false);
+}
+
+/**
+ * Handle an event in a block mapping key state.
+ *
+ * \param[in]  emitter  The native emitter.
+ * \param[in]  event    The event to write.
+ * \param[in]  first    Whether this is the mapping's first event.
+ * \return \ref CYAML_EMITTER_OK on success, or appropriate result code
+ *         otherwise.
+ */
+static cyaml_emitter_result_t cyaml__emitter_block_map_key(
+		cyaml_emitter_t *emitter,
+		const yaml_event_t *event,
+		bool first)
+{
+	if (first) {
+		if (!cyaml__emitter_increase_indent(emitter, false, false)) {
+			return CYAML_EMITTER_UNSUPPORTED;
+		}
+	}
+
+	if (event->type == YAML_MAPPING_END_EVENT) {
+		cyaml__emitter_pop_indent(emitter);
+		cyaml__emitter_pop_state(emitter);
+		return CYAML_EMITTER_OK;
+	}
+
+	cyaml__emitter_indent(emitter);
+
+	if (!cyaml__emitter_push_state(emitter,
+			CYAML_EMITTER_BLOCK_MAP_VALUE)) {
+		return CYAML_EMITTER_UNSUPPORTED;
+	}
+	return cyaml__emitter_node(emitter, event, true, true);
+}
+
+/**
+ * Handle an event in a mapping value state.
+ *
+ * \param[in]  emitter  The native emitter.
+ * \param[in]  event    The event to write.
+ * \param[in]  next     The state for the mapping's next key.
+ * \return \ref CYAML_EMITTER_OK on success, or appropriate result code
+ *         otherwise.
+ */
+static cyaml_emitter_result_t cyaml__emitter_map_value(
+		cyaml_emitter_t *emitter,
+		const yaml_event_t *event,
+		cyaml_emitter_state_t next)
+{
+	cyaml__emitter_indicator(emitter, ":", false, false, false);
+
+	if (!cyaml__emitter_push_state(emitter, next)) {
+		return CYAML_EMITTER_UNSUPPORTED;
+	}
+	return cyaml__emitter_node(emitter, event, true, false);
+}
+
+/**
+ * Handle an event in the current state.
+ *
+ * \param[in]  emitter  The native emitter.
+ * \param[in]  event    The event to write.
+ * \return \ref CYAML_EMITTER_OK on success, or appropriate result code
+ *         otherwise.
+ */
+static cyaml_emitter_result_t cyaml__emitter_state(
+		cyaml_emitter_t *emitter,
+		const yaml_event_t *event)
+{
+	switch (emitter->state) {
+	case CYAML_EMITTER_STREAM_START:
+		if (event->type != YAML_STREAM_START_EVENT) {
+			return CYAML_EMITTER_UNSUPPORTED;
+		}
+		emitter->state = CYAML_EMITTER_FIRST_DOC_START;
+		return CYAML_EMITTER_OK;
+	case CYAML_EMITTER_FIRST_DOC_START:
+		return cyaml__emitter_doc_start(emitter, event, true);
+	case CYAML_EMITTER_DOC_START:
+		return cyaml__emitter_doc_start(emitter, event, false);
+	case CYAML_EMITTER_DOC_CONTENT:
+		/* Root scalars can need a document end marker, which is
+		 * left to `libyaml`. */
+		if (event->type == YAML_SCALAR_EVENT ||
+		    !cyaml__emitter_push_state(emitter,
+				CYAML_EMITTER_DOC_END)) {
+			return CYAML_EMITTER_UNSUPPORTED;
+		}
+		return cyaml__emitter_node(emitter, event, false, false);
+	case CYAML_EMITTER_DOC_END:
+		if (event->type != YAML_DOCUMENT_END_EVENT) {
+			return CYAML_EMITTER_UNSUPPORTED;
+		}
+		cyaml__emitter_indent(emitter);
+		if (!event->data.document_end.implicit) {
+			cyaml__emitter_indicator(emitter, "...",
+					true, false, false);
+			cyaml__emitter_indent(emitter);
+		}
+		emitter->state = CYAML_EMITTER_DOC_START;
+		return CYAML_EMITTER_OK;
+	case CYAML_EMITTER_FLOW_SEQ_FIRST_ITEM:
+		return cyaml__emitter_flow_seq(emitter, event, true);
+	case CYAML_EMITTER_FLOW_SEQ_ITEM:
+		return cyaml__emitter_flow_seq(emitter, event, false);
+	case CYAML_EMITTER_FLOW_MAP_FIRST_KEY:
+		return cyaml__emitter_flow_map_key(emitter, event, true);
+	case CYAML_EMITTER_FLOW_MAP_KEY:
+		return cyaml__emitter_flow_map_key(emitter, event, false);
+	case CYAML_EMITTER_FLOW_MAP_VALUE:
+		return cyaml__emitter_map_value(emitter, event,
+				CYAML_EMITTER_FLOW_MAP_KEY);
+	case CYAML_EMITTER_BLOCK_SEQ_FIRST_ITEM:
+		return cyaml__emitter_block_seq(emitter, event, true);
+	case CYAML_EMITTER_BLOCK_SEQ_ITEM:
+		return cyaml__emitter_block_seq(emitter, event, false);
+	case CYAML_EMITTER_BLOCK_MAP_FIRST_KEY:
+		return cyaml__emitter_block_map_key(emitter, event, true);
+	case CYAML_EMITTER_BLOCK_MAP_KEY:
+		return cyaml__emitter_block_map_key(emitter, event, false);
+	case CYAML_EMITTER_BLOCK_MAP_VALUE:
+		return cyaml__emitter_map_value(emitter, event,
+				CYAML_EMITTER_BLOCK_MAP_KEY);
+	default:
+		return CYAML_EMITTER_UNSUPPORTED;
+	}
+}
+
+/* Exported function, documented in emitter.h. */
+void cyaml__emitter_init(
+		cyaml_emitter_t *emitter,
+		const cyaml_config_t *config)
+{
+	*emitter = (cyaml_emitter_t) {
+		.config = config,
+		.state = CYAML_EMITTER_STREAM_START,
+		.indent = -1,
+		.whitespace = true,
+		.indention = true,
+	};
+}
+
+/* Exported function, documented in emitter.h. */
+cyaml_emitter_result_t cyaml__emitter_emit(
+		cyaml_emitter_t *emitter,
+		const yaml_event_t *event)
+{
+	cyaml_emitter_result_t res = CYAML_EMITTER_OK;
+
+	if (emitter->pending && cyaml__emitter_start_pending(emitter, event)) {
+		/* The event ended an empty collection. */
+	} else {
+		res = cyaml__emitter_state(emitter, event);
+	}
+
+	if (res == CYAML_EMITTER_UNSUPPORTED) {
+		emitter->unsupported = true;
+	} else if (emitter->oom) {
+		res = CYAML_EMITTER_OOM;
+	}
+	return res;
+}
+
+/* Exported function, documented in emitter.h. */
+char *cyaml__emitter_take_output(
+		cyaml_emitter_t *emitter,
+		size_t *len)
+{
+	char *output = emitter->buf;
+
+	/* Trim any unused space from the buffer. */
+	if (emitter->used != 0 && emitter->used < emitter->buf_size) {
+		char *temp = cyaml__realloc(emitter->config, emitter->buf,
+				emitter->buf_size, emitter->used, false);
+		if (temp != NULL) {
+			output = temp;
+		}
+	}
+
+	*len = emitter->used;
+
+	emitter->buf = NULL;
+	emitter->buf_size = 0;
+	emitter->used = 0;
+	return output;
+}
+
+/* Exported function, documented in emitter.h. */
+void cyaml__emitter_fini(
+		cyaml_emitter_t *emitter)
+{
+	cyaml__free(emitter->config, emitter->buf);
+	emitter->buf = NULL;
+	emitter->buf_size = 0;
+}
@@ -0,0 +1,138 @@
+/*
+ * SPDX-License-Identifier: ISC
+ *
+ * Copyright (C) 2026 Michael Drake <tlsa@netsurf-browser.org>
+ */
+
+/**
+ * \file
+ * \brief CYAML native emitter.
+ *
+ * The native emitter writes `libyaml` style events directly into an
+ * in-memory buffer, for a common subset of YAML.  It is used in place of
+ * the `libyaml` emitter when \ref CYAML_CFG_NATIVE_EMITTER is set.
+ */
+
+#ifndef CYAML_EMITTER_H
+#define CYAML_EMITTER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <yaml.h>
+
+#include "cyaml/cyaml.h"
+
+/** Maximum collection nesting depth for the native emitter. */
+#define CYAML_EMITTER_DEPTH_MAX 64
+
+/** Native emitter result codes. */
+typedef enum cyaml_emitter_result {
+	CYAML_EMITTER_OK,          /**< Event written. */
+	CYAML_EMITTER_UNSUPPORTED, /**< Event needs YAML it can't write. */
+	CYAML_EMITTER_OOM,         /**< Memory allocation failed. */
+} cyaml_emitter_result_t;
+
+/** Native emitter states, named after the `libyaml` emitter's states. */
+typedef enum cyaml_emitter_state {
+	CYAML_EMITTER_STREAM_START,         /**< Expect stream start. */
+	CYAML_EMITTER_FIRST_DOC_START,      /**< Expect first document. */
+	CYAML_EMITTER_DOC_START,            /**< Expect stream end. */
+	CYAML_EMITTER_DOC_CONTENT,          /**< Expect document root. */
+	CYAML_EMITTER_DOC_END,              /**< Expect document end. */
+	CYAML_EMITTER_FLOW_SEQ_FIRST_ITEM,  /**< Expect first flow entry. */
+	CYAML_EMITTER_FLOW_SEQ_ITEM,        /**< Expect flow entry. */
+	CYAML_EMITTER_FLOW_MAP_FIRST_KEY,   /**< Expect first flow key. */
+	CYAML_EMITTER_FLOW_MAP_KEY,         /**< Expect flow key. */
+	CYAML_EMITTER_FLOW_MAP_VALUE,       /**< Expect flow value. */
+	CYAML_EMITTER_BLOCK_SEQ_FIRST_ITEM, /**< Expect first block entry. */
+	CYAML_EMITTER_BLOCK_SEQ_ITEM,       /**< Expect block entry. */
+	CYAML_EMITTER_BLOCK_MAP_FIRST_KEY,  /**< Expect first block key. */
+	CYAML_EMITTER_BLOCK_MAP_KEY,        /**< Expect block key. */
+	CYAML_EMITTER_BLOCK_MAP_VALUE,      /**< Expect block value. */
+	CYAML_EMITTER_END,                  /**< Expect nothing. */
+} cyaml_emitter_state_t;
+
+/** Native emitter context. */
+typedef struct cyaml_emitter {
+	const cyaml_config_t *config; /**< Client's CYAML config. */
+	char *buf;                    /**< Output buffer. */
+	size_t buf_size;              /**< Allocated size of `buf`. */
+	size_t used;                  /**< Number of bytes used in `buf`. */
+	bool oom;                     /**< Whether an allocation failed. */
+	bool unsupported;             /**< Whether an event was unsupported. */
+	cyaml_emitter_state_t state;  /**< Current emitter state. */
+	/** States to return to when the open nodes end, outermost first. */
+	cyaml_emitter_state_t states[CYAML_EMITTER_DEPTH_MAX];
+	uint32_t states_count;        /**< Number of entries in `states`. */
+	/** Indentation to restore when the open nodes end. */
+	int indents[CYAML_EMITTER_DEPTH_MAX];
+	uint32_t indents_count;       /**< Number of entries in `indents`. */
+	int indent;                   /**< Current indentation, or -1. */
+	uint32_t flow_level;          /**< Number of open flow collections. */
+	size_t column;                /**< Current output column. */
+	bool whitespace;              /**< Whether last output was a space. */
+	bool indention;               /**< Whether output is indentation. */
+	bool mapping_context;         /**< Whether node is a mapping value. */
+	bool simple_key_context;      /**< Whether node is a simple key. */
+	/** Whether a collection start is waiting to see if it's empty. */
+	bool pending;
+	/** Whether the waiting collection is a mapping. */
+	bool pending_map;
+	/** Whether the waiting collection asked for flow style. */
+	bool pending_flow;
+} cyaml_emitter_t;
+
+/**
+ * Initialise a native emitter.
+ *
+ * \param[out] emitter  The emitter to initialise.
+ * \param[in]  config   The client's CYAML config.
+ */
+void cyaml__emitter_init(
+		cyaml_emitter_t *emitter,
+		const cyaml_config_t *config);
+
+/**
+ * Write an event with a native emitter.
+ *
+ * The emitter does not take ownership of the event or anything it points
+ * to, so the event may be built without `libyaml`'s event initialisers.
+ *
+ * Once an event gives \ref CYAML_EMITTER_UNSUPPORTED, the emitter's
+ * `unsupported` member is set, and the output so far should be thrown away,
+ * and the document emitted with `libyaml` instead.
+ *
+ * \param[in]  emitter  The emitter to write the event with.
+ * \param[in]  event    The event to write.
+ * \return \ref CYAML_EMITTER_OK on success, or appropriate result code
+ *         otherwise.
+ */
+cyaml_emitter_result_t cyaml__emitter_emit(
+		cyaml_emitter_t *emitter,
+		const yaml_event_t *event);
+
+/**
+ * Take a native emitter's output buffer.
+ *
+ * The caller owns the returned buffer, which is trimmed to the length of the
+ * output.  It is not '\0' terminated.
+ *
+ * \param[in]  emitter  The emitter to take the output of.
+ * \param[out] len      Returns the length of the output in bytes.
+ * \return the output buffer, or NULL if there is no output.
+ */
+char *cyaml__emitter_take_output(
+		cyaml_emitter_t *emitter,
+		size_t *len);
+
+/**
+ * Free a native emitter's allocations.
+ *
+ * \param[in]  emitter  The emitter to finalise.
+ */
+void cyaml__emitter_fini(
+		cyaml_emitter_t *emitter);
+
+#endif
@@ -11,17 +11,24 @@
  * As described in the public API for \ref cyaml_free(), it is preferable for
  * clients to write their own free routines, tailored for their data structure.
  *
- * Recursion and stack usage
+ * Iteration and stack usage
  * -------------------------
  *
- * This generic CYAML free routine is implemented using recursion, rather
- * than iteration with a heap-allocated stack.  This is because recursion
- * seems less bad than allocating within the free code, and the stack-cost
- * of these functions isn't huge.  The maximum recursion depth is of course
- * bound by the schema, however schemas for recursively nesting data structures
- * are unbound, e.g. for a data tree structure.
+ * This generic CYAML free routine is implemented using iteration with an
+ * explicit stack, rather than recursion.  The maximum nesting depth is bound
+ * by the schema, however schemas for recursively nesting data structures
+ * are unbound, e.g. for a data tree structure, and recursion could overflow
+ * the C stack for very deep documents.
+ *
+ * The stack starts in a small array on the C stack, so most documents are
+ * freed without allocating.  For deeper documents, the stack is grown with
+ * the client's allocator.  If that fails, the subtree is freed with a nested
+ * run using a new local stack, so nothing is leaked.
+ *
+ * Values whose data holds no pointers are not walked at all.
  */
 
+#include <inttypes.h>
 #include <stdbool.h>
 #include <assert.h>
 #include <string.h>
@@ -29,113 +36,294 @@
 #include "data.h"
 #include "util.h"
 #include "mem.h"
+#include "schema.h"
+
+/** Number of free stack entries to keep on the C stack. */
+#define CYAML_FREE_STACK_LOCAL 32
+
+/**
+ * A CYAML free stack entry, for a mapping or sequence being freed.
+ */
+typedef struct cyaml_free_frame {
+	/** Schema for the mapping or sequence. */
+	const cyaml_schema_value_t *schema;
+	/** The mapping or sequence's data. */
+	uint8_t *data;
+	/** Allocation to free when the entry is popped, or NULL. */
+	uint8_t *alloc;
+	/**
+	 * For sequences, the entry count.  For mappings which are entries
+	 * of a \ref CYAML_FLAG_COLUMNAR sequence, the sequence entry count,
+	 * or zero for other mappings.
+	 */
+	uint64_t count;
+	/** For columnar sequence entry mappings, index in the columns. */
+	uint64_t column;
+	/** Index of the next mapping field or sequence entry to free. */
+	uint64_t next;
+} cyaml_free_frame_t;
+
+/**
+ * Internal CYAML free context.
+ */
+typedef struct cyaml_free_ctx {
+	const cyaml_config_t *cfg; /**< The client's CYAML library config. */
+	cyaml_free_frame_t *stack; /**< The stack. */
+	uint32_t idx;              /**< Next (empty) stack slot. */
+	uint32_t max;              /**< Current stack allocation limit. */
+	/** Local stack, used until the stack needs to grow. */
+	cyaml_free_frame_t local[CYAML_FREE_STACK_LOCAL];
+} cyaml_free_ctx_t;
+
+/**
+ * Initialise a CYAML free context.
+ *
+ * \param[out] ctx  The free context to initialise.
+ * \param[in]  cfg  The client's CYAML library config.
+ */
+static inline void cyaml__free_ctx_init(
+		cyaml_free_ctx_t *ctx,
+		const cyaml_config_t *cfg)
+{
+	ctx->cfg = cfg;
+	ctx->stack = ctx->local;
+	ctx->idx = 0;
+	ctx->max = CYAML_FREE_STACK_LOCAL;
+}
+
+static void cyaml__free_run(
+		cyaml_free_ctx_t *ctx);
+
+/**
+ * Push an entry onto the free stack.
+ *
+ * If the stack can't grow, the entry's value is freed immediately, by
+ * a nested run with a stack of its own.
+ *
+ * \param[in]  ctx    The CYAML free context.
+ * \param[in]  frame  The entry to push.
+ */
+static void cyaml__free_push(
+		cyaml_free_ctx_t *ctx,
+		const cyaml_free_frame_t *frame)
+{
+	if (ctx->idx == ctx->max) {
+		uint32_t max = ctx->max * 2;
+		cyaml_free_frame_t *temp;
+
+		if (ctx->stack == ctx->local) {
+			temp = cyaml__alloc(ctx->cfg,
+					sizeof(*temp) * max, false);
+			if (temp != NULL) {
+				memcpy(temp, ctx->local, sizeof(ctx->local));
+			}
+		} else {
+			temp = cyaml__realloc(ctx->cfg, ctx->stack,
+					0, sizeof(*temp) * max, false);
+		}
+
+		if (temp == NULL) {
+			cyaml_free_ctx_t nested;
+
+			cyaml__log(ctx->cfg, CYAML_LOG_DEBUG,
+					"Free: Stack growth failed; "
+					"nesting at depth %u\n", ctx->idx);
+			cyaml__free_ctx_init(&nested, ctx->cfg);
+			nested.stack[nested.idx++] = *frame;
+			cyaml__free_run(&nested);
+			return;
+		}
+
+		ctx->stack = temp;
+		ctx->max = max;
+	}
+
+	ctx->stack[ctx->idx++] = *frame;
+}
 
 /**
- * Internal function for freeing a CYAML-parsed data structure.
+ * Free a value.
+ *
+ * Mappings and sequences that hold pointers are pushed onto the stack, to
+ * be walked by \ref cyaml__free_run.  Otherwise the value's allocation, if
+ * it has one, is freed immediately.
  *
- * \param[in]  cfg     The client's CYAML library config.
+ * \param[in]  ctx     The CYAML free context.
  * \param[in]  schema  The schema describing how to free `data`.
  * \param[in]  data    The data structure to be freed.
  * \param[in]  count   If data is of type \ref CYAML_SEQUENCE, this is the
  *                     number of entries in the sequence.
  */
 static void cyaml__free_value(
-		const cyaml_config_t *cfg,
+		cyaml_free_ctx_t *ctx,
 		const cyaml_schema_value_t *schema,
-		uint8_t * data,
-		uint64_t count);
+		uint8_t *data,
+		uint64_t count)
+{
+	uint8_t *alloc = NULL;
+
+	if (schema->flags & CYAML_FLAG_POINTER) {
+		data = cyaml_data_read_pointer(data);
+		if (data == NULL) {
+			return;
+		}
+		alloc = data;
+	}
+
+	if ((schema->type == CYAML_MAPPING ||
+	     schema->type == CYAML_SEQUENCE ||
+	     schema->type == CYAML_SEQUENCE_FIXED) &&
+	    cyaml__schema_has_pointers(ctx->cfg, schema)) {
+		cyaml_free_frame_t frame = {
+			.schema = schema,
+			.data = data,
+			.alloc = alloc,
+			.count = count,
+		};
+
+		if (schema->type == CYAML_SEQUENCE_FIXED) {
+			frame.count = schema->sequence.max;
+		} else if (schema->type == CYAML_MAPPING) {
+			frame.count = 0;
+		}
+
+		cyaml__free_push(ctx, &frame);
+		return;
+	}
+
+	if (alloc != NULL) {
+		cyaml__log(ctx->cfg, CYAML_LOG_DEBUG,
+				"Free: Freeing: %p\n", alloc);
+		cyaml__free(ctx->cfg, alloc);
+	}
+}
 
 /**
- * Internal function for freeing a CYAML-parsed sequence.
+ * Free the next field of the mapping at the top of the free stack.
  *
- * \param[in]  cfg              The client's CYAML library config.
- * \param[in]  sequence_schema  The schema describing how to free `data`.
- * \param[in]  data             The data structure to be freed.
- * \param[in]  count            The sequence's entry count.
+ * \param[in]  ctx  The CYAML free context.
+ * \return false if the mapping has no more fields to free, true otherwise.
  */
-static void cyaml__free_sequence(
-		const cyaml_config_t *cfg,
-		const cyaml_schema_value_t *sequence_schema,
-		uint8_t * const data,
-		uint64_t count)
+static bool cyaml__free_mapping_next(
+		cyaml_free_ctx_t *ctx)
 {
-	const cyaml_schema_value_t *schema = sequence_schema->sequence.entry;
-	uint32_t data_size = schema->data_size;
+	cyaml_free_frame_t *frame = &ctx->stack[ctx->idx - 1];
+	const cyaml_schema_field_t *field;
+	uint64_t count = 0;
 
-	cyaml__log(cfg, CYAML_LOG_DEBUG,
-			"Free: Freeing sequence with count: %u\n", count);
+	field = frame->schema->mapping.fields + frame->next;
+	if (field->key == NULL) {
+		return false;
+	}
+	frame->next++;
 
-	if (schema->flags & CYAML_FLAG_POINTER) {
-		data_size = sizeof(data);
+	cyaml__log(ctx->cfg, CYAML_LOG_DEBUG,
+			"Free: Freeing key: %s (at offset: %u)\n",
+			field->key, (unsigned)field->data_offset);
+
+	if (field->value.flags & CYAML_FLAG_LAZY) {
+		/* Lazy values refer to the input, and own nothing. */
+		return true;
 	}
 
-	for (unsigned i = 0; i < count; i++) {
-		cyaml__log(cfg, CYAML_LOG_DEBUG,
-				"Free: Freeing sequence entry: %u\n", i);
-		cyaml__free_value(cfg, schema, data + data_size * i, 0);
+	if (field->value.type == CYAML_SEQUENCE) {
+		cyaml_err_t err;
+		count = cyaml_data_read(field->count_size,
+				frame->data + cyaml_data_member_offset(
+					field->count_offset,
+					field->count_size,
+					frame->count, frame->column), &err);
+		if (err != CYAML_OK) {
+			return false;
+		}
 	}
+
+	/* Note: `frame` isn't valid after this, since freeing the value
+	 *       may grow the stack. */
+	cyaml__free_value(ctx, &field->value,
+			frame->data + cyaml_data_member_offset(
+				field->data_offset,
+				cyaml_data_member_size(&field->value),
+				frame->count, frame->column), count);
+	return true;
 }
 
 /**
- * Internal function for freeing a CYAML-parsed mapping.
+ * Free the next entry of the sequence at the top of the free stack.
  *
- * \param[in]  cfg             The client's CYAML library config.
- * \param[in]  mapping_schema  The schema describing how to free `data`.
- * \param[in]  data            The data structure to be freed.
+ * \param[in]  ctx  The CYAML free context.
+ * \return false if the sequence has no more entries to free, true otherwise.
  */
-static void cyaml__free_mapping(
-		const cyaml_config_t *cfg,
-		const cyaml_schema_value_t *mapping_schema,
-		uint8_t * const data)
+static bool cyaml__free_sequence_next(
+		cyaml_free_ctx_t *ctx)
 {
-	const cyaml_schema_field_t *schema = mapping_schema->mapping.fields;
-
-	while (schema->key != NULL) {
-		uint64_t count = 0;
-		cyaml__log(cfg, CYAML_LOG_DEBUG,
-				"Free: Freeing key: %s (at offset: %u)\n",
-				schema->key, (unsigned)schema->data_offset);
-		if (schema->value.type == CYAML_SEQUENCE) {
-			cyaml_err_t err;
-			count = cyaml_data_read(schema->count_size,
-					data + schema->count_offset, &err);
-			if (err != CYAML_OK) {
-				return;
-			}
-		}
-		cyaml__free_value(cfg, &schema->value,
-				data + schema->data_offset, count);
-		schema++;
+	cyaml_free_frame_t *frame = &ctx->stack[ctx->idx - 1];
+	const cyaml_schema_value_t *schema = frame->schema;
+	const cyaml_schema_value_t *entry = schema->sequence.entry;
+	uint64_t i = frame->next;
+
+	if (i >= frame->count) {
+		return false;
+	}
+	frame->next++;
+
+	if (i == 0) {
+		cyaml__log(ctx->cfg, CYAML_LOG_DEBUG,
+				"Free: Freeing sequence with count: %"PRIu64"\n",
+				frame->count);
 	}
+
+	if ((schema->flags & CYAML_FLAG_COLUMNAR) &&
+	    cyaml_data_columnar_valid(schema)) {
+		cyaml_free_frame_t column = {
+			.schema = entry,
+			.data = frame->data,
+			.count = frame->count,
+			.column = i,
+		};
+
+		cyaml__free_push(ctx, &column);
+		return true;
+	}
+
+	cyaml__free_value(ctx, entry,
+			frame->data + cyaml_data_member_size(entry) * i, 0);
+	return true;
 }
 
-/* This function is documented at the forward declaration above. */
-static void cyaml__free_value(
-		const cyaml_config_t *cfg,
-		const cyaml_schema_value_t *schema,
-		uint8_t * data,
-		uint64_t count)
+/**
+ * Free everything on the free stack.
+ *
+ * \param[in]  ctx  The CYAML free context.
+ */
+static void cyaml__free_run(
+		cyaml_free_ctx_t *ctx)
 {
-	if (schema->flags & CYAML_FLAG_POINTER) {
-		data = cyaml_data_read_pointer(data);
-		if (data == NULL) {
-			return;
+	while (ctx->idx > 0) {
+		const cyaml_free_frame_t *frame = &ctx->stack[ctx->idx - 1];
+		bool more;
+
+		if (frame->schema->type == CYAML_MAPPING) {
+			more = cyaml__free_mapping_next(ctx);
+		} else {
+			more = cyaml__free_sequence_next(ctx);
 		}
-	}
 
-	if (schema->type == CYAML_MAPPING) {
-		cyaml__free_mapping(cfg, schema, data);
-	} else if (schema->type == CYAML_SEQUENCE ||
-	           schema->type == CYAML_SEQUENCE_FIXED) {
-		if (schema->type == CYAML_SEQUENCE_FIXED) {
-			count = schema->sequence.max;
+		if (!more) {
+			frame = &ctx->stack[--ctx->idx];
+			if (frame->alloc != NULL) {
+				cyaml__log(ctx->cfg, CYAML_LOG_DEBUG,
+						"Free: Freeing: %p\n",
+						frame->alloc);
+				cyaml__free(ctx->cfg, frame->alloc);
+			}
 		}
-		cyaml__free_sequence(cfg, schema, data, count);
 	}
 
-	if (schema->flags & CYAML_FLAG_POINTER) {
-		cyaml__log(cfg, CYAML_LOG_DEBUG, "Free: Freeing: %p\n", data);
-		cyaml__free(cfg, data);
+	if (ctx->stack != ctx->local) {
+		cyaml__free(ctx->cfg, ctx->stack);
+		ctx->stack = ctx->local;
+		ctx->max = CYAML_FREE_STACK_LOCAL;
 	}
 }
 
@@ -146,6 +334,8 @@ cyaml_err_t cyaml_free(
 		cyaml_data_t *data,
 		unsigned seq_count)
 {
+	cyaml_free_ctx_t ctx;
+
 	if (config == NULL) {
 		return CYAML_ERR_BAD_PARAM_NULL_CONFIG;
 	}
@@ -156,8 +346,10 @@ cyaml_err_t cyaml_free(
 		return CYAML_ERR_BAD_PARAM_NULL_SCHEMA;
 	}
 	cyaml__log(config, CYAML_LOG_DEBUG, "Free: Top level data: %p\n", data);
-	cyaml__free_value(config, schema,
+	cyaml__free_ctx_init(&ctx, config);
+	cyaml__free_value(&ctx, schema,
 			(schema->flags & CYAML_FLAG_POINTER) ? &data : data,
 			seq_count);
+	cyaml__free_run(&ctx);
 	return CYAML_OK;
 }
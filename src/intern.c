@@ -0,0 +1,172 @@
+/*
+ * SPDX-License-Identifier: ISC
+ *
+ * Copyright (C) 2026 Michael Drake <tlsa@netsurf-browser.org>
+ */
+
+/**
+ * \file
+ * \brief CYAML loaded string interning.
+ *
+ * The hash table is open addressed, with linear probing, and it is kept at
+ * most half full.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "mem.h"
+#include "intern.h"
+#include "strpool.h"
+
+/** Initial number of slots in an interned string table. */
+#define CYAML_INTERN_TABLE_MIN 64
+
+/**
+ * Find the hash table slot for a string.
+ *
+ * \param[in]  table  The hash table.
+ * \param[in]  size   Number of slots in the hash table.  Power of two.
+ * \param[in]  str    The string to find.
+ * \param[in]  len    Length of `str` in bytes.
+ * \param[in]  hash   Hash of the string.
+ * \return the slot holding the string, or the empty slot where it belongs.
+ */
+static cyaml_intern_entry_t * cyaml__intern_slot(
+		cyaml_intern_entry_t *table,
+		uint32_t size,
+		const char *str,
+		size_t len,
+		uint32_t hash)
+{
+	uint32_t mask = size - 1;
+	uint32_t i = hash & mask;
+
+	while (table[i].str != NULL) {
+		const cyaml_intern_entry_t *entry = table + i;
+
+		if (entry->hash == hash && entry->len == len &&
+		    memcmp(entry->str, str, len) == 0) {
+			break;
+		}
+		i = (i + 1) & mask;
+	}
+
+	return table + i;
+}
+
+/**
+ * Ensure an interned string table has space for another string.
+ *
+ * \param[in]      config  The CYAML client config.
+ * \param[in,out]  intern  The interned string table.
+ * \return \ref CYAML_OK on success, or appropriate error code otherwise.
+ */
+static cyaml_err_t cyaml__intern_table_ensure(
+		const cyaml_config_t *config,
+		cyaml_intern_t *intern)
+{
+	cyaml_intern_entry_t *table;
+	uint32_t size;
+
+	if ((intern->count + 1) * 2 <= intern->table_size) {
+		return CYAML_OK;
+	}
+
+	if (intern->table_size == 0) {
+		size = CYAML_INTERN_TABLE_MIN;
+	} else if (intern->table_size > UINT32_MAX / 2 / sizeof(*table)) {
+		return CYAML_ERR_OOM;
+	} else {
+		size = intern->table_size * 2;
+	}
+
+	table = cyaml__alloc(config, size * sizeof(*table), true);
+	if (table == NULL) {
+		return CYAML_ERR_OOM;
+	}
+
+	for (uint32_t i = 0; i < intern->table_size; i++) {
+		const cyaml_intern_entry_t *entry = intern->table + i;
+
+		if (entry->str != NULL) {
+			*cyaml__intern_slot(table, size, entry->str,
+					entry->len, entry->hash) = *entry;
+		}
+	}
+
+	cyaml__free(config, intern->table);
+	intern->table = table;
+	intern->table_size = size;
+
+	return CYAML_OK;
+}
+
+/* Exported function, documented in intern.h. */
+cyaml_err_t cyaml__intern(
+		const cyaml_config_t *config,
+		cyaml_arena_t *arena,
+		cyaml_intern_t *intern,
+		const char *str,
+		size_t len,
+		const char **str_out)
+{
+	uint32_t hash = cyaml__strpool_hash(str, len);
+	cyaml_intern_entry_t *slot;
+	cyaml_err_t err;
+	char *copy;
+
+	if (intern->table_size != 0) {
+		slot = cyaml__intern_slot(intern->table, intern->table_size,
+				str, len, hash);
+		if (slot->str != NULL) {
+			*str_out = slot->str;
+			return CYAML_OK;
+		}
+	}
+
+	err = cyaml__intern_table_ensure(config, intern);
+	if (err != CYAML_OK) {
+		return err;
+	}
+
+	copy = cyaml__arena_realloc(config, arena, NULL, 0, len + 1, false);
+	if (copy == NULL) {
+		return CYAML_ERR_OOM;
+	}
+	memcpy(copy, str, len);
+	copy[len] = '\0';
+
+	*cyaml__intern_slot(intern->table, intern->table_size,
+			str, len, hash) = (cyaml_intern_entry_t) {
+		.str = copy,
+		.len = len,
+		.hash = hash,
+	};
+	intern->count++;
+
+	*str_out = copy;
+	return CYAML_OK;
+}
+
+/* Exported function, documented in intern.h. */
+void cyaml__intern_reset(
+		cyaml_intern_t *intern)
+{
+	if (intern->table != NULL) {
+		memset(intern->table, 0,
+				intern->table_size * sizeof(*intern->table));
+	}
+	intern->count = 0;
+}
+
+/* Exported function, documented in intern.h. */
+void cyaml__intern_free(
+		const cyaml_config_t *config,
+		cyaml_intern_t *intern)
+{
+	cyaml__free(config, intern->table);
+
+	*intern = (cyaml_intern_t) { 0 };
+}
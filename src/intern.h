@@ -0,0 +1,82 @@
+/*
+ * SPDX-License-Identifier: ISC
+ *
+ * Copyright (C) 2026 Michael Drake <tlsa@netsurf-browser.org>
+ */
+
+/**
+ * \file
+ * \brief CYAML loaded string interning.
+ */
+
+#ifndef CYAML_INTERN_H
+#define CYAML_INTERN_H
+
+#include "cyaml/cyaml.h"
+
+#include "arena.h"
+
+/**
+ * An interned string table entry.
+ */
+typedef struct cyaml_intern_entry {
+	const char *str; /**< The interned string, or NULL for unused slots. */
+	size_t len;      /**< Length of `str` in bytes. */
+	uint32_t hash;   /**< Hash of `str`. */
+} cyaml_intern_entry_t;
+
+/**
+ * A table of strings interned in an arena.
+ *
+ * Each unique string is allocated from the arena once, and the allocation
+ * is shared by every value with that string.  The strings belong to the
+ * arena, so the table must be reset whenever its arena is handed over to
+ * the client.
+ */
+typedef struct cyaml_intern {
+	cyaml_intern_entry_t *table; /**< Hash table of strings, or NULL. */
+	uint32_t table_size; /**< Number of slots in `table`.  Power of two. */
+	uint32_t count;      /**< Number of strings in the table. */
+} cyaml_intern_t;
+
+/**
+ * Get the interned copy of a string, interning it if it isn't already.
+ *
+ * \param[in]      config   The CYAML client config.
+ * \param[in]      arena    The arena to allocate interned strings from.
+ * \param[in,out]  intern   The interned string table.
+ * \param[in]      str      The string to intern.
+ * \param[in]      len      Length of `str` in bytes.
+ * \param[out]     str_out  Returns the interned '\0' terminated string.
+ * \return \ref CYAML_OK on success, or appropriate error code otherwise.
+ */
+cyaml_err_t cyaml__intern(
+		const cyaml_config_t *config,
+		cyaml_arena_t *arena,
+		cyaml_intern_t *intern,
+		const char *str,
+		size_t len,
+		const char **str_out);
+
+/**
+ * Remove all the strings from an interned string table, keeping its
+ * allocation.
+ *
+ * \param[in,out]  intern  The interned string table to empty.
+ */
+void cyaml__intern_reset(
+		cyaml_intern_t *intern);
+
+/**
+ * Free an interned string table's allocation.
+ *
+ * The interned strings themselves belong to the arena, and are not freed.
+ *
+ * \param[in]      config  The CYAML client config.
+ * \param[in,out]  intern  The interned string table to free.  Left empty.
+ */
+void cyaml__intern_free(
+		const cyaml_config_t *config,
+		cyaml_intern_t *intern);
+
+#endif
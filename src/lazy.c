@@ -0,0 +1,41 @@
+/*
+ * SPDX-License-Identifier: ISC
+ *
+ * Copyright (C) 2026 Michael Drake <tlsa@netsurf-browser.org>
+ */
+
+/**
+ * \file
+ * \brief CYAML lazy value helpers.
+ */
+
+#include <stdbool.h>
+#include <string.h>
+
+#include "mem.h"
+#include "lazy.h"
+
+/* Exported function, documented in lazy.h. */
+uint8_t * cyaml__lazy_input(
+		const cyaml_config_t *config,
+		const cyaml_lazy_t *lazy,
+		size_t *len_out)
+{
+	size_t len = lazy->column + lazy->len;
+	uint8_t *input;
+
+	if (len < lazy->len) {
+		return NULL;
+	}
+
+	input = cyaml__alloc(config, len == 0 ? 1 : len, false);
+	if (input == NULL) {
+		return NULL;
+	}
+
+	memset(input, ' ', lazy->column);
+	memcpy(input + lazy->column, lazy->input, lazy->len);
+
+	*len_out = len;
+	return input;
+}
@@ -0,0 +1,38 @@
+/*
+ * SPDX-License-Identifier: ISC
+ *
+ * Copyright (C) 2026 Michael Drake <tlsa@netsurf-browser.org>
+ */
+
+/**
+ * \file
+ * \brief CYAML lazy value helpers.
+ */
+
+#ifndef CYAML_LAZY_H
+#define CYAML_LAZY_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "cyaml/cyaml.h"
+
+/**
+ * Create a YAML input buffer for a lazy value.
+ *
+ * The value's YAML is preceded by spaces up to the column it started at in
+ * the original input, so that the indentation of block collections is kept.
+ * Offsets into the buffer, from the end of the spaces onwards, correspond to
+ * offsets into the lazy value's YAML.
+ *
+ * \param[in]  config   The client's CYAML library config.
+ * \param[in]  lazy     The lazy value to create an input buffer for.
+ * \param[out] len_out  Returns the length of the buffer in bytes.
+ * \return the allocated buffer, or NULL on allocation failure.
+ */
+uint8_t * cyaml__lazy_input(
+		const cyaml_config_t *config,
+		const cyaml_lazy_t *lazy,
+		size_t *len_out);
+
+#endif
@@ -13,22 +13,43 @@
  * in the client's data structure.
  */
 
+/* For mmap and pthreads. */
+#define _POSIX_C_SOURCE 200809L
+
 #include <inttypes.h>
 #include <stdbool.h>
 #include <assert.h>
 #include <limits.h>
-#include <errno.h>
 #include <float.h>
 #include <math.h>
 
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#define CYAML_HAVE_MMAP 1
+#define CYAML_HAVE_PTHREAD 1
+#else
+#define CYAML_HAVE_MMAP 0
+#define CYAML_HAVE_PTHREAD 0
+#endif
+
 #include <yaml.h>
 
 #include "mem.h"
 #include "data.h"
+#include "strpool.h"
+#include "intern.h"
 #include "util.h"
-
-/** Identifies that no mapping schema entry was found for key. */
-#define CYAML_FIELDS_IDX_NONE 0xffff
+#include "copy.h"
+#include "arena.h"
+#include "schema.h"
+#include "number.h"
+#include "parallel.h"
+#include "scan.h"
+#include "lazy.h"
 
 /**
  * CYAML events.  These correspond to `libyaml` events.
@@ -48,6 +69,14 @@ typedef enum cyaml_event {
 	CYAML_EVT__COUNT,
 } cyaml_event_t;
 
+/**
+ * Number of bitfield entries a mapping's state has space for.
+ *
+ * Mappings with more fields than fit get their bitfield from the load
+ * context's bitfield pool.
+ */
+#define CYAML_BITFIELD_INLINE 2
+
 /**
  * A CYAML load state machine stack entry.
  */
@@ -72,17 +101,34 @@ typedef struct cyaml_state {
 		 * \ref CYAML_STATE_IN_MAP_VALUE states. */
 		struct {
 			const cyaml_schema_field_t *fields;
-			/** Bit field of mapping fields found. */
-			cyaml_bitfield_t *fields_set;
+			/** Compiled mapping details, or NULL. */
+			const cyaml_schema_mapping_t *compiled;
+			/** Bit field of mapping fields found, for mappings
+			 *  with few enough fields. */
+			cyaml_bitfield_t fields_inline[CYAML_BITFIELD_INLINE];
+			/** Bit field of mapping fields found, for other
+			 *  mappings.  This is an index into the load
+			 *  context's bitfield pool. */
+			uint32_t fields_set;
 			uint16_t fields_count;
 			uint16_t fields_idx;
+			/** For entries of a \ref CYAML_FLAG_COLUMNAR sequence,
+			 *  the number of entries each column has space for,
+			 *  or zero for other mappings. */
+			uint32_t columns;
+			/** Index of this entry in the columns. */
+			uint32_t column;
 		} mapping;
 		/**  Additional state for \ref CYAML_STATE_IN_SEQUENCE state. */
 		struct {
 			uint8_t *data;
 			uint8_t *count_data;
 			uint32_t count;
+			/** Number of entries `data` has space for. */
+			uint32_t capacity;
 			uint8_t count_size;
+			/** Whether the entries are loaded in bulk. */
+			bool bulk;
 		} sequence;
 	};
 	uint8_t *data; /**< Pointer to output client data for this state. */
@@ -101,6 +147,20 @@ typedef struct cyaml_anchor {
 	uint32_t end;   /**< Index into \ref cyaml_event_ctx_t events array. */
 } cyaml_anchor_t;
 
+/**
+ * Recorded event data.
+ *
+ * This is a compact form of the parts of a `libyaml` event that the loader
+ * uses.  Any scalar value is interned in the recording's string pool, so
+ * that the `libyaml` event can be deleted as soon as it is recorded.
+ */
+typedef struct cyaml_recorded_event {
+	yaml_mark_t start_mark; /**< Start position of the event. */
+	yaml_event_type_t type; /**< The `libyaml` event type. */
+	uint32_t value;         /**< Scalar value's string pool offset. */
+	uint32_t length;        /**< Scalar value's length. */
+} cyaml_recorded_event_t;
+
 /**
  * Event recording context.
  *
@@ -113,7 +173,9 @@ typedef struct cyaml_event_record {
 	cyaml_anchor_t *complete;
 	/** Array of recording anchor details or NULL. */
 	cyaml_anchor_t *progress;
-	yaml_event_t *data;      /**< Array of anchor-referenced events. */
+	/** Array of anchor-referenced events. */
+	cyaml_recorded_event_t *data;
+	cyaml_strpool_t strings; /**< Pool of recorded scalar values. */
 	uint32_t *events;        /**< Array of event data indices. */
 	uint32_t *stack;         /**< Stack of start event array indices. */
 	uint32_t complete_count; /**< Number of anchor details in `complete`. */
@@ -121,6 +183,11 @@ typedef struct cyaml_event_record {
 	uint32_t events_count;   /**< Number of events in events array. */
 	uint32_t stack_count;    /**< Number of entries in the event stack. */
 	uint32_t data_count;     /**< Number of recorded libyaml events. */
+	uint32_t complete_max;   /**< Allocated entries in `complete`. */
+	uint32_t progress_max;   /**< Allocated entries in `progress`. */
+	uint32_t events_max;     /**< Allocated entries in `events`. */
+	uint32_t stack_max;      /**< Allocated entries in `stack`. */
+	uint32_t data_max;       /**< Allocated entries in `data`. */
 } cyaml_event_record_t;
 
 /**
@@ -146,11 +213,22 @@ typedef struct cyaml_event_ctx {
 	cyaml_event_replay_t replay; /**< Event replaying context. */
 } cyaml_event_ctx_t;
 
+/**
+ * Client's multi-document stream callback details.
+ */
+typedef struct cyaml_stream {
+	cyaml_doc_fn_t doc_fn; /**< Client's document callback. */
+	void *doc_ctx;         /**< Client's document callback context. */
+} cyaml_stream_t;
+
 /**
  * Internal YAML loading context.
  */
 typedef struct cyaml_ctx {
 	const cyaml_config_t *config; /**< Settings provided by client. */
+	cyaml_arena_t *arena;         /**< Arena for loaded data, or NULL. */
+	/** Client's stream callback, or NULL to load a single document. */
+	const cyaml_stream_t *stream;
 	cyaml_event_ctx_t event_ctx;  /**< Our LibYAML event context. */
 	cyaml_state_t *state;   /**< Current entry in state stack, or NULL. */
 	cyaml_state_t *stack;   /**< State stack */
@@ -158,8 +236,82 @@ typedef struct cyaml_ctx {
 	uint32_t stack_max;     /**< Current stack allocation limit. */
 	unsigned seq_count;     /**< Top-level sequence count. */
 	yaml_parser_t *parser;  /**< Internal libyaml parser object. */
+	cyaml_scan_t *scan;     /**< Native scanner, used instead of parser. */
+	/** Pool of mapping bitfields, used in stack order. */
+	cyaml_bitfield_t *bitfields;
+	uint32_t bitfields_used; /**< Entries used in `bitfields`. */
+	uint32_t bitfields_max;  /**< Entries allocated in `bitfields`. */
+	/** Strings interned for \ref CYAML_CFG_INTERN arena loads. */
+	cyaml_intern_t intern;
+	/**
+	 * The client's input that is being parsed, for lazy values, or NULL
+	 * if the input isn't retained.  The parsed input has `column` spaces
+	 * before the client's input.
+	 */
+	const cyaml_lazy_t *origin;
+	size_t lazy_index;  /**< Input character index at `lazy_offset`. */
+	size_t lazy_offset; /**< Parsed input byte offset at `lazy_index`. */
+	uint64_t alias_events; /**< Number of events replayed for aliases. */
+	uint32_t depth;        /**< Current mapping and sequence depth. */
 } cyaml_ctx_t;
 
+/**
+ * Stack size for incremental load parser threads.
+ *
+ * The load itself doesn't recurse, so this only needs to cover `libyaml`
+ * and the client's callbacks, which are also called on the parser thread.
+ */
+#ifndef CYAML_FEED_STACK_SIZE
+#define CYAML_FEED_STACK_SIZE (256 * 1024)
+#endif
+
+/**
+ * Incremental load state.
+ *
+ * With threads, the parser runs on its own thread, and its read handler
+ * waits for the client to feed input.  The client's thread and the parser
+ * thread take turns; only one of them runs at a time.  Without threads,
+ * the fed input is buffered until the end of the input.
+ */
+typedef struct cyaml_feed {
+	const cyaml_schema_value_t *schema; /**< Client's schema for load. */
+	cyaml_data_t *data;     /**< Loaded data, once done. */
+	unsigned seq_count;     /**< Loaded sequence entry count, once done. */
+	cyaml_err_t err;        /**< Result of the load, once done. */
+#if CYAML_HAVE_PTHREAD
+	pthread_t thread;       /**< Thread the parser runs on. */
+	pthread_mutex_t lock;   /**< Lock for the state below. */
+	pthread_cond_t cond;    /**< Signalled when the state below changes. */
+	const uint8_t *input;   /**< Fed input not yet read by the parser. */
+	size_t input_len;       /**< Length of fed input not yet read. */
+	bool starved;           /**< Parser is waiting for more input. */
+	bool end;               /**< Client has ended the input. */
+	bool abort;             /**< Client is abandoning the load. */
+	bool done;              /**< Load is complete. */
+#else
+	uint8_t *buffer;        /**< Fed input. */
+	size_t buffer_len;      /**< Length of fed input. */
+	size_t buffer_size;     /**< Size of buffer allocation. */
+#endif
+} cyaml_feed_t;
+
+/**
+ * CYAML loader.
+ *
+ * This holds on to the allocations made while loading a document, so that
+ * they can be reused to load subsequent documents.
+ */
+struct cyaml_loader {
+	const cyaml_config_t *config; /**< Settings provided by client. */
+	cyaml_state_t *stack;         /**< Retained state stack. */
+	uint32_t stack_max;           /**< Retained state stack size. */
+	cyaml_bitfield_t *bitfields;  /**< Retained mapping bitfield pool. */
+	uint32_t bitfields_max;       /**< Retained bitfield pool size. */
+	cyaml_intern_t intern;        /**< Retained interned string table. */
+	cyaml_event_record_t record;  /**< Retained event recording buffers. */
+	cyaml_feed_t *feed;           /**< Incremental load, or NULL. */
+};
+
 /**
  * Check that \ref CYAML_INT value value is allowed by client.
  *
@@ -452,25 +604,22 @@ static cyaml_err_t cyaml__store_float(
 }
 
 /**
- * Store a string value to client data structure according to schema.
+ * Check that a string value is allowed by the schema and client.
  *
- * \param[in]  ctx       The CYAML loading context.
- * \param[in]  schema    The schema for the value to be stored.
- * \param[in]  location  The place to write the value in the output data.
- * \param[in]  value     The value to store.
+ * \param[in]  ctx      The CYAML loading context.
+ * \param[in]  schema   The schema for the value.
+ * \param[in]  value    The value to check.
+ * \param[in]  str_len  Length of `value` in bytes.
  * \return \ref CYAML_OK on success, or appropriate error code otherwise.
  */
-static cyaml_err_t cyaml__store_string(
+static cyaml_err_t cyaml__validate_string(
 		const cyaml_ctx_t *ctx,
 		const cyaml_schema_value_t *schema,
-		uint8_t *location,
-		const char *value)
+		const char *value,
+		size_t str_len)
 {
-	size_t str_len = strlen(value);
 	cyaml_validate_string_fn_t validate_cb = schema->string.validation_cb;
 
-	CYAML_UNUSED(ctx);
-
 	if (schema->string.min > schema->string.max) {
 		return CYAML_ERR_BAD_MIN_MAX_SCHEMA;
 	} else if (str_len < schema->string.min) {
@@ -491,6 +640,32 @@ static cyaml_err_t cyaml__store_string(
 		}
 	}
 
+	return CYAML_OK;
+}
+
+/**
+ * Store a string value to client data structure according to schema.
+ *
+ * \param[in]  ctx       The CYAML loading context.
+ * \param[in]  schema    The schema for the value to be stored.
+ * \param[in]  location  The place to write the value in the output data.
+ * \param[in]  value     The value to store.
+ * \return \ref CYAML_OK on success, or appropriate error code otherwise.
+ */
+static cyaml_err_t cyaml__store_string(
+		const cyaml_ctx_t *ctx,
+		const cyaml_schema_value_t *schema,
+		uint8_t *location,
+		const char *value)
+{
+	size_t str_len = strlen(value);
+	cyaml_err_t err;
+
+	err = cyaml__validate_string(ctx, schema, value, str_len);
+	if (err != CYAML_OK) {
+		return err;
+	}
+
 	memcpy(location, value, str_len + 1);
 
 	return CYAML_OK;
@@ -508,12 +683,12 @@ static inline cyaml_event_t cyaml__get_event_type(const yaml_event_t *event)
 }
 
 /**
- * Convert a `libyaml` event to a human readable string.
+ * Convert a `libyaml` event type to a human readable string.
  *
- * \param[in]  event  The `libyaml` event.
- * \return String representing event.
+ * \param[in]  type  The `libyaml` event type.
+ * \return String representing event type.
  */
-static const char * cyaml__libyaml_event_type_str(const yaml_event_t *event)
+static const char * cyaml__libyaml_event_type_to_str(yaml_event_type_t type)
 {
 	static const char * const strings[] = {
 		"NO_EVENT",
@@ -528,7 +703,19 @@ static const char * cyaml__libyaml_event_type_str(const yaml_event_t *event)
 		"MAPPING_START",
 		"MAPPING_END",
 	};
-	return strings[event->type];
+	return strings[type];
+}
+
+/**
+ * Convert a `libyaml` event to a human readable string.
+ *
+ * \param[in]  event  The `libyaml` event.
+ * \return String representing event.
+ */
+static inline const char * cyaml__libyaml_event_type_str(
+		const yaml_event_t *event)
+{
+	return cyaml__libyaml_event_type_to_str(event->type);
 }
 
 /**
@@ -609,6 +796,20 @@ static cyaml_err_t cyaml__handle_alias(
 
 	anchor_idx -= 1;
 
+	if (ctx->config->max_alias_events != 0) {
+		const cyaml_anchor_t *anchor = record->complete + anchor_idx;
+		uint64_t events = (uint64_t)anchor->end - anchor->start + 1;
+
+		if (events > ctx->config->max_alias_events -
+				ctx->alias_events) {
+			cyaml__log(ctx->config, CYAML_LOG_ERROR,
+					"Load: Alias event limit exceeded "
+					"by alias: '%s'\n", alias);
+			return CYAML_ERR_LIMIT_ALIAS_EVENTS;
+		}
+		ctx->alias_events += events;
+	}
+
 	cyaml__log(ctx->config, CYAML_LOG_INFO,
 			"Load: Found alias for anchor: '%s'\n", alias);
 
@@ -616,28 +817,86 @@ static cyaml_err_t cyaml__handle_alias(
 	replay->anchor_idx = anchor_idx;
 	replay->event_idx = record->complete[anchor_idx].start;
 
+	if (cyaml__stats(ctx->config) != NULL) {
+		cyaml__stats(ctx->config)->aliases++;
+	}
+
 	return CYAML_OK;
 }
 
+/** Minimum number of entries to allocate for an event recording array. */
+#define CYAML_RECORD_ARRAY_MIN 8
+
+/**
+ * Ensure an event recording array has space for another entry.
+ *
+ * Arrays grow geometrically, so recording many events doesn't need an
+ * allocation for each event.
+ *
+ * \param[in]      ctx         The CYAML loading context.
+ * \param[in]      array       The array to ensure space in, or NULL.
+ * \param[in]      entry_size  Size of an array entry in bytes.
+ * \param[in]      count       Number of entries used in the array.
+ * \param[in,out]  max         Allocated entries in array. Updated on success.
+ * \param[in]      hint        Entries to allocate for a new array, or zero.
+ * \return the array on success, or NULL on failure.
+ */
+static void * cyaml__record_array_ensure(
+		cyaml_ctx_t *ctx,
+		void *array,
+		size_t entry_size,
+		uint32_t count,
+		uint32_t *max,
+		uint32_t hint)
+{
+	uint32_t new_max;
+
+	if (count < *max) {
+		return array;
+	}
+
+	if (*max == 0) {
+		new_max = (hint > CYAML_RECORD_ARRAY_MIN) ?
+				hint : CYAML_RECORD_ARRAY_MIN;
+	} else if (*max > UINT32_MAX / 2) {
+		return NULL;
+	} else {
+		new_max = *max * 2;
+	}
+
+	if (new_max > SIZE_MAX / entry_size) {
+		return NULL;
+	}
+
+	array = cyaml__realloc(ctx->config, array, entry_size * *max,
+			entry_size * new_max, true);
+	if (array == NULL) {
+		return NULL;
+	}
+
+	*max = new_max;
+	return array;
+}
+
 /**
  * Create new anchor entry at the end of an anchors array.
  *
  * \param[in]      ctx            The CYAML loading context.
  * \param[in,out]  anchors_count  Count of anchors in array. Updated on success.
+ * \param[in,out]  anchors_max    Allocated anchors in array. Updated on success.
  * \param[in,out]  anchors        Anchors array, updated on success.
  * \return \ref CYAML_OK on success, or appropriate error otherwise.
  */
 static cyaml_err_t cyaml__new_anchor(
 		cyaml_ctx_t *ctx,
 		uint32_t *anchors_count,
+		uint32_t *anchors_max,
 		cyaml_anchor_t **anchors)
 {
-	size_t anchors_size;
 	cyaml_anchor_t *temp;
 
-	anchors_size = *anchors_count * sizeof(**anchors);
-	temp = cyaml__realloc(ctx->config, *anchors, anchors_size,
-			anchors_size + sizeof(**anchors), true);
+	temp = cyaml__record_array_ensure(ctx, *anchors, sizeof(**anchors),
+			*anchors_count, anchors_max, 0);
 	if (temp == NULL) {
 		return CYAML_ERR_OOM;
 	}
@@ -687,6 +946,7 @@ static cyaml_err_t cyaml__handle_anchor(
 		/* Start of multi-event recording. */
 		err = cyaml__new_anchor(ctx,
 				&record->progress_count,
+				&record->progress_max,
 				&record->progress);
 		if (err != CYAML_OK) {
 			return err;
@@ -696,6 +956,7 @@ static cyaml_err_t cyaml__handle_anchor(
 		/* Single event anchor */
 		err = cyaml__new_anchor(ctx,
 				&record->complete_count,
+				&record->complete_max,
 				&record->complete);
 		if (err != CYAML_OK) {
 			return err;
@@ -710,6 +971,10 @@ static cyaml_err_t cyaml__handle_anchor(
 		return CYAML_ERR_OOM;
 	}
 
+	if (cyaml__stats(ctx->config) != NULL) {
+		cyaml__stats(ctx->config)->anchors++;
+	}
+
 	*is_anchor_out = true;
 	return CYAML_OK;
 }
@@ -726,15 +991,13 @@ static cyaml_err_t cyaml__record_stack_push(
 		uint32_t event_index)
 {
 	uint32_t *stack;
-	size_t stack_size;
 	uint32_t stack_count;
 	cyaml_event_ctx_t *e_ctx = &ctx->event_ctx;
 	cyaml_event_record_t *record = &e_ctx->record;
 
 	stack_count = record->stack_count;
-	stack_size = stack_count * sizeof(*stack);
-	stack = cyaml__realloc(ctx->config, record->stack,
-			stack_size, stack_size + sizeof(*stack), true);
+	stack = cyaml__record_array_ensure(ctx, record->stack, sizeof(*stack),
+			stack_count, &record->stack_max, 0);
 	if (stack == NULL) {
 		return CYAML_ERR_OOM;
 	}
@@ -745,8 +1008,8 @@ static cyaml_err_t cyaml__record_stack_push(
 
 	cyaml__log(ctx->config, CYAML_LOG_DEBUG,
 			"Load:   Push recording stack entry for %s\n",
-			cyaml__libyaml_event_type_str(
-				&record->data[record->events[event_index]]));
+			cyaml__libyaml_event_type_to_str(
+				record->data[record->events[event_index]].type));
 
 	return CYAML_OK;
 }
@@ -782,6 +1045,7 @@ static cyaml_err_t cyaml__record_stack_pop(
 
 		err = cyaml__new_anchor(ctx,
 				&record->complete_count,
+				&record->complete_max,
 				&record->complete);
 		if (err != CYAML_OK) {
 			return err;
@@ -799,8 +1063,8 @@ static cyaml_err_t cyaml__record_stack_pop(
 	record->stack_count--;
 	cyaml__log(ctx->config, CYAML_LOG_DEBUG,
 			"Load:   Pop recording stack entry for %s\n",
-			cyaml__libyaml_event_type_str(
-				&record->data[record->events[event_index]]));
+			cyaml__libyaml_event_type_to_str(
+				record->data[record->events[event_index]].type));
 
 	return CYAML_OK;
 }
@@ -842,6 +1106,42 @@ static cyaml_err_t cyaml__update_anchor_recordings(
 	return CYAML_OK;
 }
 
+/**
+ * Fill out a recorded event from a `libyaml` event.
+ *
+ * \param[in]  ctx        The CYAML loading context.
+ * \param[in]  event      The `libyaml` event to record.
+ * \param[out] event_out  The recorded event to fill out.
+ * \return \ref CYAML_OK on success, or appropriate error otherwise.
+ */
+static cyaml_err_t cyaml__record_event_data(
+		cyaml_ctx_t *ctx,
+		const yaml_event_t *event,
+		cyaml_recorded_event_t *event_out)
+{
+	cyaml_event_record_t *record = &ctx->event_ctx.record;
+
+	*event_out = (cyaml_recorded_event_t) {
+		.start_mark = event->start_mark,
+		.type = event->type,
+	};
+
+	if (event->type == YAML_SCALAR_EVENT) {
+		cyaml_err_t err;
+
+		err = cyaml__strpool_intern(ctx->config, &record->strings,
+				(const char *)event->data.scalar.value,
+				event->data.scalar.length,
+				&event_out->value);
+		if (err != CYAML_OK) {
+			return err;
+		}
+		event_out->length = (uint32_t)event->data.scalar.length;
+	}
+
+	return CYAML_OK;
+}
+
 /**
  * Handle the recording of the current event.
  *
@@ -858,7 +1158,6 @@ static cyaml_err_t cyaml__handle_record(
 		uint32_t replay_event_index)
 {
 	uint32_t *events;
-	size_t events_size;
 	uint32_t event_index;
 	uint32_t events_count;
 	cyaml_event_ctx_t *e_ctx = &ctx->event_ctx;
@@ -871,8 +1170,7 @@ static cyaml_err_t cyaml__handle_record(
 
 		event_index = record->events[replay_event_index];
 	} else {
-		size_t data_size;
-		yaml_event_t *data;
+		cyaml_recorded_event_t *data;
 		uint32_t data_count;
 		bool event_has_anchor = false;
 
@@ -891,28 +1189,28 @@ static cyaml_err_t cyaml__handle_record(
 
 		/* Record event data. */
 		data_count = record->data_count;
-		data_size = data_count * sizeof(*data);
-		data = cyaml__realloc(ctx->config, record->data,
-				data_size, data_size + sizeof(*data),
-				true);
+		data = cyaml__record_array_ensure(ctx, record->data,
+				sizeof(*data), data_count, &record->data_max,
+				ctx->config->anchor_events_hint);
 		if (data == NULL) {
 			return CYAML_ERR_OOM;
 		}
 		record->data = data;
-		record->data_count++;
 
-		memcpy(data + data_count, event, sizeof(*data));
-		e_ctx->have_event = false;
+		err = cyaml__record_event_data(ctx, event, data + data_count);
+		if (err != CYAML_OK) {
+			return err;
+		}
+		record->data_count++;
 		event_index = data_count;
 	}
 
 	/* Record event data index.  Multiple event data indexes can
 	 * reference the same event data, due to replaying of events. */
 	events_count = record->events_count;
-	events_size = events_count * sizeof(*events);
-	events = cyaml__realloc(ctx->config, record->events,
-			events_size, events_size + sizeof(*events),
-			true);
+	events = cyaml__record_array_ensure(ctx, record->events,
+			sizeof(*events), events_count, &record->events_max,
+			ctx->config->anchor_events_hint);
 	if (events == NULL) {
 		return CYAML_ERR_OOM;
 	}
@@ -947,7 +1245,7 @@ static void cyaml__handle_replay(
 	cyaml_event_ctx_t *e_ctx = &ctx->event_ctx;
 	cyaml_event_replay_t *replay = &e_ctx->replay;
 	const cyaml_event_record_t *record = &e_ctx->record;
-	const yaml_event_t *replay_event = record->data +
+	const cyaml_recorded_event_t *replay_event = record->data +
 			record->events[replay->event_idx];
 	const cyaml_anchor_t *replay_anchor = record->complete +
 			replay->anchor_idx;
@@ -970,7 +1268,17 @@ static void cyaml__handle_replay(
 		replay->event_idx++;
 	}
 
-	memcpy(event_out, replay_event, sizeof(*event_out));
+	*event_out = (yaml_event_t) {
+		.type = replay_event->type,
+		.start_mark = replay_event->start_mark,
+		.end_mark = replay_event->start_mark,
+	};
+	if (replay_event->type == YAML_SCALAR_EVENT) {
+		event_out->data.scalar.value = (yaml_char_t *)(uintptr_t)
+				cyaml__strpool_get(&record->strings,
+						replay_event->value);
+		event_out->data.scalar.length = replay_event->length;
+	}
 	*event_index_out = event_index;
 }
 
@@ -986,38 +1294,56 @@ static void cyaml__delete_yaml_event(
 		cyaml_ctx_t *ctx)
 {
 	if (ctx->event_ctx.have_event) {
-		yaml_event_delete(&ctx->event_ctx.event);
+		if (ctx->scan == NULL) {
+			yaml_event_delete(&ctx->event_ctx.event);
+		}
 		ctx->event_ctx.have_event = false;
 	}
 }
 
 /**
- * Free any recordings from the CYAML loading context.
+ * Empty a recording, keeping its buffers for reuse.
  *
- * \param[in]  ctx    The CYAML loading context.
+ * \param[in]      config  The client's CYAML library config.
+ * \param[in,out]  record  The event recording context to empty.
  */
-static void cyaml__free_recording(
-		cyaml_ctx_t *ctx)
+static void cyaml__reset_recording(
+		const cyaml_config_t *config,
+		cyaml_event_record_t *record)
 {
-	cyaml_event_ctx_t *e_ctx = &ctx->event_ctx;
-	cyaml_event_record_t *record = &e_ctx->record;
-
 	for (uint32_t i = 0; i < record->progress_count; i++) {
-		cyaml__free(ctx->config, record->progress[i].name);
+		cyaml__free(config, record->progress[i].name);
 	}
-	cyaml__free(ctx->config, record->progress);
-
 	for (uint32_t i = 0; i < record->complete_count; i++) {
-		cyaml__free(ctx->config, record->complete[i].name);
+		cyaml__free(config, record->complete[i].name);
 	}
-	cyaml__free(ctx->config, record->complete);
+	cyaml__strpool_reset(&record->strings);
 
-	for (uint32_t i = 0; i < record->data_count; i++) {
-		yaml_event_delete(&record->data[i]);
-	}
-	cyaml__free(ctx->config, record->events);
-	cyaml__free(ctx->config, record->stack);
-	cyaml__free(ctx->config, record->data);
+	record->complete_count = 0;
+	record->progress_count = 0;
+	record->events_count = 0;
+	record->stack_count = 0;
+	record->data_count = 0;
+}
+
+/**
+ * Free a recording, including its buffers.
+ *
+ * \param[in]  config  The client's CYAML library config.
+ * \param[in]  record  The event recording context to free.
+ */
+static void cyaml__free_recording(
+		const cyaml_config_t *config,
+		cyaml_event_record_t *record)
+{
+	cyaml__reset_recording(config, record);
+	cyaml__free(config, record->progress);
+	cyaml__free(config, record->complete);
+
+	cyaml__strpool_free(config, &record->strings);
+	cyaml__free(config, record->events);
+	cyaml__free(config, record->stack);
+	cyaml__free(config, record->data);
 }
 
 /**
@@ -1042,6 +1368,7 @@ static cyaml_err_t cyaml_get_next_event(
 		cyaml_ctx_t *ctx)
 {
 	cyaml_event_ctx_t *e_ctx = &ctx->event_ctx;
+	cyaml_stats_t *stats = cyaml__stats(ctx->config);
 	yaml_event_t *event = &e_ctx->event;
 	uint32_t replay_event_index = 0;
 	bool replayed_event = false;
@@ -1050,7 +1377,30 @@ static cyaml_err_t cyaml_get_next_event(
 	cyaml__delete_yaml_event(ctx);
 
 	if (!e_ctx->replay.active) {
-		if (!yaml_parser_parse(ctx->parser, event)) {
+		uint64_t start = (stats != NULL) ? cyaml__stats_now() : 0;
+		int parsed;
+
+		if (ctx->scan != NULL) {
+			cyaml_scan_result_t res;
+
+			res = cyaml__scan_next(ctx->scan, event);
+			if (stats != NULL) {
+				stats->libyaml_ns += cyaml__stats_now() - start;
+			}
+			if (res != CYAML_SCAN_OK) {
+				/* Input is checked before loading natively,
+				 * so only allocation can fail. */
+				assert(res == CYAML_SCAN_OOM);
+				return CYAML_ERR_OOM;
+			}
+			parsed = 1;
+		} else {
+			parsed = yaml_parser_parse(ctx->parser, event);
+			if (stats != NULL) {
+				stats->libyaml_ns += cyaml__stats_now() - start;
+			}
+		}
+		if (!parsed) {
 			cyaml__log(ctx->config, CYAML_LOG_ERROR,
 					"Load: libyaml: %s\n",
 					ctx->parser->problem);
@@ -1058,6 +1408,15 @@ static cyaml_err_t cyaml_get_next_event(
 		}
 		e_ctx->have_event = true;
 
+		/* The parser's offset counts the input bytes it has
+		 * read, which may be ahead of the current event. */
+		if (ctx->scan == NULL && ctx->config->max_input_size != 0 &&
+		    ctx->parser->offset > ctx->config->max_input_size) {
+			cyaml__log(ctx->config, CYAML_LOG_ERROR,
+					"Load: Input size limit exceeded\n");
+			return CYAML_ERR_LIMIT_INPUT_SIZE;
+		}
+
 		if (event->type == YAML_ALIAS_EVENT) {
 			if (ctx->config->flags & CYAML_CFG_NO_ALIAS) {
 				return CYAML_ERR_ALIAS;
@@ -1080,6 +1439,10 @@ static cyaml_err_t cyaml_get_next_event(
 	cyaml__log(ctx->config, CYAML_LOG_DEBUG, "Load: Event: %s\n",
 			cyaml__libyaml_event_type_str(event));
 
+	if (stats != NULL && (unsigned)event->type < CYAML_EVENT__COUNT) {
+		stats->events[event->type]++;
+	}
+
 	if (ctx->config->flags & CYAML_CFG_NO_ALIAS) {
 		return CYAML_OK;
 	}
@@ -1107,22 +1470,31 @@ static inline const yaml_event_t * cyaml__current_event(
 /**
  * Get the offset to a mapping field by key in a mapping schema array.
  *
+ * If the current mapping has compiled details, they are used to find the
+ * field, otherwise the mapping schema's fields are searched linearly.
+ *
  * \param[in]  cfg     The client's CYAML library config.
- * \param[in]  schema  CYAML schema for the mapping value to be loaded.
+ * \param[in]  state   CYAML load state for a \ref CYAML_STATE_IN_MAP_KEY state.
  * \param[in]  key     Key to search for in mapping schema.
  * \return index the mapping schema's mapping fields array for key, or
  *         \ref CYAML_FIELDS_IDX_NONE if key is not present in schema.
  */
 static inline uint16_t cyaml__get_mapping_field_idx(
 		const cyaml_config_t *cfg,
-		const cyaml_schema_value_t *schema,
+		const cyaml_state_t *state,
 		const char *key)
 {
+	const cyaml_schema_value_t *schema = state->schema;
 	const cyaml_schema_field_t *fields = schema->mapping.fields;
 	uint16_t index = 0;
 
 	assert(schema->type == CYAML_MAPPING);
 
+	if (state->mapping.compiled != NULL) {
+		return cyaml__schema_mapping_field_idx(
+				state->mapping.compiled, key);
+	}
+
 	/* Step through each entry in the schema */
 	for (; fields->key != NULL; fields++) {
 		if (cyaml__strcmp(cfg, schema, fields->key, key) == 0) {
@@ -1157,6 +1529,39 @@ static inline const cyaml_schema_field_t * cyaml_mapping_schema_field(
 	return state->mapping.fields + state->mapping.fields_idx;
 }
 
+/**
+ * Get the address of a mapping field's value in the client data.
+ *
+ * \param[in]  state  The mapping's CYAML load state.
+ * \param[in]  field  The field to get the value address for.
+ * \return Address to write the field's value to.
+ */
+static inline uint8_t * cyaml__field_value_data(
+		const cyaml_state_t *state,
+		const cyaml_schema_field_t *field)
+{
+	return state->data + cyaml_data_member_offset(field->data_offset,
+			cyaml_data_member_size(&field->value),
+			state->mapping.columns, state->mapping.column);
+}
+
+/**
+ * Get the address of a mapping field's sequence count in the client data.
+ *
+ * \param[in]  state  The mapping's CYAML load state.
+ * \param[in]  field  The \ref CYAML_SEQUENCE field to get the count address
+ *                    for.
+ * \return Address to write the field's sequence entry count to.
+ */
+static inline uint8_t * cyaml__field_count_data(
+		const cyaml_state_t *state,
+		const cyaml_schema_field_t *field)
+{
+	return state->data + cyaml_data_member_offset(field->count_offset,
+			field->count_size,
+			state->mapping.columns, state->mapping.column);
+}
+
 /**
  * Ensure that the CYAML load context has space for a new stack entry.
  *
@@ -1167,7 +1572,7 @@ static cyaml_err_t cyaml__stack_ensure(
 		cyaml_ctx_t *ctx)
 {
 	cyaml_state_t *temp;
-	uint32_t max = ctx->stack_max + 16;
+	uint32_t max = (ctx->stack_max == 0) ? 16 : ctx->stack_max * 2;
 
 	if (ctx->stack_idx < ctx->stack_max) {
 		return CYAML_OK;
@@ -1210,7 +1615,9 @@ static uint16_t cyaml__get_mapping_field_count(
  * Create \ref CYAML_STATE_IN_MAP_KEY state's bitfield array allocation.
  *
  * The bitfield is used to record whether the mapping as all the required
- * fields by mapping schema array index.
+ * fields by mapping schema array index.  Small bitfields are kept in the
+ * state itself, and larger ones are taken from the load context's bitfield
+ * pool, so most mappings need no allocation.
  *
  * \param[in]  ctx    The CYAML loading context.
  * \param[in]  state  CYAML load state for a \ref CYAML_STATE_IN_MAP_KEY state.
@@ -1220,36 +1627,76 @@ static cyaml_err_t cyaml__mapping_bitfieid_create(
 		cyaml_ctx_t *ctx,
 		cyaml_state_t *state)
 {
-	unsigned count = state->mapping.fields_count;
+	uint32_t count = (uint32_t)((state->mapping.fields_count +
+			CYAML_BITFIELD_BITS - 1) / CYAML_BITFIELD_BITS);
+
+	state->mapping.fields_set = ctx->bitfields_used;
+	if (count <= CYAML_BITFIELD_INLINE) {
+		memset(state->mapping.fields_inline, 0,
+				sizeof(state->mapping.fields_inline));
+		return CYAML_OK;
+	}
 
-	if (count != 0) {
-		cyaml_bitfield_t *bitfield;
-		size_t size = ((count + CYAML_BITFIELD_BITS - 1) /
-				CYAML_BITFIELD_BITS) * sizeof(*bitfield);
+	if (count > ctx->bitfields_max - ctx->bitfields_used) {
+		cyaml_bitfield_t *temp;
+		uint32_t max = ctx->bitfields_max * 2;
+
+		if (max < ctx->bitfields_used + count) {
+			max = ctx->bitfields_used + count + 16;
+		}
 
-		bitfield = cyaml__alloc(ctx->config, size, true);
-		if (bitfield == NULL) {
+		temp = cyaml__realloc(ctx->config, ctx->bitfields,
+				sizeof(*temp) * ctx->bitfields_max,
+				sizeof(*temp) * max, false);
+		if (temp == NULL) {
 			return CYAML_ERR_OOM;
 		}
 
-		state->mapping.fields_set = bitfield;
+		ctx->bitfields = temp;
+		ctx->bitfields_max = max;
 	}
 
+	memset(ctx->bitfields + ctx->bitfields_used, 0,
+			sizeof(*ctx->bitfields) * count);
+	ctx->bitfields_used += count;
+
 	return CYAML_OK;
 }
 
 /**
  * Destroy a \ref CYAML_STATE_IN_MAP_KEY state's bitfield array allocation.
  *
+ * Bitfields must be destroyed in the reverse order to their creation.
+ *
  * \param[in]  ctx    The CYAML loading context.
  * \param[in]  state  CYAML load state for a \ref CYAML_STATE_IN_MAP_KEY state.
  */
 static void cyaml__mapping_bitfieid_destroy(
+		cyaml_ctx_t *ctx,
+		const cyaml_state_t *state)
+{
+	assert(state->mapping.fields_set <= ctx->bitfields_used);
+
+	ctx->bitfields_used = state->mapping.fields_set;
+}
+
+/**
+ * Get a \ref CYAML_STATE_IN_MAP_KEY state's bitfield array.
+ *
+ * \param[in]  ctx    The CYAML loading context.
+ * \param[in]  state  CYAML load state for a \ref CYAML_STATE_IN_MAP_KEY state.
+ * \return the state's bitfield array.
+ */
+static inline cyaml_bitfield_t * cyaml__mapping_bitfieid(
 		const cyaml_ctx_t *ctx,
 		cyaml_state_t *state)
 {
-	cyaml__free(ctx->config, state->mapping.fields_set);
-	state->mapping.fields_set = NULL;
+	if (state->mapping.fields_count <=
+			CYAML_BITFIELD_INLINE * CYAML_BITFIELD_BITS) {
+		return state->mapping.fields_inline;
+	}
+
+	return ctx->bitfields + state->mapping.fields_set;
 }
 
 /**
@@ -1265,7 +1712,7 @@ static void cyaml__mapping_bitfieid_set(
 	cyaml_state_t *state = ctx->state;
 	unsigned idx = state->mapping.fields_idx;
 
-	state->mapping.fields_set[idx / CYAML_BITFIELD_BITS] |=
+	cyaml__mapping_bitfieid(ctx, state)[idx / CYAML_BITFIELD_BITS] |=
 			1u << (idx % CYAML_BITFIELD_BITS);
 }
 
@@ -1282,7 +1729,7 @@ static bool cyaml__mapping_bitfieid_check(
 	cyaml_state_t *state = ctx->state;
 	unsigned idx = state->mapping.fields_idx;
 
-	return state->mapping.fields_set[idx / CYAML_BITFIELD_BITS] &
+	return cyaml__mapping_bitfieid(ctx, state)[idx / CYAML_BITFIELD_BITS] &
 			(1u << (idx % CYAML_BITFIELD_BITS));
 }
 
@@ -1353,8 +1800,8 @@ static cyaml_err_t cyaml__field_scalar_apply_default(
 			break;
 		}
 
-		value_data = cyaml__realloc(ctx->config, value_data, 0,
-				size, true);
+		value_data = cyaml__data_realloc(ctx->config, ctx->arena,
+				value_data, 0, size, true);
 		if (value_data == NULL) {
 			return CYAML_ERR_OOM;
 		}
@@ -1416,6 +1863,11 @@ static cyaml_err_t cyaml__field_apply_default(
 	cyaml_err_t err;
 	bool ptr;
 
+	if (schema->flags & CYAML_FLAG_LAZY) {
+		/* Missing lazy values are left absent. */
+		return CYAML_OK;
+	}
+
 	switch (schema->type) {
 	case CYAML_INT:    /* Fall through */
 	case CYAML_UINT:   /* Fall through */
@@ -1451,7 +1903,7 @@ static cyaml_err_t cyaml__field_apply_default(
 	}
 
 	ptr = cyaml__flag_check_all(schema->flags, CYAML_FLAG_POINTER);
-	err = cyaml_copy(ctx->config, schema,
+	err = cyaml__copy(ctx->config, ctx->arena, schema,
 			schema_default,
 			(unsigned) seq_count,
 			ptr ? (cyaml_data_t **) data :
@@ -1467,7 +1919,7 @@ static cyaml_err_t cyaml__field_apply_default(
 	if (schema->type == CYAML_SEQUENCE) {
 		err = cyaml_data_write(seq_count,
 				field->count_size,
-				ctx->state->data + field->count_offset);
+				cyaml__field_count_data(ctx->state, field));
 		if (err != CYAML_OK) {
 			cyaml__log(ctx->config, CYAML_LOG_ERROR,
 				"Load: Failed writing sequence count\n");
@@ -1496,11 +1948,13 @@ static cyaml_err_t cyaml__mapping_bitfieid_validate(
 {
 	cyaml_state_t *state = ctx->state;
 	unsigned count = state->mapping.fields_count;
+	const cyaml_bitfield_t *fields_set =
+			cyaml__mapping_bitfieid(ctx, state);
 
 	for (unsigned i = 0; i < count; i++) {
 		const cyaml_schema_field_t *field = state->mapping.fields + i;
 
-		if (state->mapping.fields_set[i / CYAML_BITFIELD_BITS] &
+		if (fields_set[i / CYAML_BITFIELD_BITS] &
 				(1u << (i % CYAML_BITFIELD_BITS))) {
 			continue;
 		}
@@ -1511,7 +1965,7 @@ static cyaml_err_t cyaml__mapping_bitfieid_validate(
 					"Load: Using default value for: %s\n",
 					field->key);
 			err = cyaml__field_apply_default(ctx, field,
-					state->data + field->data_offset);
+					cyaml__field_value_data(state, field));
 			if (err != CYAML_OK) {
 				return err;
 			}
@@ -1539,6 +1993,61 @@ static inline bool cyaml__is_sequence(const cyaml_schema_value_t *schema)
 	        (schema->type == CYAML_SEQUENCE_FIXED));
 }
 
+/**
+ * Check whether a sequence's entries can be loaded in bulk.
+ *
+ * Sequences of non-pointer numbers without validation callbacks have runs of
+ * scalar entries loaded in a loop, without returning to the state machine for
+ * every entry.  The sequence entry count is written once, at the end of the
+ * sequence.
+ *
+ * \param[in]  schema  The schema for the sequence.
+ * \return true if the entries can be loaded in bulk, false otherwise.
+ */
+static inline bool cyaml__sequence_is_bulk(
+		const cyaml_schema_value_t *schema)
+{
+	const cyaml_schema_value_t *entry = schema->sequence.entry;
+
+	if (schema->type != CYAML_SEQUENCE ||
+	    !(schema->flags & CYAML_FLAG_POINTER) ||
+	    entry->flags & CYAML_FLAG_POINTER) {
+		return false;
+	}
+
+	switch (entry->type) {
+	case CYAML_INT:
+		return entry->integer.validation_cb == NULL;
+	case CYAML_UINT:
+		return entry->unsigned_integer.validation_cb == NULL;
+	case CYAML_FLOAT:
+		return entry->floating_point.validation_cb == NULL;
+	default:
+		return false;
+	}
+}
+
+/**
+ * Check a mapping and sequence nesting depth against the client's limit.
+ *
+ * \param[in]  ctx    The CYAML loading context.
+ * \param[in]  depth  The nesting depth to check.
+ * \return \ref CYAML_OK if the depth is allowed, or
+ *         \ref CYAML_ERR_LIMIT_DEPTH otherwise.
+ */
+static inline cyaml_err_t cyaml__check_depth(
+		const cyaml_ctx_t *ctx,
+		uint64_t depth)
+{
+	if (ctx->config->max_depth != 0 && depth > ctx->config->max_depth) {
+		cyaml__log(ctx->config, CYAML_LOG_ERROR,
+				"Load: Nesting depth limit exceeded\n");
+		return CYAML_ERR_LIMIT_DEPTH;
+	}
+
+	return CYAML_OK;
+}
+
 /**
  * Push a new entry onto the CYAML load context's stack.
  *
@@ -1571,9 +2080,19 @@ static cyaml_err_t cyaml__stack_push(
 	switch (state) {
 	case CYAML_STATE_IN_MAP_KEY:
 		assert(schema->type == CYAML_MAPPING);
+		err = cyaml__check_depth(ctx, (uint64_t)ctx->depth + 1);
+		if (err != CYAML_OK) {
+			return err;
+		}
 		s.mapping.fields = schema->mapping.fields;
-		s.mapping.fields_count = cyaml__get_mapping_field_count(
-				schema->mapping.fields);
+		s.mapping.compiled = cyaml__schema_mapping(ctx->config, schema);
+		if (s.mapping.compiled != NULL) {
+			s.mapping.fields_count =
+					s.mapping.compiled->fields_count;
+		} else {
+			s.mapping.fields_count = cyaml__get_mapping_field_count(
+					schema->mapping.fields);
+		}
 		err = cyaml__mapping_bitfieid_create(ctx, &s);
 		if (err != CYAML_OK) {
 			return err;
@@ -1581,6 +2100,16 @@ static cyaml_err_t cyaml__stack_push(
 		break;
 	case CYAML_STATE_IN_SEQUENCE:
 		assert(cyaml__is_sequence(schema));
+		err = cyaml__check_depth(ctx, (uint64_t)ctx->depth + 1);
+		if (err != CYAML_OK) {
+			return err;
+		}
+		if ((schema->flags & CYAML_FLAG_COLUMNAR) &&
+		    !cyaml_data_columnar_valid(schema)) {
+			cyaml__log(ctx->config, CYAML_LOG_ERROR,
+					"Load: Bad columnar sequence schema\n");
+			return CYAML_ERR_BAD_TYPE_IN_SCHEMA;
+		}
 		if (schema->type == CYAML_SEQUENCE_FIXED) {
 			if (schema->sequence.min != schema->sequence.max) {
 				return CYAML_ERR_SEQUENCE_FIXED_COUNT;
@@ -1593,14 +2122,26 @@ static cyaml_err_t cyaml__stack_push(
 					CYAML_STATE_IN_MAP_KEY) {
 				const cyaml_schema_field_t *field =
 						cyaml_mapping_schema_field(ctx);
-				s.sequence.count_data = ctx->state->data +
-						field->count_offset;
+				s.sequence.count_data = cyaml__field_count_data(
+						ctx->state, field);
 				s.sequence.count_size = field->count_size;
 			} else {
 				assert(ctx->state->state == CYAML_STATE_IN_DOC);
 				s.sequence.count_data = (void *)&ctx->seq_count;
 				s.sequence.count_size = sizeof(ctx->seq_count);
 			}
+			s.sequence.bulk = cyaml__sequence_is_bulk(schema);
+			if (s.sequence.bulk) {
+				/* Bulk loading only writes the count at the
+				 * end, so check the count can be written
+				 * before any entries are allocated. */
+				err = cyaml_data_write(0,
+						s.sequence.count_size,
+						s.sequence.count_data);
+				if (err != CYAML_OK) {
+					return err;
+				}
+			}
 		}
 		break;
 	default:
@@ -1620,6 +2161,13 @@ static cyaml_err_t cyaml__stack_push(
 	ctx->state = ctx->stack + ctx->stack_idx;
 	ctx->stack_idx++;
 
+	if (state == CYAML_STATE_IN_MAP_KEY ||
+	    state == CYAML_STATE_IN_SEQUENCE) {
+		ctx->depth++;
+	}
+
+	cyaml__stats_stack(ctx->config, ctx->stack_idx);
+
 	return CYAML_OK;
 }
 
@@ -1641,6 +2189,10 @@ static void cyaml__stack_pop(
 	case CYAML_STATE_IN_MAP_KEY: /* Fall through. */
 	case CYAML_STATE_IN_MAP_VALUE:
 		cyaml__mapping_bitfieid_destroy(ctx, ctx->state);
+		ctx->depth--;
+		break;
+	case CYAML_STATE_IN_SEQUENCE:
+		ctx->depth--;
 		break;
 	default:
 		break;
@@ -1704,10 +2256,186 @@ static cyaml_err_t cyaml__validate_event_type_for_schema(
 }
 
 /**
- * Helper to make allocations for loaded YAML values.
+ * Get the entry capacity to grow a \ref CYAML_SEQUENCE allocation to.
  *
- * If the current state is sequence, this extends any existing allocation
- * for the sequence.
+ * Capacity grows geometrically, so that loading a sequence doesn't need a
+ * reallocation for every entry, but it is never more than the schema allows.
+ *
+ * \param[in]  schema    The schema for the sequence.
+ * \param[in]  capacity  The sequence's current entry capacity.
+ * \return the new entry capacity.
+ */
+static inline uint32_t cyaml__sequence_grow_capacity(
+		const cyaml_schema_value_t *schema,
+		uint32_t capacity)
+{
+	uint32_t max = schema->sequence.max;
+
+	if (capacity == 0) {
+		return (max < 4) ? max : 4;
+	}
+
+	return (capacity > max / 2) ? max : capacity * 2;
+}
+
+/**
+ * A structure member of a \ref CYAML_FLAG_COLUMNAR sequence's entries.
+ *
+ * Each mapping field has a member for its value, and \ref CYAML_SEQUENCE
+ * fields also have a member for their entry count.
+ */
+typedef struct cyaml_column {
+	size_t offset; /**< Offset of the member in the structure. */
+	size_t size;   /**< Size of the member. */
+	uint32_t rank; /**< Non-zero position of the member in the schema. */
+} cyaml_column_t;
+
+/**
+ * Check whether a structure member comes before another in member order.
+ *
+ * \param[in]  a  A member.
+ * \param[in]  b  Another member.
+ * \return true if `a` is before `b`, false otherwise.
+ */
+static inline bool cyaml__column_before(
+		const cyaml_column_t *a,
+		const cyaml_column_t *b)
+{
+	return a->offset < b->offset ||
+			(a->offset == b->offset && a->rank < b->rank);
+}
+
+/**
+ * Consider a member as the next one after a previous member.
+ *
+ * \param[in]      prev       The previous member, or a member with zero rank
+ *                            to get the first.
+ * \param[in,out]  next       The next member found so far, or a member with
+ *                            zero rank.  Updated if `candidate` is nearer.
+ * \param[in]      candidate  The member to consider.
+ */
+static inline void cyaml__column_consider(
+		const cyaml_column_t *prev,
+		cyaml_column_t *next,
+		const cyaml_column_t *candidate)
+{
+	if (prev->rank != 0 && !cyaml__column_before(prev, candidate)) {
+		return;
+	}
+
+	if (next->rank == 0 || cyaml__column_before(candidate, next)) {
+		*next = *candidate;
+	}
+}
+
+/**
+ * Get the next structure member of a columnar mapping in member order.
+ *
+ * \param[in]      fields  The mapping's fields.
+ * \param[in,out]  column  The previous member, or a member with zero rank to
+ *                         get the first.  Updated to the next member.
+ * \return true if there was a next member, false otherwise.
+ */
+static bool cyaml__seq_columns_next(
+		const cyaml_schema_field_t *fields,
+		cyaml_column_t *column)
+{
+	cyaml_column_t next = {
+		.rank = 0,
+	};
+	uint32_t rank = 0;
+
+	for (const cyaml_schema_field_t *f = fields; f->key != NULL; f++) {
+		cyaml_column_t value = {
+			.offset = f->data_offset,
+			.size = cyaml_data_member_size(&f->value),
+			.rank = ++rank,
+		};
+		cyaml_column_t count = {
+			.offset = f->count_offset,
+			.size = f->count_size,
+			.rank = ++rank,
+		};
+
+		if (f->value.type != CYAML_IGNORE) {
+			cyaml__column_consider(column, &next, &value);
+		}
+		if (f->value.type == CYAML_SEQUENCE) {
+			cyaml__column_consider(column, &next, &count);
+		}
+	}
+
+	*column = next;
+	return next.rank != 0;
+}
+
+/**
+ * Grow the allocation for a \ref CYAML_FLAG_COLUMNAR sequence.
+ *
+ * Every column moves when the capacity changes, so rather than extending the
+ * existing allocation, the columns are copied into a new one.
+ *
+ * \param[in]      ctx            The CYAML loading context.
+ * \param[in]      schema         The schema for the sequence.
+ * \param[in,out]  value_data_io  Current address of sequence's data.  Updated
+ *                                to the address of the allocation.
+ * \return \ref CYAML_OK on success, or appropriate error code otherwise.
+ */
+static cyaml_err_t cyaml__seq_columns_grow(
+		cyaml_ctx_t *ctx,
+		const cyaml_schema_value_t *schema,
+		uint8_t **value_data_io)
+{
+	const cyaml_schema_field_t *fields = schema->sequence.entry->mapping.
+			fields;
+	cyaml_state_t *state = ctx->state;
+	cyaml_column_t column = {
+		.rank = 0,
+	};
+	uint8_t *value_data;
+	uint32_t capacity;
+
+	if (state->sequence.count < state->sequence.capacity) {
+		*value_data_io = state->sequence.data;
+		return CYAML_OK;
+	}
+
+	capacity = cyaml__sequence_grow_capacity(schema,
+			state->sequence.capacity);
+	value_data = cyaml__data_realloc(ctx->config, ctx->arena, NULL, 0,
+			(size_t)schema->data_size * capacity, true);
+	if (value_data == NULL) {
+		return CYAML_ERR_OOM;
+	}
+
+	if (state->sequence.data != NULL) {
+		while (cyaml__seq_columns_next(fields, &column)) {
+			memcpy(value_data + column.offset * capacity,
+				state->sequence.data + column.offset *
+						state->sequence.capacity,
+				column.size * state->sequence.count);
+		}
+		cyaml__data_free(ctx->config, ctx->arena,
+				state->sequence.data);
+	}
+
+	cyaml__log(ctx->config, CYAML_LOG_DEBUG,
+			"Load: Columnar allocation: %p (%u entries)\n",
+			value_data, capacity);
+
+	state->sequence.data = value_data;
+	state->sequence.capacity = capacity;
+
+	cyaml_data_write_pointer(value_data, *value_data_io);
+	*value_data_io = value_data;
+	return CYAML_OK;
+}
+
+/**
+ * Helper to make allocations for loaded YAML values.
+ *
+ * If the current state is sequence, this extends any existing allocation
+ * for the sequence, if it doesn't already have space for another entry.
  *
  * The current CYAML loading context's state is updated with new allocation
  * address, where necessary.
@@ -1728,10 +2456,15 @@ static cyaml_err_t cyaml__data_handle_pointer(
 {
 	cyaml_state_t *state = ctx->state;
 
+	if (schema->flags & CYAML_FLAG_COLUMNAR) {
+		return cyaml__seq_columns_grow(ctx, schema, value_data_io);
+	}
+
 	if (schema->flags & CYAML_FLAG_POINTER) {
 		/* Need to create/extend an allocation. */
 		size_t data_size = schema->data_size;
 		uint8_t *value_data = NULL;
+		uint32_t capacity = 0;
 		size_t offset = 0;
 		size_t delta;
 
@@ -1744,9 +2477,16 @@ static cyaml_err_t cyaml__data_handle_pointer(
 			break;
 		case CYAML_SEQUENCE:
 			/* Sequence; could be extending allocation. */
-			offset = data_size * state->sequence.count;
+			if (state->sequence.count < state->sequence.capacity) {
+				*value_data_io = state->sequence.data;
+				return CYAML_OK;
+			}
+			capacity = cyaml__sequence_grow_capacity(schema,
+					state->sequence.capacity);
+			offset = data_size * state->sequence.capacity;
 			value_data = state->sequence.data;
-			delta = data_size;
+			delta = data_size * (capacity -
+					state->sequence.capacity);
 			break;
 		case CYAML_SEQUENCE_FIXED:
 			/* Allocation is only made for full fixed size
@@ -1762,8 +2502,8 @@ static cyaml_err_t cyaml__data_handle_pointer(
 			break;
 		}
 
-		value_data = cyaml__realloc(ctx->config, value_data,
-				offset, offset + delta, true);
+		value_data = cyaml__data_realloc(ctx->config, ctx->arena,
+				value_data, offset, offset + delta, true);
 		if (value_data == NULL) {
 			return CYAML_ERR_OOM;
 		}
@@ -1776,6 +2516,7 @@ static cyaml_err_t cyaml__data_handle_pointer(
 			/* Updated the in sequence state so it knows the new
 			 * allocation address. */
 			state->sequence.data = value_data;
+			state->sequence.capacity = capacity;
 		}
 
 		/* Write the allocation pointer into the data structure. */
@@ -1857,20 +2598,16 @@ static cyaml_err_t cyaml__read_int(
 		const char *value,
 		uint8_t *data)
 {
-	long long temp;
-	char *end = NULL;
+	int64_t temp;
 
-	errno = 0;
-	temp = strtoll(value, &end, 0);
-
-	if (end == value || end == NULL || *end != '\0' || errno == ERANGE) {
+	if (cyaml__number_parse_int(value, &temp) != CYAML_NUMBER_OK) {
 		cyaml__log(ctx->config, CYAML_LOG_ERROR,
 				"Load: Invalid INT value: '%s'\n",
 				value);
 		return CYAML_ERR_INVALID_VALUE;
 	}
 
-	return cyaml__store_int(ctx, schema, data, (int64_t)temp, true);
+	return cyaml__store_int(ctx, schema, data, temp, true);
 }
 
 /**
@@ -1886,20 +2623,13 @@ static inline cyaml_err_t cyaml__read_uint64_t(
 		const char *value,
 		uint64_t *out)
 {
-	unsigned long long temp;
-	char *end = NULL;
-
-	errno = 0;
-	temp = strtoull(value, &end, 0);
-
-	if (end == value || end == NULL || *end != '\0' || errno == ERANGE) {
+	if (cyaml__number_parse_uint(value, out) != CYAML_NUMBER_OK) {
 		cyaml__log(ctx->config, CYAML_LOG_ERROR,
 				"Load: Invalid uint64_t value: '%s'\n",
 				value);
 		return CYAML_ERR_INVALID_VALUE;
 	}
 
-	*out = (uint64_t)temp;
 	return CYAML_OK;
 }
 
@@ -1959,6 +2689,42 @@ static cyaml_err_t cyaml__read_bool(
 	return cyaml__store_bool(ctx, schema, data, temp);
 }
 
+/**
+ * Get the index of the first \ref CYAML_ENUM or \ref CYAML_FLAGS string that
+ * matches a name.
+ *
+ * If the compiled schema covers the value, its names table is used.
+ * Otherwise the schema's strings are searched in order.
+ *
+ * \param[in]  ctx     The CYAML loading context.
+ * \param[in]  schema  The schema for the value to be read.
+ * \param[in]  value   String containing scaler value.
+ * \return index in the schema's strings array, or \ref CYAML_NAMES_IDX_NONE
+ *         if there is no string matching `value`.
+ */
+static uint32_t cyaml__get_strval_index(
+		const cyaml_ctx_t *ctx,
+		const cyaml_schema_value_t *schema,
+		const char *value)
+{
+	const cyaml_strval_t *strings = schema->enumeration.strings;
+	const cyaml_schema_names_t *names;
+
+	names = cyaml__schema_names(ctx->config, schema);
+	if (names != NULL) {
+		return cyaml__schema_names_name_idx(names, value);
+	}
+
+	for (uint32_t i = 0; i < schema->enumeration.count; i++) {
+		if (cyaml__strcmp(ctx->config, schema,
+				value, strings[i].str) == 0) {
+			return i;
+		}
+	}
+
+	return CYAML_NAMES_IDX_NONE;
+}
+
 /**
  * Read a value of type \ref CYAML_ENUM.
  *
@@ -1975,13 +2741,11 @@ static cyaml_err_t cyaml__read_enum(
 		uint8_t *data)
 {
 	const cyaml_strval_t *strings = schema->enumeration.strings;
+	uint32_t i = cyaml__get_strval_index(ctx, schema, value);
 
-	for (uint32_t i = 0; i < schema->enumeration.count; i++) {
-		if (cyaml__strcmp(ctx->config, schema,
-				value, strings[i].str) == 0) {
-			return cyaml__store_int(ctx, schema, data,
-					strings[i].val, true);
-		}
+	if (i != CYAML_NAMES_IDX_NONE) {
+		return cyaml__store_int(ctx, schema, data,
+				strings[i].val, true);
 	}
 
 	if (!cyaml__flag_check_all(schema->flags, CYAML_FLAG_STRICT)) {
@@ -2002,7 +2766,7 @@ static cyaml_err_t cyaml__read_enum(
 
 	cyaml__log(ctx->config, CYAML_LOG_NOTICE,
 			"Load:   Valid values are:\n");
-	for (uint32_t i = 0; i < schema->enumeration.count; i++) {
+	for (i = 0; i < schema->enumeration.count; i++) {
 		cyaml__log(ctx->config, CYAML_LOG_NOTICE,
 				"Load:   - `%s`\n", strings[i].str);
 	}
@@ -2031,18 +2795,17 @@ static cyaml_err_t cyaml__read_float(
 		const char *value,
 		uint8_t *data)
 {
+	cyaml_number_result_t result;
 	double temp;
-	char *end = NULL;
 
-	errno = 0;
-	temp = strtod(value, &end);
+	result = cyaml__number_parse_double(value, &temp);
 
-	if (end == value || end == NULL || *end != '\0') {
+	if (result == CYAML_NUMBER_INVALID) {
 		cyaml__log(ctx->config, CYAML_LOG_ERROR,
 				"Load: Invalid FLOAT value: %s\n", value);
 		return CYAML_ERR_INVALID_VALUE;
 
-	} else if (errno == ERANGE) {
+	} else if (result == CYAML_NUMBER_RANGE) {
 		cyaml_log_t level = CYAML_LOG_ERROR;
 
 		if (!cyaml__flag_check_all(schema->flags, CYAML_FLAG_STRICT)) {
@@ -2115,6 +2878,59 @@ static cyaml_err_t cyaml__read_scalar_value(
 	return fn[schema->type](ctx, schema, value, data);
 }
 
+/**
+ * Check whether loaded strings are being interned.
+ *
+ * \param[in]  ctx  The CYAML loading context.
+ * \return true if \ref CYAML_FLAG_POINTER strings are interned.
+ */
+static inline bool cyaml__interning(
+		const cyaml_ctx_t *ctx)
+{
+	return ctx->arena != NULL &&
+			(ctx->config->flags & CYAML_CFG_INTERN);
+}
+
+/**
+ * Read a \ref CYAML_STRING pointer value, sharing interned strings.
+ *
+ * \param[in]  ctx     The CYAML loading context.
+ * \param[in]  schema  The schema for the value to be read.
+ * \param[in]  data    The place to write the string pointer.
+ * \param[in]  event   The `libyaml` event providing the scalar value data.
+ * \return \ref CYAML_OK on success, or appropriate error code otherwise.
+ */
+static cyaml_err_t cyaml__read_string_interned(
+		cyaml_ctx_t *ctx,
+		const cyaml_schema_value_t *schema,
+		uint8_t *data,
+		const yaml_event_t *event)
+{
+	const char *value = (const char *)event->data.scalar.value;
+	size_t str_len = strlen(value);
+	const char *str;
+	cyaml_err_t err;
+
+	cyaml__log(ctx->config, CYAML_LOG_INFO, "Load:   <%s>\n", value);
+
+	err = cyaml__validate_string(ctx, schema, value, str_len);
+	if (err != CYAML_OK) {
+		return err;
+	}
+
+	err = cyaml__intern(ctx->config, ctx->arena, &ctx->intern,
+			value, str_len, &str);
+	if (err != CYAML_OK) {
+		return err;
+	}
+
+	cyaml__log(ctx->config, CYAML_LOG_DEBUG,
+			"Load: Interned string: %p\n", str);
+
+	cyaml_data_write_pointer(str, data);
+	return CYAML_OK;
+}
+
 /**
  * Set a flag in a \ref CYAML_FLAGS value.
  *
@@ -2131,25 +2947,19 @@ static cyaml_err_t cyaml__set_flag(
 		uint64_t *flags_out)
 {
 	const cyaml_strval_t *strings = schema->enumeration.strings;
+	uint32_t i = cyaml__get_strval_index(ctx, schema, value);
 
-	for (uint32_t i = 0; i < schema->enumeration.count; i++) {
-		if (cyaml__strcmp(ctx->config, schema,
-				value, strings[i].str) == 0) {
-			*flags_out |= ((uint64_t)strings[i].val);
-			return CYAML_OK;
-		}
+	if (i != CYAML_NAMES_IDX_NONE) {
+		*flags_out |= ((uint64_t)strings[i].val);
+		return CYAML_OK;
 	}
 
 	if (!(schema->flags & CYAML_FLAG_STRICT)) {
-		long long temp;
-		char *end = NULL;
+		int64_t temp;
 		uint64_t max = (~(uint64_t)0) >> ((8 - schema->data_size) * 8);
 
-		errno = 0;
-		temp = strtoll(value, &end, 0);
-
-		if (!(end == value || end == NULL || *end != '\0' ||
-		      errno == ERANGE || temp < 0 || (uint64_t)temp > max)) {
+		if (cyaml__number_parse_int(value, &temp) == CYAML_NUMBER_OK &&
+		    temp >= 0 && (uint64_t)temp <= max) {
 			*flags_out |= ((uint64_t)temp);
 			return CYAML_OK;
 		}
@@ -2238,15 +3048,31 @@ static cyaml_err_t cyaml__get_bitval_index(
 	const yaml_event_t *const event = cyaml__current_event(ctx);
 	const char *name = (const char *)event->data.scalar.value;
 	const cyaml_bitdef_t *bitdef = schema->bitfield.bitdefs;
+	const cyaml_schema_names_t *names;
 	uint32_t i;
 
-	for (i = 0; i < schema->bitfield.count; i++) {
-		if (bitdef[i].bits + bitdef[i].offset > schema->data_size * 8) {
+	names = cyaml__schema_names(ctx->config, schema);
+	if (names != NULL) {
+		/* Any bad bitdef before the match is reported, just as it
+		 * would be by the linear search. */
+		i = cyaml__schema_names_name_idx(names, name);
+		if (i == CYAML_NAMES_IDX_NONE) {
+			i = schema->bitfield.count;
+		}
+		if (names->bad_bitdef <= i &&
+		    names->bad_bitdef < schema->bitfield.count) {
 			return CYAML_ERR_BAD_BITVAL_IN_SCHEMA;
 		}
-		if (cyaml__strcmp(ctx->config, schema,
-				name, bitdef[i].name) == 0) {
-			break;
+	} else {
+		for (i = 0; i < schema->bitfield.count; i++) {
+			if (bitdef[i].bits + bitdef[i].offset >
+					schema->data_size * 8) {
+				return CYAML_ERR_BAD_BITVAL_IN_SCHEMA;
+			}
+			if (cyaml__strcmp(ctx->config, schema,
+					name, bitdef[i].name) == 0) {
+				break;
+			}
 		}
 	}
 
@@ -2395,12 +3221,17 @@ static cyaml_err_t cyaml__consume_ignored_value(
 {
 	if (cyaml_event != CYAML_EVT_SCALAR) {
 		unsigned level = 1;
+		cyaml_err_t err;
 
 		assert(cyaml_event == CYAML_EVT_SEQ_START ||
 		       cyaml_event == CYAML_EVT_MAP_START);
 
+		err = cyaml__check_depth(ctx, (uint64_t)ctx->depth + level);
+		if (err != CYAML_OK) {
+			return err;
+		}
+
 		while (level > 0) {
-			cyaml_err_t err;
 			const yaml_event_t *const event =
 					cyaml__current_event(ctx);
 
@@ -2412,6 +3243,11 @@ static cyaml_err_t cyaml__consume_ignored_value(
 			case CYAML_EVT_SEQ_START: /* Fall through */
 			case CYAML_EVT_MAP_START:
 				level++;
+				err = cyaml__check_depth(ctx,
+						(uint64_t)ctx->depth + level);
+				if (err != CYAML_OK) {
+					return err;
+				}
 				break;
 
 			case CYAML_EVT_SEQ_END: /* Fall through */
@@ -2500,6 +3336,12 @@ static cyaml_err_t cyaml__read_value(
 		return err;
 	}
 
+	if (schema->type == CYAML_STRING &&
+	    (schema->flags & CYAML_FLAG_POINTER) &&
+	    cyaml__interning(ctx)) {
+		return cyaml__read_string_interned(ctx, schema, data, event);
+	}
+
 	if (cyaml__is_sequence(schema) == false) {
 		/* Since sequences extend their allocation for each entry,
 		 * they're handled in the sequence-specific code.
@@ -2544,6 +3386,138 @@ static cyaml_err_t cyaml__read_value(
 	return err;
 }
 
+/**
+ * Get the byte offset into the parsed input of an event mark.
+ *
+ * The native scanner's mark indices are byte offsets, but `libyaml` counts
+ * characters, so the input is walked to find the offset.  Lazy values are
+ * found in input order, so the walk continues from the previous offset.
+ *
+ * \param[in]  ctx    The CYAML loading context.
+ * \param[in]  index  The mark index to get the offset for.
+ * \return the byte offset into the parsed input.
+ */
+static size_t cyaml__lazy_offset(
+		cyaml_ctx_t *ctx,
+		size_t index)
+{
+	const cyaml_lazy_t *origin = ctx->origin;
+	size_t end = origin->column + origin->len;
+
+	if (ctx->scan != NULL) {
+		return index;
+	}
+
+	while (ctx->lazy_index < index && ctx->lazy_offset < end) {
+		do {
+			ctx->lazy_offset++;
+		} while (ctx->lazy_offset < end &&
+		         ctx->lazy_offset >= origin->column &&
+		         (origin->input[ctx->lazy_offset - origin->column] &
+		          0xc0) == 0x80);
+		ctx->lazy_index++;
+	}
+
+	return ctx->lazy_offset;
+}
+
+/**
+ * Handle a YAML event corresponding to a \ref CYAML_FLAG_LAZY value.
+ *
+ * The value is consumed without being decoded, and its location in the
+ * client's input is stored in a \ref cyaml_lazy_t.
+ *
+ * \param[in]  ctx     The CYAML loading context.
+ * \param[in]  schema  CYAML schema for the expected value.
+ * \param[in]  data    Pointer to where the \ref cyaml_lazy_t should be
+ *                     written.
+ * \param[in]  event   The YAML event to handle.
+ * \return \ref CYAML_OK on success, or appropriate error code otherwise.
+ */
+static cyaml_err_t cyaml__read_lazy(
+		cyaml_ctx_t *ctx,
+		const cyaml_schema_value_t *schema,
+		uint8_t *data,
+		const yaml_event_t *event)
+{
+	cyaml_event_t cyaml_event = cyaml__get_event_type(event);
+	const cyaml_lazy_t *origin = ctx->origin;
+	size_t column = event->start_mark.column;
+	cyaml_lazy_t lazy;
+	cyaml_err_t err;
+	size_t start;
+	size_t end;
+
+	cyaml__log(ctx->config, CYAML_LOG_DEBUG,
+			"Load: Reading lazy value of type '%s'\n",
+			cyaml__type_to_str(schema->type));
+
+	if (!cyaml_data_lazy_valid(schema)) {
+		cyaml__log(ctx->config, CYAML_LOG_ERROR,
+				"Load: Bad lazy value schema\n");
+		return CYAML_ERR_BAD_TYPE_IN_SCHEMA;
+	}
+
+	if (cyaml_event == CYAML_EVT_SCALAR) {
+		if (cyaml__string_is_null_ptr(schema,
+				(const char *)event->data.scalar.value)) {
+			cyaml__log(ctx->config, CYAML_LOG_INFO,
+					"Load:   <NULL>\n");
+			return CYAML_OK;
+		}
+	}
+
+	err = cyaml__validate_event_type_for_schema(ctx, schema, event);
+	if (err != CYAML_OK) {
+		return err;
+	}
+
+	if (origin == NULL) {
+		cyaml__log(ctx->config, CYAML_LOG_ERROR,
+				"Load: Lazy values need data input\n");
+		return CYAML_ERR_LAZY_NO_INPUT;
+	}
+
+	if (ctx->event_ctx.replay.active) {
+		cyaml__log(ctx->config, CYAML_LOG_ERROR,
+				"Load: Lazy values can't be aliased\n");
+		return CYAML_ERR_ALIAS;
+	}
+
+	if (ctx->parser != NULL &&
+	    ctx->parser->encoding != YAML_UTF8_ENCODING) {
+		cyaml__log(ctx->config, CYAML_LOG_ERROR,
+				"Load: Lazy values need UTF-8 input\n");
+		return CYAML_ERR_INVALID_VALUE;
+	}
+
+	start = cyaml__lazy_offset(ctx, event->start_mark.index);
+
+	/* Note: `event` is the end of the value after this. */
+	err = cyaml__consume_ignored_value(ctx, cyaml_event);
+	if (err != CYAML_OK) {
+		return err;
+	}
+
+	end = cyaml__lazy_offset(ctx, event->end_mark.index);
+	if (start < origin->column || end < start ||
+	    end > origin->column + origin->len) {
+		return CYAML_ERR_INTERNAL_ERROR;
+	}
+
+	lazy = (cyaml_lazy_t) {
+		.input = origin->input + (start - origin->column),
+		.len = end - start,
+		.column = column,
+	};
+	memcpy(data, &lazy, sizeof(lazy));
+
+	cyaml__log(ctx->config, CYAML_LOG_INFO,
+			"Load:   <Lazy: %zu bytes>\n", lazy.len);
+
+	return CYAML_OK;
+}
+
 /**
  * YAML loading handler for start of stream in the \ref CYAML_STATE_START state.
  *
@@ -2572,7 +3546,7 @@ static cyaml_err_t cyaml__doc_start(
 		const yaml_event_t *event)
 {
 	CYAML_UNUSED(event);
-	if (ctx->state->stream.doc_count == 1) {
+	if (ctx->state->stream.doc_count == 1 && ctx->stream == NULL) {
 		cyaml__log(ctx->config, CYAML_LOG_WARNING,
 				"Ignoring documents after first in stream\n");
 		cyaml__stack_pop(ctx);
@@ -2615,17 +3589,63 @@ static cyaml_err_t cyaml__doc_root_value(
 }
 
 /**
- * YAML loading handler for finalising the \ref CYAML_STATE_IN_DOC state.
+ * Give a loaded document from a stream to the client.
  *
- * \param[in]  ctx    The CYAML loading context.
- * \param[in]  event  The YAML event to handle.
+ * The client owns the document's data once this is called, so the load
+ * context's references to it are cleared.
+ *
+ * \param[in]  ctx  The CYAML loading context.
  * \return \ref CYAML_OK on success, or appropriate error code otherwise.
  */
-static cyaml_err_t cyaml__doc_end(
-		cyaml_ctx_t *ctx,
+static cyaml_err_t cyaml__doc_give(
+		cyaml_ctx_t *ctx)
+{
+	cyaml_data_t **data = (cyaml_data_t **)(void *)ctx->state->data;
+	unsigned seq_count = ctx->seq_count;
+	cyaml_data_t *doc = *data;
+
+	if (ctx->arena != NULL) {
+		/* Start a new arena for the next document.  The interned
+		 * strings belong to the old one. */
+		cyaml__intern_reset(&ctx->intern);
+		if (doc != NULL) {
+			cyaml__arena_finalise(ctx->arena);
+			cyaml__arena_init(ctx->arena, ctx->arena->chunk_size);
+		} else {
+			cyaml__arena_destroy(ctx->config, ctx->arena);
+		}
+	}
+
+	*data = NULL;
+	ctx->seq_count = 0;
+
+	/* Anchors don't apply across documents. */
+	cyaml__reset_recording(ctx->config, &ctx->event_ctx.record);
+
+	cyaml__log(ctx->config, CYAML_LOG_DEBUG,
+			"Load: Stream document: %p\n", doc);
+
+	return ctx->stream->doc_fn(ctx->stream->doc_ctx, doc, seq_count);
+}
+
+/**
+ * YAML loading handler for finalising the \ref CYAML_STATE_IN_DOC state.
+ *
+ * \param[in]  ctx    The CYAML loading context.
+ * \param[in]  event  The YAML event to handle.
+ * \return \ref CYAML_OK on success, or appropriate error code otherwise.
+ */
+static cyaml_err_t cyaml__doc_end(
+		cyaml_ctx_t *ctx,
 		const yaml_event_t *event)
 {
 	CYAML_UNUSED(event);
+	if (ctx->stream != NULL) {
+		cyaml_err_t err = cyaml__doc_give(ctx);
+		if (err != CYAML_OK) {
+			return err;
+		}
+	}
 	cyaml__stack_pop(ctx);
 	return CYAML_OK;
 }
@@ -2644,6 +3664,10 @@ static inline void cyaml__log_ignored_key(
 			CYAML_LOG_WARNING : CYAML_LOG_DEBUG;
 
 	cyaml__log(ctx->config, lvl, "Load: Ignoring value for key: %s\n", key);
+
+	if (cyaml__stats(ctx->config) != NULL) {
+		cyaml__stats(ctx->config)->ignored_keys++;
+	}
 }
 
 /**
@@ -2692,7 +3716,7 @@ static cyaml_err_t cyaml__map_key(
 
 	key = (const char *)event->data.scalar.value;
 	ctx->state->mapping.fields_idx = cyaml__get_mapping_field_idx(
-			ctx->config, ctx->state->schema, key);
+			ctx->config, ctx->state, key);
 	cyaml__log(ctx->config, CYAML_LOG_INFO, "Load: [%s]\n", key);
 
 	if (ctx->state->mapping.fields_idx == CYAML_FIELDS_IDX_NONE) {
@@ -2776,7 +3800,7 @@ static cyaml_err_t cyaml__map_value(
 {
 	cyaml_state_t *state = ctx->state;
 	const cyaml_schema_field_t *field = cyaml_mapping_schema_field(ctx);
-	cyaml_data_t *data = state->data + field->data_offset;
+	cyaml_data_t *data = cyaml__field_value_data(state, field);
 
 	/* Toggle mapping sub-state back to key.  Do this before
 	 * reading value, because reading value might increase the
@@ -2787,9 +3811,105 @@ static cyaml_err_t cyaml__map_value(
 	ctx->state->line = event->start_mark.line;
 	ctx->state->column = event->start_mark.column;
 
+	if (field->value.flags & CYAML_FLAG_LAZY) {
+		return cyaml__read_lazy(ctx, &field->value, data, event);
+	}
+
 	return cyaml__read_value(ctx, &field->value, data, event);
 }
 
+/**
+ * YAML loading helper dispatch function.
+ *
+ * Dispatches events to the appropriate event handler function for the
+ * current combination of load state machine state (from the load context)
+ * and event type.
+ *
+ * \param[in]  ctx    The CYAML loading context.
+ * \param[in]  event  The YAML event to handle.
+ * \return \ref CYAML_OK on success, or appropriate error code otherwise.
+ */
+static inline cyaml_err_t cyaml__load_event(
+		cyaml_ctx_t *ctx,
+		const yaml_event_t *event);
+
+/**
+ * Load a run of scalar entries of a bulk sequence.
+ *
+ * Scalar events are read and stored in a loop until a non-scalar event,
+ * which is then handled as normal.
+ *
+ * \param[in]  ctx    The CYAML loading context.
+ * \param[in]  event  The first scalar event of the run.
+ * \return \ref CYAML_OK on success, or appropriate error code otherwise.
+ */
+static cyaml_err_t cyaml__seq_entry_bulk(
+		cyaml_ctx_t *ctx,
+		const yaml_event_t *event)
+{
+	cyaml_state_t *state = ctx->state;
+	const cyaml_schema_value_t *schema = state->schema;
+	const cyaml_schema_value_t *entry = schema->sequence.entry;
+	cyaml_err_t (*read_fn)(
+			const cyaml_ctx_t *ctx,
+			const cyaml_schema_value_t *schema,
+			const char *value,
+			uint8_t *data);
+	cyaml_err_t err;
+
+	switch (entry->type) {
+	case CYAML_INT:
+		read_fn = cyaml__read_int;
+		break;
+	case CYAML_UINT:
+		read_fn = cyaml__read_uint;
+		break;
+	case CYAML_FLOAT:
+		read_fn = cyaml__read_float;
+		break;
+	default:
+		return CYAML_ERR_INTERNAL_ERROR;
+	}
+
+	do {
+		uint8_t *value_data = state->data;
+
+		state->line = event->start_mark.line;
+		state->column = event->start_mark.column;
+
+		if (state->sequence.count + 1 > schema->sequence.max) {
+			cyaml__log(ctx->config, CYAML_LOG_ERROR,
+					"Load: Excessive entries "
+					"(%"PRIu32" max) in sequence.\n",
+					schema->sequence.max);
+			return CYAML_ERR_SEQUENCE_ENTRIES_MAX;
+		}
+
+		err = cyaml__data_handle_pointer(ctx, schema, event,
+				&value_data);
+		if (err != CYAML_OK) {
+			return err;
+		}
+
+		err = read_fn(ctx, entry,
+				(const char *)event->data.scalar.value,
+				value_data + schema->data_size *
+						state->sequence.count);
+		if (err != CYAML_OK) {
+			return err;
+		}
+		state->sequence.count++;
+
+		err = cyaml_get_next_event(ctx);
+		if (err != CYAML_OK) {
+			return err;
+		}
+		event = cyaml__current_event(ctx);
+	} while (event->type == YAML_SCALAR_EVENT);
+
+	return cyaml__load_event(ctx, event);
+}
+
 /**
  * YAML loading handler for new sequence entries in the
  * \ref CYAML_STATE_IN_SEQUENCE state.
@@ -2806,6 +3926,12 @@ static cyaml_err_t cyaml__seq_entry(
 	cyaml_state_t *state = ctx->state;
 	uint8_t *value_data = state->data;
 	const cyaml_schema_value_t *schema = state->schema;
+	bool columnar = schema->flags & CYAML_FLAG_COLUMNAR;
+	uint32_t column = state->sequence.count;
+
+	if (state->sequence.bulk && event->type == YAML_SCALAR_EVENT) {
+		return cyaml__seq_entry_bulk(ctx, event);
+	}
 
 	ctx->state->line = event->start_mark.line;
 	ctx->state->column = event->start_mark.column;
@@ -2826,7 +3952,9 @@ static cyaml_err_t cyaml__seq_entry(
 	cyaml__log(ctx->config, CYAML_LOG_DEBUG,
 			"Load: Sequence entry: %u (%"PRIu32" bytes)\n",
 			state->sequence.count, schema->data_size);
-	value_data += schema->data_size * state->sequence.count;
+	if (!columnar) {
+		value_data += schema->data_size * state->sequence.count;
+	}
 	state->sequence.count++;
 
 	if (schema->type != CYAML_SEQUENCE_FIXED) {
@@ -2840,7 +3968,8 @@ static cyaml_err_t cyaml__seq_entry(
 				cyaml__log(ctx->config, CYAML_LOG_DEBUG,
 						"Load: Freeing %p\n",
 						state->sequence.data);
-				cyaml__free(ctx->config, state->sequence.data);
+				cyaml__data_free(ctx->config, ctx->arena,
+						state->sequence.data);
 			}
 			return err;
 		}
@@ -2853,6 +3982,102 @@ static cyaml_err_t cyaml__seq_entry(
 		return err;
 	}
 
+	if (columnar) {
+		/* The entry's mapping state was pushed by reading the value,
+		 * and the sequence state may have moved. */
+		assert(ctx->state->state == CYAML_STATE_IN_MAP_KEY);
+		state = ctx->state - 1;
+		ctx->state->mapping.columns = state->sequence.capacity;
+		ctx->state->mapping.column = column;
+	}
+
+	return CYAML_OK;
+}
+
+/**
+ * Pack the columns of a \ref CYAML_FLAG_COLUMNAR sequence.
+ *
+ * While loading, each column has space for the sequence's capacity.  This
+ * moves the columns so that each has space for only the entry count, which
+ * is the layout clients expect.
+ *
+ * Columns are moved in member order, so no column is overwritten before it
+ * is moved.
+ *
+ * \param[in]  state  The sequence's CYAML load state.  Its capacity is
+ *                    updated to the entry count.
+ */
+static void cyaml__seq_columns_pack(
+		cyaml_state_t *state)
+{
+	const cyaml_schema_value_t *schema = state->schema;
+	const cyaml_schema_field_t *fields = schema->sequence.entry->mapping.
+			fields;
+	uint32_t count = state->sequence.count;
+	cyaml_column_t column = {
+		.rank = 0,
+	};
+
+	if (count == state->sequence.capacity) {
+		return;
+	}
+
+	while (cyaml__seq_columns_next(fields, &column)) {
+		memmove(state->sequence.data + column.offset * count,
+			state->sequence.data + column.offset *
+					state->sequence.capacity,
+			column.size * count);
+	}
+
+	state->sequence.capacity = count;
+}
+
+/**
+ * Trim any unused capacity from the current sequence's allocation.
+ *
+ * This does nothing if the client has set \ref CYAML_CFG_SEQUENCE_SLACK,
+ * except for packing the columns of \ref CYAML_FLAG_COLUMNAR sequences.
+ *
+ * \param[in]  ctx  The CYAML loading context.
+ * \return \ref CYAML_OK on success, or appropriate error code otherwise.
+ */
+static cyaml_err_t cyaml__seq_trim(
+		cyaml_ctx_t *ctx)
+{
+	cyaml_state_t *state = ctx->state;
+	const cyaml_schema_value_t *schema = state->schema;
+	uint32_t capacity = state->sequence.capacity;
+	uint8_t *value_data;
+
+	if (schema->type != CYAML_SEQUENCE ||
+	    !(schema->flags & CYAML_FLAG_POINTER) ||
+	    state->sequence.count == state->sequence.capacity) {
+		return CYAML_OK;
+	}
+
+	if (schema->flags & CYAML_FLAG_COLUMNAR) {
+		/* Columns must be packed, even if slack is kept. */
+		cyaml__seq_columns_pack(state);
+	}
+
+	if (ctx->config->flags & CYAML_CFG_SEQUENCE_SLACK) {
+		return CYAML_OK;
+	}
+
+	value_data = cyaml__data_realloc(ctx->config, ctx->arena,
+			state->sequence.data, schema->data_size * capacity,
+			schema->data_size * state->sequence.count, false);
+	if (value_data == NULL) {
+		return CYAML_ERR_OOM;
+	}
+
+	cyaml__log(ctx->config, CYAML_LOG_DEBUG,
+			"Load: Trimmed sequence allocation: %p (%u of %u)\n",
+			value_data, state->sequence.count, capacity);
+
+	state->sequence.data = value_data;
+	state->sequence.capacity = state->sequence.count;
+	cyaml_data_write_pointer(value_data, state->data);
 	return CYAML_OK;
 }
 
@@ -2869,6 +4094,7 @@ static cyaml_err_t cyaml__seq_end(
 {
 	const cyaml_state_t *state = ctx->state;
 	const cyaml_schema_value_t *schema = state->schema;
+	cyaml_err_t err;
 
 	CYAML_UNUSED(event);
 
@@ -2881,6 +4107,22 @@ static cyaml_err_t cyaml__seq_end(
 		return CYAML_ERR_SEQUENCE_ENTRIES_MIN;
 	}
 
+	if (state->sequence.bulk) {
+		err = cyaml_data_write(state->sequence.count,
+				state->sequence.count_size,
+				state->sequence.count_data);
+		if (err != CYAML_OK) {
+			cyaml__log(ctx->config, CYAML_LOG_ERROR,
+				"Load: Failed writing sequence count\n");
+			return err;
+		}
+	}
+
+	err = cyaml__seq_trim(ctx);
+	if (err != CYAML_OK) {
+		return err;
+	}
+
 	if (schema->sequence.validation_cb != NULL) {
 		if (!schema->sequence.validation_cb(
 				ctx->config->validation_ctx,
@@ -2896,6 +4138,27 @@ static cyaml_err_t cyaml__seq_end(
 	return CYAML_OK;
 }
 
+/**
+ * Pack the columns of any partially loaded \ref CYAML_FLAG_COLUMNAR sequences.
+ *
+ * This is used when a load fails, so that the partially loaded data has the
+ * layout \ref cyaml_free expects.
+ *
+ * \param[in]  ctx  The CYAML loading context.
+ */
+static void cyaml__seq_columns_pack_all(
+		const cyaml_ctx_t *ctx)
+{
+	for (uint32_t idx = 0; idx < ctx->stack_idx; idx++) {
+		cyaml_state_t *state = ctx->stack + idx;
+
+		if (state->state == CYAML_STATE_IN_SEQUENCE &&
+		    state->schema->flags & CYAML_FLAG_COLUMNAR) {
+			cyaml__seq_columns_pack(state);
+		}
+	}
+}
+
 /**
  * Check that common load parameters from client are valid.
  *
@@ -2933,16 +4196,37 @@ static inline cyaml_err_t cyaml__validate_load_params(
 }
 
 /**
- * YAML loading helper dispatch function.
+ * Check that stream load parameters from client are valid.
  *
- * Dispatches events to the appropriate event handler function for the
- * current combination of load state machine state (from the load context)
- * and event type.
- *
- * \param[in]  ctx    The CYAML loading context.
- * \param[in]  event  The YAML event to handle.
+ * \param[in] config  The client's CYAML library config.
+ * \param[in] schema  The schema describing the content of each document.
+ * \param[in] stream  The client's stream callback details.
  * \return \ref CYAML_OK on success, or appropriate error code otherwise.
  */
+static inline cyaml_err_t cyaml__validate_stream_params(
+		const cyaml_config_t *config,
+		const cyaml_schema_value_t *schema,
+		const cyaml_stream_t *stream)
+{
+	if (config == NULL) {
+		return CYAML_ERR_BAD_PARAM_NULL_CONFIG;
+	}
+	if (config->mem_fn == NULL) {
+		return CYAML_ERR_BAD_CONFIG_NULL_MEMFN;
+	}
+	if (schema == NULL) {
+		return CYAML_ERR_BAD_PARAM_NULL_SCHEMA;
+	}
+	if (!(schema->flags & CYAML_FLAG_POINTER)) {
+		return CYAML_ERR_TOP_LEVEL_NON_PTR;
+	}
+	if (stream->doc_fn == NULL) {
+		return CYAML_ERR_BAD_PARAM_NULL_CALLBACK;
+	}
+	return CYAML_OK;
+}
+
+/* This function is documented at the forward declaration above. */
 static inline cyaml_err_t cyaml__load_event(
 		cyaml_ctx_t *ctx,
 		const yaml_event_t *event)
@@ -2994,46 +4278,223 @@ static inline cyaml_err_t cyaml__load_event(
 	return err;
 }
 
+/**
+ * Take the retained allocations from a loader for a load context.
+ *
+ * \param[in]  ctx     The CYAML loading context.
+ * \param[in]  loader  The loader to take the allocations from.
+ */
+static void cyaml__loader_take(
+		cyaml_ctx_t *ctx,
+		cyaml_loader_t *loader)
+{
+	ctx->stack = loader->stack;
+	ctx->stack_max = loader->stack_max;
+	ctx->bitfields = loader->bitfields;
+	ctx->bitfields_max = loader->bitfields_max;
+	ctx->event_ctx.record = loader->record;
+	ctx->intern = loader->intern;
+
+	loader->stack = NULL;
+	loader->bitfields = NULL;
+	loader->intern = (cyaml_intern_t) { 0 };
+}
+
+/**
+ * Give the allocations from a finished load context back to a loader.
+ *
+ * \param[in]  ctx     The CYAML loading context.
+ * \param[in]  loader  The loader to give the allocations to.
+ */
+static void cyaml__loader_give(
+		cyaml_ctx_t *ctx,
+		cyaml_loader_t *loader)
+{
+	assert(ctx->stack_idx == 0);
+	assert(ctx->bitfields_used == 0);
+
+	cyaml__reset_recording(ctx->config, &ctx->event_ctx.record);
+	cyaml__intern_reset(&ctx->intern);
+
+	loader->stack = ctx->stack;
+	loader->stack_max = ctx->stack_max;
+	loader->bitfields = ctx->bitfields;
+	loader->bitfields_max = ctx->bitfields_max;
+	loader->record = ctx->event_ctx.record;
+	loader->intern = ctx->intern;
+}
+
+/**
+ * Handle a YAML event, calling the client's trace callback around it.
+ *
+ * \param[in]  ctx    The CYAML loading context.
+ * \param[in]  event  The YAML event to handle.
+ * \return \ref CYAML_OK on success, or appropriate error code otherwise.
+ */
+static cyaml_err_t cyaml__load_event_traced(
+		cyaml_ctx_t *ctx,
+		const yaml_event_t *event)
+{
+	const cyaml_config_t *config = ctx->config;
+	cyaml_event_type_t type = (cyaml_event_type_t)event->type;
+	cyaml_err_t err;
+
+	config->trace_fn(CYAML_TRACE_EVENT_BEGIN, config->trace_ctx, type);
+	err = cyaml__load_event(ctx, event);
+	config->trace_fn(CYAML_TRACE_EVENT_END, config->trace_ctx, type);
+
+	return err;
+}
+
+/**
+ * Allocation accounting for loads with a memory limit.
+ */
+typedef struct cyaml_mem_limit {
+	const cyaml_config_t *config; /**< Client's config. */
+	uint64_t used;                /**< Bytes requested so far. */
+	bool exceeded;                /**< Whether a request was refused. */
+} cyaml_mem_limit_t;
+
+/**
+ * Check whether a load has any of the client's resource limits set.
+ *
+ * \param[in]  config  Client's CYAML configuration structure.
+ * \return true if any limit is set, false otherwise.
+ */
+static inline bool cyaml__load_limited(
+		const cyaml_config_t *config)
+{
+	return config->max_alias_events != 0 ||
+			config->max_alloc_bytes != 0 ||
+			config->max_depth != 0 ||
+			config->max_input_size != 0;
+}
+
+/**
+ * Memory allocation function for loads with a memory limit.
+ *
+ * This counts the requested bytes, and passes requests that fit in the
+ * limit on to the client's allocator.
+ *
+ * \param[in]  ctx   The \ref cyaml_mem_limit_t for the load.
+ * \param[in]  ptr   Existing allocation to resize, or NULL.
+ * \param[in]  size  New size for allocation, or zero to free.
+ * \return new allocation, or NULL on failure or if `size` is zero.
+ */
+static void * cyaml__mem_limited(
+		void *ctx,
+		void *ptr,
+		size_t size)
+{
+	cyaml_mem_limit_t *limit = ctx;
+	const cyaml_config_t *config = limit->config;
+
+	if (size != 0) {
+		if (size > config->max_alloc_bytes - limit->used) {
+			limit->exceeded = true;
+			return NULL;
+		}
+		limit->used += size;
+	}
+
+	return config->mem_fn(config->mem_ctx, ptr, size);
+}
+
 /**
  * The main YAML loading function.
  *
  * The public interfaces are wrappers around this.
  *
  * \param[in]  config         Client's CYAML configuration structure.
+ * \param[in]  loader         Loader to reuse allocations from, or NULL.
+ * \param[in]  stream         Stream callback to give each document to, or
+ *                            NULL to load a single document.
  * \param[in]  schema         CYAML schema for the YAML to be loaded.
  * \param[out] data_out       Returns the caller-owned loaded data on success.
- *                            Untouched on failure.
+ *                            Untouched on failure.  Unused for streams.
  * \param[out] seq_count_out  On success, returns the sequence entry count.
  *                            Untouched on failure.
  *                            Must be non-NULL if top-level schema type is
  *                            \ref CYAML_SEQUENCE, otherwise, must be NULL.
+ *                            Unused for streams.
  * \param[in]  parser         An initialised `libyaml` parser object
- *                            with its input set.
+ *                            with its input set, or NULL.
+ * \param[in]  scan           A native scanner to use if `parser` is NULL.
+ * \param[in]  origin         The client's input being parsed, for lazy
+ *                            values, or NULL if it isn't retained.
  * \return \ref CYAML_OK on success, or appropriate error code otherwise.
  */
 static cyaml_err_t cyaml__load(
 		const cyaml_config_t *config,
+		cyaml_loader_t *loader,
+		const cyaml_stream_t *stream,
 		const cyaml_schema_value_t *schema,
 		cyaml_data_t **data_out,
 		unsigned *seq_count_out,
-		yaml_parser_t *parser)
+		yaml_parser_t *parser,
+		cyaml_scan_t *scan,
+		const cyaml_lazy_t *origin)
 {
 	cyaml_data_t *data = NULL;
+	cyaml_config_t limited_config;
+	cyaml_mem_limit_t mem_limit = {
+		.config = config,
+	};
+	cyaml_arena_t arena;
 	cyaml_ctx_t ctx = {
 		.config = config,
+		.stream = stream,
 		.parser = parser,
+		.scan = scan,
+		.origin = origin,
 	};
 	cyaml_err_t err = CYAML_OK;
+	uint64_t start = 0;
 
-	err = cyaml__validate_load_params(config, schema,
-			data_out, seq_count_out);
+	/* The `libyaml` mark indices don't count a byte order mark. */
+	if (origin != NULL && origin->column == 0 && origin->len >= 3 &&
+	    memcmp(origin->input, "\xef\xbb\xbf", 3) == 0) {
+		ctx.lazy_offset = 3;
+	}
+
+	if (stream != NULL) {
+		err = cyaml__validate_stream_params(config, schema, stream);
+	} else {
+		err = cyaml__validate_load_params(config, schema,
+				data_out, seq_count_out);
+	}
 	if (err != CYAML_OK) {
 		return err;
 	}
 
-	err = cyaml__stack_push(&ctx, CYAML_STATE_START, NULL, schema, &data);
-	if (err != CYAML_OK) {
-		goto out;
+	/* Everything allocated for the load goes through the limited
+	 * allocator, which passes the client's allocations through to the
+	 * client's allocator, so they can be freed with the client's config
+	 * as normal. */
+	if (config->max_alloc_bytes != 0) {
+		limited_config = *config;
+		limited_config.mem_fn = cyaml__mem_limited;
+		limited_config.mem_ctx = &mem_limit;
+		config = &limited_config;
+		ctx.config = config;
+	}
+
+	if (cyaml__stats(config) != NULL) {
+		start = cyaml__stats_now();
+	}
+
+	if (loader != NULL) {
+		cyaml__loader_take(&ctx, loader);
+	}
+
+	if (config->flags & CYAML_CFG_ARENA) {
+		cyaml__arena_init(&arena, config->arena_chunk_size);
+		ctx.arena = &arena;
+	}
+
+	err = cyaml__stack_push(&ctx, CYAML_STATE_START, NULL, schema, &data);
+	if (err != CYAML_OK) {
+		goto out;
 	}
 
 	do {
@@ -3044,7 +4505,11 @@ static cyaml_err_t cyaml__load(
 			goto out;
 		}
 
-		err = cyaml__load_event(&ctx, event);
+		if (config->trace_fn != NULL) {
+			err = cyaml__load_event_traced(&ctx, event);
+		} else {
+			err = cyaml__load_event(&ctx, event);
+		}
 		if (err != CYAML_OK) {
 			goto out;
 		}
@@ -3054,28 +4519,578 @@ static cyaml_err_t cyaml__load(
 
 	assert(ctx.stack_idx == 0);
 
-	*data_out = data;
+	if (ctx.arena != NULL) {
+		if (data != NULL) {
+			assert(data == arena.root);
+			cyaml__arena_finalise(&arena);
+		} else {
+			cyaml__arena_destroy(config, &arena);
+		}
+	}
+
+	if (data_out != NULL) {
+		*data_out = data;
+	}
 	if (seq_count_out != NULL) {
 		*seq_count_out = ctx.seq_count;
 	}
 out:
 	if (err != CYAML_OK) {
-		cyaml_free(config, schema, data, ctx.seq_count);
+		if (mem_limit.exceeded) {
+			cyaml__log(config, CYAML_LOG_ERROR,
+					"Load: Memory limit exceeded\n");
+			err = CYAML_ERR_LIMIT_MEMORY;
+		}
+		if (ctx.arena != NULL) {
+			cyaml__arena_destroy(config, &arena);
+		} else {
+			cyaml__seq_columns_pack_all(&ctx);
+			cyaml_free(config, schema, data, ctx.seq_count);
+		}
 		cyaml__backtrace(&ctx);
 	}
 	while (ctx.stack_idx > 0) {
 		cyaml__stack_pop(&ctx);
 	}
-	cyaml__free(config, ctx.stack);
 	cyaml__delete_yaml_event(&ctx);
-	cyaml__free_recording(&ctx);
+	if (loader != NULL) {
+		cyaml__loader_give(&ctx, loader);
+	} else {
+		cyaml__free(config, ctx.stack);
+		cyaml__free(config, ctx.bitfields);
+		cyaml__free_recording(config, &ctx.event_ctx.record);
+		cyaml__intern_free(config, &ctx.intern);
+	}
+	if (cyaml__stats(config) != NULL) {
+		cyaml__stats(config)->total_ns += cyaml__stats_now() - start;
+	}
 	return err;
 }
 
-/* Exported function, documented in include/cyaml/cyaml.h */
-cyaml_err_t cyaml_load_file(
+/**
+ * Parse a YAML document from a data buffer.
+ *
+ * \param[in]  config         Client's CYAML configuration structure.
+ * \param[in]  loader         Loader to reuse allocations from, or NULL.
+ * \param[in]  stream         Stream callback to give each document to, or
+ *                            NULL to load a single document.
+ * \param[in]  input          Buffer to load YAML data from.
+ * \param[in]  input_len      Length of input in bytes.
+ * \param[in]  origin         The client's input that `input` holds, for
+ *                            lazy values, or NULL if it isn't retained.
+ * \param[in]  schema         CYAML schema for the YAML to be loaded.
+ * \param[out] data_out       Returns the caller-owned loaded data on success.
+ *                            Untouched on failure.
+ * \param[out] seq_count_out  On success, returns the sequence entry count.
+ *                            Untouched on failure.
+ * \return \ref CYAML_OK on success, or appropriate error code otherwise.
+ */
+static cyaml_err_t cyaml__load_string(
+		const cyaml_config_t *config,
+		cyaml_loader_t *loader,
+		const cyaml_stream_t *stream,
+		const uint8_t *input,
+		size_t input_len,
+		const cyaml_lazy_t *origin,
+		const cyaml_schema_value_t *schema,
+		cyaml_data_t **data_out,
+		unsigned *seq_count_out)
+{
+	cyaml_err_t err;
+	yaml_parser_t parser;
+
+	/* The input's size is known, so there's no need to parse any of it
+	 * to find that it's too big. */
+	if (config != NULL && config->max_input_size != 0 &&
+	    input_len > config->max_input_size) {
+		cyaml__log(config, CYAML_LOG_ERROR,
+				"Load: Input size limit exceeded\n");
+		return CYAML_ERR_LIMIT_INPUT_SIZE;
+	}
+
+	if (config != NULL && config->mem_fn != NULL && stream == NULL &&
+	    (config->flags & CYAML_CFG_NATIVE_SCANNER)) {
+		cyaml_scan_result_t res;
+		cyaml_scan_t scan;
+
+		/* The whole input is checked first, so that the native
+		 * scanner never has to give up part way through a load. */
+		cyaml__scan_init(&scan, config, input, input_len);
+		res = cyaml__scan_check(&scan);
+		if (res == CYAML_SCAN_OK) {
+			err = cyaml__load(config, loader, stream, schema,
+					data_out, seq_count_out, NULL, &scan,
+					origin);
+			cyaml__scan_fini(&scan);
+			return err;
+		}
+		cyaml__scan_fini(&scan);
+		if (res == CYAML_SCAN_OOM) {
+			return CYAML_ERR_OOM;
+		}
+		cyaml__log(config, CYAML_LOG_DEBUG, "Load: Native scanner "
+				"unsupported input; using libyaml\n");
+	}
+
+	/* Initialize parser */
+	if (!yaml_parser_initialize(&parser)) {
+		return CYAML_ERR_LIBYAML_PARSER_INIT;
+	}
+
+	/* Set input data */
+	yaml_parser_set_input_string(&parser, input, input_len);
+
+	/* Parse the input */
+	err = cyaml__load(config, loader, stream, schema,
+			data_out, seq_count_out, &parser, NULL, origin);
+	if (err != CYAML_OK) {
+		yaml_parser_delete(&parser);
+		return err;
+	}
+
+	/* Cleanup */
+	yaml_parser_delete(&parser);
+
+	return CYAML_OK;
+}
+
+/** Minimum number of input bytes for each chunk of a parallel load. */
+#define CYAML_PARALLEL_CHUNK_MIN (64 * 1024)
+
+/** A chunk of a parallel load. */
+typedef struct cyaml_parallel_job {
+	const cyaml_config_t *config;         /**< Config for chunk load. */
+	cyaml_config_t chunk_config;          /**< Storage for `config`. */
+	cyaml_stats_t stats;                  /**< Chunk load statistics. */
+	const cyaml_schema_value_t *schema;   /**< Schema for chunk load. */
+	const uint8_t *input;  /**< Start of chunk in client's input. */
+	size_t input_len;      /**< Length of chunk in bytes. */
+	bool retained;         /**< Whether the client retains the input. */
+	cyaml_data_t *data;    /**< Loaded chunk sequence, or NULL. */
+	unsigned seq_count;    /**< Loaded chunk sequence entry count. */
+	cyaml_err_t err;       /**< Result of chunk load. */
+} cyaml_parallel_job_t;
+
+/**
+ * Load a chunk of a parallel load.
+ *
+ * \param[in]  job  The \ref cyaml_parallel_job_t to load.
+ */
+static void cyaml__load_parallel_job(void *job)
+{
+	cyaml_parallel_job_t *chunk = job;
+	const cyaml_lazy_t origin = {
+		.input = chunk->input,
+		.len = chunk->input_len,
+	};
+
+	chunk->err = cyaml__load_string(chunk->config, NULL, NULL,
+			chunk->input, chunk->input_len,
+			chunk->retained ? &origin : NULL, chunk->schema,
+			&chunk->data, &chunk->seq_count);
+}
+
+/**
+ * Check whether a load may be split across threads.
+ *
+ * \param[in]  config         Client's CYAML configuration structure.
+ * \param[in]  loader         Loader to reuse allocations from, or NULL.
+ * \param[in]  stream         Stream callback details, or NULL.
+ * \param[in]  schema         CYAML schema for the YAML to be loaded.
+ * \param[in]  data_out       Client's address to write data to.
+ * \param[in]  seq_count_out  Client's address to write sequence count to.
+ * \return true if the load may be split, false otherwise.
+ */
+static bool cyaml__load_parallel_allowed(
+		const cyaml_config_t *config,
+		const cyaml_loader_t *loader,
+		const cyaml_stream_t *stream,
+		const cyaml_schema_value_t *schema,
+		cyaml_data_t * const *data_out,
+		const unsigned *seq_count_out)
+{
+	return loader == NULL && stream == NULL &&
+			config != NULL && config->mem_fn != NULL &&
+			(config->flags & CYAML_CFG_PARALLEL) &&
+			!(config->flags & CYAML_CFG_ARENA) &&
+			config->trace_fn == NULL &&
+			!cyaml__load_limited(config) &&
+			schema != NULL &&
+			schema->type == CYAML_SEQUENCE &&
+			(schema->flags & CYAML_FLAG_POINTER) &&
+			!(schema->flags & CYAML_FLAG_COLUMNAR) &&
+			!cyaml__schema_has_validation(config, schema) &&
+			data_out != NULL && seq_count_out != NULL;
+}
+
+/**
+ * Free the loaded chunks of a parallel load.
+ *
+ * \param[in]  config  Client's CYAML configuration structure.
+ * \param[in]  jobs    The chunks.
+ * \param[in]  count   Number of chunks.
+ */
+static void cyaml__load_parallel_free(
+		const cyaml_config_t *config,
+		const cyaml_parallel_job_t *jobs,
+		unsigned count)
+{
+	for (unsigned i = 0; i < count; i++) {
+		if (jobs[i].err == CYAML_OK) {
+			cyaml_free(config, jobs[i].schema,
+					jobs[i].data, jobs[i].seq_count);
+		}
+	}
+}
+
+/**
+ * Join the loaded chunks of a parallel load into one sequence.
+ *
+ * The first chunk's sequence allocation is grown to fit every entry, and
+ * the other chunks' entries are moved into it.
+ *
+ * \param[in]  config         Client's CYAML configuration structure.
+ * \param[in]  schema         CYAML schema for the YAML to be loaded.
+ * \param[in]  jobs           The loaded chunks.
+ * \param[in]  count          Number of chunks.
+ * \param[out] data_out       Returns the caller-owned loaded data on success.
+ *                            Untouched on failure.
+ * \param[out] seq_count_out  On success, returns the sequence entry count.
+ *                            Untouched on failure.
+ * \return \ref CYAML_OK on success, or appropriate error code otherwise.
+ */
+static cyaml_err_t cyaml__load_parallel_join(
+		const cyaml_config_t *config,
+		const cyaml_schema_value_t *schema,
+		cyaml_parallel_job_t *jobs,
+		unsigned count,
+		cyaml_data_t **data_out,
+		unsigned *seq_count_out)
+{
+	size_t size = schema->sequence.entry->data_size;
+	uint8_t *data = jobs[0].data;
+	size_t total = jobs[0].seq_count;
+	cyaml_stats_t *stats;
+
+	for (unsigned i = 1; i < count; i++) {
+		total += jobs[i].seq_count;
+	}
+
+	data = cyaml__realloc(config, data, size * jobs[0].seq_count,
+			size * total, false);
+	if (data == NULL) {
+		return CYAML_ERR_OOM;
+	}
+	jobs[0].data = data;
+
+	data += size * jobs[0].seq_count;
+	for (unsigned i = 1; i < count; i++) {
+		memcpy(data, jobs[i].data, size * jobs[i].seq_count);
+		data += size * jobs[i].seq_count;
+		cyaml__free(config, jobs[i].data);
+	}
+
+	cyaml__log(config, CYAML_LOG_DEBUG,
+			"Load: Parallel: Joined %u chunks (%zu entries)\n",
+			count, total);
+
+	stats = cyaml__stats(config);
+	if (stats != NULL) {
+		stats->parallel_chunks += count;
+	}
+
+	*data_out = jobs[0].data;
+	*seq_count_out = (unsigned)total;
+	return CYAML_OK;
+}
+
+/**
+ * Try to load a YAML document with a top level sequence across threads.
+ *
+ * The input is split into chunks of top level sequence entries, which are
+ * each loaded as a document of their own.  If any chunk fails to load, for
+ * example because an alias refers to an anchor in another chunk, or if the
+ * split was inside a multi-line scalar, the load is not done, so that the
+ * caller can load the whole document serially.  The serial load gives the
+ * client the right error if the document is actually invalid.
+ *
+ * \param[in]  config         Client's CYAML configuration structure.
+ * \param[in]  input          Buffer to load YAML data from.
+ * \param[in]  input_len      Length of input in bytes.
+ * \param[in]  retained       Whether the client retains the input.
+ * \param[in]  schema         CYAML schema for the YAML to be loaded.
+ * \param[out] data_out       Returns the caller-owned loaded data on success.
+ *                            Untouched on failure.
+ * \param[out] seq_count_out  On success, returns the sequence entry count.
+ *                            Untouched on failure.
+ * \param[out] loaded         Returns false if the document was not loaded,
+ *                            in which case it should be loaded serially.
+ * \return \ref CYAML_OK on success, or appropriate error code otherwise.
+ */
+static cyaml_err_t cyaml__load_parallel(
+		const cyaml_config_t *config,
+		const uint8_t *input,
+		size_t input_len,
+		bool retained,
+		const cyaml_schema_value_t *schema,
+		cyaml_data_t **data_out,
+		unsigned *seq_count_out,
+		bool *loaded)
+{
+	cyaml_parallel_job_t jobs[CYAML_PARALLEL_CHUNKS_MAX];
+	size_t offsets[CYAML_PARALLEL_CHUNKS_MAX];
+	cyaml_schema_value_t chunk_schema = *schema;
+	cyaml_config_t chunk_config = *config;
+	size_t size = schema->sequence.entry->data_size;
+	unsigned chunks_max;
+	uint64_t total = 0;
+	unsigned count;
+	cyaml_err_t err;
+
+	*loaded = false;
+
+	chunks_max = cyaml__parallel_threads(config);
+	if (chunks_max > input_len / CYAML_PARALLEL_CHUNK_MIN) {
+		chunks_max = (unsigned)(input_len / CYAML_PARALLEL_CHUNK_MIN);
+	}
+	if (chunks_max > CYAML_PARALLEL_CHUNKS_MAX) {
+		chunks_max = CYAML_PARALLEL_CHUNKS_MAX;
+	}
+
+	count = cyaml__parallel_split(input, input_len, chunks_max, offsets);
+	if (count < 2) {
+		return CYAML_OK;
+	}
+
+	/* Entry count limits are checked once the chunks are joined. */
+	chunk_config.flags &= ~(cyaml_cfg_flags_t)CYAML_CFG_PARALLEL;
+	chunk_config.log_fn = NULL;
+	chunk_schema.sequence.min = 0;
+	chunk_schema.sequence.max = CYAML_UNLIMITED;
+
+	for (unsigned i = 0; i < count; i++) {
+		size_t end = (i + 1 < count) ? offsets[i + 1] : input_len;
+
+		jobs[i] = (cyaml_parallel_job_t) {
+			.chunk_config = chunk_config,
+			.schema = &chunk_schema,
+			.input = input + offsets[i],
+			.input_len = end - offsets[i],
+			.retained = retained,
+		};
+		jobs[i].config = &jobs[i].chunk_config;
+
+		/* Each chunk has its own statistics, to avoid sharing them
+		 * between threads. */
+		if (cyaml__stats(config) != NULL) {
+			jobs[i].chunk_config.stats = &jobs[i].stats;
+		}
+	}
+
+	cyaml__log(config, CYAML_LOG_DEBUG,
+			"Load: Parallel: Loading %u chunks\n", count);
+
+	cyaml__parallel_run(cyaml__load_parallel_job,
+			jobs, sizeof(*jobs), count);
+
+	if (cyaml__stats(config) != NULL) {
+		for (unsigned i = 0; i < count; i++) {
+			cyaml__stats_add(cyaml__stats(config), &jobs[i].stats);
+		}
+	}
+
+	for (unsigned i = 0; i < count; i++) {
+		if (jobs[i].err != CYAML_OK) {
+			cyaml__log(config, CYAML_LOG_DEBUG,
+					"Load: Parallel: Chunk %u failed: %s\n",
+					i, cyaml_strerror(jobs[i].err));
+			cyaml__load_parallel_free(config, jobs, count);
+			return CYAML_OK;
+		}
+		total += jobs[i].seq_count;
+	}
+
+	if (total < schema->sequence.min ||
+	    total > schema->sequence.max ||
+	    total > SIZE_MAX / size) {
+		cyaml__load_parallel_free(config, jobs, count);
+		return CYAML_OK;
+	}
+
+	err = cyaml__load_parallel_join(config, schema, jobs, count,
+			data_out, seq_count_out);
+	if (err != CYAML_OK) {
+		cyaml__load_parallel_free(config, jobs, count);
+		return err;
+	}
+
+	*loaded = true;
+	return CYAML_OK;
+}
+
+/**
+ * Load a YAML document from a data buffer.
+ *
+ * \param[in]  config         Client's CYAML configuration structure.
+ * \param[in]  loader         Loader to reuse allocations from, or NULL.
+ * \param[in]  stream         Stream callback to give each document to, or
+ *                            NULL to load a single document.
+ * \param[in]  input          Buffer to load YAML data from.
+ * \param[in]  input_len      Length of input in bytes.
+ * \param[in]  retained       Whether the client retains the input, so
+ *                            that it can hold lazy values.
+ * \param[in]  schema         CYAML schema for the YAML to be loaded.
+ * \param[out] data_out       Returns the caller-owned loaded data on success.
+ *                            Untouched on failure.
+ * \param[out] seq_count_out  On success, returns the sequence entry count.
+ *                            Untouched on failure.
+ * \return \ref CYAML_OK on success, or appropriate error code otherwise.
+ */
+static cyaml_err_t cyaml__load_data(
+		const cyaml_config_t *config,
+		cyaml_loader_t *loader,
+		const cyaml_stream_t *stream,
+		const uint8_t *input,
+		size_t input_len,
+		bool retained,
+		const cyaml_schema_value_t *schema,
+		cyaml_data_t **data_out,
+		unsigned *seq_count_out)
+{
+	const cyaml_lazy_t origin = {
+		.input = input,
+		.len = input_len,
+	};
+
+	if (cyaml__load_parallel_allowed(config, loader, stream, schema,
+			data_out, seq_count_out)) {
+		bool loaded;
+		cyaml_err_t err;
+
+		err = cyaml__load_parallel(config, input, input_len, retained,
+				schema, data_out, seq_count_out, &loaded);
+		if (loaded || err != CYAML_OK) {
+			return err;
+		}
+	}
+
+	return cyaml__load_string(config, loader, stream, input, input_len,
+			retained ? &origin : NULL, schema,
+			data_out, seq_count_out);
+}
+
+/**
+ * Load a YAML document from a file at the given path, by mapping it.
+ *
+ * \param[in]  config         Client's CYAML configuration structure.
+ * \param[in]  loader         Loader to reuse allocations from, or NULL.
+ * \param[in]  stream         Stream callback to give each document to, or
+ *                            NULL to load a single document.
+ * \param[in]  path           Path to YAML file to load.
+ * \param[in]  schema         CYAML schema for the YAML to be loaded.
+ * \param[out] data_out       Returns the caller-owned loaded data on success.
+ *                            Untouched on failure.
+ * \param[out] seq_count_out  On success, returns the sequence entry count.
+ *                            Untouched on failure.
+ * \param[out] mapped         Returns false if the file could not be mapped,
+ *                            in which case it should be read instead.
+ * \return \ref CYAML_OK on success, or appropriate error code otherwise.
+ */
+static cyaml_err_t cyaml__load_file_mmap(
+		const cyaml_config_t *config,
+		cyaml_loader_t *loader,
+		const cyaml_stream_t *stream,
 		const char *path,
+		const cyaml_schema_value_t *schema,
+		cyaml_data_t **data_out,
+		unsigned *seq_count_out,
+		bool *mapped)
+{
+#if CYAML_HAVE_MMAP
+	static const uint8_t empty[] = "";
+	struct stat info;
+	cyaml_err_t err;
+	size_t size;
+	void *map;
+	int fd;
+
+	*mapped = false;
+
+	fd = open(path, O_RDONLY);
+	if (fd == -1) {
+		return CYAML_ERR_FILE_OPEN;
+	}
+
+	if (fstat(fd, &info) != 0 || !S_ISREG(info.st_mode) ||
+	    (uintmax_t)info.st_size > SIZE_MAX) {
+		close(fd);
+		return CYAML_OK;
+	}
+
+	size = (size_t)info.st_size;
+	if (size == 0) {
+		/* Empty files can't be mapped. */
+		close(fd);
+		*mapped = true;
+		return cyaml__load_data(config, loader, stream, empty, 0,
+				false, schema, data_out, seq_count_out);
+	}
+
+	/* The mapping remains valid after the file is closed. */
+	map = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (map == MAP_FAILED) {
+		return CYAML_OK;
+	}
+
+	cyaml__log(config, CYAML_LOG_DEBUG,
+			"Load: Mapped file: %s (%zu bytes)\n", path, size);
+
+	/* Failure to advise the kernel doesn't matter. */
+	(void)posix_madvise(map, size, POSIX_MADV_SEQUENTIAL);
+
+	*mapped = true;
+	/* The mapping doesn't outlive the load, so it can't hold lazy
+	 * values. */
+	err = cyaml__load_data(config, loader, stream, map, size, false,
+			schema, data_out, seq_count_out);
+
+	munmap(map, size);
+	return err;
+#else
+	CYAML_UNUSED(config);
+	CYAML_UNUSED(loader);
+	CYAML_UNUSED(stream);
+	CYAML_UNUSED(path);
+	CYAML_UNUSED(schema);
+	CYAML_UNUSED(data_out);
+	CYAML_UNUSED(seq_count_out);
+
+	*mapped = false;
+	return CYAML_OK;
+#endif
+}
+
+/**
+ * Load a YAML document from a file at the given path.
+ *
+ * \param[in]  config         Client's CYAML configuration structure.
+ * \param[in]  loader         Loader to reuse allocations from, or NULL.
+ * \param[in]  stream         Stream callback to give each document to, or
+ *                            NULL to load a single document.
+ * \param[in]  path           Path to YAML file to load.
+ * \param[in]  schema         CYAML schema for the YAML to be loaded.
+ * \param[out] data_out       Returns the caller-owned loaded data on success.
+ *                            Untouched on failure.
+ * \param[out] seq_count_out  On success, returns the sequence entry count.
+ *                            Untouched on failure.
+ * \return \ref CYAML_OK on success, or appropriate error code otherwise.
+ */
+static cyaml_err_t cyaml__load_file(
 		const cyaml_config_t *config,
+		cyaml_loader_t *loader,
+		const cyaml_stream_t *stream,
+		const char *path,
 		const cyaml_schema_value_t *schema,
 		cyaml_data_t **data_out,
 		unsigned *seq_count_out)
@@ -3084,6 +5099,16 @@ cyaml_err_t cyaml_load_file(
 	cyaml_err_t err;
 	yaml_parser_t parser;
 
+	if (config != NULL && (config->flags & CYAML_CFG_MMAP)) {
+		bool mapped;
+
+		err = cyaml__load_file_mmap(config, loader, stream, path,
+				schema, data_out, seq_count_out, &mapped);
+		if (err != CYAML_OK || mapped) {
+			return err;
+		}
+	}
+
 	/* Initialize parser */
 	if (!yaml_parser_initialize(&parser)) {
 		return CYAML_ERR_LIBYAML_PARSER_INIT;
@@ -3100,7 +5125,8 @@ cyaml_err_t cyaml_load_file(
 	yaml_parser_set_input_file(&parser, file);
 
 	/* Parse the input */
-	err = cyaml__load(config, schema, data_out, seq_count_out, &parser);
+	err = cyaml__load(config, loader, stream, schema,
+			data_out, seq_count_out, &parser, NULL, NULL);
 	if (err != CYAML_OK) {
 		yaml_parser_delete(&parser);
 		fclose(file);
@@ -3114,6 +5140,18 @@ cyaml_err_t cyaml_load_file(
 	return CYAML_OK;
 }
 
+/* Exported function, documented in include/cyaml/cyaml.h */
+cyaml_err_t cyaml_load_file(
+		const char *path,
+		const cyaml_config_t *config,
+		const cyaml_schema_value_t *schema,
+		cyaml_data_t **data_out,
+		unsigned *seq_count_out)
+{
+	return cyaml__load_file(config, NULL, NULL, path, schema,
+			data_out, seq_count_out);
+}
+
 /* Exported function, documented in include/cyaml/cyaml.h */
 cyaml_err_t cyaml_load_data(
 		const uint8_t *input,
@@ -3122,27 +5160,516 @@ cyaml_err_t cyaml_load_data(
 		const cyaml_schema_value_t *schema,
 		cyaml_data_t **data_out,
 		unsigned *seq_count_out)
+{
+	return cyaml__load_data(config, NULL, NULL, input, input_len, true,
+			schema, data_out, seq_count_out);
+}
+
+/* Exported function, documented in include/cyaml/cyaml.h */
+cyaml_err_t cyaml_load_stream_file(
+		const char *path,
+		const cyaml_config_t *config,
+		const cyaml_schema_value_t *schema,
+		cyaml_doc_fn_t doc_fn,
+		void *doc_ctx)
+{
+	const cyaml_stream_t stream = {
+		.doc_fn = doc_fn,
+		.doc_ctx = doc_ctx,
+	};
+
+	return cyaml__load_file(config, NULL, &stream, path, schema,
+			NULL, NULL);
+}
+
+/* Exported function, documented in include/cyaml/cyaml.h */
+cyaml_err_t cyaml_load_stream_data(
+		const uint8_t *input,
+		size_t input_len,
+		const cyaml_config_t *config,
+		const cyaml_schema_value_t *schema,
+		cyaml_doc_fn_t doc_fn,
+		void *doc_ctx)
+{
+	const cyaml_stream_t stream = {
+		.doc_fn = doc_fn,
+		.doc_ctx = doc_ctx,
+	};
+
+	return cyaml__load_data(config, NULL, &stream, input, input_len,
+			true, schema, NULL, NULL);
+}
+
+/* Exported function, documented in include/cyaml/cyaml.h */
+cyaml_err_t cyaml_lazy_get(
+		const cyaml_config_t *config,
+		const cyaml_schema_value_t *schema,
+		const cyaml_lazy_t *lazy,
+		cyaml_data_t **data_out,
+		unsigned *seq_count_out)
 {
 	cyaml_err_t err;
+	uint8_t *input;
+	size_t len;
+
+	err = cyaml__validate_load_params(config, schema,
+			data_out, seq_count_out);
+	if (err != CYAML_OK) {
+		return err;
+	}
+	if (lazy == NULL) {
+		return CYAML_ERR_BAD_PARAM_NULL_DATA;
+	}
+
+	if (lazy->input == NULL) {
+		*data_out = NULL;
+		if (seq_count_out != NULL) {
+			*seq_count_out = 0;
+		}
+		return CYAML_OK;
+	}
+
+	input = cyaml__lazy_input(config, lazy, &len);
+	if (input == NULL) {
+		return CYAML_ERR_OOM;
+	}
+
+	err = cyaml__load_string(config, NULL, NULL, input, len, lazy,
+			schema, data_out, seq_count_out);
+
+	cyaml__free(config, input);
+	return err;
+}
+
+/* Exported function, documented in include/cyaml/cyaml.h */
+cyaml_err_t cyaml_loader_create(
+		const cyaml_config_t *config,
+		cyaml_loader_t **loader_out)
+{
+	cyaml_loader_t *loader;
+
+	if (config == NULL) {
+		return CYAML_ERR_BAD_PARAM_NULL_CONFIG;
+	}
+	if (config->mem_fn == NULL) {
+		return CYAML_ERR_BAD_CONFIG_NULL_MEMFN;
+	}
+	if (loader_out == NULL) {
+		return CYAML_ERR_BAD_PARAM_NULL_LOADER;
+	}
+
+	loader = cyaml__alloc(config, sizeof(*loader), true);
+	if (loader == NULL) {
+		return CYAML_ERR_OOM;
+	}
+
+	loader->config = config;
+
+	*loader_out = loader;
+	return CYAML_OK;
+}
+
+/* Exported function, documented in include/cyaml/cyaml.h */
+cyaml_err_t cyaml_loader_load_file(
+		cyaml_loader_t *loader,
+		const char *path,
+		const cyaml_schema_value_t *schema,
+		cyaml_data_t **data_out,
+		unsigned *seq_count_out)
+{
+	if (loader == NULL) {
+		return CYAML_ERR_BAD_PARAM_NULL_LOADER;
+	}
+	if (loader->feed != NULL) {
+		return CYAML_ERR_BAD_LOADER_STATE;
+	}
+
+	return cyaml__load_file(loader->config, loader, NULL, path, schema,
+			data_out, seq_count_out);
+}
+
+/* Exported function, documented in include/cyaml/cyaml.h */
+cyaml_err_t cyaml_loader_load_data(
+		cyaml_loader_t *loader,
+		const uint8_t *input,
+		size_t input_len,
+		const cyaml_schema_value_t *schema,
+		cyaml_data_t **data_out,
+		unsigned *seq_count_out)
+{
+	if (loader == NULL) {
+		return CYAML_ERR_BAD_PARAM_NULL_LOADER;
+	}
+	if (loader->feed != NULL) {
+		return CYAML_ERR_BAD_LOADER_STATE;
+	}
+
+	return cyaml__load_data(loader->config, loader, NULL, input, input_len,
+			true, schema, data_out, seq_count_out);
+}
+
+/**
+ * Get the sequence count output for an incremental load.
+ *
+ * \param[in]  feed  The incremental load.
+ * \return pointer to write the sequence count to, or NULL if the top level
+ *         value isn't a sequence.
+ */
+static inline unsigned * cyaml__feed_seq_count(
+		cyaml_feed_t *feed)
+{
+	return (feed->schema->type == CYAML_SEQUENCE) ? &feed->seq_count : NULL;
+}
+
+#if CYAML_HAVE_PTHREAD
+/**
+ * `libyaml` read handler for incremental loads.
+ *
+ * Runs on the parser thread, and waits until the client feeds some input,
+ * ends the input, or abandons the load.
+ *
+ * \param[in]  data       The incremental load.
+ * \param[in]  buffer     Buffer to read input into.
+ * \param[in]  size       Size of buffer in bytes.
+ * \param[out] size_read  Returns number of bytes read, or zero at the end
+ *                        of the input.
+ * \return 1 on success, or 0 if the load is being abandoned.
+ */
+static int cyaml__feed_read(
+		void *data,
+		unsigned char *buffer,
+		size_t size,
+		size_t *size_read)
+{
+	cyaml_feed_t *feed = data;
+	size_t len;
+
+	pthread_mutex_lock(&feed->lock);
+	while (feed->input_len == 0 && !feed->end && !feed->abort) {
+		feed->starved = true;
+		pthread_cond_broadcast(&feed->cond);
+		pthread_cond_wait(&feed->cond, &feed->lock);
+	}
+
+	if (feed->abort) {
+		pthread_mutex_unlock(&feed->lock);
+		*size_read = 0;
+		return 0;
+	}
+
+	len = (feed->input_len < size) ? feed->input_len : size;
+	memcpy(buffer, feed->input, len);
+	feed->input += len;
+	feed->input_len -= len;
+	pthread_mutex_unlock(&feed->lock);
+
+	*size_read = len;
+	return 1;
+}
+
+/**
+ * Parser thread start routine for incremental loads.
+ *
+ * \param[in]  ctx  The loader.
+ * \return NULL.
+ */
+static void * cyaml__feed_thread(void *ctx)
+{
+	cyaml_loader_t *loader = ctx;
+	cyaml_feed_t *feed = loader->feed;
 	yaml_parser_t parser;
+	cyaml_err_t err;
 
-	/* Initialize parser */
 	if (!yaml_parser_initialize(&parser)) {
-		return CYAML_ERR_LIBYAML_PARSER_INIT;
+		err = CYAML_ERR_LIBYAML_PARSER_INIT;
+	} else {
+		yaml_parser_set_input(&parser, cyaml__feed_read, feed);
+		err = cyaml__load(loader->config, loader, NULL, feed->schema,
+				&feed->data, cyaml__feed_seq_count(feed),
+				&parser, NULL, NULL);
+		yaml_parser_delete(&parser);
 	}
 
-	/* Set input data */
-	yaml_parser_set_input_string(&parser, input, input_len);
+	pthread_mutex_lock(&feed->lock);
+	feed->err = err;
+	feed->done = true;
+	pthread_cond_broadcast(&feed->cond);
+	pthread_mutex_unlock(&feed->lock);
 
-	/* Parse the input */
-	err = cyaml__load(config, schema, data_out, seq_count_out, &parser);
+	return NULL;
+}
+
+/**
+ * Start the parser thread for an incremental load.
+ *
+ * The thread gets a stack of \ref CYAML_FEED_STACK_SIZE bytes, so that
+ * loads in progress don't each reserve the platform's default thread
+ * stack size.
+ *
+ * \param[in]  loader  The loader with the incremental load to start.
+ * \return true on success, false if the thread couldn't be created.
+ */
+static bool cyaml__feed_thread_start(
+		cyaml_loader_t *loader)
+{
+	size_t stack_size = CYAML_FEED_STACK_SIZE;
+	pthread_attr_t attr;
+	bool ok;
+
+	if (pthread_attr_init(&attr) != 0) {
+		return false;
+	}
+
+#ifdef PTHREAD_STACK_MIN
+	if (stack_size < (size_t)PTHREAD_STACK_MIN) {
+		stack_size = (size_t)PTHREAD_STACK_MIN;
+	}
+#endif
+	/* If the size is refused, the default stack size is used. */
+	(void)pthread_attr_setstacksize(&attr, stack_size);
+
+	ok = (pthread_create(&loader->feed->thread, &attr,
+			cyaml__feed_thread, loader) == 0);
+	pthread_attr_destroy(&attr);
+
+	return ok;
+}
+#endif
+
+/**
+ * Free an incremental load.
+ *
+ * If the load isn't done, it is abandoned.  If the load completed but its
+ * data was never taken by \ref cyaml_loader_feed_end, the data is freed.
+ *
+ * \param[in]  loader  The loader with the incremental load to free.
+ */
+static void cyaml__feed_free(
+		cyaml_loader_t *loader)
+{
+	cyaml_feed_t *feed = loader->feed;
+
+#if CYAML_HAVE_PTHREAD
+	pthread_mutex_lock(&feed->lock);
+	feed->abort = true;
+	pthread_cond_broadcast(&feed->cond);
+	pthread_mutex_unlock(&feed->lock);
+
+	pthread_join(feed->thread, NULL);
+	pthread_cond_destroy(&feed->cond);
+	pthread_mutex_destroy(&feed->lock);
+#else
+	cyaml__free(loader->config, feed->buffer);
+#endif
+
+	if (feed->err == CYAML_OK && feed->data != NULL) {
+		if (loader->config->flags & CYAML_CFG_ARENA) {
+			cyaml_arena_free(loader->config, feed->data);
+		} else {
+			cyaml_free(loader->config, feed->schema,
+					feed->data, feed->seq_count);
+		}
+	}
+
+	cyaml__free(loader->config, feed);
+	loader->feed = NULL;
+}
+
+/* Exported function, documented in include/cyaml/cyaml.h */
+cyaml_err_t cyaml_loader_feed_start(
+		cyaml_loader_t *loader,
+		const cyaml_schema_value_t *schema)
+{
+	cyaml_feed_t *feed;
+
+	if (loader == NULL) {
+		return CYAML_ERR_BAD_PARAM_NULL_LOADER;
+	}
+	if (loader->feed != NULL) {
+		return CYAML_ERR_BAD_LOADER_STATE;
+	}
+	if (schema == NULL) {
+		return CYAML_ERR_BAD_PARAM_NULL_SCHEMA;
+	}
+	if (!(schema->flags & CYAML_FLAG_POINTER)) {
+		return CYAML_ERR_TOP_LEVEL_NON_PTR;
+	}
+
+	feed = cyaml__alloc(loader->config, sizeof(*feed), true);
+	if (feed == NULL) {
+		return CYAML_ERR_OOM;
+	}
+	feed->schema = schema;
+
+#if CYAML_HAVE_PTHREAD
+	if (pthread_mutex_init(&feed->lock, NULL) != 0) {
+		cyaml__free(loader->config, feed);
+		return CYAML_ERR_OOM;
+	}
+	if (pthread_cond_init(&feed->cond, NULL) != 0) {
+		pthread_mutex_destroy(&feed->lock);
+		cyaml__free(loader->config, feed);
+		return CYAML_ERR_OOM;
+	}
+
+	loader->feed = feed;
+	if (!cyaml__feed_thread_start(loader)) {
+		pthread_cond_destroy(&feed->cond);
+		pthread_mutex_destroy(&feed->lock);
+		cyaml__free(loader->config, feed);
+		loader->feed = NULL;
+		return CYAML_ERR_OOM;
+	}
+#else
+	loader->feed = feed;
+#endif
+
+	cyaml__log(loader->config, CYAML_LOG_DEBUG,
+			"Load: Incremental load started\n");
+	return CYAML_OK;
+}
+
+/* Exported function, documented in include/cyaml/cyaml.h */
+cyaml_err_t cyaml_loader_feed(
+		cyaml_loader_t *loader,
+		const uint8_t *input,
+		size_t input_len)
+{
+	cyaml_feed_t *feed;
+	cyaml_err_t err;
+
+	if (loader == NULL) {
+		return CYAML_ERR_BAD_PARAM_NULL_LOADER;
+	}
+	if (loader->feed == NULL) {
+		return CYAML_ERR_BAD_LOADER_STATE;
+	}
+	if (input == NULL && input_len != 0) {
+		return CYAML_ERR_BAD_PARAM_NULL_DATA;
+	}
+
+	feed = loader->feed;
+
+#if CYAML_HAVE_PTHREAD
+	pthread_mutex_lock(&feed->lock);
+	feed->input = input;
+	feed->input_len = input_len;
+	feed->starved = false;
+	pthread_cond_broadcast(&feed->cond);
+	while (!feed->done && !(feed->starved && feed->input_len == 0)) {
+		pthread_cond_wait(&feed->cond, &feed->lock);
+	}
+	err = feed->done ? feed->err : CYAML_NEED_MORE;
+	pthread_mutex_unlock(&feed->lock);
+#else
+	if (feed->buffer_size - feed->buffer_len < input_len) {
+		size_t size = feed->buffer_len + input_len;
+		uint8_t *temp;
+
+		if (size < input_len) {
+			err = CYAML_ERR_OOM;
+			goto out;
+		}
+		if (size < feed->buffer_size * 2) {
+			size = feed->buffer_size * 2;
+		}
+
+		temp = cyaml__realloc(loader->config, feed->buffer,
+				feed->buffer_len, size, false);
+		if (temp == NULL) {
+			err = CYAML_ERR_OOM;
+			goto out;
+		}
+		feed->buffer = temp;
+		feed->buffer_size = size;
+	}
+
+	if (input_len != 0) {
+		memcpy(feed->buffer + feed->buffer_len, input, input_len);
+		feed->buffer_len += input_len;
+	}
+	err = CYAML_NEED_MORE;
+out:
+#endif
+
+	if (err != CYAML_NEED_MORE && err != CYAML_OK) {
+		cyaml__feed_free(loader);
+		return err;
+	}
+
+	return CYAML_NEED_MORE;
+}
+
+/* Exported function, documented in include/cyaml/cyaml.h */
+cyaml_err_t cyaml_loader_feed_end(
+		cyaml_loader_t *loader,
+		cyaml_data_t **data_out,
+		unsigned *seq_count_out)
+{
+	cyaml_feed_t *feed;
+	cyaml_err_t err;
+
+	if (loader == NULL) {
+		return CYAML_ERR_BAD_PARAM_NULL_LOADER;
+	}
+	if (loader->feed == NULL) {
+		return CYAML_ERR_BAD_LOADER_STATE;
+	}
+
+	feed = loader->feed;
+	err = cyaml__validate_load_params(loader->config, feed->schema,
+			data_out, seq_count_out);
 	if (err != CYAML_OK) {
-		yaml_parser_delete(&parser);
 		return err;
 	}
 
-	/* Cleanup */
-	yaml_parser_delete(&parser);
+#if CYAML_HAVE_PTHREAD
+	pthread_mutex_lock(&feed->lock);
+	feed->end = true;
+	pthread_cond_broadcast(&feed->cond);
+	while (!feed->done) {
+		pthread_cond_wait(&feed->cond, &feed->lock);
+	}
+	pthread_mutex_unlock(&feed->lock);
+#else
+	feed->err = cyaml__load_string(loader->config, loader, NULL,
+			feed->buffer, feed->buffer_len, NULL, feed->schema,
+			&feed->data, cyaml__feed_seq_count(feed));
+#endif
+
+	err = feed->err;
+	if (err == CYAML_OK) {
+		*data_out = feed->data;
+		if (seq_count_out != NULL) {
+			*seq_count_out = feed->seq_count;
+		}
+		feed->data = NULL;
+	}
+
+	cyaml__feed_free(loader);
+	return err;
+}
+
+/* Exported function, documented in include/cyaml/cyaml.h */
+cyaml_err_t cyaml_loader_free(
+		cyaml_loader_t *loader)
+{
+	const cyaml_config_t *config;
+
+	if (loader == NULL) {
+		return CYAML_OK;
+	}
+
+	if (loader->feed != NULL) {
+		cyaml__feed_free(loader);
+	}
+
+	config = loader->config;
+	cyaml__free(config, loader->stack);
+	cyaml__free(config, loader->bitfields);
+	cyaml__free_recording(config, &loader->record);
+	cyaml__intern_free(config, &loader->intern);
+	cyaml__free(config, loader);
 
 	return CYAML_OK;
 }
@@ -14,6 +14,8 @@
 
 #include "cyaml/cyaml.h"
 
+#include "stats.h"
+
 /**
  * Helper for freeing using the client's choice of allocator routine.
  *
@@ -24,6 +26,7 @@ static inline void cyaml__free(
 		const cyaml_config_t *config,
 		void *ptr)
 {
+	cyaml__stats_mem(config, ptr, 0);
 	config->mem_fn(config->mem_ctx, ptr, 0);
 }
 
@@ -50,7 +53,11 @@ static inline void * cyaml__realloc(
 		size_t new_size,
 		bool clean)
 {
-	uint8_t *temp = config->mem_fn(config->mem_ctx, ptr, new_size);
+	uint8_t *temp;
+
+	cyaml__stats_mem(config, ptr, new_size);
+
+	temp = config->mem_fn(config->mem_ctx, ptr, new_size);
 	if (temp == NULL) {
 		return NULL;
 	}
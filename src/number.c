@@ -0,0 +1,851 @@
+/*
+ * SPDX-License-Identifier: ISC
+ *
+ * Copyright (C) 2026 Michael Drake <tlsa@netsurf-browser.org>
+ */
+
+/**
+ * \file
+ * \brief CYAML number formatting and parsing.
+ *
+ * Floating point values are converted with the Grisu2 algorithm, from
+ * Florian Loitsch's paper "Printing Floating-Point Numbers Quickly and
+ * Accurately with Integers".  The output always reads back as the same
+ * value, and it is almost always the shortest string that does.
+ *
+ * Parsing handles common number strings directly, and falls back to the C
+ * library for anything else, so that the accepted strings don't change.
+ * Floating point values are parsed directly using Clinger's fast path,
+ * when the result can be computed exactly with one rounding.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <float.h>
+
+#include "number.h"
+
+/** A floating point value, as a 64-bit significand and binary exponent. */
+typedef struct cyaml_diy_fp {
+	uint64_t f; /**< Significand. */
+	int e;      /**< Binary exponent. */
+} cyaml_diy_fp_t;
+
+/**
+ * Normalised cached powers of ten, from 1e-348 to 1e340 in steps of 1e8.
+ */
+static const struct cyaml_cached_power {
+	uint64_t f; /**< Significand. */
+	int16_t e;  /**< Binary exponent. */
+} cyaml__cached_powers[] = {
+	{ 0xfa8fd5a0081c0288u, -1220 }, /* 1e-348 */
+	{ 0xbaaee17fa23ebf76u, -1193 }, /* 1e-340 */
+	{ 0x8b16fb203055ac76u, -1166 }, /* 1e-332 */
+	{ 0xcf42894a5dce35eau, -1140 }, /* 1e-324 */
+	{ 0x9a6bb0aa55653b2du, -1113 }, /* 1e-316 */
+	{ 0xe61acf033d1a45dfu, -1087 }, /* 1e-308 */
+	{ 0xab70fe17c79ac6cau, -1060 }, /* 1e-300 */
+	{ 0xff77b1fcbebcdc4fu, -1034 }, /* 1e-292 */
+	{ 0xbe5691ef416bd60cu, -1007 }, /* 1e-284 */
+	{ 0x8dd01fad907ffc3cu,  -980 }, /* 1e-276 */
+	{ 0xd3515c2831559a83u,  -954 }, /* 1e-268 */
+	{ 0x9d71ac8fada6c9b5u,  -927 }, /* 1e-260 */
+	{ 0xea9c227723ee8bcbu,  -901 }, /* 1e-252 */
+	{ 0xaecc49914078536du,  -874 }, /* 1e-244 */
+	{ 0x823c12795db6ce57u,  -847 }, /* 1e-236 */
+	{ 0xc21094364dfb5637u,  -821 }, /* 1e-228 */
+	{ 0x9096ea6f3848984fu,  -794 }, /* 1e-220 */
+	{ 0xd77485cb25823ac7u,  -768 }, /* 1e-212 */
+	{ 0xa086cfcd97bf97f4u,  -741 }, /* 1e-204 */
+	{ 0xef340a98172aace5u,  -715 }, /* 1e-196 */
+	{ 0xb23867fb2a35b28eu,  -688 }, /* 1e-188 */
+	{ 0x84c8d4dfd2c63f3bu,  -661 }, /* 1e-180 */
+	{ 0xc5dd44271ad3cdbau,  -635 }, /* 1e-172 */
+	{ 0x936b9fcebb25c996u,  -608 }, /* 1e-164 */
+	{ 0xdbac6c247d62a584u,  -582 }, /* 1e-156 */
+	{ 0xa3ab66580d5fdaf6u,  -555 }, /* 1e-148 */
+	{ 0xf3e2f893dec3f126u,  -529 }, /* 1e-140 */
+	{ 0xb5b5ada8aaff80b8u,  -502 }, /* 1e-132 */
+	{ 0x87625f056c7c4a8bu,  -475 }, /* 1e-124 */
+	{ 0xc9bcff6034c13053u,  -449 }, /* 1e-116 */
+	{ 0x964e858c91ba2655u,  -422 }, /* 1e-108 */
+	{ 0xdff9772470297ebdu,  -396 }, /* 1e-100 */
+	{ 0xa6dfbd9fb8e5b88fu,  -369 }, /* 1e-92 */
+	{ 0xf8a95fcf88747d94u,  -343 }, /* 1e-84 */
+	{ 0xb94470938fa89bcfu,  -316 }, /* 1e-76 */
+	{ 0x8a08f0f8bf0f156bu,  -289 }, /* 1e-68 */
+	{ 0xcdb02555653131b6u,  -263 }, /* 1e-60 */
+	{ 0x993fe2c6d07b7facu,  -236 }, /* 1e-52 */
+	{ 0xe45c10c42a2b3b06u,  -210 }, /* 1e-44 */
+	{ 0xaa242499697392d3u,  -183 }, /* 1e-36 */
+	{ 0xfd87b5f28300ca0eu,  -157 }, /* 1e-28 */
+	{ 0xbce5086492111aebu,  -130 }, /* 1e-20 */
+	{ 0x8cbccc096f5088ccu,  -103 }, /* 1e-12 */
+	{ 0xd1b71758e219652cu,   -77 }, /* 1e-4 */
+	{ 0x9c40000000000000u,   -50 }, /* 1e4 */
+	{ 0xe8d4a51000000000u,   -24 }, /* 1e12 */
+	{ 0xad78ebc5ac620000u,     3 }, /* 1e20 */
+	{ 0x813f3978f8940984u,    30 }, /* 1e28 */
+	{ 0xc097ce7bc90715b3u,    56 }, /* 1e36 */
+	{ 0x8f7e32ce7bea5c70u,    83 }, /* 1e44 */
+	{ 0xd5d238a4abe98068u,   109 }, /* 1e52 */
+	{ 0x9f4f2726179a2245u,   136 }, /* 1e60 */
+	{ 0xed63a231d4c4fb27u,   162 }, /* 1e68 */
+	{ 0xb0de65388cc8ada8u,   189 }, /* 1e76 */
+	{ 0x83c7088e1aab65dbu,   216 }, /* 1e84 */
+	{ 0xc45d1df942711d9au,   242 }, /* 1e92 */
+	{ 0x924d692ca61be758u,   269 }, /* 1e100 */
+	{ 0xda01ee641a708deau,   295 }, /* 1e108 */
+	{ 0xa26da3999aef774au,   322 }, /* 1e116 */
+	{ 0xf209787bb47d6b85u,   348 }, /* 1e124 */
+	{ 0xb454e4a179dd1877u,   375 }, /* 1e132 */
+	{ 0x865b86925b9bc5c2u,   402 }, /* 1e140 */
+	{ 0xc83553c5c8965d3du,   428 }, /* 1e148 */
+	{ 0x952ab45cfa97a0b3u,   455 }, /* 1e156 */
+	{ 0xde469fbd99a05fe3u,   481 }, /* 1e164 */
+	{ 0xa59bc234db398c25u,   508 }, /* 1e172 */
+	{ 0xf6c69a72a3989f5cu,   534 }, /* 1e180 */
+	{ 0xb7dcbf5354e9beceu,   561 }, /* 1e188 */
+	{ 0x88fcf317f22241e2u,   588 }, /* 1e196 */
+	{ 0xcc20ce9bd35c78a5u,   614 }, /* 1e204 */
+	{ 0x98165af37b2153dfu,   641 }, /* 1e212 */
+	{ 0xe2a0b5dc971f303au,   667 }, /* 1e220 */
+	{ 0xa8d9d1535ce3b396u,   694 }, /* 1e228 */
+	{ 0xfb9b7cd9a4a7443cu,   720 }, /* 1e236 */
+	{ 0xbb764c4ca7a44410u,   747 }, /* 1e244 */
+	{ 0x8bab8eefb6409c1au,   774 }, /* 1e252 */
+	{ 0xd01fef10a657842cu,   800 }, /* 1e260 */
+	{ 0x9b10a4e5e9913129u,   827 }, /* 1e268 */
+	{ 0xe7109bfba19c0c9du,   853 }, /* 1e276 */
+	{ 0xac2820d9623bf429u,   880 }, /* 1e284 */
+	{ 0x80444b5e7aa7cf85u,   907 }, /* 1e292 */
+	{ 0xbf21e44003acdd2du,   933 }, /* 1e300 */
+	{ 0x8e679c2f5e44ff8fu,   960 }, /* 1e308 */
+	{ 0xd433179d9c8cb841u,   986 }, /* 1e316 */
+	{ 0x9e19db92b4e31ba9u,  1013 }, /* 1e324 */
+	{ 0xeb96bf6ebadf77d9u,  1039 }, /* 1e332 */
+	{ 0xaf87023b9bf0ee6bu,  1066 }, /* 1e340 */
+};
+
+/** Powers of ten that fit in 32 bits. */
+static const uint32_t cyaml__pow10[] = {
+	1u, 10u, 100u, 1000u, 10000u, 100000u,
+	1000000u, 10000000u, 100000000u, 1000000000u,
+};
+
+/**
+ * Multiply two floating point values, rounding to 64 significant bits.
+ *
+ * \param[in]  x  First value.
+ * \param[in]  y  Second value.
+ * \return the product.
+ */
+static cyaml_diy_fp_t cyaml__diy_fp_mul(
+		cyaml_diy_fp_t x,
+		cyaml_diy_fp_t y)
+{
+	const uint64_t m32 = 0xffffffffu;
+	uint64_t a = x.f >> 32;
+	uint64_t b = x.f & m32;
+	uint64_t c = y.f >> 32;
+	uint64_t d = y.f & m32;
+	uint64_t ac = a * c;
+	uint64_t bc = b * c;
+	uint64_t ad = a * d;
+	uint64_t bd = b * d;
+	uint64_t tmp = (bd >> 32) + (ad & m32) + (bc & m32) + (1u << 31);
+
+	return (cyaml_diy_fp_t) {
+		.f = ac + (ad >> 32) + (bc >> 32) + (tmp >> 32),
+		.e = x.e + y.e + 64,
+	};
+}
+
+/**
+ * Normalise a floating point value, so its significand's top bit is set.
+ *
+ * \param[in]  x  The value to normalise.  Must be non-zero.
+ * \return the normalised value.
+ */
+static cyaml_diy_fp_t cyaml__diy_fp_normalise(
+		cyaml_diy_fp_t x)
+{
+	while (!(x.f & ((uint64_t)1 << 63))) {
+		x.f <<= 1;
+		x.e--;
+	}
+
+	return x;
+}
+
+/**
+ * Get a cached power of ten that brings a value into the digit range.
+ *
+ * \param[in]  e  Binary exponent of the normalised upper boundary.
+ * \param[out] k  Returns the negated decimal exponent of the power.
+ * \return the cached power of ten.
+ */
+static cyaml_diy_fp_t cyaml__cached_power(
+		int e,
+		int *k)
+{
+	double dk = (-61 - e) * 0.30102999566398114 + 347;
+	int ik = (int)dk;
+	unsigned index;
+
+	if (dk - ik > 0.0) {
+		ik++;
+	}
+
+	index = (unsigned)((ik >> 3) + 1);
+	*k = -(-348 + (int)(index << 3));
+
+	return (cyaml_diy_fp_t) {
+		.f = cyaml__cached_powers[index].f,
+		.e = cyaml__cached_powers[index].e,
+	};
+}
+
+/**
+ * Nudge the last generated digit towards the exact value.
+ *
+ * \param[in,out] buffer     The generated digits.
+ * \param[in]     len        Number of generated digits.
+ * \param[in]     delta      Width of the rounding interval.
+ * \param[in]     rest       Remainder after the generated digits.
+ * \param[in]     ten_kappa  Value of one unit in the last digit.
+ * \param[in]     wp_w       Distance from the value to the upper boundary.
+ */
+static void cyaml__grisu_round(
+		char *buffer,
+		unsigned len,
+		uint64_t delta,
+		uint64_t rest,
+		uint64_t ten_kappa,
+		uint64_t wp_w)
+{
+	while (rest < wp_w && delta - rest >= ten_kappa &&
+	       (rest + ten_kappa < wp_w ||
+	        wp_w - rest > rest + ten_kappa - wp_w)) {
+		buffer[len - 1]--;
+		rest += ten_kappa;
+	}
+}
+
+/**
+ * Count the decimal digits in a 32-bit value.
+ *
+ * \param[in]  n  The value.
+ * \return the number of decimal digits.
+ */
+static int cyaml__count_digits(
+		uint32_t n)
+{
+	int count = 1;
+
+	while (count < 10 && n >= cyaml__pow10[count]) {
+		count++;
+	}
+
+	return count;
+}
+
+/**
+ * Generate the shortest digits in the rounding interval.
+ *
+ * \param[in]     w       The scaled value.
+ * \param[in]     mp      The scaled upper boundary.
+ * \param[in]     delta   Width of the scaled rounding interval.
+ * \param[out]    buffer  Returns the digits.
+ * \param[in,out] k       Decimal exponent, updated for the digits.
+ * \return the number of generated digits.
+ */
+static unsigned cyaml__grisu_digits(
+		cyaml_diy_fp_t w,
+		cyaml_diy_fp_t mp,
+		uint64_t delta,
+		char *buffer,
+		int *k)
+{
+	const cyaml_diy_fp_t one = {
+		.f = (uint64_t)1 << -mp.e,
+		.e = mp.e,
+	};
+	const uint64_t wp_w = mp.f - w.f;
+	uint32_t p1 = (uint32_t)(mp.f >> -one.e);
+	uint64_t p2 = mp.f & (one.f - 1);
+	int kappa = cyaml__count_digits(p1);
+	unsigned len = 0;
+
+	while (kappa > 0) {
+		uint32_t div = cyaml__pow10[kappa - 1];
+		uint32_t d = p1 / div;
+		uint64_t rest;
+
+		p1 %= div;
+		if (d != 0 || len != 0) {
+			buffer[len++] = (char)('0' + d);
+		}
+		kappa--;
+
+		rest = ((uint64_t)p1 << -one.e) + p2;
+		if (rest <= delta) {
+			*k += kappa;
+			cyaml__grisu_round(buffer, len, delta, rest,
+					(uint64_t)cyaml__pow10[kappa] << -one.e,
+					wp_w);
+			return len;
+		}
+	}
+
+	for (;;) {
+		uint64_t d;
+
+		p2 *= 10;
+		delta *= 10;
+		d = p2 >> -one.e;
+		if (d != 0 || len != 0) {
+			buffer[len++] = (char)('0' + d);
+		}
+		p2 &= one.f - 1;
+		kappa--;
+
+		if (p2 < delta) {
+			*k += kappa;
+			cyaml__grisu_round(buffer, len, delta, p2, one.f,
+					(-kappa < 10) ?
+					wp_w * cyaml__pow10[-kappa] : 0);
+			return len;
+		}
+	}
+}
+
+/**
+ * Generate the digits for a finite, positive, floating point value.
+ *
+ * \param[in]  f       Significand of the value, including any hidden bit.
+ * \param[in]  e       Binary exponent of the value.
+ * \param[in]  hidden  The hidden bit, for the value's type.
+ * \param[out] buffer  Returns the digits.
+ * \param[out] k       Returns the decimal exponent of the last digit.
+ * \return the number of generated digits.
+ */
+static unsigned cyaml__grisu2(
+		uint64_t f,
+		int e,
+		uint64_t hidden,
+		char *buffer,
+		int *k)
+{
+	cyaml_diy_fp_t v = { .f = f, .e = e };
+	cyaml_diy_fp_t mp = { .f = (f << 1) + 1, .e = e - 1 };
+	cyaml_diy_fp_t mm;
+	cyaml_diy_fp_t c_mk;
+
+	if (f == hidden) {
+		mm = (cyaml_diy_fp_t) { .f = (f << 2) - 1, .e = e - 2 };
+	} else {
+		mm = (cyaml_diy_fp_t) { .f = (f << 1) - 1, .e = e - 1 };
+	}
+
+	mp = cyaml__diy_fp_normalise(mp);
+	mm.f <<= mm.e - mp.e;
+	mm.e = mp.e;
+
+	c_mk = cyaml__cached_power(mp.e, k);
+
+	v = cyaml__diy_fp_mul(cyaml__diy_fp_normalise(v), c_mk);
+	mp = cyaml__diy_fp_mul(mp, c_mk);
+	mm = cyaml__diy_fp_mul(mm, c_mk);
+	mm.f++;
+	mp.f--;
+
+	return cyaml__grisu_digits(v, mp, mp.f - mm.f, buffer, k);
+}
+
+/**
+ * Write a decimal exponent.
+ *
+ * \param[out] buffer  Buffer to write to.
+ * \param[in]  exp     The exponent.
+ * \return the number of bytes written.
+ */
+static unsigned cyaml__format_exponent(
+		char *buffer,
+		int exp)
+{
+	unsigned len = 0;
+
+	buffer[len++] = 'e';
+	if (exp < 0) {
+		buffer[len++] = '-';
+		exp = -exp;
+	} else {
+		buffer[len++] = '+';
+	}
+
+	if (exp >= 100) {
+		buffer[len++] = (char)('0' + exp / 100);
+		exp %= 100;
+		buffer[len++] = (char)('0' + exp / 10);
+	} else {
+		buffer[len++] = (char)('0' + exp / 10);
+	}
+	buffer[len++] = (char)('0' + exp % 10);
+
+	return len;
+}
+
+/**
+ * Lay out generated digits as a YAML floating point value.
+ *
+ * The output always has a decimal point, and any exponent is signed, so
+ * that it is read as a floating point value by YAML 1.1 and 1.2 readers.
+ *
+ * \param[in,out] buffer  Buffer holding the digits at the start.  Must
+ *                        have space for \ref CYAML_NUMBER_STR_MAX bytes.
+ * \param[in]     len     Number of digits.
+ * \param[in]     k       Decimal exponent of the last digit.
+ */
+static void cyaml__format_digits(
+		char *buffer,
+		unsigned len,
+		int k)
+{
+	int point = (int)len + k;
+
+	if (k >= 0 && point <= 16) {
+		/* Integer, like 1200.0 */
+		memset(buffer + len, '0', (size_t)k);
+		len += (unsigned)k;
+		buffer[len++] = '.';
+		buffer[len++] = '0';
+
+	} else if (point > 0 && point <= 16) {
+		/* Fixed point, like 12.34 */
+		memmove(buffer + point + 1, buffer + point, len - (size_t)point);
+		buffer[point] = '.';
+		len++;
+
+	} else if (point > -5 && point <= 0) {
+		/* Small fixed point, like 0.001234 */
+		unsigned offset = (unsigned)(2 - point);
+
+		memmove(buffer + offset, buffer, len);
+		buffer[0] = '0';
+		buffer[1] = '.';
+		memset(buffer + 2, '0', (size_t)-point);
+		len += offset;
+
+	} else {
+		/* Scientific, like 1.234e+30 */
+		if (len == 1) {
+			buffer[1] = '.';
+			buffer[2] = '0';
+			len = 3;
+		} else {
+			memmove(buffer + 2, buffer + 1, len - 1);
+			buffer[1] = '.';
+			len++;
+		}
+		len += cyaml__format_exponent(buffer + len, point - 1);
+	}
+
+	buffer[len] = '\0';
+}
+
+/**
+ * Convert a floating point value to a string, given its components.
+ *
+ * \param[in]  negative  Whether the value's sign bit is set.
+ * \param[in]  biased_e  The value's biased exponent field.
+ * \param[in]  mantissa  The value's mantissa field.
+ * \param[in]  e_max     Biased exponent field value for infinity and NaN.
+ * \param[in]  bias      Exponent bias, including the mantissa bits.
+ * \param[in]  hidden    The hidden bit, for the value's type.
+ * \param[out] buffer    Buffer of \ref CYAML_NUMBER_STR_MAX bytes to use.
+ * \return '\0' terminated string conversion of the value, within `buffer`.
+ */
+static const char * cyaml__format_fp(
+		bool negative,
+		int biased_e,
+		uint64_t mantissa,
+		int e_max,
+		int bias,
+		uint64_t hidden,
+		char buffer[CYAML_NUMBER_STR_MAX])
+{
+	char *pos = buffer;
+	unsigned len;
+	uint64_t f;
+	int e;
+	int k;
+
+	if (biased_e == e_max && mantissa != 0) {
+		memcpy(buffer, "nan", sizeof("nan"));
+		return buffer;
+	}
+
+	if (negative) {
+		*pos++ = '-';
+	}
+
+	if (biased_e == e_max) {
+		memcpy(pos, "inf", sizeof("inf"));
+		return buffer;
+	}
+
+	if (biased_e == 0 && mantissa == 0) {
+		memcpy(pos, "0.0", sizeof("0.0"));
+		return buffer;
+	}
+
+	if (biased_e != 0) {
+		f = mantissa + hidden;
+		e = biased_e - bias;
+	} else {
+		f = mantissa;
+		e = 1 - bias;
+	}
+
+	len = cyaml__grisu2(f, e, hidden, pos, &k);
+	cyaml__format_digits(pos, len, k);
+
+	return buffer;
+}
+
+/* Exported function, documented in number.h. */
+const char * cyaml__number_format_float(
+		float value,
+		char buffer[CYAML_NUMBER_STR_MAX])
+{
+	uint32_t bits;
+
+	memcpy(&bits, &value, sizeof(bits));
+
+	return cyaml__format_fp(bits >> 31, (int)((bits >> 23) & 0xff),
+			bits & 0x7fffff, 0xff, 127 + 23,
+			(uint64_t)1 << 23, buffer);
+}
+
+/* Exported function, documented in number.h. */
+const char * cyaml__number_format_double(
+		double value,
+		char buffer[CYAML_NUMBER_STR_MAX])
+{
+	uint64_t bits;
+
+	memcpy(&bits, &value, sizeof(bits));
+
+	return cyaml__format_fp(bits >> 63, (int)((bits >> 52) & 0x7ff),
+			bits & (((uint64_t)1 << 52) - 1), 0x7ff, 1023 + 52,
+			(uint64_t)1 << 52, buffer);
+}
+
+/* Exported function, documented in number.h. */
+const char * cyaml__number_format_uint(
+		uint64_t value,
+		bool hex,
+		char buffer[CYAML_NUMBER_STR_MAX])
+{
+	static const char digits[] = "0123456789abcdef";
+	char *pos = buffer + CYAML_NUMBER_STR_MAX - 1;
+
+	*pos = '\0';
+
+	if (hex) {
+		do {
+			*--pos = digits[value & 0xf];
+			value >>= 4;
+		} while (value != 0);
+		*--pos = 'x';
+		*--pos = '0';
+	} else {
+		do {
+			*--pos = digits[value % 10];
+			value /= 10;
+		} while (value != 0);
+	}
+
+	return pos;
+}
+
+/* Exported function, documented in number.h. */
+const char * cyaml__number_format_int(
+		int64_t value,
+		char buffer[CYAML_NUMBER_STR_MAX])
+{
+	char *pos;
+
+	if (value >= 0) {
+		return cyaml__number_format_uint((uint64_t)value,
+				false, buffer);
+	}
+
+	/* Negate as unsigned, so INT64_MIN works. */
+	pos = (char *)cyaml__number_format_uint(0 - (uint64_t)value,
+			false, buffer);
+	*--pos = '-';
+
+	return pos;
+}
+
+/**
+ * Get the value of a digit character.
+ *
+ * \param[in]  c  The character.
+ * \return the digit's value, or 16 if it is not a hex digit.
+ */
+static inline unsigned cyaml__digit_value(
+		char c)
+{
+	if (c >= '0' && c <= '9') {
+		return (unsigned)(c - '0');
+	} else if (c >= 'a' && c <= 'f') {
+		return (unsigned)(c - 'a' + 10);
+	} else if (c >= 'A' && c <= 'F') {
+		return (unsigned)(c - 'A' + 10);
+	}
+
+	return 16;
+}
+
+/**
+ * Parse the magnitude of an integer, without using the C library.
+ *
+ * This handles the common cases only.  Strings with leading white space,
+ * values that overflow, and invalid strings are left to the C library.
+ *
+ * \param[in]  str  The string to parse, after any sign.
+ * \param[out] out  Returns the parsed magnitude on success.
+ * \return true if the string was parsed, false otherwise.
+ */
+static bool cyaml__parse_magnitude(
+		const char *str,
+		uint64_t *out)
+{
+	uint64_t value = 0;
+	unsigned base = 10;
+
+	if (str[0] == '0') {
+		if ((str[1] == 'x' || str[1] == 'X') &&
+		    cyaml__digit_value(str[2]) < 16) {
+			base = 16;
+			str += 2;
+		} else {
+			base = 8;
+			str++;
+		}
+	} else if (cyaml__digit_value(str[0]) >= 10) {
+		return false;
+	}
+
+	for (; *str != '\0'; str++) {
+		unsigned digit = cyaml__digit_value(*str);
+
+		if (digit >= base) {
+			return false;
+		}
+		if (value > (UINT64_MAX - digit) / base) {
+			return false;
+		}
+		value = value * base + digit;
+	}
+
+	*out = value;
+	return true;
+}
+
+/* Exported function, documented in number.h. */
+cyaml_number_result_t cyaml__number_parse_int(
+		const char *str,
+		int64_t *out)
+{
+	uint64_t magnitude;
+	bool negative = false;
+	const char *pos = str;
+	long long temp;
+	char *end = NULL;
+
+	if (*pos == '-' || *pos == '+') {
+		negative = (*pos == '-');
+		pos++;
+	}
+
+	if (cyaml__parse_magnitude(pos, &magnitude)) {
+		if (negative && magnitude <= (uint64_t)INT64_MAX + 1) {
+			*out = (int64_t)(0 - magnitude);
+			return CYAML_NUMBER_OK;
+		} else if (!negative && magnitude <= INT64_MAX) {
+			*out = (int64_t)magnitude;
+			return CYAML_NUMBER_OK;
+		}
+	}
+
+	errno = 0;
+	temp = strtoll(str, &end, 0);
+
+	if (end == str || end == NULL || *end != '\0') {
+		return CYAML_NUMBER_INVALID;
+	} else if (errno == ERANGE) {
+		return CYAML_NUMBER_RANGE;
+	}
+
+	*out = (int64_t)temp;
+	return CYAML_NUMBER_OK;
+}
+
+/* Exported function, documented in number.h. */
+cyaml_number_result_t cyaml__number_parse_uint(
+		const char *str,
+		uint64_t *out)
+{
+	unsigned long long temp;
+	char *end = NULL;
+
+	/* Negative values are left to the C library, which negates them. */
+	if (cyaml__parse_magnitude(str + (*str == '+'), out)) {
+		return CYAML_NUMBER_OK;
+	}
+
+	errno = 0;
+	temp = strtoull(str, &end, 0);
+
+	if (end == str || end == NULL || *end != '\0') {
+		return CYAML_NUMBER_INVALID;
+	} else if (errno == ERANGE) {
+		return CYAML_NUMBER_RANGE;
+	}
+
+	*out = (uint64_t)temp;
+	return CYAML_NUMBER_OK;
+}
+
+/** Largest significand that converts to double exactly. */
+#define CYAML_DOUBLE_EXACT_MAX ((uint64_t)1 << 53)
+
+/** Largest power of ten that is exactly representable as a double. */
+#define CYAML_DOUBLE_EXACT_POW10_MAX 22
+
+/**
+ * Parse a floating point value, without using the C library.
+ *
+ * This is Clinger's fast path.  It handles plain decimal strings, where
+ * the significand and power of ten are both exactly representable as
+ * doubles, so only one rounding happens.  Anything else is left to the
+ * C library.
+ *
+ * \param[in]  str  The string to parse.
+ * \param[out] out  Returns the parsed value on success.
+ * \return true if the string was parsed, false otherwise.
+ */
+static bool cyaml__parse_double_fast(
+		const char *str,
+		double *out)
+{
+	static const double pow10[CYAML_DOUBLE_EXACT_POW10_MAX + 1] = {
+		1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+		1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+		1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+	};
+	bool negative = false;
+	uint64_t significand = 0;
+	unsigned digits = 0;
+	int exp10 = 0;
+	double value;
+
+#if !defined(FLT_EVAL_METHOD) || FLT_EVAL_METHOD != 0
+	/* Excess precision would round twice. */
+	return false;
+#endif
+
+	if (*str == '-' || *str == '+') {
+		negative = (*str == '-');
+		str++;
+	}
+
+	for (; *str >= '0' && *str <= '9'; str++, digits++) {
+		if (significand >= CYAML_DOUBLE_EXACT_MAX / 10) {
+			return false;
+		}
+		significand = significand * 10 + (uint64_t)(*str - '0');
+	}
+	if (*str == '.') {
+		for (str++; *str >= '0' && *str <= '9'; str++, digits++) {
+			if (significand >= CYAML_DOUBLE_EXACT_MAX / 10) {
+				return false;
+			}
+			significand = significand * 10 + (uint64_t)(*str - '0');
+			exp10--;
+		}
+	}
+	if (digits == 0) {
+		return false;
+	}
+
+	if (*str == 'e' || *str == 'E') {
+		bool exp_negative = false;
+		int exp = 0;
+
+		str++;
+		if (*str == '-' || *str == '+') {
+			exp_negative = (*str == '-');
+			str++;
+		}
+		if (*str < '0' || *str > '9') {
+			return false;
+		}
+		for (; *str >= '0' && *str <= '9'; str++) {
+			if (exp > 1000) {
+				return false;
+			}
+			exp = exp * 10 + (*str - '0');
+		}
+		exp10 += exp_negative ? -exp : exp;
+	}
+	if (*str != '\0') {
+		return false;
+	}
+
+	value = (double)significand;
+	if (exp10 < 0) {
+		if (exp10 < -CYAML_DOUBLE_EXACT_POW10_MAX) {
+			return false;
+		}
+		value /= pow10[-exp10];
+	} else if (exp10 > 0) {
+		if (exp10 > CYAML_DOUBLE_EXACT_POW10_MAX) {
+			return false;
+		}
+		value *= pow10[exp10];
+	}
+
+	*out = negative ? -value : value;
+	return true;
+}
+
+/* Exported function, documented in number.h. */
+cyaml_number_result_t cyaml__number_parse_double(
+		const char *str,
+		double *out)
+{
+	char *end = NULL;
+	double temp;
+
+	if (cyaml__parse_double_fast(str, out)) {
+		return CYAML_NUMBER_OK;
+	}
+
+	errno = 0;
+	temp = strtod(str, &end);
+
+	if (end == str || end == NULL || *end != '\0') {
+		return CYAML_NUMBER_INVALID;
+	}
+
+	*out = temp;
+	return (errno == ERANGE) ? CYAML_NUMBER_RANGE : CYAML_NUMBER_OK;
+}
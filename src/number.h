@@ -0,0 +1,124 @@
+/*
+ * SPDX-License-Identifier: ISC
+ *
+ * Copyright (C) 2026 Michael Drake <tlsa@netsurf-browser.org>
+ */
+
+/**
+ * \file
+ * \brief CYAML number formatting and parsing.
+ *
+ * These functions are reentrant; they write to a buffer owned by the caller.
+ */
+
+#ifndef CYAML_NUMBER_H
+#define CYAML_NUMBER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/** Result of parsing a number. */
+typedef enum cyaml_number_result {
+	CYAML_NUMBER_OK,      /**< Number parsed successfully. */
+	CYAML_NUMBER_INVALID, /**< String is not a valid number. */
+	CYAML_NUMBER_RANGE,   /**< Number is out of range for the type. */
+} cyaml_number_result_t;
+
+/** Size of buffer needed by the number formatting functions. */
+#define CYAML_NUMBER_STR_MAX 32
+
+/**
+ * Convert a signed integer to a decimal string.
+ *
+ * \param[in]  value   The integer to convert.
+ * \param[out] buffer  Buffer of \ref CYAML_NUMBER_STR_MAX bytes to use.
+ * \return '\0' terminated string conversion of the value, within `buffer`.
+ */
+const char * cyaml__number_format_int(
+		int64_t value,
+		char buffer[CYAML_NUMBER_STR_MAX]);
+
+/**
+ * Convert an unsigned integer to a string.
+ *
+ * \param[in]  value   The integer to convert.
+ * \param[in]  hex     Whether to render the number as `0x` prefixed hex.
+ * \param[out] buffer  Buffer of \ref CYAML_NUMBER_STR_MAX bytes to use.
+ * \return '\0' terminated string conversion of the value, within `buffer`.
+ */
+const char * cyaml__number_format_uint(
+		uint64_t value,
+		bool hex,
+		char buffer[CYAML_NUMBER_STR_MAX]);
+
+/**
+ * Convert a single precision floating point value to a string.
+ *
+ * The string has the fewest digits that will be read back as the same
+ * single precision value.
+ *
+ * \param[in]  value   The value to convert.
+ * \param[out] buffer  Buffer of \ref CYAML_NUMBER_STR_MAX bytes to use.
+ * \return '\0' terminated string conversion of the value, within `buffer`.
+ */
+const char * cyaml__number_format_float(
+		float value,
+		char buffer[CYAML_NUMBER_STR_MAX]);
+
+/**
+ * Convert a double precision floating point value to a string.
+ *
+ * The string has the fewest digits that will be read back as the same
+ * double precision value.
+ *
+ * \param[in]  value   The value to convert.
+ * \param[out] buffer  Buffer of \ref CYAML_NUMBER_STR_MAX bytes to use.
+ * \return '\0' terminated string conversion of the value, within `buffer`.
+ */
+const char * cyaml__number_format_double(
+		double value,
+		char buffer[CYAML_NUMBER_STR_MAX]);
+
+/**
+ * Parse a signed integer.
+ *
+ * Accepts the same strings as `strtoll` with base zero: decimal, `0x`
+ * prefixed hex, and `0` prefixed octal.  The whole string must be used.
+ *
+ * \param[in]  str  The '\0' terminated string to parse.
+ * \param[out] out  Returns the parsed value on success.
+ * \return \ref CYAML_NUMBER_OK on success, or appropriate result otherwise.
+ */
+cyaml_number_result_t cyaml__number_parse_int(
+		const char *str,
+		int64_t *out);
+
+/**
+ * Parse an unsigned integer.
+ *
+ * Accepts the same strings as `strtoull` with base zero: decimal, `0x`
+ * prefixed hex, and `0` prefixed octal.  The whole string must be used.
+ *
+ * \param[in]  str  The '\0' terminated string to parse.
+ * \param[out] out  Returns the parsed value on success.
+ * \return \ref CYAML_NUMBER_OK on success, or appropriate result otherwise.
+ */
+cyaml_number_result_t cyaml__number_parse_uint(
+		const char *str,
+		uint64_t *out);
+
+/**
+ * Parse a double precision floating point value.
+ *
+ * Accepts the same strings as `strtod`.  The whole string must be used.
+ *
+ * \param[in]  str  The '\0' terminated string to parse.
+ * \param[out] out  Returns the parsed value on success.  Also set for
+ *                  \ref CYAML_NUMBER_RANGE, to the value `strtod` gave.
+ * \return \ref CYAML_NUMBER_OK on success, or appropriate result otherwise.
+ */
+cyaml_number_result_t cyaml__number_parse_double(
+		const char *str,
+		double *out);
+
+#endif
@@ -0,0 +1,286 @@
+/*
+ * SPDX-License-Identifier: ISC
+ *
+ * Copyright (C) 2026 Michael Drake <tlsa@netsurf-browser.org>
+ */
+
+/**
+ * \file
+ * \brief CYAML parallel loading helpers.
+ *
+ * Large documents with a top level block sequence can be split into chunks
+ * of sequence entries, which can be loaded on separate threads.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <limits.h>
+#include <assert.h>
+#include <string.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <pthread.h>
+#include <unistd.h>
+#define CYAML_HAVE_PTHREAD 1
+#else
+#define CYAML_HAVE_PTHREAD 0
+#endif
+
+#include "parallel.h"
+
+/* Exported function, documented in parallel.h. */
+unsigned cyaml__parallel_threads(
+		const cyaml_config_t *config)
+{
+	if (config->load_threads != 0) {
+		return config->load_threads;
+	}
+
+#if CYAML_HAVE_PTHREAD && defined(_SC_NPROCESSORS_ONLN)
+	{
+		long online = sysconf(_SC_NPROCESSORS_ONLN);
+
+		if (online > 0) {
+			return (online > UINT_MAX) ? UINT_MAX :
+					(unsigned)online;
+		}
+	}
+#endif
+
+	return 1;
+}
+
+/**
+ * Check whether a character ends a YAML indicator.
+ *
+ * \param[in]  line  The line the indicator is at the start of.
+ * \param[in]  len   Number of bytes remaining in the input.
+ * \param[in]  pos   Offset of the character after the indicator.
+ * \return true if the indicator is followed by white space or a line break,
+ *         or is at the end of the input.
+ */
+static inline bool cyaml__parallel_is_sep(
+		const uint8_t *line,
+		size_t len,
+		size_t pos)
+{
+	if (len <= pos) {
+		return true;
+	}
+
+	switch (line[pos]) {
+	case ' ':  /* Fall through. */
+	case '\t': /* Fall through. */
+	case '\r': /* Fall through. */
+	case '\n':
+		return true;
+	default:
+		return false;
+	}
+}
+
+/**
+ * Check whether a line starts with a block sequence entry indicator.
+ *
+ * \param[in]  line  The start of the line.
+ * \param[in]  len   Number of bytes remaining in the input.
+ * \return true if the line starts a block sequence entry.
+ */
+static inline bool cyaml__parallel_is_entry(
+		const uint8_t *line,
+		size_t len)
+{
+	return len >= 1 && line[0] == '-' &&
+			cyaml__parallel_is_sep(line, len, 1);
+}
+
+/**
+ * Check whether a line is a document start or end marker.
+ *
+ * \param[in]  line  The start of the line.
+ * \param[in]  len   Number of bytes remaining in the input.
+ * \return true if the line is a document marker.
+ */
+static inline bool cyaml__parallel_is_marker(
+		const uint8_t *line,
+		size_t len)
+{
+	if (len < 3) {
+		return false;
+	}
+
+	if (memcmp(line, "---", 3) != 0 && memcmp(line, "...", 3) != 0) {
+		return false;
+	}
+
+	return cyaml__parallel_is_sep(line, len, 3);
+}
+
+/**
+ * Check whether a line has no content.
+ *
+ * \param[in]  line  The start of the line.
+ * \param[in]  len   Number of bytes remaining in the input.
+ * \return true if the line is empty, white space, or a comment.
+ */
+static bool cyaml__parallel_is_blank(
+		const uint8_t *line,
+		size_t len)
+{
+	for (size_t i = 0; i < len; i++) {
+		switch (line[i]) {
+		case ' ':  /* Fall through. */
+		case '\t':
+			break;
+		case '\r': /* Fall through. */
+		case '\n': /* Fall through. */
+		case '#':
+			return true;
+		default:
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/**
+ * Get the offset of the start of the next line.
+ *
+ * \param[in]  input      The YAML input.
+ * \param[in]  input_len  Length of input in bytes.
+ * \param[in]  pos        Offset into the current line.
+ * \return the offset of the next line, or `input_len` if there isn't one.
+ */
+static inline size_t cyaml__parallel_next_line(
+		const uint8_t *input,
+		size_t input_len,
+		size_t pos)
+{
+	const uint8_t *nl = memchr(input + pos, '\n', input_len - pos);
+
+	if (nl == NULL) {
+		return input_len;
+	}
+
+	return (size_t)(nl - input) + 1;
+}
+
+/* Exported function, documented in parallel.h. */
+unsigned cyaml__parallel_split(
+		const uint8_t *input,
+		size_t input_len,
+		unsigned chunks_max,
+		size_t *offsets)
+{
+	static const uint8_t bom[] = { 0xef, 0xbb, 0xbf };
+	unsigned count = 1;
+	size_t pos = 0;
+
+	assert(chunks_max <= CYAML_PARALLEL_CHUNKS_MAX);
+
+	offsets[0] = 0;
+	if (chunks_max < 2) {
+		return 1;
+	}
+
+	if (input_len >= sizeof(bom) && memcmp(input, bom, sizeof(bom)) == 0) {
+		pos = sizeof(bom);
+	}
+
+	/* Skip any leading blank lines and comments. */
+	while (pos < input_len &&
+	       cyaml__parallel_is_blank(input + pos, input_len - pos)) {
+		pos = cyaml__parallel_next_line(input, input_len, pos);
+	}
+
+	if (!cyaml__parallel_is_entry(input + pos, input_len - pos)) {
+		return 1;
+	}
+
+	/* Check every line for document markers, and take the first top
+	 * level entry at or after each split target as a chunk start. */
+	while (pos < input_len) {
+		const uint8_t *line = input + pos;
+		size_t len = input_len - pos;
+
+		if (cyaml__parallel_is_marker(line, len)) {
+			return 1;
+		}
+
+		if (count < chunks_max &&
+		    pos >= input_len / chunks_max * count &&
+		    cyaml__parallel_is_entry(line, len)) {
+			offsets[count++] = pos;
+		}
+
+		pos = cyaml__parallel_next_line(input, input_len, pos);
+	}
+
+	return count;
+}
+
+#if CYAML_HAVE_PTHREAD
+/** A job to run on a thread. */
+typedef struct cyaml_parallel_task {
+	cyaml_parallel_fn_t fn; /**< Job function. */
+	void *job;              /**< The job. */
+} cyaml_parallel_task_t;
+
+/**
+ * Thread start routine.
+ *
+ * \param[in]  ctx  The \ref cyaml_parallel_task_t to run.
+ * \return NULL.
+ */
+static void * cyaml__parallel_thread(void *ctx)
+{
+	cyaml_parallel_task_t *task = ctx;
+
+	task->fn(task->job);
+
+	return NULL;
+}
+#endif
+
+/* Exported function, documented in parallel.h. */
+void cyaml__parallel_run(
+		cyaml_parallel_fn_t fn,
+		void *jobs,
+		size_t job_size,
+		unsigned count)
+{
+	uint8_t *job = jobs;
+#if CYAML_HAVE_PTHREAD
+	cyaml_parallel_task_t tasks[CYAML_PARALLEL_CHUNKS_MAX];
+	pthread_t threads[CYAML_PARALLEL_CHUNKS_MAX];
+	bool started[CYAML_PARALLEL_CHUNKS_MAX];
+
+	assert(count <= CYAML_PARALLEL_CHUNKS_MAX);
+
+	for (unsigned i = 1; i < count; i++) {
+		tasks[i].fn = fn;
+		tasks[i].job = job + job_size * i;
+		started[i] = (pthread_create(&threads[i], NULL,
+				cyaml__parallel_thread, &tasks[i]) == 0);
+	}
+
+	if (count > 0) {
+		fn(job);
+	}
+
+	for (unsigned i = 1; i < count; i++) {
+		if (started[i]) {
+			pthread_join(threads[i], NULL);
+		} else {
+			fn(job + job_size * i);
+		}
+	}
+#else
+	for (unsigned i = 0; i < count; i++) {
+		fn(job + job_size * i);
+	}
+#endif
+}
@@ -0,0 +1,86 @@
+/*
+ * SPDX-License-Identifier: ISC
+ *
+ * Copyright (C) 2026 Michael Drake <tlsa@netsurf-browser.org>
+ */
+
+/**
+ * \file
+ * \brief CYAML parallel loading helpers.
+ */
+
+#ifndef CYAML_PARALLEL_H
+#define CYAML_PARALLEL_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "cyaml/cyaml.h"
+
+/** Maximum number of chunks a parallel load is split into. */
+#define CYAML_PARALLEL_CHUNKS_MAX 64
+
+/**
+ * Parallel job function.
+ *
+ * \param[in]  job  The job to run.
+ */
+typedef void (*cyaml_parallel_fn_t)(void *job);
+
+/**
+ * Get the number of threads to use for a parallel load.
+ *
+ * \param[in]  config  The CYAML client config.
+ * \return the number of threads to use, at least one.
+ */
+unsigned cyaml__parallel_threads(
+		const cyaml_config_t *config);
+
+/**
+ * Split a YAML input at top level block sequence entry boundaries.
+ *
+ * This is a heuristic pre-scan, which doesn't tokenise the input.  It looks
+ * for lines that start with a block sequence entry indicator in the first
+ * column.  That is always a top level entry, unless it is inside a quoted
+ * or flow scalar that spans lines, so each chunk must be checked by parsing
+ * it on its own.
+ *
+ * The input is not split if it doesn't start with a block sequence entry,
+ * or if it has directives or document markers.
+ *
+ * \param[in]  input       The YAML input.
+ * \param[in]  input_len   Length of input in bytes.
+ * \param[in]  chunks_max  Maximum number of chunks to split the input into.
+ *                         Must be no more than \ref CYAML_PARALLEL_CHUNKS_MAX.
+ * \param[out] offsets     Returns the start offset of each chunk.  Each
+ *                         chunk ends where the next starts, and the last
+ *                         chunk ends at the end of the input.
+ * \return the number of chunks, or one if the input should not be split.
+ */
+unsigned cyaml__parallel_split(
+		const uint8_t *input,
+		size_t input_len,
+		unsigned chunks_max,
+		size_t *offsets);
+
+/**
+ * Run jobs in parallel.
+ *
+ * The first job is run on the calling thread, and the others are each run
+ * on a thread of their own.  Any jobs that a thread can't be created for
+ * are run on the calling thread.  Returns when all the jobs are complete.
+ *
+ * \param[in]  fn        The function to run each job with.
+ * \param[in]  jobs      Array of jobs.
+ * \param[in]  job_size  Size of each job in bytes.
+ * \param[in]  count     Number of jobs.  Must be no more than
+ *                       \ref CYAML_PARALLEL_CHUNKS_MAX.
+ */
+void cyaml__parallel_run(
+		cyaml_parallel_fn_t fn,
+		void *jobs,
+		size_t job_size,
+		unsigned count);
+
+#endif
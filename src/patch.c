@@ -0,0 +1,1369 @@
+/*
+ * SPDX-License-Identifier: ISC
+ *
+ * Copyright (C) 2026 Michael Drake <tlsa@netsurf-browser.org>
+ */
+
+/**
+ * \file
+ * \brief Update a document's YAML input to modified client data.
+ *
+ * The input is parsed again, and its events are walked alongside the
+ * schema and two versions of the client data: the data that was loaded
+ * from the input, and a modified copy of it.  Subtrees that are the same
+ * in both are skipped.  Changed subtrees are descended into, down to the
+ * scalar values that changed, and the YAML of each of those is replaced
+ * in the input, using the event marks to find its bytes.
+ */
+
+/* For mkstemp, fchmod and fsync. */
+#define _POSIX_C_SOURCE 200809L
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <limits.h>
+#include <string.h>
+#include <stdio.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/stat.h>
+#include <unistd.h>
+#define CYAML_HAVE_FSYNC 1
+#else
+#define CYAML_HAVE_FSYNC 0
+#endif
+
+#include <yaml.h>
+
+#include "mem.h"
+#include "data.h"
+#include "util.h"
+#include "schema.h"
+#include "number.h"
+
+/** Minimum number of edits to allocate space for. */
+#define CYAML_PATCH_EDITS_MIN 8
+
+/** Minimum size of the buffer a file is read into. */
+#define CYAML_PATCH_FILE_MIN 4096
+
+/** Suffix for the name of the temporary file a patched file is written to. */
+#define CYAML_PATCH_TEMP_SUFFIX ".XXXXXX"
+
+/** CYAML patch context. */
+typedef struct cyaml_patch_ctx {
+	/** The client's CYAML library config. */
+	const cyaml_config_t *config;
+	const uint8_t *input;       /**< The YAML input being patched. */
+	size_t input_len;           /**< Length of `input` in bytes. */
+	yaml_parser_t parser;       /**< Parser for `input`. */
+	yaml_event_t event;         /**< The current event. */
+	bool have_event;            /**< Whether `event` needs deleting. */
+	size_t index;               /**< Mark index `offset` is for. */
+	size_t offset;              /**< Byte offset of `index` in input. */
+	cyaml_patch_edit_t *edits;  /**< Edits made so far, in input order. */
+	unsigned count;             /**< Number of entries used in `edits`. */
+	unsigned size;              /**< Number of entries allocated. */
+} cyaml_patch_ctx_t;
+
+/**
+ * Log that a change can't be patched into the input.
+ *
+ * \param[in]  ctx     The CYAML patch context.
+ * \param[in]  reason  Description of the change.
+ * \return \ref CYAML_ERR_PATCH_UNSUPPORTED.
+ */
+static cyaml_err_t cyaml__patch_unsupported(
+		const cyaml_patch_ctx_t *ctx,
+		const char *reason)
+{
+	cyaml__log(ctx->config, CYAML_LOG_DEBUG,
+			"Patch: Can't patch %s (line: %zu)\n", reason,
+			ctx->event.start_mark.line + 1);
+	return CYAML_ERR_PATCH_UNSUPPORTED;
+}
+
+/**
+ * Parse the next event from the input.
+ *
+ * \param[in]  ctx  The CYAML patch context.
+ * \return \ref CYAML_OK on success, or appropriate error code otherwise.
+ */
+static cyaml_err_t cyaml__patch_next(
+		cyaml_patch_ctx_t *ctx)
+{
+	if (ctx->have_event) {
+		yaml_event_delete(&ctx->event);
+		ctx->have_event = false;
+	}
+
+	if (!yaml_parser_parse(&ctx->parser, &ctx->event)) {
+		cyaml__log(ctx->config, CYAML_LOG_ERROR,
+				"Patch: LibYAML: %s\n", ctx->parser.problem);
+		return CYAML_ERR_LIBYAML_PARSER;
+	}
+	ctx->have_event = true;
+
+	return CYAML_OK;
+}
+
+/**
+ * Skip the rest of the node that starts with the current event.
+ *
+ * \param[in]  ctx  The CYAML patch context.
+ * \return \ref CYAML_OK on success, or appropriate error code otherwise.
+ */
+static cyaml_err_t cyaml__patch_skip(
+		cyaml_patch_ctx_t *ctx)
+{
+	unsigned level = 0;
+
+	do {
+		switch (ctx->event.type) {
+		case YAML_SEQUENCE_START_EVENT: /* Fall through. */
+		case YAML_MAPPING_START_EVENT:
+			level++;
+			break;
+		case YAML_SEQUENCE_END_EVENT: /* Fall through. */
+		case YAML_MAPPING_END_EVENT:
+			level--;
+			break;
+		default:
+			break;
+		}
+
+		if (level != 0) {
+			cyaml_err_t err = cyaml__patch_next(ctx);
+			if (err != CYAML_OK) {
+				return err;
+			}
+		}
+	} while (level != 0);
+
+	return CYAML_OK;
+}
+
+/**
+ * Get the byte offset into the input of an event mark.
+ *
+ * `libyaml` counts characters, so the input is walked to find the offset.
+ * Marks are looked up in input order, so the walk continues from the
+ * previous offset.
+ *
+ * \param[in]  ctx    The CYAML patch context.
+ * \param[in]  index  The mark index to get the offset for.
+ * \return the byte offset into the input.
+ */
+static size_t cyaml__patch_offset(
+		cyaml_patch_ctx_t *ctx,
+		size_t index)
+{
+	while (ctx->index < index && ctx->offset < ctx->input_len) {
+		do {
+			ctx->offset++;
+		} while (ctx->offset < ctx->input_len &&
+		         (ctx->input[ctx->offset] & 0xc0) == 0x80);
+		ctx->index++;
+	}
+
+	return ctx->offset;
+}
+
+/**
+ * Get the anchor of a node's first event.
+ *
+ * \param[in]  event  The event to get the anchor of.
+ * \return the anchor, or NULL if the node has no anchor.
+ */
+static const yaml_char_t * cyaml__patch_anchor(
+		const yaml_event_t *event)
+{
+	switch (event->type) {
+	case YAML_SCALAR_EVENT:
+		return event->data.scalar.anchor;
+	case YAML_SEQUENCE_START_EVENT:
+		return event->data.sequence_start.anchor;
+	case YAML_MAPPING_START_EVENT:
+		return event->data.mapping_start.anchor;
+	default:
+		break;
+	}
+
+	return NULL;
+}
+
+static bool cyaml__patch_equal(
+		const cyaml_config_t *config,
+		const cyaml_schema_value_t *schema,
+		const uint8_t *a,
+		const uint8_t *b,
+		uint64_t count);
+
+/**
+ * Read the entry count of a mapping field's sequence value.
+ *
+ * \param[in]  field    The mapping field.
+ * \param[in]  data     The mapping's client data.
+ * \param[in]  columns  For entries of a \ref CYAML_FLAG_COLUMNAR
+ *                      sequence, the sequence entry count, or zero.
+ * \param[in]  column   Index of this entry in the columns.
+ * \param[out] err      Returns the error code.  \ref CYAML_OK on success,
+ *                      or appropriate error otherwise.
+ * \return the entry count, or zero for fields that aren't sequences.
+ */
+static uint64_t cyaml__patch_field_count(
+		const cyaml_schema_field_t *field,
+		const uint8_t *data,
+		uint64_t columns,
+		uint64_t column,
+		cyaml_err_t *err)
+{
+	*err = CYAML_OK;
+	if (field->value.type != CYAML_SEQUENCE ||
+	    (field->value.flags & CYAML_FLAG_LAZY)) {
+		return 0;
+	}
+
+	return cyaml_data_read(field->count_size,
+			data + cyaml_data_member_offset(
+				field->count_offset, field->count_size,
+				columns, column), err);
+}
+
+/**
+ * Compare two versions of a mapping's client data.
+ *
+ * \param[in]  config   The client's CYAML library config.
+ * \param[in]  schema   The schema for the mapping.
+ * \param[in]  a        The first version of the mapping's data.
+ * \param[in]  b        The second version of the mapping's data.
+ * \param[in]  columns  For entries of a \ref CYAML_FLAG_COLUMNAR
+ *                      sequence, the sequence entry count, or zero.
+ * \param[in]  column   Index of this entry in the columns.
+ * \return true if the versions are the same, false otherwise.
+ */
+static bool cyaml__patch_equal_mapping(
+		const cyaml_config_t *config,
+		const cyaml_schema_value_t *schema,
+		const uint8_t *a,
+		const uint8_t *b,
+		uint64_t columns,
+		uint64_t column)
+{
+	const cyaml_schema_field_t *field = schema->mapping.fields;
+
+	for (; field->key != NULL; field++) {
+		const cyaml_schema_value_t *value = &field->value;
+		uint64_t count_a;
+		uint64_t count_b;
+		cyaml_err_t err;
+		size_t offset;
+
+		if (value->type == CYAML_IGNORE) {
+			continue;
+		}
+
+		count_a = cyaml__patch_field_count(field, a,
+				columns, column, &err);
+		if (err != CYAML_OK) {
+			return false;
+		}
+		count_b = cyaml__patch_field_count(field, b,
+				columns, column, &err);
+		if (err != CYAML_OK || count_a != count_b) {
+			return false;
+		}
+
+		offset = cyaml_data_member_offset(field->data_offset,
+				cyaml_data_member_size(value),
+				columns, column);
+		if (!cyaml__patch_equal(config, value,
+				a + offset, b + offset, count_a)) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/**
+ * Compare two versions of a sequence's entries.
+ *
+ * \param[in]  config  The client's CYAML library config.
+ * \param[in]  schema  The schema for the sequence.
+ * \param[in]  a       The first version of the sequence's entries.
+ * \param[in]  b       The second version of the sequence's entries.
+ * \param[in]  count   The sequence entry count.
+ * \return true if the versions are the same, false otherwise.
+ */
+static bool cyaml__patch_equal_entries(
+		const cyaml_config_t *config,
+		const cyaml_schema_value_t *schema,
+		const uint8_t *a,
+		const uint8_t *b,
+		uint64_t count)
+{
+	const cyaml_schema_value_t *value = schema->sequence.entry;
+	bool columnar = (schema->flags & CYAML_FLAG_COLUMNAR) &&
+			cyaml_data_columnar_valid(schema);
+	uint64_t seq_count = 0;
+	size_t data_size;
+
+	if (value->type == CYAML_SEQUENCE_FIXED) {
+		seq_count = value->sequence.max;
+	}
+
+	if (value->flags & CYAML_FLAG_POINTER) {
+		data_size = sizeof(NULL);
+	} else {
+		data_size = value->data_size;
+		if (value->type == CYAML_SEQUENCE_FIXED) {
+			data_size *= seq_count;
+		}
+	}
+
+	for (uint64_t i = 0; i < count; i++) {
+		bool equal;
+
+		if (columnar) {
+			equal = cyaml__patch_equal_mapping(config, value,
+					a, b, count, i);
+		} else {
+			equal = cyaml__patch_equal(config, value,
+					a + data_size * i,
+					b + data_size * i, seq_count);
+		}
+		if (!equal) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/**
+ * Compare two versions of a value's client data.
+ *
+ * \param[in]  config  The client's CYAML library config.
+ * \param[in]  schema  The schema for the value.
+ * \param[in]  a       The first version of the value's data.
+ * \param[in]  b       The second version of the value's data.
+ * \param[in]  count   Entry count for sequence values.  Unused for
+ *                     non-sequence values.
+ * \return true if the versions are the same, false otherwise.
+ */
+static bool cyaml__patch_equal(
+		const cyaml_config_t *config,
+		const cyaml_schema_value_t *schema,
+		const uint8_t *a,
+		const uint8_t *b,
+		uint64_t count)
+{
+	if (schema->flags & CYAML_FLAG_LAZY) {
+		return memcmp(a, b, sizeof(cyaml_lazy_t)) == 0;
+	}
+
+	if (schema->flags & CYAML_FLAG_POINTER) {
+		a = cyaml_data_read_pointer(a);
+		b = cyaml_data_read_pointer(b);
+		if (a == b) {
+			return true;
+		} else if (a == NULL || b == NULL) {
+			return false;
+		}
+	}
+
+	switch (schema->type) {
+	case CYAML_INT:      /* Fall through. */
+	case CYAML_UINT:     /* Fall through. */
+	case CYAML_BOOL:     /* Fall through. */
+	case CYAML_ENUM:     /* Fall through. */
+	case CYAML_FLAGS:    /* Fall through. */
+	case CYAML_FLOAT:    /* Fall through. */
+	case CYAML_BITFIELD:
+		return memcmp(a, b, schema->data_size) == 0;
+	case CYAML_STRING:
+		return strcmp((const char *)a, (const char *)b) == 0;
+	case CYAML_MAPPING:
+		return cyaml__patch_equal_mapping(config, schema, a, b, 0, 0);
+	case CYAML_SEQUENCE_FIXED:
+		count = schema->sequence.max;
+		/* Fall through. */
+	case CYAML_SEQUENCE:
+		return cyaml__patch_equal_entries(config, schema, a, b, count);
+	case CYAML_IGNORE:
+		return true;
+	default:
+		break;
+	}
+
+	return false;
+}
+
+/**
+ * Get the YAML text for a scalar value.
+ *
+ * \param[in]  ctx     The CYAML patch context.
+ * \param[in]  schema  The schema for the value.
+ * \param[in]  data    The value's client data.
+ * \param[out] buffer  Buffer to use for numbers.
+ * \param[out] err     Returns the error code.  \ref CYAML_OK on success,
+ *                     or appropriate error otherwise.
+ * \return the value's text, or NULL on error.
+ */
+static const char * cyaml__patch_scalar_str(
+		const cyaml_patch_ctx_t *ctx,
+		const cyaml_schema_value_t *schema,
+		const uint8_t *data,
+		char buffer[CYAML_NUMBER_STR_MAX],
+		cyaml_err_t *err)
+{
+	const cyaml_strval_t *strings;
+	const cyaml_schema_names_t *names;
+	uint64_t raw;
+
+	*err = CYAML_OK;
+
+	switch (schema->type) {
+	case CYAML_STRING:
+		return (const char *)data;
+	case CYAML_FLOAT:
+		if (schema->data_size == sizeof(float)) {
+			float number;
+			memcpy(&number, data, schema->data_size);
+			return cyaml__number_format_float(number, buffer);
+		} else if (schema->data_size == sizeof(double)) {
+			double number;
+			memcpy(&number, data, schema->data_size);
+			return cyaml__number_format_double(number, buffer);
+		}
+		*err = CYAML_ERR_INVALID_DATA_SIZE;
+		return NULL;
+	default:
+		break;
+	}
+
+	raw = cyaml_data_read(schema->data_size, data, err);
+	if (*err != CYAML_OK) {
+		return NULL;
+	}
+
+	switch (schema->type) {
+	case CYAML_UINT:
+		return cyaml__number_format_uint(raw, false, buffer);
+	case CYAML_BOOL:
+		return raw ? "true" : "false";
+	case CYAML_ENUM:
+		strings = schema->enumeration.strings;
+		names = cyaml__schema_names(ctx->config, schema);
+		if (names != NULL) {
+			uint32_t i = cyaml__schema_names_value_idx(names,
+					(int64_t)raw);
+			if (i != CYAML_NAMES_IDX_NONE) {
+				return strings[i].str;
+			}
+		} else {
+			for (uint32_t i = 0;
+					i < schema->enumeration.count; i++) {
+				if ((int64_t)raw == strings[i].val) {
+					return strings[i].str;
+				}
+			}
+		}
+		if (schema->flags & CYAML_FLAG_STRICT) {
+			*err = CYAML_ERR_INVALID_VALUE;
+			return NULL;
+		}
+		/* Fall through. */
+	case CYAML_INT:
+		return cyaml__number_format_int(
+				cyaml_data_sign_pad(raw, schema->data_size),
+				buffer);
+	default:
+		break;
+	}
+
+	*err = CYAML_ERR_BAD_TYPE_IN_SCHEMA;
+	return NULL;
+}
+
+/**
+ * Check whether a string can be written as a plain scalar anywhere.
+ *
+ * This is deliberately conservative; anything that might need quoting in
+ * some context is rejected.
+ *
+ * \param[in]  str  The string to check.
+ * \return true if the string can be written plain, false otherwise.
+ */
+static bool cyaml__patch_plain_ok(
+		const char *str)
+{
+	size_t len = strlen(str);
+
+	if (len == 0 || str[0] == ' ' || str[len - 1] == ' ' ||
+	    (str[0] == '-' && (len == 1 || str[1] == ' '))) {
+		return false;
+	}
+
+	for (size_t i = 0; i < len; i++) {
+		char c = str[i];
+
+		if (!(c >= 'a' && c <= 'z') &&
+		    !(c >= 'A' && c <= 'Z') &&
+		    !(c >= '0' && c <= '9') &&
+		    strchr(" ._/+-", c) == NULL) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/**
+ * Check whether a string can be written as a single quoted scalar.
+ *
+ * \param[in]  str  The string to check.
+ * \return true if the string has no control characters, false otherwise.
+ */
+static bool cyaml__patch_single_ok(
+		const char *str)
+{
+	for (const uint8_t *c = (const uint8_t *)str; *c != '\0'; c++) {
+		if (*c < 0x20 || *c == 0x7f) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/**
+ * Write a string as a quoted scalar.
+ *
+ * \param[in]  str    The string to write.
+ * \param[in]  quote  The quote character; `'` or `"`.
+ * \param[out] out    Buffer to write the scalar to, or NULL to only
+ *                    measure it.
+ * \return the length of the quoted scalar in bytes.
+ */
+static size_t cyaml__patch_quote(
+		const char *str,
+		char quote,
+		char *out)
+{
+	static const char hex[] = "0123456789ABCDEF";
+	char escape[4];
+	size_t len = 0;
+
+	if (out != NULL) {
+		out[len] = quote;
+	}
+	len++;
+
+	for (const uint8_t *c = (const uint8_t *)str; *c != '\0'; c++) {
+		size_t escape_len = 1;
+
+		escape[0] = (char)*c;
+		if (quote == '\'') {
+			if (*c == '\'') {
+				escape[1] = '\'';
+				escape_len = 2;
+			}
+		} else if (*c == '"' || *c == '\\') {
+			escape[0] = '\\';
+			escape[1] = (char)*c;
+			escape_len = 2;
+		} else if (*c == '\n' || *c == '\t') {
+			escape[0] = '\\';
+			escape[1] = (*c == '\n') ? 'n' : 't';
+			escape_len = 2;
+		} else if (*c < 0x20 || *c == 0x7f) {
+			escape[0] = '\\';
+			escape[1] = 'x';
+			escape[2] = hex[*c >> 4];
+			escape[3] = hex[*c & 0xf];
+			escape_len = 4;
+		}
+
+		if (out != NULL) {
+			memcpy(out + len, escape, escape_len);
+		}
+		len += escape_len;
+	}
+
+	if (out != NULL) {
+		out[len] = quote;
+	}
+	len++;
+
+	return len;
+}
+
+/**
+ * Add an edit replacing the current scalar event's YAML.
+ *
+ * The scalar keeps its style where it can.  Plain scalars are quoted if
+ * the new value needs it, and single quoted scalars with control
+ * characters become double quoted.
+ *
+ * \param[in]  ctx  The CYAML patch context.
+ * \param[in]  str  The scalar's new value.
+ * \return \ref CYAML_OK on success, or appropriate error code otherwise.
+ */
+static cyaml_err_t cyaml__patch_add(
+		cyaml_patch_ctx_t *ctx,
+		const char *str)
+{
+	const yaml_event_t *event = &ctx->event;
+	yaml_scalar_style_t style = event->data.scalar.style;
+	size_t start;
+	size_t end;
+	size_t len;
+	char *text;
+	char quote;
+
+	if (style == YAML_LITERAL_SCALAR_STYLE ||
+	    style == YAML_FOLDED_SCALAR_STYLE) {
+		return cyaml__patch_unsupported(ctx, "block scalar");
+	} else if (event->data.scalar.tag != NULL) {
+		return cyaml__patch_unsupported(ctx, "tagged scalar");
+	}
+
+	start = cyaml__patch_offset(ctx, event->start_mark.index);
+	end = cyaml__patch_offset(ctx, event->end_mark.index);
+
+	if (style == YAML_PLAIN_SCALAR_STYLE && cyaml__patch_plain_ok(str)) {
+		quote = '\0';
+		len = strlen(str);
+	} else {
+		quote = '"';
+		if (style == YAML_SINGLE_QUOTED_SCALAR_STYLE &&
+		    cyaml__patch_single_ok(str)) {
+			quote = '\'';
+		}
+		len = cyaml__patch_quote(str, quote, NULL);
+	}
+
+	text = cyaml__alloc(ctx->config, len == 0 ? 1 : len, false);
+	if (text == NULL) {
+		return CYAML_ERR_OOM;
+	}
+	if (quote == '\0') {
+		memcpy(text, str, len);
+	} else {
+		cyaml__patch_quote(str, quote, text);
+	}
+
+	if (len == end - start && memcmp(ctx->input + start, text, len) == 0) {
+		cyaml__free(ctx->config, text);
+		return CYAML_OK;
+	}
+
+	if (ctx->count == ctx->size) {
+		unsigned size = ctx->size * 2;
+		cyaml_patch_edit_t *edits;
+
+		if (size < CYAML_PATCH_EDITS_MIN) {
+			size = CYAML_PATCH_EDITS_MIN;
+		}
+		edits = cyaml__realloc(ctx->config, ctx->edits,
+				sizeof(*edits) * ctx->size,
+				sizeof(*edits) * size, false);
+		if (edits == NULL) {
+			cyaml__free(ctx->config, text);
+			return CYAML_ERR_OOM;
+		}
+		ctx->edits = edits;
+		ctx->size = size;
+	}
+
+	cyaml__log(ctx->config, CYAML_LOG_INFO,
+			"Patch: Replace %zu bytes at %zu: %.*s\n",
+			end - start, start, (int)len, text);
+
+	ctx->edits[ctx->count++] = (cyaml_patch_edit_t) {
+		.offset = start,
+		.len = end - start,
+		.text = text,
+		.text_len = len,
+	};
+
+	return CYAML_OK;
+}
+
+static cyaml_err_t cyaml__patch_value(
+		cyaml_patch_ctx_t *ctx,
+		const cyaml_schema_value_t *schema,
+		const uint8_t *prev,
+		const uint8_t *data,
+		uint64_t count);
+
+/**
+ * Patch a changed mapping.
+ *
+ * The current event is the mapping's start event.  Fields that aren't in
+ * the input can't be patched, so they must be unchanged.
+ *
+ * \param[in]  ctx      The CYAML patch context.
+ * \param[in]  schema   The schema for the mapping.
+ * \param[in]  prev     The mapping's data as loaded from the input.
+ * \param[in]  data     The mapping's modified data.
+ * \param[in]  columns  For entries of a \ref CYAML_FLAG_COLUMNAR
+ *                      sequence, the sequence entry count, or zero.
+ * \param[in]  column   Index of this entry in the columns.
+ * \return \ref CYAML_OK on success, or appropriate error code otherwise.
+ */
+static cyaml_err_t cyaml__patch_mapping(
+		cyaml_patch_ctx_t *ctx,
+		const cyaml_schema_value_t *schema,
+		const uint8_t *prev,
+		const uint8_t *data,
+		uint64_t columns,
+		uint64_t column)
+{
+	const cyaml_schema_field_t *fields = schema->mapping.fields;
+	const cyaml_schema_mapping_t *compiled;
+	cyaml_err_t err = CYAML_OK;
+	uint16_t fields_count = 0;
+	bool *seen;
+
+	while (fields[fields_count].key != NULL) {
+		fields_count++;
+	}
+
+	seen = cyaml__alloc(ctx->config,
+			sizeof(*seen) * (fields_count + 1u), true);
+	if (seen == NULL) {
+		return CYAML_ERR_OOM;
+	}
+
+	compiled = cyaml__schema_mapping(ctx->config, schema);
+
+	while (err == CYAML_OK) {
+		const cyaml_schema_field_t *field;
+		uint16_t idx = CYAML_FIELDS_IDX_NONE;
+		const char *key;
+		uint64_t count_prev;
+		uint64_t count;
+		size_t offset;
+
+		err = cyaml__patch_next(ctx);
+		if (err != CYAML_OK) {
+			break;
+		} else if (ctx->event.type == YAML_MAPPING_END_EVENT) {
+			break;
+		} else if (ctx->event.type != YAML_SCALAR_EVENT) {
+			err = cyaml__patch_unsupported(ctx, "non-scalar key");
+			break;
+		}
+
+		key = (const char *)ctx->event.data.scalar.value;
+		if (compiled != NULL) {
+			idx = cyaml__schema_mapping_field_idx(compiled, key);
+		} else {
+			for (uint16_t i = 0; i < fields_count; i++) {
+				if (cyaml__strcmp(ctx->config, schema,
+						fields[i].key, key) == 0) {
+					idx = i;
+					break;
+				}
+			}
+		}
+
+		err = cyaml__patch_next(ctx);
+		if (err != CYAML_OK) {
+			break;
+		} else if (idx == CYAML_FIELDS_IDX_NONE) {
+			err = cyaml__patch_skip(ctx);
+			continue;
+		}
+
+		field = fields + idx;
+		seen[idx] = true;
+
+		count_prev = cyaml__patch_field_count(field, prev,
+				columns, column, &err);
+		if (err != CYAML_OK) {
+			break;
+		}
+		count = cyaml__patch_field_count(field, data,
+				columns, column, &err);
+		if (err != CYAML_OK) {
+			break;
+		} else if (count != count_prev) {
+			err = cyaml__patch_unsupported(ctx,
+					"sequence entry count change");
+			break;
+		}
+
+		offset = cyaml_data_member_offset(field->data_offset,
+				cyaml_data_member_size(&field->value),
+				columns, column);
+		err = cyaml__patch_value(ctx, &field->value,
+				prev + offset, data + offset, count);
+	}
+
+	/* Fields that aren't in the input have nowhere to be patched. */
+	for (uint16_t i = 0; err == CYAML_OK && i < fields_count; i++) {
+		const cyaml_schema_field_t *field = fields + i;
+		uint64_t count_prev;
+		uint64_t count;
+		size_t offset;
+
+		if (seen[i]) {
+			continue;
+		}
+
+		count_prev = cyaml__patch_field_count(field, prev,
+				columns, column, &err);
+		if (err != CYAML_OK) {
+			break;
+		}
+		count = cyaml__patch_field_count(field, data,
+				columns, column, &err);
+		if (err != CYAML_OK) {
+			break;
+		}
+
+		offset = cyaml_data_member_offset(field->data_offset,
+				cyaml_data_member_size(&field->value),
+				columns, column);
+		if (count != count_prev ||
+		    !cyaml__patch_equal(ctx->config, &field->value,
+				prev + offset, data + offset, count)) {
+			cyaml__log(ctx->config, CYAML_LOG_DEBUG,
+					"Patch: Can't patch field that isn't "
+					"in input: %s\n", field->key);
+			err = CYAML_ERR_PATCH_UNSUPPORTED;
+		}
+	}
+
+	cyaml__free(ctx->config, seen);
+	return err;
+}
+
+/**
+ * Patch the entries of a changed sequence.
+ *
+ * The current event is the sequence's start event.
+ *
+ * \param[in]  ctx     The CYAML patch context.
+ * \param[in]  schema  The schema for the sequence.
+ * \param[in]  prev    The sequence's entries as loaded from the input.
+ * \param[in]  data    The sequence's modified entries.
+ * \param[in]  count   The sequence entry count.
+ * \return \ref CYAML_OK on success, or appropriate error code otherwise.
+ */
+static cyaml_err_t cyaml__patch_entries(
+		cyaml_patch_ctx_t *ctx,
+		const cyaml_schema_value_t *schema,
+		const uint8_t *prev,
+		const uint8_t *data,
+		uint64_t count)
+{
+	const cyaml_schema_value_t *value = schema->sequence.entry;
+	bool columnar = (schema->flags & CYAML_FLAG_COLUMNAR) &&
+			cyaml_data_columnar_valid(schema);
+	uint64_t seq_count = 0;
+	cyaml_err_t err;
+	size_t data_size;
+
+	if (value->type == CYAML_SEQUENCE_FIXED) {
+		seq_count = value->sequence.max;
+	}
+
+	if (value->flags & CYAML_FLAG_POINTER) {
+		data_size = sizeof(NULL);
+	} else {
+		data_size = value->data_size;
+		if (value->type == CYAML_SEQUENCE_FIXED) {
+			data_size *= seq_count;
+		}
+	}
+
+	for (uint64_t i = 0; i < count; i++) {
+		err = cyaml__patch_next(ctx);
+		if (err != CYAML_OK) {
+			return err;
+		} else if (ctx->event.type == YAML_SEQUENCE_END_EVENT) {
+			return cyaml__patch_unsupported(ctx,
+					"sequence that doesn't match input");
+		}
+
+		if (!columnar) {
+			err = cyaml__patch_value(ctx, value,
+					prev + data_size * i,
+					data + data_size * i, seq_count);
+		} else if (cyaml__patch_equal_mapping(ctx->config, value,
+				prev, data, count, i)) {
+			err = cyaml__patch_skip(ctx);
+		} else if (ctx->event.type != YAML_MAPPING_START_EVENT ||
+		           cyaml__patch_anchor(&ctx->event) != NULL) {
+			err = cyaml__patch_unsupported(ctx, "mapping");
+		} else {
+			err = cyaml__patch_mapping(ctx, value,
+					prev, data, count, i);
+		}
+		if (err != CYAML_OK) {
+			return err;
+		}
+	}
+
+	err = cyaml__patch_next(ctx);
+	if (err == CYAML_OK && ctx->event.type != YAML_SEQUENCE_END_EVENT) {
+		err = cyaml__patch_unsupported(ctx,
+				"sequence that doesn't match input");
+	}
+
+	return err;
+}
+
+/**
+ * Patch a value.
+ *
+ * The current event is the first event of the value's node.  The value is
+ * skipped if it is unchanged.
+ *
+ * \param[in]  ctx     The CYAML patch context.
+ * \param[in]  schema  The schema for the value.
+ * \param[in]  prev    The value's data as loaded from the input.
+ * \param[in]  data    The value's modified data.
+ * \param[in]  count   Entry count for sequence values.  Unused for
+ *                     non-sequence values.
+ * \return \ref CYAML_OK on success, or appropriate error code otherwise.
+ */
+static cyaml_err_t cyaml__patch_value(
+		cyaml_patch_ctx_t *ctx,
+		const cyaml_schema_value_t *schema,
+		const uint8_t *prev,
+		const uint8_t *data,
+		uint64_t count)
+{
+	char buffer[CYAML_NUMBER_STR_MAX];
+	yaml_event_type_t type;
+	const char *str;
+	cyaml_err_t err;
+
+	if (cyaml__patch_equal(ctx->config, schema, prev, data, count)) {
+		return cyaml__patch_skip(ctx);
+	}
+
+	/* Changing an anchored value would change its aliases too. */
+	type = ctx->event.type;
+	if (type == YAML_ALIAS_EVENT) {
+		return cyaml__patch_unsupported(ctx, "aliased value");
+	} else if (cyaml__patch_anchor(&ctx->event) != NULL) {
+		return cyaml__patch_unsupported(ctx, "anchored value");
+	} else if (schema->flags & CYAML_FLAG_LAZY) {
+		return cyaml__patch_unsupported(ctx, "lazy value");
+	}
+
+	if (schema->flags & CYAML_FLAG_POINTER) {
+		prev = cyaml_data_read_pointer(prev);
+		data = cyaml_data_read_pointer(data);
+		if (prev == NULL || data == NULL) {
+			return cyaml__patch_unsupported(ctx, "NULL value");
+		}
+	}
+
+	switch (schema->type) {
+	case CYAML_MAPPING:
+		if (type != YAML_MAPPING_START_EVENT) {
+			break;
+		}
+		return cyaml__patch_mapping(ctx, schema, prev, data, 0, 0);
+	case CYAML_SEQUENCE_FIXED:
+		count = schema->sequence.max;
+		/* Fall through. */
+	case CYAML_SEQUENCE:
+		if (type != YAML_SEQUENCE_START_EVENT) {
+			break;
+		}
+		return cyaml__patch_entries(ctx, schema, prev, data, count);
+	case CYAML_INT:      /* Fall through. */
+	case CYAML_UINT:     /* Fall through. */
+	case CYAML_BOOL:     /* Fall through. */
+	case CYAML_ENUM:     /* Fall through. */
+	case CYAML_FLOAT:    /* Fall through. */
+	case CYAML_STRING:
+		if (type != YAML_SCALAR_EVENT) {
+			break;
+		}
+		str = cyaml__patch_scalar_str(ctx, schema, data, buffer, &err);
+		if (str == NULL) {
+			return err;
+		}
+		return cyaml__patch_add(ctx, str);
+	default:
+		break;
+	}
+
+	return cyaml__patch_unsupported(ctx, cyaml__type_to_str(schema->type));
+}
+
+/**
+ * Patch the first document in the input.
+ *
+ * \param[in]  ctx     The CYAML patch context.
+ * \param[in]  schema  The top level schema.
+ * \param[in]  prev    The data loaded from the input.
+ * \param[in]  data    The modified data.
+ * \return \ref CYAML_OK on success, or appropriate error code otherwise.
+ */
+static cyaml_err_t cyaml__patch_doc(
+		cyaml_patch_ctx_t *ctx,
+		const cyaml_schema_value_t *schema,
+		const cyaml_data_t *prev,
+		const cyaml_data_t *data)
+{
+	cyaml_err_t err;
+
+	err = cyaml__patch_next(ctx);
+	if (err != CYAML_OK) {
+		return err;
+	}
+	if (ctx->parser.encoding != YAML_UTF8_ENCODING) {
+		return cyaml__patch_unsupported(ctx, "non-UTF-8 input");
+	}
+
+	/* `libyaml` skips the byte order mark without counting it. */
+	if (ctx->input_len >= 3 && memcmp(ctx->input, "\xef\xbb\xbf", 3) == 0) {
+		ctx->offset = 3;
+	}
+
+	err = cyaml__patch_next(ctx);
+	if (err != CYAML_OK) {
+		return err;
+	} else if (ctx->event.type != YAML_DOCUMENT_START_EVENT) {
+		return cyaml__patch_unsupported(ctx, "empty input");
+	}
+
+	err = cyaml__patch_next(ctx);
+	if (err != CYAML_OK) {
+		return err;
+	}
+
+	/* The top level value is a pointer, so give its address. */
+	return cyaml__patch_value(ctx, schema,
+			(const uint8_t *)&prev, (const uint8_t *)&data, 0);
+}
+
+/* Exported function, documented in include/cyaml/cyaml.h */
+void cyaml_free_patch(
+		const cyaml_config_t *config,
+		cyaml_patch_edit_t *edits,
+		unsigned count)
+{
+	if (config == NULL || config->mem_fn == NULL) {
+		return;
+	}
+
+	for (unsigned i = 0; i < count; i++) {
+		cyaml__free(config, edits[i].text);
+	}
+	cyaml__free(config, edits);
+}
+
+/* Exported function, documented in include/cyaml/cyaml.h */
+cyaml_err_t cyaml_save_patch(
+		cyaml_patch_edit_t **edits_out,
+		unsigned *count_out,
+		const uint8_t *input,
+		size_t input_len,
+		const cyaml_config_t *config,
+		const cyaml_schema_value_t *schema,
+		const cyaml_data_t *prev,
+		const cyaml_data_t *data)
+{
+	cyaml_patch_ctx_t ctx = {
+		.config = config,
+		.input = input,
+		.input_len = input_len,
+	};
+	cyaml_err_t err;
+
+	if (config == NULL) {
+		return CYAML_ERR_BAD_PARAM_NULL_CONFIG;
+	}
+	if (config->mem_fn == NULL) {
+		return CYAML_ERR_BAD_CONFIG_NULL_MEMFN;
+	}
+	if (schema == NULL) {
+		return CYAML_ERR_BAD_PARAM_NULL_SCHEMA;
+	}
+	if (!(schema->flags & CYAML_FLAG_POINTER)) {
+		return CYAML_ERR_TOP_LEVEL_NON_PTR;
+	}
+	if (schema->type != CYAML_MAPPING) {
+		return CYAML_ERR_BAD_TYPE_IN_SCHEMA;
+	}
+	if (edits_out == NULL || count_out == NULL ||
+	    input == NULL || prev == NULL || data == NULL) {
+		return CYAML_ERR_BAD_PARAM_NULL_DATA;
+	}
+
+	if (!yaml_parser_initialize(&ctx.parser)) {
+		return CYAML_ERR_LIBYAML_PARSER_INIT;
+	}
+	yaml_parser_set_input_string(&ctx.parser, input, input_len);
+
+	err = cyaml__patch_doc(&ctx, schema, prev, data);
+
+	if (ctx.have_event) {
+		yaml_event_delete(&ctx.event);
+	}
+	yaml_parser_delete(&ctx.parser);
+
+	if (err != CYAML_OK) {
+		cyaml_free_patch(config, ctx.edits, ctx.count);
+		return err;
+	}
+
+	cyaml__log(config, CYAML_LOG_DEBUG,
+			"Patch: %u edits\n", ctx.count);
+
+	if (ctx.count == 0) {
+		cyaml__free(config, ctx.edits);
+		ctx.edits = NULL;
+	}
+	*edits_out = ctx.edits;
+	*count_out = ctx.count;
+	return CYAML_OK;
+}
+
+/**
+ * Read a whole file into memory.
+ *
+ * \param[in]  config   The client's CYAML library config.
+ * \param[in]  path     Path to the file to read.
+ * \param[out] buf_out  Returns the file's contents on success.
+ * \param[out] len_out  Returns the length of the file in bytes on success.
+ * \return \ref CYAML_OK on success, or appropriate error code otherwise.
+ */
+static cyaml_err_t cyaml__patch_read_file(
+		const cyaml_config_t *config,
+		const char *path,
+		uint8_t **buf_out,
+		size_t *len_out)
+{
+	cyaml_err_t err = CYAML_OK;
+	uint8_t *buf = NULL;
+	size_t size = 0;
+	size_t len = 0;
+	FILE *file;
+
+	file = fopen(path, "rb");
+	if (file == NULL) {
+		return CYAML_ERR_FILE_OPEN;
+	}
+
+	do {
+		if (len == size) {
+			size_t new_size = (size == 0) ?
+					CYAML_PATCH_FILE_MIN : size * 2;
+			uint8_t *temp;
+
+			temp = cyaml__realloc(config, buf, size,
+					new_size, false);
+			if (temp == NULL) {
+				err = CYAML_ERR_OOM;
+				break;
+			}
+			buf = temp;
+			size = new_size;
+		}
+		len += fread(buf + len, 1, size - len, file);
+	} while (len == size);
+
+	if (err == CYAML_OK && ferror(file)) {
+		err = CYAML_ERR_FILE_OPEN;
+	}
+	fclose(file);
+
+	if (err != CYAML_OK) {
+		cyaml__free(config, buf);
+		return err;
+	}
+
+	*buf_out = buf;
+	*len_out = len;
+	return CYAML_OK;
+}
+
+/**
+ * Write patched YAML to a file.
+ *
+ * \param[in]  file       The file to write to.
+ * \param[in]  input      The unpatched YAML.
+ * \param[in]  input_len  Length of input in bytes.
+ * \param[in]  edits      The edits to make, in input order.
+ * \param[in]  count      The number of edits.
+ * \return true on success, false if writing failed.
+ */
+static bool cyaml__patch_write_output(
+		FILE *file,
+		const uint8_t *input,
+		size_t input_len,
+		const cyaml_patch_edit_t *edits,
+		unsigned count)
+{
+	size_t pos = 0;
+
+	for (unsigned i = 0; i < count; i++) {
+		const cyaml_patch_edit_t *edit = edits + i;
+
+		if (fwrite(input + pos, 1, edit->offset - pos,
+				file) != edit->offset - pos ||
+		    fwrite(edit->text, 1, edit->text_len,
+				file) != edit->text_len) {
+			return false;
+		}
+		pos = edit->offset + edit->len;
+	}
+
+	return fwrite(input + pos, 1, input_len - pos,
+			file) == input_len - pos;
+}
+
+/**
+ * Create the temporary file a patched file is written to.
+ *
+ * \param[in]     path  Path to the file being patched.
+ * \param[in,out] temp  Path of the temporary file, ending with
+ *                      \ref CYAML_PATCH_TEMP_SUFFIX.  Updated to the
+ *                      path of the file created.
+ * \return the temporary file, opened for writing, or NULL on failure.
+ */
+static FILE * cyaml__patch_temp_file(
+		const char *path,
+		char *temp)
+{
+#if CYAML_HAVE_FSYNC
+	struct stat st;
+	FILE *file;
+	int fd;
+
+	fd = mkstemp(temp);
+	if (fd == -1) {
+		return NULL;
+	}
+
+	/* Keep the permissions of the file being replaced. */
+	if (stat(path, &st) == 0) {
+		(void)fchmod(fd, st.st_mode & 07777);
+	}
+
+	file = fdopen(fd, "wb");
+	if (file == NULL) {
+		close(fd);
+		remove(temp);
+	}
+	return file;
+#else
+	(void)path;
+
+	return fopen(temp, "wbx");
+#endif
+}
+
+/**
+ * Write edits to a file.
+ *
+ * The whole patched YAML is written to a temporary file in the same
+ * directory, which then replaces the file, so the file is never left
+ * partly written.
+ *
+ * \param[in]  config     The client's CYAML library config.
+ * \param[in]  path       Path to the file to write.
+ * \param[in]  input      The file's current contents.
+ * \param[in]  input_len  Length of input in bytes.
+ * \param[in]  edits      The edits to make, in input order.
+ * \param[in]  count      The number of edits.
+ * \return \ref CYAML_OK on success, or appropriate error code otherwise.
+ */
+static cyaml_err_t cyaml__patch_write_file(
+		const cyaml_config_t *config,
+		const char *path,
+		const uint8_t *input,
+		size_t input_len,
+		const cyaml_patch_edit_t *edits,
+		unsigned count)
+{
+	size_t path_len = strlen(path);
+	FILE *file;
+	char *temp;
+	bool ok;
+
+	temp = cyaml__alloc(config, path_len +
+			sizeof(CYAML_PATCH_TEMP_SUFFIX), false);
+	if (temp == NULL) {
+		return CYAML_ERR_OOM;
+	}
+	memcpy(temp, path, path_len);
+	memcpy(temp + path_len, CYAML_PATCH_TEMP_SUFFIX,
+			sizeof(CYAML_PATCH_TEMP_SUFFIX));
+
+	file = cyaml__patch_temp_file(path, temp);
+	if (file == NULL) {
+		cyaml__free(config, temp);
+		return CYAML_ERR_FILE_OPEN;
+	}
+
+	ok = cyaml__patch_write_output(file, input, input_len, edits, count);
+	ok = ok && (fflush(file) == 0);
+#if CYAML_HAVE_FSYNC
+	ok = ok && (fsync(fileno(file)) == 0);
+#endif
+	if (fclose(file) != 0) {
+		ok = false;
+	}
+
+	ok = ok && (rename(temp, path) == 0);
+	if (!ok) {
+		remove(temp);
+	}
+
+	cyaml__free(config, temp);
+	return ok ? CYAML_OK : CYAML_ERR_FILE_WRITE;
+}
+
+/* Exported function, documented in include/cyaml/cyaml.h */
+cyaml_err_t cyaml_save_file_patch(
+		const char *path,
+		const cyaml_config_t *config,
+		const cyaml_schema_value_t *schema,
+		const cyaml_data_t *prev,
+		const cyaml_data_t *data)
+{
+	cyaml_patch_edit_t *edits;
+	cyaml_err_t err;
+	unsigned count;
+	uint8_t *input;
+	size_t len;
+
+	if (config == NULL) {
+		return CYAML_ERR_BAD_PARAM_NULL_CONFIG;
+	}
+	if (config->mem_fn == NULL) {
+		return CYAML_ERR_BAD_CONFIG_NULL_MEMFN;
+	}
+
+	err = cyaml__patch_read_file(config, path, &input, &len);
+	if (err != CYAML_OK) {
+		return err;
+	}
+
+	err = cyaml_save_patch(&edits, &count, input, len,
+			config, schema, prev, data);
+	if (err == CYAML_OK && count != 0) {
+		err = cyaml__patch_write_file(config, path, input, len,
+				edits, count);
+		cyaml_free_patch(config, edits, count);
+	}
+
+	cyaml__free(config, input);
+	return err;
+}
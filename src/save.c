@@ -22,6 +22,10 @@
 #include "mem.h"
 #include "data.h"
 #include "util.h"
+#include "schema.h"
+#include "number.h"
+#include "lazy.h"
+#include "emitter.h"
 
 /**
  * A CYAML save state machine stack entry.
@@ -39,6 +43,12 @@ typedef struct cyaml_state {
 		 */
 		struct {
 			const cyaml_schema_field_t *field;
+			/** For entries of a \ref CYAML_FLAG_COLUMNAR
+			 *  sequence, the sequence entry count, or zero for
+			 *  other mappings. */
+			uint64_t columns;
+			/** Index of this entry in the columns. */
+			uint64_t column;
 		} mapping;
 		/**  Additional state for \ref CYAML_STATE_IN_SEQUENCE state. */
 		struct {
@@ -61,8 +71,22 @@ typedef struct cyaml_ctx {
 	uint32_t stack_max;     /**< Current stack allocation limit. */
 	unsigned seq_count;     /**< Top-level sequence count. */
 	yaml_emitter_t *emitter;  /**< Internal libyaml parser object. */
+	/** Native emitter, or NULL if saving with `libyaml`. */
+	cyaml_emitter_t *native;
 } cyaml_ctx_t;
 
+/**
+ * CYAML saver.
+ *
+ * This holds on to the allocations made while saving a document, so that
+ * they can be reused to save subsequent documents.
+ */
+struct cyaml_saver {
+	const cyaml_config_t *config; /**< Settings provided by client. */
+	cyaml_state_t *stack;         /**< Retained state stack. */
+	uint32_t stack_max;           /**< Retained state stack size. */
+};
+
 /**
  * Ensure that the CYAML save context has space for a new stack entry.
  *
@@ -73,7 +97,7 @@ static cyaml_err_t cyaml__stack_ensure(
 		cyaml_ctx_t *ctx)
 {
 	cyaml_state_t *temp;
-	uint32_t max = ctx->stack_max + 16;
+	uint32_t max = (ctx->stack_max == 0) ? 16 : ctx->stack_max * 2;
 
 	if (ctx->stack_idx < ctx->stack_max) {
 		return CYAML_OK;
@@ -121,14 +145,38 @@ static cyaml_err_t cyaml__emit_event_helper(
 		int valid,
 		yaml_event_t *event)
 {
+	cyaml_stats_t *stats = cyaml__stats(ctx->config);
+	uint64_t start = 0;
+
 	if (valid == 0) {
 		cyaml__log(ctx->config, CYAML_LOG_ERROR,
 				"Save: LibYAML: Failed to initialise event\n");
 		return CYAML_ERR_LIBYAML_EVENT_INIT;
 	}
 
+	if (stats != NULL) {
+		if ((unsigned)event->type < CYAML_EVENT__COUNT) {
+			stats->events[event->type]++;
+		}
+		start = cyaml__stats_now();
+	}
+
+	if (ctx->native != NULL) {
+		switch (cyaml__emitter_emit(ctx->native, event)) {
+		case CYAML_EMITTER_OK:
+			return CYAML_OK;
+		case CYAML_EMITTER_OOM:
+			return CYAML_ERR_OOM;
+		default:
+			return CYAML_ERR_INTERNAL_ERROR;
+		}
+	}
+
 	/* Emit event and update save state stack. */
 	valid = yaml_emitter_emit(ctx->emitter, event);
+	if (stats != NULL) {
+		stats->libyaml_ns += cyaml__stats_now() - start;
+	}
 	if (valid == 0) {
 		cyaml__log(ctx->config, CYAML_LOG_ERROR,
 				"Save: LibYAML: Failed to emit event: %s\n",
@@ -259,6 +307,61 @@ static inline bool cyaml__emit_doc_delim(
 	return ctx->config->flags & CYAML_CFG_DOCUMENT_DELIM;
 }
 
+/**
+ * Initialise a YAML mapping start event.
+ *
+ * The native emitter doesn't take ownership of events, so events for it
+ * are made without `libyaml` allocating a copy of the tag.
+ *
+ * \param[in]  ctx     The CYAML saving context.
+ * \param[out] event   The event to initialise.
+ * \param[in]  style   The mapping style.
+ * \return 1 on success, 0 otherwise.
+ */
+static inline int cyaml__mapping_start_event_init(
+		const cyaml_ctx_t *ctx,
+		yaml_event_t *event,
+		yaml_mapping_style_t style)
+{
+	if (ctx->native != NULL) {
+		*event = (yaml_event_t) {
+			.type = YAML_MAPPING_START_EVENT,
+			.data.mapping_start.implicit = 1,
+			.data.mapping_start.style = style,
+		};
+		return 1;
+	}
+
+	return yaml_mapping_start_event_initialize(event, NULL,
+			(yaml_char_t *)YAML_MAP_TAG, 1, style);
+}
+
+/**
+ * Initialise a YAML sequence start event.
+ *
+ * \param[in]  ctx     The CYAML saving context.
+ * \param[out] event   The event to initialise.
+ * \param[in]  style   The sequence style.
+ * \return 1 on success, 0 otherwise.
+ */
+static inline int cyaml__sequence_start_event_init(
+		const cyaml_ctx_t *ctx,
+		yaml_event_t *event,
+		yaml_sequence_style_t style)
+{
+	if (ctx->native != NULL) {
+		*event = (yaml_event_t) {
+			.type = YAML_SEQUENCE_START_EVENT,
+			.data.sequence_start.implicit = 1,
+			.data.sequence_start.style = style,
+		};
+		return 1;
+	}
+
+	return yaml_sequence_start_event_initialize(event, NULL,
+			(yaml_char_t *)YAML_SEQ_TAG, 1, style);
+}
+
 /**
  * Emit a YAML start event for the state being pushed to the stack.
  *
@@ -288,13 +391,11 @@ static cyaml_err_t cyaml__stack_push_write_event(
 	case CYAML_STATE_IN_DOC:
 		return CYAML_OK;
 	case CYAML_STATE_IN_MAP_KEY:
-		ret = yaml_mapping_start_event_initialize(&event, NULL,
-				(yaml_char_t *)YAML_MAP_TAG, 1,
+		ret = cyaml__mapping_start_event_init(ctx, &event,
 				cyaml__get_emit_style_map(ctx, schema));
 		break;
 	case CYAML_STATE_IN_SEQUENCE:
-		ret = yaml_sequence_start_event_initialize(&event, NULL,
-				(yaml_char_t *)YAML_SEQ_TAG, 1,
+		ret = cyaml__sequence_start_event_init(ctx, &event,
 				cyaml__get_emit_style_seq(ctx, schema));
 		break;
 	default:
@@ -353,6 +454,8 @@ static cyaml_err_t cyaml__stack_push(
 	ctx->state = ctx->stack + ctx->stack_idx;
 	ctx->stack_idx++;
 
+	cyaml__stats_stack(ctx->config, ctx->stack_idx);
+
 	return CYAML_OK;
 }
 
@@ -495,6 +598,21 @@ static cyaml_err_t cyaml__emit_scalar(
 				"Save:   <%s>\n", value);
 	}
 
+	if (ctx->native != NULL) {
+		yaml_scalar_style_t style = cyaml__get_emit_style_scalar(schema);
+
+		/* The native emitter doesn't need a copy of the value. */
+		event = (yaml_event_t) {
+			.type = YAML_SCALAR_EVENT,
+			.data.scalar.value = (yaml_char_t *)value,
+			.data.scalar.length = strlen(value),
+			.data.scalar.plain_implicit = 1,
+			.data.scalar.quoted_implicit = 1,
+			.data.scalar.style = style,
+		};
+		return cyaml__emit_event_helper(ctx, 1, &event);
+	}
+
 	ret = yaml_scalar_event_initialize(&event, NULL,
 			(yaml_char_t *)tag,
 			(yaml_char_t *)value,
@@ -504,97 +622,6 @@ static cyaml_err_t cyaml__emit_scalar(
 	return cyaml__emit_event_helper(ctx, ret, &event);
 }
 
-/**
- * Convert signed integer to string.
- *
- * \param[in]  value  The integer to convert.
- * \return String conversion of the value.
- */
-static const char * cyaml__get_int(
-		int64_t value)
-{
-	static char string[32];
-
-	sprintf(string, "%"PRIi64, value);
-
-	return string;
-}
-
-/**
- * Convert unsigned integer to string.
- *
- * \param[in]  value  The integer to convert.
- * \param[in]  hex    Whether to render the number as hexadecimal.
- * \return String conversion of the value.
- */
-static const char * cyaml__get_uint(
-		uint64_t value, bool hex)
-{
-	static char string[32];
-
-	if (hex) {
-		sprintf(string, "0x%"PRIx64, value);
-	} else {
-		sprintf(string, "%"PRIu64, value);
-	}
-
-	return string;
-}
-
-/**
- * Get string representation for single precision floating point values.
- *
- * \param[in]  value  The value to convert.
- * \return String conversion of the value.
- */
-static const char * cyaml__get_float(
-		double value)
-{
-	static char string[64];
-
-	sprintf(string, "%g", value);
-
-	return string;
-}
-
-/**
- * Get string representation for double precision floating point values.
- *
- * \param[in]  value  The value to convert.
- * \return String conversion of the value.
- */
-static const char * cyaml__get_double(
-		double value)
-{
-	static char string[64];
-
-	sprintf(string, "%.16e", value);
-
-	return string;
-}
-
-/**
- * Pad a signed value that's smaller than 64-bit to an int64_t.
- *
- * This sets all the bits in the padded region.
- *
- * \param[in]  raw   Contains a signed value of size bytes.
- * \param[in]  size  Number of bytes used in raw.
- * \return Value padded to 64-bit signed.
- */
-static int64_t cyaml_sign_pad(uint64_t raw, size_t size)
-{
-	uint64_t sign_bit = (size == 0) ?
-			UINT64_MAX : ((uint64_t)1) << (size * CHAR_BIT - 1);
-	unsigned padding = ((unsigned)(sizeof(raw) - size)) * CHAR_BIT;
-
-	if ((sign_bit & raw) && (padding != 0)) {
-		raw |= (((uint64_t)1 << padding) - 1) << (size * CHAR_BIT);
-	}
-
-	return (int64_t)raw;
-}
-
 /**
  * Write a value of type \ref CYAML_INT.
  *
@@ -608,6 +635,7 @@ static cyaml_err_t cyaml__write_int(
 		const cyaml_schema_value_t *schema,
 		const uint8_t *data)
 {
+	char string[CYAML_NUMBER_STR_MAX];
 	cyaml_err_t err;
 	int64_t number;
 	uint64_t raw;
@@ -617,10 +645,10 @@ static cyaml_err_t cyaml__write_int(
 		return err;
 	}
 
-	number = cyaml_sign_pad(raw, schema->data_size);
+	number = cyaml_data_sign_pad(raw, schema->data_size);
 
 	return cyaml__emit_scalar(ctx, schema,
-			cyaml__get_int(number),
+			cyaml__number_format_int(number, string),
 			YAML_INT_TAG);
 }
 
@@ -637,13 +665,15 @@ static cyaml_err_t cyaml__write_uint(
 		const cyaml_schema_value_t *schema,
 		const uint8_t *data)
 {
+	char string[CYAML_NUMBER_STR_MAX];
 	uint64_t number;
 	cyaml_err_t err;
 
 	number = cyaml_data_read(schema->data_size, data, &err);
 	if (err == CYAML_OK) {
-		const char *string = cyaml__get_uint(number, false);
-		err = cyaml__emit_scalar(ctx, schema, string, YAML_INT_TAG);
+		err = cyaml__emit_scalar(ctx, schema,
+				cyaml__number_format_uint(number, false, string),
+				YAML_INT_TAG);
 	}
 
 	return err;
@@ -693,11 +723,23 @@ static cyaml_err_t cyaml__write_enum(
 	number = (int64_t)cyaml_data_read(schema->data_size, data, &err);
 	if (err == CYAML_OK) {
 		const cyaml_strval_t *strings = schema->enumeration.strings;
+		const cyaml_schema_names_t *names;
 		const char *string = NULL;
-		for (uint32_t i = 0; i < schema->enumeration.count; i++) {
-			if (number == strings[i].val) {
+
+		names = cyaml__schema_names(ctx->config, schema);
+		if (names != NULL) {
+			uint32_t i = cyaml__schema_names_value_idx(
+					names, number);
+			if (i != CYAML_NAMES_IDX_NONE) {
 				string = strings[i].str;
-				break;
+			}
+		} else {
+			for (uint32_t i = 0;
+					i < schema->enumeration.count; i++) {
+				if (number == strings[i].val) {
+					string = strings[i].str;
+					break;
+				}
 			}
 		}
 		if (string == NULL) {
@@ -732,17 +774,18 @@ static cyaml_err_t cyaml__write_float(
 		const cyaml_schema_value_t *schema,
 		const uint8_t *data)
 {
+	char buffer[CYAML_NUMBER_STR_MAX];
 	const char *string = NULL;
 
 	if (schema->data_size == sizeof(float)) {
 		float number;
 		memcpy(&number, data, schema->data_size);
-		string = cyaml__get_float(number);
+		string = cyaml__number_format_float(number, buffer);
 
 	} else if (schema->data_size == sizeof(double)) {
 		double number;
 		memcpy(&number, data, schema->data_size);
-		string = cyaml__get_double(number);
+		string = cyaml__number_format_double(number, buffer);
 	} else {
 		return CYAML_ERR_INVALID_DATA_SIZE;
 	}
@@ -815,8 +858,7 @@ static cyaml_err_t cyaml__emit_flags_sequence(
 	cyaml_err_t err;
 	int ret;
 
-	ret = yaml_sequence_start_event_initialize(&event, NULL,
-			(yaml_char_t *)YAML_SEQ_TAG, 1,
+	ret = cyaml__sequence_start_event_init(ctx, &event,
 			YAML_ANY_SEQUENCE_STYLE);
 
 	err = cyaml__emit_event_helper(ctx, ret, &event);
@@ -840,8 +882,11 @@ static cyaml_err_t cyaml__emit_flags_sequence(
 		if (schema->flags & CYAML_FLAG_STRICT) {
 			return CYAML_ERR_INVALID_VALUE;
 		} else {
-			const char *string = cyaml__get_uint(number, false);
-			err = cyaml__emit_scalar(ctx, schema, string,
+			char string[CYAML_NUMBER_STR_MAX];
+
+			err = cyaml__emit_scalar(ctx, schema,
+					cyaml__number_format_uint(
+							number, false, string),
 					YAML_STR_TAG);
 			if (err != CYAML_OK) {
 				return err;
@@ -896,8 +941,7 @@ static cyaml_err_t cyaml__emit_bitfield_mapping(
 	cyaml_err_t err;
 	int ret;
 
-	ret = yaml_mapping_start_event_initialize(&event, NULL,
-			(yaml_char_t *)YAML_MAP_TAG, 1,
+	ret = cyaml__mapping_start_event_init(ctx, &event,
 			cyaml__get_emit_style_map(ctx, schema));
 
 	err = cyaml__emit_event_helper(ctx, ret, &event);
@@ -906,6 +950,7 @@ static cyaml_err_t cyaml__emit_bitfield_mapping(
 	}
 
 	for (uint32_t i = 0; i < schema->bitfield.count; i++) {
+		char buffer[CYAML_NUMBER_STR_MAX];
 		const char *value_str;
 		uint64_t value;
 		uint64_t mask;
@@ -932,7 +977,7 @@ static cyaml_err_t cyaml__emit_bitfield_mapping(
 		}
 
 		/* Emit bitfield value's value */
-		value_str = cyaml__get_uint(value, true);
+		value_str = cyaml__number_format_uint(value, true, buffer);
 		err = cyaml__emit_scalar(ctx, schema, value_str, YAML_INT_TAG);
 		if (err != CYAML_OK) {
 			return err;
@@ -968,6 +1013,110 @@ static cyaml_err_t cyaml__write_bitfield_value(
 	return err;
 }
 
+/**
+ * Emit the YAML event for a NULL pointer value.
+ *
+ * \param[in]  ctx     The CYAML saving context.
+ * \param[in]  schema  CYAML schema for the value.
+ * \return \ref CYAML_OK on success, or appropriate error code otherwise.
+ */
+static cyaml_err_t cyaml__write_null(
+		cyaml_ctx_t *ctx,
+		const cyaml_schema_value_t *schema)
+{
+	if (cyaml__flag_check_all(schema->flags,
+			CYAML_FLAG_POINTER_NULL_STR)) {
+		return cyaml__emit_scalar(ctx, schema, "null", YAML_STR_TAG);
+	} else if (cyaml__flag_check_all(schema->flags,
+			CYAML_FLAG_POINTER_NULL)) {
+		return cyaml__emit_scalar(ctx, schema, "", YAML_STR_TAG);
+	}
+
+	return CYAML_ERR_INVALID_VALUE;
+}
+
+/**
+ * Emit the YAML events for a \ref CYAML_FLAG_LAZY value.
+ *
+ * The lazy value's YAML is parsed, and its events are passed through to
+ * the emitter, without being decoded.
+ *
+ * \param[in]  ctx     The CYAML saving context.
+ * \param[in]  schema  CYAML schema for the value.
+ * \param[in]  data    The place to read the \ref cyaml_lazy_t from.
+ * \return \ref CYAML_OK on success, or appropriate error code otherwise.
+ */
+static cyaml_err_t cyaml__write_lazy(
+		cyaml_ctx_t *ctx,
+		const cyaml_schema_value_t *schema,
+		const uint8_t *data)
+{
+	cyaml_err_t err = CYAML_OK;
+	yaml_event_type_t type;
+	yaml_parser_t parser;
+	cyaml_lazy_t lazy;
+	uint8_t *input;
+	size_t len;
+
+	if (!cyaml_data_lazy_valid(schema)) {
+		cyaml__log(ctx->config, CYAML_LOG_ERROR,
+				"Save: Bad lazy value schema\n");
+		return CYAML_ERR_BAD_TYPE_IN_SCHEMA;
+	}
+
+	memcpy(&lazy, data, sizeof(lazy));
+	if (lazy.input == NULL) {
+		return cyaml__write_null(ctx, schema);
+	}
+
+	cyaml__log(ctx->config, CYAML_LOG_DEBUG,
+			"Save: Writing lazy value (%zu bytes)\n", lazy.len);
+
+	input = cyaml__lazy_input(ctx->config, &lazy, &len);
+	if (input == NULL) {
+		return CYAML_ERR_OOM;
+	}
+
+	if (!yaml_parser_initialize(&parser)) {
+		cyaml__free(ctx->config, input);
+		return CYAML_ERR_LIBYAML_PARSER_INIT;
+	}
+	yaml_parser_set_input_string(&parser, input, len);
+
+	do {
+		yaml_event_t event;
+
+		if (!yaml_parser_parse(&parser, &event)) {
+			cyaml__log(ctx->config, CYAML_LOG_ERROR,
+					"Save: LibYAML: Lazy value: %s\n",
+					parser.problem);
+			err = CYAML_ERR_LIBYAML_PARSER;
+			break;
+		}
+
+		type = event.type;
+		switch (type) {
+		case YAML_STREAM_START_EVENT:   /* Fall through. */
+		case YAML_STREAM_END_EVENT:     /* Fall through. */
+		case YAML_DOCUMENT_START_EVENT: /* Fall through. */
+		case YAML_DOCUMENT_END_EVENT:
+			yaml_event_delete(&event);
+			break;
+		default:
+			/* The libyaml emitter takes ownership of the event. */
+			err = cyaml__emit_event_helper(ctx, 1, &event);
+			if (ctx->native != NULL) {
+				yaml_event_delete(&event);
+			}
+			break;
+		}
+	} while (err == CYAML_OK && type != YAML_STREAM_END_EVENT);
+
+	yaml_parser_delete(&parser);
+	cyaml__free(ctx->config, input);
+	return err;
+}
+
 /**
  * Emit the YAML events required for a CYAML value.
  *
@@ -995,17 +1144,7 @@ static cyaml_err_t cyaml__write_value(
 			data, "Save");
 
 	if (data == NULL) {
-		if (cyaml__flag_check_all(schema->flags,
-				CYAML_FLAG_POINTER_NULL_STR)) {
-			return cyaml__emit_scalar(ctx, schema, "null",
-					YAML_STR_TAG);
-		} else if (cyaml__flag_check_all(schema->flags,
-				CYAML_FLAG_POINTER_NULL)) {
-			return cyaml__emit_scalar(ctx, schema, "",
-					YAML_STR_TAG);
-		} else {
-			return CYAML_ERR_INVALID_VALUE;
-		}
+		return cyaml__write_null(ctx, schema);
 	}
 
 	switch (schema->type) {
@@ -1033,6 +1172,12 @@ static cyaml_err_t cyaml__write_value(
 		}
 		/* Fall through. */
 	case CYAML_SEQUENCE:
+		if ((schema->flags & CYAML_FLAG_COLUMNAR) &&
+		    !cyaml_data_columnar_valid(schema)) {
+			cyaml__log(ctx->config, CYAML_LOG_ERROR,
+					"Save: Bad columnar sequence schema\n");
+			return CYAML_ERR_BAD_TYPE_IN_SCHEMA;
+		}
 		err = cyaml__stack_push(ctx, CYAML_STATE_IN_SEQUENCE,
 				schema, data);
 		if (err == CYAML_OK) {
@@ -1108,6 +1253,22 @@ static cyaml_err_t cyaml__write_doc(
 	return err;
 }
 
+/**
+ * Get the offset of a mapping field's value in the mapping's client data.
+ *
+ * \param[in]  state  The mapping's CYAML save state.
+ * \param[in]  field  The field to get the value offset for.
+ * \return Offset to read the field's value from.
+ */
+static inline size_t cyaml__field_offset(
+		const cyaml_state_t *state,
+		const cyaml_schema_field_t *field)
+{
+	return cyaml_data_member_offset(field->data_offset,
+			cyaml_data_member_size(&field->value),
+			state->mapping.columns, state->mapping.column);
+}
+
 /**
  * YAML saving handler for the \ref CYAML_STATE_IN_MAP_KEY and \ref
  * CYAML_STATE_IN_MAP_VALUE states.
@@ -1122,6 +1283,8 @@ static cyaml_err_t cyaml__write_mapping(
 	cyaml_err_t err = CYAML_OK;
 
 	if (field != NULL && field->key != NULL) {
+		const uint8_t *data = ctx->state->data +
+				cyaml__field_offset(ctx->state, field);
 		uint64_t seq_count = 0;
 
 		if (field->value.type == CYAML_IGNORE) {
@@ -1131,8 +1294,8 @@ static cyaml_err_t cyaml__write_mapping(
 
 		if ((field->value.flags & CYAML_FLAG_OPTIONAL) &&
 		    (field->value.flags & CYAML_FLAG_POINTER)) {
-			const void *ptr = cyaml_data_read_pointer(
-					ctx->state->data + field->data_offset);
+			/* A lazy value's first member is its input pointer. */
+			const void *ptr = cyaml_data_read_pointer(data);
 			if (ptr == NULL) {
 				ctx->state->mapping.field++;
 				return CYAML_OK;
@@ -1149,10 +1312,19 @@ static cyaml_err_t cyaml__write_mapping(
 		 * value can put a new state entry on the stack. */
 		ctx->state->mapping.field++;
 
+		if (field->value.flags & CYAML_FLAG_LAZY) {
+			return cyaml__write_lazy(ctx, &field->value, data);
+		}
+
 		if (field->value.type == CYAML_SEQUENCE) {
+			const cyaml_state_t *state = ctx->state;
+			size_t offset = cyaml_data_member_offset(
+					field->count_offset, field->count_size,
+					state->mapping.columns,
+					state->mapping.column);
+
 			seq_count = cyaml_data_read(field->count_size,
-					ctx->state->data + field->count_offset,
-					&err);
+					state->data + offset, &err);
 			if (err != CYAML_OK) {
 				return err;
 			}
@@ -1164,10 +1336,7 @@ static cyaml_err_t cyaml__write_mapping(
 			seq_count = field->value.sequence.min;
 		}
 
-		err = cyaml__write_value(ctx,
-				&field->value,
-				ctx->state->data + field->data_offset,
-				seq_count);
+		err = cyaml__write_value(ctx, &field->value, data, seq_count);
 	} else {
 		err = cyaml__stack_pop(ctx, true);
 	}
@@ -1175,6 +1344,59 @@ static cyaml_err_t cyaml__write_mapping(
 	return err;
 }
 
+/**
+ * Check whether a sequence's entries can be written in bulk.
+ *
+ * Sequences of non-pointer numbers are written in a loop, without returning
+ * to the state machine for every entry.
+ *
+ * \param[in]  entry  The schema for the sequence's entries.
+ * \return true if the entries can be written in bulk, false otherwise.
+ */
+static inline bool cyaml__sequence_is_bulk(
+		const cyaml_schema_value_t *entry)
+{
+	switch (entry->type) {
+	case CYAML_INT:  /* Fall through. */
+	case CYAML_UINT: /* Fall through. */
+	case CYAML_FLOAT:
+		return !(entry->flags & CYAML_FLAG_POINTER);
+	default:
+		return false;
+	}
+}
+
+/**
+ * Write all of the remaining entries of a sequence of numbers.
+ *
+ * \param[in]  ctx  The CYAML saving context.
+ * \return \ref CYAML_OK on success, or appropriate error code otherwise.
+ */
+static cyaml_err_t cyaml__write_sequence_bulk(
+		cyaml_ctx_t *ctx)
+{
+	cyaml_state_t *state = ctx->state;
+	const cyaml_schema_value_t *value = state->schema->sequence.entry;
+	const uint8_t *data = state->data + value->data_size *
+			state->sequence.entry;
+
+	cyaml__log(ctx->config, CYAML_LOG_INFO,
+			"Save: Sequence entries %"PRIu64" to %"PRIu64"\n",
+			state->sequence.entry + 1,
+			state->sequence.count);
+
+	while (state->sequence.entry < state->sequence.count) {
+		cyaml_err_t err = cyaml__write_scalar_value(ctx, value, data);
+		if (err != CYAML_OK) {
+			return err;
+		}
+		state->sequence.entry++;
+		data += value->data_size;
+	}
+
+	return cyaml__stack_pop(ctx, true);
+}
+
 /**
  * YAML saving handler for the \ref CYAML_STATE_IN_SEQUENCE state.
  *
@@ -1186,6 +1408,10 @@ static cyaml_err_t cyaml__write_sequence(
 {
 	cyaml_err_t err = CYAML_OK;
 
+	if (cyaml__sequence_is_bulk(ctx->state->schema->sequence.entry)) {
+		return cyaml__write_sequence_bulk(ctx);
+	}
+
 	if (ctx->state->sequence.entry < ctx->state->sequence.count) {
 		const cyaml_schema_value_t *schema = ctx->state->schema;
 		const cyaml_schema_value_t *value = schema->sequence.entry;
@@ -1219,6 +1445,19 @@ static cyaml_err_t cyaml__write_sequence(
 		 * value can put a new state entry on the stack. */
 		ctx->state->sequence.entry++;
 
+		if (schema->flags & CYAML_FLAG_COLUMNAR) {
+			uint64_t columns = ctx->state->sequence.count;
+			uint64_t column = ctx->state->sequence.entry - 1;
+
+			err = cyaml__write_value(ctx, value,
+					ctx->state->data, seq_count);
+			if (err == CYAML_OK) {
+				ctx->state->mapping.columns = columns;
+				ctx->state->mapping.column = column;
+			}
+			return err;
+		}
+
 		err = cyaml__write_value(ctx, value,
 				ctx->state->data + offset,
 				seq_count);
@@ -1271,24 +1510,30 @@ static inline cyaml_err_t cyaml__validate_save_params(
  * The public interfaces are wrappers around this.
  *
  * \param[in] config     Client's CYAML configuration structure.
+ * \param[in] saver      Saver to reuse allocations from, or NULL.
  * \param[in] schema     CYAML schema for the YAML to be saved.
  * \param[in] data       The caller-owned data to be saved.
  * \param[in] seq_count  If top level type is sequence, this should be the
  *                       entry count, otherwise it is ignored.
  * \param[in] emitter    An initialised `libyaml` emitter object
- *                       with its output set.
+ *                       with its output set, or NULL if `native` is set.
+ * \param[in] native     An initialised native emitter, or NULL to save
+ *                       with `emitter`.
  * \return \ref CYAML_OK on success, or appropriate error code otherwise.
  */
 static cyaml_err_t cyaml__save(
 		const cyaml_config_t *config,
+		cyaml_saver_t *saver,
 		const cyaml_schema_value_t *schema,
 		const cyaml_data_t *data,
 		unsigned seq_count,
-		yaml_emitter_t *emitter)
+		yaml_emitter_t *emitter,
+		cyaml_emitter_t *native)
 {
 	cyaml_ctx_t ctx = {
 		.config = config,
 		.emitter = emitter,
+		.native = native,
 		.seq_count = seq_count,
 	};
 	typedef cyaml_err_t (* const cyaml_write_fn)(
@@ -1302,12 +1547,27 @@ static cyaml_err_t cyaml__save(
 		[CYAML_STATE_IN_SEQUENCE]  = cyaml__write_sequence,
 	};
 	cyaml_err_t err = CYAML_OK;
+	cyaml_stats_t *stats;
+	uint64_t flush_start;
+	uint64_t start = 0;
+	int flushed;
 
 	err = cyaml__validate_save_params(config, schema, data, seq_count);
 	if (err != CYAML_OK) {
 		return err;
 	}
 
+	stats = cyaml__stats(config);
+	if (stats != NULL) {
+		start = cyaml__stats_now();
+	}
+
+	if (saver != NULL) {
+		ctx.stack = saver->stack;
+		ctx.stack_max = saver->stack_max;
+		saver->stack = NULL;
+	}
+
 	err = cyaml__stack_push(&ctx, CYAML_STATE_START, schema, &data);
 	if (err != CYAML_OK) {
 		goto out;
@@ -1327,7 +1587,16 @@ static cyaml_err_t cyaml__save(
 
 	assert(ctx.stack_idx == 0);
 
-	if (!yaml_emitter_flush(emitter)) {
+	if (native != NULL) {
+		goto out;
+	}
+
+	flush_start = (stats != NULL) ? cyaml__stats_now() : 0;
+	flushed = yaml_emitter_flush(emitter);
+	if (stats != NULL) {
+		stats->libyaml_ns += cyaml__stats_now() - flush_start;
+	}
+	if (!flushed) {
 		cyaml__log(config, CYAML_LOG_ERROR,
 				"Save: LibYAML: Failed to flush emitter: %s\n",
 				emitter->problem);
@@ -1335,20 +1604,40 @@ static cyaml_err_t cyaml__save(
 	}
 
 out:
-	if (err != CYAML_OK) {
+	if (err != CYAML_OK && (native == NULL || !native->unsupported)) {
 		cyaml__backtrace(&ctx);
 	}
 	while (ctx.stack_idx > 0) {
 		cyaml__stack_pop(&ctx, false);
 	}
-	cyaml__free(config, ctx.stack);
+	if (saver != NULL) {
+		saver->stack = ctx.stack;
+		saver->stack_max = ctx.stack_max;
+	} else {
+		cyaml__free(config, ctx.stack);
+	}
+	if (stats != NULL) {
+		stats->total_ns += cyaml__stats_now() - start;
+	}
 	return err;
 }
 
-/* Exported function, documented in include/cyaml/cyaml.h */
-cyaml_err_t cyaml_save_file(
-		const char *path,
+/**
+ * Save a YAML document to a file at the given path.
+ *
+ * \param[in] config     Client's CYAML configuration structure.
+ * \param[in] saver      Saver to reuse allocations from, or NULL.
+ * \param[in] path       Path to YAML file to write.
+ * \param[in] schema     CYAML schema for the YAML to be saved.
+ * \param[in] data       The caller-owned data to be saved.
+ * \param[in] seq_count  If top level type is sequence, this should be the
+ *                       entry count, otherwise it is ignored.
+ * \return \ref CYAML_OK on success, or appropriate error code otherwise.
+ */
+static cyaml_err_t cyaml__save_file(
 		const cyaml_config_t *config,
+		cyaml_saver_t *saver,
+		const char *path,
 		const cyaml_schema_value_t *schema,
 		const cyaml_data_t *data,
 		unsigned seq_count)
@@ -1373,7 +1662,8 @@ cyaml_err_t cyaml_save_file(
 	yaml_emitter_set_output_file(&emitter, file);
 
 	/* Serialise to the output */
-	err = cyaml__save(config, schema, data, seq_count, &emitter);
+	err = cyaml__save(config, saver, schema, data, seq_count,
+			&emitter, NULL);
 	if (err != CYAML_OK) {
 		yaml_emitter_delete(&emitter);
 		fclose(file);
@@ -1404,7 +1694,8 @@ typedef struct cyaml_buffer_ctx {
  * characters to the output.  The handler should write size bytes of the
  * buffer to the output.
  *
- * \todo Could be more efficient about this, but for now, this is fine.
+ * The buffer allocation grows geometrically, starting from the client's
+ * size hint, if they gave one.
  *
  * \param[in]  data    A pointer to cyaml buffer context struture.
  * \param[in]  buffer  The buffer with bytes to be written.
@@ -1423,18 +1714,36 @@ static int cyaml__buffer_handler(
 	};
 
 	if (size > (buffer_ctx->len - buffer_ctx->used)) {
-		char *temp = cyaml__realloc(
+		size_t need = buffer_ctx->used + size;
+		size_t len = buffer_ctx->len;
+		char *temp;
+
+		if (need < size) {
+			buffer_ctx->err = CYAML_ERR_OOM;
+			return RETURN_FAILURE;
+		}
+
+		if (len == 0) {
+			len = buffer_ctx->config->save_size_hint;
+		} else {
+			len = (len <= SIZE_MAX / 2) ? len * 2 : SIZE_MAX;
+		}
+		if (len < need) {
+			len = need;
+		}
+
+		temp = cyaml__realloc(
 				buffer_ctx->config,
 				buffer_ctx->data,
 				buffer_ctx->len,
-				buffer_ctx->used + size,
+				len,
 				false);
 		if (temp == NULL) {
 			buffer_ctx->err = CYAML_ERR_OOM;
 			return RETURN_FAILURE;
 		}
 		buffer_ctx->data = temp;
-		buffer_ctx->len = buffer_ctx->used + size;
+		buffer_ctx->len = len;
 	}
 
 	memcpy(buffer_ctx->data + buffer_ctx->used, buffer, size);
@@ -1443,11 +1752,26 @@ static int cyaml__buffer_handler(
 	return RETURN_SUCCESS;
 }
 
-/* Exported function, documented in include/cyaml/cyaml.h */
-cyaml_err_t cyaml_save_data(
+/**
+ * Save a YAML document into a string in memory.
+ *
+ * \param[in]  config     Client's CYAML configuration structure.
+ * \param[in]  saver      Saver to reuse allocations from, or NULL.
+ * \param[out] output     Returns the caller-owned serialised YAML data on
+ *                        success, untouched on failure.
+ * \param[out] len        Returns the length of the data in output on success,
+ *                        untouched on failure.
+ * \param[in]  schema     CYAML schema for the YAML to be saved.
+ * \param[in]  data       The caller-owned data to be saved.
+ * \param[in]  seq_count  If top level type is sequence, this should be the
+ *                        entry count, otherwise it is ignored.
+ * \return \ref CYAML_OK on success, or appropriate error code otherwise.
+ */
+static cyaml_err_t cyaml__save_data(
+		const cyaml_config_t *config,
+		cyaml_saver_t *saver,
 		char **output,
 		size_t *len,
-		const cyaml_config_t *config,
 		const cyaml_schema_value_t *schema,
 		const cyaml_data_t *data,
 		unsigned seq_count)
@@ -1459,6 +1783,29 @@ cyaml_err_t cyaml_save_data(
 		.err = CYAML_OK,
 	};
 
+	if (config != NULL && config->mem_fn != NULL &&
+	    (config->flags & CYAML_CFG_NATIVE_EMITTER)) {
+		cyaml_emitter_t native;
+
+		/* Output is only given to the client once the whole document
+		 * has been written, so the native emitter can give up part
+		 * way through. */
+		cyaml__emitter_init(&native, config);
+		err = cyaml__save(config, saver, schema, data, seq_count,
+				NULL, &native);
+		if (!native.unsupported) {
+			if (err == CYAML_OK) {
+				*output = cyaml__emitter_take_output(
+						&native, len);
+			}
+			cyaml__emitter_fini(&native);
+			return err;
+		}
+		cyaml__emitter_fini(&native);
+		cyaml__log(config, CYAML_LOG_DEBUG, "Save: Native emitter "
+				"unsupported output; using libyaml\n");
+	}
+
 	/* Initialize emitter */
 	if (!yaml_emitter_initialize(&emitter)) {
 		return CYAML_ERR_LIBYAML_EMITTER_INIT;
@@ -1468,7 +1815,8 @@ cyaml_err_t cyaml_save_data(
 	yaml_emitter_set_output(&emitter, cyaml__buffer_handler, &buffer_ctx);
 
 	/* Serialise to the output */
-	err = cyaml__save(config, schema, data, seq_count, &emitter);
+	err = cyaml__save(config, saver, schema, data, seq_count,
+			&emitter, NULL);
 	if (err != CYAML_OK) {
 		yaml_emitter_delete(&emitter);
 		if ((config != NULL) && (config->mem_fn != NULL)) {
@@ -1483,8 +1831,236 @@ cyaml_err_t cyaml_save_data(
 	/* Cleanup */
 	yaml_emitter_delete(&emitter);
 
+	/* Trim any unused space from the buffer. */
+	if (buffer_ctx.used != 0 && buffer_ctx.used < buffer_ctx.len) {
+		char *temp = cyaml__realloc(config, buffer_ctx.data,
+				buffer_ctx.len, buffer_ctx.used, false);
+		if (temp != NULL) {
+			buffer_ctx.data = temp;
+		}
+	}
+
 	*output = buffer_ctx.data;
 	*len = buffer_ctx.used;
 
 	return CYAML_OK;
 }
+
+/** CYAML save stream context. */
+typedef struct cyaml_stream_ctx {
+	cyaml_write_fn_t write_fn; /**< Client's output write callback. */
+	void *write_ctx; /**< Client's private context for `write_fn`. */
+	cyaml_err_t err; /**< Any error returned by `write_fn`. */
+} cyaml_stream_ctx_t;
+
+/**
+ * Write handler for libyaml, which passes output to the client.
+ *
+ * \param[in]  data    A pointer to cyaml stream context struture.
+ * \param[in]  buffer  The buffer with bytes to be written.
+ * \param[in]  size    The number of bytes to be written.
+ * \return 1 on sucess, 0 otherwise.
+ */
+static int cyaml__stream_handler(
+		void *data,
+		unsigned char *buffer,
+		size_t size)
+{
+	cyaml_stream_ctx_t *stream_ctx = data;
+	enum {
+		RETURN_SUCCESS = 1,
+		RETURN_FAILURE = 0,
+	};
+
+	stream_ctx->err = stream_ctx->write_fn(stream_ctx->write_ctx,
+			buffer, size);
+	if (stream_ctx->err != CYAML_OK) {
+		return RETURN_FAILURE;
+	}
+
+	return RETURN_SUCCESS;
+}
+
+/**
+ * Save a YAML document to a client write callback.
+ *
+ * \param[in]  config     Client's CYAML configuration structure.
+ * \param[in]  saver      Saver to reuse allocations from, or NULL.
+ * \param[in]  write_fn   Client's output write callback.
+ * \param[in]  write_ctx  Client's private context for write_fn.
+ * \param[in]  schema     CYAML schema for the YAML to be saved.
+ * \param[in]  data       The caller-owned data to be saved.
+ * \param[in]  seq_count  If top level type is sequence, this should be the
+ *                        entry count, otherwise it is ignored.
+ * \return \ref CYAML_OK on success, or appropriate error code otherwise.
+ */
+static cyaml_err_t cyaml__save_stream(
+		const cyaml_config_t *config,
+		cyaml_saver_t *saver,
+		cyaml_write_fn_t write_fn,
+		void *write_ctx,
+		const cyaml_schema_value_t *schema,
+		const cyaml_data_t *data,
+		unsigned seq_count)
+{
+	cyaml_err_t err;
+	yaml_emitter_t emitter;
+	cyaml_stream_ctx_t stream_ctx = {
+		.write_fn = write_fn,
+		.write_ctx = write_ctx,
+		.err = CYAML_OK,
+	};
+
+	if (write_fn == NULL) {
+		return CYAML_ERR_BAD_PARAM_NULL_CALLBACK;
+	}
+
+	/* Initialize emitter */
+	if (!yaml_emitter_initialize(&emitter)) {
+		return CYAML_ERR_LIBYAML_EMITTER_INIT;
+	}
+
+	/* Set output callback */
+	yaml_emitter_set_output(&emitter, cyaml__stream_handler, &stream_ctx);
+
+	/* Serialise to the output */
+	err = cyaml__save(config, saver, schema, data, seq_count,
+			&emitter, NULL);
+	if (err != CYAML_OK && stream_ctx.err != CYAML_OK) {
+		err = stream_ctx.err;
+	}
+
+	/* Cleanup */
+	yaml_emitter_delete(&emitter);
+
+	return err;
+}
+
+/* Exported function, documented in include/cyaml/cyaml.h */
+cyaml_err_t cyaml_save_file(
+		const char *path,
+		const cyaml_config_t *config,
+		const cyaml_schema_value_t *schema,
+		const cyaml_data_t *data,
+		unsigned seq_count)
+{
+	return cyaml__save_file(config, NULL, path, schema, data, seq_count);
+}
+
+/* Exported function, documented in include/cyaml/cyaml.h */
+cyaml_err_t cyaml_save_data(
+		char **output,
+		size_t *len,
+		const cyaml_config_t *config,
+		const cyaml_schema_value_t *schema,
+		const cyaml_data_t *data,
+		unsigned seq_count)
+{
+	return cyaml__save_data(config, NULL, output, len,
+			schema, data, seq_count);
+}
+
+/* Exported function, documented in include/cyaml/cyaml.h */
+cyaml_err_t cyaml_save_stream(
+		cyaml_write_fn_t write_fn,
+		void *write_ctx,
+		const cyaml_config_t *config,
+		const cyaml_schema_value_t *schema,
+		const cyaml_data_t *data,
+		unsigned seq_count)
+{
+	return cyaml__save_stream(config, NULL, write_fn, write_ctx,
+			schema, data, seq_count);
+}
+
+/* Exported function, documented in include/cyaml/cyaml.h */
+cyaml_err_t cyaml_saver_create(
+		const cyaml_config_t *config,
+		cyaml_saver_t **saver_out)
+{
+	cyaml_saver_t *saver;
+
+	if (config == NULL) {
+		return CYAML_ERR_BAD_PARAM_NULL_CONFIG;
+	}
+	if (config->mem_fn == NULL) {
+		return CYAML_ERR_BAD_CONFIG_NULL_MEMFN;
+	}
+	if (saver_out == NULL) {
+		return CYAML_ERR_BAD_PARAM_NULL_SAVER;
+	}
+
+	saver = cyaml__alloc(config, sizeof(*saver), true);
+	if (saver == NULL) {
+		return CYAML_ERR_OOM;
+	}
+
+	saver->config = config;
+
+	*saver_out = saver;
+	return CYAML_OK;
+}
+
+/* Exported function, documented in include/cyaml/cyaml.h */
+cyaml_err_t cyaml_saver_save_file(
+		cyaml_saver_t *saver,
+		const char *path,
+		const cyaml_schema_value_t *schema,
+		const cyaml_data_t *data,
+		unsigned seq_count)
+{
+	if (saver == NULL) {
+		return CYAML_ERR_BAD_PARAM_NULL_SAVER;
+	}
+
+	return cyaml__save_file(saver->config, saver, path,
+			schema, data, seq_count);
+}
+
+/* Exported function, documented in include/cyaml/cyaml.h */
+cyaml_err_t cyaml_saver_save_data(
+		cyaml_saver_t *saver,
+		char **output,
+		size_t *len,
+		const cyaml_schema_value_t *schema,
+		const cyaml_data_t *data,
+		unsigned seq_count)
+{
+	if (saver == NULL) {
+		return CYAML_ERR_BAD_PARAM_NULL_SAVER;
+	}
+
+	return cyaml__save_data(saver->config, saver, output, len,
+			schema, data, seq_count);
+}
+
+/* Exported function, documented in include/cyaml/cyaml.h */
+cyaml_err_t cyaml_saver_save_stream(
+		cyaml_saver_t *saver,
+		cyaml_write_fn_t write_fn,
+		void *write_ctx,
+		const cyaml_schema_value_t *schema,
+		const cyaml_data_t *data,
+		unsigned seq_count)
+{
+	if (saver == NULL) {
+		return CYAML_ERR_BAD_PARAM_NULL_SAVER;
+	}
+
+	return cyaml__save_stream(saver->config, saver, write_fn, write_ctx,
+			schema, data, seq_count);
+}
+
+/* Exported function, documented in include/cyaml/cyaml.h */
+cyaml_err_t cyaml_saver_free(
+		cyaml_saver_t *saver)
+{
+	if (saver == NULL) {
+		return CYAML_OK;
+	}
+
+	cyaml__free(saver->config, saver->stack);
+	cyaml__free(saver->config, saver);
+
+	return CYAML_OK;
+}
@@ -0,0 +1,1514 @@
+/*
+ * SPDX-License-Identifier: ISC
+ *
+ * Copyright (C) 2026 Michael Drake <tlsa@netsurf-browser.org>
+ */
+
+/**
+ * \file
+ * \brief CYAML native scanner.
+ *
+ * This handles single document input made of block mappings and sequences,
+ * single line plain and quoted scalars, single line flow collections of
+ * scalars, and comments.  Anything else, for example tags, anchors, aliases,
+ * block scalars and multi-line scalars, is reported as unsupported, so the
+ * caller can use `libyaml` instead.
+ *
+ * Anything the scanner accepts, it must give the same events for as `libyaml`
+ * would, so it is strict about what it accepts.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+
+#include "mem.h"
+#include "scan.h"
+
+/** Maximum length of an implicit key, as for `libyaml`. */
+#define CYAML_SCAN_KEY_MAX 1024
+
+/** A scanned scalar token. */
+typedef struct cyaml_scan_token {
+	size_t mark;   /**< Offset of the start of the token. */
+	size_t start;  /**< Offset of the start of the scalar's content. */
+	size_t end;    /**< Offset of the end of the scalar's content. */
+	size_t next;   /**< Offset after the token. */
+	yaml_scalar_style_t style; /**< Scalar style. */
+} cyaml_scan_token_t;
+
+/** Result of checking for an implicit block mapping key. */
+typedef enum cyaml_scan_key {
+	CYAML_SCAN_KEY_NO,          /**< Not a key. */
+	CYAML_SCAN_KEY_YES,         /**< A key. */
+	CYAML_SCAN_KEY_UNSUPPORTED, /**< Not something the scanner handles. */
+} cyaml_scan_key_t;
+
+/**
+ * Get the byte at an offset into the input.
+ *
+ * Input with NUL bytes is rejected by \ref cyaml__scan_input_valid, so
+ * NUL is used to mean the end of the input.
+ *
+ * \param[in]  scan  The native scanner.
+ * \param[in]  pos   Offset into the input.
+ * \return the byte at `pos`, or 0 at the end of the input.
+ */
+static inline uint8_t cyaml__scan_at(
+		const cyaml_scan_t *scan,
+		size_t pos)
+{
+	return (pos < scan->input_len) ? scan->input[pos] : 0;
+}
+
+/**
+ * Check whether an offset is at a line break or the end of the input.
+ *
+ * \param[in]  scan  The native scanner.
+ * \param[in]  pos   Offset into the input.
+ * \return true if `pos` is at a line break or the end of the input.
+ */
+static inline bool cyaml__scan_is_break(
+		const cyaml_scan_t *scan,
+		size_t pos)
+{
+	switch (cyaml__scan_at(scan, pos)) {
+	case '\0': /* Fall through. */
+	case '\r': /* Fall through. */
+	case '\n':
+		return true;
+	default:
+		return false;
+	}
+}
+
+/**
+ * Check whether an offset is at a space, a line break or the end of input.
+ *
+ * \param[in]  scan  The native scanner.
+ * \param[in]  pos   Offset into the input.
+ * \return true if `pos` is at a space, line break, or the end of the input.
+ */
+static inline bool cyaml__scan_is_blank(
+		const cyaml_scan_t *scan,
+		size_t pos)
+{
+	return cyaml__scan_at(scan, pos) == ' ' ||
+			cyaml__scan_is_break(scan, pos);
+}
+
+/**
+ * Check whether an offset is at a flow collection indicator.
+ *
+ * \param[in]  scan  The native scanner.
+ * \param[in]  pos   Offset into the input.
+ * \return true if `pos` is at a flow indicator.
+ */
+static inline bool cyaml__scan_is_flow_indicator(
+		const cyaml_scan_t *scan,
+		size_t pos)
+{
+	switch (cyaml__scan_at(scan, pos)) {
+	case ',': /* Fall through. */
+	case '[': /* Fall through. */
+	case ']': /* Fall through. */
+	case '{': /* Fall through. */
+	case '}':
+		return true;
+	default:
+		return false;
+	}
+}
+
+/**
+ * Check whether an offset is at a block sequence entry indicator.
+ *
+ * \param[in]  scan  The native scanner.
+ * \param[in]  pos   Offset into the input.
+ * \return true if `pos` is at a block sequence entry indicator.
+ */
+static inline bool cyaml__scan_is_entry(
+		const cyaml_scan_t *scan,
+		size_t pos)
+{
+	return cyaml__scan_at(scan, pos) == '-' &&
+			cyaml__scan_is_blank(scan, pos + 1);
+}
+
+/**
+ * Check whether an offset is at a document start or end marker.
+ *
+ * \param[in]  scan  The native scanner.
+ * \param[in]  pos   Offset of the start of a line.
+ * \return true if `pos` is at a document marker.
+ */
+static inline bool cyaml__scan_is_marker(
+		const cyaml_scan_t *scan,
+		size_t pos)
+{
+	if (scan->input_len - pos < 3) {
+		return false;
+	}
+
+	if (memcmp(scan->input + pos, "---", 3) != 0 &&
+	    memcmp(scan->input + pos, "...", 3) != 0) {
+		return false;
+	}
+
+	return cyaml__scan_is_blank(scan, pos + 3);
+}
+
+/**
+ * Check whether an offset is at a valid start for a plain scalar.
+ *
+ * Some characters that `libyaml` allows to start a plain scalar are
+ * rejected, to keep this simple.
+ *
+ * \param[in]  scan  The native scanner.
+ * \param[in]  pos   Offset into the input.
+ * \param[in]  flow  Whether the scalar is in a flow collection.
+ * \return true if a plain scalar can start at `pos`.
+ */
+static bool cyaml__scan_is_plain_start(
+		const cyaml_scan_t *scan,
+		size_t pos,
+		bool flow)
+{
+	switch (cyaml__scan_at(scan, pos)) {
+	case '-':
+		return !cyaml__scan_is_blank(scan, pos + 1) &&
+				!(flow && cyaml__scan_is_flow_indicator(
+						scan, pos + 1));
+	case '?':  /* Fall through. */
+	case ':':  /* Fall through. */
+	case ',':  /* Fall through. */
+	case '[':  /* Fall through. */
+	case ']':  /* Fall through. */
+	case '{':  /* Fall through. */
+	case '}':  /* Fall through. */
+	case '#':  /* Fall through. */
+	case '&':  /* Fall through. */
+	case '*':  /* Fall through. */
+	case '!':  /* Fall through. */
+	case '|':  /* Fall through. */
+	case '>':  /* Fall through. */
+	case '\'': /* Fall through. */
+	case '"':  /* Fall through. */
+	case '%':  /* Fall through. */
+	case '@':  /* Fall through. */
+	case '`':  /* Fall through. */
+	case ' ':  /* Fall through. */
+	case '\t':
+		return false;
+	default:
+		return !cyaml__scan_is_break(scan, pos);
+	}
+}
+
+/**
+ * Check that the input has only characters the scanner handles.
+ *
+ * This allows printable ASCII, tabs, line feeds, carriage return line
+ * feed pairs, and UTF-8 encoded characters from the Basic Multilingual
+ * Plane, other than surrogates, non-characters, byte order marks, and the
+ * Unicode line and paragraph separators, which `libyaml` treats as
+ * line breaks.
+ *
+ * \param[in]  input      The input to check.
+ * \param[in]  input_len  Length of input in bytes.
+ * \return true if the input is acceptable.
+ */
+static bool cyaml__scan_input_valid(
+		const uint8_t *input,
+		size_t input_len)
+{
+	size_t pos = 0;
+
+	while (pos < input_len) {
+		uint8_t c = input[pos];
+		uint32_t cp;
+
+		if ((c >= 0x20 && c < 0x7f) || c == '\n' || c == '\t') {
+			pos++;
+			continue;
+		} else if (c == '\r') {
+			if (pos + 1 >= input_len || input[pos + 1] != '\n') {
+				return false;
+			}
+			pos += 2;
+			continue;
+		} else if (c >= 0xc2 && c <= 0xdf) {
+			if (input_len - pos < 2 ||
+			    (input[pos + 1] & 0xc0) != 0x80) {
+				return false;
+			}
+			cp = ((uint32_t)(c & 0x1f) << 6) |
+					(input[pos + 1] & 0x3f);
+			pos += 2;
+		} else if (c >= 0xe0 && c <= 0xef) {
+			if (input_len - pos < 3 ||
+			    (input[pos + 1] & 0xc0) != 0x80 ||
+			    (input[pos + 2] & 0xc0) != 0x80) {
+				return false;
+			}
+			cp = ((uint32_t)(c & 0x0f) << 12) |
+					((uint32_t)(input[pos + 1] & 0x3f) << 6) |
+					(input[pos + 2] & 0x3f);
+			if (cp < 0x800 || (cp >= 0xd800 && cp <= 0xdfff)) {
+				return false;
+			}
+			pos += 3;
+		} else {
+			return false;
+		}
+
+		if (cp < 0xa0 || cp == 0x2028 || cp == 0x2029 ||
+		    cp == 0xfeff || cp >= 0xfffe) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/**
+ * Move the scanner to the start of the next line.
+ *
+ * \param[in]  scan  The native scanner.
+ * \param[in]  pos   Offset of a line break, or the end of the input.
+ */
+static void cyaml__scan_newline(
+		cyaml_scan_t *scan,
+		size_t pos)
+{
+	assert(cyaml__scan_is_break(scan, pos));
+
+	if (pos >= scan->input_len) {
+		scan->pos = scan->input_len;
+		return;
+	}
+
+	if (scan->input[pos] == '\r') {
+		pos++;
+	}
+	pos++;
+
+	scan->pos = pos;
+	scan->line_start = pos;
+	scan->line++;
+}
+
+/**
+ * Skip to the end of the current line.
+ *
+ * \param[in]  scan  The native scanner.
+ * \param[in]  pos   Offset into the current line.
+ * \return offset of the line break, or the end of the input.
+ */
+static inline size_t cyaml__scan_line_end(
+		const cyaml_scan_t *scan,
+		size_t pos)
+{
+	while (!cyaml__scan_is_break(scan, pos)) {
+		pos++;
+	}
+
+	return pos;
+}
+
+/**
+ * Skip blank lines and comment lines.
+ *
+ * Leaves the scanner at the next content, or the end of the input.
+ *
+ * \param[in]  scan  The native scanner.
+ */
+static void cyaml__scan_skip_lines(
+		cyaml_scan_t *scan)
+{
+	for (;;) {
+		size_t pos = scan->pos;
+
+		while (cyaml__scan_at(scan, pos) == ' ') {
+			pos++;
+		}
+		if (cyaml__scan_at(scan, pos) == '#') {
+			pos = cyaml__scan_line_end(scan, pos);
+		}
+		if (pos >= scan->input_len || !cyaml__scan_is_break(scan, pos)) {
+			scan->pos = pos;
+			return;
+		}
+		cyaml__scan_newline(scan, pos);
+	}
+}
+
+/**
+ * Ensure the scalar buffer is big enough.
+ *
+ * \param[in]  scan  The native scanner.
+ * \param[in]  size  Required buffer size in bytes.
+ * \return true on success, false on allocation failure.
+ */
+static bool cyaml__scan_buf_ensure(
+		cyaml_scan_t *scan,
+		size_t size)
+{
+	size_t new_size = (scan->buf_size == 0) ? 64 : scan->buf_size;
+	char *temp;
+
+	if (size <= scan->buf_size) {
+		return true;
+	}
+
+	while (new_size < size) {
+		new_size *= 2;
+	}
+
+	temp = cyaml__realloc(scan->config, scan->buf,
+			scan->buf_size, new_size, false);
+	if (temp == NULL) {
+		return false;
+	}
+
+	scan->buf = temp;
+	scan->buf_size = new_size;
+	return true;
+}
+
+/**
+ * Write a Unicode codepoint as UTF-8.
+ *
+ * \param[in]  cp   The codepoint to write.
+ * \param[out] out  Buffer to write to, with space for four bytes.
+ * \return number of bytes written.
+ */
+static size_t cyaml__scan_utf8(
+		uint32_t cp,
+		char *out)
+{
+	if (cp < 0x80) {
+		out[0] = (char)cp;
+		return 1;
+	} else if (cp < 0x800) {
+		out[0] = (char)(0xc0 | (cp >> 6));
+		out[1] = (char)(0x80 | (cp & 0x3f));
+		return 2;
+	} else if (cp < 0x10000) {
+		out[0] = (char)(0xe0 | (cp >> 12));
+		out[1] = (char)(0x80 | ((cp >> 6) & 0x3f));
+		out[2] = (char)(0x80 | (cp & 0x3f));
+		return 3;
+	}
+
+	out[0] = (char)(0xf0 | (cp >> 18));
+	out[1] = (char)(0x80 | ((cp >> 12) & 0x3f));
+	out[2] = (char)(0x80 | ((cp >> 6) & 0x3f));
+	out[3] = (char)(0x80 | (cp & 0x3f));
+	return 4;
+}
+
+/**
+ * Decode a hexadecimal escape in a double quoted scalar.
+ *
+ * \param[in]  scan    The native scanner.
+ * \param[in]  pos     Offset of the first hex digit.
+ * \param[in]  end     Offset of the end of the scalar's content.
+ * \param[in]  digits  Number of hex digits.
+ * \param[out] cp_out  Returns the escaped codepoint on success.
+ * \return true on success, false if the escape is invalid.
+ */
+static bool cyaml__scan_hex(
+		const cyaml_scan_t *scan,
+		size_t pos,
+		size_t end,
+		unsigned digits,
+		uint32_t *cp_out)
+{
+	uint32_t cp = 0;
+
+	if (end - pos < digits) {
+		return false;
+	}
+
+	for (unsigned i = 0; i < digits; i++) {
+		uint8_t c = scan->input[pos + i];
+
+		if (c >= '0' && c <= '9') {
+			cp = (cp << 4) | (uint32_t)(c - '0');
+		} else if (c >= 'a' && c <= 'f') {
+			cp = (cp << 4) | (uint32_t)(c - 'a' + 10);
+		} else if (c >= 'A' && c <= 'F') {
+			cp = (cp << 4) | (uint32_t)(c - 'A' + 10);
+		} else {
+			return false;
+		}
+	}
+
+	if ((cp >= 0xd800 && cp <= 0xdfff) || cp > 0x10ffff) {
+		return false;
+	}
+
+	*cp_out = cp;
+	return true;
+}
+
+/**
+ * Decode the content of a double quoted scalar.
+ *
+ * \param[in]  scan     The native scanner.
+ * \param[in]  tok      The scalar token.
+ * \param[out] out      Buffer to write the value to.
+ * \param[out] len_out  Returns the value length on success.
+ * \return true on success, false if the scalar has an unsupported escape.
+ */
+static bool cyaml__scan_decode_double(
+		const cyaml_scan_t *scan,
+		const cyaml_scan_token_t *tok,
+		char *out,
+		size_t *len_out)
+{
+	size_t len = 0;
+
+	for (size_t pos = tok->start; pos < tok->end; pos++) {
+		uint8_t c = scan->input[pos];
+		uint32_t cp;
+
+		if (c != '\\') {
+			out[len++] = (char)c;
+			continue;
+		}
+
+		switch (scan->input[++pos]) {
+		case '0':  cp = 0x00; break;
+		case 'a':  cp = 0x07; break;
+		case 'b':  cp = 0x08; break;
+		case 't':  /* Fall through. */
+		case '\t': cp = 0x09; break;
+		case 'n':  cp = 0x0a; break;
+		case 'v':  cp = 0x0b; break;
+		case 'f':  cp = 0x0c; break;
+		case 'r':  cp = 0x0d; break;
+		case 'e':  cp = 0x1b; break;
+		case ' ':  cp = ' ';  break;
+		case '"':  cp = '"';  break;
+		case '/':  cp = '/';  break;
+		case '\\': cp = '\\'; break;
+		case 'N':  cp = 0x85; break;
+		case '_':  cp = 0xa0; break;
+		case 'L':  cp = 0x2028; break;
+		case 'P':  cp = 0x2029; break;
+		case 'x':
+			if (!cyaml__scan_hex(scan, pos + 1, tok->end, 2, &cp)) {
+				return false;
+			}
+			pos += 2;
+			break;
+		case 'u':
+			if (!cyaml__scan_hex(scan, pos + 1, tok->end, 4, &cp)) {
+				return false;
+			}
+			pos += 4;
+			break;
+		case 'U':
+			if (!cyaml__scan_hex(scan, pos + 1, tok->end, 8, &cp)) {
+				return false;
+			}
+			pos += 8;
+			break;
+		default:
+			return false;
+		}
+
+		len += cyaml__scan_utf8(cp, out + len);
+	}
+
+	*len_out = len;
+	return true;
+}
+
+/**
+ * Get the mark for an offset on the current line.
+ *
+ * As for `libyaml`, the column counts characters.  The index is the byte
+ * offset.  Marks are mostly found in input order, so the count continues
+ * from the previous column found, when it was earlier on the same line.
+ *
+ * \param[in]  scan  The native scanner.
+ * \param[in]  pos   Offset on the current line.
+ * \return the mark for `pos`.
+ */
+static yaml_mark_t cyaml__scan_mark(
+		cyaml_scan_t *scan,
+		size_t pos)
+{
+	if (scan->column_pos < scan->line_start || scan->column_pos > pos) {
+		scan->column_pos = scan->line_start;
+		scan->column = 0;
+	}
+
+	while (scan->column_pos < pos) {
+		if ((scan->input[scan->column_pos++] & 0xc0) != 0x80) {
+			scan->column++;
+		}
+	}
+
+	return (yaml_mark_t) {
+		.index = pos,
+		.line = scan->line,
+		.column = scan->column,
+	};
+}
+
+/**
+ * Fill out an event with no data.
+ *
+ * \param[in]  scan   The native scanner.
+ * \param[out] event  The event to fill out.
+ * \param[in]  type   The event type.
+ * \param[in]  pos    Offset of the event on the current line.
+ */
+static void cyaml__scan_event(
+		cyaml_scan_t *scan,
+		yaml_event_t *event,
+		yaml_event_type_t type,
+		size_t pos)
+{
+	memset(event, 0, sizeof(*event));
+
+	event->type = type;
+	event->start_mark = cyaml__scan_mark(scan, pos);
+	event->end_mark = event->start_mark;
+}
+
+/**
+ * Fill out a scalar event.
+ *
+ * \param[in]  scan   The native scanner.
+ * \param[out] event  The event to fill out.
+ * \param[in]  tok    The scalar token.
+ * \return \ref CYAML_SCAN_OK on success, or appropriate result code otherwise.
+ */
+static cyaml_scan_result_t cyaml__scan_scalar(
+		cyaml_scan_t *scan,
+		yaml_event_t *event,
+		const cyaml_scan_token_t *tok)
+{
+	const uint8_t *input = scan->input;
+	size_t len = 0;
+
+	/* Decoded values are never longer than their source. */
+	if (!cyaml__scan_buf_ensure(scan, tok->end - tok->start + 1)) {
+		return CYAML_SCAN_OOM;
+	}
+
+	switch (tok->style) {
+	case YAML_SINGLE_QUOTED_SCALAR_STYLE:
+		for (size_t pos = tok->start; pos < tok->end; pos++) {
+			scan->buf[len++] = (char)input[pos];
+			if (input[pos] == '\'') {
+				pos++;
+			}
+		}
+		break;
+	case YAML_DOUBLE_QUOTED_SCALAR_STYLE:
+		if (!cyaml__scan_decode_double(scan, tok, scan->buf, &len)) {
+			return CYAML_SCAN_UNSUPPORTED;
+		}
+		break;
+	default:
+		len = tok->end - tok->start;
+		memcpy(scan->buf, input + tok->start, len);
+		break;
+	}
+	scan->buf[len] = '\0';
+
+	/* As for `libyaml`, the end mark is after the closing quote of
+	 * quoted scalars, and after the last character of plain scalars. */
+	cyaml__scan_event(scan, event, YAML_SCALAR_EVENT, tok->mark);
+	event->end_mark = cyaml__scan_mark(scan,
+			(tok->style == YAML_PLAIN_SCALAR_STYLE) ?
+					tok->end : tok->end + 1);
+	event->data.scalar.value = (yaml_char_t *)scan->buf;
+	event->data.scalar.length = len;
+	event->data.scalar.style = tok->style;
+	event->data.scalar.plain_implicit =
+			(tok->style == YAML_PLAIN_SCALAR_STYLE);
+	event->data.scalar.quoted_implicit =
+			(tok->style != YAML_PLAIN_SCALAR_STYLE);
+
+	return CYAML_SCAN_OK;
+}
+
+/**
+ * Fill out an empty plain scalar event for the expected block node.
+ *
+ * As for `libyaml`, the event is marked just after the node's indicator.
+ *
+ * \param[in]  scan   The native scanner.
+ * \param[out] event  The event to fill out.
+ * \return \ref CYAML_SCAN_OK on success, or appropriate result code otherwise.
+ */
+static cyaml_scan_result_t cyaml__scan_empty(
+		cyaml_scan_t *scan,
+		yaml_event_t *event)
+{
+	cyaml_scan_token_t tok = {
+		.mark = scan->pos,
+		.start = scan->pos,
+		.end = scan->pos,
+		.next = scan->pos,
+		.style = YAML_PLAIN_SCALAR_STYLE,
+	};
+	cyaml_scan_result_t res;
+
+	res = cyaml__scan_scalar(scan, event, &tok);
+	if (res == CYAML_SCAN_OK) {
+		event->start_mark = scan->pending_mark;
+		event->end_mark = scan->pending_mark;
+	}
+
+	return res;
+}
+
+/**
+ * Scan a single line quoted scalar.
+ *
+ * \param[in]  scan  The native scanner.
+ * \param[in]  pos   Offset of the opening quote.
+ * \param[out] tok   Returns the scalar token on success.
+ * \return true on success, false if the scalar isn't closed on the line.
+ */
+static bool cyaml__scan_quoted(
+		const cyaml_scan_t *scan,
+		size_t pos,
+		cyaml_scan_token_t *tok)
+{
+	uint8_t quote = cyaml__scan_at(scan, pos);
+
+	tok->mark = pos++;
+	tok->start = pos;
+	tok->style = (quote == '"') ?
+			YAML_DOUBLE_QUOTED_SCALAR_STYLE :
+			YAML_SINGLE_QUOTED_SCALAR_STYLE;
+
+	for (;;) {
+		uint8_t c = cyaml__scan_at(scan, pos);
+
+		if (cyaml__scan_is_break(scan, pos)) {
+			return false;
+		} else if (c == quote) {
+			if (quote == '\'' && cyaml__scan_at(scan, pos + 1) == '\'') {
+				pos += 2;
+				continue;
+			}
+			break;
+		} else if (c == '\\' && quote == '"') {
+			if (cyaml__scan_is_break(scan, pos + 1)) {
+				return false;
+			}
+			pos++;
+		}
+		pos++;
+	}
+
+	tok->end = pos;
+	tok->next = pos + 1;
+	return true;
+}
+
+/**
+ * Scan a plain scalar in block context.
+ *
+ * The scalar ends at the end of the line, a comment, or a mapping value
+ * indicator.
+ *
+ * \param[in]  scan       The native scanner.
+ * \param[in]  pos        Offset of the start of the scalar.
+ * \param[out] tok        Returns the scalar token on success.
+ * \param[out] colon_out  Returns whether the scalar ended at a mapping
+ *                        value indicator.
+ * \return true on success, false if the scalar contains a tab.
+ */
+static bool cyaml__scan_block_plain(
+		const cyaml_scan_t *scan,
+		size_t pos,
+		cyaml_scan_token_t *tok,
+		bool *colon_out)
+{
+	size_t end = pos;
+
+	tok->mark = pos;
+	tok->start = pos;
+	tok->style = YAML_PLAIN_SCALAR_STYLE;
+	*colon_out = false;
+
+	while (!cyaml__scan_is_break(scan, pos)) {
+		uint8_t c = scan->input[pos];
+
+		if (c == ':' && cyaml__scan_is_blank(scan, pos + 1)) {
+			*colon_out = true;
+			break;
+		} else if (c == ' ') {
+			if (cyaml__scan_at(scan, pos + 1) == '#') {
+				break;
+			}
+			pos++;
+			continue;
+		} else if (c == '\t') {
+			return false;
+		}
+		end = ++pos;
+	}
+
+	tok->end = end;
+	tok->next = pos;
+	return true;
+}
+
+/**
+ * Scan a plain scalar in a flow collection.
+ *
+ * \param[in]  scan  The native scanner.
+ * \param[in]  pos   Offset of the start of the scalar.
+ * \param[out] tok   Returns the scalar token on success.
+ * \return true on success, false if the scalar isn't supported.
+ */
+static bool cyaml__scan_flow_plain(
+		const cyaml_scan_t *scan,
+		size_t pos,
+		cyaml_scan_token_t *tok)
+{
+	size_t end = pos;
+
+	if (!cyaml__scan_is_plain_start(scan, pos, true)) {
+		return false;
+	}
+
+	tok->mark = pos;
+	tok->start = pos;
+	tok->style = YAML_PLAIN_SCALAR_STYLE;
+
+	while (!cyaml__scan_is_break(scan, pos) &&
+	       !cyaml__scan_is_flow_indicator(scan, pos)) {
+		uint8_t c = scan->input[pos];
+
+		if (c == ':') {
+			if (cyaml__scan_is_blank(scan, pos + 1) ||
+			    cyaml__scan_is_flow_indicator(scan, pos + 1)) {
+				break;
+			}
+			return false;
+		} else if (c == ' ') {
+			if (cyaml__scan_at(scan, pos + 1) == '#') {
+				break;
+			}
+			pos++;
+			continue;
+		} else if (c == '\t') {
+			return false;
+		}
+		end = ++pos;
+	}
+
+	tok->end = end;
+	tok->next = pos;
+	return true;
+}
+
+/**
+ * Check for an implicit block mapping key.
+ *
+ * \param[in]  scan  The native scanner.
+ * \param[in]  pos   Offset of the possible key.
+ * \param[out] tok   Returns the key token if it is a key.  The token's
+ *                   `next` member is set to the offset after the mapping
+ *                   value indicator.
+ * \return whether there is a key at `pos`.
+ */
+static cyaml_scan_key_t cyaml__scan_key(
+		const cyaml_scan_t *scan,
+		size_t pos,
+		cyaml_scan_token_t *tok)
+{
+	size_t colon;
+
+	switch (cyaml__scan_at(scan, pos)) {
+	case '\'': /* Fall through. */
+	case '"':
+		if (!cyaml__scan_quoted(scan, pos, tok)) {
+			return CYAML_SCAN_KEY_UNSUPPORTED;
+		}
+		colon = tok->next;
+		while (cyaml__scan_at(scan, colon) == ' ') {
+			colon++;
+		}
+		if (cyaml__scan_at(scan, colon) != ':' ||
+		    !cyaml__scan_is_blank(scan, colon + 1)) {
+			return CYAML_SCAN_KEY_NO;
+		}
+		break;
+	default:
+		if (!cyaml__scan_is_plain_start(scan, pos, false)) {
+			return CYAML_SCAN_KEY_NO;
+		} else {
+			bool is_key;
+
+			if (!cyaml__scan_block_plain(scan, pos, tok, &is_key)) {
+				return CYAML_SCAN_KEY_UNSUPPORTED;
+			}
+			if (!is_key) {
+				return CYAML_SCAN_KEY_NO;
+			}
+			colon = tok->next;
+		}
+		break;
+	}
+
+	if (colon - pos > CYAML_SCAN_KEY_MAX) {
+		return CYAML_SCAN_KEY_UNSUPPORTED;
+	}
+
+	tok->next = colon + 1;
+	return CYAML_SCAN_KEY_YES;
+}
+
+/**
+ * Open a collection.
+ *
+ * \param[in]  scan   The native scanner.
+ * \param[out] event  Returns the collection start event on success.
+ * \param[in]  type   The collection type.
+ * \param[in]  pos    Offset of the start of the collection.
+ * \return \ref CYAML_SCAN_OK on success, or appropriate result code otherwise.
+ */
+static cyaml_scan_result_t cyaml__scan_push(
+		cyaml_scan_t *scan,
+		yaml_event_t *event,
+		cyaml_scan_type_t type,
+		size_t pos)
+{
+	cyaml_scan_level_t *level;
+
+	if (scan->depth == CYAML_SCAN_DEPTH_MAX) {
+		return CYAML_SCAN_UNSUPPORTED;
+	}
+
+	level = &scan->levels[scan->depth++];
+	level->type = type;
+	level->expect = CYAML_SCAN_EXPECT_ENTRY;
+	level->indent = (int64_t)(pos - scan->line_start);
+
+	switch (type) {
+	case CYAML_SCAN_BLOCK_MAP:
+		cyaml__scan_event(scan, event, YAML_MAPPING_START_EVENT, pos);
+		event->data.mapping_start.implicit = 1;
+		event->data.mapping_start.style = YAML_BLOCK_MAPPING_STYLE;
+		break;
+	case CYAML_SCAN_FLOW_MAP:
+		cyaml__scan_event(scan, event, YAML_MAPPING_START_EVENT, pos);
+		event->end_mark = cyaml__scan_mark(scan, pos + 1);
+		event->data.mapping_start.implicit = 1;
+		event->data.mapping_start.style = YAML_FLOW_MAPPING_STYLE;
+		break;
+	case CYAML_SCAN_BLOCK_SEQ:
+		cyaml__scan_event(scan, event, YAML_SEQUENCE_START_EVENT, pos);
+		event->data.sequence_start.implicit = 1;
+		event->data.sequence_start.style = YAML_BLOCK_SEQUENCE_STYLE;
+		break;
+	case CYAML_SCAN_FLOW_SEQ:
+		cyaml__scan_event(scan, event, YAML_SEQUENCE_START_EVENT, pos);
+		event->end_mark = cyaml__scan_mark(scan, pos + 1);
+		event->data.sequence_start.implicit = 1;
+		event->data.sequence_start.style = YAML_FLOW_SEQUENCE_STYLE;
+		break;
+	}
+
+	return CYAML_SCAN_OK;
+}
+
+/**
+ * Close the innermost collection.
+ *
+ * \param[in]  scan   The native scanner.
+ * \param[out] event  Returns the collection end event.
+ * \param[in]  pos    Offset of the end of the collection.
+ */
+static void cyaml__scan_pop(
+		cyaml_scan_t *scan,
+		yaml_event_t *event,
+		size_t pos)
+{
+	cyaml_scan_type_t type;
+
+	assert(scan->depth > 0);
+
+	type = scan->levels[--scan->depth].type;
+	cyaml__scan_event(scan, event,
+			(type == CYAML_SCAN_BLOCK_MAP ||
+			 type == CYAML_SCAN_FLOW_MAP) ?
+					YAML_MAPPING_END_EVENT :
+					YAML_SEQUENCE_END_EVENT, pos);
+}
+
+/**
+ * Expect a block node.
+ *
+ * \param[in]  scan    The native scanner.
+ * \param[in]  indent  Indentation of the collection the node belongs to.
+ * \param[in]  map     Whether the node is a mapping value.
+ */
+static inline void cyaml__scan_expect_node(
+		cyaml_scan_t *scan,
+		int64_t indent,
+		bool map)
+{
+	scan->pending = true;
+	scan->pending_map = map;
+	scan->pending_inline = false;
+	scan->pending_indent = indent;
+	scan->pending_mark = cyaml__scan_mark(scan, scan->pos);
+}
+
+/**
+ * Handle the start of the document.
+ *
+ * \param[in]  scan   The native scanner.
+ * \param[out] event  Returns the document start event on success.
+ * \return \ref CYAML_SCAN_OK on success, or appropriate result code otherwise.
+ */
+static cyaml_scan_result_t cyaml__scan_doc_start(
+		cyaml_scan_t *scan,
+		yaml_event_t *event)
+{
+	bool explicit = false;
+	yaml_mark_t start;
+	yaml_mark_t end;
+
+	cyaml__scan_skip_lines(scan);
+
+	if (scan->pos == scan->line_start && cyaml__scan_is_marker(scan,
+			scan->pos) && scan->input[scan->pos] == '-') {
+		size_t pos = scan->pos + 3;
+
+		/* As for `libyaml`, the event is marked at the marker. */
+		start = cyaml__scan_mark(scan, scan->pos);
+		end = cyaml__scan_mark(scan, pos);
+
+		while (cyaml__scan_at(scan, pos) == ' ') {
+			pos++;
+		}
+		if (cyaml__scan_at(scan, pos) == '#') {
+			pos = cyaml__scan_line_end(scan, pos);
+		}
+		if (!cyaml__scan_is_break(scan, pos)) {
+			return CYAML_SCAN_UNSUPPORTED;
+		}
+		cyaml__scan_newline(scan, pos);
+		cyaml__scan_skip_lines(scan);
+		explicit = true;
+	}
+
+	if (scan->pos >= scan->input_len) {
+		return CYAML_SCAN_UNSUPPORTED;
+	}
+
+	cyaml__scan_event(scan, event, YAML_DOCUMENT_START_EVENT, scan->pos);
+	event->data.document_start.implicit = !explicit;
+	if (explicit) {
+		event->start_mark = start;
+		event->end_mark = end;
+	}
+
+	cyaml__scan_expect_node(scan, -1, false);
+	scan->state = CYAML_SCAN_LINE;
+	return CYAML_SCAN_OK;
+}
+
+/**
+ * Handle the start of a line's content in block context.
+ *
+ * \param[in]  scan     The native scanner.
+ * \param[out] event    Returns an event on success, if one was produced.
+ * \param[out] emitted  Returns whether an event was produced.
+ * \return \ref CYAML_SCAN_OK on success, or appropriate result code otherwise.
+ */
+static cyaml_scan_result_t cyaml__scan_line(
+		cyaml_scan_t *scan,
+		yaml_event_t *event,
+		bool *emitted)
+{
+	const cyaml_scan_level_t *top;
+	cyaml_scan_token_t tok;
+	size_t pos;
+	bool eof;
+	int64_t col;
+
+	cyaml__scan_skip_lines(scan);
+
+	pos = scan->pos;
+	eof = (pos >= scan->input_len);
+	col = eof ? -1 : (int64_t)(pos - scan->line_start);
+
+	/* As for `libyaml`, the end of the input is on a line of its own. */
+	if (eof && pos > scan->line_start) {
+		scan->line_start = pos;
+		scan->line++;
+		scan->column_pos = pos;
+		scan->column = 0;
+	}
+
+	if (col == 0 && cyaml__scan_is_marker(scan, pos)) {
+		return CYAML_SCAN_UNSUPPORTED;
+	}
+
+	if (scan->pending) {
+		if (!eof && (col > scan->pending_indent ||
+				(col == scan->pending_indent &&
+				 scan->pending_map &&
+				 cyaml__scan_is_entry(scan, pos)))) {
+			scan->state = CYAML_SCAN_NODE;
+			return CYAML_SCAN_OK;
+		}
+
+		scan->pending = false;
+		*emitted = true;
+		return cyaml__scan_empty(scan, event);
+	}
+
+	if (scan->depth == 0) {
+		if (!eof) {
+			return CYAML_SCAN_UNSUPPORTED;
+		}
+		cyaml__scan_event(scan, event, YAML_DOCUMENT_END_EVENT, pos);
+		event->data.document_end.implicit = 1;
+		scan->state = CYAML_SCAN_STREAM_END;
+		*emitted = true;
+		return CYAML_SCAN_OK;
+	}
+
+	top = &scan->levels[scan->depth - 1];
+	assert(top->type == CYAML_SCAN_BLOCK_MAP ||
+	       top->type == CYAML_SCAN_BLOCK_SEQ);
+
+	/* Close collections that are more indented than the line, and
+	 * sequences that share their indentation with a parent mapping,
+	 * when the line isn't another entry. */
+	if (top->indent > col ||
+	    (top->indent == col && top->type == CYAML_SCAN_BLOCK_SEQ &&
+	     !cyaml__scan_is_entry(scan, pos) && scan->depth >= 2 &&
+	     scan->levels[scan->depth - 2].type == CYAML_SCAN_BLOCK_MAP &&
+	     scan->levels[scan->depth - 2].indent == col)) {
+		cyaml__scan_pop(scan, event, pos);
+		*emitted = true;
+		return CYAML_SCAN_OK;
+	}
+
+	if (top->indent < col) {
+		return CYAML_SCAN_UNSUPPORTED;
+	}
+
+	if (top->type == CYAML_SCAN_BLOCK_SEQ) {
+		if (!cyaml__scan_is_entry(scan, pos)) {
+			return CYAML_SCAN_UNSUPPORTED;
+		}
+		scan->pos = pos + 1;
+		cyaml__scan_expect_node(scan, col, false);
+		scan->state = CYAML_SCAN_INLINE;
+		return CYAML_SCAN_OK;
+	}
+
+	if (cyaml__scan_key(scan, pos, &tok) != CYAML_SCAN_KEY_YES) {
+		return CYAML_SCAN_UNSUPPORTED;
+	}
+	scan->pos = tok.next;
+	cyaml__scan_expect_node(scan, col, true);
+	scan->state = CYAML_SCAN_INLINE;
+	*emitted = true;
+	return cyaml__scan_scalar(scan, event, &tok);
+}
+
+/**
+ * Handle the rest of a line after a block indicator.
+ *
+ * \param[in]  scan  The native scanner.
+ */
+static void cyaml__scan_inline(
+		cyaml_scan_t *scan)
+{
+	size_t pos = scan->pos;
+
+	while (cyaml__scan_at(scan, pos) == ' ') {
+		pos++;
+	}
+
+	if (cyaml__scan_at(scan, pos) == '#') {
+		pos = cyaml__scan_line_end(scan, pos);
+	}
+
+	if (cyaml__scan_is_break(scan, pos)) {
+		cyaml__scan_newline(scan, pos);
+		scan->state = CYAML_SCAN_LINE;
+		return;
+	}
+
+	scan->pos = pos;
+	scan->pending_inline = true;
+	scan->state = CYAML_SCAN_NODE;
+}
+
+/**
+ * Handle the start of a block node.
+ *
+ * \param[in]  scan   The native scanner.
+ * \param[out] event  Returns the node's first event on success.
+ * \return \ref CYAML_SCAN_OK on success, or appropriate result code otherwise.
+ */
+static cyaml_scan_result_t cyaml__scan_node(
+		cyaml_scan_t *scan,
+		yaml_event_t *event)
+{
+	bool nested = scan->pending_inline && scan->pending_map;
+	cyaml_scan_token_t tok;
+	size_t pos = scan->pos;
+	bool colon;
+
+	scan->pending = false;
+
+	if (cyaml__scan_is_entry(scan, pos)) {
+		cyaml_scan_result_t res;
+
+		if (nested) {
+			return CYAML_SCAN_UNSUPPORTED;
+		}
+		scan->state = CYAML_SCAN_LINE;
+		res = cyaml__scan_push(scan, event, CYAML_SCAN_BLOCK_SEQ, pos);
+
+		/* As for `libyaml`, a sequence with the same indentation
+		 * as its mapping is marked to the end of its first entry
+		 * indicator. */
+		if (res == CYAML_SCAN_OK && scan->pending_map &&
+		    (int64_t)(pos - scan->line_start) ==
+		    scan->pending_indent) {
+			event->end_mark = cyaml__scan_mark(scan, pos + 1);
+		}
+		return res;
+	}
+
+	switch (cyaml__scan_at(scan, pos)) {
+	case '[':
+		scan->pos = pos + 1;
+		scan->state = CYAML_SCAN_FLOW;
+		return cyaml__scan_push(scan, event,
+				CYAML_SCAN_FLOW_SEQ, pos);
+	case '{':
+		scan->pos = pos + 1;
+		scan->state = CYAML_SCAN_FLOW;
+		return cyaml__scan_push(scan, event,
+				CYAML_SCAN_FLOW_MAP, pos);
+	default:
+		break;
+	}
+
+	switch (cyaml__scan_key(scan, pos, &tok)) {
+	case CYAML_SCAN_KEY_YES:
+		if (nested) {
+			return CYAML_SCAN_UNSUPPORTED;
+		}
+		scan->state = CYAML_SCAN_LINE;
+		return cyaml__scan_push(scan, event,
+				CYAML_SCAN_BLOCK_MAP, pos);
+	case CYAML_SCAN_KEY_NO:
+		break;
+	default:
+		return CYAML_SCAN_UNSUPPORTED;
+	}
+
+	switch (cyaml__scan_at(scan, pos)) {
+	case '\'': /* Fall through. */
+	case '"':
+		if (!cyaml__scan_quoted(scan, pos, &tok)) {
+			return CYAML_SCAN_UNSUPPORTED;
+		}
+		break;
+	default:
+		if (!cyaml__scan_is_plain_start(scan, pos, false) ||
+		    !cyaml__scan_block_plain(scan, pos, &tok, &colon) ||
+		    colon) {
+			return CYAML_SCAN_UNSUPPORTED;
+		}
+		break;
+	}
+
+	scan->pos = tok.next;
+	scan->state = CYAML_SCAN_AFTER_NODE;
+	return cyaml__scan_scalar(scan, event, &tok);
+}
+
+/**
+ * Handle the rest of a line after a block node's scalar or flow collection.
+ *
+ * \param[in]  scan  The native scanner.
+ * \return \ref CYAML_SCAN_OK on success, or appropriate result code otherwise.
+ */
+static cyaml_scan_result_t cyaml__scan_after_node(
+		cyaml_scan_t *scan)
+{
+	size_t pos = scan->pos;
+
+	while (cyaml__scan_at(scan, pos) == ' ') {
+		pos++;
+	}
+
+	if (cyaml__scan_at(scan, pos) == '#') {
+		if (pos == scan->pos) {
+			return CYAML_SCAN_UNSUPPORTED;
+		}
+		pos = cyaml__scan_line_end(scan, pos);
+	}
+
+	if (!cyaml__scan_is_break(scan, pos)) {
+		return CYAML_SCAN_UNSUPPORTED;
+	}
+
+	cyaml__scan_newline(scan, pos);
+	scan->state = CYAML_SCAN_LINE;
+	return CYAML_SCAN_OK;
+}
+
+/**
+ * Close a flow collection.
+ *
+ * \param[in]  scan   The native scanner.
+ * \param[out] event  Returns the collection end event.
+ * \param[in]  pos    Offset of the collection's closing indicator.
+ */
+static void cyaml__scan_flow_end(
+		cyaml_scan_t *scan,
+		yaml_event_t *event,
+		size_t pos)
+{
+	cyaml__scan_pop(scan, event, pos);
+	event->end_mark = cyaml__scan_mark(scan, pos + 1);
+	scan->pos = pos + 1;
+
+	if (scan->depth == 0 ||
+	    scan->levels[scan->depth - 1].type == CYAML_SCAN_BLOCK_MAP ||
+	    scan->levels[scan->depth - 1].type == CYAML_SCAN_BLOCK_SEQ) {
+		scan->state = CYAML_SCAN_AFTER_NODE;
+	}
+}
+
+/**
+ * Handle the next token in a flow collection.
+ *
+ * \param[in]  scan     The native scanner.
+ * \param[out] event    Returns an event on success, if one was produced.
+ * \param[out] emitted  Returns whether an event was produced.
+ * \return \ref CYAML_SCAN_OK on success, or appropriate result code otherwise.
+ */
+static cyaml_scan_result_t cyaml__scan_flow(
+		cyaml_scan_t *scan,
+		yaml_event_t *event,
+		bool *emitted)
+{
+	cyaml_scan_level_t *top = &scan->levels[scan->depth - 1];
+	bool map = (top->type == CYAML_SCAN_FLOW_MAP);
+	uint8_t close = map ? '}' : ']';
+	cyaml_scan_token_t tok;
+	size_t pos = scan->pos;
+	uint8_t c;
+
+	while (cyaml__scan_at(scan, pos) == ' ') {
+		pos++;
+	}
+
+	/* Multi-line flow collections aren't supported. */
+	if (cyaml__scan_is_break(scan, pos) || cyaml__scan_at(scan, pos) == '#') {
+		return CYAML_SCAN_UNSUPPORTED;
+	}
+
+	c = scan->input[pos];
+	switch (top->expect) {
+	case CYAML_SCAN_EXPECT_COLON:
+		if (c != ':' || !cyaml__scan_is_blank(scan, pos + 1)) {
+			return CYAML_SCAN_UNSUPPORTED;
+		}
+		top->expect = CYAML_SCAN_EXPECT_VALUE;
+		scan->pos = pos + 1;
+		return CYAML_SCAN_OK;
+
+	case CYAML_SCAN_EXPECT_SEP:
+		if (c == ',') {
+			top->expect = CYAML_SCAN_EXPECT_ENTRY;
+			scan->pos = pos + 1;
+			return CYAML_SCAN_OK;
+		} else if (c != close) {
+			return CYAML_SCAN_UNSUPPORTED;
+		}
+		*emitted = true;
+		cyaml__scan_flow_end(scan, event, pos);
+		return CYAML_SCAN_OK;
+
+	case CYAML_SCAN_EXPECT_ENTRY:
+		if (c == close) {
+			*emitted = true;
+			cyaml__scan_flow_end(scan, event, pos);
+			return CYAML_SCAN_OK;
+		} else if (map && (c == '[' || c == '{')) {
+			/* Complex keys aren't supported. */
+			return CYAML_SCAN_UNSUPPORTED;
+		}
+		/* Fall through. */
+	case CYAML_SCAN_EXPECT_VALUE:
+		if (c == '[' || c == '{') {
+			top->expect = CYAML_SCAN_EXPECT_SEP;
+			scan->pos = pos + 1;
+			*emitted = true;
+			return cyaml__scan_push(scan, event, (c == '[') ?
+					CYAML_SCAN_FLOW_SEQ :
+					CYAML_SCAN_FLOW_MAP, pos);
+		}
+		break;
+	}
+
+	if (c == '\'' || c == '"') {
+		if (!cyaml__scan_quoted(scan, pos, &tok)) {
+			return CYAML_SCAN_UNSUPPORTED;
+		}
+	} else if (!cyaml__scan_flow_plain(scan, pos, &tok)) {
+		return CYAML_SCAN_UNSUPPORTED;
+	}
+
+	if (map && top->expect == CYAML_SCAN_EXPECT_ENTRY) {
+		top->expect = CYAML_SCAN_EXPECT_COLON;
+	} else {
+		/* Single pair mappings in flow sequences aren't supported. */
+		if (!map) {
+			pos = tok.next;
+			while (cyaml__scan_at(scan, pos) == ' ') {
+				pos++;
+			}
+			if (cyaml__scan_at(scan, pos) == ':') {
+				return CYAML_SCAN_UNSUPPORTED;
+			}
+		}
+		top->expect = CYAML_SCAN_EXPECT_SEP;
+	}
+
+	scan->pos = tok.next;
+	*emitted = true;
+	return cyaml__scan_scalar(scan, event, &tok);
+}
+
+/* Exported function, documented in scan.h. */
+void cyaml__scan_init(
+		cyaml_scan_t *scan,
+		const cyaml_config_t *config,
+		const uint8_t *input,
+		size_t input_len)
+{
+	static const uint8_t bom[] = { 0xef, 0xbb, 0xbf };
+
+	memset(scan, 0, sizeof(*scan));
+
+	scan->config = config;
+	scan->input = input;
+	scan->input_len = input_len;
+
+	if (input_len >= sizeof(bom) && memcmp(input, bom, sizeof(bom)) == 0) {
+		scan->start = sizeof(bom);
+	}
+
+	scan->pos = scan->start;
+	scan->line_start = scan->start;
+	scan->state = CYAML_SCAN_STREAM_START;
+}
+
+/* Exported function, documented in scan.h. */
+cyaml_scan_result_t cyaml__scan_next(
+		cyaml_scan_t *scan,
+		yaml_event_t *event)
+{
+	cyaml_scan_result_t res = CYAML_SCAN_OK;
+	bool emitted = false;
+
+	while (res == CYAML_SCAN_OK && !emitted) {
+		switch (scan->state) {
+		case CYAML_SCAN_STREAM_START:
+			cyaml__scan_event(scan, event,
+					YAML_STREAM_START_EVENT, scan->pos);
+			event->data.stream_start.encoding = YAML_UTF8_ENCODING;
+			scan->state = CYAML_SCAN_DOC_START;
+			emitted = true;
+			break;
+		case CYAML_SCAN_DOC_START:
+			res = cyaml__scan_doc_start(scan, event);
+			emitted = true;
+			break;
+		case CYAML_SCAN_LINE:
+			res = cyaml__scan_line(scan, event, &emitted);
+			break;
+		case CYAML_SCAN_INLINE:
+			cyaml__scan_inline(scan);
+			break;
+		case CYAML_SCAN_NODE:
+			res = cyaml__scan_node(scan, event);
+			emitted = true;
+			break;
+		case CYAML_SCAN_AFTER_NODE:
+			res = cyaml__scan_after_node(scan);
+			break;
+		case CYAML_SCAN_FLOW:
+			res = cyaml__scan_flow(scan, event, &emitted);
+			break;
+		case CYAML_SCAN_STREAM_END:
+			cyaml__scan_event(scan, event,
+					YAML_STREAM_END_EVENT, scan->pos);
+			scan->state = CYAML_SCAN_DONE;
+			emitted = true;
+			break;
+		case CYAML_SCAN_DONE:
+			res = CYAML_SCAN_UNSUPPORTED;
+			break;
+		}
+	}
+
+	return res;
+}
+
+/* Exported function, documented in scan.h. */
+cyaml_scan_result_t cyaml__scan_check(
+		cyaml_scan_t *scan)
+{
+	cyaml_scan_result_t res = CYAML_SCAN_UNSUPPORTED;
+	yaml_event_t event;
+
+	if (cyaml__scan_input_valid(scan->input + scan->start,
+			scan->input_len - scan->start)) {
+		do {
+			res = cyaml__scan_next(scan, &event);
+		} while (res == CYAML_SCAN_OK &&
+		         event.type != YAML_STREAM_END_EVENT);
+	}
+
+	scan->pos = scan->start;
+	scan->line_start = scan->start;
+	scan->line = 0;
+	scan->state = CYAML_SCAN_STREAM_START;
+	scan->pending = false;
+	scan->depth = 0;
+
+	return res;
+}
+
+/* Exported function, documented in scan.h. */
+void cyaml__scan_fini(
+		cyaml_scan_t *scan)
+{
+	cyaml__free(scan->config, scan->buf);
+	scan->buf = NULL;
+	scan->buf_size = 0;
+}
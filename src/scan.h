@@ -0,0 +1,152 @@
+/*
+ * SPDX-License-Identifier: ISC
+ *
+ * Copyright (C) 2026 Michael Drake <tlsa@netsurf-browser.org>
+ */
+
+/**
+ * \file
+ * \brief CYAML native scanner.
+ *
+ * The native scanner produces `libyaml` style events directly from an
+ * in-memory buffer, for a common subset of YAML.  It is used in place of
+ * the `libyaml` parser when \ref CYAML_CFG_NATIVE_SCANNER is set.
+ */
+
+#ifndef CYAML_SCAN_H
+#define CYAML_SCAN_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <yaml.h>
+
+#include "cyaml/cyaml.h"
+
+/** Maximum collection nesting depth for the native scanner. */
+#define CYAML_SCAN_DEPTH_MAX 64
+
+/** Native scanner result codes. */
+typedef enum cyaml_scan_result {
+	CYAML_SCAN_OK,          /**< Event produced. */
+	CYAML_SCAN_UNSUPPORTED, /**< Input uses YAML the scanner can't handle. */
+	CYAML_SCAN_OOM,         /**< Memory allocation failed. */
+} cyaml_scan_result_t;
+
+/** Native scanner states. */
+typedef enum cyaml_scan_state {
+	CYAML_SCAN_STREAM_START, /**< Before the stream start event. */
+	CYAML_SCAN_DOC_START,    /**< Before the document start event. */
+	CYAML_SCAN_LINE,         /**< At the start of a line's content. */
+	CYAML_SCAN_INLINE,       /**< After a block indicator on a line. */
+	CYAML_SCAN_NODE,         /**< At the start of a block node. */
+	CYAML_SCAN_AFTER_NODE,   /**< After a block scalar or flow node. */
+	CYAML_SCAN_FLOW,         /**< Inside a flow collection. */
+	CYAML_SCAN_STREAM_END,   /**< Before the stream end event. */
+	CYAML_SCAN_DONE,         /**< After the stream end event. */
+} cyaml_scan_state_t;
+
+/** Native scanner collection types. */
+typedef enum cyaml_scan_type {
+	CYAML_SCAN_BLOCK_MAP, /**< Block mapping. */
+	CYAML_SCAN_BLOCK_SEQ, /**< Block sequence. */
+	CYAML_SCAN_FLOW_MAP,  /**< Flow mapping. */
+	CYAML_SCAN_FLOW_SEQ,  /**< Flow sequence. */
+} cyaml_scan_type_t;
+
+/** What a native scanner flow collection expects next. */
+typedef enum cyaml_scan_expect {
+	CYAML_SCAN_EXPECT_ENTRY, /**< An entry, a key, or the end. */
+	CYAML_SCAN_EXPECT_COLON, /**< A mapping value indicator. */
+	CYAML_SCAN_EXPECT_VALUE, /**< A mapping value. */
+	CYAML_SCAN_EXPECT_SEP,   /**< An entry separator, or the end. */
+} cyaml_scan_expect_t;
+
+/** A native scanner collection nesting level. */
+typedef struct cyaml_scan_level {
+	cyaml_scan_type_t type;     /**< Collection type. */
+	cyaml_scan_expect_t expect; /**< Next flow token expected. */
+	int64_t indent;             /**< Block indentation column. */
+} cyaml_scan_level_t;
+
+/** Native scanner context. */
+typedef struct cyaml_scan {
+	const cyaml_config_t *config; /**< Client's CYAML config. */
+	const uint8_t *input;         /**< YAML input buffer. */
+	size_t input_len;             /**< Length of input in bytes. */
+	size_t start;                 /**< Offset of input after any BOM. */
+	size_t pos;                   /**< Current offset into input. */
+	size_t line_start;            /**< Offset of current line's start. */
+	size_t line;                  /**< Current line number. */
+	size_t column_pos;            /**< Offset of last column found. */
+	size_t column;                /**< Column of `column_pos`. */
+	cyaml_scan_state_t state;     /**< Current scanner state. */
+	/** Whether a block node is expected next. */
+	bool pending;
+	/** Whether the expected block node is a mapping value. */
+	bool pending_map;
+	/** Whether the expected block node is on its indicator's line. */
+	bool pending_inline;
+	/** Indentation of the collection the expected node belongs to. */
+	int64_t pending_indent;
+	/** Mark after the expected block node's indicator. */
+	yaml_mark_t pending_mark;
+	uint32_t depth;               /**< Number of open collections. */
+	/** Open collections, outermost first. */
+	cyaml_scan_level_t levels[CYAML_SCAN_DEPTH_MAX];
+	char *buf;                    /**< Scalar value buffer. */
+	size_t buf_size;              /**< Allocated size of `buf`. */
+} cyaml_scan_t;
+
+/**
+ * Initialise a native scanner.
+ *
+ * \param[out] scan       The scanner to initialise.
+ * \param[in]  config     The client's CYAML config.
+ * \param[in]  input      The YAML input buffer.
+ * \param[in]  input_len  Length of input in bytes.
+ */
+void cyaml__scan_init(
+		cyaml_scan_t *scan,
+		const cyaml_config_t *config,
+		const uint8_t *input,
+		size_t input_len);
+
+/**
+ * Check that the native scanner can scan all of its input.
+ *
+ * This scans the whole input, and rewinds the scanner to the start.
+ * If the check succeeds, scanning the input again with \ref
+ * cyaml__scan_next will not give \ref CYAML_SCAN_UNSUPPORTED.
+ *
+ * \param[in]  scan  The scanner to check the input of.
+ * \return \ref CYAML_SCAN_OK if the input can be scanned, or appropriate
+ *         result code otherwise.
+ */
+cyaml_scan_result_t cyaml__scan_check(
+		cyaml_scan_t *scan);
+
+/**
+ * Get the next event from a native scanner.
+ *
+ * Scalar values point into a buffer owned by the scanner, which is reused
+ * by the next call.  Events must not be given to `yaml_event_delete`.
+ *
+ * \param[in]  scan   The scanner to get an event from.
+ * \param[out] event  Returns the event on success.
+ * \return \ref CYAML_SCAN_OK on success, or appropriate result code otherwise.
+ */
+cyaml_scan_result_t cyaml__scan_next(
+		cyaml_scan_t *scan,
+		yaml_event_t *event);
+
+/**
+ * Free a native scanner's allocations.
+ *
+ * \param[in]  scan  The scanner to finalise.
+ */
+void cyaml__scan_fini(
+		cyaml_scan_t *scan);
+
+#endif
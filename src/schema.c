@@ -0,0 +1,1142 @@
+/*
+ * SPDX-License-Identifier: ISC
+ *
+ * Copyright (C) 2026 Michael Drake <tlsa@netsurf-browser.org>
+ */
+
+/**
+ * \file
+ * \brief Compile CYAML schemas into a form that is faster to use.
+ *
+ * A compiled schema holds, for every \ref CYAML_MAPPING schema value reachable
+ * from the top level schema value, the number of fields and an index of the
+ * fields array ordered by key.  This allows the load code to find a mapping
+ * field by key with a binary search, rather than with a linear scan of the
+ * schema's fields array.
+ *
+ * The compiled details are looked up by the address of the mapping schema
+ * value, so any schema values that are not covered by the compiled schema
+ * simply take the normal, uncompiled, code path.
+ *
+ * The index also has each key's length, and for case insensitive mappings,
+ * a lower cased copy of the key.  So a lookup only has to lower case the
+ * input key once, and can then compare keys with `memcmp`.
+ *
+ * The compiled schema also holds, for every \ref CYAML_ENUM, \ref CYAML_FLAGS,
+ * and \ref CYAML_BITFIELD schema value, a hash table of the value's names, so
+ * that loading can find a name without scanning the strings or bitdefs array.
+ * For enums, there is also an index of the strings ordered by value, which
+ * saving uses to find the string for a value with a binary search.
+ */
+
+#include <stdbool.h>
+#include <assert.h>
+#include <string.h>
+
+#include "schema.h"
+#include "strpool.h"
+#include "util.h"
+#include "mem.h"
+
+/**
+ * Compare two keys.
+ *
+ * \param[in]  case_sensitive  Whether to compare with case sensitivity.
+ * \param[in]  str1            First string to be compared.
+ * \param[in]  str2            Second string to be compared.
+ * \return 0 if and only if strings are equal.
+ */
+static inline int cyaml__schema_key_cmp(
+		bool case_sensitive,
+		const char *str1,
+		const char *str2)
+{
+	if (case_sensitive) {
+		return strcmp(str1, str2);
+	}
+
+	return cyaml_utf8_casecmp(str1, str2);
+}
+
+/**
+ * Get the hash table start slot for a mapping schema value.
+ *
+ * \param[in]  schema  The mapping schema value.
+ * \param[in]  size    Number of slots in the hash table.  Power of two.
+ * \return Slot index to start probing from.
+ */
+static inline uint32_t cyaml__schema_slot(
+		const cyaml_schema_value_t *schema,
+		uint32_t size)
+{
+	uint64_t hash = (uint64_t)(uintptr_t)schema;
+
+	hash = (hash >> 4) * 0x9e3779b97f4a7c15u;
+
+	return (uint32_t)(hash >> 32) & (size - 1);
+}
+
+/**
+ * Find the hash table entry for a mapping schema value.
+ *
+ * \param[in]  mappings  The compiled mappings hash table.
+ * \param[in]  size      Number of slots in the hash table.  Power of two.
+ * \param[in]  schema    The mapping schema value to find.
+ * \return the entry for `schema`, or the empty entry where it would go.
+ */
+static cyaml_schema_mapping_t * cyaml__schema_find_slot(
+		cyaml_schema_mapping_t *mappings,
+		uint32_t size,
+		const cyaml_schema_value_t *schema)
+{
+	uint32_t slot = cyaml__schema_slot(schema, size);
+
+	while (mappings[slot].schema != NULL &&
+	       mappings[slot].schema != schema) {
+		slot = (slot + 1) & (size - 1);
+	}
+
+	return mappings + slot;
+}
+
+/* Exported function, documented in schema.h. */
+const cyaml_schema_mapping_t * cyaml__schema_mapping(
+		const cyaml_config_t *config,
+		const cyaml_schema_value_t *schema)
+{
+	const cyaml_schema_compiled_t *compiled = config->compiled_schema;
+	const cyaml_schema_mapping_t *mapping;
+
+	if (compiled == NULL || compiled->mappings_used == 0) {
+		return NULL;
+	}
+
+	mapping = cyaml__schema_find_slot(compiled->mappings,
+			compiled->mappings_size, schema);
+	if (mapping->schema == NULL) {
+		return NULL;
+	}
+
+	if (mapping->case_sensitive != cyaml__is_case_sensitive(
+			config, schema)) {
+		return NULL;
+	}
+
+	return mapping;
+}
+
+/**
+ * Find the hash table entry for an enum, flags, or bitfield schema value.
+ *
+ * \param[in]  names   The compiled names hash table.
+ * \param[in]  size    Number of slots in the hash table.  Power of two.
+ * \param[in]  schema  The schema value to find.
+ * \return the entry for `schema`, or the empty entry where it would go.
+ */
+static cyaml_schema_names_t * cyaml__schema_names_find_slot(
+		cyaml_schema_names_t *names,
+		uint32_t size,
+		const cyaml_schema_value_t *schema)
+{
+	uint32_t slot = cyaml__schema_slot(schema, size);
+
+	while (names[slot].schema != NULL &&
+	       names[slot].schema != schema) {
+		slot = (slot + 1) & (size - 1);
+	}
+
+	return names + slot;
+}
+
+/* Exported function, documented in schema.h. */
+const cyaml_schema_names_t * cyaml__schema_names(
+		const cyaml_config_t *config,
+		const cyaml_schema_value_t *schema)
+{
+	const cyaml_schema_compiled_t *compiled = config->compiled_schema;
+	const cyaml_schema_names_t *names;
+
+	if (compiled == NULL || compiled->names_used == 0) {
+		return NULL;
+	}
+
+	names = cyaml__schema_names_find_slot(compiled->names,
+			compiled->names_size, schema);
+	if (names->schema == NULL) {
+		return NULL;
+	}
+
+	if (names->case_sensitive != cyaml__is_case_sensitive(
+			config, schema)) {
+		return NULL;
+	}
+
+	return names;
+}
+
+/**
+ * Get a name from an enum, flags, or bitfield schema value.
+ *
+ * \param[in]  schema  The schema value.
+ * \param[in]  index   Index in the schema's strings or bitdefs array.
+ * \return the name of the entry at `index`.
+ */
+static inline const char * cyaml__schema_names_str(
+		const cyaml_schema_value_t *schema,
+		uint32_t index)
+{
+	if (schema->type == CYAML_BITFIELD) {
+		return schema->bitfield.bitdefs[index].name;
+	}
+
+	return schema->enumeration.strings[index].str;
+}
+
+/**
+ * Get the index of the first entry with a given name from the names table.
+ *
+ * \param[in]  names  Compiled names, with a table.
+ * \param[in]  str    Name to search for, lower cased if the value is
+ *                    case insensitive.
+ * \param[in]  len    Length of `str` in bytes.
+ * \return index in the schema's strings or bitdefs array for name, or
+ *         \ref CYAML_NAMES_IDX_NONE if name is not present in schema.
+ */
+static uint32_t cyaml__schema_names_table_idx(
+		const cyaml_schema_names_t *names,
+		const char *str,
+		size_t len)
+{
+	uint32_t mask = names->table_size - 1;
+	uint32_t slot = cyaml__strpool_hash(str, len) & mask;
+
+	while (names->table[slot] != 0) {
+		uint32_t index = names->table[slot] - 1;
+		const cyaml_schema_key_t *key = names->keys + index;
+
+		if (key->len == len && memcmp(key->str, str, len) == 0) {
+			return index;
+		}
+		slot = (slot + 1) & mask;
+	}
+
+	return CYAML_NAMES_IDX_NONE;
+}
+
+/* Exported function, documented in schema.h. */
+uint32_t cyaml__schema_names_name_idx(
+		const cyaml_schema_names_t *names,
+		const char *name)
+{
+	char folded[CYAML_SCHEMA_FOLD_MAX];
+	size_t len = strlen(name);
+
+	if (names->table != NULL) {
+		if (names->case_sensitive) {
+			return cyaml__schema_names_table_idx(names, name, len);
+
+		} else if (len <= sizeof(folded)) {
+			/* The compiled names are all ASCII, so a name
+			 * with any other characters can't match. */
+			if (!cyaml_utf8_ascii_fold(name, len, folded)) {
+				return CYAML_NAMES_IDX_NONE;
+			}
+			return cyaml__schema_names_table_idx(
+					names, folded, len);
+		}
+	}
+
+	for (uint32_t i = 0; i < names->count; i++) {
+		if (cyaml__schema_key_cmp(names->case_sensitive,
+				cyaml__schema_names_str(names->schema, i),
+				name) == 0) {
+			return i;
+		}
+	}
+
+	return CYAML_NAMES_IDX_NONE;
+}
+
+/* Exported function, documented in schema.h. */
+uint32_t cyaml__schema_names_value_idx(
+		const cyaml_schema_names_t *names,
+		int64_t value)
+{
+	const cyaml_strval_t *strings = names->schema->enumeration.strings;
+	uint32_t lo = 0;
+	uint32_t hi = names->count;
+
+	assert(names->by_value != NULL || names->count == 0);
+
+	/* Find the first index entry that is not less than value. */
+	while (lo < hi) {
+		uint32_t mid = lo + (hi - lo) / 2;
+
+		if (strings[names->by_value[mid]].val < value) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+
+	if (lo < names->count && strings[names->by_value[lo]].val == value) {
+		return names->by_value[lo];
+	}
+
+	return CYAML_NAMES_IDX_NONE;
+}
+
+/**
+ * Check whether a schema value's data holds any pointers, without using
+ * a compiled schema.
+ *
+ * Recursive schemas can only recurse through pointer values, so this
+ * always terminates.
+ *
+ * \param[in]  schema  The schema value to check.
+ * \return true if the value's data may hold pointers, false otherwise.
+ */
+static bool cyaml__schema_value_has_pointers(
+		const cyaml_schema_value_t *schema)
+{
+	const cyaml_schema_field_t *field;
+	const cyaml_schema_value_t *entry;
+
+	switch (schema->type) {
+	case CYAML_MAPPING:
+		for (field = schema->mapping.fields;
+				field->key != NULL; field++) {
+			if (field->value.flags & CYAML_FLAG_LAZY) {
+				continue;
+			}
+			if ((field->value.flags & CYAML_FLAG_POINTER) ||
+			    cyaml__schema_value_has_pointers(&field->value)) {
+				return true;
+			}
+		}
+		return false;
+	case CYAML_SEQUENCE: /* Fall through. */
+	case CYAML_SEQUENCE_FIXED:
+		entry = schema->sequence.entry;
+		return (entry->flags & CYAML_FLAG_POINTER) ||
+				cyaml__schema_value_has_pointers(entry);
+	default:
+		return false;
+	}
+}
+
+/* Exported function, documented in schema.h. */
+bool cyaml__schema_has_pointers(
+		const cyaml_config_t *config,
+		const cyaml_schema_value_t *schema)
+{
+	if (schema->type == CYAML_MAPPING) {
+		const cyaml_schema_mapping_t *mapping;
+
+		mapping = cyaml__schema_mapping(config, schema);
+		if (mapping != NULL) {
+			return mapping->pointers;
+		}
+	}
+
+	return cyaml__schema_value_has_pointers(schema);
+}
+
+/**
+ * Check whether a schema value has any validation callbacks, without using
+ * a compiled schema.
+ *
+ * Recursive schemas are cut off at \ref CYAML_SCHEMA_VALIDATION_DEPTH,
+ * where callbacks are assumed.
+ *
+ * \param[in]  schema  The schema value to check.
+ * \param[in]  depth   Nesting depth of the schema value.
+ * \return true if the value may have validation callbacks, false otherwise.
+ */
+static bool cyaml__schema_value_has_validation(
+		const cyaml_schema_value_t *schema,
+		unsigned depth)
+{
+	const cyaml_schema_field_t *field;
+
+	if (depth > CYAML_SCHEMA_VALIDATION_DEPTH) {
+		return true;
+	}
+
+	switch (schema->type) {
+	case CYAML_INT:
+		return schema->integer.validation_cb != NULL;
+	case CYAML_UINT:
+		return schema->unsigned_integer.validation_cb != NULL;
+	case CYAML_FLOAT:
+		return schema->floating_point.validation_cb != NULL;
+	case CYAML_STRING:
+		return schema->string.validation_cb != NULL;
+	case CYAML_ENUM: /* Fall through. */
+	case CYAML_FLAGS:
+		return schema->enumeration.validation_cb != NULL;
+	case CYAML_BITFIELD:
+		return schema->bitfield.validation_cb != NULL;
+	case CYAML_MAPPING:
+		if (schema->mapping.validation_cb != NULL) {
+			return true;
+		}
+		for (field = schema->mapping.fields;
+				field->key != NULL; field++) {
+			if (field->value.flags & CYAML_FLAG_LAZY) {
+				continue;
+			}
+			if (cyaml__schema_value_has_validation(
+					&field->value, depth + 1)) {
+				return true;
+			}
+		}
+		return false;
+	case CYAML_SEQUENCE: /* Fall through. */
+	case CYAML_SEQUENCE_FIXED:
+		return schema->sequence.validation_cb != NULL ||
+				cyaml__schema_value_has_validation(
+						schema->sequence.entry,
+						depth + 1);
+	default:
+		return false;
+	}
+}
+
+/* Exported function, documented in schema.h. */
+bool cyaml__schema_has_validation(
+		const cyaml_config_t *config,
+		const cyaml_schema_value_t *schema)
+{
+	if (schema->type == CYAML_MAPPING) {
+		const cyaml_schema_mapping_t *mapping;
+
+		mapping = cyaml__schema_mapping(config, schema);
+		if (mapping != NULL) {
+			return mapping->validation;
+		}
+	}
+
+	return cyaml__schema_value_has_validation(schema, 0);
+}
+
+/**
+ * Compare a compiled key with a key of known length.
+ *
+ * This orders keys in the same way as \ref cyaml__schema_key_cmp does, for
+ * keys that can be compiled.  When one key is a prefix of the other, `strcmp`
+ * orders the shorter key first, and \ref cyaml_utf8_casecmp orders it last.
+ *
+ * \param[in]  case_sensitive  Whether the keys are compared case sensitively.
+ * \param[in]  key             The compiled key.
+ * \param[in]  str             Key to compare with, lower cased if the
+ *                             comparison is case insensitive.
+ * \param[in]  len             Length of `str` in bytes.
+ * \return 0 if and only if keys are equal.
+ */
+static inline int cyaml__schema_key_order(
+		bool case_sensitive,
+		const cyaml_schema_key_t *key,
+		const char *str,
+		size_t len)
+{
+	size_t min = (key->len < len) ? key->len : len;
+	int cmp = memcmp(key->str, str, min);
+
+	if (cmp != 0 || key->len == len) {
+		return cmp;
+	}
+
+	return ((key->len < len) == case_sensitive) ? -1 : 1;
+}
+
+/**
+ * Get a mapping field index by binary search of the compiled keys.
+ *
+ * \param[in]  mapping  Compiled mapping details, with keys.
+ * \param[in]  str      Key to search for, lower cased if the mapping is
+ *                      case insensitive.
+ * \param[in]  len      Length of `str` in bytes.
+ * \return index the mapping schema's mapping fields array for key, or
+ *         \ref CYAML_FIELDS_IDX_NONE if key is not present in schema.
+ */
+static uint16_t cyaml__schema_mapping_key_idx(
+		const cyaml_schema_mapping_t *mapping,
+		const char *str,
+		size_t len)
+{
+	const cyaml_schema_key_t *keys = mapping->keys;
+	uint16_t lo = 0;
+	uint16_t hi = mapping->fields_count;
+
+	/* Find the first index entry that is not less than key. */
+	while (lo < hi) {
+		uint16_t mid = (uint16_t)(lo + (hi - lo) / 2);
+
+		if (cyaml__schema_key_order(mapping->case_sensitive,
+				keys + mid, str, len) < 0) {
+			lo = (uint16_t)(mid + 1);
+		} else {
+			hi = mid;
+		}
+	}
+
+	if (lo < mapping->fields_count && keys[lo].len == len &&
+	    memcmp(keys[lo].str, str, len) == 0) {
+		return mapping->index[lo];
+	}
+
+	return CYAML_FIELDS_IDX_NONE;
+}
+
+/* Exported function, documented in schema.h. */
+uint16_t cyaml__schema_mapping_field_idx(
+		const cyaml_schema_mapping_t *mapping,
+		const char *key)
+{
+	const cyaml_schema_field_t *fields = mapping->schema->mapping.fields;
+	uint16_t lo = 0;
+	uint16_t hi = mapping->fields_count;
+
+	if (mapping->keys != NULL) {
+		char folded[CYAML_SCHEMA_FOLD_MAX];
+		size_t len = strlen(key);
+
+		if (mapping->case_sensitive) {
+			return cyaml__schema_mapping_key_idx(mapping, key, len);
+
+		} else if (len <= sizeof(folded)) {
+			/* The compiled keys are all ASCII, so a key
+			 * with any other characters can't match. */
+			if (!cyaml_utf8_ascii_fold(key, len, folded)) {
+				return CYAML_FIELDS_IDX_NONE;
+			}
+			return cyaml__schema_mapping_key_idx(
+					mapping, folded, len);
+		}
+	}
+
+	/* Find the first index entry that is not less than key. */
+	while (lo < hi) {
+		uint16_t mid = (uint16_t)(lo + (hi - lo) / 2);
+
+		if (cyaml__schema_key_cmp(mapping->case_sensitive,
+				fields[mapping->index[mid]].key, key) < 0) {
+			lo = (uint16_t)(mid + 1);
+		} else {
+			hi = mid;
+		}
+	}
+
+	if (lo < mapping->fields_count &&
+	    cyaml__schema_key_cmp(mapping->case_sensitive,
+			fields[mapping->index[lo]].key, key) == 0) {
+		return mapping->index[lo];
+	}
+
+	return CYAML_FIELDS_IDX_NONE;
+}
+
+/**
+ * Ensure there is space in the compiled schema for another mapping.
+ *
+ * The hash table is kept at most half full.
+ *
+ * \param[in]  config    The client's CYAML library config.
+ * \param[in]  compiled  The compiled schema being built.
+ * \return \ref CYAML_OK on success, or appropriate error code otherwise.
+ */
+static cyaml_err_t cyaml__schema_mappings_ensure(
+		const cyaml_config_t *config,
+		cyaml_schema_compiled_t *compiled)
+{
+	cyaml_schema_mapping_t *mappings;
+	uint32_t size;
+
+	if ((compiled->mappings_used + 1) * 2 <= compiled->mappings_size) {
+		return CYAML_OK;
+	}
+
+	size = (compiled->mappings_size == 0) ? 16 :
+			compiled->mappings_size * 2;
+	mappings = cyaml__alloc(config, sizeof(*mappings) * size, true);
+	if (mappings == NULL) {
+		return CYAML_ERR_OOM;
+	}
+
+	for (uint32_t i = 0; i < compiled->mappings_size; i++) {
+		const cyaml_schema_mapping_t *old = compiled->mappings + i;
+
+		if (old->schema != NULL) {
+			*cyaml__schema_find_slot(mappings, size,
+					old->schema) = *old;
+		}
+	}
+
+	cyaml__free(config, compiled->mappings);
+	compiled->mappings = mappings;
+	compiled->mappings_size = size;
+
+	return CYAML_OK;
+}
+
+/**
+ * Build the key ordered index of a mapping's fields.
+ *
+ * This is an insertion sort, which is stable, so where a schema has
+ * duplicate keys, the first one in the schema is found first, just as
+ * it would be by the linear search.
+ *
+ * \param[in]  mapping  The compiled mapping details to build index for.
+ */
+static void cyaml__schema_mapping_sort(
+		cyaml_schema_mapping_t *mapping)
+{
+	const cyaml_schema_field_t *fields = mapping->schema->mapping.fields;
+
+	for (uint16_t i = 0; i < mapping->fields_count; i++) {
+		uint16_t idx = i;
+		uint16_t pos = i;
+
+		while (pos > 0 && cyaml__schema_key_cmp(mapping->case_sensitive,
+				fields[mapping->index[pos - 1]].key,
+				fields[idx].key) > 0) {
+			mapping->index[pos] = mapping->index[pos - 1];
+			pos--;
+		}
+		mapping->index[pos] = idx;
+	}
+}
+
+/**
+ * Build the compiled keys of a mapping, in index order.
+ *
+ * Case insensitive mappings with any non-ASCII keys are left without
+ * compiled keys.
+ *
+ * \param[in]  config   The client's CYAML library config.
+ * \param[in]  mapping  The compiled mapping details to build keys for.
+ * \return \ref CYAML_OK on success, or appropriate error code otherwise.
+ */
+static cyaml_err_t cyaml__schema_mapping_keys(
+		const cyaml_config_t *config,
+		cyaml_schema_mapping_t *mapping)
+{
+	const cyaml_schema_field_t *fields = mapping->schema->mapping.fields;
+	size_t total = 0;
+
+	if (mapping->fields_count == 0) {
+		return CYAML_OK;
+	}
+
+	mapping->keys = cyaml__alloc(config,
+			sizeof(*mapping->keys) * mapping->fields_count, false);
+	if (mapping->keys == NULL) {
+		return CYAML_ERR_OOM;
+	}
+
+	for (uint16_t i = 0; i < mapping->fields_count; i++) {
+		const char *key = fields[mapping->index[i]].key;
+
+		mapping->keys[i].str = key;
+		mapping->keys[i].len = strlen(key);
+		total += mapping->keys[i].len;
+	}
+
+	if (mapping->case_sensitive) {
+		return CYAML_OK;
+	}
+
+	mapping->folded = cyaml__alloc(config, total + 1, false);
+	if (mapping->folded == NULL) {
+		return CYAML_ERR_OOM;
+	}
+
+	total = 0;
+	for (uint16_t i = 0; i < mapping->fields_count; i++) {
+		cyaml_schema_key_t *key = mapping->keys + i;
+		char *folded = mapping->folded + total;
+
+		if (!cyaml_utf8_ascii_fold(key->str, key->len, folded)) {
+			cyaml__free(config, mapping->keys);
+			cyaml__free(config, mapping->folded);
+			mapping->keys = NULL;
+			mapping->folded = NULL;
+			return CYAML_OK;
+		}
+		key->str = folded;
+		total += key->len;
+	}
+
+	return CYAML_OK;
+}
+
+/**
+ * Compile a schema value.
+ *
+ * \param[in]  config    The client's CYAML library config.
+ * \param[in]  compiled  The compiled schema being built.
+ * \param[in]  schema    The schema value to compile.
+ * \return \ref CYAML_OK on success, or appropriate error code otherwise.
+ */
+static cyaml_err_t cyaml__schema_compile_value(
+		const cyaml_config_t *config,
+		cyaml_schema_compiled_t *compiled,
+		const cyaml_schema_value_t *schema);
+
+/**
+ * Compile a mapping schema value.
+ *
+ * Mappings that have already been compiled are skipped, which also stops
+ * recursive schemas from recursing forever.
+ *
+ * \param[in]  config    The client's CYAML library config.
+ * \param[in]  compiled  The compiled schema being built.
+ * \param[in]  schema    The mapping schema value to compile.
+ * \return \ref CYAML_OK on success, or appropriate error code otherwise.
+ */
+static cyaml_err_t cyaml__schema_compile_mapping(
+		const cyaml_config_t *config,
+		cyaml_schema_compiled_t *compiled,
+		const cyaml_schema_value_t *schema)
+{
+	const cyaml_schema_field_t *field = schema->mapping.fields;
+	cyaml_schema_mapping_t *mapping;
+	cyaml_err_t err;
+	uint16_t count = 0;
+
+	if (compiled->mappings_used != 0) {
+		mapping = cyaml__schema_find_slot(compiled->mappings,
+				compiled->mappings_size, schema);
+		if (mapping->schema != NULL) {
+			return CYAML_OK;
+		}
+	}
+
+	err = cyaml__schema_mappings_ensure(config, compiled);
+	if (err != CYAML_OK) {
+		return err;
+	}
+
+	while (field[count].key != NULL) {
+		count++;
+	}
+
+	mapping = cyaml__schema_find_slot(compiled->mappings,
+			compiled->mappings_size, schema);
+	if (count != 0) {
+		mapping->index = cyaml__alloc(config,
+				sizeof(*mapping->index) * count, false);
+		if (mapping->index == NULL) {
+			return CYAML_ERR_OOM;
+		}
+	}
+	mapping->schema = schema;
+	mapping->fields_count = count;
+	mapping->case_sensitive = cyaml__is_case_sensitive(config, schema);
+	mapping->pointers = cyaml__schema_value_has_pointers(schema);
+	mapping->validation = cyaml__schema_value_has_validation(schema, 0);
+	compiled->mappings_used++;
+
+	cyaml__schema_mapping_sort(mapping);
+
+	err = cyaml__schema_mapping_keys(config, mapping);
+	if (err != CYAML_OK) {
+		return err;
+	}
+
+	cyaml__log(config, CYAML_LOG_DEBUG,
+			"Schema: Compiled mapping with %u fields\n", count);
+
+	/* Note: `mapping` isn't valid after this, since compiling the
+	 *       fields may resize the hash table. */
+	for (; field->key != NULL; field++) {
+		err = cyaml__schema_compile_value(config, compiled,
+				&field->value);
+		if (err != CYAML_OK) {
+			return err;
+		}
+	}
+
+	return CYAML_OK;
+}
+
+/**
+ * Ensure there is space in the compiled schema for another set of names.
+ *
+ * The hash table is kept at most half full.
+ *
+ * \param[in]  config    The client's CYAML library config.
+ * \param[in]  compiled  The compiled schema being built.
+ * \return \ref CYAML_OK on success, or appropriate error code otherwise.
+ */
+static cyaml_err_t cyaml__schema_names_ensure(
+		const cyaml_config_t *config,
+		cyaml_schema_compiled_t *compiled)
+{
+	cyaml_schema_names_t *names;
+	uint32_t size;
+
+	if ((compiled->names_used + 1) * 2 <= compiled->names_size) {
+		return CYAML_OK;
+	}
+
+	size = (compiled->names_size == 0) ? 16 :
+			compiled->names_size * 2;
+	names = cyaml__alloc(config, sizeof(*names) * size, true);
+	if (names == NULL) {
+		return CYAML_ERR_OOM;
+	}
+
+	for (uint32_t i = 0; i < compiled->names_size; i++) {
+		const cyaml_schema_names_t *old = compiled->names + i;
+
+		if (old->schema != NULL) {
+			*cyaml__schema_names_find_slot(names, size,
+					old->schema) = *old;
+		}
+	}
+
+	cyaml__free(config, compiled->names);
+	compiled->names = names;
+	compiled->names_size = size;
+
+	return CYAML_OK;
+}
+
+/**
+ * Build the compiled names of an enum, flags, or bitfield value.
+ *
+ * Names are lower cased for case insensitive values, unless any of them
+ * are non-ASCII, in which case they are all left as they are, and there is
+ * no `folded` storage.
+ *
+ * \param[in]  config  The client's CYAML library config.
+ * \param[in]  names   The compiled names to build keys for.
+ * \return \ref CYAML_OK on success, or appropriate error code otherwise.
+ */
+static cyaml_err_t cyaml__schema_names_keys(
+		const cyaml_config_t *config,
+		cyaml_schema_names_t *names)
+{
+	size_t total = 0;
+
+	names->keys = cyaml__alloc(config,
+			sizeof(*names->keys) * names->count, false);
+	if (names->keys == NULL) {
+		return CYAML_ERR_OOM;
+	}
+
+	for (uint32_t i = 0; i < names->count; i++) {
+		const char *str = cyaml__schema_names_str(names->schema, i);
+
+		names->keys[i].str = str;
+		names->keys[i].len = strlen(str);
+		total += names->keys[i].len;
+	}
+
+	if (names->case_sensitive) {
+		return CYAML_OK;
+	}
+
+	names->folded = cyaml__alloc(config, total + 1, false);
+	if (names->folded == NULL) {
+		return CYAML_ERR_OOM;
+	}
+
+	total = 0;
+	for (uint32_t i = 0; i < names->count; i++) {
+		const cyaml_schema_key_t *key = names->keys + i;
+
+		if (!cyaml_utf8_ascii_fold(key->str, key->len,
+				names->folded + total)) {
+			cyaml__free(config, names->folded);
+			names->folded = NULL;
+			return CYAML_OK;
+		}
+		total += key->len;
+	}
+
+	total = 0;
+	for (uint32_t i = 0; i < names->count; i++) {
+		names->keys[i].str = names->folded + total;
+		total += names->keys[i].len;
+	}
+
+	return CYAML_OK;
+}
+
+/**
+ * Build the hash table of an enum, flags, or bitfield value's names.
+ *
+ * Where a schema has duplicate names, only the first is added, so it is
+ * found just as it would be by the linear search.
+ *
+ * \param[in]  config  The client's CYAML library config.
+ * \param[in]  names   The compiled names to build table for.
+ * \return \ref CYAML_OK on success, or appropriate error code otherwise.
+ */
+static cyaml_err_t cyaml__schema_names_table(
+		const cyaml_config_t *config,
+		cyaml_schema_names_t *names)
+{
+	uint32_t size = 16;
+	uint32_t mask;
+
+	if (!names->case_sensitive && names->folded == NULL) {
+		return CYAML_OK;
+	}
+
+	while (size / 2 < names->count) {
+		if (size > UINT32_MAX / 2 / sizeof(*names->table)) {
+			return CYAML_ERR_OOM;
+		}
+		size *= 2;
+	}
+	mask = size - 1;
+
+	names->table = cyaml__alloc(config,
+			sizeof(*names->table) * size, true);
+	if (names->table == NULL) {
+		return CYAML_ERR_OOM;
+	}
+	names->table_size = size;
+
+	for (uint32_t i = 0; i < names->count; i++) {
+		const cyaml_schema_key_t *key = names->keys + i;
+		uint32_t slot = cyaml__strpool_hash(key->str, key->len) & mask;
+
+		while (names->table[slot] != 0) {
+			const cyaml_schema_key_t *other =
+					names->keys + names->table[slot] - 1;
+
+			if (other->len == key->len &&
+			    memcmp(other->str, key->str, key->len) == 0) {
+				break;
+			}
+			slot = (slot + 1) & mask;
+		}
+
+		if (names->table[slot] == 0) {
+			names->table[slot] = i + 1;
+		}
+	}
+
+	return CYAML_OK;
+}
+
+/**
+ * Build the value ordered index of an enum value's strings.
+ *
+ * This is an insertion sort, which is stable, so where a schema has
+ * duplicate values, the first one in the schema is found first, just as
+ * it would be by the linear search.
+ *
+ * \param[in]  config  The client's CYAML library config.
+ * \param[in]  names   The compiled names to build index for.
+ * \return \ref CYAML_OK on success, or appropriate error code otherwise.
+ */
+static cyaml_err_t cyaml__schema_names_sort(
+		const cyaml_config_t *config,
+		cyaml_schema_names_t *names)
+{
+	const cyaml_strval_t *strings = names->schema->enumeration.strings;
+
+	names->by_value = cyaml__alloc(config,
+			sizeof(*names->by_value) * names->count, false);
+	if (names->by_value == NULL) {
+		return CYAML_ERR_OOM;
+	}
+
+	for (uint32_t i = 0; i < names->count; i++) {
+		uint32_t pos = i;
+
+		while (pos > 0 &&
+		       strings[names->by_value[pos - 1]].val > strings[i].val) {
+			names->by_value[pos] = names->by_value[pos - 1];
+			pos--;
+		}
+		names->by_value[pos] = i;
+	}
+
+	return CYAML_OK;
+}
+
+/**
+ * Compile an enum, flags, or bitfield schema value.
+ *
+ * Values that have already been compiled are skipped.
+ *
+ * \param[in]  config    The client's CYAML library config.
+ * \param[in]  compiled  The compiled schema being built.
+ * \param[in]  schema    The schema value to compile.
+ * \return \ref CYAML_OK on success, or appropriate error code otherwise.
+ */
+static cyaml_err_t cyaml__schema_compile_names(
+		const cyaml_config_t *config,
+		cyaml_schema_compiled_t *compiled,
+		const cyaml_schema_value_t *schema)
+{
+	cyaml_schema_names_t *names;
+	cyaml_err_t err;
+
+	if (compiled->names_used != 0) {
+		names = cyaml__schema_names_find_slot(compiled->names,
+				compiled->names_size, schema);
+		if (names->schema != NULL) {
+			return CYAML_OK;
+		}
+	}
+
+	err = cyaml__schema_names_ensure(config, compiled);
+	if (err != CYAML_OK) {
+		return err;
+	}
+
+	names = cyaml__schema_names_find_slot(compiled->names,
+			compiled->names_size, schema);
+	names->schema = schema;
+	names->count = (schema->type == CYAML_BITFIELD) ?
+			schema->bitfield.count :
+			schema->enumeration.count;
+	names->bad_bitdef = names->count;
+	names->case_sensitive = cyaml__is_case_sensitive(config, schema);
+	compiled->names_used++;
+
+	if (names->count == 0) {
+		return CYAML_OK;
+	}
+
+	err = cyaml__schema_names_keys(config, names);
+	if (err != CYAML_OK) {
+		return err;
+	}
+
+	err = cyaml__schema_names_table(config, names);
+	if (err != CYAML_OK) {
+		return err;
+	}
+
+	if (schema->type == CYAML_ENUM) {
+		err = cyaml__schema_names_sort(config, names);
+		if (err != CYAML_OK) {
+			return err;
+		}
+
+	} else if (schema->type == CYAML_BITFIELD) {
+		const cyaml_bitdef_t *bitdef = schema->bitfield.bitdefs;
+
+		for (uint32_t i = 0; i < names->count; i++) {
+			if (bitdef[i].bits + bitdef[i].offset >
+					schema->data_size * 8) {
+				names->bad_bitdef = i;
+				break;
+			}
+		}
+	}
+
+	cyaml__log(config, CYAML_LOG_DEBUG,
+			"Schema: Compiled %u names\n", names->count);
+
+	return CYAML_OK;
+}
+
+/* This function is documented at the forward declaration above. */
+static cyaml_err_t cyaml__schema_compile_value(
+		const cyaml_config_t *config,
+		cyaml_schema_compiled_t *compiled,
+		const cyaml_schema_value_t *schema)
+{
+	switch (schema->type) {
+	case CYAML_MAPPING:
+		return cyaml__schema_compile_mapping(config, compiled, schema);
+	case CYAML_SEQUENCE: /* Fall through. */
+	case CYAML_SEQUENCE_FIXED:
+		return cyaml__schema_compile_value(config, compiled,
+				schema->sequence.entry);
+	case CYAML_ENUM: /* Fall through. */
+	case CYAML_FLAGS: /* Fall through. */
+	case CYAML_BITFIELD:
+		return cyaml__schema_compile_names(config, compiled, schema);
+	default:
+		break;
+	}
+
+	return CYAML_OK;
+}
+
+/* Exported function, documented in include/cyaml/cyaml.h */
+cyaml_err_t cyaml_schema_compiled_free(
+		const cyaml_config_t *config,
+		cyaml_schema_compiled_t *compiled)
+{
+	if (config == NULL) {
+		return CYAML_ERR_BAD_PARAM_NULL_CONFIG;
+	}
+	if (config->mem_fn == NULL) {
+		return CYAML_ERR_BAD_CONFIG_NULL_MEMFN;
+	}
+	if (compiled == NULL) {
+		return CYAML_OK;
+	}
+
+	for (uint32_t i = 0; i < compiled->mappings_size; i++) {
+		cyaml__free(config, compiled->mappings[i].index);
+		cyaml__free(config, compiled->mappings[i].keys);
+		cyaml__free(config, compiled->mappings[i].folded);
+	}
+	cyaml__free(config, compiled->mappings);
+
+	for (uint32_t i = 0; i < compiled->names_size; i++) {
+		cyaml__free(config, compiled->names[i].keys);
+		cyaml__free(config, compiled->names[i].folded);
+		cyaml__free(config, compiled->names[i].table);
+		cyaml__free(config, compiled->names[i].by_value);
+	}
+	cyaml__free(config, compiled->names);
+	cyaml__free(config, compiled);
+
+	return CYAML_OK;
+}
+
+/* Exported function, documented in include/cyaml/cyaml.h */
+cyaml_err_t cyaml_schema_compile(
+		const cyaml_config_t *config,
+		const cyaml_schema_value_t *schema,
+		cyaml_schema_compiled_t **compiled_out)
+{
+	cyaml_schema_compiled_t *compiled;
+	cyaml_err_t err;
+
+	if (config == NULL) {
+		return CYAML_ERR_BAD_PARAM_NULL_CONFIG;
+	}
+	if (config->mem_fn == NULL) {
+		return CYAML_ERR_BAD_CONFIG_NULL_MEMFN;
+	}
+	if (schema == NULL) {
+		return CYAML_ERR_BAD_PARAM_NULL_SCHEMA;
+	}
+	if (compiled_out == NULL) {
+		return CYAML_ERR_BAD_PARAM_NULL_DATA;
+	}
+
+	compiled = cyaml__alloc(config, sizeof(*compiled), true);
+	if (compiled == NULL) {
+		return CYAML_ERR_OOM;
+	}
+	compiled->schema = schema;
+
+	err = cyaml__schema_compile_value(config, compiled, schema);
+	if (err != CYAML_OK) {
+		cyaml_schema_compiled_free(config, compiled);
+		return err;
+	}
+
+	cyaml__log(config, CYAML_LOG_INFO,
+			"Schema: Compiled %u mappings\n",
+			compiled->mappings_used);
+
+	*compiled_out = compiled;
+	return CYAML_OK;
+}
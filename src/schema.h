@@ -0,0 +1,221 @@
+/*
+ * SPDX-License-Identifier: ISC
+ *
+ * Copyright (C) 2026 Michael Drake <tlsa@netsurf-browser.org>
+ */
+
+/**
+ * \file
+ * \brief CYAML compiled schema internals.
+ */
+
+#ifndef CYAML_SCHEMA_H
+#define CYAML_SCHEMA_H
+
+#include "cyaml/cyaml.h"
+
+/** Identifies that no mapping schema entry was found for key. */
+#define CYAML_FIELDS_IDX_NONE 0xffff
+
+/** Identifies that no enum, flag or bitfield entry was found. */
+#define CYAML_NAMES_IDX_NONE UINT32_MAX
+
+/** Longest input key that is lower cased for compiled key lookup. */
+#define CYAML_SCHEMA_FOLD_MAX 128
+
+/** Deepest schema nesting searched for validation callbacks. */
+#define CYAML_SCHEMA_VALIDATION_DEPTH 16
+
+/**
+ * A compiled mapping key.
+ */
+typedef struct cyaml_schema_key {
+	/** The key.  Lower cased for case insensitive mappings. */
+	const char *str;
+	/** Length of the key in bytes. */
+	size_t len;
+} cyaml_schema_key_t;
+
+/**
+ * Compiled details for a single \ref CYAML_MAPPING schema value.
+ */
+typedef struct cyaml_schema_mapping {
+	/** The mapping schema value these details were compiled for. */
+	const cyaml_schema_value_t *schema;
+	/** Mapping field indices, ordered by key. */
+	uint16_t *index;
+	/**
+	 * Mapping keys, in `index` order, or NULL.
+	 *
+	 * This is NULL for case insensitive mappings with non-ASCII keys,
+	 * which are compared with \ref cyaml_utf8_casecmp instead.
+	 */
+	cyaml_schema_key_t *keys;
+	/** Storage for lower cased keys, or NULL. */
+	char *folded;
+	/** Number of fields in the mapping schema's fields array. */
+	uint16_t fields_count;
+	/** Whether the key index was sorted with case sensitivity. */
+	bool case_sensitive;
+	/** Whether the mapping's fields hold any pointers, at any depth. */
+	bool pointers;
+	/** Whether the mapping has any validation callbacks, at any depth. */
+	bool validation;
+} cyaml_schema_mapping_t;
+
+/**
+ * Compiled details for a single \ref CYAML_ENUM, \ref CYAML_FLAGS, or
+ * \ref CYAML_BITFIELD schema value.
+ */
+typedef struct cyaml_schema_names {
+	/** The schema value these details were compiled for. */
+	const cyaml_schema_value_t *schema;
+	/**
+	 * Names, in schema order.
+	 *
+	 * For case insensitive values, the names are lower cased, unless any
+	 * of them are non-ASCII.
+	 */
+	cyaml_schema_key_t *keys;
+	/** Storage for lower cased names, or NULL. */
+	char *folded;
+	/**
+	 * Hash table of name indices plus one, with zero for unused slots.
+	 *
+	 * This is NULL for case insensitive values with non-ASCII names,
+	 * which are compared with \ref cyaml_utf8_casecmp instead.
+	 */
+	uint32_t *table;
+	/** For \ref CYAML_ENUM, name indices ordered by value, or NULL. */
+	uint32_t *by_value;
+	/** Number of slots in `table`.  Always a power of two. */
+	uint32_t table_size;
+	/** Number of entries in the schema's strings or bitdefs array. */
+	uint32_t count;
+	/**
+	 * For \ref CYAML_BITFIELD, the index of the first bitdef that doesn't
+	 * fit in the value's data size, or `count` if they all fit.
+	 */
+	uint32_t bad_bitdef;
+	/** Whether the names were compiled with case sensitivity. */
+	bool case_sensitive;
+} cyaml_schema_names_t;
+
+/**
+ * A compiled CYAML schema.
+ *
+ * The mapping details, and the enum, flags, and bitfield names, are kept in
+ * open addressed hash tables, keyed on the address of the schema value.
+ */
+struct cyaml_schema_compiled {
+	/** The top level schema value that was compiled. */
+	const cyaml_schema_value_t *schema;
+	/** Hash table of compiled mapping details. */
+	cyaml_schema_mapping_t *mappings;
+	/** Number of slots in the `mappings` table.  Always a power of two. */
+	uint32_t mappings_size;
+	/** Number of used slots in the `mappings` table. */
+	uint32_t mappings_used;
+	/** Hash table of compiled enum, flags, and bitfield names. */
+	cyaml_schema_names_t *names;
+	/** Number of slots in the `names` table.  Always a power of two. */
+	uint32_t names_size;
+	/** Number of used slots in the `names` table. */
+	uint32_t names_used;
+};
+
+/**
+ * Get the compiled details for a mapping schema value.
+ *
+ * \param[in]  config  The client's CYAML library config.
+ * \param[in]  schema  CYAML schema for a mapping value.
+ * \return the compiled mapping details, or NULL if there is no compiled
+ *         schema, the schema value isn't covered by it, or it was compiled
+ *         for a different case sensitivity.
+ */
+const cyaml_schema_mapping_t * cyaml__schema_mapping(
+		const cyaml_config_t *config,
+		const cyaml_schema_value_t *schema);
+
+/**
+ * Check whether a schema value's data holds any pointers.
+ *
+ * This doesn't count the value's own \ref CYAML_FLAG_POINTER, so it tells
+ * whether the value's data has to be walked to find allocations.  For
+ * mappings covered by the compiled schema, the answer is precomputed.
+ *
+ * \param[in]  config  The client's CYAML library config.
+ * \param[in]  schema  The schema value to check.
+ * \return true if the value's data may hold pointers, false otherwise.
+ */
+bool cyaml__schema_has_pointers(
+		const cyaml_config_t *config,
+		const cyaml_schema_value_t *schema);
+
+/**
+ * Check whether a schema value has any validation callbacks.
+ *
+ * This includes callbacks for the value itself and for any values nested
+ * inside it, other than \ref CYAML_FLAG_LAZY fields.  Schemas nested deeper
+ * than \ref CYAML_SCHEMA_VALIDATION_DEPTH are assumed to have callbacks.
+ * For mappings covered by the compiled schema, the answer is precomputed.
+ *
+ * \param[in]  config  The client's CYAML library config.
+ * \param[in]  schema  The schema value to check.
+ * \return true if the value may have validation callbacks, false otherwise.
+ */
+bool cyaml__schema_has_validation(
+		const cyaml_config_t *config,
+		const cyaml_schema_value_t *schema);
+
+/**
+ * Get a mapping field index from compiled mapping details.
+ *
+ * \param[in]  mapping  Compiled mapping details.
+ * \param[in]  key      Key to search for in mapping.
+ * \return index the mapping schema's mapping fields array for key, or
+ *         \ref CYAML_FIELDS_IDX_NONE if key is not present in schema.
+ */
+uint16_t cyaml__schema_mapping_field_idx(
+		const cyaml_schema_mapping_t *mapping,
+		const char *key);
+
+/**
+ * Get the compiled names for an enum, flags, or bitfield schema value.
+ *
+ * \param[in]  config  The client's CYAML library config.
+ * \param[in]  schema  CYAML schema for an enum, flags, or bitfield value.
+ * \return the compiled names, or NULL if there is no compiled schema, the
+ *         schema value isn't covered by it, or it was compiled for a
+ *         different case sensitivity.
+ */
+const cyaml_schema_names_t * cyaml__schema_names(
+		const cyaml_config_t *config,
+		const cyaml_schema_value_t *schema);
+
+/**
+ * Get the index of the first entry with a given name from compiled names.
+ *
+ * \param[in]  names  Compiled names.
+ * \param[in]  name   Name to search for.
+ * \return index in the schema's strings or bitdefs array for name, or
+ *         \ref CYAML_NAMES_IDX_NONE if name is not present in schema.
+ */
+uint32_t cyaml__schema_names_name_idx(
+		const cyaml_schema_names_t *names,
+		const char *name);
+
+/**
+ * Get the index of the first entry with a given value from compiled enum
+ * names.
+ *
+ * \param[in]  names  Compiled names for a \ref CYAML_ENUM value.
+ * \param[in]  value  Value to search for.
+ * \return index in the schema's strings array for value, or
+ *         \ref CYAML_NAMES_IDX_NONE if value is not present in schema.
+ */
+uint32_t cyaml__schema_names_value_idx(
+		const cyaml_schema_names_t *names,
+		int64_t value);
+
+#endif
@@ -0,0 +1,131 @@
+/*
+ * SPDX-License-Identifier: ISC
+ *
+ * Copyright (C) 2026 Michael Drake <tlsa@netsurf-browser.org>
+ */
+
+/**
+ * \file
+ * \brief CYAML statistics collection.
+ */
+
+#ifndef CYAML_STATS_H
+#define CYAML_STATS_H
+
+#include <time.h>
+
+#include "cyaml/cyaml.h"
+
+#ifndef CYAML_STATS
+/**
+ * Whether statistics collection is built into the library.
+ *
+ * If this is zero, the client's \ref cyaml_config_t `stats` member is
+ * ignored, and the statistics code compiles away.
+ */
+#define CYAML_STATS 1
+#endif
+
+/**
+ * Get the client's statistics structure.
+ *
+ * \param[in]  config  The CYAML client config.
+ * \return the client's statistics structure, or NULL if statistics are not
+ *         being collected.
+ */
+static inline cyaml_stats_t * cyaml__stats(
+		const cyaml_config_t *config)
+{
+#if CYAML_STATS
+	return config->stats;
+#else
+	(void)config;
+	return NULL;
+#endif
+}
+
+/**
+ * Get the current time, for timing statistics.
+ *
+ * \return the current time in nanoseconds.
+ */
+static inline uint64_t cyaml__stats_now(void)
+{
+	struct timespec ts;
+
+	if (timespec_get(&ts, TIME_UTC) == 0) {
+		return 0;
+	}
+
+	return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * Count a call to the client's allocator.
+ *
+ * \param[in]  config  The CYAML client config.
+ * \param[in]  ptr     The existing allocation or NULL.
+ * \param[in]  size    The size requested, or zero to free.
+ */
+static inline void cyaml__stats_mem(
+		const cyaml_config_t *config,
+		const void *ptr,
+		size_t size)
+{
+	cyaml_stats_t *stats = cyaml__stats(config);
+
+	if (stats != NULL) {
+		if (size != 0) {
+			stats->allocs++;
+			stats->alloc_bytes += size;
+		} else if (ptr != NULL) {
+			stats->frees++;
+		}
+	}
+}
+
+/**
+ * Record the depth of a state stack.
+ *
+ * \param[in]  config  The CYAML client config.
+ * \param[in]  depth   The number of entries on the stack.
+ */
+static inline void cyaml__stats_stack(
+		const cyaml_config_t *config,
+		uint32_t depth)
+{
+	cyaml_stats_t *stats = cyaml__stats(config);
+
+	if (stats != NULL && depth > stats->stack_max) {
+		stats->stack_max = depth;
+	}
+}
+
+/**
+ * Add one set of statistics to another.
+ *
+ * \param[in]  stats  The statistics to add to.
+ * \param[in]  add    The statistics to add.
+ */
+static inline void cyaml__stats_add(
+		cyaml_stats_t *stats,
+		const cyaml_stats_t *add)
+{
+	for (unsigned i = 0; i < CYAML_EVENT__COUNT; i++) {
+		stats->events[i] += add->events[i];
+	}
+	stats->allocs += add->allocs;
+	stats->alloc_bytes += add->alloc_bytes;
+	stats->frees += add->frees;
+	stats->anchors += add->anchors;
+	stats->aliases += add->aliases;
+	stats->ignored_keys += add->ignored_keys;
+	stats->parallel_chunks += add->parallel_chunks;
+	stats->total_ns += add->total_ns;
+	stats->libyaml_ns += add->libyaml_ns;
+	if (add->stack_max > stats->stack_max) {
+		stats->stack_max = add->stack_max;
+	}
+}
+
+#endif
@@ -0,0 +1,250 @@
+/*
+ * SPDX-License-Identifier: ISC
+ *
+ * Copyright (C) 2026 Michael Drake <tlsa@netsurf-browser.org>
+ */
+
+/**
+ * \file
+ * \brief CYAML interned string pool.
+ *
+ * The hash table slots hold string offsets.  String offsets are always
+ * non-zero, because the length prefix comes first, so zero marks an
+ * unused slot.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "mem.h"
+#include "strpool.h"
+
+/** Size of the length prefix before each pooled string. */
+#define CYAML_STRPOOL_PREFIX (sizeof(uint32_t))
+
+/** Initial size of a string pool's data buffer. */
+#define CYAML_STRPOOL_DATA_MIN 256
+
+/** Initial number of slots in a string pool's hash table. */
+#define CYAML_STRPOOL_TABLE_MIN 64
+
+/**
+ * Get the length of a pooled string.
+ *
+ * \param[in]  pool    The string pool.
+ * \param[in]  offset  The string's offset in the pool.
+ * \return the string's length in bytes.
+ */
+static inline uint32_t cyaml__strpool_len(
+		const cyaml_strpool_t *pool,
+		uint32_t offset)
+{
+	uint32_t len;
+
+	memcpy(&len, pool->data + offset - CYAML_STRPOOL_PREFIX, sizeof(len));
+
+	return len;
+}
+
+/**
+ * Find the hash table slot for a string.
+ *
+ * \param[in]  pool  The string pool.
+ * \param[in]  str   The string to find.
+ * \param[in]  len   Length of `str` in bytes.
+ * \param[in]  hash  Hash of the string.
+ * \return the slot holding the string, or the empty slot where it belongs.
+ */
+static uint32_t * cyaml__strpool_slot(
+		const cyaml_strpool_t *pool,
+		const char *str,
+		size_t len,
+		uint32_t hash)
+{
+	uint32_t mask = pool->table_size - 1;
+	uint32_t i = hash & mask;
+
+	while (pool->table[i] != 0) {
+		uint32_t offset = pool->table[i];
+
+		if (cyaml__strpool_len(pool, offset) == len &&
+		    memcmp(pool->data + offset, str, len) == 0) {
+			break;
+		}
+		i = (i + 1) & mask;
+	}
+
+	return pool->table + i;
+}
+
+/**
+ * Ensure a string pool's hash table has space for another string.
+ *
+ * The hash table is kept at most half full.
+ *
+ * \param[in]      config  The CYAML client config.
+ * \param[in,out]  pool    The string pool.
+ * \return \ref CYAML_OK on success, or appropriate error code otherwise.
+ */
+static cyaml_err_t cyaml__strpool_table_ensure(
+		const cyaml_config_t *config,
+		cyaml_strpool_t *pool)
+{
+	cyaml_strpool_t temp = *pool;
+
+	if ((pool->count + 1) * 2 <= pool->table_size) {
+		return CYAML_OK;
+	}
+
+	if (pool->table_size == 0) {
+		temp.table_size = CYAML_STRPOOL_TABLE_MIN;
+	} else if (pool->table_size > UINT32_MAX / 2 / sizeof(*temp.table)) {
+		return CYAML_ERR_OOM;
+	} else {
+		temp.table_size = pool->table_size * 2;
+	}
+
+	temp.table = cyaml__alloc(config,
+			temp.table_size * sizeof(*temp.table), true);
+	if (temp.table == NULL) {
+		return CYAML_ERR_OOM;
+	}
+
+	for (uint32_t i = 0; i < pool->table_size; i++) {
+		uint32_t offset = pool->table[i];
+
+		if (offset != 0) {
+			const char *str = pool->data + offset;
+			uint32_t len = cyaml__strpool_len(pool, offset);
+
+			*cyaml__strpool_slot(&temp, str, len,
+					cyaml__strpool_hash(str, len)) = offset;
+		}
+	}
+
+	cyaml__free(config, pool->table);
+	pool->table = temp.table;
+	pool->table_size = temp.table_size;
+
+	return CYAML_OK;
+}
+
+/**
+ * Ensure a string pool's data buffer has space for another string.
+ *
+ * \param[in]      config  The CYAML client config.
+ * \param[in,out]  pool    The string pool.
+ * \param[in]      size    Bytes needed for the string's pool entry.
+ * \return \ref CYAML_OK on success, or appropriate error code otherwise.
+ */
+static cyaml_err_t cyaml__strpool_data_ensure(
+		const cyaml_config_t *config,
+		cyaml_strpool_t *pool,
+		size_t size)
+{
+	size_t max = pool->data_max;
+	char *data;
+
+	if (size <= pool->data_max - pool->data_len) {
+		return CYAML_OK;
+	}
+
+	if (size > UINT32_MAX - pool->data_len) {
+		return CYAML_ERR_OOM;
+	}
+
+	if (max == 0) {
+		max = CYAML_STRPOOL_DATA_MIN;
+	}
+	while (max - pool->data_len < size) {
+		if (max > UINT32_MAX / 2) {
+			max = UINT32_MAX;
+			break;
+		}
+		max *= 2;
+	}
+
+	data = cyaml__realloc(config, pool->data,
+			pool->data_len, max, false);
+	if (data == NULL) {
+		return CYAML_ERR_OOM;
+	}
+
+	pool->data = data;
+	pool->data_max = (uint32_t)max;
+
+	return CYAML_OK;
+}
+
+/* Exported function, documented in strpool.h. */
+cyaml_err_t cyaml__strpool_intern(
+		const cyaml_config_t *config,
+		cyaml_strpool_t *pool,
+		const char *str,
+		size_t len,
+		uint32_t *offset_out)
+{
+	uint32_t hash = cyaml__strpool_hash(str, len);
+	uint32_t len32 = (uint32_t)len;
+	uint32_t offset;
+	uint32_t *slot;
+	cyaml_err_t err;
+
+	if (len > UINT32_MAX - CYAML_STRPOOL_PREFIX - 1) {
+		return CYAML_ERR_OOM;
+	}
+
+	if (pool->table_size != 0) {
+		slot = cyaml__strpool_slot(pool, str, len, hash);
+		if (*slot != 0) {
+			*offset_out = *slot;
+			return CYAML_OK;
+		}
+	}
+
+	err = cyaml__strpool_table_ensure(config, pool);
+	if (err != CYAML_OK) {
+		return err;
+	}
+
+	err = cyaml__strpool_data_ensure(config, pool,
+			CYAML_STRPOOL_PREFIX + len + 1);
+	if (err != CYAML_OK) {
+		return err;
+	}
+
+	offset = pool->data_len + (uint32_t)CYAML_STRPOOL_PREFIX;
+	memcpy(pool->data + pool->data_len, &len32, sizeof(len32));
+	memcpy(pool->data + offset, str, len);
+	pool->data[offset + len] = '\0';
+	pool->data_len = offset + len32 + 1;
+
+	*cyaml__strpool_slot(pool, str, len, hash) = offset;
+	pool->count++;
+
+	*offset_out = offset;
+	return CYAML_OK;
+}
+
+/* Exported function, documented in strpool.h. */
+void cyaml__strpool_reset(
+		cyaml_strpool_t *pool)
+{
+	if (pool->table != NULL) {
+		memset(pool->table, 0, pool->table_size * sizeof(*pool->table));
+	}
+	pool->data_len = 0;
+	pool->count = 0;
+}
+
+/* Exported function, documented in strpool.h. */
+void cyaml__strpool_free(
+		const cyaml_config_t *config,
+		cyaml_strpool_t *pool)
+{
+	cyaml__free(config, pool->data);
+	cyaml__free(config, pool->table);
+
+	*pool = (cyaml_strpool_t) { 0 };
+}
@@ -0,0 +1,109 @@
+/*
+ * SPDX-License-Identifier: ISC
+ *
+ * Copyright (C) 2026 Michael Drake <tlsa@netsurf-browser.org>
+ */
+
+/**
+ * \file
+ * \brief CYAML interned string pool.
+ */
+
+#ifndef CYAML_STRPOOL_H
+#define CYAML_STRPOOL_H
+
+#include "cyaml/cyaml.h"
+
+/**
+ * A CYAML interned string pool.
+ *
+ * Strings are stored one after another in a single buffer, and identified
+ * by their offset into the buffer.  Each unique string is only stored once.
+ * Every string is prefixed by its length, and followed by a '\0'
+ * terminator, so strings may contain '\0' bytes.
+ *
+ * \note String offsets are stable, but string pointers are invalidated by
+ *       interning another string.
+ */
+typedef struct cyaml_strpool {
+	char *data;          /**< String data buffer, or NULL. */
+	uint32_t *table;     /**< Hash table of string offsets, or NULL. */
+	uint32_t data_len;   /**< Bytes used in `data`. */
+	uint32_t data_max;   /**< Bytes allocated for `data`. */
+	uint32_t table_size; /**< Number of slots in `table`.  Power of two. */
+	uint32_t count;      /**< Number of strings in the pool. */
+} cyaml_strpool_t;
+
+/**
+ * Get the hash of a string.
+ *
+ * This is the 32-bit FNV-1a hash.
+ *
+ * \param[in]  str  The string to hash.
+ * \param[in]  len  Length of `str` in bytes.
+ * \return the string's hash.
+ */
+static inline uint32_t cyaml__strpool_hash(
+		const char *str,
+		size_t len)
+{
+	uint32_t hash = 0x811c9dc5u;
+
+	for (size_t i = 0; i < len; i++) {
+		hash ^= (uint8_t)str[i];
+		hash *= 0x01000193u;
+	}
+
+	return hash;
+}
+
+/**
+ * Add a string to a string pool, if it isn't in the pool already.
+ *
+ * \param[in]      config      The CYAML client config.
+ * \param[in,out]  pool        The string pool to add the string to.
+ * \param[in]      str         The string to intern.
+ * \param[in]      len         Length of `str` in bytes.
+ * \param[out]     offset_out  Returns the string's offset in the pool.
+ * \return \ref CYAML_OK on success, or appropriate error code otherwise.
+ */
+cyaml_err_t cyaml__strpool_intern(
+		const cyaml_config_t *config,
+		cyaml_strpool_t *pool,
+		const char *str,
+		size_t len,
+		uint32_t *offset_out);
+
+/**
+ * Get an interned string from a string pool.
+ *
+ * \param[in]  pool    The string pool to get the string from.
+ * \param[in]  offset  The string's offset, from \ref cyaml__strpool_intern.
+ * \return the '\0' terminated string.
+ */
+static inline const char * cyaml__strpool_get(
+		const cyaml_strpool_t *pool,
+		uint32_t offset)
+{
+	return pool->data + offset;
+}
+
+/**
+ * Remove all the strings from a string pool, keeping its allocations.
+ *
+ * \param[in,out]  pool  The string pool to empty.
+ */
+void cyaml__strpool_reset(
+		cyaml_strpool_t *pool);
+
+/**
+ * Free a string pool's allocations.
+ *
+ * \param[in]      config  The CYAML client config.
+ * \param[in,out]  pool    The string pool to free.  Left empty.
+ */
+void cyaml__strpool_free(
+		const cyaml_config_t *config,
+		cyaml_strpool_t *pool);
+
+#endif
@@ -12,6 +12,7 @@
 #include <assert.h>
 #include <stdint.h>
 #include <stdbool.h>
+#include <string.h>
 
 #include "utf8.h"
 
@@ -184,6 +185,66 @@ static inline int cyaml_utf8_difference(unsigned a, unsigned b)
 	return (((int)a) - ((int)b));
 }
 
+/**
+ * Convert an ASCII character to lower case.
+ *
+ * \param[in]  c  Character to convert to lower-case, if applicable.
+ * \return the lower-cased character.
+ */
+static inline unsigned cyaml_utf8_ascii_lower(uint8_t c)
+{
+	return ((c >= 'A') && (c <= 'Z')) ? (c + 32u) : c;
+}
+
+/**
+ * Convert the ASCII characters in a word of bytes to lower case.
+ *
+ * Each byte is handled independently, without carries between bytes, so
+ * this works with either byte order.  Bytes with the top bit set are left
+ * alone.
+ *
+ * \param[in]  w  Word of eight bytes to convert.
+ * \return the word with upper case ASCII letters lower-cased.
+ */
+static inline uint64_t cyaml_utf8_ascii_lower_word(uint64_t w)
+{
+	const uint64_t ones = 0x0101010101010101u;
+	uint64_t low = w & (ones * 0x7f);
+	uint64_t ge_a = low + ones * (0x80 - 'A');
+	uint64_t gt_z = low + ones * (0x7f - 'Z');
+	uint64_t upper = ge_a & ~gt_z & ~w & (ones * 0x80);
+
+	return w | (upper >> 2);
+}
+
+/* Exported function, documented in utf8.h. */
+bool cyaml_utf8_ascii_fold(
+		const void *str,
+		size_t len,
+		void *out)
+{
+	const uint8_t *s = str;
+	uint8_t *o = out;
+	uint64_t high = 0;
+	size_t i = 0;
+
+	for (; len - i >= sizeof(uint64_t); i += sizeof(uint64_t)) {
+		uint64_t w;
+
+		memcpy(&w, s + i, sizeof(w));
+		high |= w;
+		w = cyaml_utf8_ascii_lower_word(w);
+		memcpy(o + i, &w, sizeof(w));
+	}
+
+	for (; i < len; i++) {
+		high |= s[i];
+		o[i] = (uint8_t)cyaml_utf8_ascii_lower(s[i]);
+	}
+
+	return (high & 0x8080808080808080u) == 0;
+}
+
 /* Exported function, documented in utf8.h. */
 int cyaml_utf8_casecmp(
 		const void * const str1,
@@ -192,6 +253,28 @@ int cyaml_utf8_casecmp(
 	const uint8_t *s1 = str1;
 	const uint8_t *s2 = str2;
 
+	/* Common case: Both strings have ASCII values.  This avoids the
+	 * per-character length handling until a multi-byte character. */
+	while (((*s1 | *s2) & 0x80) == 0) {
+		unsigned cmp1 = cyaml_utf8_ascii_lower(*s1);
+		unsigned cmp2 = cyaml_utf8_ascii_lower(*s2);
+
+		if (cmp1 != cmp2) {
+			if (*s1 == 0) {
+				return 1; /* String 1 has ended. */
+			} else if (*s2 == 0) {
+				return -1;/* String 2 has ended. */
+			}
+			return cyaml_utf8_difference(cmp1, cmp2);
+
+		} else if (cmp1 == 0) {
+			return 0; /* Both strings ended; match. */
+		}
+
+		s1++;
+		s2++;
+	}
+
 	while (true) {
 		unsigned len1;
 		unsigned len2;
@@ -215,13 +298,11 @@ int cyaml_utf8_casecmp(
 
 		/* Compare values. */
 		if ((len1 == 1) && (len2 == 1)) {
-			/* Common case: Both strings have ASCII values. */
+			/* Both strings have ASCII values. */
 			if (*s1 != *s2) {
 				/* They're different; need to lower case. */
-				cmp1 = ((*s1 >= 'A') && (*s1 <= 'Z')) ?
-						(*s1 + 32u) : *s1;
-				cmp2 = ((*s2 >= 'A') && (*s2 <= 'Z')) ?
-						(*s2 + 32u) : *s2;
+				cmp1 = cyaml_utf8_ascii_lower(*s1);
+				cmp2 = cyaml_utf8_ascii_lower(*s2);
 				if (cmp1 != cmp2) {
 					return cyaml_utf8_difference(
 							cmp1, cmp2);
@@ -12,6 +12,10 @@
 #ifndef CYAML_UTF8_H
 #define CYAML_UTF8_H
 
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
 /**
  * Get a codepoint from the input string.
  *
@@ -43,4 +47,21 @@ int cyaml_utf8_casecmp(
 		const void * const str1,
 		const void * const str2);
 
+/**
+ * Lower case an ASCII string.
+ *
+ * Strings that are lower cased with this can be compared with `memcmp`
+ * to give the same equality result as \ref cyaml_utf8_casecmp.
+ *
+ * \param[in]  str  String to lower case.
+ * \param[in]  len  Length of `str` in bytes.
+ * \param[out] out  Buffer of at least `len` bytes to write to.
+ * \return true if `str` is entirely ASCII, false otherwise.  If false is
+ *         returned, `out` should not be used.
+ */
+bool cyaml_utf8_ascii_fold(
+		const void *str,
+		size_t len,
+		void *out);
+
 #endif
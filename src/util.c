@@ -114,6 +114,20 @@ const char * cyaml_strerror(
 		[CYAML_ERR_LIBYAML_EVENT_INIT]    = "libyaml event init failed",
 		[CYAML_ERR_LIBYAML_EMITTER]       = "libyaml emitter error",
 		[CYAML_ERR_LIBYAML_PARSER]        = "libyaml parser error",
+		[CYAML_ERR_BAD_PARAM_NULL_LOADER] = "Bad parameter: NULL loader",
+		[CYAML_ERR_BAD_PARAM_NULL_SAVER]  = "Bad parameter: NULL saver",
+		[CYAML_ERR_BAD_PARAM_NULL_CALLBACK] = "Bad parameter: NULL callback",
+		[CYAML_ERR_BAD_LOADER_STATE]      = "Loader in wrong state for call",
+		[CYAML_NEED_MORE]                 = "More input needed",
+		[CYAML_ERR_LAZY_NO_INPUT]         = "Lazy value needs data input",
+		[CYAML_ERR_BINARY_INVALID]        = "Invalid binary image",
+		[CYAML_ERR_BINARY_SCHEMA]         = "Binary image schema mismatch",
+		[CYAML_ERR_LIMIT_ALIAS_EVENTS]    = "Alias event limit exceeded",
+		[CYAML_ERR_LIMIT_MEMORY]          = "Memory limit exceeded",
+		[CYAML_ERR_LIMIT_DEPTH]           = "Nesting depth limit exceeded",
+		[CYAML_ERR_LIMIT_INPUT_SIZE]      = "Input size limit exceeded",
+		[CYAML_ERR_PATCH_UNSUPPORTED]     = "Changes can't be patched",
+		[CYAML_ERR_FILE_WRITE]            = "Failed to write file",
 	};
 	if ((unsigned)err >= CYAML_ERR__COUNT) {
 		return "Invalid error code";
@@ -118,27 +118,61 @@ static inline const char * cyaml__type_to_str(cyaml_type_e type)
 	return strings[type];
 }
 
+#ifndef CYAML_LOG_MIN_LEVEL
 /**
- * Log to client's logging function, if provided.
+ * Minimum log level built into the library.
+ *
+ * Messages with a lower level are compiled out entirely, whatever the
+ * client's \ref cyaml_config_t.log_level.  Release builds set this to
+ * \ref CYAML_LOG_NOTICE, so debug and info logging costs nothing there.
+ */
+#define CYAML_LOG_MIN_LEVEL CYAML_LOG_DEBUG
+#endif
+
+/**
+ * Log to client's logging function.
+ *
+ * Use \ref cyaml__log rather than calling this directly.
  *
  * \param[in] cfg    CYAML client config structure.
  * \param[in] level  Log level of message to log.
  * \param[in] fmt    Format string for message to log.
  * \param[in] ...    Additional arguments used by fmt.
  */
-static inline void cyaml__log(
+static inline void cyaml__log_emit(
 		const cyaml_config_t *cfg,
 		cyaml_log_t level,
 		const char *fmt, ...)
 {
-	if (level >= cfg->log_level && cfg->log_fn != NULL) {
-		va_list args;
-		va_start(args, fmt);
-		cfg->log_fn(level, cfg->log_ctx, fmt, args);
-		va_end(args);
-	}
+	va_list args;
+	va_start(args, fmt);
+	cfg->log_fn(level, cfg->log_ctx, fmt, args);
+	va_end(args);
 }
 
+/**
+ * Log to client's logging function, if provided.
+ *
+ * The level is checked before the message arguments are evaluated, and
+ * messages below \ref CYAML_LOG_MIN_LEVEL are removed at compile time.
+ *
+ * \param[in] _cfg    CYAML client config structure.
+ * \param[in] _level  Log level of message to log.
+ * \param[in] ...     Format string for message to log, and any additional
+ *                    arguments used by it.
+ */
+#define cyaml__log(_cfg, _level, ...) \
+	do { \
+		const cyaml_config_t *cyaml__log_cfg = (_cfg); \
+		cyaml_log_t cyaml__log_level = (_level); \
+		if (cyaml__log_level >= CYAML_LOG_MIN_LEVEL && \
+		    cyaml__log_level >= cyaml__log_cfg->log_level && \
+		    cyaml__log_cfg->log_fn != NULL) { \
+			cyaml__log_emit(cyaml__log_cfg, cyaml__log_level, \
+					__VA_ARGS__); \
+		} \
+	} while (0)
+
 /**
  * Check if comparason should be case sensitive.
  *
@@ -0,0 +1,905 @@
+/*
+ * SPDX-License-Identifier: ISC
+ *
+ * Copyright (C) 2026 Michael Drake <tlsa@netsurf-browser.org>
+ */
+
+/**
+ * \file
+ * \brief CYAML benchmarks.
+ *
+ * Generates representative documents, and measures loading, with libyaml
+ * and with the native scanner, saving, with libyaml and with the native
+ * emitter, copying and freeing them.  Results are written to stdout as CSV.
+ *
+ * Usage: cyaml-bench [-t SECONDS] [DOCUMENT...]
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <stdio.h>
+#include <time.h>
+
+#include <yaml.h>
+
+#include <cyaml/cyaml.h>
+
+/** Default minimum time to spend measuring each operation, in seconds. */
+#define BENCH_TIME_DEFAULT 0.25
+
+/** Minimum number of iterations of each operation. */
+#define BENCH_ITERATIONS_MIN 3
+
+/**
+ * Maximum wall clock time for an operation's loop, as a multiple of the
+ * measuring time.
+ *
+ * This bounds operations that need untimed setup for every iteration,
+ * such as free, which is very fast for pointer-free data.
+ */
+#define BENCH_WALL_FACTOR 20
+
+/** Depth of each tree in the deep document. */
+#define BENCH_DEEP_DEPTH 32
+
+/** Number of trees in the deep document. */
+#define BENCH_DEEP_COUNT 500
+
+/** Number of keys in each mapping of the wide document. */
+#define BENCH_WIDE_KEYS 64
+
+/** Number of mappings in the wide document. */
+#define BENCH_WIDE_COUNT 2000
+
+/** Number of values in the numeric document. */
+#define BENCH_NUMERIC_COUNT 250000
+
+/** Number of entries in the strings document. */
+#define BENCH_STRINGS_COUNT 20000
+
+/** Number of entries in the anchors document. */
+#define BENCH_ANCHORS_COUNT 40000
+
+/** Number of distinct anchors in the anchors document. */
+#define BENCH_ANCHORS_DISTINCT 256
+
+/** Growable output buffer for generated documents. */
+typedef struct bench_buf {
+	char *data;  /**< Buffer contents, always NUL terminated. */
+	size_t len;  /**< Length of contents, excluding the terminator. */
+	size_t size; /**< Allocated size of the buffer. */
+} bench_buf_t;
+
+/** Memory allocation counts. */
+typedef struct bench_counts {
+	unsigned long long allocs; /**< Allocation and reallocation calls. */
+	unsigned long long frees;  /**< Calls to free an allocation. */
+} bench_counts_t;
+
+/** Accumulated measurement for one operation. */
+typedef struct bench_result {
+	unsigned long long iterations; /**< Number of times it was run. */
+	double seconds;                /**< Total time taken. */
+	bench_counts_t counts;         /**< Total allocation counts. */
+} bench_result_t;
+
+/** A benchmark document. */
+typedef struct bench_doc {
+	/** Name of the document. */
+	const char *name;
+	/** Schema for the document's top level value. */
+	const cyaml_schema_value_t *schema;
+	/** Function to write the document to a buffer. */
+	bool (*generate)(bench_buf_t *buf);
+} bench_doc_t;
+
+/**
+ * Append formatted text to a buffer.
+ *
+ * \param[in]  buf  The buffer to append to.
+ * \param[in]  fmt  Format string.
+ * \param[in]  ...  Additional arguments used by fmt.
+ * \return true on success, false on allocation failure.
+ */
+static bool bench_printf(
+		bench_buf_t *buf,
+		const char *fmt, ...)
+{
+	va_list args;
+	int len;
+
+	va_start(args, fmt);
+	len = vsnprintf(buf->data + buf->len, buf->size - buf->len, fmt, args);
+	va_end(args);
+
+	if (len < 0) {
+		return false;
+	}
+
+	if ((size_t)len >= buf->size - buf->len) {
+		size_t size = (buf->size + (size_t)len + 1) * 2;
+		char *data = realloc(buf->data, size);
+
+		if (data == NULL) {
+			return false;
+		}
+		buf->data = data;
+		buf->size = size;
+
+		va_start(args, fmt);
+		len = vsnprintf(buf->data + buf->len, buf->size - buf->len,
+				fmt, args);
+		va_end(args);
+
+		if (len < 0) {
+			return false;
+		}
+	}
+
+	buf->len += (size_t)len;
+	return true;
+}
+
+/**
+ * Count the YAML events in a document.
+ *
+ * \param[in]  input  The document.
+ * \param[in]  len    Length of document in bytes.
+ * \return the number of events, or zero on error.
+ */
+static unsigned long long bench_count_events(
+		const char *input,
+		size_t len)
+{
+	unsigned long long count = 0;
+	yaml_parser_t parser;
+	bool done = false;
+
+	if (!yaml_parser_initialize(&parser)) {
+		return 0;
+	}
+	yaml_parser_set_input_string(&parser,
+			(const unsigned char *)input, len);
+
+	while (!done) {
+		yaml_event_t event;
+
+		if (!yaml_parser_parse(&parser, &event)) {
+			count = 0;
+			break;
+		}
+		done = (event.type == YAML_STREAM_END_EVENT);
+		yaml_event_delete(&event);
+		count++;
+	}
+
+	yaml_parser_delete(&parser);
+	return count;
+}
+
+/**
+ * Memory allocation function that counts calls.
+ *
+ * \param[in]  ctx   The \ref bench_counts_t to update.
+ * \param[in]  ptr   Existing allocation, or NULL.
+ * \param[in]  size  New size of allocation, or 0 to free.
+ * \return the new allocation, or NULL.
+ */
+static void * bench_mem(
+		void *ctx,
+		void *ptr,
+		size_t size)
+{
+	bench_counts_t *counts = ctx;
+
+	if (size == 0) {
+		if (ptr != NULL) {
+			counts->frees++;
+		}
+	} else {
+		counts->allocs++;
+	}
+
+	return cyaml_mem(NULL, ptr, size);
+}
+
+/**
+ * Get the current time.
+ *
+ * \return the time in seconds.
+ */
+static double bench_now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+/**
+ * Start timing an operation.
+ *
+ * \param[in]  counts  The allocation counts.
+ * \param[out] start   Returns the allocation counts at the start.
+ * \return the time at the start.
+ */
+static inline double bench_start(
+		const bench_counts_t *counts,
+		bench_counts_t *start)
+{
+	*start = *counts;
+	return bench_now();
+}
+
+/**
+ * Finish timing an operation, and add it to a result.
+ *
+ * \param[in]  result      The result to update.
+ * \param[in]  counts      The allocation counts.
+ * \param[in]  start       The allocation counts at the start.
+ * \param[in]  start_time  The time at the start.
+ */
+static inline void bench_stop(
+		bench_result_t *result,
+		const bench_counts_t *counts,
+		const bench_counts_t *start,
+		double start_time)
+{
+	result->seconds += bench_now() - start_time;
+	result->counts.allocs += counts->allocs - start->allocs;
+	result->counts.frees += counts->frees - start->frees;
+	result->iterations++;
+}
+
+/**
+ * Check whether an operation has been measured for long enough.
+ *
+ * \param[in]  result   The result so far.
+ * \param[in]  seconds  Minimum time to spend measuring.
+ * \return true if measuring should continue.
+ */
+static inline bool bench_more(
+		const bench_result_t *result,
+		double seconds)
+{
+	return result->iterations < BENCH_ITERATIONS_MIN ||
+			result->seconds < seconds;
+}
+
+/**
+ * Write a result as a CSV line.
+ *
+ * \param[in]  doc     The document.
+ * \param[in]  op      Name of the operation.
+ * \param[in]  bytes   Size of the document in bytes.
+ * \param[in]  events  Number of YAML events in the document.
+ * \param[in]  result  The result to write.
+ */
+static void bench_report(
+		const bench_doc_t *doc,
+		const char *op,
+		size_t bytes,
+		unsigned long long events,
+		const bench_result_t *result)
+{
+	double iterations = (double)result->iterations;
+	double seconds = result->seconds / iterations;
+
+	printf("%s,%s,%llu,%zu,%llu,%.0f,%.2f,%.0f,%.2f,%.1f,%.1f\n",
+			doc->name, op, result->iterations, bytes, events,
+			seconds * 1e9,
+			(double)bytes / seconds / 1e6,
+			(double)events / seconds,
+			seconds * 1e9 / (double)events,
+			(double)result->counts.allocs / iterations,
+			(double)result->counts.frees / iterations);
+}
+
+/**
+ * Run the benchmarks for a document.
+ *
+ * \param[in]  doc      The document to benchmark.
+ * \param[in]  seconds  Minimum time to spend measuring each operation.
+ * \return true on success, false otherwise.
+ */
+static bool bench_doc(
+		const bench_doc_t *doc,
+		double seconds)
+{
+	bench_counts_t counts = { 0 };
+	cyaml_config_t config = {
+		.log_fn = cyaml_log,
+		.mem_fn = bench_mem,
+		.mem_ctx = &counts,
+		.log_level = CYAML_LOG_WARNING,
+	};
+	cyaml_config_t native;
+	cyaml_config_t block;
+	cyaml_config_t parallel;
+	bench_result_t load = { 0 };
+	bench_result_t load_native = { 0 };
+	bench_result_t save = { 0 };
+	bench_result_t save_native = { 0 };
+	bench_result_t copy = { 0 };
+	bench_result_t copy_block = { 0 };
+	bench_result_t copy_parallel = { 0 };
+	bench_result_t release = { 0 };
+	const uint8_t *input;
+	bench_buf_t buf = { 0 };
+	unsigned long long events;
+	cyaml_data_t *data = NULL;
+	unsigned *seq_count_out;
+	bench_counts_t start;
+	unsigned seq_count = 0;
+	double start_time;
+	double wall_start;
+	cyaml_err_t err;
+	bool ok = false;
+
+	if (!doc->generate(&buf)) {
+		fprintf(stderr, "%s: Failed to generate document\n", doc->name);
+		goto out;
+	}
+	input = (const uint8_t *)buf.data;
+
+	/* Only top level sequences have an entry count. */
+	seq_count_out = (doc->schema->type == CYAML_SEQUENCE) ?
+			&seq_count : NULL;
+
+	events = bench_count_events(buf.data, buf.len);
+	if (events == 0) {
+		fprintf(stderr, "%s: Failed to parse document\n", doc->name);
+		goto out;
+	}
+
+	while (bench_more(&load, seconds)) {
+		start_time = bench_start(&counts, &start);
+		err = cyaml_load_data(input, buf.len, &config, doc->schema,
+				&data, seq_count_out);
+		bench_stop(&load, &counts, &start, start_time);
+		if (err != CYAML_OK) {
+			fprintf(stderr, "%s: Load failed: %s\n",
+					doc->name, cyaml_strerror(err));
+			goto out;
+		}
+		cyaml_free(&config, doc->schema, data, seq_count);
+	}
+	bench_report(doc, "load", buf.len, events, &load);
+
+	native = config;
+	native.flags |= CYAML_CFG_NATIVE_SCANNER;
+	while (bench_more(&load_native, seconds)) {
+		start_time = bench_start(&counts, &start);
+		err = cyaml_load_data(input, buf.len, &native, doc->schema,
+				&data, seq_count_out);
+		bench_stop(&load_native, &counts, &start, start_time);
+		if (err != CYAML_OK) {
+			fprintf(stderr, "%s: Load failed: %s\n",
+					doc->name, cyaml_strerror(err));
+			goto out;
+		}
+		cyaml_free(&config, doc->schema, data, seq_count);
+	}
+	bench_report(doc, "load_native", buf.len, events, &load_native);
+
+	err = cyaml_load_data(input, buf.len, &config, doc->schema,
+			&data, seq_count_out);
+	if (err != CYAML_OK) {
+		fprintf(stderr, "%s: Load failed: %s\n",
+				doc->name, cyaml_strerror(err));
+		goto out;
+	}
+
+	while (bench_more(&save, seconds)) {
+		char *output;
+		size_t len;
+
+		start_time = bench_start(&counts, &start);
+		err = cyaml_save_data(&output, &len, &config, doc->schema,
+				data, seq_count);
+		bench_stop(&save, &counts, &start, start_time);
+		if (err != CYAML_OK) {
+			fprintf(stderr, "%s: Save failed: %s\n",
+					doc->name, cyaml_strerror(err));
+			break;
+		}
+		config.mem_fn(config.mem_ctx, output, 0);
+	}
+
+	native = config;
+	native.flags |= CYAML_CFG_NATIVE_EMITTER;
+	while (err == CYAML_OK && bench_more(&save_native, seconds)) {
+		char *output;
+		size_t len;
+
+		start_time = bench_start(&counts, &start);
+		err = cyaml_save_data(&output, &len, &native, doc->schema,
+				data, seq_count);
+		bench_stop(&save_native, &counts, &start, start_time);
+		if (err != CYAML_OK) {
+			fprintf(stderr, "%s: Save failed: %s\n",
+					doc->name, cyaml_strerror(err));
+			break;
+		}
+		config.mem_fn(config.mem_ctx, output, 0);
+	}
+
+	while (err == CYAML_OK && bench_more(&copy, seconds)) {
+		cyaml_data_t *copied = NULL;
+
+		start_time = bench_start(&counts, &start);
+		err = cyaml_copy(&config, doc->schema, data, seq_count,
+				&copied);
+		bench_stop(&copy, &counts, &start, start_time);
+		if (err != CYAML_OK) {
+			fprintf(stderr, "%s: Copy failed: %s\n",
+					doc->name, cyaml_strerror(err));
+			break;
+		}
+		cyaml_free(&config, doc->schema, copied, seq_count);
+	}
+
+	block = config;
+	block.flags |= CYAML_CFG_COPY_BLOCK;
+	while (err == CYAML_OK && bench_more(&copy_block, seconds)) {
+		cyaml_data_t *copied = NULL;
+
+		start_time = bench_start(&counts, &start);
+		err = cyaml_copy(&block, doc->schema, data, seq_count,
+				&copied);
+		bench_stop(&copy_block, &counts, &start, start_time);
+		if (err != CYAML_OK) {
+			fprintf(stderr, "%s: Copy failed: %s\n",
+					doc->name, cyaml_strerror(err));
+			break;
+		}
+		cyaml_arena_free(&block, copied);
+	}
+
+	parallel = block;
+	parallel.flags |= CYAML_CFG_PARALLEL;
+	while (err == CYAML_OK && bench_more(&copy_parallel, seconds)) {
+		cyaml_data_t *copied = NULL;
+
+		start_time = bench_start(&counts, &start);
+		err = cyaml_copy(&parallel, doc->schema, data, seq_count,
+				&copied);
+		bench_stop(&copy_parallel, &counts, &start, start_time);
+		if (err != CYAML_OK) {
+			fprintf(stderr, "%s: Copy failed: %s\n",
+					doc->name, cyaml_strerror(err));
+			break;
+		}
+		cyaml_arena_free(&parallel, copied);
+	}
+
+	cyaml_free(&config, doc->schema, data, seq_count);
+	if (err != CYAML_OK) {
+		goto out;
+	}
+	bench_report(doc, "save", buf.len, events, &save);
+	bench_report(doc, "save_native", buf.len, events, &save_native);
+	bench_report(doc, "copy", buf.len, events, &copy);
+	bench_report(doc, "copy_block", buf.len, events, &copy_block);
+	bench_report(doc, "copy_parallel", buf.len, events, &copy_parallel);
+
+	wall_start = bench_now();
+	while (bench_more(&release, seconds) && (release.iterations <
+			BENCH_ITERATIONS_MIN || bench_now() - wall_start <
+			seconds * BENCH_WALL_FACTOR)) {
+		err = cyaml_load_data(input, buf.len, &config, doc->schema,
+				&data, seq_count_out);
+		if (err != CYAML_OK) {
+			fprintf(stderr, "%s: Load failed: %s\n",
+					doc->name, cyaml_strerror(err));
+			goto out;
+		}
+		start_time = bench_start(&counts, &start);
+		cyaml_free(&config, doc->schema, data, seq_count);
+		bench_stop(&release, &counts, &start, start_time);
+	}
+	bench_report(doc, "free", buf.len, events, &release);
+
+	ok = true;
+out:
+	free(buf.data);
+	return ok;
+}
+
+/******************************************************************************
+ * Deep document: trees of nested mappings.
+ ******************************************************************************/
+
+/** A tree node. */
+struct bench_node {
+	int value;                   /**< The node's value. */
+	struct bench_node *children; /**< The node's children. */
+	unsigned children_count;     /**< Number of children. */
+};
+
+static const cyaml_schema_value_t bench_node_schema;
+
+/** Fields of a tree node mapping. */
+static const cyaml_schema_field_t bench_node_fields[] = {
+	CYAML_FIELD_INT("value", CYAML_FLAG_DEFAULT,
+			struct bench_node, value),
+	CYAML_FIELD_SEQUENCE("children",
+			CYAML_FLAG_POINTER | CYAML_FLAG_OPTIONAL,
+			struct bench_node, children, &bench_node_schema,
+			0, CYAML_UNLIMITED),
+	CYAML_FIELD_END
+};
+
+/** A tree node mapping. */
+static const cyaml_schema_value_t bench_node_schema = {
+	CYAML_VALUE_MAPPING(CYAML_FLAG_DEFAULT,
+			struct bench_node, bench_node_fields),
+};
+
+/** Top level schema for the deep document. */
+static const cyaml_schema_value_t bench_deep_schema = {
+	CYAML_VALUE_SEQUENCE(CYAML_FLAG_POINTER,
+			struct bench_node, &bench_node_schema,
+			0, CYAML_UNLIMITED),
+};
+
+/**
+ * Generate a tree node, and its descendants.
+ *
+ * \param[in]  buf    The buffer to write to.
+ * \param[in]  depth  Depth of the node.
+ * \return true on success, false otherwise.
+ */
+static bool bench_deep_node(
+		bench_buf_t *buf,
+		int depth)
+{
+	int indent = depth * 4;
+
+	if (!bench_printf(buf, "%*s- value: %d\n", indent, "", depth)) {
+		return false;
+	}
+
+	if (depth + 1 < BENCH_DEEP_DEPTH) {
+		if (!bench_printf(buf, "%*s  children:\n", indent, "")) {
+			return false;
+		}
+		return bench_deep_node(buf, depth + 1);
+	}
+
+	return true;
+}
+
+/**
+ * Generate the deep document.
+ *
+ * \param[in]  buf  The buffer to write to.
+ * \return true on success, false otherwise.
+ */
+static bool bench_deep(bench_buf_t *buf)
+{
+	for (unsigned i = 0; i < BENCH_DEEP_COUNT; i++) {
+		if (!bench_deep_node(buf, 0)) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/******************************************************************************
+ * Wide document: mappings with many keys.
+ ******************************************************************************/
+
+/** A wide mapping. */
+struct bench_wide {
+	int values[BENCH_WIDE_KEYS]; /**< Value of each key. */
+};
+
+/** Keys of a wide mapping. */
+static char bench_wide_keys[BENCH_WIDE_KEYS][16];
+
+/** Fields of a wide mapping, filled in by \ref bench_wide. */
+static cyaml_schema_field_t bench_wide_fields[BENCH_WIDE_KEYS + 1];
+
+/** A wide mapping. */
+static const cyaml_schema_value_t bench_wide_entry_schema = {
+	CYAML_VALUE_MAPPING(CYAML_FLAG_DEFAULT,
+			struct bench_wide, bench_wide_fields),
+};
+
+/** Top level schema for the wide document. */
+static const cyaml_schema_value_t bench_wide_schema = {
+	CYAML_VALUE_SEQUENCE(CYAML_FLAG_POINTER,
+			struct bench_wide, &bench_wide_entry_schema,
+			0, CYAML_UNLIMITED),
+};
+
+/**
+ * Generate the wide document.
+ *
+ * \param[in]  buf  The buffer to write to.
+ * \return true on success, false otherwise.
+ */
+static bool bench_wide(bench_buf_t *buf)
+{
+	for (unsigned k = 0; k < BENCH_WIDE_KEYS; k++) {
+		snprintf(bench_wide_keys[k], sizeof(bench_wide_keys[k]),
+				"key_%02u", k);
+		bench_wide_fields[k] = (cyaml_schema_field_t) {
+			.key = bench_wide_keys[k],
+			.data_offset = offsetof(struct bench_wide, values) +
+					k * sizeof(int),
+			.value = {
+				.type = CYAML_INT,
+				.flags = CYAML_FLAG_DEFAULT,
+				.data_size = sizeof(int),
+			},
+		};
+	}
+
+	for (unsigned i = 0; i < BENCH_WIDE_COUNT; i++) {
+		for (unsigned k = 0; k < BENCH_WIDE_KEYS; k++) {
+			if (!bench_printf(buf, "%s key_%02u: %u\n",
+					k == 0 ? "-" : " ", k, i + k)) {
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+/******************************************************************************
+ * Numeric document: a huge sequence of numbers.
+ ******************************************************************************/
+
+/** Numeric document. */
+struct bench_numeric {
+	double *values;        /**< The values. */
+	unsigned values_count; /**< Number of values. */
+};
+
+/** Numeric value. */
+static const cyaml_schema_value_t bench_numeric_entry_schema = {
+	CYAML_VALUE_FLOAT(CYAML_FLAG_DEFAULT, double),
+};
+
+/** Fields of the numeric document mapping. */
+static const cyaml_schema_field_t bench_numeric_fields[] = {
+	CYAML_FIELD_SEQUENCE("values", CYAML_FLAG_POINTER,
+			struct bench_numeric, values,
+			&bench_numeric_entry_schema, 0, CYAML_UNLIMITED),
+	CYAML_FIELD_END
+};
+
+/** Top level schema for the numeric document. */
+static const cyaml_schema_value_t bench_numeric_schema = {
+	CYAML_VALUE_MAPPING(CYAML_FLAG_POINTER,
+			struct bench_numeric, bench_numeric_fields),
+};
+
+/**
+ * Generate the numeric document.
+ *
+ * \param[in]  buf  The buffer to write to.
+ * \return true on success, false otherwise.
+ */
+static bool bench_numeric(bench_buf_t *buf)
+{
+	if (!bench_printf(buf, "values:\n")) {
+		return false;
+	}
+
+	for (unsigned i = 0; i < BENCH_NUMERIC_COUNT; i++) {
+		if (!bench_printf(buf, "  - %u.%03u\n", i, i % 1000)) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/******************************************************************************
+ * Strings document: a config with many string values.
+ ******************************************************************************/
+
+/** An entry in the strings document. */
+struct bench_string {
+	char *name;        /**< Entry name. */
+	char *path;        /**< Entry path. */
+	char *description; /**< Entry description. */
+};
+
+/** Fields of an entry in the strings document. */
+static const cyaml_schema_field_t bench_string_fields[] = {
+	CYAML_FIELD_STRING_PTR("name", CYAML_FLAG_POINTER,
+			struct bench_string, name, 0, CYAML_UNLIMITED),
+	CYAML_FIELD_STRING_PTR("path", CYAML_FLAG_POINTER,
+			struct bench_string, path, 0, CYAML_UNLIMITED),
+	CYAML_FIELD_STRING_PTR("description", CYAML_FLAG_POINTER,
+			struct bench_string, description, 0, CYAML_UNLIMITED),
+	CYAML_FIELD_END
+};
+
+/** An entry in the strings document. */
+static const cyaml_schema_value_t bench_string_entry_schema = {
+	CYAML_VALUE_MAPPING(CYAML_FLAG_DEFAULT,
+			struct bench_string, bench_string_fields),
+};
+
+/** Top level schema for the strings document. */
+static const cyaml_schema_value_t bench_strings_schema = {
+	CYAML_VALUE_SEQUENCE(CYAML_FLAG_POINTER,
+			struct bench_string, &bench_string_entry_schema,
+			0, CYAML_UNLIMITED),
+};
+
+/**
+ * Generate the strings document.
+ *
+ * \param[in]  buf  The buffer to write to.
+ * \return true on success, false otherwise.
+ */
+static bool bench_strings(bench_buf_t *buf)
+{
+	for (unsigned i = 0; i < BENCH_STRINGS_COUNT; i++) {
+		if (!bench_printf(buf,
+				"- name: service-%u\n"
+				"  path: /srv/services/%u/config/main.yaml\n"
+				"  description: \"Service number %u, which "
+				"handles requests for group %u.\"\n",
+				i, i, i, i % 17)) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/******************************************************************************
+ * Anchors document: many aliases of a few anchored values.
+ ******************************************************************************/
+
+/** An entry in the anchors document. */
+struct bench_anchor {
+	char *name;               /**< Entry name. */
+	struct bench_string *ref; /**< Referenced details. */
+};
+
+/** Fields of an entry in the anchors document. */
+static const cyaml_schema_field_t bench_anchor_fields[] = {
+	CYAML_FIELD_STRING_PTR("name", CYAML_FLAG_POINTER,
+			struct bench_anchor, name, 0, CYAML_UNLIMITED),
+	CYAML_FIELD_MAPPING_PTR("ref", CYAML_FLAG_POINTER,
+			struct bench_anchor, ref, bench_string_fields),
+	CYAML_FIELD_END
+};
+
+/** An entry in the anchors document. */
+static const cyaml_schema_value_t bench_anchor_entry_schema = {
+	CYAML_VALUE_MAPPING(CYAML_FLAG_DEFAULT,
+			struct bench_anchor, bench_anchor_fields),
+};
+
+/** Top level schema for the anchors document. */
+static const cyaml_schema_value_t bench_anchors_schema = {
+	CYAML_VALUE_SEQUENCE(CYAML_FLAG_POINTER,
+			struct bench_anchor, &bench_anchor_entry_schema,
+			0, CYAML_UNLIMITED),
+};
+
+/**
+ * Generate the anchors document.
+ *
+ * \param[in]  buf  The buffer to write to.
+ * \return true on success, false otherwise.
+ */
+static bool bench_anchors(bench_buf_t *buf)
+{
+	for (unsigned i = 0; i < BENCH_ANCHORS_COUNT; i++) {
+		unsigned a = i % BENCH_ANCHORS_DISTINCT;
+		bool ok;
+
+		if (i < BENCH_ANCHORS_DISTINCT) {
+			ok = bench_printf(buf,
+					"- name: &n%u entry %u\n"
+					"  ref: &r%u\n"
+					"    name: ref-%u\n"
+					"    path: /srv/refs/%u\n"
+					"    description: Reference %u\n",
+					a, a, a, a, a, a);
+		} else {
+			ok = bench_printf(buf,
+					"- name: *n%u\n"
+					"  ref: *r%u\n", a, a);
+		}
+		if (!ok) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/** The benchmark documents. */
+static const bench_doc_t bench_docs[] = {
+	{ "deep",    &bench_deep_schema,    bench_deep    },
+	{ "wide",    &bench_wide_schema,    bench_wide    },
+	{ "numeric", &bench_numeric_schema, bench_numeric },
+	{ "strings", &bench_strings_schema, bench_strings },
+	{ "anchors", &bench_anchors_schema, bench_anchors },
+};
+
+/**
+ * Check whether a document has been selected on the command line.
+ *
+ * \param[in]  doc   The document.
+ * \param[in]  argc  Number of document names.
+ * \param[in]  argv  Document names.
+ * \return true if the document should be run.
+ */
+static bool bench_selected(
+		const bench_doc_t *doc,
+		int argc,
+		char *argv[])
+{
+	bool any = false;
+
+	for (int i = 0; i < argc; i++) {
+		/* Allow a single space separated list, as from `make`. */
+		const char *name = argv[i];
+
+		while (*name != '\0') {
+			size_t len = strcspn(name, " ");
+
+			if (len != 0) {
+				any = true;
+				if (len == strlen(doc->name) &&
+				    strncmp(name, doc->name, len) == 0) {
+					return true;
+				}
+			}
+			name += len;
+			name += strspn(name, " ");
+		}
+	}
+
+	return !any;
+}
+
+/**
+ * Main entry point from OS.
+ *
+ * \param[in]  argc  Argument count.
+ * \param[in]  argv  Vector of string arguments.
+ * \return Program return code.
+ */
+int main(int argc, char *argv[])
+{
+	double seconds = BENCH_TIME_DEFAULT;
+	bool ok = true;
+	int i = 1;
+
+	if (argc > 2 && strcmp(argv[1], "-t") == 0) {
+		seconds = strtod(argv[2], NULL);
+		i = 3;
+	}
+
+	printf("document,operation,iterations,bytes,events,ns_per_op,"
+			"mb_per_s,events_per_s,ns_per_event,"
+			"allocs_per_op,frees_per_op\n");
+
+	for (unsigned d = 0; d < CYAML_ARRAY_LEN(bench_docs); d++) {
+		if (bench_selected(&bench_docs[d], argc - i, argv + i)) {
+			ok &= bench_doc(&bench_docs[d], seconds);
+		}
+	}
+
+	return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
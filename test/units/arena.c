@@ -0,0 +1,1032 @@
+/*
+ * SPDX-License-Identifier: ISC
+ *
+ * Copyright (C) 2026 Michael Drake <tlsa@netsurf-browser.org>
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <assert.h>
+#include <string.h>
+#include <stdio.h>
+
+#include <cyaml/cyaml.h>
+
+#include "ttest.h"
+#include "test.h"
+
+/** Helper macro to count bytes of YAML input data. */
+#define YAML_LEN(_y) (sizeof(_y) - 1)
+
+/**
+ * Unit test context data.
+ */
+typedef struct test_data {
+	cyaml_data_t **data;
+	cyaml_data_t **copy;
+	cyaml_data_t **block;
+	unsigned *seq_count;
+	const struct cyaml_config *config;
+	const struct cyaml_schema_value *schema;
+} test_data_t;
+
+/**
+ * Common clean up function to free data loaded by tests.
+ *
+ * \param[in]  data  The unit test context data.
+ */
+static void cyaml_cleanup(void *data)
+{
+	struct test_data *td = data;
+	unsigned seq_count = 0;
+
+	if (td->seq_count != NULL) {
+		seq_count = *(td->seq_count);
+	}
+
+	if (td->data != NULL) {
+		cyaml_arena_free(td->config, *(td->data));
+	}
+
+	if (td->copy != NULL) {
+		cyaml_free(td->config, td->schema, *(td->copy), seq_count);
+	}
+
+	if (td->block != NULL) {
+		cyaml_arena_free(td->config, *(td->block));
+	}
+}
+
+/**
+ * Allocation counting memory function.
+ *
+ * \param[in] ctx    Pointer to count of live allocations.
+ * \param[in] ptr    Existing allocation to resize, or NULL.
+ * \param[in] size   The new size for the allocation.
+ * \return the allocation, or NULL.
+ */
+static void * test_arena_mem_count(
+		void *ctx,
+		void *ptr,
+		size_t size)
+{
+	unsigned *live = ctx;
+	void *temp = cyaml_mem(NULL, ptr, size);
+
+	if (ptr == NULL && temp != NULL) {
+		(*live)++;
+	} else if (size == 0 && ptr != NULL) {
+		(*live)--;
+	}
+
+	return temp;
+}
+
+/**
+ * Test loading a deep document into an arena.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_arena_load_mapping(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	struct inner {
+		char *name;
+		int value;
+	};
+	struct target_struct {
+		char *title;
+		struct inner *inner;
+		char **strings;
+		unsigned strings_count;
+		int *numbers;
+		unsigned numbers_count;
+	} *data_tgt = NULL;
+	static const unsigned char yaml[] =
+		"title: Arena test\n"
+		"inner:\n"
+		"  name: Deep\n"
+		"  value: 99\n"
+		"strings: [ a, bb, ccc, dddd, eeeee, ffffff ]\n"
+		"numbers: [ 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14 ]\n";
+	static const char * const ref_strings[] = {
+		"a", "bb", "ccc", "dddd", "eeeee", "ffffff",
+	};
+	static const struct cyaml_schema_field inner_schema[] = {
+		CYAML_FIELD_STRING_PTR("name", CYAML_FLAG_POINTER,
+				struct inner, name, 0, CYAML_UNLIMITED),
+		CYAML_FIELD_INT("value", CYAML_FLAG_DEFAULT,
+				struct inner, value),
+		CYAML_FIELD_END
+	};
+	static const struct cyaml_schema_value string_schema = {
+		CYAML_VALUE_STRING(CYAML_FLAG_POINTER, char,
+				0, CYAML_UNLIMITED),
+	};
+	static const struct cyaml_schema_value int_schema = {
+		CYAML_VALUE_INT(CYAML_FLAG_DEFAULT, int),
+	};
+	static const struct cyaml_schema_field mapping_schema[] = {
+		CYAML_FIELD_STRING_PTR("title", CYAML_FLAG_POINTER,
+				struct target_struct, title,
+				0, CYAML_UNLIMITED),
+		CYAML_FIELD_MAPPING_PTR("inner", CYAML_FLAG_POINTER,
+				struct target_struct, inner, inner_schema),
+		CYAML_FIELD_SEQUENCE("strings", CYAML_FLAG_POINTER,
+				struct target_struct, strings,
+				&string_schema, 0, CYAML_UNLIMITED),
+		CYAML_FIELD_SEQUENCE("numbers", CYAML_FLAG_POINTER,
+				struct target_struct, numbers,
+				&int_schema, 0, CYAML_UNLIMITED),
+		CYAML_FIELD_END
+	};
+	static const struct cyaml_schema_value top_schema = {
+		CYAML_VALUE_MAPPING(CYAML_FLAG_POINTER,
+				struct target_struct, mapping_schema),
+	};
+	unsigned live = 0;
+	cyaml_config_t cfg = *config;
+	test_data_t td = {
+		.data = (cyaml_data_t **) &data_tgt,
+		.config = &cfg,
+		.schema = &top_schema,
+	};
+	cyaml_err_t err;
+	ttest_ctx_t tc;
+
+	cfg.mem_fn = test_arena_mem_count;
+	cfg.mem_ctx = &live;
+	cfg.flags |= CYAML_CFG_ARENA;
+	cfg.arena_chunk_size = 128;
+	if (!ttest_start(report, __func__, cyaml_cleanup, &td, &tc)) {
+		return true;
+	}
+
+	err = cyaml_load_data(yaml, YAML_LEN(yaml), &cfg, &top_schema,
+			(cyaml_data_t **) &data_tgt, NULL);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	if (strcmp(data_tgt->title, "Arena test") != 0) {
+		return ttest_fail(&tc, "Incorrect value for title");
+	}
+	if (strcmp(data_tgt->inner->name, "Deep") != 0 ||
+	    data_tgt->inner->value != 99) {
+		return ttest_fail(&tc, "Incorrect value for inner");
+	}
+	if (data_tgt->strings_count != 6) {
+		return ttest_fail(&tc, "Incorrect strings count");
+	}
+	for (unsigned i = 0; i < data_tgt->strings_count; i++) {
+		if (strcmp(data_tgt->strings[i], ref_strings[i]) != 0) {
+			return ttest_fail(&tc, "Bad string value");
+		}
+	}
+	if (data_tgt->numbers_count != 14) {
+		return ttest_fail(&tc, "Incorrect numbers count");
+	}
+	for (unsigned i = 0; i < data_tgt->numbers_count; i++) {
+		if (data_tgt->numbers[i] != (int)i + 1) {
+			return ttest_fail(&tc, "Bad number value");
+		}
+	}
+
+	/* The 10 loaded pointer values should share a few chunks. */
+	if (live > 6) {
+		return ttest_fail(&tc, "Too many allocations");
+	}
+
+	err = cyaml_arena_free(&cfg, data_tgt);
+	data_tgt = NULL;
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	if (live != 0) {
+		return ttest_fail(&tc, "Arena free leaked allocations");
+	}
+
+	return ttest_pass(&tc);
+}
+
+/**
+ * Test loading a top level sequence into an arena.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_arena_load_top_level_sequence(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	static const unsigned char yaml[] =
+		"- one\n"
+		"- two\n"
+		"- three\n";
+	static const char * const ref[] = {
+		"one", "two", "three",
+	};
+	char **data_tgt = NULL;
+	unsigned count = 0;
+	static const struct cyaml_schema_value entry_schema = {
+		CYAML_VALUE_STRING(CYAML_FLAG_POINTER, char,
+				0, CYAML_UNLIMITED),
+	};
+	static const struct cyaml_schema_value top_schema = {
+		CYAML_VALUE_SEQUENCE(CYAML_FLAG_POINTER, char *,
+				&entry_schema, 0, CYAML_UNLIMITED),
+	};
+	cyaml_config_t cfg = *config;
+	test_data_t td = {
+		.data = (cyaml_data_t **) &data_tgt,
+		.config = &cfg,
+		.schema = &top_schema,
+	};
+	cyaml_err_t err;
+	ttest_ctx_t tc;
+
+	cfg.flags |= CYAML_CFG_ARENA;
+	if (!ttest_start(report, __func__, cyaml_cleanup, &td, &tc)) {
+		return true;
+	}
+
+	err = cyaml_load_data(yaml, YAML_LEN(yaml), &cfg, &top_schema,
+			(cyaml_data_t **) &data_tgt, &count);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	if (count != 3) {
+		return ttest_fail(&tc, "Incorrect sequence count");
+	}
+	for (unsigned i = 0; i < count; i++) {
+		if (strcmp(data_tgt[i], ref[i]) != 0) {
+			return ttest_fail(&tc, "Incorrect value");
+		}
+	}
+
+	return ttest_pass(&tc);
+}
+
+/** Test document for string interning, with repeated strings. */
+static const unsigned char test_arena_intern_yaml[] =
+	"- eu-west\n"
+	"- us-east\n"
+	"- eu-west\n"
+	"- eu-west\n"
+	"- us-east\n";
+
+/** Test entry schema for string interning. */
+static const struct cyaml_schema_value test_arena_intern_entry = {
+	CYAML_VALUE_STRING(CYAML_FLAG_POINTER, char, 0, CYAML_UNLIMITED),
+};
+
+/** Test top level schema for string interning. */
+static const struct cyaml_schema_value test_arena_intern_schema = {
+	CYAML_VALUE_SEQUENCE(CYAML_FLAG_POINTER, char *,
+			&test_arena_intern_entry, 0, CYAML_UNLIMITED),
+};
+
+/**
+ * Check a loaded string interning test document.
+ *
+ * \param[in]  data    The loaded document.
+ * \param[in]  count   The loaded sequence entry count.
+ * \param[in]  shared  Whether equal strings should share an allocation.
+ * \return true if the document is as expected, false otherwise.
+ */
+static bool test_arena_intern_check(
+		char * const *data,
+		unsigned count,
+		bool shared)
+{
+	if (count != 5 ||
+	    strcmp(data[0], "eu-west") != 0 ||
+	    strcmp(data[1], "us-east") != 0 ||
+	    strcmp(data[3], "eu-west") != 0 ||
+	    strcmp(data[4], "us-east") != 0) {
+		return false;
+	}
+
+	if (data[0] == data[1]) {
+		return false;
+	}
+
+	return shared == (data[0] == data[2] && data[0] == data[3] &&
+			data[1] == data[4]);
+}
+
+/**
+ * Test loading repeated strings into an arena with interning.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_arena_load_intern(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	char **data_tgt = NULL;
+	char **copy = NULL;
+	unsigned count = 0;
+	cyaml_config_t cfg = *config;
+	test_data_t td = {
+		.data = (cyaml_data_t **) &data_tgt,
+		.copy = (cyaml_data_t **) &copy,
+		.seq_count = &count,
+		.config = &cfg,
+		.schema = &test_arena_intern_schema,
+	};
+	cyaml_err_t err;
+	ttest_ctx_t tc;
+
+	cfg.flags |= CYAML_CFG_ARENA | CYAML_CFG_INTERN;
+	if (!ttest_start(report, __func__, cyaml_cleanup, &td, &tc)) {
+		return true;
+	}
+
+	err = cyaml_load_data(test_arena_intern_yaml,
+			YAML_LEN(test_arena_intern_yaml), &cfg,
+			&test_arena_intern_schema,
+			(cyaml_data_t **) &data_tgt, &count);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	if (!test_arena_intern_check(data_tgt, count, true)) {
+		return ttest_fail(&tc, "Strings not interned");
+	}
+
+	err = cyaml_copy(&cfg, &test_arena_intern_schema,
+			data_tgt, count, (cyaml_data_t **) &copy);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	if (!test_arena_intern_check(copy, count, false)) {
+		return ttest_fail(&tc, "Copied strings shared");
+	}
+
+	return ttest_pass(&tc);
+}
+
+/**
+ * Test that strings aren't interned without an arena.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_arena_load_intern_no_arena(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	char **data_tgt = NULL;
+	unsigned count = 0;
+	cyaml_config_t cfg = *config;
+	test_data_t td = {
+		.copy = (cyaml_data_t **) &data_tgt,
+		.seq_count = &count,
+		.config = &cfg,
+		.schema = &test_arena_intern_schema,
+	};
+	cyaml_err_t err;
+	ttest_ctx_t tc;
+
+	cfg.flags |= CYAML_CFG_INTERN;
+	if (!ttest_start(report, __func__, cyaml_cleanup, &td, &tc)) {
+		return true;
+	}
+
+	err = cyaml_load_data(test_arena_intern_yaml,
+			YAML_LEN(test_arena_intern_yaml), &cfg,
+			&test_arena_intern_schema,
+			(cyaml_data_t **) &data_tgt, &count);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	if (!test_arena_intern_check(data_tgt, count, false)) {
+		return ttest_fail(&tc, "Strings shared without arena");
+	}
+
+	return ttest_pass(&tc);
+}
+
+/**
+ * Test that a loader doesn't share interned strings between documents.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_arena_load_intern_loader(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	char **data_tgt = NULL;
+	char **block = NULL;
+	unsigned count = 0;
+	unsigned count2 = 0;
+	cyaml_loader_t *loader = NULL;
+	cyaml_config_t cfg = *config;
+	test_data_t td = {
+		.data = (cyaml_data_t **) &data_tgt,
+		.block = (cyaml_data_t **) &block,
+		.config = &cfg,
+		.schema = &test_arena_intern_schema,
+	};
+	cyaml_err_t err;
+	ttest_ctx_t tc;
+
+	cfg.flags |= CYAML_CFG_ARENA | CYAML_CFG_INTERN;
+	if (!ttest_start(report, __func__, cyaml_cleanup, &td, &tc)) {
+		return true;
+	}
+
+	err = cyaml_loader_create(&cfg, &loader);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	err = cyaml_loader_load_data(loader, test_arena_intern_yaml,
+			YAML_LEN(test_arena_intern_yaml),
+			&test_arena_intern_schema,
+			(cyaml_data_t **) &data_tgt, &count);
+	if (err != CYAML_OK) {
+		cyaml_loader_free(loader);
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	err = cyaml_loader_load_data(loader, test_arena_intern_yaml,
+			YAML_LEN(test_arena_intern_yaml),
+			&test_arena_intern_schema,
+			(cyaml_data_t **) &block, &count2);
+	cyaml_loader_free(loader);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	if (!test_arena_intern_check(block, count2, true)) {
+		return ttest_fail(&tc, "Strings not interned");
+	}
+
+	for (unsigned i = 0; i < count; i++) {
+		if (block[i] == data_tgt[i]) {
+			return ttest_fail(&tc, "String shared across loads");
+		}
+	}
+
+	return ttest_pass(&tc);
+}
+
+/**
+ * Test loading pointer default values into an arena.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_arena_load_defaults(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	struct inner {
+		char *name;
+	};
+	struct target_struct {
+		int value;
+		char *str;
+		struct inner *inner;
+	} *data_tgt = NULL;
+	static const unsigned char yaml[] =
+		"value: 1\n";
+	static const struct inner inner_default = {
+		.name = (char *) "Default name",
+	};
+	static const struct cyaml_schema_field inner_schema[] = {
+		CYAML_FIELD_STRING_PTR("name", CYAML_FLAG_POINTER,
+				struct inner, name, 0, CYAML_UNLIMITED),
+		CYAML_FIELD_END
+	};
+	static const struct cyaml_schema_field mapping_schema[] = {
+		CYAML_FIELD_INT("value", CYAML_FLAG_DEFAULT,
+				struct target_struct, value),
+		{
+			.key = "str",
+			.data_offset = offsetof(struct target_struct, str),
+			.value = {
+				.type = CYAML_STRING,
+				.flags = CYAML_FLAG_POINTER |
+				         CYAML_FLAG_OPTIONAL,
+				.data_size = sizeof(char),
+				.string = {
+					.min = 0,
+					.max = CYAML_UNLIMITED,
+					.missing = "Default str",
+				},
+			},
+		},
+		{
+			.key = "inner",
+			.data_offset = offsetof(struct target_struct, inner),
+			.value = {
+				.type = CYAML_MAPPING,
+				.flags = CYAML_FLAG_POINTER |
+				         CYAML_FLAG_OPTIONAL,
+				.data_size = sizeof(struct inner),
+				.mapping = {
+					.fields = inner_schema,
+					.missing = &inner_default,
+				},
+			},
+		},
+		CYAML_FIELD_END
+	};
+	static const struct cyaml_schema_value top_schema = {
+		CYAML_VALUE_MAPPING(CYAML_FLAG_POINTER,
+				struct target_struct, mapping_schema),
+	};
+	unsigned live = 0;
+	cyaml_config_t cfg = *config;
+	test_data_t td = {
+		.data = (cyaml_data_t **) &data_tgt,
+		.config = &cfg,
+		.schema = &top_schema,
+	};
+	cyaml_err_t err;
+	ttest_ctx_t tc;
+
+	cfg.mem_fn = test_arena_mem_count;
+	cfg.mem_ctx = &live;
+	cfg.flags |= CYAML_CFG_ARENA;
+	if (!ttest_start(report, __func__, cyaml_cleanup, &td, &tc)) {
+		return true;
+	}
+
+	err = cyaml_load_data(yaml, YAML_LEN(yaml), &cfg, &top_schema,
+			(cyaml_data_t **) &data_tgt, NULL);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	if (data_tgt->value != 1 ||
+	    strcmp(data_tgt->str, "Default str") != 0 ||
+	    strcmp(data_tgt->inner->name, "Default name") != 0) {
+		return ttest_fail(&tc, "Incorrect value");
+	}
+
+	err = cyaml_arena_free(&cfg, data_tgt);
+	data_tgt = NULL;
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	if (live != 0) {
+		return ttest_fail(&tc, "Arena free leaked allocations");
+	}
+
+	return ttest_pass(&tc);
+}
+
+/**
+ * Test failing to load a document into an arena.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_arena_load_error(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	struct target_struct {
+		char *a;
+		char *b;
+		int c;
+	} *data_tgt = NULL;
+	static const unsigned char yaml[] =
+		"a: Cheerful\n"
+		"b: Lollipop\n"
+		"c: Unicorns\n";
+	static const struct cyaml_schema_field mapping_schema[] = {
+		CYAML_FIELD_STRING_PTR("a", CYAML_FLAG_POINTER,
+				struct target_struct, a, 0, CYAML_UNLIMITED),
+		CYAML_FIELD_STRING_PTR("b", CYAML_FLAG_POINTER,
+				struct target_struct, b, 0, CYAML_UNLIMITED),
+		CYAML_FIELD_INT("c", CYAML_FLAG_DEFAULT,
+				struct target_struct, c),
+		CYAML_FIELD_END
+	};
+	static const struct cyaml_schema_value top_schema = {
+		CYAML_VALUE_MAPPING(CYAML_FLAG_POINTER,
+				struct target_struct, mapping_schema),
+	};
+	unsigned live = 0;
+	cyaml_config_t cfg = *config;
+	test_data_t td = {
+		.data = (cyaml_data_t **) &data_tgt,
+		.config = &cfg,
+		.schema = &top_schema,
+	};
+	cyaml_err_t err;
+	ttest_ctx_t tc;
+
+	cfg.mem_fn = test_arena_mem_count;
+	cfg.mem_ctx = &live;
+	cfg.flags |= CYAML_CFG_ARENA;
+	if (!ttest_start(report, __func__, cyaml_cleanup, &td, &tc)) {
+		return true;
+	}
+
+	err = cyaml_load_data(yaml, YAML_LEN(yaml), &cfg, &top_schema,
+			(cyaml_data_t **) &data_tgt, NULL);
+	if (err != CYAML_ERR_INVALID_VALUE) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	if (data_tgt != NULL) {
+		return ttest_fail(&tc, "Data non-NULL on error");
+	}
+
+	if (live != 0) {
+		return ttest_fail(&tc, "Failed load leaked allocations");
+	}
+
+	return ttest_pass(&tc);
+}
+
+/**
+ * Test copying data loaded into an arena.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_arena_copy(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	struct target_struct {
+		char *a;
+		char *b;
+	} *data_tgt = NULL, *copy = NULL;
+	static const unsigned char yaml[] =
+		"a: Cheerful\n"
+		"b: Lollipop\n";
+	static const struct cyaml_schema_field mapping_schema[] = {
+		CYAML_FIELD_STRING_PTR("a", CYAML_FLAG_POINTER,
+				struct target_struct, a, 0, CYAML_UNLIMITED),
+		CYAML_FIELD_STRING_PTR("b", CYAML_FLAG_POINTER,
+				struct target_struct, b, 0, CYAML_UNLIMITED),
+		CYAML_FIELD_END
+	};
+	static const struct cyaml_schema_value top_schema = {
+		CYAML_VALUE_MAPPING(CYAML_FLAG_POINTER,
+				struct target_struct, mapping_schema),
+	};
+	cyaml_config_t cfg = *config;
+	test_data_t td = {
+		.data = (cyaml_data_t **) &data_tgt,
+		.copy = (cyaml_data_t **) &copy,
+		.config = &cfg,
+		.schema = &top_schema,
+	};
+	cyaml_err_t err;
+	ttest_ctx_t tc;
+
+	cfg.flags |= CYAML_CFG_ARENA;
+	if (!ttest_start(report, __func__, cyaml_cleanup, &td, &tc)) {
+		return true;
+	}
+
+	err = cyaml_load_data(yaml, YAML_LEN(yaml), &cfg, &top_schema,
+			(cyaml_data_t **) &data_tgt, NULL);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	err = cyaml_copy(&cfg, &top_schema, data_tgt, 0,
+			(cyaml_data_t **) &copy);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	if (strcmp(copy->a, "Cheerful") != 0 ||
+	    strcmp(copy->b, "Lollipop") != 0) {
+		return ttest_fail(&tc, "Incorrect value");
+	}
+
+	return ttest_pass(&tc);
+}
+
+/**
+ * Test copying a deep document into a single allocation.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_arena_copy_block(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	struct inner {
+		char *name;
+		int value;
+	};
+	struct target_struct {
+		char *title;
+		struct inner *inner;
+		char **strings;
+		unsigned strings_count;
+		int *numbers;
+		unsigned numbers_count;
+		int *fixed;
+	} *data_tgt = NULL, *copy = NULL;
+	static const unsigned char yaml[] =
+		"title: Block test\n"
+		"inner:\n"
+		"  name: Deep\n"
+		"  value: 99\n"
+		"strings: [ a, bb, ccc, dddd, eeeee, ffffff ]\n"
+		"numbers: [ 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14 ]\n"
+		"fixed: [ 7, 8, 9 ]\n";
+	static const char * const ref_strings[] = {
+		"a", "bb", "ccc", "dddd", "eeeee", "ffffff",
+	};
+	static const struct cyaml_schema_field inner_schema[] = {
+		CYAML_FIELD_STRING_PTR("name", CYAML_FLAG_POINTER,
+				struct inner, name, 0, CYAML_UNLIMITED),
+		CYAML_FIELD_INT("value", CYAML_FLAG_DEFAULT,
+				struct inner, value),
+		CYAML_FIELD_END
+	};
+	static const struct cyaml_schema_value string_schema = {
+		CYAML_VALUE_STRING(CYAML_FLAG_POINTER, char,
+				0, CYAML_UNLIMITED),
+	};
+	static const struct cyaml_schema_value int_schema = {
+		CYAML_VALUE_INT(CYAML_FLAG_DEFAULT, int),
+	};
+	static const struct cyaml_schema_field mapping_schema[] = {
+		CYAML_FIELD_STRING_PTR("title", CYAML_FLAG_POINTER,
+				struct target_struct, title,
+				0, CYAML_UNLIMITED),
+		CYAML_FIELD_MAPPING_PTR("inner", CYAML_FLAG_POINTER,
+				struct target_struct, inner, inner_schema),
+		CYAML_FIELD_SEQUENCE("strings", CYAML_FLAG_POINTER,
+				struct target_struct, strings,
+				&string_schema, 0, CYAML_UNLIMITED),
+		CYAML_FIELD_SEQUENCE("numbers", CYAML_FLAG_POINTER,
+				struct target_struct, numbers,
+				&int_schema, 0, CYAML_UNLIMITED),
+		CYAML_FIELD_SEQUENCE_FIXED("fixed", CYAML_FLAG_POINTER,
+				struct target_struct, fixed,
+				&int_schema, 3),
+		CYAML_FIELD_END
+	};
+	static const struct cyaml_schema_value top_schema = {
+		CYAML_VALUE_MAPPING(CYAML_FLAG_POINTER,
+				struct target_struct, mapping_schema),
+	};
+	unsigned live = 0;
+	unsigned loaded;
+	cyaml_config_t cfg = *config;
+	test_data_t td = {
+		.data = (cyaml_data_t **) &data_tgt,
+		.block = (cyaml_data_t **) &copy,
+		.config = &cfg,
+		.schema = &top_schema,
+	};
+	cyaml_err_t err;
+	ttest_ctx_t tc;
+
+	cfg.mem_fn = test_arena_mem_count;
+	cfg.mem_ctx = &live;
+	cfg.flags |= CYAML_CFG_ARENA;
+	if (!ttest_start(report, __func__, cyaml_cleanup, &td, &tc)) {
+		return true;
+	}
+
+	err = cyaml_load_data(yaml, YAML_LEN(yaml), &cfg, &top_schema,
+			(cyaml_data_t **) &data_tgt, NULL);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	loaded = live;
+	cfg.flags |= CYAML_CFG_COPY_BLOCK;
+	err = cyaml_copy(&cfg, &top_schema, data_tgt, 0,
+			(cyaml_data_t **) &copy);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	if (live != loaded + 1) {
+		return ttest_fail(&tc, "Copy made %u allocations",
+				live - loaded);
+	}
+
+	if (strcmp(copy->title, "Block test") != 0) {
+		return ttest_fail(&tc, "Incorrect value for title");
+	}
+	if (strcmp(copy->inner->name, "Deep") != 0 ||
+	    copy->inner->value != 99) {
+		return ttest_fail(&tc, "Incorrect value for inner");
+	}
+	if (copy->strings_count != 6) {
+		return ttest_fail(&tc, "Incorrect strings count");
+	}
+	for (unsigned i = 0; i < copy->strings_count; i++) {
+		if (strcmp(copy->strings[i], ref_strings[i]) != 0) {
+			return ttest_fail(&tc, "Bad string value");
+		}
+	}
+	if (copy->numbers_count != 14) {
+		return ttest_fail(&tc, "Incorrect numbers count");
+	}
+	for (unsigned i = 0; i < copy->numbers_count; i++) {
+		if (copy->numbers[i] != (int)i + 1) {
+			return ttest_fail(&tc, "Bad number value");
+		}
+	}
+	for (unsigned i = 0; i < 3; i++) {
+		if (copy->fixed[i] != (int)i + 7) {
+			return ttest_fail(&tc, "Bad fixed value");
+		}
+	}
+	if (copy->title == data_tgt->title ||
+	    copy->strings[0] == data_tgt->strings[0]) {
+		return ttest_fail(&tc, "Copy shares source data");
+	}
+
+	err = cyaml_arena_free(&cfg, copy);
+	copy = NULL;
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	if (live != loaded) {
+		return ttest_fail(&tc, "Arena free leaked allocations");
+	}
+
+	return ttest_pass(&tc);
+}
+
+/**
+ * Test copying into a single allocation fails cleanly.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_arena_copy_block_error(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	struct target_struct {
+		char *a;
+		char *b;
+	} data = {
+		.a = (char *) "Cheerful",
+	}, *copy = NULL;
+	static const struct cyaml_schema_field mapping_schema[] = {
+		CYAML_FIELD_STRING_PTR("a", CYAML_FLAG_POINTER,
+				struct target_struct, a, 0, CYAML_UNLIMITED),
+		CYAML_FIELD_STRING_PTR("b", CYAML_FLAG_POINTER,
+				struct target_struct, b, 0, CYAML_UNLIMITED),
+		CYAML_FIELD_END
+	};
+	static const struct cyaml_schema_value top_schema = {
+		CYAML_VALUE_MAPPING(CYAML_FLAG_POINTER,
+				struct target_struct, mapping_schema),
+	};
+	static const struct cyaml_schema_value top_schema_non_ptr = {
+		CYAML_VALUE_MAPPING(CYAML_FLAG_DEFAULT,
+				struct target_struct, mapping_schema),
+	};
+	unsigned live = 0;
+	cyaml_config_t cfg = *config;
+	test_data_t td = {
+		.block = (cyaml_data_t **) &copy,
+		.config = &cfg,
+		.schema = &top_schema,
+	};
+	cyaml_err_t err;
+	ttest_ctx_t tc;
+
+	cfg.mem_fn = test_arena_mem_count;
+	cfg.mem_ctx = &live;
+	cfg.flags |= CYAML_CFG_COPY_BLOCK;
+	if (!ttest_start(report, __func__, cyaml_cleanup, &td, &tc)) {
+		return true;
+	}
+
+	err = cyaml_copy(&cfg, &top_schema, &data, 0,
+			(cyaml_data_t **) &copy);
+	if (err != CYAML_ERR_MAPPING_FIELD_MISSING) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	if (copy != NULL) {
+		return ttest_fail(&tc, "Data non-NULL on error");
+	}
+
+	if (live != 0) {
+		return ttest_fail(&tc, "Failed copy leaked allocations");
+	}
+
+	err = cyaml_copy(&cfg, &top_schema_non_ptr, &data, 0,
+			(cyaml_data_t **) &copy);
+	if (err != CYAML_ERR_TOP_LEVEL_NON_PTR) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	return ttest_pass(&tc);
+}
+
+/**
+ * Test freeing an arena with bad parameters.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_arena_free_bad_params(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	cyaml_config_t cfg = *config;
+	test_data_t td = {
+		.config = config,
+	};
+	cyaml_err_t err;
+	ttest_ctx_t tc;
+
+	if (!ttest_start(report, __func__, cyaml_cleanup, &td, &tc)) {
+		return true;
+	}
+
+	err = cyaml_arena_free(NULL, NULL);
+	if (err != CYAML_ERR_BAD_PARAM_NULL_CONFIG) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	cfg.mem_fn = NULL;
+	err = cyaml_arena_free(&cfg, NULL);
+	if (err != CYAML_ERR_BAD_CONFIG_NULL_MEMFN) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	err = cyaml_arena_free(config, NULL);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	return ttest_pass(&tc);
+}
+
+/**
+ * Run the CYAML arena unit tests.
+ *
+ * \param[in]  rc         The ttest report context.
+ * \param[in]  log_level  CYAML log level.
+ * \param[in]  log_fn     CYAML logging function, or NULL.
+ * \return true iff all unit tests pass, otherwise false.
+ */
+bool arena_tests(
+		ttest_report_ctx_t *rc,
+		cyaml_log_t log_level,
+		cyaml_log_fn_t log_fn)
+{
+	bool pass = true;
+	cyaml_config_t config = {
+		.log_fn = log_fn,
+		.mem_fn = cyaml_mem,
+		.log_level = log_level,
+		.flags = CYAML_CFG_DEFAULT,
+	};
+
+	ttest_heading(rc, "Arena tests");
+
+	pass &= test_arena_copy(rc, &config);
+	pass &= test_arena_copy_block(rc, &config);
+	pass &= test_arena_load_error(rc, &config);
+	pass &= test_arena_copy_block_error(rc, &config);
+	pass &= test_arena_load_mapping(rc, &config);
+	pass &= test_arena_load_defaults(rc, &config);
+	pass &= test_arena_free_bad_params(rc, &config);
+	pass &= test_arena_load_top_level_sequence(rc, &config);
+	pass &= test_arena_load_intern(rc, &config);
+	pass &= test_arena_load_intern_no_arena(rc, &config);
+	pass &= test_arena_load_intern_loader(rc, &config);
+
+	return pass;
+}
@@ -0,0 +1,725 @@
+/*
+ * SPDX-License-Identifier: ISC
+ *
+ * Copyright (C) 2026 Michael Drake <tlsa@netsurf-browser.org>
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <assert.h>
+#include <string.h>
+#include <stdio.h>
+
+#include <cyaml/cyaml.h>
+
+#include "ttest.h"
+#include "test.h"
+
+/** Helper macro to count bytes of YAML input data. */
+#define YAML_LEN(_y) (sizeof(_y) - 1)
+
+/** Size of the binary image header, which the image data follows. */
+#define TEST_BINARY_HEADER_SIZE 40
+
+/** Number of nodes in the deep test list. */
+#define TEST_BINARY_DEEP_COUNT 200000
+
+/**
+ * Unit test context data.
+ */
+typedef struct test_data {
+	cyaml_data_t **data;
+	unsigned *seq_count;
+	cyaml_data_t **image_data;
+	uint8_t **image;
+	char **buffer;
+	char **buffer2;
+	const struct cyaml_config *config;
+	const struct cyaml_schema_value *schema;
+} test_data_t;
+
+/**
+ * Common clean up function to free data used by tests.
+ *
+ * \param[in]  data  The unit test context data.
+ */
+static void cyaml_cleanup(void *data)
+{
+	struct test_data *td = data;
+	unsigned seq_count = 0;
+
+	if (td->seq_count != NULL) {
+		seq_count = *(td->seq_count);
+	}
+
+	if (td->data != NULL) {
+		cyaml_free(td->config, td->schema, *(td->data), seq_count);
+	}
+
+	if (td->image_data != NULL) {
+		cyaml_arena_free(td->config, *(td->image_data));
+	}
+
+	if (td->image != NULL) {
+		td->config->mem_fn(td->config->mem_ctx, *(td->image), 0);
+	}
+
+	if (td->buffer != NULL) {
+		td->config->mem_fn(td->config->mem_ctx, *(td->buffer), 0);
+	}
+
+	if (td->buffer2 != NULL) {
+		td->config->mem_fn(td->config->mem_ctx, *(td->buffer2), 0);
+	}
+}
+
+/** Test document item structure. */
+struct test_binary_item {
+	char *label;
+	unsigned size;
+	int point[2];
+};
+
+/** Test document structure. */
+struct test_binary_doc {
+	char *name;
+	char *note;
+	int *level;
+	struct test_binary_item *items;
+	unsigned items_count;
+	char *tags[3];
+	int count;
+};
+
+/** Test document item point entry schema. */
+static const struct cyaml_schema_value test_binary_point_schema = {
+	CYAML_VALUE_INT(CYAML_FLAG_DEFAULT, int),
+};
+
+/** Test document item mapping fields. */
+static const struct cyaml_schema_field test_binary_item_fields[] = {
+	CYAML_FIELD_STRING_PTR("label", CYAML_FLAG_POINTER,
+			struct test_binary_item, label, 0, CYAML_UNLIMITED),
+	CYAML_FIELD_UINT("size", CYAML_FLAG_DEFAULT,
+			struct test_binary_item, size),
+	CYAML_FIELD_SEQUENCE_FIXED("point", CYAML_FLAG_DEFAULT,
+			struct test_binary_item, point,
+			&test_binary_point_schema, 2),
+	CYAML_FIELD_END
+};
+
+/** Test document item schema. */
+static const struct cyaml_schema_value test_binary_item_schema = {
+	CYAML_VALUE_MAPPING(CYAML_FLAG_DEFAULT,
+			struct test_binary_item, test_binary_item_fields),
+};
+
+/** Test document tag schema. */
+static const struct cyaml_schema_value test_binary_tag_schema = {
+	CYAML_VALUE_STRING(CYAML_FLAG_POINTER, char, 0, CYAML_UNLIMITED),
+};
+
+/** Test document mapping fields. */
+static const struct cyaml_schema_field test_binary_fields[] = {
+	CYAML_FIELD_STRING_PTR("name", CYAML_FLAG_POINTER,
+			struct test_binary_doc, name, 0, CYAML_UNLIMITED),
+	CYAML_FIELD_STRING_PTR("note",
+			CYAML_FLAG_POINTER | CYAML_FLAG_OPTIONAL,
+			struct test_binary_doc, note, 0, CYAML_UNLIMITED),
+	CYAML_FIELD_INT_PTR("level", CYAML_FLAG_POINTER,
+			struct test_binary_doc, level),
+	CYAML_FIELD_SEQUENCE("items", CYAML_FLAG_POINTER,
+			struct test_binary_doc, items,
+			&test_binary_item_schema, 0, CYAML_UNLIMITED),
+	CYAML_FIELD_SEQUENCE_FIXED("tags", CYAML_FLAG_DEFAULT,
+			struct test_binary_doc, tags,
+			&test_binary_tag_schema, 3),
+	CYAML_FIELD_INT("count", CYAML_FLAG_DEFAULT,
+			struct test_binary_doc, count),
+	CYAML_FIELD_END
+};
+
+/** Test document schema. */
+static const struct cyaml_schema_value test_binary_schema = {
+	CYAML_VALUE_MAPPING(CYAML_FLAG_POINTER,
+			struct test_binary_doc, test_binary_fields),
+};
+
+/** Test document. */
+static const unsigned char test_binary_yaml[] =
+	"name: Fish\n"
+	"level: -3\n"
+	"items:\n"
+	"- label: first\n"
+	"  size: 1\n"
+	"  point: [1, 2]\n"
+	"- label: second one\n"
+	"  size: 2\n"
+	"  point: [3, 4]\n"
+	"- label: \"\"\n"
+	"  size: 3\n"
+	"  point: [5, 6]\n"
+	"tags: [red, green, blue]\n"
+	"count: 9\n";
+
+/**
+ * Check that two documents save to the same YAML.
+ *
+ * \param[in]  td         The test context data.
+ * \param[in]  tc         The test case.
+ * \param[in]  data       The first document.
+ * \param[in]  data2      The second document.
+ * \param[in]  seq_count  Top level sequence entry count.
+ * \return true if the documents match, false otherwise.
+ */
+static bool test_binary_match(
+		test_data_t *td,
+		const ttest_ctx_t *tc,
+		const cyaml_data_t *data,
+		const cyaml_data_t *data2,
+		unsigned seq_count)
+{
+	size_t len;
+	size_t len2;
+	cyaml_err_t err;
+
+	err = cyaml_save_data(td->buffer, &len, td->config, td->schema,
+			data, seq_count);
+	if (err != CYAML_OK) {
+		return ttest_fail(tc, cyaml_strerror(err));
+	}
+
+	err = cyaml_save_data(td->buffer2, &len2, td->config, td->schema,
+			data2, seq_count);
+	if (err != CYAML_OK) {
+		return ttest_fail(tc, cyaml_strerror(err));
+	}
+
+	if (len != len2 || memcmp(*(td->buffer), *(td->buffer2), len) != 0) {
+		return ttest_fail(tc, "Documents differ");
+	}
+
+	return true;
+}
+
+/**
+ * Test saving and loading a binary image.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_binary_round_trip(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	struct test_binary_doc *data = NULL;
+	struct test_binary_doc *loaded = NULL;
+	uint8_t *image = NULL;
+	char *buffer = NULL;
+	char *buffer2 = NULL;
+	size_t len;
+	test_data_t td = {
+		.data = (cyaml_data_t **) &data,
+		.image_data = (cyaml_data_t **) &loaded,
+		.image = &image,
+		.buffer = &buffer,
+		.buffer2 = &buffer2,
+		.config = config,
+		.schema = &test_binary_schema,
+	};
+	cyaml_err_t err;
+	ttest_ctx_t tc;
+
+	if (!ttest_start(report, __func__, cyaml_cleanup, &td, &tc)) {
+		return true;
+	}
+
+	err = cyaml_load_data(test_binary_yaml, YAML_LEN(test_binary_yaml),
+			config, &test_binary_schema, (cyaml_data_t **) &data,
+			NULL);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	err = cyaml_save_binary(&image, &len, config, &test_binary_schema,
+			data, 0);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	err = cyaml_load_binary(image, len, config, &test_binary_schema,
+			(cyaml_data_t **) &loaded, NULL);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	if (loaded->note != NULL) {
+		return ttest_fail(&tc, "Absent optional value not NULL");
+	}
+	if (strcmp(loaded->items[1].label, "second one") != 0 ||
+	    loaded->items[2].point[1] != 6 ||
+	    strcmp(loaded->tags[2], "blue") != 0 ||
+	    *loaded->level != -3) {
+		return ttest_fail(&tc, "Bad loaded data");
+	}
+
+	if (!test_binary_match(&td, &tc, data, loaded, 0)) {
+		return false;
+	}
+
+	return ttest_pass(&tc);
+}
+
+/**
+ * Test saving and loading a binary image with a top level sequence.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_binary_sequence(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	static const unsigned char yaml[] =
+		"- label: a\n"
+		"  size: 1\n"
+		"  point: [1, 2]\n"
+		"- label: b\n"
+		"  size: 2\n"
+		"  point: [3, 4]\n";
+	static const struct cyaml_schema_value schema = {
+		CYAML_VALUE_SEQUENCE(CYAML_FLAG_POINTER,
+				struct test_binary_item,
+				&test_binary_item_schema, 0, CYAML_UNLIMITED),
+	};
+	struct test_binary_item *data = NULL;
+	struct test_binary_item *loaded = NULL;
+	unsigned seq_count = 0;
+	unsigned loaded_count = 0;
+	uint8_t *image = NULL;
+	char *buffer = NULL;
+	char *buffer2 = NULL;
+	size_t len;
+	test_data_t td = {
+		.data = (cyaml_data_t **) &data,
+		.seq_count = &seq_count,
+		.image_data = (cyaml_data_t **) &loaded,
+		.image = &image,
+		.buffer = &buffer,
+		.buffer2 = &buffer2,
+		.config = config,
+		.schema = &schema,
+	};
+	cyaml_err_t err;
+	ttest_ctx_t tc;
+
+	if (!ttest_start(report, __func__, cyaml_cleanup, &td, &tc)) {
+		return true;
+	}
+
+	err = cyaml_load_data(yaml, YAML_LEN(yaml), config, &schema,
+			(cyaml_data_t **) &data, &seq_count);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	err = cyaml_save_binary(&image, &len, config, &schema,
+			data, seq_count);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	err = cyaml_load_binary(image, len, config, &schema,
+			(cyaml_data_t **) &loaded, &loaded_count);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	if (loaded_count != seq_count) {
+		return ttest_fail(&tc, "Bad sequence entry count");
+	}
+
+	if (!test_binary_match(&td, &tc, data, loaded, seq_count)) {
+		return false;
+	}
+
+	return ttest_pass(&tc);
+}
+
+/** A node in the deep test list. */
+struct test_binary_node {
+	int value;
+	struct test_binary_node *next;
+};
+
+/** Deep test list node fields. */
+static const struct cyaml_schema_field test_binary_node_fields[] = {
+	CYAML_FIELD_INT("value", CYAML_FLAG_DEFAULT,
+			struct test_binary_node, value),
+	CYAML_FIELD_MAPPING_PTR("next",
+			CYAML_FLAG_POINTER | CYAML_FLAG_OPTIONAL,
+			struct test_binary_node, next, test_binary_node_fields),
+	CYAML_FIELD_END
+};
+
+/** Deep test list node schema. */
+static const struct cyaml_schema_value test_binary_node_schema = {
+	CYAML_VALUE_MAPPING(CYAML_FLAG_POINTER,
+			struct test_binary_node, test_binary_node_fields),
+};
+
+/**
+ * Test loading a binary image of a very deep document.
+ *
+ * The image is built by hand from the header of a saved single node list,
+ * since saving a deep list would copy it first.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_binary_deep(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	size_t stride = (sizeof(struct test_binary_node) +
+			_Alignof(max_align_t) - 1) &
+			~(_Alignof(max_align_t) - 1);
+	struct test_binary_node single = { .value = 0 };
+	const struct test_binary_node *node;
+	struct test_binary_node *loaded = NULL;
+	cyaml_config_t cfg = *config;
+	uint8_t *image = NULL;
+	uint8_t *deep = NULL;
+	uint64_t size;
+	size_t len;
+	test_data_t td = {
+		.image_data = (cyaml_data_t **) &loaded,
+		.image = &image,
+		.buffer = (char **) &deep,
+		.config = &cfg,
+		.schema = &test_binary_node_schema,
+	};
+	cyaml_err_t err;
+	ttest_ctx_t tc;
+
+	/* Logging every node of the list would take a long time. */
+	cfg.log_fn = NULL;
+
+	if (!ttest_start(report, __func__, cyaml_cleanup, &td, &tc)) {
+		return true;
+	}
+
+	err = cyaml_save_binary(&image, &len, &cfg,
+			&test_binary_node_schema, &single, 0);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	size = stride * TEST_BINARY_DEEP_COUNT;
+	deep = cfg.mem_fn(cfg.mem_ctx, NULL, TEST_BINARY_HEADER_SIZE + size);
+	if (deep == NULL) {
+		return ttest_fail(&tc, "Failed to allocate image");
+	}
+	memset(deep, 0, TEST_BINARY_HEADER_SIZE + size);
+	memcpy(deep, image, TEST_BINARY_HEADER_SIZE);
+	memcpy(deep + TEST_BINARY_HEADER_SIZE - sizeof(size),
+			&size, sizeof(size));
+
+	/* Each node's next pointer is the next node's offset, plus one. */
+	for (unsigned i = 0; i < TEST_BINARY_DEEP_COUNT; i++) {
+		struct test_binary_node entry = { .value = (int)i };
+		uintptr_t next = 0;
+
+		if (i + 1 < TEST_BINARY_DEEP_COUNT) {
+			next = (i + 1) * stride + 1;
+		}
+		memcpy(&entry.next, &next, sizeof(next));
+		memcpy(deep + TEST_BINARY_HEADER_SIZE + i * stride,
+				&entry, sizeof(entry));
+	}
+
+	err = cyaml_load_binary(deep, TEST_BINARY_HEADER_SIZE + size, &cfg,
+			&test_binary_node_schema,
+			(cyaml_data_t **) &loaded, NULL);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	node = loaded;
+	for (unsigned i = 0; i < TEST_BINARY_DEEP_COUNT; i++) {
+		if (node == NULL || node->value != (int)i) {
+			return ttest_fail(&tc, "Bad node %u", i);
+		}
+		node = node->next;
+	}
+	if (node != NULL) {
+		return ttest_fail(&tc, "List too long");
+	}
+
+	return ttest_pass(&tc);
+}
+
+/**
+ * Test loading a binary image with a different schema.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_binary_err_schema(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	static const struct cyaml_schema_field fields[] = {
+		CYAML_FIELD_STRING_PTR("name", CYAML_FLAG_POINTER,
+				struct test_binary_doc, name,
+				0, CYAML_UNLIMITED),
+		CYAML_FIELD_INT("count", CYAML_FLAG_DEFAULT,
+				struct test_binary_doc, count),
+		CYAML_FIELD_END
+	};
+	static const struct cyaml_schema_value schema = {
+		CYAML_VALUE_MAPPING(CYAML_FLAG_POINTER,
+				struct test_binary_doc, fields),
+	};
+	struct test_binary_doc *data = NULL;
+	struct test_binary_doc *loaded = NULL;
+	uint8_t *image = NULL;
+	size_t len;
+	test_data_t td = {
+		.data = (cyaml_data_t **) &data,
+		.image_data = (cyaml_data_t **) &loaded,
+		.image = &image,
+		.config = config,
+		.schema = &test_binary_schema,
+	};
+	cyaml_err_t err;
+	ttest_ctx_t tc;
+
+	if (!ttest_start(report, __func__, cyaml_cleanup, &td, &tc)) {
+		return true;
+	}
+
+	err = cyaml_load_data(test_binary_yaml, YAML_LEN(test_binary_yaml),
+			config, &test_binary_schema, (cyaml_data_t **) &data,
+			NULL);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	err = cyaml_save_binary(&image, &len, config, &test_binary_schema,
+			data, 0);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	err = cyaml_load_binary(image, len, config, &schema,
+			(cyaml_data_t **) &loaded, NULL);
+	if (err != CYAML_ERR_BINARY_SCHEMA) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	return ttest_pass(&tc);
+}
+
+/**
+ * Test loading truncated and corrupt binary images.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_binary_err_corrupt(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	struct test_binary_doc *data = NULL;
+	struct test_binary_doc *loaded = NULL;
+	uint8_t *image = NULL;
+	char *name;
+	size_t len;
+	test_data_t td = {
+		.data = (cyaml_data_t **) &data,
+		.image_data = (cyaml_data_t **) &loaded,
+		.image = &image,
+		.config = config,
+		.schema = &test_binary_schema,
+	};
+	cyaml_err_t err;
+	ttest_ctx_t tc;
+
+	if (!ttest_start(report, __func__, cyaml_cleanup, &td, &tc)) {
+		return true;
+	}
+
+	err = cyaml_load_data(test_binary_yaml, YAML_LEN(test_binary_yaml),
+			config, &test_binary_schema, (cyaml_data_t **) &data,
+			NULL);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	err = cyaml_save_binary(&image, &len, config, &test_binary_schema,
+			data, 0);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	err = cyaml_load_binary(image, TEST_BINARY_HEADER_SIZE - 1, config,
+			&test_binary_schema, (cyaml_data_t **) &loaded, NULL);
+	if (err != CYAML_ERR_BINARY_INVALID) {
+		return ttest_fail(&tc, "Short header: %s",
+				cyaml_strerror(err));
+	}
+
+	err = cyaml_load_binary(image, len - 1, config,
+			&test_binary_schema, (cyaml_data_t **) &loaded, NULL);
+	if (err != CYAML_ERR_BINARY_INVALID) {
+		return ttest_fail(&tc, "Truncated: %s", cyaml_strerror(err));
+	}
+
+	/* Point the document's name beyond the end of the image. */
+	memcpy(&name, image + TEST_BINARY_HEADER_SIZE, sizeof(name));
+	memset(image + TEST_BINARY_HEADER_SIZE, 0x7f, sizeof(name));
+
+	err = cyaml_load_binary(image, len, config,
+			&test_binary_schema, (cyaml_data_t **) &loaded, NULL);
+	if (err != CYAML_ERR_BINARY_INVALID) {
+		return ttest_fail(&tc, "Bad offset: %s", cyaml_strerror(err));
+	}
+
+	memcpy(image + TEST_BINARY_HEADER_SIZE, &name, sizeof(name));
+	image[0] = 'X';
+
+	err = cyaml_load_binary(image, len, config,
+			&test_binary_schema, (cyaml_data_t **) &loaded, NULL);
+	if (err != CYAML_ERR_BINARY_INVALID) {
+		return ttest_fail(&tc, "Bad magic: %s", cyaml_strerror(err));
+	}
+
+	return ttest_pass(&tc);
+}
+
+/**
+ * Test saving a binary image with a lazy value in the schema.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_binary_err_lazy(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	struct target_struct {
+		cyaml_lazy_t item;
+	} data = { .item = { .input = NULL } };
+	static const struct cyaml_schema_field fields[] = {
+		CYAML_FIELD_MAPPING_LAZY("item", CYAML_FLAG_OPTIONAL,
+				struct target_struct, item,
+				struct test_binary_item,
+				test_binary_item_fields),
+		CYAML_FIELD_END
+	};
+	static const struct cyaml_schema_value schema = {
+		CYAML_VALUE_MAPPING(CYAML_FLAG_POINTER,
+				struct target_struct, fields),
+	};
+	uint8_t *image = NULL;
+	size_t len;
+	test_data_t td = {
+		.image = &image,
+		.config = config,
+		.schema = &schema,
+	};
+	cyaml_err_t err;
+	ttest_ctx_t tc;
+
+	if (!ttest_start(report, __func__, cyaml_cleanup, &td, &tc)) {
+		return true;
+	}
+
+	err = cyaml_save_binary(&image, &len, config, &schema, &data, 0);
+	if (err != CYAML_ERR_LAZY_NO_INPUT) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	return ttest_pass(&tc);
+}
+
+/**
+ * Test saving a binary image with a non-pointer top level value.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_binary_err_top_level_non_ptr(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	static const struct cyaml_schema_value schema = {
+		CYAML_VALUE_INT(CYAML_FLAG_DEFAULT, int),
+	};
+	uint8_t *image = NULL;
+	int data = 1;
+	size_t len;
+	test_data_t td = {
+		.image = &image,
+		.config = config,
+		.schema = &schema,
+	};
+	cyaml_err_t err;
+	ttest_ctx_t tc;
+
+	if (!ttest_start(report, __func__, cyaml_cleanup, &td, &tc)) {
+		return true;
+	}
+
+	err = cyaml_save_binary(&image, &len, config, &schema, &data, 0);
+	if (err != CYAML_ERR_TOP_LEVEL_NON_PTR) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	return ttest_pass(&tc);
+}
+
+/**
+ * Run the CYAML binary image unit tests.
+ *
+ * \param[in]  rc         The ttest report context.
+ * \param[in]  log_level  CYAML log level.
+ * \param[in]  log_fn     CYAML logging function, or NULL.
+ * \return true iff all unit tests pass, otherwise false.
+ */
+bool binary_tests(
+		ttest_report_ctx_t *rc,
+		cyaml_log_t log_level,
+		cyaml_log_fn_t log_fn)
+{
+	bool pass = true;
+	cyaml_config_t config = {
+		.log_fn = log_fn,
+		.mem_fn = cyaml_mem,
+		.log_level = log_level,
+		.flags = CYAML_CFG_DEFAULT,
+	};
+
+	ttest_heading(rc, "Binary image tests");
+
+	pass &= test_binary_round_trip(rc, &config);
+	pass &= test_binary_sequence(rc, &config);
+	pass &= test_binary_deep(rc, &config);
+
+	ttest_heading(rc, "Binary image error tests");
+
+	pass &= test_binary_err_schema(rc, &config);
+	pass &= test_binary_err_corrupt(rc, &config);
+	pass &= test_binary_err_lazy(rc, &config);
+	pass &= test_binary_err_top_level_non_ptr(rc, &config);
+
+	return pass;
+}
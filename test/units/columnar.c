@@ -0,0 +1,563 @@
+/*
+ * SPDX-License-Identifier: ISC
+ *
+ * Copyright (C) 2026 Michael Drake <tlsa@netsurf-browser.org>
+ */
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <assert.h>
+#include <string.h>
+#include <stdio.h>
+
+#include <cyaml/cyaml.h>
+
+#include "ttest.h"
+#include "test.h"
+
+/** Macro to squash unused variable compiler warnings. */
+#define UNUSED(_x) ((void)(_x))
+
+/** Number of sequence entries in generated test documents. */
+#define TEST_COLUMNAR_ENTRIES 10
+
+/** Unit test context data. */
+typedef struct test_data {
+	char *yaml;
+	char *saved;
+	cyaml_data_t *columns;
+	cyaml_data_t *entries;
+	cyaml_data_t *copy;
+	unsigned columns_count;
+	unsigned entries_count;
+	const struct cyaml_config *config;
+} test_data_t;
+
+/** Test sequence entry mapping. */
+struct test_columnar_entry {
+	char name[8];
+	uint16_t *vals;
+	unsigned vals_count;
+	int x;
+	char *label;
+	uint8_t level;
+};
+
+/** Test sequence entry vals sequence entry schema. */
+static const struct cyaml_schema_value test_columnar_val_schema = {
+	CYAML_VALUE_UINT(CYAML_FLAG_DEFAULT, uint16_t),
+};
+
+/** Test sequence entry mapping schema. */
+static const struct cyaml_schema_field test_columnar_entry_schema[] = {
+	CYAML_FIELD_STRING("name", CYAML_FLAG_DEFAULT,
+			struct test_columnar_entry, name, 0),
+	CYAML_FIELD_SEQUENCE("vals", CYAML_FLAG_POINTER | CYAML_FLAG_OPTIONAL,
+			struct test_columnar_entry, vals,
+			&test_columnar_val_schema, 0, CYAML_UNLIMITED),
+	CYAML_FIELD_INT("x", CYAML_FLAG_DEFAULT,
+			struct test_columnar_entry, x),
+	CYAML_FIELD_STRING_PTR("label",
+			CYAML_FLAG_POINTER | CYAML_FLAG_OPTIONAL,
+			struct test_columnar_entry, label,
+			0, CYAML_UNLIMITED),
+	CYAML_FIELD(UINT, "level", CYAML_FLAG_OPTIONAL,
+			struct test_columnar_entry, level,
+			{ .missing = 7 }),
+	CYAML_FIELD_END
+};
+
+/** Test sequence entry schema. */
+static const struct cyaml_schema_value test_columnar_entry_value = {
+	CYAML_VALUE_MAPPING(CYAML_FLAG_DEFAULT,
+			struct test_columnar_entry, test_columnar_entry_schema),
+};
+
+/** Test document top level schema, with columnar layout. */
+static const struct cyaml_schema_value test_columnar_schema = {
+	CYAML_VALUE_SEQUENCE(CYAML_FLAG_POINTER | CYAML_FLAG_COLUMNAR,
+			struct test_columnar_entry, &test_columnar_entry_value,
+			0, CYAML_UNLIMITED),
+};
+
+/** Test document top level schema, with array of structures layout. */
+static const struct cyaml_schema_value test_columnar_aos_schema = {
+	CYAML_VALUE_SEQUENCE(CYAML_FLAG_POINTER,
+			struct test_columnar_entry, &test_columnar_entry_value,
+			0, CYAML_UNLIMITED),
+};
+
+/**
+ * Common clean up function to free data loaded by tests.
+ *
+ * \param[in]  data  The unit test context data.
+ */
+static void cyaml_cleanup(void *data)
+{
+	struct test_data *td = data;
+
+	cyaml_free(td->config, &test_columnar_schema,
+			td->columns, td->columns_count);
+	cyaml_free(td->config, &test_columnar_schema,
+			td->copy, td->columns_count);
+	cyaml_free(td->config, &test_columnar_aos_schema,
+			td->entries, td->entries_count);
+	if (td->saved != NULL) {
+		td->config->mem_fn(td->config->mem_ctx, td->saved, 0);
+	}
+	free(td->yaml);
+}
+
+/**
+ * Generate a test document with a top level sequence of mappings.
+ *
+ * Every third entry has a label, and every fourth entry has no level.
+ *
+ * \param[in]  bad  Entry to give an invalid value, or
+ *                  \ref TEST_COLUMNAR_ENTRIES for none.
+ * \return the document, or NULL on failure.
+ */
+static char * test_columnar_yaml(
+		unsigned bad)
+{
+	size_t size = TEST_COLUMNAR_ENTRIES * 128;
+	char *yaml = malloc(size);
+	size_t len = 0;
+
+	if (yaml == NULL) {
+		return NULL;
+	}
+
+	for (unsigned i = 0; i < TEST_COLUMNAR_ENTRIES; i++) {
+		len += (size_t)sprintf(yaml + len, "- name: n%u\n", i);
+		len += (size_t)sprintf(yaml + len, "  vals: [");
+		for (unsigned v = 0; v < i % 4; v++) {
+			len += (size_t)sprintf(yaml + len, "%s%u",
+					v == 0 ? "" : ", ", i * 10 + v);
+		}
+		len += (size_t)sprintf(yaml + len, "]\n");
+		if (i == bad) {
+			len += (size_t)sprintf(yaml + len, "  x: bad\n");
+		} else {
+			len += (size_t)sprintf(yaml + len, "  x: %d\n",
+					-(int)i);
+		}
+		if (i % 3 == 0) {
+			len += (size_t)sprintf(yaml + len,
+					"  label: label %u\n", i);
+		}
+		if (i % 4 != 0) {
+			len += (size_t)sprintf(yaml + len,
+					"  level: %u\n", i);
+		}
+	}
+
+	return yaml;
+}
+
+/**
+ * Check columnar test data has the values from the generated document.
+ *
+ * \param[in]  tc     The test context.
+ * \param[in]  data   The columnar data.
+ * \param[in]  count  The data's entry count.
+ * \return true if the data is correct, false otherwise.
+ */
+static bool test_columnar_check(
+		ttest_ctx_t *tc,
+		const cyaml_data_t *data,
+		unsigned count)
+{
+	const char (*name)[8] = CYAML_COLUMN(data, count,
+			struct test_columnar_entry, name);
+	uint16_t * const *vals = CYAML_COLUMN(data, count,
+			struct test_columnar_entry, vals);
+	const unsigned *vals_count = CYAML_COLUMN(data, count,
+			struct test_columnar_entry, vals_count);
+	const int *x = CYAML_COLUMN(data, count,
+			struct test_columnar_entry, x);
+	char * const *label = CYAML_COLUMN(data, count,
+			struct test_columnar_entry, label);
+	const uint8_t *level = CYAML_COLUMN(data, count,
+			struct test_columnar_entry, level);
+
+	if (count != TEST_COLUMNAR_ENTRIES) {
+		return ttest_fail(tc, "Incorrect entry count: %u", count);
+	}
+
+	for (unsigned i = 0; i < count; i++) {
+		char expect[24];
+
+		sprintf(expect, "n%u", i);
+		if (strcmp(name[i], expect) != 0) {
+			return ttest_fail(tc, "Bad name %u: %s", i, name[i]);
+		}
+		if (x[i] != -(int)i) {
+			return ttest_fail(tc, "Bad x %u: %d", i, x[i]);
+		}
+		if (level[i] != ((i % 4 == 0) ? 7 : i)) {
+			return ttest_fail(tc, "Bad level %u: %u", i, level[i]);
+		}
+		if (vals_count[i] != i % 4) {
+			return ttest_fail(tc, "Bad vals count %u: %u",
+					i, vals_count[i]);
+		}
+		for (unsigned v = 0; v < vals_count[i]; v++) {
+			if (vals[i][v] != i * 10 + v) {
+				return ttest_fail(tc, "Bad val %u[%u]: %u",
+						i, v, vals[i][v]);
+			}
+		}
+		if (i % 3 == 0) {
+			sprintf(expect, "label %u", i);
+			if (label[i] == NULL ||
+			    strcmp(label[i], expect) != 0) {
+				return ttest_fail(tc, "Bad label %u", i);
+			}
+		} else if (label[i] != NULL) {
+			return ttest_fail(tc, "Unexpected label %u", i);
+		}
+	}
+
+	return true;
+}
+
+/**
+ * Test loading a sequence of mappings as columns.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \param[in]  name    Name of the test.
+ * \param[in]  flags   Additional config flags to load with.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_columnar_load_flags(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config,
+		const char *name,
+		cyaml_cfg_flags_t flags)
+{
+	cyaml_config_t cfg = *config;
+	test_data_t td = {
+		.config = &cfg,
+	};
+	cyaml_err_t err;
+	ttest_ctx_t tc;
+
+	if (!ttest_start(report, name, cyaml_cleanup, &td, &tc)) {
+		return true;
+	}
+
+	cfg.flags |= flags;
+
+	td.yaml = test_columnar_yaml(TEST_COLUMNAR_ENTRIES);
+	if (td.yaml == NULL) {
+		return ttest_fail(&tc, "Failed to generate document");
+	}
+
+	err = cyaml_load_data((const uint8_t *)td.yaml, strlen(td.yaml),
+			&cfg, &test_columnar_schema,
+			&td.columns, &td.columns_count);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	if (!test_columnar_check(&tc, td.columns, td.columns_count)) {
+		return false;
+	}
+
+	return ttest_pass(&tc);
+}
+
+/**
+ * Test loading a sequence of mappings as columns.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_columnar_load(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	return test_columnar_load_flags(report, config, __func__,
+			CYAML_CFG_DEFAULT);
+}
+
+/**
+ * Test loading columns with sequence slack packs the columns.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_columnar_load_slack(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	return test_columnar_load_flags(report, config, __func__,
+			CYAML_CFG_SEQUENCE_SLACK);
+}
+
+/**
+ * Test saving columns gives the same document as saving structures.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_columnar_save(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	test_data_t td = {
+		.config = config,
+	};
+	unsigned count;
+	cyaml_err_t err;
+	ttest_ctx_t tc;
+	size_t len;
+
+	if (!ttest_start(report, __func__, cyaml_cleanup, &td, &tc)) {
+		return true;
+	}
+
+	td.yaml = test_columnar_yaml(TEST_COLUMNAR_ENTRIES);
+	if (td.yaml == NULL) {
+		return ttest_fail(&tc, "Failed to generate document");
+	}
+
+	err = cyaml_load_data((const uint8_t *)td.yaml, strlen(td.yaml),
+			config, &test_columnar_schema,
+			&td.columns, &td.columns_count);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	err = cyaml_save_data(&td.saved, &len, config, &test_columnar_schema,
+			td.columns, td.columns_count);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	err = cyaml_load_data((const uint8_t *)td.saved, len,
+			config, &test_columnar_aos_schema,
+			&td.entries, &td.entries_count);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	if (td.entries_count != TEST_COLUMNAR_ENTRIES) {
+		return ttest_fail(&tc, "Incorrect entry count: %u",
+				td.entries_count);
+	}
+
+	for (unsigned i = 0; i < td.entries_count; i++) {
+		const struct test_columnar_entry *entry =
+				(const struct test_columnar_entry *)
+				td.entries + i;
+		const int *x = CYAML_COLUMN(td.columns, td.columns_count,
+				struct test_columnar_entry, x);
+
+		if (entry->x != x[i]) {
+			return ttest_fail(&tc, "Bad saved entry %u", i);
+		}
+	}
+
+	/* Reload the saved document as columns, and check it's the same. */
+	err = cyaml_load_data((const uint8_t *)td.saved, len,
+			config, &test_columnar_schema,
+			&td.copy, &count);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	if (!test_columnar_check(&tc, td.copy, count)) {
+		return false;
+	}
+
+	return ttest_pass(&tc);
+}
+
+/**
+ * Test copying columnar data.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_columnar_copy(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	test_data_t td = {
+		.config = config,
+	};
+	cyaml_err_t err;
+	ttest_ctx_t tc;
+
+	if (!ttest_start(report, __func__, cyaml_cleanup, &td, &tc)) {
+		return true;
+	}
+
+	td.yaml = test_columnar_yaml(TEST_COLUMNAR_ENTRIES);
+	if (td.yaml == NULL) {
+		return ttest_fail(&tc, "Failed to generate document");
+	}
+
+	err = cyaml_load_data((const uint8_t *)td.yaml, strlen(td.yaml),
+			config, &test_columnar_schema,
+			&td.columns, &td.columns_count);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	err = cyaml_copy(config, &test_columnar_schema,
+			td.columns, td.columns_count, &td.copy);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	if (!test_columnar_check(&tc, td.copy, td.columns_count)) {
+		return false;
+	}
+
+	return ttest_pass(&tc);
+}
+
+/**
+ * Test a failed columnar load frees the partially loaded data.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_columnar_load_error(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	test_data_t td = {
+		.config = config,
+	};
+	cyaml_err_t err;
+	ttest_ctx_t tc;
+
+	if (!ttest_start(report, __func__, cyaml_cleanup, &td, &tc)) {
+		return true;
+	}
+
+	/* Fail part way through the entries, with unused capacity. */
+	td.yaml = test_columnar_yaml(TEST_COLUMNAR_ENTRIES - 4);
+	if (td.yaml == NULL) {
+		return ttest_fail(&tc, "Failed to generate document");
+	}
+
+	err = cyaml_load_data((const uint8_t *)td.yaml, strlen(td.yaml),
+			config, &test_columnar_schema,
+			&td.columns, &td.columns_count);
+	if (err != CYAML_ERR_INVALID_VALUE) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	if (td.columns != NULL) {
+		return ttest_fail(&tc, "Data non-NULL on error.");
+	}
+
+	return ttest_pass(&tc);
+}
+
+/**
+ * Test columnar sequences of pointer mappings are rejected.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_columnar_bad_schema(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	static const struct cyaml_schema_value entry_schema = {
+		CYAML_VALUE_MAPPING(CYAML_FLAG_POINTER,
+				struct test_columnar_entry,
+				test_columnar_entry_schema),
+	};
+	static const struct cyaml_schema_value schema = {
+		CYAML_VALUE_SEQUENCE(CYAML_FLAG_POINTER | CYAML_FLAG_COLUMNAR,
+				struct test_columnar_entry *, &entry_schema,
+				0, CYAML_UNLIMITED),
+	};
+	static const unsigned char yaml[] = "- name: n0\n  vals: []\n  x: 0\n";
+	struct test_columnar_entry entry = { .x = 1 };
+	struct test_columnar_entry *entries[] = { &entry };
+	test_data_t td = {
+		.config = config,
+	};
+	cyaml_data_t *data = NULL;
+	unsigned count = 0;
+	cyaml_err_t err;
+	ttest_ctx_t tc;
+	size_t len;
+
+	if (!ttest_start(report, __func__, cyaml_cleanup, &td, &tc)) {
+		return true;
+	}
+
+	err = cyaml_load_data(yaml, strlen((const char *)yaml),
+			config, &schema, &data, &count);
+	if (err != CYAML_ERR_BAD_TYPE_IN_SCHEMA) {
+		cyaml_free(config, &schema, data, count);
+		return ttest_fail(&tc, "Load: %s", cyaml_strerror(err));
+	}
+
+	err = cyaml_save_data(&td.saved, &len, config, &schema,
+			entries, CYAML_ARRAY_LEN(entries));
+	if (err != CYAML_ERR_BAD_TYPE_IN_SCHEMA) {
+		return ttest_fail(&tc, "Save: %s", cyaml_strerror(err));
+	}
+
+	return ttest_pass(&tc);
+}
+
+/**
+ * Run the CYAML columnar sequence unit tests.
+ *
+ * \param[in]  rc         The ttest report context.
+ * \param[in]  log_level  CYAML log level.
+ * \param[in]  log_fn     CYAML logging function, or NULL.
+ * \return true iff all unit tests pass, otherwise false.
+ */
+bool columnar_tests(
+		ttest_report_ctx_t *rc,
+		cyaml_log_t log_level,
+		cyaml_log_fn_t log_fn)
+{
+	bool pass = true;
+	cyaml_config_t config = {
+		.log_fn = log_fn,
+		.mem_fn = cyaml_mem,
+		.log_level = log_level,
+		.flags = CYAML_CFG_DEFAULT,
+	};
+
+	ttest_heading(rc, "Columnar sequence tests");
+
+	pass &= test_columnar_load(rc, &config);
+	pass &= test_columnar_load_slack(rc, &config);
+	pass &= test_columnar_save(rc, &config);
+	pass &= test_columnar_copy(rc, &config);
+
+	/* Since we expect error logging for these tests,
+	 * suppress log output if required log level is greater
+	 * than \ref CYAML_LOG_INFO.
+	 */
+	if (log_level > CYAML_LOG_INFO) {
+		config.log_fn = NULL;
+	}
+
+	pass &= test_columnar_load_error(rc, &config);
+	pass &= test_columnar_bad_schema(rc, &config);
+
+	return pass;
+}
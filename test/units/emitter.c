@@ -0,0 +1,747 @@
+/*
+ * SPDX-License-Identifier: ISC
+ *
+ * Copyright (C) 2026 Michael Drake <tlsa@netsurf-browser.org>
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdarg.h>
+#include <assert.h>
+#include <string.h>
+#include <stdio.h>
+
+#include <cyaml/cyaml.h>
+
+#include "ttest.h"
+#include "test.h"
+
+/** Macro to squash unused variable compiler warnings. */
+#define UNUSED(_x) ((void)(_x))
+
+/** Helper macro to count bytes of YAML input data. */
+#define YAML_LEN(_y) (sizeof(_y) - 1)
+
+/** Helper macro to get the number of entries in an array. */
+#define ARRAY_LEN(_a) (sizeof(_a) / sizeof(*(_a)))
+
+#ifndef CYAML_LOG_MIN_LEVEL
+#define CYAML_LOG_MIN_LEVEL CYAML_LOG_DEBUG
+#endif
+
+/**
+ * Whether falling back to libyaml can be seen, from the library's debug
+ * logging.
+ *
+ * Checks of which emitter was used are skipped when debug logging is
+ * compiled out of the library.
+ */
+#define TEST_EMITTER_LOGGED (CYAML_LOG_MIN_LEVEL <= CYAML_LOG_DEBUG)
+
+/**
+ * Unit test context data.
+ */
+typedef struct test_data {
+	char **buffer;
+	char **other;
+	cyaml_data_t **data;
+	const struct cyaml_config *config;
+	const struct cyaml_schema_value *schema;
+	cyaml_saver_t *saver;
+	bool fallback;
+} test_data_t;
+
+/**
+ * Common clean up function to free data allocated by tests.
+ *
+ * \param[in]  data  The unit test context data.
+ */
+static void cyaml_cleanup(void *data)
+{
+	struct test_data *td = data;
+
+	if (td->buffer != NULL) {
+		td->config->mem_fn(td->config->mem_ctx, *(td->buffer), 0);
+	}
+
+	if (td->other != NULL) {
+		td->config->mem_fn(td->config->mem_ctx, *(td->other), 0);
+	}
+
+	if (td->data != NULL) {
+		cyaml_free(td->config, td->schema, *(td->data), 0);
+	}
+
+	cyaml_saver_free(td->saver);
+}
+
+/**
+ * Log function that notes whether a save fell back to libyaml.
+ *
+ * \param[in]  level  Log level of message.
+ * \param[in]  ctx    The unit test context data.
+ * \param[in]  fmt    Format string for message.
+ * \param[in]  args   Format string arguments.
+ */
+static void test_emitter_log(
+		cyaml_log_t level,
+		void *ctx,
+		const char *fmt,
+		va_list args)
+{
+	struct test_data *td = ctx;
+
+	UNUSED(level);
+	UNUSED(args);
+
+	if (strstr(fmt, "Native emitter") != NULL) {
+		td->fallback = true;
+	}
+}
+
+/** Test document point structure. */
+struct test_emitter_point {
+	int x;
+	int y;
+};
+
+/** Test document enumeration. */
+enum test_emitter_colour {
+	TEST_EMITTER_RED,
+	TEST_EMITTER_GREEN,
+	TEST_EMITTER_BLUE,
+};
+
+/** Test document structure. */
+struct test_emitter_doc {
+	const char *name;
+	const char *indicators;
+	const char *empty;
+	const char *single;
+	const char *dbl;
+	const char *sentence;
+	int count;
+	bool enabled;
+	double ratio;
+	enum test_emitter_colour colour;
+	unsigned flags;
+	unsigned bits;
+	int *none;
+	struct test_emitter_point origin;
+	int *values;
+	unsigned values_count;
+	int *nothing;
+	unsigned nothing_count;
+	const char **tags;
+	unsigned tags_count;
+	struct test_emitter_point *points;
+	unsigned points_count;
+};
+
+/** Test document colour names. */
+static const cyaml_strval_t test_emitter_colours[] = {
+	{ "red",   TEST_EMITTER_RED },
+	{ "green", TEST_EMITTER_GREEN },
+	{ "blue",  TEST_EMITTER_BLUE },
+};
+
+/** Test document flag names. */
+static const cyaml_strval_t test_emitter_flags[] = {
+	{ "first",  1 << 0 },
+	{ "second", 1 << 1 },
+	{ "third",  1 << 2 },
+};
+
+/** Test document bitfield definitions. */
+static const cyaml_bitdef_t test_emitter_bitdefs[] = {
+	{ .name = "low",  .offset = 0, .bits = 4 },
+	{ .name = "high", .offset = 4, .bits = 4 },
+};
+
+/** Test document point mapping fields. */
+static const struct cyaml_schema_field test_emitter_point_fields[] = {
+	CYAML_FIELD_INT("x", CYAML_FLAG_DEFAULT,
+			struct test_emitter_point, x),
+	CYAML_FIELD_INT("y", CYAML_FLAG_DEFAULT,
+			struct test_emitter_point, y),
+	CYAML_FIELD_END
+};
+
+/** Test document point schema. */
+static const struct cyaml_schema_value test_emitter_point_schema = {
+	CYAML_VALUE_MAPPING(CYAML_FLAG_DEFAULT,
+			struct test_emitter_point, test_emitter_point_fields),
+};
+
+/** Test document value schema. */
+static const struct cyaml_schema_value test_emitter_value_schema = {
+	CYAML_VALUE_INT(CYAML_FLAG_DEFAULT, int),
+};
+
+/** Test document tag schema. */
+static const struct cyaml_schema_value test_emitter_tag_schema = {
+	CYAML_VALUE_STRING(CYAML_FLAG_POINTER, char, 0, CYAML_UNLIMITED),
+};
+
+/** Test document mapping fields. */
+static const struct cyaml_schema_field test_emitter_fields[] = {
+	CYAML_FIELD_STRING_PTR("name", CYAML_FLAG_POINTER,
+			struct test_emitter_doc, name, 0, CYAML_UNLIMITED),
+	CYAML_FIELD_STRING_PTR("indicators", CYAML_FLAG_POINTER,
+			struct test_emitter_doc, indicators,
+			0, CYAML_UNLIMITED),
+	CYAML_FIELD_STRING_PTR("empty", CYAML_FLAG_POINTER,
+			struct test_emitter_doc, empty, 0, CYAML_UNLIMITED),
+	CYAML_FIELD_STRING_PTR("single",
+			CYAML_FLAG_POINTER | CYAML_FLAG_SCALAR_QUOTE_SINGLE,
+			struct test_emitter_doc, single, 0, CYAML_UNLIMITED),
+	CYAML_FIELD_STRING_PTR("double",
+			CYAML_FLAG_POINTER | CYAML_FLAG_SCALAR_QUOTE_DOUBLE,
+			struct test_emitter_doc, dbl, 0, CYAML_UNLIMITED),
+	CYAML_FIELD_STRING_PTR("sentence", CYAML_FLAG_POINTER,
+			struct test_emitter_doc, sentence, 0, CYAML_UNLIMITED),
+	CYAML_FIELD_INT("count", CYAML_FLAG_DEFAULT,
+			struct test_emitter_doc, count),
+	CYAML_FIELD_BOOL("enabled", CYAML_FLAG_DEFAULT,
+			struct test_emitter_doc, enabled),
+	CYAML_FIELD_FLOAT("ratio", CYAML_FLAG_DEFAULT,
+			struct test_emitter_doc, ratio),
+	CYAML_FIELD_ENUM("colour", CYAML_FLAG_DEFAULT,
+			struct test_emitter_doc, colour, test_emitter_colours,
+			ARRAY_LEN(test_emitter_colours)),
+	CYAML_FIELD_FLAGS("flags", CYAML_FLAG_DEFAULT,
+			struct test_emitter_doc, flags, test_emitter_flags,
+			ARRAY_LEN(test_emitter_flags)),
+	CYAML_FIELD_BITFIELD("bits", CYAML_FLAG_FLOW,
+			struct test_emitter_doc, bits, test_emitter_bitdefs,
+			ARRAY_LEN(test_emitter_bitdefs)),
+	CYAML_FIELD_INT_PTR("none", CYAML_FLAG_POINTER_NULL,
+			struct test_emitter_doc, none),
+	CYAML_FIELD_MAPPING("origin", CYAML_FLAG_FLOW,
+			struct test_emitter_doc, origin,
+			test_emitter_point_fields),
+	CYAML_FIELD_SEQUENCE("values", CYAML_FLAG_POINTER | CYAML_FLAG_FLOW,
+			struct test_emitter_doc, values,
+			&test_emitter_value_schema, 0, CYAML_UNLIMITED),
+	CYAML_FIELD_SEQUENCE("nothing", CYAML_FLAG_POINTER,
+			struct test_emitter_doc, nothing,
+			&test_emitter_value_schema, 0, CYAML_UNLIMITED),
+	CYAML_FIELD_SEQUENCE("tags", CYAML_FLAG_POINTER,
+			struct test_emitter_doc, tags,
+			&test_emitter_tag_schema, 0, CYAML_UNLIMITED),
+	CYAML_FIELD_SEQUENCE("points", CYAML_FLAG_POINTER,
+			struct test_emitter_doc, points,
+			&test_emitter_point_schema, 0, CYAML_UNLIMITED),
+	CYAML_FIELD_END
+};
+
+/** Test document schema. */
+static const struct cyaml_schema_value test_emitter_schema = {
+	CYAML_VALUE_MAPPING(CYAML_FLAG_POINTER,
+			struct test_emitter_doc, test_emitter_fields),
+};
+
+/** Test document sequence values. */
+static int test_emitter_values[] = { 1, -2, 3 };
+
+/** Test document sequence tags. */
+static const char *test_emitter_tags[] = {
+	"plain",
+	"- dash",
+	"key: value",
+	"it's",
+	"",
+	"123",
+};
+
+/** Test document sequence points. */
+static struct test_emitter_point test_emitter_points[] = {
+	{ .x = 3, .y = 4 },
+	{ .x = 5, .y = 6 },
+};
+
+/** Test document the native emitter can write. */
+static const struct test_emitter_doc test_emitter_doc = {
+	.name = "plain value",
+	.indicators = "# not: a comment, [really]",
+	.empty = "",
+	.single = "it's",
+	.dbl = "say \"hi\" \\o/",
+	.sentence = "A sentence that is long enough that libyaml has to "
+			"wrap it over more than one line of output, at the "
+			"space characters.",
+	.count = -12,
+	.enabled = true,
+	.ratio = 0.5,
+	.colour = TEST_EMITTER_BLUE,
+	.flags = (1 << 0) | (1 << 2),
+	.bits = 0x31,
+	.none = NULL,
+	.origin = { .x = 1, .y = 2 },
+	.values = test_emitter_values,
+	.values_count = ARRAY_LEN(test_emitter_values),
+	.nothing = test_emitter_values,
+	.nothing_count = 0,
+	.tags = test_emitter_tags,
+	.tags_count = ARRAY_LEN(test_emitter_tags),
+	.points = test_emitter_points,
+	.points_count = ARRAY_LEN(test_emitter_points),
+};
+
+/**
+ * Save data with libyaml and with the native emitter, and compare them.
+ *
+ * \param[in]  tc      The test context.
+ * \param[in]  td      The unit test context data.
+ * \param[in]  flags   Additional config flags to save with.
+ * \param[in]  schema  The schema for the data to save.
+ * \param[in]  data    The data to save.
+ * \return true if the outputs are identical, false otherwise.
+ */
+static bool test_emitter_compare(
+		ttest_ctx_t *tc,
+		test_data_t *td,
+		cyaml_cfg_flags_t flags,
+		const cyaml_schema_value_t *schema,
+		const cyaml_data_t *data)
+{
+	cyaml_config_t cfg = *td->config;
+	size_t other_len;
+	cyaml_err_t err;
+	size_t len;
+
+	cfg.flags |= flags;
+	err = cyaml_save_data(td->other, &other_len, &cfg, schema, data, 0);
+	if (err != CYAML_OK) {
+		return ttest_fail(tc, cyaml_strerror(err));
+	}
+
+	cfg.flags |= CYAML_CFG_NATIVE_EMITTER;
+	cfg.log_fn = test_emitter_log;
+	cfg.log_ctx = td;
+	cfg.log_level = CYAML_LOG_DEBUG;
+	err = cyaml_save_data(td->buffer, &len, &cfg, schema, data, 0);
+	if (err != CYAML_OK) {
+		return ttest_fail(tc, cyaml_strerror(err));
+	}
+
+	if (len != other_len || memcmp(*td->buffer, *td->other, len) != 0) {
+		return ttest_fail(tc, "Native save differs from libyaml:\n"
+				"EXPECTED (%zu):\n\n%.*s\n\n"
+				"GOT (%zu):\n\n%.*s\n",
+				other_len, (int)other_len, *td->other,
+				len, (int)len, *td->buffer);
+	}
+
+	return true;
+}
+
+/**
+ * Test saving a document with the native emitter.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \param[in]  flags   Additional config flags to save with.
+ * \param[in]  name    Name of the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_emitter_save_with(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config,
+		cyaml_cfg_flags_t flags,
+		const char *name)
+{
+	char *buffer = NULL;
+	char *other = NULL;
+	test_data_t td = {
+		.buffer = &buffer,
+		.other = &other,
+		.config = config,
+	};
+	ttest_ctx_t tc;
+
+	if (!ttest_start(report, name, cyaml_cleanup, &td, &tc)) {
+		return true;
+	}
+
+	if (!test_emitter_compare(&tc, &td, flags,
+			&test_emitter_schema, &test_emitter_doc)) {
+		return false;
+	}
+
+	if (TEST_EMITTER_LOGGED && td.fallback) {
+		return ttest_fail(&tc, "Save fell back to libyaml");
+	}
+
+	return ttest_pass(&tc);
+}
+
+/**
+ * Test saving a document with the native emitter.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_emitter_save(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	return test_emitter_save_with(report, config,
+			CYAML_CFG_DEFAULT, __func__);
+}
+
+/**
+ * Test saving a document with the native emitter, with document delimiters.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_emitter_save_delim(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	return test_emitter_save_with(report, config,
+			CYAML_CFG_DOCUMENT_DELIM, __func__);
+}
+
+/**
+ * Test saving a document with the native emitter, in flow style.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_emitter_save_flow(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	return test_emitter_save_with(report, config,
+			CYAML_CFG_STYLE_FLOW, __func__);
+}
+
+/**
+ * Test saving a document with the native emitter, in block style.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_emitter_save_block(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	return test_emitter_save_with(report, config,
+			CYAML_CFG_STYLE_BLOCK | CYAML_CFG_DOCUMENT_DELIM,
+			__func__);
+}
+
+/**
+ * Test saving a document the native emitter can't write.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_emitter_save_fallback(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	struct test_emitter_doc doc = test_emitter_doc;
+	char *buffer = NULL;
+	char *other = NULL;
+	test_data_t td = {
+		.buffer = &buffer,
+		.other = &other,
+		.config = config,
+	};
+	ttest_ctx_t tc;
+
+	if (!ttest_start(report, __func__, cyaml_cleanup, &td, &tc)) {
+		return true;
+	}
+
+	doc.name = "caf\xc3\xa9\tcr\xc3\xa8me";
+
+	if (!test_emitter_compare(&tc, &td, CYAML_CFG_DEFAULT,
+			&test_emitter_schema, &doc)) {
+		return false;
+	}
+
+	if (TEST_EMITTER_LOGGED && !td.fallback) {
+		return ttest_fail(&tc, "Save didn't fall back to libyaml");
+	}
+
+	return ttest_pass(&tc);
+}
+
+/**
+ * Test saving a document with a top level scalar with the native emitter.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_emitter_save_scalar(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	static const struct cyaml_schema_value schema = {
+		CYAML_VALUE_STRING(CYAML_FLAG_POINTER, char,
+				0, CYAML_UNLIMITED),
+	};
+	char *buffer = NULL;
+	char *other = NULL;
+	test_data_t td = {
+		.buffer = &buffer,
+		.other = &other,
+		.config = config,
+	};
+	ttest_ctx_t tc;
+
+	if (!ttest_start(report, __func__, cyaml_cleanup, &td, &tc)) {
+		return true;
+	}
+
+	if (!test_emitter_compare(&tc, &td, CYAML_CFG_DEFAULT,
+			&schema, "hello")) {
+		return false;
+	}
+
+	return ttest_pass(&tc);
+}
+
+/**
+ * Test saving lazy values with the native emitter.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_emitter_save_lazy(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	struct lazy_doc {
+		cyaml_lazy_t points;
+		cyaml_lazy_t values;
+		int count;
+	};
+	static const struct cyaml_schema_field fields[] = {
+		CYAML_FIELD_SEQUENCE_LAZY("points", CYAML_FLAG_DEFAULT,
+				struct lazy_doc, points,
+				struct test_emitter_point,
+				&test_emitter_point_schema,
+				0, CYAML_UNLIMITED),
+		CYAML_FIELD_SEQUENCE_LAZY("values", CYAML_FLAG_DEFAULT,
+				struct lazy_doc, values, int,
+				&test_emitter_value_schema,
+				0, CYAML_UNLIMITED),
+		CYAML_FIELD_INT("count", CYAML_FLAG_DEFAULT,
+				struct lazy_doc, count),
+		CYAML_FIELD_END
+	};
+	static const struct cyaml_schema_value schema = {
+		CYAML_VALUE_MAPPING(CYAML_FLAG_POINTER,
+				struct lazy_doc, fields),
+	};
+	static const unsigned char yaml[] =
+		"points:\n"
+		"  - {x: 1, 'y': 2}\n"
+		"  - x: 3\n"
+		"    y: \"4\"\n"
+		"values: [ 5, 6 ]\n"
+		"count: 7\n";
+	struct lazy_doc *data_tgt = NULL;
+	char *buffer = NULL;
+	char *other = NULL;
+	test_data_t td = {
+		.buffer = &buffer,
+		.other = &other,
+		.data = (cyaml_data_t **) &data_tgt,
+		.config = config,
+		.schema = &schema,
+	};
+	cyaml_err_t err;
+	ttest_ctx_t tc;
+
+	if (!ttest_start(report, __func__, cyaml_cleanup, &td, &tc)) {
+		return true;
+	}
+
+	err = cyaml_load_data(yaml, YAML_LEN(yaml), config, &schema,
+			(cyaml_data_t **) &data_tgt, NULL);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	if (!test_emitter_compare(&tc, &td, CYAML_CFG_DEFAULT,
+			&schema, data_tgt)) {
+		return false;
+	}
+
+	if (TEST_EMITTER_LOGGED && td.fallback) {
+		return ttest_fail(&tc, "Save fell back to libyaml");
+	}
+
+	return ttest_pass(&tc);
+}
+
+/**
+ * Test saving documents with a saver and the native emitter.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_emitter_saver(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	cyaml_config_t cfg = *config;
+	char *buffer = NULL;
+	char *other = NULL;
+	test_data_t td = {
+		.buffer = &buffer,
+		.other = &other,
+		.config = config,
+	};
+	size_t other_len;
+	cyaml_err_t err;
+	ttest_ctx_t tc;
+	size_t len;
+
+	if (!ttest_start(report, __func__, cyaml_cleanup, &td, &tc)) {
+		return true;
+	}
+
+	err = cyaml_save_data(&other, &other_len, &cfg,
+			&test_emitter_schema, &test_emitter_doc, 0);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	cfg.flags |= CYAML_CFG_NATIVE_EMITTER;
+	err = cyaml_saver_create(&cfg, &td.saver);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	for (unsigned i = 0; i < 2; i++) {
+		config->mem_fn(config->mem_ctx, buffer, 0);
+		buffer = NULL;
+
+		err = cyaml_saver_save_data(td.saver, &buffer, &len,
+				&test_emitter_schema, &test_emitter_doc, 0);
+		if (err != CYAML_OK) {
+			return ttest_fail(&tc, cyaml_strerror(err));
+		}
+
+		if (len != other_len || memcmp(buffer, other, len) != 0) {
+			return ttest_fail(&tc, "Native save differs "
+					"from libyaml");
+		}
+	}
+
+	return ttest_pass(&tc);
+}
+
+/**
+ * Test saving an invalid value with the native emitter.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_emitter_err_save_invalid(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	static const struct cyaml_schema_field fields[] = {
+		CYAML_FIELD_ENUM("colour", CYAML_FLAG_STRICT,
+				struct test_emitter_doc, colour,
+				test_emitter_colours,
+				ARRAY_LEN(test_emitter_colours)),
+		CYAML_FIELD_END
+	};
+	static const struct cyaml_schema_value schema = {
+		CYAML_VALUE_MAPPING(CYAML_FLAG_POINTER,
+				struct test_emitter_doc, fields),
+	};
+	struct test_emitter_doc doc = {
+		.colour = 7,
+	};
+	cyaml_config_t cfg = *config;
+	char *buffer = NULL;
+	test_data_t td = {
+		.buffer = &buffer,
+		.config = config,
+	};
+	cyaml_err_t err;
+	ttest_ctx_t tc;
+	size_t len;
+
+	if (!ttest_start(report, __func__, cyaml_cleanup, &td, &tc)) {
+		return true;
+	}
+
+	cfg.flags |= CYAML_CFG_NATIVE_EMITTER;
+	cfg.log_fn = test_emitter_log;
+	cfg.log_ctx = &td;
+	cfg.log_level = CYAML_LOG_DEBUG;
+
+	err = cyaml_save_data(&buffer, &len, &cfg, &schema, &doc, 0);
+	if (err != CYAML_ERR_INVALID_VALUE) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	if (buffer != NULL) {
+		return ttest_fail(&tc, "Buffer non-NULL on error.");
+	}
+
+	if (TEST_EMITTER_LOGGED && td.fallback) {
+		return ttest_fail(&tc, "Save fell back to libyaml");
+	}
+
+	return ttest_pass(&tc);
+}
+
+/**
+ * Run the CYAML native emitter unit tests.
+ *
+ * \param[in]  rc         The ttest report context.
+ * \param[in]  log_level  CYAML log level.
+ * \param[in]  log_fn     CYAML logging function, or NULL.
+ * \return true iff all unit tests pass, otherwise false.
+ */
+bool emitter_tests(
+		ttest_report_ctx_t *rc,
+		cyaml_log_t log_level,
+		cyaml_log_fn_t log_fn)
+{
+	bool pass = true;
+	cyaml_config_t config = {
+		.log_fn = log_fn,
+		.mem_fn = cyaml_mem,
+		.log_level = log_level,
+		.flags = CYAML_CFG_DEFAULT,
+	};
+
+	ttest_heading(rc, "Native emitter tests");
+
+	pass &= test_emitter_save(rc, &config);
+	pass &= test_emitter_save_delim(rc, &config);
+	pass &= test_emitter_save_flow(rc, &config);
+	pass &= test_emitter_save_block(rc, &config);
+	pass &= test_emitter_save_fallback(rc, &config);
+	pass &= test_emitter_save_scalar(rc, &config);
+	pass &= test_emitter_save_lazy(rc, &config);
+	pass &= test_emitter_saver(rc, &config);
+
+	ttest_heading(rc, "Native emitter error tests");
+
+	pass &= test_emitter_err_save_invalid(rc, &config);
+
+	return pass;
+}
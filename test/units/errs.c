@@ -6651,6 +6651,65 @@ static bool test_err_load_schema_sequence_max_entries(
 	return ttest_pass(&tc);
 }
 
+/**
+ * Test loading when a sequence of numbers has a mapping entry.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_err_load_schema_sequence_int_mapping_entry(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	static const unsigned char yaml[] =
+		"key:\n"
+		"  - 1\n"
+		"  - 2\n"
+		"  - { a: 3 }\n"
+		"  - 4\n";
+	struct target_struct {
+		int *a;
+		unsigned a_count;
+	} *data_tgt = NULL;
+	static const struct cyaml_schema_value entry_schema = {
+		CYAML_VALUE_INT(CYAML_FLAG_DEFAULT, *(data_tgt->a)),
+	};
+	static const struct cyaml_schema_field mapping_schema[] = {
+		CYAML_FIELD_SEQUENCE("key", CYAML_FLAG_POINTER,
+				struct target_struct, a, &entry_schema,
+				0, CYAML_UNLIMITED),
+		CYAML_FIELD_END
+	};
+	static const struct cyaml_schema_value top_schema = {
+		CYAML_VALUE_MAPPING(CYAML_FLAG_POINTER,
+				struct target_struct, mapping_schema),
+	};
+	test_data_t td = {
+		.data = (cyaml_data_t **) &data_tgt,
+		.config = config,
+		.schema = &top_schema,
+	};
+	cyaml_err_t err;
+	ttest_ctx_t tc;
+
+	if (!ttest_start(report, __func__, cyaml_cleanup, &td, &tc)) {
+		return true;
+	}
+
+	err = cyaml_load_data(yaml, YAML_LEN(yaml), config, &top_schema,
+			(cyaml_data_t **) &data_tgt, NULL);
+	if (err != CYAML_ERR_INVALID_VALUE) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	if (data_tgt != NULL) {
+		return ttest_fail(&tc, "Data non-NULL on error.");
+	}
+
+	return ttest_pass(&tc);
+}
+
 /**
  * Test loading when schema expects flags and finds a mapping inside.
  *
@@ -9494,6 +9553,7 @@ bool errs_tests(
 
 	pass &= test_err_load_schema_sequence_min_entries(rc, &config);
 	pass &= test_err_load_schema_sequence_max_entries(rc, &config);
+	pass &= test_err_load_schema_sequence_int_mapping_entry(rc, &config);
 
 	ttest_heading(rc, "YAML / schema mismatch: bad flags/enum strings");
 
@@ -7,6 +7,7 @@
 #include <stdbool.h>
 #include <assert.h>
 #include <stdio.h>
+#include <string.h>
 
 #include <cyaml/cyaml.h>
 
@@ -280,6 +281,137 @@ static bool test_file_load_save_basic(
 	return ttest_pass(&tc);
 }
 
+/**
+ * Test loading the basic YAML file, with the file mapped into memory.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_file_load_basic_mmap(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	struct animal {
+		char *kind;
+		char **sounds;
+		unsigned sounds_count;
+	};
+	struct target_struct {
+		struct animal *animals;
+		unsigned animals_count;
+		char **cakes;
+		unsigned cakes_count;
+	} *data_tgt = NULL;
+	static const struct cyaml_schema_value sounds_entry_schema = {
+		CYAML_VALUE_STRING(CYAML_FLAG_POINTER, char, 0, CYAML_UNLIMITED),
+	};
+	static const struct cyaml_schema_field animal_mapping_schema[] = {
+		CYAML_FIELD_STRING_PTR("kind", CYAML_FLAG_POINTER,
+				struct animal, kind, 0, CYAML_UNLIMITED),
+		CYAML_FIELD_SEQUENCE("sounds", CYAML_FLAG_POINTER,
+				struct animal, sounds,
+				&sounds_entry_schema, 0, CYAML_UNLIMITED),
+		CYAML_FIELD_END
+	};
+	static const struct cyaml_schema_value animals_entry_schema = {
+		CYAML_VALUE_MAPPING(CYAML_FLAG_DEFAULT,
+				struct animal, animal_mapping_schema),
+	};
+	static const struct cyaml_schema_value cakes_entry_schema = {
+		CYAML_VALUE_STRING(CYAML_FLAG_POINTER, char, 0, CYAML_UNLIMITED),
+	};
+	static const struct cyaml_schema_field mapping_schema[] = {
+		CYAML_FIELD_SEQUENCE("animals", CYAML_FLAG_POINTER,
+				struct target_struct, animals,
+				&animals_entry_schema, 0, CYAML_UNLIMITED),
+		CYAML_FIELD_SEQUENCE("cakes", CYAML_FLAG_POINTER,
+				struct target_struct, cakes,
+				&cakes_entry_schema, 0, CYAML_UNLIMITED),
+		CYAML_FIELD_END
+	};
+	static const struct cyaml_schema_value top_schema = {
+		CYAML_VALUE_MAPPING(CYAML_FLAG_POINTER,
+				struct target_struct, mapping_schema),
+	};
+	cyaml_config_t cfg = *config;
+	test_data_t td = {
+		.data = (cyaml_data_t **) &data_tgt,
+		.config = &cfg,
+		.schema = &top_schema,
+	};
+	cyaml_err_t err;
+	ttest_ctx_t tc;
+
+	cfg.flags |= CYAML_CFG_MMAP;
+
+	if (!ttest_start(report, __func__, cyaml_cleanup, &td, &tc)) {
+		return true;
+	}
+
+	err = cyaml_load_file("test/data/basic.yaml", &cfg, &top_schema,
+			(cyaml_data_t **) &data_tgt, NULL);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	if (data_tgt->animals_count != 3 || data_tgt->cakes_count != 5) {
+		return ttest_fail(&tc, "Incorrect sequence entry count");
+	}
+	if (strcmp(data_tgt->animals[1].kind, "hippo") != 0 ||
+	    data_tgt->animals[1].sounds_count != 3 ||
+	    strcmp(data_tgt->cakes[4], "yule log") != 0) {
+		return ttest_fail(&tc, "Incorrect value");
+	}
+
+	return ttest_pass(&tc);
+}
+
+/**
+ * Test loading a non-existent file, with the file mapped into memory.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_file_load_bad_path_mmap(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	struct target_struct {
+		char *cakes;
+	} *data_tgt = NULL;
+	static const struct cyaml_schema_field mapping_schema[] = {
+		CYAML_FIELD_END
+	};
+	static const struct cyaml_schema_value top_schema = {
+		CYAML_VALUE_MAPPING(CYAML_FLAG_POINTER,
+				struct target_struct, mapping_schema),
+	};
+	cyaml_config_t cfg = *config;
+	test_data_t td = {
+		.data = (cyaml_data_t **) &data_tgt,
+		.config = &cfg,
+		.schema = &top_schema,
+	};
+	cyaml_err_t err;
+	ttest_ctx_t tc;
+
+	cfg.flags |= CYAML_CFG_MMAP;
+
+	if (!ttest_start(report, __func__, cyaml_cleanup, &td, &tc)) {
+		return true;
+	}
+
+	err = cyaml_load_file("/cyaml/path/shouldn't/exist.yaml",
+			&cfg, &top_schema, (cyaml_data_t **) &data_tgt, NULL);
+	if (err != CYAML_ERR_FILE_OPEN) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	return ttest_pass(&tc);
+}
+
 /**
  * Test loading the basic YAML file, with a mismatching schema.
  *
@@ -430,6 +562,7 @@ bool file_tests(
 
 	pass &= test_file_load_basic(rc, &config);
 	pass &= test_file_load_save_basic(rc, &config);
+	pass &= test_file_load_basic_mmap(rc, &config);
 
 	/* Since we expect loads of error logging for these tests,
 	 * suppress log output if required log level is greater
@@ -440,6 +573,7 @@ bool file_tests(
 	}
 
 	pass &= test_file_load_bad_path(rc, &config);
+	pass &= test_file_load_bad_path_mmap(rc, &config);
 	pass &= test_file_save_bad_path(rc, &config);
 	pass &= test_file_load_basic_invalid(rc, &config);
 	pass &= test_file_save_basic_invalid(rc, &config);
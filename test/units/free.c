@@ -5,7 +5,9 @@
  */
 
 #include <stdbool.h>
+#include <stdarg.h>
 #include <assert.h>
+#include <string.h>
 #include <stdio.h>
 
 #include <cyaml/cyaml.h>
@@ -16,6 +18,134 @@
 /** Macro to squash unused variable compiler warnings. */
 #define UNUSED(_x) ((void)(_x))
 
+#ifndef CYAML_LOG_MIN_LEVEL
+#define CYAML_LOG_MIN_LEVEL CYAML_LOG_DEBUG
+#endif
+
+/**
+ * Whether walking of freed data can be seen, from the library's debug
+ * logging.
+ */
+#define TEST_FREE_LOGGED (CYAML_LOG_MIN_LEVEL <= CYAML_LOG_DEBUG)
+
+/** Number of nodes in the deep test list. */
+#define TEST_FREE_DEEP_COUNT 200000
+
+/**
+ * Allocation tracking context for free tests.
+ */
+typedef struct test_free_mem {
+	unsigned live;   /**< Number of live allocations. */
+	bool fail;       /**< Whether new allocations should fail. */
+	unsigned keys;   /**< Number of mapping keys logged as freed. */
+} test_free_mem_t;
+
+/**
+ * Allocation counting memory function.
+ *
+ * \param[in] ctx    The \ref test_free_mem_t.
+ * \param[in] ptr    Existing allocation to resize, or NULL.
+ * \param[in] size   The new size for the allocation.
+ * \return the allocation, or NULL.
+ */
+static void * test_free_mem_fn(
+		void *ctx,
+		void *ptr,
+		size_t size)
+{
+	test_free_mem_t *mem = ctx;
+	void *temp;
+
+	if (mem->fail && size != 0) {
+		return NULL;
+	}
+
+	temp = cyaml_mem(NULL, ptr, size);
+	if (ptr == NULL && temp != NULL) {
+		mem->live++;
+	} else if (size == 0 && ptr != NULL) {
+		mem->live--;
+	}
+
+	return temp;
+}
+
+/**
+ * Logging function, which counts mapping keys being freed.
+ *
+ * \param[in]  level  Log level of message to log.
+ * \param[in]  ctx    The \ref test_free_mem_t.
+ * \param[in]  fmt    Format string for message to log.
+ * \param[in]  args   Additional arguments used by fmt.
+ */
+static void test_free_log(
+		cyaml_log_t level,
+		void *ctx,
+		const char *fmt,
+		va_list args)
+{
+	test_free_mem_t *mem = ctx;
+
+	UNUSED(level);
+	UNUSED(args);
+
+	if (strstr(fmt, "Free: Freeing key") != NULL) {
+		mem->keys++;
+	}
+}
+
+/** A node in the deep test list. */
+struct test_free_node {
+	int value;
+	struct test_free_node *next;
+};
+
+static const struct cyaml_schema_value test_free_node_schema;
+
+/** Deep test list node fields. */
+static const struct cyaml_schema_field test_free_node_fields[] = {
+	CYAML_FIELD_INT("value", CYAML_FLAG_DEFAULT,
+			struct test_free_node, value),
+	CYAML_FIELD_MAPPING_PTR("next",
+			CYAML_FLAG_POINTER | CYAML_FLAG_OPTIONAL,
+			struct test_free_node, next, test_free_node_fields),
+	CYAML_FIELD_END
+};
+
+/** Deep test list node schema. */
+static const struct cyaml_schema_value test_free_node_schema = {
+	CYAML_VALUE_MAPPING(CYAML_FLAG_POINTER,
+			struct test_free_node, test_free_node_fields),
+};
+
+/**
+ * Build a deep test list.
+ *
+ * \param[in]  config  The CYAML config to allocate with.
+ * \param[in]  count   Number of nodes in the list.
+ * \return the list, or NULL on failure.
+ */
+static struct test_free_node * test_free_deep_list(
+		const cyaml_config_t *config,
+		unsigned count)
+{
+	struct test_free_node *head = NULL;
+
+	for (unsigned i = 0; i < count; i++) {
+		struct test_free_node *node = config->mem_fn(
+				config->mem_ctx, NULL, sizeof(*node));
+		if (node == NULL) {
+			cyaml_free(config, &test_free_node_schema, head, 0);
+			return NULL;
+		}
+		node->value = (int)i;
+		node->next = head;
+		head = node;
+	}
+
+	return head;
+}
+
 /**
  * Test cyaml_free with NULL data.
  *
@@ -129,6 +259,191 @@ static bool test_free_null_schema(
 	return ttest_pass(&tc);
 }
 
+/**
+ * Test cyaml_free with a very deep document.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_free_deep(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	test_free_mem_t mem = { 0 };
+	cyaml_config_t cfg = *config;
+	struct test_free_node *list;
+	cyaml_err_t err;
+	ttest_ctx_t tc;
+
+	/* Logging every node of the list would take a long time. */
+	cfg.log_fn = NULL;
+	cfg.mem_fn = test_free_mem_fn;
+	cfg.mem_ctx = &mem;
+
+	if (!ttest_start(report, __func__, NULL, NULL, &tc)) return true;
+
+	list = test_free_deep_list(&cfg, TEST_FREE_DEEP_COUNT);
+	if (list == NULL) {
+		return ttest_fail(&tc, "Failed to build list");
+	}
+
+	err = cyaml_free(&cfg, &test_free_node_schema, list, 0);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, "Free failed: %s", cyaml_strerror(err));
+	}
+
+	if (mem.live != 0) {
+		return ttest_fail(&tc, "Leaked %u allocations", mem.live);
+	}
+
+	return ttest_pass(&tc);
+}
+
+/**
+ * Test cyaml_free with a deep document, when allocations fail.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_free_deep_oom(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	test_free_mem_t mem = { 0 };
+	cyaml_config_t cfg = *config;
+	struct test_free_node *list;
+	cyaml_err_t err;
+	ttest_ctx_t tc;
+
+	cfg.log_fn = NULL;
+	cfg.mem_fn = test_free_mem_fn;
+	cfg.mem_ctx = &mem;
+
+	if (!ttest_start(report, __func__, NULL, NULL, &tc)) return true;
+
+	list = test_free_deep_list(&cfg, 1000);
+	if (list == NULL) {
+		return ttest_fail(&tc, "Failed to build list");
+	}
+
+	mem.fail = true;
+	err = cyaml_free(&cfg, &test_free_node_schema, list, 0);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, "Free failed: %s", cyaml_strerror(err));
+	}
+
+	if (mem.live != 0) {
+		return ttest_fail(&tc, "Leaked %u allocations", mem.live);
+	}
+
+	return ttest_pass(&tc);
+}
+
+/**
+ * Test cyaml_free doesn't walk sequences of pointer-free entries.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_free_sequence_pointer_free(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	struct entry {
+		int a;
+		int b[2];
+	};
+	struct target_struct {
+		struct entry *entries;
+		unsigned entries_count;
+	} *data;
+	static const struct cyaml_schema_value int_schema = {
+		CYAML_VALUE_INT(CYAML_FLAG_DEFAULT, int),
+	};
+	static const struct cyaml_schema_field entry_schema[] = {
+		CYAML_FIELD_INT("a", CYAML_FLAG_DEFAULT, struct entry, a),
+		CYAML_FIELD_SEQUENCE_FIXED("b", CYAML_FLAG_DEFAULT,
+				struct entry, b, &int_schema, 2),
+		CYAML_FIELD_END
+	};
+	static const struct cyaml_schema_value entry_value = {
+		CYAML_VALUE_MAPPING(CYAML_FLAG_DEFAULT,
+				struct entry, entry_schema),
+	};
+	static const struct cyaml_schema_field mapping_schema[] = {
+		CYAML_FIELD_SEQUENCE("entries", CYAML_FLAG_POINTER,
+				struct target_struct, entries,
+				&entry_value, 0, CYAML_UNLIMITED),
+		CYAML_FIELD_END
+	};
+	static const struct cyaml_schema_value top_schema = {
+		CYAML_VALUE_MAPPING(CYAML_FLAG_POINTER,
+				struct target_struct, mapping_schema),
+	};
+	cyaml_schema_compiled_t *compiled = NULL;
+	test_free_mem_t mem = { 0 };
+	cyaml_config_t cfg = *config;
+	cyaml_err_t err;
+	ttest_ctx_t tc;
+
+	cfg.log_fn = test_free_log;
+	cfg.log_ctx = &mem;
+	cfg.log_level = CYAML_LOG_DEBUG;
+	cfg.mem_fn = test_free_mem_fn;
+	cfg.mem_ctx = &mem;
+
+	if (!ttest_start(report, __func__, NULL, NULL, &tc)) return true;
+
+	err = cyaml_schema_compile(&cfg, &top_schema, &compiled);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, "Compile failed: %s",
+				cyaml_strerror(err));
+	}
+
+	for (unsigned pass = 0; pass < 2; pass++) {
+		cfg.compiled_schema = (pass == 0) ? NULL : compiled;
+
+		data = cfg.mem_fn(cfg.mem_ctx, NULL, sizeof(*data));
+		if (data == NULL) {
+			cyaml_schema_compiled_free(&cfg, compiled);
+			return ttest_fail(&tc, "OOM");
+		}
+		data->entries_count = 1000;
+		data->entries = cfg.mem_fn(cfg.mem_ctx, NULL,
+				sizeof(*data->entries) * data->entries_count);
+		if (data->entries == NULL) {
+			cfg.mem_fn(cfg.mem_ctx, data, 0);
+			cyaml_schema_compiled_free(&cfg, compiled);
+			return ttest_fail(&tc, "OOM");
+		}
+
+		mem.keys = 0;
+		err = cyaml_free(&cfg, &top_schema, data, 0);
+		if (err != CYAML_OK) {
+			cyaml_schema_compiled_free(&cfg, compiled);
+			return ttest_fail(&tc, "Free failed: %s",
+					cyaml_strerror(err));
+		}
+
+		/* Only the top level mapping's key is walked. */
+		if (TEST_FREE_LOGGED && mem.keys != 1) {
+			cyaml_schema_compiled_free(&cfg, compiled);
+			return ttest_fail(&tc, "Walked %u keys", mem.keys);
+		}
+	}
+
+	cyaml_schema_compiled_free(&cfg, compiled);
+
+	if (mem.live != 0) {
+		return ttest_fail(&tc, "Leaked %u allocations", mem.live);
+	}
+
+	return ttest_pass(&tc);
+}
+
 /**
  * Run the CYAML freeing unit tests.
  *
@@ -156,6 +471,9 @@ bool free_tests(
 	pass &= test_free_null_mem_fn(rc, &config);
 	pass &= test_free_null_config(rc, &config);
 	pass &= test_free_null_schema(rc, &config);
+	pass &= test_free_deep(rc, &config);
+	pass &= test_free_deep_oom(rc, &config);
+	pass &= test_free_sequence_pointer_free(rc, &config);
 
 	return pass;
 }
@@ -0,0 +1,764 @@
+/*
+ * SPDX-License-Identifier: ISC
+ *
+ * Copyright (C) 2026 Michael Drake <tlsa@netsurf-browser.org>
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <assert.h>
+#include <string.h>
+#include <stdio.h>
+
+#include <cyaml/cyaml.h>
+
+#include "ttest.h"
+#include "test.h"
+
+/** Helper macro to count bytes of YAML input data. */
+#define YAML_LEN(_y) (sizeof(_y) - 1)
+
+/** Number of lazily decoded values a test can keep for clean up. */
+#define TEST_LAZY_DECODED_MAX 4
+
+/**
+ * Unit test context data.
+ */
+typedef struct test_data {
+	cyaml_data_t **data;
+	cyaml_data_t **copy;
+	char **buffer;
+	const struct cyaml_config *config;
+	const struct cyaml_schema_value *schema;
+	/** Lazily decoded values. */
+	cyaml_data_t *decoded[TEST_LAZY_DECODED_MAX];
+	/** Schemas for the lazily decoded values. */
+	const struct cyaml_schema_value *decoded_schema[TEST_LAZY_DECODED_MAX];
+	/** Sequence entry counts for the lazily decoded values. */
+	unsigned decoded_count[TEST_LAZY_DECODED_MAX];
+} test_data_t;
+
+/**
+ * Common clean up function to free data loaded by tests.
+ *
+ * \param[in]  data  The unit test context data.
+ */
+static void cyaml_cleanup(void *data)
+{
+	struct test_data *td = data;
+
+	for (unsigned i = 0; i < TEST_LAZY_DECODED_MAX; i++) {
+		if (td->decoded_schema[i] != NULL) {
+			cyaml_free(td->config, td->decoded_schema[i],
+					td->decoded[i], td->decoded_count[i]);
+		}
+	}
+
+	if (td->data != NULL) {
+		cyaml_free(td->config, td->schema, *(td->data), 0);
+	}
+
+	if (td->copy != NULL) {
+		cyaml_free(td->config, td->schema, *(td->copy), 0);
+	}
+
+	if (td->buffer != NULL) {
+		td->config->mem_fn(td->config->mem_ctx, *(td->buffer), 0);
+	}
+}
+
+/** Test document point structure. */
+struct test_lazy_point {
+	int x;
+	int y;
+};
+
+/** Test document inner structure. */
+struct test_lazy_inner {
+	int id;
+	cyaml_lazy_t more;
+};
+
+/** Test document structure. */
+struct test_lazy_doc {
+	char *name;
+	cyaml_lazy_t origin;
+	cyaml_lazy_t values;
+	cyaml_lazy_t inner;
+	cyaml_lazy_t absent;
+	int count;
+};
+
+/** Test document point mapping fields. */
+static const struct cyaml_schema_field test_lazy_point_fields[] = {
+	CYAML_FIELD_INT("x", CYAML_FLAG_DEFAULT, struct test_lazy_point, x),
+	CYAML_FIELD_INT("y", CYAML_FLAG_DEFAULT, struct test_lazy_point, y),
+	CYAML_FIELD_END
+};
+
+/** Test document value schema. */
+static const struct cyaml_schema_value test_lazy_value_schema = {
+	CYAML_VALUE_INT(CYAML_FLAG_DEFAULT, int),
+};
+
+/** Test document inner mapping fields. */
+static const struct cyaml_schema_field test_lazy_inner_fields[] = {
+	CYAML_FIELD_INT("id", CYAML_FLAG_DEFAULT, struct test_lazy_inner, id),
+	CYAML_FIELD_SEQUENCE_LAZY("more", CYAML_FLAG_DEFAULT,
+			struct test_lazy_inner, more, int,
+			&test_lazy_value_schema, 0, CYAML_UNLIMITED),
+	CYAML_FIELD_END
+};
+
+/** Test document mapping fields. */
+static const struct cyaml_schema_field test_lazy_fields[] = {
+	CYAML_FIELD_STRING_PTR("name", CYAML_FLAG_POINTER,
+			struct test_lazy_doc, name, 0, CYAML_UNLIMITED),
+	CYAML_FIELD_MAPPING_LAZY("origin", CYAML_FLAG_DEFAULT,
+			struct test_lazy_doc, origin,
+			struct test_lazy_point, test_lazy_point_fields),
+	CYAML_FIELD_SEQUENCE_LAZY("values", CYAML_FLAG_DEFAULT,
+			struct test_lazy_doc, values, int,
+			&test_lazy_value_schema, 0, CYAML_UNLIMITED),
+	CYAML_FIELD_MAPPING_LAZY("inner", CYAML_FLAG_DEFAULT,
+			struct test_lazy_doc, inner,
+			struct test_lazy_inner, test_lazy_inner_fields),
+	CYAML_FIELD_MAPPING_LAZY("absent", CYAML_FLAG_OPTIONAL,
+			struct test_lazy_doc, absent,
+			struct test_lazy_point, test_lazy_point_fields),
+	CYAML_FIELD_INT("count", CYAML_FLAG_DEFAULT,
+			struct test_lazy_doc, count),
+	CYAML_FIELD_END
+};
+
+/** Test document schema. */
+static const struct cyaml_schema_value test_lazy_schema = {
+	CYAML_VALUE_MAPPING(CYAML_FLAG_POINTER,
+			struct test_lazy_doc, test_lazy_fields),
+};
+
+/** Test document, with non-ASCII text before the lazy values. */
+static const unsigned char test_lazy_yaml[] =
+	"\xef\xbb\xbf"
+	"name: \"caf\xc3\xa9 \xe2\x98\x95\"\n"
+	"origin: {x: 1, y: 2}\n"
+	"values:\n"
+	"- 1\n"
+	"- 2\n"
+	"- 3\n"
+	"inner:\n"
+	"  id: 7\n"
+	"  more:\n"
+	"    - 4\n"
+	"    - 5\n"
+	"count: 9\n";
+
+/**
+ * Get a field's value schema from the test document schema.
+ *
+ * \param[in]  fields  The mapping fields to search.
+ * \param[in]  key     The field's key.
+ * \return the field's value schema.
+ */
+static const cyaml_schema_value_t * test_lazy_schema_for(
+		const cyaml_schema_field_t *fields,
+		const char *key)
+{
+	while (strcmp(fields->key, key) != 0) {
+		fields++;
+	}
+
+	return &fields->value;
+}
+
+/**
+ * Check whether a lazy value refers to the test document.
+ *
+ * \param[in]  lazy  The lazy value to check.
+ * \return true if the lazy value is inside the test document.
+ */
+static bool test_lazy_in_input(
+		const cyaml_lazy_t *lazy)
+{
+	const uint8_t *end = test_lazy_yaml + YAML_LEN(test_lazy_yaml);
+
+	return lazy->input != NULL && lazy->len > 0 &&
+			lazy->input >= test_lazy_yaml &&
+			lazy->input + lazy->len <= end;
+}
+
+/**
+ * Decode a test document's lazy values, and check them.
+ *
+ * \param[in]  tc      The test context.
+ * \param[in]  td      The unit test context data, to keep decoded values in.
+ * \param[in]  config  The CYAML config to decode with.
+ * \param[in]  doc     The test document.
+ * \return true if the lazy values are correct, false otherwise.
+ */
+static bool test_lazy_check_doc(
+		ttest_ctx_t *tc,
+		test_data_t *td,
+		const cyaml_config_t *config,
+		const struct test_lazy_doc *doc)
+{
+	const struct test_lazy_point *origin;
+	const struct test_lazy_inner *inner;
+	const int *values;
+	const int *more;
+	cyaml_err_t err;
+
+	if (doc->name == NULL ||
+	    strcmp(doc->name, "caf\xc3\xa9 \xe2\x98\x95") != 0 ||
+	    doc->count != 9) {
+		return ttest_fail(tc, "Incorrect eager values");
+	}
+
+	if (doc->absent.input != NULL) {
+		return ttest_fail(tc, "Absent lazy value has input");
+	}
+
+	td->decoded_schema[0] = test_lazy_schema_for(test_lazy_fields,
+			"origin");
+	err = cyaml_lazy_get(config, td->decoded_schema[0], &doc->origin,
+			&td->decoded[0], NULL);
+	if (err != CYAML_OK) {
+		return ttest_fail(tc, cyaml_strerror(err));
+	}
+	origin = td->decoded[0];
+	if (origin == NULL || origin->x != 1 || origin->y != 2) {
+		return ttest_fail(tc, "Incorrect lazy mapping");
+	}
+
+	td->decoded_schema[1] = test_lazy_schema_for(test_lazy_fields,
+			"values");
+	err = cyaml_lazy_get(config, td->decoded_schema[1], &doc->values,
+			&td->decoded[1], &td->decoded_count[1]);
+	if (err != CYAML_OK) {
+		return ttest_fail(tc, cyaml_strerror(err));
+	}
+	values = td->decoded[1];
+	if (td->decoded_count[1] != 3 ||
+	    values[0] != 1 || values[1] != 2 || values[2] != 3) {
+		return ttest_fail(tc, "Incorrect lazy sequence");
+	}
+
+	td->decoded_schema[2] = test_lazy_schema_for(test_lazy_fields,
+			"inner");
+	err = cyaml_lazy_get(config, td->decoded_schema[2], &doc->inner,
+			&td->decoded[2], NULL);
+	if (err != CYAML_OK) {
+		return ttest_fail(tc, cyaml_strerror(err));
+	}
+	inner = td->decoded[2];
+	if (inner == NULL || inner->id != 7) {
+		return ttest_fail(tc, "Incorrect lazy block mapping");
+	}
+
+	td->decoded_schema[3] = test_lazy_schema_for(test_lazy_inner_fields,
+			"more");
+	err = cyaml_lazy_get(config, td->decoded_schema[3], &inner->more,
+			&td->decoded[3], &td->decoded_count[3]);
+	if (err != CYAML_OK) {
+		return ttest_fail(tc, cyaml_strerror(err));
+	}
+	more = td->decoded[3];
+	if (td->decoded_count[3] != 2 || more[0] != 4 || more[1] != 5) {
+		return ttest_fail(tc, "Incorrect nested lazy sequence");
+	}
+
+	return true;
+}
+
+/**
+ * Test loading lazy values, and decoding them.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \param[in]  flags   Additional config flags to load with.
+ * \param[in]  name    Name of the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_lazy_load_with(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config,
+		cyaml_cfg_flags_t flags,
+		const char *name)
+{
+	struct test_lazy_doc *data_tgt = NULL;
+	cyaml_config_t cfg = *config;
+	test_data_t td = {
+		.data = (cyaml_data_t **) &data_tgt,
+		.config = config,
+		.schema = &test_lazy_schema,
+	};
+	cyaml_err_t err;
+	ttest_ctx_t tc;
+
+	if (!ttest_start(report, name, cyaml_cleanup, &td, &tc)) {
+		return true;
+	}
+
+	cfg.flags |= flags;
+
+	err = cyaml_load_data(test_lazy_yaml, YAML_LEN(test_lazy_yaml),
+			&cfg, &test_lazy_schema,
+			(cyaml_data_t **) &data_tgt, NULL);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	if (!test_lazy_in_input(&data_tgt->origin) ||
+	    !test_lazy_in_input(&data_tgt->values) ||
+	    !test_lazy_in_input(&data_tgt->inner)) {
+		return ttest_fail(&tc, "Lazy value not in input");
+	}
+
+	if (!test_lazy_check_doc(&tc, &td, &cfg, data_tgt)) {
+		return false;
+	}
+
+	if (!test_lazy_in_input(&((struct test_lazy_inner *)
+			td.decoded[2])->more)) {
+		return ttest_fail(&tc, "Nested lazy value not in input");
+	}
+
+	return ttest_pass(&tc);
+}
+
+/**
+ * Test loading lazy values with `libyaml`.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_lazy_load(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	return test_lazy_load_with(report, config,
+			CYAML_CFG_DEFAULT, __func__);
+}
+
+/**
+ * Test loading lazy values with the native scanner.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_lazy_load_native(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	return test_lazy_load_with(report, config,
+			CYAML_CFG_NATIVE_SCANNER, __func__);
+}
+
+/**
+ * Test decoding an absent lazy value.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_lazy_get_absent(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	struct test_lazy_point *data_tgt = (void *)&data_tgt;
+	const cyaml_lazy_t lazy = { 0 };
+	test_data_t td = {
+		.config = config,
+	};
+	cyaml_err_t err;
+	ttest_ctx_t tc;
+
+	if (!ttest_start(report, __func__, cyaml_cleanup, &td, &tc)) {
+		return true;
+	}
+
+	err = cyaml_lazy_get(config,
+			test_lazy_schema_for(test_lazy_fields, "absent"),
+			&lazy, (cyaml_data_t **) &data_tgt, NULL);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	if (data_tgt != NULL) {
+		return ttest_fail(&tc, "Data non-NULL for absent value.");
+	}
+
+	return ttest_pass(&tc);
+}
+
+/**
+ * Check whether a buffer contains a string.
+ *
+ * \param[in]  buffer  The buffer to search.
+ * \param[in]  len     Length of buffer in bytes.
+ * \param[in]  str     The string to search for.
+ * \return true if the string is in the buffer.
+ */
+static bool test_lazy_contains(
+		const char *buffer,
+		size_t len,
+		const char *str)
+{
+	size_t str_len = strlen(str);
+
+	for (size_t i = 0; i + str_len <= len; i++) {
+		if (memcmp(buffer + i, str, str_len) == 0) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/**
+ * Test saving lazy values.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_lazy_save(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	struct test_lazy_doc *data_tgt = NULL;
+	struct test_lazy_doc *reload = NULL;
+	char *buffer = NULL;
+	size_t len;
+	test_data_t td = {
+		.data = (cyaml_data_t **) &data_tgt,
+		.copy = (cyaml_data_t **) &reload,
+		.buffer = &buffer,
+		.config = config,
+		.schema = &test_lazy_schema,
+	};
+	cyaml_err_t err;
+	ttest_ctx_t tc;
+
+	if (!ttest_start(report, __func__, cyaml_cleanup, &td, &tc)) {
+		return true;
+	}
+
+	err = cyaml_load_data(test_lazy_yaml, YAML_LEN(test_lazy_yaml),
+			config, &test_lazy_schema,
+			(cyaml_data_t **) &data_tgt, NULL);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	err = cyaml_save_data(&buffer, &len, config, &test_lazy_schema,
+			data_tgt, 0);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	if (test_lazy_contains(buffer, len, "absent")) {
+		return ttest_fail(&tc, "Absent lazy value saved");
+	}
+
+	/* The saved lazy values refer to the saved output. */
+	err = cyaml_load_data((const uint8_t *)buffer, len,
+			config, &test_lazy_schema,
+			(cyaml_data_t **) &reload, NULL);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	if (!test_lazy_check_doc(&tc, &td, config, reload)) {
+		return false;
+	}
+
+	return ttest_pass(&tc);
+}
+
+/**
+ * Test copying lazy values.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_lazy_copy(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	struct test_lazy_doc *data_tgt = NULL;
+	struct test_lazy_doc *copy = NULL;
+	test_data_t td = {
+		.data = (cyaml_data_t **) &data_tgt,
+		.copy = (cyaml_data_t **) &copy,
+		.config = config,
+		.schema = &test_lazy_schema,
+	};
+	cyaml_err_t err;
+	ttest_ctx_t tc;
+
+	if (!ttest_start(report, __func__, cyaml_cleanup, &td, &tc)) {
+		return true;
+	}
+
+	err = cyaml_load_data(test_lazy_yaml, YAML_LEN(test_lazy_yaml),
+			config, &test_lazy_schema,
+			(cyaml_data_t **) &data_tgt, NULL);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	err = cyaml_copy(config, &test_lazy_schema, data_tgt, 0,
+			(cyaml_data_t **) &copy);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	if (copy->name == data_tgt->name ||
+	    memcmp(&copy->origin, &data_tgt->origin,
+			sizeof(copy->origin)) != 0 ||
+	    memcmp(&copy->values, &data_tgt->values,
+			sizeof(copy->values)) != 0 ||
+	    memcmp(&copy->inner, &data_tgt->inner,
+			sizeof(copy->inner)) != 0) {
+		return ttest_fail(&tc, "Incorrect copy");
+	}
+
+	if (!test_lazy_check_doc(&tc, &td, config, copy)) {
+		return false;
+	}
+
+	return ttest_pass(&tc);
+}
+
+/**
+ * Test loading lazy values from a file.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \param[in]  flags   Additional config flags to load with.
+ * \param[in]  name    Name of the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_lazy_err_file_with(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config,
+		cyaml_cfg_flags_t flags,
+		const char *name)
+{
+	struct target_struct {
+		cyaml_lazy_t cakes;
+	} *data_tgt = NULL;
+	static const struct cyaml_schema_value entry_schema = {
+		CYAML_VALUE_STRING(CYAML_FLAG_POINTER, char,
+				0, CYAML_UNLIMITED),
+	};
+	static const struct cyaml_schema_field mapping_schema[] = {
+		CYAML_FIELD_SEQUENCE_LAZY("cakes", CYAML_FLAG_DEFAULT,
+				struct target_struct, cakes, char *,
+				&entry_schema, 0, CYAML_UNLIMITED),
+		CYAML_FIELD_END
+	};
+	static const struct cyaml_schema_value top_schema = {
+		CYAML_VALUE_MAPPING(CYAML_FLAG_POINTER,
+				struct target_struct, mapping_schema),
+	};
+	cyaml_config_t cfg = *config;
+	test_data_t td = {
+		.data = (cyaml_data_t **) &data_tgt,
+		.config = config,
+		.schema = &top_schema,
+	};
+	cyaml_err_t err;
+	ttest_ctx_t tc;
+
+	if (!ttest_start(report, name, cyaml_cleanup, &td, &tc)) {
+		return true;
+	}
+
+	cfg.flags |= flags | CYAML_CFG_IGNORE_UNKNOWN_KEYS;
+
+	err = cyaml_load_file("test/data/basic.yaml", &cfg, &top_schema,
+			(cyaml_data_t **) &data_tgt, NULL);
+	if (err != CYAML_ERR_LAZY_NO_INPUT) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	if (data_tgt != NULL) {
+		return ttest_fail(&tc, "Data non-NULL on error.");
+	}
+
+	return ttest_pass(&tc);
+}
+
+/**
+ * Test loading lazy values from a file.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_lazy_err_file(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	return test_lazy_err_file_with(report, config,
+			CYAML_CFG_DEFAULT, __func__);
+}
+
+/**
+ * Test loading lazy values from a mapped file.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_lazy_err_file_mmap(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	return test_lazy_err_file_with(report, config,
+			CYAML_CFG_MMAP, __func__);
+}
+
+/**
+ * Test loading a lazy value that is an alias.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_lazy_err_alias(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	static const unsigned char yaml[] =
+		"name: a\n"
+		"absent: &o {x: 1, y: 2}\n"
+		"origin: *o\n"
+		"values: [1]\n"
+		"inner: {id: 1}\n"
+		"count: 1\n";
+	struct test_lazy_doc *data_tgt = NULL;
+	test_data_t td = {
+		.data = (cyaml_data_t **) &data_tgt,
+		.config = config,
+		.schema = &test_lazy_schema,
+	};
+	cyaml_err_t err;
+	ttest_ctx_t tc;
+
+	if (!ttest_start(report, __func__, cyaml_cleanup, &td, &tc)) {
+		return true;
+	}
+
+	err = cyaml_load_data(yaml, YAML_LEN(yaml), config, &test_lazy_schema,
+			(cyaml_data_t **) &data_tgt, NULL);
+	if (err != CYAML_ERR_ALIAS) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	if (data_tgt != NULL) {
+		return ttest_fail(&tc, "Data non-NULL on error.");
+	}
+
+	return ttest_pass(&tc);
+}
+
+/**
+ * Test loading a lazy value with an unsupported type.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_lazy_err_bad_type(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	static const unsigned char yaml[] =
+		"value: 1\n";
+	struct target_struct {
+		cyaml_lazy_t value;
+	} *data_tgt = NULL;
+	static const struct cyaml_schema_field mapping_schema[] = {
+		{
+			.key = "value",
+			.data_offset = offsetof(struct target_struct, value),
+			.value = {
+				CYAML_VALUE_INT(CYAML_FLAG_POINTER |
+						CYAML_FLAG_LAZY, int),
+			},
+		},
+		CYAML_FIELD_END
+	};
+	static const struct cyaml_schema_value top_schema = {
+		CYAML_VALUE_MAPPING(CYAML_FLAG_POINTER,
+				struct target_struct, mapping_schema),
+	};
+	test_data_t td = {
+		.data = (cyaml_data_t **) &data_tgt,
+		.config = config,
+		.schema = &top_schema,
+	};
+	cyaml_err_t err;
+	ttest_ctx_t tc;
+
+	if (!ttest_start(report, __func__, cyaml_cleanup, &td, &tc)) {
+		return true;
+	}
+
+	err = cyaml_load_data(yaml, YAML_LEN(yaml), config, &top_schema,
+			(cyaml_data_t **) &data_tgt, NULL);
+	if (err != CYAML_ERR_BAD_TYPE_IN_SCHEMA) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	if (data_tgt != NULL) {
+		return ttest_fail(&tc, "Data non-NULL on error.");
+	}
+
+	return ttest_pass(&tc);
+}
+
+/**
+ * Run the CYAML lazy value unit tests.
+ *
+ * \param[in]  rc         The ttest report context.
+ * \param[in]  log_level  CYAML log level.
+ * \param[in]  log_fn     CYAML logging function, or NULL.
+ * \return true iff all unit tests pass, otherwise false.
+ */
+bool lazy_tests(
+		ttest_report_ctx_t *rc,
+		cyaml_log_t log_level,
+		cyaml_log_fn_t log_fn)
+{
+	bool pass = true;
+	cyaml_config_t config = {
+		.log_fn = log_fn,
+		.mem_fn = cyaml_mem,
+		.log_level = log_level,
+		.flags = CYAML_CFG_DEFAULT,
+	};
+
+	ttest_heading(rc, "Lazy value tests");
+
+	pass &= test_lazy_load(rc, &config);
+	pass &= test_lazy_load_native(rc, &config);
+	pass &= test_lazy_get_absent(rc, &config);
+	pass &= test_lazy_save(rc, &config);
+	pass &= test_lazy_copy(rc, &config);
+
+	ttest_heading(rc, "Lazy value error tests");
+
+	pass &= test_lazy_err_file(rc, &config);
+	pass &= test_lazy_err_file_mmap(rc, &config);
+	pass &= test_lazy_err_alias(rc, &config);
+	pass &= test_lazy_err_bad_type(rc, &config);
+
+	return pass;
+}
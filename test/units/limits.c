@@ -0,0 +1,367 @@
+/*
+ * SPDX-License-Identifier: ISC
+ *
+ * Copyright (C) 2026 Michael Drake <tlsa@netsurf-browser.org>
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <assert.h>
+#include <string.h>
+#include <stdio.h>
+
+#include <cyaml/cyaml.h>
+
+#include "ttest.h"
+#include "test.h"
+
+/** Helper macro to count bytes of YAML input data. */
+#define YAML_LEN(_y) (sizeof(_y) - 1)
+
+#ifndef CYAML_STATS
+#define CYAML_STATS 1
+#endif
+
+/**
+ * Unit test context data.
+ */
+typedef struct test_data {
+	cyaml_data_t **data;
+	const struct cyaml_config *config;
+	const struct cyaml_schema_value *schema;
+} test_data_t;
+
+/**
+ * Common clean up function to free data loaded by tests.
+ *
+ * \param[in]  data  The unit test context data.
+ */
+static void cyaml_cleanup(void *data)
+{
+	struct test_data *td = data;
+
+	if (td->data != NULL) {
+		cyaml_free(td->config, td->schema, *(td->data), 0);
+	}
+}
+
+/** Test document structure. */
+struct test_limits_doc {
+	char *name;
+	int *values;
+	unsigned values_count;
+	struct test_limits_inner {
+		int x;
+	} inner;
+};
+
+/** Test document sequence entry schema. */
+static const struct cyaml_schema_value test_limits_entry_schema = {
+	CYAML_VALUE_INT(CYAML_FLAG_DEFAULT, int),
+};
+
+/** Test document inner mapping fields. */
+static const struct cyaml_schema_field test_limits_inner_fields[] = {
+	CYAML_FIELD_INT("x", CYAML_FLAG_DEFAULT,
+			struct test_limits_inner, x),
+	CYAML_FIELD_END
+};
+
+/** Test document mapping fields. */
+static const struct cyaml_schema_field test_limits_fields[] = {
+	CYAML_FIELD_STRING_PTR("name", CYAML_FLAG_POINTER,
+			struct test_limits_doc, name, 0, CYAML_UNLIMITED),
+	CYAML_FIELD_SEQUENCE("values", CYAML_FLAG_POINTER,
+			struct test_limits_doc, values,
+			&test_limits_entry_schema, 0, CYAML_UNLIMITED),
+	CYAML_FIELD_MAPPING("inner", CYAML_FLAG_OPTIONAL,
+			struct test_limits_doc, inner,
+			test_limits_inner_fields),
+	CYAML_FIELD_END
+};
+
+/** Test document schema. */
+static const struct cyaml_schema_value test_limits_schema = {
+	CYAML_VALUE_MAPPING(CYAML_FLAG_POINTER,
+			struct test_limits_doc, test_limits_fields),
+};
+
+/**
+ * Test the alias event limit.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_limits_alias_events(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	/* The aliases replay 4 * 6 + 4 * 26 + 6 = 134 events. */
+	static const unsigned char yaml[] =
+		"a: &a [1, 2, 3, 4]\n"
+		"b: &b [*a, *a, *a, *a]\n"
+		"c: [*b, *b, *b, *b]\n"
+		"name: laughs\n"
+		"values: *a\n";
+	struct test_limits_doc *data_tgt = NULL;
+	cyaml_config_t cfg = *config;
+	test_data_t td = {
+		.data = (cyaml_data_t **) &data_tgt,
+		.config = &cfg,
+		.schema = &test_limits_schema,
+	};
+	cyaml_err_t err;
+	ttest_ctx_t tc;
+
+	if (!ttest_start(report, __func__, cyaml_cleanup, &td, &tc)) {
+		return true;
+	}
+
+	cfg.flags |= CYAML_CFG_IGNORE_UNKNOWN_KEYS;
+	cfg.max_alias_events = 133;
+	err = cyaml_load_data(yaml, YAML_LEN(yaml), &cfg, &test_limits_schema,
+			(cyaml_data_t **) &data_tgt, NULL);
+	if (err != CYAML_ERR_LIMIT_ALIAS_EVENTS) {
+		return ttest_fail(&tc, "Limited: %s", cyaml_strerror(err));
+	}
+
+	cfg.max_alias_events = 134;
+	err = cyaml_load_data(yaml, YAML_LEN(yaml), &cfg, &test_limits_schema,
+			(cyaml_data_t **) &data_tgt, NULL);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, "Allowed: %s", cyaml_strerror(err));
+	}
+
+	if (data_tgt->values_count != 4 || data_tgt->values[3] != 4) {
+		return ttest_fail(&tc, "Incorrect value");
+	}
+
+	return ttest_pass(&tc);
+}
+
+/**
+ * Test the allocation limit.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_limits_alloc_bytes(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	static const unsigned char yaml[] =
+		"name: a name that is quite long\n"
+		"values: [1, 2, 3, 4, 5, 6, 7, 8]\n";
+	struct test_limits_doc *data_tgt = NULL;
+	cyaml_config_t cfg = *config;
+	test_data_t td = {
+		.data = (cyaml_data_t **) &data_tgt,
+		.config = &cfg,
+		.schema = &test_limits_schema,
+	};
+	cyaml_err_t err;
+	ttest_ctx_t tc;
+
+	if (!ttest_start(report, __func__, cyaml_cleanup, &td, &tc)) {
+		return true;
+	}
+
+	cfg.max_alloc_bytes = 64;
+	err = cyaml_load_data(yaml, YAML_LEN(yaml), &cfg, &test_limits_schema,
+			(cyaml_data_t **) &data_tgt, NULL);
+	if (err != CYAML_ERR_LIMIT_MEMORY) {
+		return ttest_fail(&tc, "Limited: %s", cyaml_strerror(err));
+	}
+
+	cfg.flags |= CYAML_CFG_ARENA;
+	err = cyaml_load_data(yaml, YAML_LEN(yaml), &cfg, &test_limits_schema,
+			(cyaml_data_t **) &data_tgt, NULL);
+	if (err != CYAML_ERR_LIMIT_MEMORY) {
+		return ttest_fail(&tc, "Arena: %s", cyaml_strerror(err));
+	}
+	cfg.flags &= ~(cyaml_cfg_flags_t)CYAML_CFG_ARENA;
+
+	cfg.max_alloc_bytes = 1024 * 1024;
+	err = cyaml_load_data(yaml, YAML_LEN(yaml), &cfg, &test_limits_schema,
+			(cyaml_data_t **) &data_tgt, NULL);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, "Allowed: %s", cyaml_strerror(err));
+	}
+
+	if (strcmp(data_tgt->name, "a name that is quite long") != 0 ||
+	    data_tgt->values_count != 8 || data_tgt->values[7] != 8) {
+		return ttest_fail(&tc, "Incorrect value");
+	}
+
+	return ttest_pass(&tc);
+}
+
+/**
+ * Test the nesting depth limit.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_limits_depth(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	static const unsigned char yaml_schema[] =
+		"name: nested\n"
+		"values: [1]\n"
+		"inner: { x: 1 }\n";
+	static const unsigned char yaml_ignored[] =
+		"name: nested\n"
+		"values: [1]\n"
+		"ignored: [[[1]]]\n";
+	struct test_limits_doc *data_tgt = NULL;
+	cyaml_config_t cfg = *config;
+	test_data_t td = {
+		.data = (cyaml_data_t **) &data_tgt,
+		.config = &cfg,
+		.schema = &test_limits_schema,
+	};
+	cyaml_err_t err;
+	ttest_ctx_t tc;
+
+	if (!ttest_start(report, __func__, cyaml_cleanup, &td, &tc)) {
+		return true;
+	}
+
+	cfg.flags |= CYAML_CFG_IGNORE_UNKNOWN_KEYS;
+	cfg.max_depth = 1;
+	err = cyaml_load_data(yaml_schema, YAML_LEN(yaml_schema), &cfg,
+			&test_limits_schema, (cyaml_data_t **) &data_tgt, NULL);
+	if (err != CYAML_ERR_LIMIT_DEPTH) {
+		return ttest_fail(&tc, "Schema: %s", cyaml_strerror(err));
+	}
+
+	cfg.max_depth = 3;
+	err = cyaml_load_data(yaml_ignored, YAML_LEN(yaml_ignored), &cfg,
+			&test_limits_schema, (cyaml_data_t **) &data_tgt, NULL);
+	if (err != CYAML_ERR_LIMIT_DEPTH) {
+		return ttest_fail(&tc, "Ignored: %s", cyaml_strerror(err));
+	}
+
+	cfg.max_depth = 4;
+	err = cyaml_load_data(yaml_ignored, YAML_LEN(yaml_ignored), &cfg,
+			&test_limits_schema, (cyaml_data_t **) &data_tgt, NULL);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, "Allowed: %s", cyaml_strerror(err));
+	}
+
+	cyaml_free(&cfg, &test_limits_schema, data_tgt, 0);
+	data_tgt = NULL;
+
+	cfg.max_depth = 2;
+	err = cyaml_load_data(yaml_schema, YAML_LEN(yaml_schema), &cfg,
+			&test_limits_schema, (cyaml_data_t **) &data_tgt, NULL);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, "Allowed: %s", cyaml_strerror(err));
+	}
+
+	if (data_tgt->inner.x != 1) {
+		return ttest_fail(&tc, "Incorrect value");
+	}
+
+	return ttest_pass(&tc);
+}
+
+/**
+ * Test the input size limit.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_limits_input_size(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	static const unsigned char yaml[] =
+		"name: sized\n"
+		"values: [1, 2]\n";
+	struct test_limits_doc *data_tgt = NULL;
+	cyaml_config_t cfg = *config;
+	cyaml_stats_t stats = { 0 };
+	test_data_t td = {
+		.data = (cyaml_data_t **) &data_tgt,
+		.config = &cfg,
+		.schema = &test_limits_schema,
+	};
+	cyaml_err_t err;
+	ttest_ctx_t tc;
+
+	if (!ttest_start(report, __func__, cyaml_cleanup, &td, &tc)) {
+		return true;
+	}
+
+	cfg.stats = &stats;
+	cfg.max_input_size = YAML_LEN(yaml) - 1;
+	err = cyaml_load_data(yaml, YAML_LEN(yaml), &cfg, &test_limits_schema,
+			(cyaml_data_t **) &data_tgt, NULL);
+	if (err != CYAML_ERR_LIMIT_INPUT_SIZE) {
+		return ttest_fail(&tc, "Limited: %s", cyaml_strerror(err));
+	}
+
+	cfg.flags |= CYAML_CFG_NATIVE_SCANNER;
+	err = cyaml_load_data(yaml, YAML_LEN(yaml), &cfg, &test_limits_schema,
+			(cyaml_data_t **) &data_tgt, NULL);
+	if (err != CYAML_ERR_LIMIT_INPUT_SIZE) {
+		return ttest_fail(&tc, "Native: %s", cyaml_strerror(err));
+	}
+	cfg.flags &= ~(cyaml_cfg_flags_t)CYAML_CFG_NATIVE_SCANNER;
+
+	/* Input that is known to be too big is rejected without parsing. */
+	if (CYAML_STATS && stats.libyaml_ns != 0) {
+		return ttest_fail(&tc, "Input was parsed");
+	}
+	cfg.stats = NULL;
+
+	cfg.max_input_size = YAML_LEN(yaml);
+	err = cyaml_load_data(yaml, YAML_LEN(yaml), &cfg, &test_limits_schema,
+			(cyaml_data_t **) &data_tgt, NULL);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, "Allowed: %s", cyaml_strerror(err));
+	}
+
+	if (data_tgt->values_count != 2 || data_tgt->values[1] != 2) {
+		return ttest_fail(&tc, "Incorrect value");
+	}
+
+	return ttest_pass(&tc);
+}
+
+/**
+ * Run the CYAML resource limit unit tests.
+ *
+ * \param[in]  rc         The ttest report context.
+ * \param[in]  log_level  CYAML log level.
+ * \param[in]  log_fn     CYAML logging function, or NULL.
+ * \return true iff all unit tests pass, otherwise false.
+ */
+bool limits_tests(
+		ttest_report_ctx_t *rc,
+		cyaml_log_t log_level,
+		cyaml_log_fn_t log_fn)
+{
+	bool pass = true;
+	cyaml_config_t config = {
+		.log_fn = log_fn,
+		.mem_fn = cyaml_mem,
+		.log_level = log_level,
+		.flags = CYAML_CFG_DEFAULT,
+	};
+
+	ttest_heading(rc, "Resource limit tests");
+
+	pass &= test_limits_depth(rc, &config);
+	pass &= test_limits_input_size(rc, &config);
+	pass &= test_limits_alloc_bytes(rc, &config);
+	pass &= test_limits_alias_events(rc, &config);
+
+	return pass;
+}
@@ -8565,6 +8565,116 @@ static bool test_load_mapping_with_multiple_fields(
 	return ttest_pass(&tc);
 }
 
+/**
+ * Test loading a mapping with too many fields for an inline bitfield.
+ *
+ * The mapping has a nested mapping among its fields, so the nested
+ * mapping's state is pushed while the outer mapping's bitfield is in use.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_load_mapping_with_many_fields(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	enum { COUNT = 100, INNER = 50 };
+	struct inner_struct {
+		int x;
+	};
+	struct target_struct {
+		int v[COUNT];
+		struct inner_struct inner;
+	} *data_tgt = NULL;
+	static const struct cyaml_schema_field inner_schema[] = {
+		CYAML_FIELD_INT("x", CYAML_FLAG_DEFAULT,
+				struct inner_struct, x),
+		CYAML_FIELD_END
+	};
+	struct cyaml_schema_field mapping_schema[COUNT + 2];
+	struct cyaml_schema_value top_schema = {
+		CYAML_VALUE_MAPPING(CYAML_FLAG_POINTER,
+				struct target_struct, mapping_schema),
+	};
+	char keys[COUNT][8];
+	unsigned char yaml[COUNT * 16 + 32];
+	test_data_t td = {
+		.data = (cyaml_data_t **) &data_tgt,
+		.config = config,
+		.schema = &top_schema,
+	};
+	size_t len = 0;
+	cyaml_err_t err;
+	ttest_ctx_t tc;
+	unsigned f = 0;
+
+	for (unsigned i = 0; i < COUNT; i++) {
+		if (i == INNER) {
+			mapping_schema[f++] = (struct cyaml_schema_field)
+					CYAML_FIELD_MAPPING("inner",
+						CYAML_FLAG_DEFAULT,
+						struct target_struct, inner,
+						inner_schema);
+		}
+		sprintf(keys[i], "f%u", i);
+		mapping_schema[f++] = (struct cyaml_schema_field) {
+			.key = keys[i],
+			.data_offset = (uint32_t)(offsetof(
+					struct target_struct, v) +
+					i * sizeof(int)),
+			.value = {
+				.type = CYAML_INT,
+				.flags = CYAML_FLAG_DEFAULT,
+				.data_size = sizeof(int),
+			},
+		};
+	}
+	mapping_schema[f] = (struct cyaml_schema_field) CYAML_FIELD_END;
+
+	for (unsigned i = COUNT; i > 0; i--) {
+		len += (size_t)sprintf((char *)yaml + len,
+				"f%u: %u\n", i - 1, i);
+		if (i - 1 == INNER) {
+			len += (size_t)sprintf((char *)yaml + len,
+					"inner: { x: 7 }\n");
+		}
+	}
+
+	if (!ttest_start(report, __func__, cyaml_cleanup, &td, &tc)) {
+		return true;
+	}
+
+	err = cyaml_load_data(yaml, len, config, &top_schema,
+			(cyaml_data_t **) &data_tgt, NULL);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	for (unsigned i = 0; i < COUNT; i++) {
+		if (data_tgt->v[i] != (int)i + 1) {
+			return ttest_fail(&tc, "Incorrect value for f%u", i);
+		}
+	}
+	if (data_tgt->inner.x != 7) {
+		return ttest_fail(&tc, "Incorrect value for inner");
+	}
+
+	cyaml_free(config, &top_schema, data_tgt, 0);
+	data_tgt = NULL;
+
+	/* Drop the last line, which has the required `f0` field. */
+	len -= strlen("f0: 1\n");
+
+	err = cyaml_load_data(yaml, len, config, &top_schema,
+			(cyaml_data_t **) &data_tgt, NULL);
+	if (err != CYAML_ERR_MAPPING_FIELD_MISSING) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	return ttest_pass(&tc);
+}
+
 /**
  * Test loading a mapping with optional fields.
  *
@@ -9076,6 +9186,376 @@ static bool test_load_sequence_without_max_entries(
 	return ttest_pass(&tc);
 }
 
+/**
+ * Generate YAML for a flow sequence of integers.
+ *
+ * The sequence entries are the integers from zero to `count - 1`.
+ *
+ * \param[in]  buf     Buffer to write the YAML into.
+ * \param[in]  size    Size of `buf` in bytes.
+ * \param[in]  prefix  YAML to write before the sequence.
+ * \param[in]  count   Number of sequence entries to write.
+ * \return the length of the generated YAML, or zero if it didn't fit.
+ */
+static size_t test_load_gen_int_seq_yaml(
+		char *buf,
+		size_t size,
+		const char *prefix,
+		unsigned count)
+{
+	size_t len = 0;
+	int ret;
+
+	ret = snprintf(buf, size, "%s [", prefix);
+	if (ret < 0 || (size_t)ret >= size) {
+		return 0;
+	}
+	len += (size_t)ret;
+
+	for (unsigned i = 0; i < count; i++) {
+		ret = snprintf(buf + len, size - len, "%s%u",
+				(i == 0) ? " " : ", ", i);
+		if (ret < 0 || (size_t)ret >= size - len) {
+			return 0;
+		}
+		len += (size_t)ret;
+	}
+
+	ret = snprintf(buf + len, size - len, " ]\n");
+	if (ret < 0 || (size_t)ret >= size - len) {
+		return 0;
+	}
+	len += (size_t)ret;
+
+	return len;
+}
+
+/**
+ * Test loading a pointer sequence with many entries.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_load_sequence_many_entries(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	enum { COUNT = 1000 };
+	static char yaml[COUNT * 8];
+	struct target_struct {
+		unsigned *seq;
+		unsigned seq_count;
+	} *data_tgt = NULL;
+	static const struct cyaml_schema_value sequence_entry = {
+		CYAML_VALUE_UINT(CYAML_FLAG_DEFAULT, unsigned),
+	};
+	static const struct cyaml_schema_field mapping_schema[] = {
+		CYAML_FIELD_SEQUENCE("seq", CYAML_FLAG_POINTER,
+				struct target_struct, seq, &sequence_entry,
+				0, CYAML_UNLIMITED),
+		CYAML_FIELD_END
+	};
+	static const struct cyaml_schema_value top_schema = {
+		CYAML_VALUE_MAPPING(CYAML_FLAG_POINTER,
+				struct target_struct, mapping_schema),
+	};
+	test_data_t td = {
+		.data = (cyaml_data_t **) &data_tgt,
+		.config = config,
+		.schema = &top_schema,
+	};
+	cyaml_err_t err;
+	ttest_ctx_t tc;
+	size_t len;
+
+	if (!ttest_start(report, __func__, cyaml_cleanup, &td, &tc)) {
+		return true;
+	}
+
+	len = test_load_gen_int_seq_yaml(yaml, sizeof(yaml), "seq:", COUNT);
+	if (len == 0) {
+		return ttest_fail(&tc, "Failed to generate YAML");
+	}
+
+	err = cyaml_load_data((const uint8_t *) yaml, len, config, &top_schema,
+			(cyaml_data_t **) &data_tgt, NULL);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	if (data_tgt->seq_count != COUNT) {
+		return ttest_fail(&tc, "Incorrect sequence entry count");
+	}
+	for (unsigned i = 0; i < COUNT; i++) {
+		if (data_tgt->seq[i] != i) {
+			return ttest_fail(&tc, "Incorrect value for entry %u",
+					i);
+		}
+	}
+
+	return ttest_pass(&tc);
+}
+
+/**
+ * Test loading a pointer sequence with many entries, keeping slack.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_load_sequence_many_entries_slack(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	enum { COUNT = 1000 };
+	static char yaml[COUNT * 8];
+	cyaml_config_t cfg = *config;
+	struct target_struct {
+		unsigned *seq;
+		unsigned seq_count;
+	} *data_tgt = NULL;
+	static const struct cyaml_schema_value sequence_entry = {
+		CYAML_VALUE_UINT(CYAML_FLAG_DEFAULT, unsigned),
+	};
+	static const struct cyaml_schema_field mapping_schema[] = {
+		CYAML_FIELD_SEQUENCE("seq", CYAML_FLAG_POINTER,
+				struct target_struct, seq, &sequence_entry,
+				0, CYAML_UNLIMITED),
+		CYAML_FIELD_END
+	};
+	static const struct cyaml_schema_value top_schema = {
+		CYAML_VALUE_MAPPING(CYAML_FLAG_POINTER,
+				struct target_struct, mapping_schema),
+	};
+	test_data_t td = {
+		.data = (cyaml_data_t **) &data_tgt,
+		.config = &cfg,
+		.schema = &top_schema,
+	};
+	cyaml_err_t err;
+	ttest_ctx_t tc;
+	size_t len;
+
+	if (!ttest_start(report, __func__, cyaml_cleanup, &td, &tc)) {
+		return true;
+	}
+
+	cfg.flags |= CYAML_CFG_SEQUENCE_SLACK;
+
+	len = test_load_gen_int_seq_yaml(yaml, sizeof(yaml), "seq:", COUNT);
+	if (len == 0) {
+		return ttest_fail(&tc, "Failed to generate YAML");
+	}
+
+	err = cyaml_load_data((const uint8_t *) yaml, len, &cfg, &top_schema,
+			(cyaml_data_t **) &data_tgt, NULL);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	if (data_tgt->seq_count != COUNT) {
+		return ttest_fail(&tc, "Incorrect sequence entry count");
+	}
+	for (unsigned i = 0; i < COUNT; i++) {
+		if (data_tgt->seq[i] != i) {
+			return ttest_fail(&tc, "Incorrect value for entry %u",
+					i);
+		}
+	}
+
+	return ttest_pass(&tc);
+}
+
+/**
+ * Test loading a pointer sequence that fills its schema's max entries.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_load_sequence_max_entries_filled(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	static const unsigned char yaml[] =
+		"seq: [ 0, 1, 2, 3, 4 ]\n";
+	struct target_struct {
+		unsigned *seq;
+		unsigned seq_count;
+	} *data_tgt = NULL;
+	static const struct cyaml_schema_value sequence_entry = {
+		CYAML_VALUE_UINT(CYAML_FLAG_DEFAULT, unsigned),
+	};
+	static const struct cyaml_schema_field mapping_schema[] = {
+		CYAML_FIELD_SEQUENCE("seq", CYAML_FLAG_POINTER,
+				struct target_struct, seq, &sequence_entry,
+				0, 5),
+		CYAML_FIELD_END
+	};
+	static const struct cyaml_schema_value top_schema = {
+		CYAML_VALUE_MAPPING(CYAML_FLAG_POINTER,
+				struct target_struct, mapping_schema),
+	};
+	test_data_t td = {
+		.data = (cyaml_data_t **) &data_tgt,
+		.config = config,
+		.schema = &top_schema,
+	};
+	cyaml_err_t err;
+	ttest_ctx_t tc;
+
+	if (!ttest_start(report, __func__, cyaml_cleanup, &td, &tc)) {
+		return true;
+	}
+
+	err = cyaml_load_data(yaml, YAML_LEN(yaml), config, &top_schema,
+			(cyaml_data_t **) &data_tgt, NULL);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	if (data_tgt->seq_count != 5) {
+		return ttest_fail(&tc, "Incorrect sequence entry count");
+	}
+	for (unsigned i = 0; i < 5; i++) {
+		if (data_tgt->seq[i] != i) {
+			return ttest_fail(&tc, "Incorrect value for entry %u",
+					i);
+		}
+	}
+
+	return ttest_pass(&tc);
+}
+
+/**
+ * Test loading a pointer sequence of numbers with aliased entries.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_load_sequence_int_alias(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	static const int expect[] = { 1, 2, 3, 2, 3, 4 };
+	static const unsigned char yaml[] =
+		"seq: [ 1, &two 2, &three 3, *two, *three, 4 ]\n";
+	struct target_struct {
+		int *seq;
+		unsigned seq_count;
+	} *data_tgt = NULL;
+	static const struct cyaml_schema_value sequence_entry = {
+		CYAML_VALUE_INT(CYAML_FLAG_DEFAULT, int),
+	};
+	static const struct cyaml_schema_field mapping_schema[] = {
+		CYAML_FIELD_SEQUENCE("seq", CYAML_FLAG_POINTER,
+				struct target_struct, seq, &sequence_entry,
+				0, CYAML_UNLIMITED),
+		CYAML_FIELD_END
+	};
+	static const struct cyaml_schema_value top_schema = {
+		CYAML_VALUE_MAPPING(CYAML_FLAG_POINTER,
+				struct target_struct, mapping_schema),
+	};
+	test_data_t td = {
+		.data = (cyaml_data_t **) &data_tgt,
+		.config = config,
+		.schema = &top_schema,
+	};
+	cyaml_err_t err;
+	ttest_ctx_t tc;
+
+	if (!ttest_start(report, __func__, cyaml_cleanup, &td, &tc)) {
+		return true;
+	}
+
+	err = cyaml_load_data(yaml, YAML_LEN(yaml), config, &top_schema,
+			(cyaml_data_t **) &data_tgt, NULL);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	if (data_tgt->seq_count != CYAML_ARRAY_LEN(expect)) {
+		return ttest_fail(&tc, "Incorrect sequence entry count");
+	}
+	for (unsigned i = 0; i < CYAML_ARRAY_LEN(expect); i++) {
+		if (data_tgt->seq[i] != expect[i]) {
+			return ttest_fail(&tc, "Incorrect value for entry %u",
+					i);
+		}
+	}
+
+	return ttest_pass(&tc);
+}
+
+/**
+ * Test loading a pointer sequence of floating point numbers.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_load_sequence_float_many_entries(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	enum { COUNT = 1000 };
+	static char yaml[COUNT * 8];
+	struct target_struct {
+		double *seq;
+		unsigned seq_count;
+	} *data_tgt = NULL;
+	static const struct cyaml_schema_value sequence_entry = {
+		CYAML_VALUE_FLOAT(CYAML_FLAG_DEFAULT, double),
+	};
+	static const struct cyaml_schema_field mapping_schema[] = {
+		CYAML_FIELD_SEQUENCE("seq", CYAML_FLAG_POINTER,
+				struct target_struct, seq, &sequence_entry,
+				0, CYAML_UNLIMITED),
+		CYAML_FIELD_END
+	};
+	static const struct cyaml_schema_value top_schema = {
+		CYAML_VALUE_MAPPING(CYAML_FLAG_POINTER,
+				struct target_struct, mapping_schema),
+	};
+	test_data_t td = {
+		.data = (cyaml_data_t **) &data_tgt,
+		.config = config,
+		.schema = &top_schema,
+	};
+	cyaml_err_t err;
+	ttest_ctx_t tc;
+	size_t len;
+
+	if (!ttest_start(report, __func__, cyaml_cleanup, &td, &tc)) {
+		return true;
+	}
+
+	len = test_load_gen_int_seq_yaml(yaml, sizeof(yaml), "seq:", COUNT);
+	if (len == 0) {
+		return ttest_fail(&tc, "Failed to generate YAML");
+	}
+
+	err = cyaml_load_data((const uint8_t *) yaml, len, config, &top_schema,
+			(cyaml_data_t **) &data_tgt, NULL);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	if (data_tgt->seq_count != COUNT) {
+		return ttest_fail(&tc, "Incorrect sequence entry count");
+	}
+	for (unsigned i = 0; i < COUNT; i++) {
+		if (data_tgt->seq[i] != (double) i) {
+			return ttest_fail(&tc, "Incorrect value for entry %u",
+					i);
+		}
+	}
+
+	return ttest_pass(&tc);
+}
 /**
  * Test loading without a logging function.
  *
@@ -10249,6 +10729,147 @@ static bool test_load_anchor_sequence(
 	return ttest_pass(&tc);
 }
 
+/**
+ * Generate YAML with a large anchored sequence, which is aliased twice.
+ *
+ * \param[in]  buf    Buffer to write the YAML into.
+ * \param[in]  size   Size of `buf` in bytes.
+ * \param[in]  count  Number of sequence entries to write.
+ * \return the length of the generated YAML, or zero if it didn't fit.
+ */
+static size_t test_load_gen_anchor_seq_yaml(
+		char *buf,
+		size_t size,
+		unsigned count)
+{
+	size_t len;
+	int ret;
+
+	len = test_load_gen_int_seq_yaml(buf, size, "anchors:\n  - &a1", count);
+	if (len == 0) {
+		return 0;
+	}
+
+	ret = snprintf(buf + len, size - len, "test_a: *a1\ntest_b: *a1\n");
+	if (ret < 0 || (size_t)ret >= size - len) {
+		return 0;
+	}
+
+	return len + (size_t)ret;
+}
+
+/**
+ * Test loading a large aliased sequence.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \param[in]  hint    The anchor events hint to load with.
+ * \param[in]  name    The test name.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_load_anchor_sequence_large_common(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config,
+		uint32_t hint,
+		const char *name)
+{
+	enum { COUNT = 1000 };
+	static char yaml[COUNT * 8];
+	cyaml_config_t cfg = *config;
+	struct target_struct {
+		unsigned *a;
+		unsigned a_count;
+		unsigned *b;
+		unsigned b_count;
+	} *data_tgt = NULL;
+	static const struct cyaml_schema_value sequence_entry_schema = {
+		CYAML_VALUE_UINT(CYAML_FLAG_DEFAULT, unsigned),
+	};
+	static const struct cyaml_schema_field mapping_schema[] = {
+		CYAML_FIELD_IGNORE("anchors", CYAML_FLAG_OPTIONAL),
+		CYAML_FIELD_SEQUENCE("test_a", CYAML_FLAG_POINTER,
+				struct target_struct, a,
+				&sequence_entry_schema,
+				0, CYAML_UNLIMITED),
+		CYAML_FIELD_SEQUENCE("test_b", CYAML_FLAG_POINTER,
+				struct target_struct, b,
+				&sequence_entry_schema,
+				0, CYAML_UNLIMITED),
+		CYAML_FIELD_END
+	};
+	static const struct cyaml_schema_value top_schema = {
+		CYAML_VALUE_MAPPING(CYAML_FLAG_POINTER,
+				struct target_struct, mapping_schema),
+	};
+	test_data_t td = {
+		.data = (cyaml_data_t **) &data_tgt,
+		.config = &cfg,
+		.schema = &top_schema,
+	};
+	cyaml_err_t err;
+	ttest_ctx_t tc;
+	size_t len;
+
+	if (!ttest_start(report, name, cyaml_cleanup, &td, &tc)) {
+		return true;
+	}
+
+	cfg.anchor_events_hint = hint;
+
+	len = test_load_gen_anchor_seq_yaml(yaml, sizeof(yaml), COUNT);
+	if (len == 0) {
+		return ttest_fail(&tc, "Failed to generate YAML");
+	}
+
+	err = cyaml_load_data((const uint8_t *) yaml, len, &cfg, &top_schema,
+			(cyaml_data_t **) &data_tgt, NULL);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	if (data_tgt->a_count != COUNT || data_tgt->b_count != COUNT) {
+		return ttest_fail(&tc, "Incorrect sequence entry count");
+	}
+	for (unsigned i = 0; i < COUNT; i++) {
+		if (data_tgt->a[i] != i || data_tgt->b[i] != i) {
+			return ttest_fail(&tc, "Incorrect value for entry %u",
+					i);
+		}
+	}
+
+	return ttest_pass(&tc);
+}
+
+/**
+ * Test loading a large aliased sequence.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_load_anchor_sequence_large(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	return test_load_anchor_sequence_large_common(report, config,
+			0, __func__);
+}
+
+/**
+ * Test loading a large aliased sequence, with an anchor events hint.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_load_anchor_sequence_large_hint(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	return test_load_anchor_sequence_large_common(report, config,
+			1024, __func__);
+}
+
 /**
  * Test loading with anchors within anchors, etc.
  *
@@ -11792,10 +12413,16 @@ bool load_tests(
 	pass &= test_load_multiple_documents_ignored(rc, &config);
 	pass &= test_load_mapping_without_any_fields(rc, &config);
 	pass &= test_load_mapping_with_multiple_fields(rc, &config);
+	pass &= test_load_mapping_with_many_fields(rc, &config);
 	pass &= test_load_mapping_with_optional_fields(rc, &config);
 	pass &= test_load_mapping_only_optional_fields(rc, &config);
 	pass &= test_load_mapping_ignored_unknown_keys(rc, &config);
 	pass &= test_load_sequence_without_max_entries(rc, &config);
+	pass &= test_load_sequence_many_entries(rc, &config);
+	pass &= test_load_sequence_many_entries_slack(rc, &config);
+	pass &= test_load_sequence_max_entries_filled(rc, &config);
+	pass &= test_load_sequence_int_alias(rc, &config);
+	pass &= test_load_sequence_float_many_entries(rc, &config);
 	pass &= test_load_schema_top_level_sequence_fixed(rc, &config);
 	pass &= test_load_schema_sequence_entry_count_member(rc, &config);
 
@@ -11820,6 +12447,8 @@ bool load_tests(
 
 	pass &= test_load_anchor_mapping(rc, &config);
 	pass &= test_load_anchor_sequence(rc, &config);
+	pass &= test_load_anchor_sequence_large(rc, &config);
+	pass &= test_load_anchor_sequence_large_hint(rc, &config);
 	pass &= test_load_anchor_deep_mapping_sequence(rc, &config);
 
 	ttest_heading(rc, "Load tests: anchors and aliases (edge cases)");
@@ -0,0 +1,863 @@
+/*
+ * SPDX-License-Identifier: ISC
+ *
+ * Copyright (C) 2026 Michael Drake <tlsa@netsurf-browser.org>
+ */
+
+#include <stdbool.h>
+#include <assert.h>
+#include <string.h>
+#include <stdio.h>
+
+#include <cyaml/cyaml.h>
+
+#include "ttest.h"
+#include "test.h"
+
+/** Helper macro to count bytes of YAML input data. */
+#define YAML_LEN(_y) (sizeof(_y) - 1)
+
+/**
+ * Unit test context data.
+ */
+typedef struct test_data {
+	cyaml_data_t **data;
+	char **buffer;
+	cyaml_loader_t **loader;
+	cyaml_saver_t **saver;
+	const struct cyaml_config *config;
+	const struct cyaml_schema_value *schema;
+} test_data_t;
+
+/**
+ * Common clean up function to free data, loaders and savers used by tests.
+ *
+ * \param[in]  data  The unit test context data.
+ */
+static void cyaml_cleanup(void *data)
+{
+	struct test_data *td = data;
+
+	if (td->data != NULL) {
+		cyaml_free(td->config, td->schema, *(td->data), 0);
+	}
+	if (td->buffer != NULL && *(td->buffer) != NULL) {
+		td->config->mem_fn(td->config->mem_ctx, *(td->buffer), 0);
+	}
+	if (td->loader != NULL) {
+		cyaml_loader_free(*(td->loader));
+	}
+	if (td->saver != NULL) {
+		cyaml_saver_free(*(td->saver));
+	}
+}
+
+/**
+ * Allocation counting memory function.
+ *
+ * \param[in] ctx    Pointer to count of new allocations.
+ * \param[in] ptr    Existing allocation to resize, or NULL.
+ * \param[in] size   The new size for the allocation.
+ * \return the allocation, or NULL.
+ */
+static void * test_loader_mem_count(
+		void *ctx,
+		void *ptr,
+		size_t size)
+{
+	unsigned *count = ctx;
+	void *temp = cyaml_mem(NULL, ptr, size);
+
+	if (ptr == NULL && temp != NULL) {
+		(*count)++;
+	}
+
+	return temp;
+}
+
+/** Test document mapping. */
+struct test_loader_doc {
+	char *name;
+	struct test_loader_inner {
+		int a;
+		int b;
+	} *inner;
+	struct test_loader_inner *alias;
+};
+
+/** Test document inner mapping schema. */
+static const struct cyaml_schema_field test_loader_inner_schema[] = {
+	CYAML_FIELD_INT("a", CYAML_FLAG_DEFAULT,
+			struct test_loader_inner, a),
+	CYAML_FIELD_INT("b", CYAML_FLAG_DEFAULT,
+			struct test_loader_inner, b),
+	CYAML_FIELD_END
+};
+
+/** Test document mapping schema. */
+static const struct cyaml_schema_field test_loader_doc_schema[] = {
+	CYAML_FIELD_STRING_PTR("name", CYAML_FLAG_POINTER,
+			struct test_loader_doc, name, 0, CYAML_UNLIMITED),
+	CYAML_FIELD_MAPPING_PTR("inner", CYAML_FLAG_POINTER,
+			struct test_loader_doc, inner,
+			test_loader_inner_schema),
+	CYAML_FIELD_MAPPING_PTR("alias", CYAML_FLAG_POINTER,
+			struct test_loader_doc, alias,
+			test_loader_inner_schema),
+	CYAML_FIELD_END
+};
+
+/** Test document top level schema. */
+static const struct cyaml_schema_value test_loader_top_schema = {
+	CYAML_VALUE_MAPPING(CYAML_FLAG_POINTER,
+			struct test_loader_doc, test_loader_doc_schema),
+};
+
+/**
+ * Check a loaded test document.
+ *
+ * \param[in]  doc   The loaded document.
+ * \param[in]  name  The expected name.
+ * \param[in]  a     The expected value of `a`.
+ * \param[in]  b     The expected value of `b`.
+ * \return true if the document is as expected, false otherwise.
+ */
+static bool test_loader_doc_check(
+		const struct test_loader_doc *doc,
+		const char *name,
+		int a,
+		int b)
+{
+	return doc != NULL &&
+			strcmp(doc->name, name) == 0 &&
+			doc->inner->a == a && doc->inner->b == b &&
+			doc->alias->a == a && doc->alias->b == b;
+}
+
+/**
+ * Test loading several documents with a loader.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_loader_load_many(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	static const unsigned char yaml_1[] =
+		"name: first\n"
+		"inner: &i { a: 1, b: 2 }\n"
+		"alias: *i\n";
+	static const unsigned char yaml_2[] =
+		"name: second\n"
+		"inner: &i { a: 3, b: 4 }\n"
+		"alias: *i\n";
+	struct test_loader_doc *data_tgt = NULL;
+	cyaml_loader_t *loader = NULL;
+	test_data_t td = {
+		.data = (cyaml_data_t **) &data_tgt,
+		.loader = &loader,
+		.config = config,
+		.schema = &test_loader_top_schema,
+	};
+	cyaml_err_t err;
+	ttest_ctx_t tc;
+
+	if (!ttest_start(report, __func__, cyaml_cleanup, &td, &tc)) {
+		return true;
+	}
+
+	err = cyaml_loader_create(config, &loader);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	for (unsigned i = 0; i < 4; i++) {
+		const unsigned char *yaml = (i & 1) ? yaml_2 : yaml_1;
+		size_t len = (i & 1) ? YAML_LEN(yaml_2) : YAML_LEN(yaml_1);
+
+		err = cyaml_loader_load_data(loader, yaml, len,
+				&test_loader_top_schema,
+				(cyaml_data_t **) &data_tgt, NULL);
+		if (err != CYAML_OK) {
+			return ttest_fail(&tc, cyaml_strerror(err));
+		}
+
+		if (!((i & 1) ?
+				test_loader_doc_check(data_tgt, "second", 3, 4) :
+				test_loader_doc_check(data_tgt, "first", 1, 2))) {
+			return ttest_fail(&tc, "Incorrect value for load %u",
+					i);
+		}
+
+		cyaml_free(config, &test_loader_top_schema, data_tgt, 0);
+		data_tgt = NULL;
+	}
+
+	return ttest_pass(&tc);
+}
+
+/**
+ * Test a loader can be used after a failed load.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_loader_load_after_error(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	static const unsigned char yaml_bad[] =
+		"name: bad\n"
+		"inner: &i { a: 1, b: 2, c: 3 }\n"
+		"alias: *i\n";
+	static const unsigned char yaml[] =
+		"name: good\n"
+		"inner: &i { a: 5, b: 6 }\n"
+		"alias: *i\n";
+	struct test_loader_doc *data_tgt = NULL;
+	cyaml_loader_t *loader = NULL;
+	test_data_t td = {
+		.data = (cyaml_data_t **) &data_tgt,
+		.loader = &loader,
+		.config = config,
+		.schema = &test_loader_top_schema,
+	};
+	cyaml_err_t err;
+	ttest_ctx_t tc;
+
+	if (!ttest_start(report, __func__, cyaml_cleanup, &td, &tc)) {
+		return true;
+	}
+
+	err = cyaml_loader_create(config, &loader);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	err = cyaml_loader_load_data(loader, yaml_bad, YAML_LEN(yaml_bad),
+			&test_loader_top_schema,
+			(cyaml_data_t **) &data_tgt, NULL);
+	if (err != CYAML_ERR_INVALID_KEY) {
+		return ttest_fail(&tc, "Unexpected: %s", cyaml_strerror(err));
+	}
+
+	err = cyaml_loader_load_data(loader, yaml, YAML_LEN(yaml),
+			&test_loader_top_schema,
+			(cyaml_data_t **) &data_tgt, NULL);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	if (!test_loader_doc_check(data_tgt, "good", 5, 6)) {
+		return ttest_fail(&tc, "Incorrect value");
+	}
+
+	return ttest_pass(&tc);
+}
+
+/**
+ * Test a loader reuses its allocations.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_loader_load_reuse(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	static const unsigned char yaml[] =
+		"name: reuse\n"
+		"inner: &i { a: 7, b: 8 }\n"
+		"alias: *i\n";
+	struct test_loader_doc *data_tgt = NULL;
+	cyaml_loader_t *loader = NULL;
+	cyaml_config_t cfg = *config;
+	test_data_t td = {
+		.data = (cyaml_data_t **) &data_tgt,
+		.loader = &loader,
+		.config = &cfg,
+		.schema = &test_loader_top_schema,
+	};
+	unsigned allocs[2];
+	unsigned count = 0;
+	cyaml_err_t err;
+	ttest_ctx_t tc;
+
+	if (!ttest_start(report, __func__, cyaml_cleanup, &td, &tc)) {
+		return true;
+	}
+
+	cfg.mem_fn = test_loader_mem_count;
+	cfg.mem_ctx = &count;
+
+	err = cyaml_loader_create(&cfg, &loader);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	for (unsigned i = 0; i < CYAML_ARRAY_LEN(allocs); i++) {
+		count = 0;
+		err = cyaml_loader_load_data(loader, yaml, YAML_LEN(yaml),
+				&test_loader_top_schema,
+				(cyaml_data_t **) &data_tgt, NULL);
+		if (err != CYAML_OK) {
+			return ttest_fail(&tc, cyaml_strerror(err));
+		}
+		allocs[i] = count;
+
+		if (!test_loader_doc_check(data_tgt, "reuse", 7, 8)) {
+			return ttest_fail(&tc, "Incorrect value");
+		}
+
+		cyaml_free(&cfg, &test_loader_top_schema, data_tgt, 0);
+		data_tgt = NULL;
+	}
+
+	if (allocs[1] >= allocs[0]) {
+		return ttest_fail(&tc, "Allocations not reused "
+				"(%u, then %u)", allocs[0], allocs[1]);
+	}
+
+	return ttest_pass(&tc);
+}
+
+/**
+ * Test loader and saver parameter checks.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_loader_bad_params(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	static const unsigned char yaml[] = "name: x\n";
+	struct test_loader_doc *data_tgt = NULL;
+	cyaml_config_t cfg = *config;
+	cyaml_loader_t *loader = NULL;
+	cyaml_saver_t *saver = NULL;
+	cyaml_err_t err;
+	ttest_ctx_t tc;
+	size_t len;
+	char *out;
+
+	if (!ttest_start(report, __func__, NULL, NULL, &tc)) {
+		return true;
+	}
+
+	err = cyaml_loader_create(NULL, &loader);
+	if (err != CYAML_ERR_BAD_PARAM_NULL_CONFIG) {
+		return ttest_fail(&tc, "Unexpected: %s", cyaml_strerror(err));
+	}
+	err = cyaml_loader_create(config, NULL);
+	if (err != CYAML_ERR_BAD_PARAM_NULL_LOADER) {
+		return ttest_fail(&tc, "Unexpected: %s", cyaml_strerror(err));
+	}
+	err = cyaml_loader_load_data(NULL, yaml, YAML_LEN(yaml),
+			&test_loader_top_schema,
+			(cyaml_data_t **) &data_tgt, NULL);
+	if (err != CYAML_ERR_BAD_PARAM_NULL_LOADER) {
+		return ttest_fail(&tc, "Unexpected: %s", cyaml_strerror(err));
+	}
+	err = cyaml_saver_create(config, NULL);
+	if (err != CYAML_ERR_BAD_PARAM_NULL_SAVER) {
+		return ttest_fail(&tc, "Unexpected: %s", cyaml_strerror(err));
+	}
+	err = cyaml_saver_save_data(NULL, &out, &len,
+			&test_loader_top_schema, data_tgt, 0);
+	if (err != CYAML_ERR_BAD_PARAM_NULL_SAVER) {
+		return ttest_fail(&tc, "Unexpected: %s", cyaml_strerror(err));
+	}
+
+	cfg.mem_fn = NULL;
+	err = cyaml_saver_create(&cfg, &saver);
+	if (err != CYAML_ERR_BAD_CONFIG_NULL_MEMFN) {
+		return ttest_fail(&tc, "Unexpected: %s", cyaml_strerror(err));
+	}
+
+	if (cyaml_loader_free(NULL) != CYAML_OK ||
+	    cyaml_saver_free(NULL) != CYAML_OK) {
+		return ttest_fail(&tc, "Freeing NULL failed");
+	}
+
+	return ttest_pass(&tc);
+}
+
+/**
+ * Test loading a document incrementally, one byte at a time.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_loader_feed_bytes(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	static const unsigned char yaml[] =
+		"name: fed\n"
+		"inner: &i { a: 1, b: 2 }\n"
+		"alias: *i\n";
+	struct test_loader_doc *data_tgt = NULL;
+	cyaml_loader_t *loader = NULL;
+	test_data_t td = {
+		.data = (cyaml_data_t **) &data_tgt,
+		.loader = &loader,
+		.config = config,
+		.schema = &test_loader_top_schema,
+	};
+	cyaml_err_t err;
+	ttest_ctx_t tc;
+
+	if (!ttest_start(report, __func__, cyaml_cleanup, &td, &tc)) {
+		return true;
+	}
+
+	err = cyaml_loader_create(config, &loader);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	err = cyaml_loader_feed_start(loader, &test_loader_top_schema);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	for (size_t i = 0; i < YAML_LEN(yaml); i++) {
+		err = cyaml_loader_feed(loader, yaml + i, 1);
+		if (err != CYAML_NEED_MORE) {
+			return ttest_fail(&tc, "Unexpected at %zu: %s",
+					i, cyaml_strerror(err));
+		}
+	}
+
+	err = cyaml_loader_feed_end(loader, (cyaml_data_t **) &data_tgt, NULL);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	if (!test_loader_doc_check(data_tgt, "fed", 1, 2)) {
+		return ttest_fail(&tc, "Incorrect value");
+	}
+
+	return ttest_pass(&tc);
+}
+
+/**
+ * Test loading a top level sequence incrementally, with a reused loader.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_loader_feed_sequence(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	static const struct cyaml_schema_value entry_schema = {
+		CYAML_VALUE_INT(CYAML_FLAG_DEFAULT, int),
+	};
+	static const struct cyaml_schema_value top_schema = {
+		CYAML_VALUE_SEQUENCE(CYAML_FLAG_POINTER, int,
+				&entry_schema, 0, CYAML_UNLIMITED),
+	};
+	static const char * const pieces[] = {
+		"- 1\n- 2", "2\n", "- 333\n- 4",
+	};
+	cyaml_loader_t *loader = NULL;
+	test_data_t td = {
+		.loader = &loader,
+		.config = config,
+	};
+	cyaml_err_t err;
+	ttest_ctx_t tc;
+
+	if (!ttest_start(report, __func__, cyaml_cleanup, &td, &tc)) {
+		return true;
+	}
+
+	err = cyaml_loader_create(config, &loader);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	for (unsigned i = 0; i < 2; i++) {
+		unsigned count = 0;
+		int *data = NULL;
+		bool ok;
+
+		err = cyaml_loader_feed_start(loader, &top_schema);
+		if (err != CYAML_OK) {
+			return ttest_fail(&tc, cyaml_strerror(err));
+		}
+
+		for (unsigned j = 0; j < CYAML_ARRAY_LEN(pieces); j++) {
+			err = cyaml_loader_feed(loader,
+					(const uint8_t *)pieces[j],
+					strlen(pieces[j]));
+			if (err != CYAML_NEED_MORE) {
+				return ttest_fail(&tc, cyaml_strerror(err));
+			}
+		}
+
+		err = cyaml_loader_feed_end(loader,
+				(cyaml_data_t **) &data, &count);
+		if (err != CYAML_OK) {
+			return ttest_fail(&tc, cyaml_strerror(err));
+		}
+
+		ok = (count == 4 && data[0] == 1 && data[1] == 22 &&
+				data[2] == 333 && data[3] == 4);
+		cyaml_free(config, &top_schema, data, count);
+		if (!ok) {
+			return ttest_fail(&tc, "Incorrect value for load %u",
+					i);
+		}
+	}
+
+	return ttest_pass(&tc);
+}
+
+/**
+ * Test freeing a loader after an incremental load completed, without
+ * taking the loaded data.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_loader_feed_abandon_done(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	static const unsigned char yaml[] =
+		"name: abandoned\n"
+		"inner: &i { a: 1, b: 2 }\n"
+		"alias: *i\n"
+		"...\n";
+	cyaml_config_t cfg = *config;
+	cyaml_loader_t *loader = NULL;
+	test_data_t td = {
+		.loader = &loader,
+		.config = config,
+	};
+	cyaml_err_t err;
+	ttest_ctx_t tc;
+
+	if (!ttest_start(report, __func__, cyaml_cleanup, &td, &tc)) {
+		return true;
+	}
+
+	for (unsigned i = 0; i < 2; i++) {
+		cfg.flags = config->flags | ((i == 0) ? 0 : CYAML_CFG_ARENA);
+
+		err = cyaml_loader_create(&cfg, &loader);
+		if (err != CYAML_OK) {
+			return ttest_fail(&tc, cyaml_strerror(err));
+		}
+
+		err = cyaml_loader_feed_start(loader, &test_loader_top_schema);
+		if (err != CYAML_OK) {
+			return ttest_fail(&tc, cyaml_strerror(err));
+		}
+
+		err = cyaml_loader_feed(loader, yaml, YAML_LEN(yaml));
+		if (err != CYAML_NEED_MORE) {
+			return ttest_fail(&tc, "Unexpected for load %u: %s",
+					i, cyaml_strerror(err));
+		}
+
+		/* The loaded document must be freed with the loader. */
+		err = cyaml_loader_free(loader);
+		loader = NULL;
+		if (err != CYAML_OK) {
+			return ttest_fail(&tc, cyaml_strerror(err));
+		}
+	}
+
+	return ttest_pass(&tc);
+}
+
+/**
+ * Test an incremental load reports errors before the input ends.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_loader_feed_early_error(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	static const unsigned char yaml_bad[] =
+		"name: bad\n"
+		"inner: &i { a: 1, b: 2, c: 3 }\n";
+	static const unsigned char yaml[] =
+		"name: good\n"
+		"inner: &i { a: 5, b: 6 }\n"
+		"alias: *i\n";
+	struct test_loader_doc *data_tgt = NULL;
+	cyaml_loader_t *loader = NULL;
+	test_data_t td = {
+		.data = (cyaml_data_t **) &data_tgt,
+		.loader = &loader,
+		.config = config,
+		.schema = &test_loader_top_schema,
+	};
+	cyaml_err_t err;
+	ttest_ctx_t tc;
+
+	if (!ttest_start(report, __func__, cyaml_cleanup, &td, &tc)) {
+		return true;
+	}
+
+	err = cyaml_loader_create(config, &loader);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	err = cyaml_loader_feed_start(loader, &test_loader_top_schema);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	err = cyaml_loader_feed(loader, yaml_bad, YAML_LEN(yaml_bad));
+	if (err != CYAML_ERR_INVALID_KEY) {
+		return ttest_fail(&tc, "Unexpected: %s", cyaml_strerror(err));
+	}
+
+	/* The failed load has ended, so the loader can be used again. */
+	err = cyaml_loader_feed(loader, yaml, YAML_LEN(yaml));
+	if (err != CYAML_ERR_BAD_LOADER_STATE) {
+		return ttest_fail(&tc, "Unexpected: %s", cyaml_strerror(err));
+	}
+
+	err = cyaml_loader_load_data(loader, yaml, YAML_LEN(yaml),
+			&test_loader_top_schema,
+			(cyaml_data_t **) &data_tgt, NULL);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	if (!test_loader_doc_check(data_tgt, "good", 5, 6)) {
+		return ttest_fail(&tc, "Incorrect value");
+	}
+
+	return ttest_pass(&tc);
+}
+
+/**
+ * Test incremental load state and parameter checks.
+ *
+ * The loader is freed with the incremental load still in progress.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_loader_feed_bad_params(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	static const unsigned char yaml[] = "name: x\n";
+	static const unsigned char yaml_more[] = "inner: { a: 1, b: 2 }\n";
+	struct test_loader_doc *data_tgt = NULL;
+	cyaml_loader_t *loader = NULL;
+	test_data_t td = {
+		.loader = &loader,
+		.config = config,
+	};
+	unsigned count;
+	cyaml_err_t err;
+	ttest_ctx_t tc;
+
+	if (!ttest_start(report, __func__, cyaml_cleanup, &td, &tc)) {
+		return true;
+	}
+
+	if (cyaml_loader_feed_start(NULL, &test_loader_top_schema) !=
+			CYAML_ERR_BAD_PARAM_NULL_LOADER ||
+	    cyaml_loader_feed(NULL, yaml, YAML_LEN(yaml)) !=
+			CYAML_ERR_BAD_PARAM_NULL_LOADER ||
+	    cyaml_loader_feed_end(NULL, (cyaml_data_t **) &data_tgt,
+			NULL) != CYAML_ERR_BAD_PARAM_NULL_LOADER) {
+		return ttest_fail(&tc, "NULL loader accepted");
+	}
+
+	err = cyaml_loader_create(config, &loader);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	err = cyaml_loader_feed(loader, yaml, YAML_LEN(yaml));
+	if (err != CYAML_ERR_BAD_LOADER_STATE) {
+		return ttest_fail(&tc, "Unexpected: %s", cyaml_strerror(err));
+	}
+	err = cyaml_loader_feed_end(loader, (cyaml_data_t **) &data_tgt, NULL);
+	if (err != CYAML_ERR_BAD_LOADER_STATE) {
+		return ttest_fail(&tc, "Unexpected: %s", cyaml_strerror(err));
+	}
+	err = cyaml_loader_feed_start(loader, NULL);
+	if (err != CYAML_ERR_BAD_PARAM_NULL_SCHEMA) {
+		return ttest_fail(&tc, "Unexpected: %s", cyaml_strerror(err));
+	}
+
+	err = cyaml_loader_feed_start(loader, &test_loader_top_schema);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+	err = cyaml_loader_feed(loader, yaml, YAML_LEN(yaml));
+	if (err != CYAML_NEED_MORE) {
+		return ttest_fail(&tc, "Unexpected: %s", cyaml_strerror(err));
+	}
+
+	err = cyaml_loader_feed_start(loader, &test_loader_top_schema);
+	if (err != CYAML_ERR_BAD_LOADER_STATE) {
+		return ttest_fail(&tc, "Unexpected: %s", cyaml_strerror(err));
+	}
+	err = cyaml_loader_load_data(loader, yaml, YAML_LEN(yaml),
+			&test_loader_top_schema,
+			(cyaml_data_t **) &data_tgt, NULL);
+	if (err != CYAML_ERR_BAD_LOADER_STATE) {
+		return ttest_fail(&tc, "Unexpected: %s", cyaml_strerror(err));
+	}
+	err = cyaml_loader_feed(loader, NULL, 1);
+	if (err != CYAML_ERR_BAD_PARAM_NULL_DATA) {
+		return ttest_fail(&tc, "Unexpected: %s", cyaml_strerror(err));
+	}
+	err = cyaml_loader_feed_end(loader, (cyaml_data_t **) &data_tgt,
+			&count);
+	if (err != CYAML_ERR_BAD_PARAM_SEQ_COUNT) {
+		return ttest_fail(&tc, "Unexpected: %s", cyaml_strerror(err));
+	}
+
+	/* The incremental load is still in progress. */
+	err = cyaml_loader_feed(loader, yaml_more, YAML_LEN(yaml_more));
+	if (err != CYAML_NEED_MORE) {
+		return ttest_fail(&tc, "Unexpected: %s", cyaml_strerror(err));
+	}
+
+	return ttest_pass(&tc);
+}
+
+/**
+ * Test saving several documents with a saver.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_saver_save_many(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	static const char ref[] =
+		"name: saved\n"
+		"inner:\n"
+		"  a: 1\n"
+		"  b: 2\n"
+		"alias:\n"
+		"  a: 3\n"
+		"  b: 4\n";
+	struct test_loader_inner inner = { .a = 1, .b = 2 };
+	struct test_loader_inner alias = { .a = 3, .b = 4 };
+	struct test_loader_doc doc = {
+		.name = (char *) "saved",
+		.inner = &inner,
+		.alias = &alias,
+	};
+	cyaml_saver_t *saver = NULL;
+	char *buffer = NULL;
+	test_data_t td = {
+		.buffer = &buffer,
+		.saver = &saver,
+		.config = config,
+	};
+	cyaml_err_t err;
+	ttest_ctx_t tc;
+	size_t len;
+
+	if (!ttest_start(report, __func__, cyaml_cleanup, &td, &tc)) {
+		return true;
+	}
+
+	err = cyaml_saver_create(config, &saver);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	for (unsigned i = 0; i < 3; i++) {
+		err = cyaml_saver_save_data(saver, &buffer, &len,
+				&test_loader_top_schema, &doc, 0);
+		if (err != CYAML_OK) {
+			return ttest_fail(&tc, cyaml_strerror(err));
+		}
+
+		if (len != YAML_LEN(ref) || memcmp(ref, buffer, len) != 0) {
+			return ttest_fail(&tc, "Bad data for save %u:\n"
+					"EXPECTED (%zu):\n\n%.*s\n\n"
+					"GOT (%zu):\n\n%.*s\n", i,
+					YAML_LEN(ref), YAML_LEN(ref), ref,
+					len, (int)len, buffer);
+		}
+
+		config->mem_fn(config->mem_ctx, buffer, 0);
+		buffer = NULL;
+	}
+
+	return ttest_pass(&tc);
+}
+
+/**
+ * Run the CYAML loader and saver unit tests.
+ *
+ * \param[in]  rc         The ttest report context.
+ * \param[in]  log_level  CYAML log level.
+ * \param[in]  log_fn     CYAML logging function, or NULL.
+ * \return true iff all unit tests pass, otherwise false.
+ */
+bool loader_tests(
+		ttest_report_ctx_t *rc,
+		cyaml_log_t log_level,
+		cyaml_log_fn_t log_fn)
+{
+	bool pass = true;
+	cyaml_config_t config = {
+		.log_fn = log_fn,
+		.mem_fn = cyaml_mem,
+		.log_level = log_level,
+		.flags = CYAML_CFG_DEFAULT,
+	};
+
+	ttest_heading(rc, "Loader tests");
+
+	pass &= test_loader_load_many(rc, &config);
+	pass &= test_loader_load_after_error(rc, &config);
+	pass &= test_loader_load_reuse(rc, &config);
+	pass &= test_loader_bad_params(rc, &config);
+	pass &= test_loader_feed_bytes(rc, &config);
+	pass &= test_loader_feed_sequence(rc, &config);
+	pass &= test_loader_feed_abandon_done(rc, &config);
+
+	/* Since we expect error logging for these tests,
+	 * suppress log output if required log level is greater
+	 * than \ref CYAML_LOG_INFO.
+	 */
+	if (log_level > CYAML_LOG_INFO) {
+		config.log_fn = NULL;
+	}
+
+	pass &= test_loader_feed_early_error(rc, &config);
+	pass &= test_loader_feed_bad_params(rc, &config);
+
+	ttest_heading(rc, "Saver tests");
+
+	pass &= test_saver_save_many(rc, &config);
+
+	return pass;
+}
@@ -0,0 +1,515 @@
+/*
+ * SPDX-License-Identifier: ISC
+ *
+ * Copyright (C) 2026 Michael Drake <tlsa@netsurf-browser.org>
+ */
+
+#include <stdbool.h>
+#include <assert.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdio.h>
+#include <math.h>
+
+#include <cyaml/cyaml.h>
+
+#include "../../src/number.h"
+
+#include "ttest.h"
+#include "test.h"
+
+/** Macro to squash unused variable compiler warnings. */
+#define UNUSED(_x) ((void)(_x))
+
+/**
+ * Test formatting signed integers.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_number_format_int(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	static const struct {
+		int64_t value;
+		const char *expected;
+	} tests[] = {
+		{ 0, "0" },
+		{ 7, "7" },
+		{ -7, "-7" },
+		{ 1000, "1000" },
+		{ INT64_MAX, "9223372036854775807" },
+		{ INT64_MIN, "-9223372036854775808" },
+	};
+	char buffer[CYAML_NUMBER_STR_MAX];
+	ttest_ctx_t tc;
+
+	UNUSED(config);
+
+	if (!ttest_start(report, __func__, NULL, NULL, &tc)) {
+		return true;
+	}
+
+	for (unsigned i = 0; i < CYAML_ARRAY_LEN(tests); i++) {
+		const char *str = cyaml__number_format_int(
+				tests[i].value, buffer);
+
+		if (strcmp(str, tests[i].expected) != 0) {
+			return ttest_fail(&tc, "Incorrect value: "
+					"expected: %s, got: %s",
+					tests[i].expected, str);
+		}
+	}
+
+	return ttest_pass(&tc);
+}
+
+/**
+ * Test formatting unsigned integers, in decimal and hex.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_number_format_uint(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	static const struct {
+		uint64_t value;
+		bool hex;
+		const char *expected;
+	} tests[] = {
+		{ 0, false, "0" },
+		{ 42, false, "42" },
+		{ UINT64_MAX, false, "18446744073709551615" },
+		{ 0, true, "0x0" },
+		{ 0xbeef, true, "0xbeef" },
+		{ UINT64_MAX, true, "0xffffffffffffffff" },
+	};
+	char buffer[CYAML_NUMBER_STR_MAX];
+	ttest_ctx_t tc;
+
+	UNUSED(config);
+
+	if (!ttest_start(report, __func__, NULL, NULL, &tc)) {
+		return true;
+	}
+
+	for (unsigned i = 0; i < CYAML_ARRAY_LEN(tests); i++) {
+		const char *str = cyaml__number_format_uint(
+				tests[i].value, tests[i].hex, buffer);
+
+		if (strcmp(str, tests[i].expected) != 0) {
+			return ttest_fail(&tc, "Incorrect value: "
+					"expected: %s, got: %s",
+					tests[i].expected, str);
+		}
+	}
+
+	return ttest_pass(&tc);
+}
+
+/**
+ * Test formatting double precision floating point values.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_number_format_double(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	static const struct {
+		double value;
+		const char *expected;
+	} tests[] = {
+		{ 0.0, "0.0" },
+		{ -0.0, "-0.0" },
+		{ 1.0, "1.0" },
+		{ 0.1, "0.1" },
+		{ 0.3, "0.3" },
+		{ -3.14, "-3.14" },
+		{ 1e15, "1000000000000000.0" },
+		{ 1e16, "1.0e+16" },
+		{ 123456.789, "123456.789" },
+		{ 0.0001, "0.0001" },
+		{ 0.00001, "0.00001" },
+		{ 0.000001, "1.0e-06" },
+		{ 2.5e-7, "2.5e-07" },
+		{ 1e100, "1.0e+100" },
+		{ 5e-324, "5.0e-324" },
+		{ 1.7976931348623157e308, "1.7976931348623157e+308" },
+		{ INFINITY, "inf" },
+		{ -INFINITY, "-inf" },
+		{ NAN, "nan" },
+	};
+	char buffer[CYAML_NUMBER_STR_MAX];
+	ttest_ctx_t tc;
+
+	UNUSED(config);
+
+	if (!ttest_start(report, __func__, NULL, NULL, &tc)) {
+		return true;
+	}
+
+	for (unsigned i = 0; i < CYAML_ARRAY_LEN(tests); i++) {
+		const char *str = cyaml__number_format_double(
+				tests[i].value, buffer);
+
+		if (strcmp(str, tests[i].expected) != 0) {
+			return ttest_fail(&tc, "Incorrect value: "
+					"expected: %s, got: %s",
+					tests[i].expected, str);
+		}
+	}
+
+	return ttest_pass(&tc);
+}
+
+/**
+ * Test formatting single precision floating point values.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_number_format_float(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	static const struct {
+		float value;
+		const char *expected;
+	} tests[] = {
+		{ 0.0f, "0.0" },
+		{ 3.14f, "3.14" },
+		{ 0.1f, "0.1" },
+		{ 16777216.0f, "16777216.0" },
+		{ 1e-45f, "1.0e-45" },
+		{ 3.4028235e38f, "3.4028235e+38" },
+		{ -INFINITY, "-inf" },
+	};
+	char buffer[CYAML_NUMBER_STR_MAX];
+	ttest_ctx_t tc;
+
+	UNUSED(config);
+
+	if (!ttest_start(report, __func__, NULL, NULL, &tc)) {
+		return true;
+	}
+
+	for (unsigned i = 0; i < CYAML_ARRAY_LEN(tests); i++) {
+		const char *str = cyaml__number_format_float(
+				tests[i].value, buffer);
+
+		if (strcmp(str, tests[i].expected) != 0) {
+			return ttest_fail(&tc, "Incorrect value: "
+					"expected: %s, got: %s",
+					tests[i].expected, str);
+		}
+	}
+
+	return ttest_pass(&tc);
+}
+
+/**
+ * Test that formatted floating point values read back unchanged.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_number_format_round_trip(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	char buffer[CYAML_NUMBER_STR_MAX];
+	uint64_t state = 0x2545f4914f6cdd1d;
+	ttest_ctx_t tc;
+
+	UNUSED(config);
+
+	if (!ttest_start(report, __func__, NULL, NULL, &tc)) {
+		return true;
+	}
+
+	for (unsigned i = 0; i < 10000; i++) {
+		const char *str;
+		uint32_t bits32;
+		double d;
+		float f;
+
+		/* Xorshift, to get a spread of bit patterns. */
+		state ^= state << 13;
+		state ^= state >> 7;
+		state ^= state << 17;
+
+		memcpy(&d, &state, sizeof(d));
+		if (isfinite(d)) {
+			str = cyaml__number_format_double(d, buffer);
+			if (strtod(str, NULL) != d) {
+				return ttest_fail(&tc, "Double %a read back "
+						"incorrectly from: %s", d, str);
+			}
+		}
+
+		bits32 = (uint32_t)state;
+		memcpy(&f, &bits32, sizeof(f));
+		if (isfinite(f)) {
+			str = cyaml__number_format_float(f, buffer);
+			if (strtof(str, NULL) != f) {
+				return ttest_fail(&tc, "Float %a read back "
+						"incorrectly from: %s",
+						(double)f, str);
+			}
+		}
+	}
+
+	return ttest_pass(&tc);
+}
+
+/**
+ * Test parsing signed integers.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_number_parse_int(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	static const struct {
+		const char *str;
+		cyaml_number_result_t result;
+		int64_t expected;
+	} tests[] = {
+		{ "0", CYAML_NUMBER_OK, 0 },
+		{ "90", CYAML_NUMBER_OK, 90 },
+		{ "+90", CYAML_NUMBER_OK, 90 },
+		{ "-90", CYAML_NUMBER_OK, -90 },
+		{ "0x1F", CYAML_NUMBER_OK, 31 },
+		{ "-0x1f", CYAML_NUMBER_OK, -31 },
+		{ "017", CYAML_NUMBER_OK, 15 },
+		{ " 5", CYAML_NUMBER_OK, 5 },
+		{ "9223372036854775807", CYAML_NUMBER_OK, INT64_MAX },
+		{ "-9223372036854775808", CYAML_NUMBER_OK, INT64_MIN },
+		{ "9223372036854775808", CYAML_NUMBER_RANGE, 0 },
+		{ "99999999999999999999", CYAML_NUMBER_RANGE, 0 },
+		{ "", CYAML_NUMBER_INVALID, 0 },
+		{ "-", CYAML_NUMBER_INVALID, 0 },
+		{ "08", CYAML_NUMBER_INVALID, 0 },
+		{ "0x", CYAML_NUMBER_INVALID, 0 },
+		{ "1.5", CYAML_NUMBER_INVALID, 0 },
+		{ "12 ", CYAML_NUMBER_INVALID, 0 },
+		{ "Unicorns", CYAML_NUMBER_INVALID, 0 },
+	};
+	ttest_ctx_t tc;
+
+	UNUSED(config);
+
+	if (!ttest_start(report, __func__, NULL, NULL, &tc)) {
+		return true;
+	}
+
+	for (unsigned i = 0; i < CYAML_ARRAY_LEN(tests); i++) {
+		cyaml_number_result_t result;
+		int64_t value = 0;
+
+		result = cyaml__number_parse_int(tests[i].str, &value);
+		if (result != tests[i].result) {
+			return ttest_fail(&tc, "Incorrect result for '%s': "
+					"expected: %u, got: %u", tests[i].str,
+					tests[i].result, result);
+		}
+		if (result == CYAML_NUMBER_OK && value != tests[i].expected) {
+			return ttest_fail(&tc, "Incorrect value for '%s'",
+					tests[i].str);
+		}
+	}
+
+	return ttest_pass(&tc);
+}
+
+/**
+ * Test parsing unsigned integers.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_number_parse_uint(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	static const struct {
+		const char *str;
+		cyaml_number_result_t result;
+		uint64_t expected;
+	} tests[] = {
+		{ "0", CYAML_NUMBER_OK, 0 },
+		{ "+7", CYAML_NUMBER_OK, 7 },
+		{ "0xffffffffffffffff", CYAML_NUMBER_OK, UINT64_MAX },
+		{ "18446744073709551615", CYAML_NUMBER_OK, UINT64_MAX },
+		{ "-1", CYAML_NUMBER_OK, UINT64_MAX },
+		{ "18446744073709551616", CYAML_NUMBER_RANGE, 0 },
+		{ "0x10000000000000000", CYAML_NUMBER_RANGE, 0 },
+		{ "0xg", CYAML_NUMBER_INVALID, 0 },
+		{ "7a", CYAML_NUMBER_INVALID, 0 },
+	};
+	ttest_ctx_t tc;
+
+	UNUSED(config);
+
+	if (!ttest_start(report, __func__, NULL, NULL, &tc)) {
+		return true;
+	}
+
+	for (unsigned i = 0; i < CYAML_ARRAY_LEN(tests); i++) {
+		cyaml_number_result_t result;
+		uint64_t value = 0;
+
+		result = cyaml__number_parse_uint(tests[i].str, &value);
+		if (result != tests[i].result) {
+			return ttest_fail(&tc, "Incorrect result for '%s': "
+					"expected: %u, got: %u", tests[i].str,
+					tests[i].result, result);
+		}
+		if (result == CYAML_NUMBER_OK && value != tests[i].expected) {
+			return ttest_fail(&tc, "Incorrect value for '%s'",
+					tests[i].str);
+		}
+	}
+
+	return ttest_pass(&tc);
+}
+
+/**
+ * Test parsing floating point values gives the same result as `strtod`.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_number_parse_double(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	static const struct {
+		const char *str;
+		cyaml_number_result_t result;
+	} tests[] = {
+		{ "0", CYAML_NUMBER_OK },
+		{ "-0.0", CYAML_NUMBER_OK },
+		{ "3.14", CYAML_NUMBER_OK },
+		{ ".5", CYAML_NUMBER_OK },
+		{ "5.", CYAML_NUMBER_OK },
+		{ "+1e10", CYAML_NUMBER_OK },
+		{ "1.5E-3", CYAML_NUMBER_OK },
+		{ "9007199254740993", CYAML_NUMBER_OK },
+		{ "0.1e-22", CYAML_NUMBER_OK },
+		{ "123456789012345678901234567890", CYAML_NUMBER_OK },
+		{ "2.2250738585072014e-308", CYAML_NUMBER_OK },
+		{ "1.7976931348623157e308", CYAML_NUMBER_OK },
+		{ "0x1p-2", CYAML_NUMBER_OK },
+		{ "inf", CYAML_NUMBER_OK },
+		{ "1e400", CYAML_NUMBER_RANGE },
+		{ "1e-400", CYAML_NUMBER_RANGE },
+		{ "", CYAML_NUMBER_INVALID },
+		{ ".", CYAML_NUMBER_INVALID },
+		{ "1e", CYAML_NUMBER_INVALID },
+		{ "1.0f", CYAML_NUMBER_INVALID },
+	};
+	char buffer[CYAML_NUMBER_STR_MAX];
+	uint64_t state = 0x2545f4914f6cdd1d;
+	ttest_ctx_t tc;
+
+	UNUSED(config);
+
+	if (!ttest_start(report, __func__, NULL, NULL, &tc)) {
+		return true;
+	}
+
+	for (unsigned i = 0; i < CYAML_ARRAY_LEN(tests); i++) {
+		cyaml_number_result_t result;
+		double value = 0;
+		double expected;
+
+		result = cyaml__number_parse_double(tests[i].str, &value);
+		if (result != tests[i].result) {
+			return ttest_fail(&tc, "Incorrect result for '%s': "
+					"expected: %u, got: %u", tests[i].str,
+					tests[i].result, result);
+		}
+
+		expected = strtod(tests[i].str, NULL);
+		if (result != CYAML_NUMBER_INVALID &&
+		    memcmp(&value, &expected, sizeof(value)) != 0) {
+			return ttest_fail(&tc, "Incorrect value for '%s': "
+					"expected: %a, got: %a", tests[i].str,
+					expected, value);
+		}
+	}
+
+	for (unsigned i = 0; i < 10000; i++) {
+		const char *str;
+		double value;
+		double d;
+
+		/* Xorshift, to get a spread of values with few digits. */
+		state ^= state << 13;
+		state ^= state >> 7;
+		state ^= state << 17;
+
+		d = (double)(int64_t)(state >> 40) / (double)(1 << (i % 24));
+		str = cyaml__number_format_double(d, buffer);
+
+		if (cyaml__number_parse_double(str, &value) !=
+				CYAML_NUMBER_OK || value != d) {
+			return ttest_fail(&tc, "Double %a read back "
+					"incorrectly from: %s", d, str);
+		}
+	}
+
+	return ttest_pass(&tc);
+}
+
+/**
+ * Run the CYAML number formatting and parsing unit tests.
+ *
+ * \param[in]  rc         The ttest report context.
+ * \param[in]  log_level  CYAML log level.
+ * \param[in]  log_fn     CYAML logging function, or NULL.
+ * \return true iff all unit tests pass, otherwise false.
+ */
+bool number_tests(
+		ttest_report_ctx_t *rc,
+		cyaml_log_t log_level,
+		cyaml_log_fn_t log_fn)
+{
+	bool pass = true;
+	cyaml_config_t config = {
+		.log_fn = log_fn,
+		.mem_fn = cyaml_mem,
+		.log_level = log_level,
+		.flags = CYAML_CFG_DEFAULT,
+	};
+
+	ttest_heading(rc, "Number tests");
+
+	pass &= test_number_format_int(rc, &config);
+	pass &= test_number_format_uint(rc, &config);
+	pass &= test_number_format_double(rc, &config);
+	pass &= test_number_format_float(rc, &config);
+	pass &= test_number_format_round_trip(rc, &config);
+	pass &= test_number_parse_int(rc, &config);
+	pass &= test_number_parse_uint(rc, &config);
+	pass &= test_number_parse_double(rc, &config);
+
+	return pass;
+}
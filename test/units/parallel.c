@@ -0,0 +1,627 @@
+/*
+ * SPDX-License-Identifier: ISC
+ *
+ * Copyright (C) 2026 Michael Drake <tlsa@netsurf-browser.org>
+ */
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <string.h>
+#include <stdio.h>
+
+#include <cyaml/cyaml.h>
+
+#include "ttest.h"
+#include "test.h"
+
+/** Macro to squash unused variable compiler warnings. */
+#define UNUSED(_x) ((void)(_x))
+
+#ifndef CYAML_STATS
+#define CYAML_STATS 1
+#endif
+
+/** Number of sequence entries in generated test documents. */
+#define TEST_PARALLEL_ENTRIES 20000
+
+/** Kinds of generated test document. */
+enum test_parallel_kind {
+	TEST_PARALLEL_PLAIN,  /**< Entries that split cleanly. */
+	TEST_PARALLEL_QUOTED, /**< Quoted scalars with entry-like lines. */
+	TEST_PARALLEL_ALIAS,  /**< Alias to an anchor in the first entry. */
+};
+
+/** Unit test context data. */
+typedef struct test_data {
+	char *yaml;
+	cyaml_data_t *serial;
+	cyaml_data_t *parallel;
+	cyaml_data_t *copy;
+	unsigned serial_count;
+	unsigned parallel_count;
+	/** Statistics, which count any chunks loaded or copied in parallel. */
+	cyaml_stats_t stats;
+	/** Number of validation callback calls. */
+	unsigned validated;
+	const struct cyaml_config *config;
+	const struct cyaml_schema_value *schema;
+} test_data_t;
+
+/** Test sequence entry mapping. */
+struct test_parallel_entry {
+	char *name;
+	int value;
+};
+
+/** Test sequence entry mapping schema. */
+static const struct cyaml_schema_field test_parallel_entry_schema[] = {
+	CYAML_FIELD_STRING_PTR("name", CYAML_FLAG_POINTER,
+			struct test_parallel_entry, name, 0, CYAML_UNLIMITED),
+	CYAML_FIELD_INT("value", CYAML_FLAG_DEFAULT,
+			struct test_parallel_entry, value),
+	CYAML_FIELD_END
+};
+
+/** Test sequence entry schema. */
+static const struct cyaml_schema_value test_parallel_entry_value = {
+	CYAML_VALUE_MAPPING(CYAML_FLAG_DEFAULT,
+			struct test_parallel_entry, test_parallel_entry_schema),
+};
+
+/** Test document top level schema. */
+static const struct cyaml_schema_value test_parallel_top_schema = {
+	CYAML_VALUE_SEQUENCE(CYAML_FLAG_POINTER,
+			struct test_parallel_entry, &test_parallel_entry_value,
+			0, CYAML_UNLIMITED),
+};
+
+/**
+ * Common clean up function to free data loaded by tests.
+ *
+ * \param[in]  data  The unit test context data.
+ */
+static void cyaml_cleanup(void *data)
+{
+	struct test_data *td = data;
+
+	cyaml_free(td->config, td->schema, td->serial, td->serial_count);
+	cyaml_free(td->config, td->schema, td->parallel, td->parallel_count);
+	cyaml_arena_free(td->config, td->copy);
+	free(td->yaml);
+}
+
+/**
+ * Generate a large test document with a top level sequence.
+ *
+ * \param[in]  kind  The kind of document to generate.
+ * \return the document, or NULL on failure.
+ */
+static char * test_parallel_yaml(
+		enum test_parallel_kind kind)
+{
+	size_t size = TEST_PARALLEL_ENTRIES * 64;
+	char *yaml = malloc(size);
+	size_t len = 0;
+
+	if (yaml == NULL) {
+		return NULL;
+	}
+
+	len += (size_t)sprintf(yaml + len, "# Generated.\n");
+	for (unsigned i = 0; i < TEST_PARALLEL_ENTRIES; i++) {
+		if (kind == TEST_PARALLEL_QUOTED) {
+			len += (size_t)sprintf(yaml + len,
+					"- name: \"entry\n- %u\"\n", i);
+		} else if (kind == TEST_PARALLEL_ALIAS && i == 0) {
+			len += (size_t)sprintf(yaml + len,
+					"- name: &first entry %u\n", i);
+		} else if (kind == TEST_PARALLEL_ALIAS &&
+		           i == TEST_PARALLEL_ENTRIES - 1) {
+			len += (size_t)sprintf(yaml + len,
+					"- name: *first\n");
+		} else {
+			len += (size_t)sprintf(yaml + len,
+					"- name: entry %u\n", i);
+		}
+		len += (size_t)sprintf(yaml + len, "  value: %u\n", i);
+		assert(len < size);
+	}
+
+	return yaml;
+}
+
+/**
+ * Check that a parallel load gives the same data as a serial load.
+ *
+ * \param[in]  td  The unit test context data.
+ * \return true if the loaded data matches, false otherwise.
+ */
+static bool test_parallel_compare(
+		const test_data_t *td)
+{
+	const struct test_parallel_entry *serial = td->serial;
+	const struct test_parallel_entry *parallel = td->parallel;
+
+	if (td->serial_count != td->parallel_count) {
+		return false;
+	}
+
+	for (unsigned i = 0; i < td->serial_count; i++) {
+		if (strcmp(serial[i].name, parallel[i].name) != 0 ||
+		    serial[i].value != parallel[i].value) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/**
+ * Load a generated document serially and in parallel.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \param[in]  name    Name of the test.
+ * \param[in]  kind    The kind of document to generate.
+ * \param[in]  split   Whether the load is expected to be split.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_parallel_load(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config,
+		const char *name,
+		enum test_parallel_kind kind,
+		bool split)
+{
+	cyaml_config_t cfg = *config;
+	test_data_t td = {
+		.config = config,
+		.schema = &test_parallel_top_schema,
+	};
+	cyaml_err_t err;
+	ttest_ctx_t tc;
+
+	if (!ttest_start(report, name, cyaml_cleanup, &td, &tc)) {
+		return true;
+	}
+
+	td.yaml = test_parallel_yaml(kind);
+	if (td.yaml == NULL) {
+		return ttest_fail(&tc, "Failed to generate document");
+	}
+
+	err = cyaml_load_data((const uint8_t *)td.yaml, strlen(td.yaml),
+			config, &test_parallel_top_schema,
+			&td.serial, &td.serial_count);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	cfg.flags |= CYAML_CFG_PARALLEL;
+	cfg.load_threads = 4;
+	cfg.stats = &td.stats;
+
+	err = cyaml_load_data((const uint8_t *)td.yaml, strlen(td.yaml),
+			&cfg, &test_parallel_top_schema,
+			&td.parallel, &td.parallel_count);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	if (CYAML_STATS && (td.stats.parallel_chunks != 0) != split) {
+		return ttest_fail(&tc, "Load was %ssplit",
+				split ? "not " : "");
+	}
+
+	if (td.serial_count != TEST_PARALLEL_ENTRIES) {
+		return ttest_fail(&tc, "Incorrect entry count: %u",
+				td.serial_count);
+	}
+
+	if (!test_parallel_compare(&td)) {
+		return ttest_fail(&tc, "Parallel load differs from serial");
+	}
+
+	return ttest_pass(&tc);
+}
+
+/**
+ * Test parallel loading of a document that splits cleanly.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_parallel_load_plain(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	return test_parallel_load(report, config, __func__,
+			TEST_PARALLEL_PLAIN, true);
+}
+
+/**
+ * Test parallel loading falls back for entry-like lines in quoted scalars.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_parallel_load_quoted(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	return test_parallel_load(report, config, __func__,
+			TEST_PARALLEL_QUOTED, false);
+}
+
+/**
+ * Test parallel loading falls back for aliases across chunks.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_parallel_load_alias(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	return test_parallel_load(report, config, __func__,
+			TEST_PARALLEL_ALIAS, false);
+}
+
+/**
+ * Test parallel loading isn't done for documents with document markers.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_parallel_load_marker(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	cyaml_config_t cfg = *config;
+	test_data_t td = {
+		.config = config,
+		.schema = &test_parallel_top_schema,
+	};
+	cyaml_err_t err;
+	ttest_ctx_t tc;
+
+	if (!ttest_start(report, __func__, cyaml_cleanup, &td, &tc)) {
+		return true;
+	}
+
+	td.yaml = test_parallel_yaml(TEST_PARALLEL_PLAIN);
+	if (td.yaml == NULL) {
+		return ttest_fail(&tc, "Failed to generate document");
+	}
+
+	/* Start the document with an explicit document start marker. */
+	memcpy(td.yaml, "--- #", 5);
+
+	cfg.flags |= CYAML_CFG_PARALLEL;
+	cfg.load_threads = 4;
+	cfg.stats = &td.stats;
+
+	err = cyaml_load_data((const uint8_t *)td.yaml, strlen(td.yaml),
+			&cfg, &test_parallel_top_schema,
+			&td.parallel, &td.parallel_count);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	if (CYAML_STATS && td.stats.parallel_chunks != 0) {
+		return ttest_fail(&tc, "Load was split");
+	}
+
+	if (td.parallel_count != TEST_PARALLEL_ENTRIES) {
+		return ttest_fail(&tc, "Incorrect entry count: %u",
+				td.parallel_count);
+	}
+
+	return ttest_pass(&tc);
+}
+
+/**
+ * Validation callback, which counts its calls.
+ *
+ * \param[in]  ctx     The unit test context data.
+ * \param[in]  schema  The schema for the value.
+ * \param[in]  value   The value to validate.
+ * \return true.
+ */
+static bool test_parallel_validate(
+		void *ctx,
+		const cyaml_schema_value_t *schema,
+		int64_t value)
+{
+	struct test_data *td = ctx;
+
+	UNUSED(schema);
+	UNUSED(value);
+
+	td->validated++;
+	return true;
+}
+
+/**
+ * Test parallel loading isn't done for entries with validation callbacks.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_parallel_load_validation(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	static const struct cyaml_schema_field entry_schema[] = {
+		CYAML_FIELD_STRING_PTR("name", CYAML_FLAG_POINTER,
+				struct test_parallel_entry, name,
+				0, CYAML_UNLIMITED),
+		CYAML_FIELD(INT, "value", CYAML_FLAG_DEFAULT,
+				struct test_parallel_entry, value, {
+					.validation_cb = test_parallel_validate,
+				}),
+		CYAML_FIELD_END
+	};
+	static const struct cyaml_schema_value entry_value = {
+		CYAML_VALUE_MAPPING(CYAML_FLAG_DEFAULT,
+				struct test_parallel_entry, entry_schema),
+	};
+	static const struct cyaml_schema_value schema = {
+		CYAML_VALUE_SEQUENCE(CYAML_FLAG_POINTER,
+				struct test_parallel_entry, &entry_value,
+				0, CYAML_UNLIMITED),
+	};
+	cyaml_schema_compiled_t *compiled = NULL;
+	cyaml_config_t cfg = *config;
+	test_data_t td = {
+		.config = config,
+		.schema = &schema,
+	};
+	cyaml_err_t err;
+	ttest_ctx_t tc;
+
+	if (!ttest_start(report, __func__, cyaml_cleanup, &td, &tc)) {
+		return true;
+	}
+
+	td.yaml = test_parallel_yaml(TEST_PARALLEL_PLAIN);
+	if (td.yaml == NULL) {
+		return ttest_fail(&tc, "Failed to generate document");
+	}
+
+	cfg.flags |= CYAML_CFG_PARALLEL;
+	cfg.load_threads = 4;
+	cfg.stats = &td.stats;
+	cfg.validation_ctx = &td;
+
+	for (unsigned i = 0; i < 2; i++) {
+		if (i == 1) {
+			err = cyaml_schema_compile(&cfg, &schema, &compiled);
+			if (err != CYAML_OK) {
+				return ttest_fail(&tc, cyaml_strerror(err));
+			}
+			cfg.compiled_schema = compiled;
+		}
+
+		td.validated = 0;
+		err = cyaml_load_data((const uint8_t *)td.yaml,
+				strlen(td.yaml), &cfg, &schema,
+				&td.parallel, &td.parallel_count);
+		cyaml_schema_compiled_free(&cfg, compiled);
+		cfg.compiled_schema = NULL;
+		if (err != CYAML_OK) {
+			return ttest_fail(&tc, cyaml_strerror(err));
+		}
+
+		if (CYAML_STATS && td.stats.parallel_chunks != 0) {
+			return ttest_fail(&tc, "Load %u was split", i);
+		}
+
+		if (td.validated != TEST_PARALLEL_ENTRIES) {
+			return ttest_fail(&tc, "Load %u validated %u entries",
+					i, td.validated);
+		}
+
+		cyaml_free(config, &schema, td.parallel, td.parallel_count);
+		td.parallel = NULL;
+		td.parallel_count = 0;
+	}
+
+	return ttest_pass(&tc);
+}
+
+/**
+ * Test parallel loading checks entry count limits for the whole sequence.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_parallel_load_entries_max(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	static const struct cyaml_schema_value schema = {
+		CYAML_VALUE_SEQUENCE(CYAML_FLAG_POINTER,
+				struct test_parallel_entry,
+				&test_parallel_entry_value,
+				0, TEST_PARALLEL_ENTRIES - 1),
+	};
+	cyaml_config_t cfg = *config;
+	test_data_t td = {
+		.config = config,
+		.schema = &schema,
+	};
+	cyaml_err_t err;
+	ttest_ctx_t tc;
+
+	if (!ttest_start(report, __func__, cyaml_cleanup, &td, &tc)) {
+		return true;
+	}
+
+	td.yaml = test_parallel_yaml(TEST_PARALLEL_PLAIN);
+	if (td.yaml == NULL) {
+		return ttest_fail(&tc, "Failed to generate document");
+	}
+
+	cfg.flags |= CYAML_CFG_PARALLEL;
+	cfg.load_threads = 4;
+
+	err = cyaml_load_data((const uint8_t *)td.yaml, strlen(td.yaml),
+			&cfg, &schema, &td.parallel, &td.parallel_count);
+	if (err != CYAML_ERR_SEQUENCE_ENTRIES_MAX) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	return ttest_pass(&tc);
+}
+
+/**
+ * Test copying a large sequence across threads.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_parallel_copy(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	struct target_struct {
+		char *title;
+		struct test_parallel_entry *entries;
+		unsigned entries_count;
+	} data = {
+		.title = (char *) "Parallel",
+	};
+	static const struct cyaml_schema_field mapping_schema[] = {
+		CYAML_FIELD_STRING_PTR("title", CYAML_FLAG_POINTER,
+				struct target_struct, title,
+				0, CYAML_UNLIMITED),
+		CYAML_FIELD_SEQUENCE("entries", CYAML_FLAG_POINTER,
+				struct target_struct, entries,
+				&test_parallel_entry_value,
+				0, CYAML_UNLIMITED),
+		CYAML_FIELD_END
+	};
+	static const struct cyaml_schema_value top_schema = {
+		CYAML_VALUE_MAPPING(CYAML_FLAG_POINTER,
+				struct target_struct, mapping_schema),
+	};
+	cyaml_config_t cfg = *config;
+	test_data_t td = {
+		.config = config,
+		.schema = &test_parallel_top_schema,
+	};
+	const struct test_parallel_entry *serial;
+	const struct target_struct *copy;
+	cyaml_err_t err;
+	ttest_ctx_t tc;
+
+	if (!ttest_start(report, __func__, cyaml_cleanup, &td, &tc)) {
+		return true;
+	}
+
+	td.yaml = test_parallel_yaml(TEST_PARALLEL_PLAIN);
+	if (td.yaml == NULL) {
+		return ttest_fail(&tc, "Failed to generate document");
+	}
+
+	err = cyaml_load_data((const uint8_t *)td.yaml, strlen(td.yaml),
+			config, &test_parallel_top_schema,
+			&td.serial, &td.serial_count);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	/* Copy the loaded sequence from a mapping field, so that it is
+	 * below the top level. */
+	data.entries = td.serial;
+	data.entries_count = td.serial_count;
+
+	cfg.flags |= CYAML_CFG_COPY_BLOCK | CYAML_CFG_PARALLEL;
+	cfg.load_threads = 4;
+	cfg.stats = &td.stats;
+
+	err = cyaml_copy(&cfg, &top_schema, &data, 0, &td.copy);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	if (CYAML_STATS && td.stats.parallel_chunks == 0) {
+		return ttest_fail(&tc, "Copy was not split");
+	}
+
+	copy = td.copy;
+	serial = td.serial;
+	if (strcmp(copy->title, data.title) != 0) {
+		return ttest_fail(&tc, "Incorrect value for title");
+	}
+	if (copy->entries_count != td.serial_count) {
+		return ttest_fail(&tc, "Incorrect entry count: %u",
+				copy->entries_count);
+	}
+	for (unsigned i = 0; i < td.serial_count; i++) {
+		if (strcmp(serial[i].name, copy->entries[i].name) != 0 ||
+		    serial[i].value != copy->entries[i].value ||
+		    serial[i].name == copy->entries[i].name) {
+			return ttest_fail(&tc, "Bad copy of entry %u", i);
+		}
+	}
+
+	return ttest_pass(&tc);
+}
+
+/**
+ * Run the CYAML parallel loading unit tests.
+ *
+ * \param[in]  rc         The ttest report context.
+ * \param[in]  log_level  CYAML log level.
+ * \param[in]  log_fn     CYAML logging function, or NULL.
+ * \return true iff all unit tests pass, otherwise false.
+ */
+bool parallel_tests(
+		ttest_report_ctx_t *rc,
+		cyaml_log_t log_level,
+		cyaml_log_fn_t log_fn)
+{
+	bool pass = true;
+	cyaml_config_t config = {
+		.log_fn = log_fn,
+		.mem_fn = cyaml_mem,
+		.log_level = log_level,
+		.flags = CYAML_CFG_DEFAULT,
+	};
+
+	ttest_heading(rc, "Parallel loading tests");
+
+	/* The serial loads of these large documents log a great deal. */
+	if (log_level < CYAML_LOG_INFO) {
+		config.log_level = CYAML_LOG_INFO;
+	}
+
+	pass &= test_parallel_load_plain(rc, &config);
+	pass &= test_parallel_load_quoted(rc, &config);
+	pass &= test_parallel_load_alias(rc, &config);
+	pass &= test_parallel_load_marker(rc, &config);
+	pass &= test_parallel_load_validation(rc, &config);
+	pass &= test_parallel_copy(rc, &config);
+
+	/* Since we expect error logging for these tests,
+	 * suppress log output if required log level is greater
+	 * than \ref CYAML_LOG_INFO.
+	 */
+	if (log_level > CYAML_LOG_INFO) {
+		config.log_fn = NULL;
+	}
+
+	pass &= test_parallel_load_entries_max(rc, &config);
+
+	return pass;
+}
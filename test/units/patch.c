@@ -0,0 +1,865 @@
+/*
+ * SPDX-License-Identifier: ISC
+ *
+ * Copyright (C) 2026 Michael Drake <tlsa@netsurf-browser.org>
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <assert.h>
+#include <string.h>
+#include <stdio.h>
+
+#include <cyaml/cyaml.h>
+
+#include "ttest.h"
+#include "test.h"
+
+/** Helper macro to count bytes of YAML input data. */
+#define YAML_LEN(_y) (sizeof(_y) - 1)
+
+/** Path of the file used by the file patching tests. */
+#define TEST_PATCH_FILE "build/patch.yaml"
+
+/**
+ * Unit test context data.
+ */
+typedef struct test_data {
+	cyaml_data_t **data;
+	cyaml_data_t **data2;
+	cyaml_patch_edit_t **edits;
+	unsigned *count;
+	char **buffer;
+	char **buffer2;
+	const struct cyaml_config *config;
+	const struct cyaml_schema_value *schema;
+} test_data_t;
+
+/**
+ * Common clean up function to free data used by tests.
+ *
+ * \param[in]  data  The unit test context data.
+ */
+static void cyaml_cleanup(void *data)
+{
+	struct test_data *td = data;
+
+	if (td->data != NULL) {
+		cyaml_free(td->config, td->schema, *(td->data), 0);
+	}
+
+	if (td->data2 != NULL) {
+		cyaml_free(td->config, td->schema, *(td->data2), 0);
+	}
+
+	if (td->edits != NULL) {
+		cyaml_free_patch(td->config, *(td->edits), *(td->count));
+	}
+
+	if (td->buffer != NULL) {
+		td->config->mem_fn(td->config->mem_ctx, *(td->buffer), 0);
+	}
+
+	if (td->buffer2 != NULL) {
+		td->config->mem_fn(td->config->mem_ctx, *(td->buffer2), 0);
+	}
+}
+
+/** Test document mode enumeration. */
+enum test_patch_mode {
+	TEST_PATCH_IDLE,
+	TEST_PATCH_BUSY,
+	TEST_PATCH_DONE,
+};
+
+/** Test document server structure. */
+struct test_patch_server {
+	char *host;
+	unsigned port;
+};
+
+/** Test document item structure. */
+struct test_patch_item {
+	char *label;
+	int size;
+};
+
+/** Test document structure. */
+struct test_patch_doc {
+	char *name;
+	char *note;
+	int level;
+	double ratio;
+	bool enabled;
+	enum test_patch_mode mode;
+	struct test_patch_server server;
+	struct test_patch_item *items;
+	unsigned items_count;
+	int *limit;
+};
+
+/** Test document mode names. */
+static const cyaml_strval_t test_patch_mode_strings[] = {
+	{ "idle", TEST_PATCH_IDLE },
+	{ "busy", TEST_PATCH_BUSY },
+	{ "done", TEST_PATCH_DONE },
+};
+
+/** Test document server mapping fields. */
+static const struct cyaml_schema_field test_patch_server_fields[] = {
+	CYAML_FIELD_STRING_PTR("host", CYAML_FLAG_POINTER,
+			struct test_patch_server, host, 0, CYAML_UNLIMITED),
+	CYAML_FIELD_UINT("port", CYAML_FLAG_DEFAULT,
+			struct test_patch_server, port),
+	CYAML_FIELD_END
+};
+
+/** Test document item mapping fields. */
+static const struct cyaml_schema_field test_patch_item_fields[] = {
+	CYAML_FIELD_STRING_PTR("label", CYAML_FLAG_POINTER,
+			struct test_patch_item, label, 0, CYAML_UNLIMITED),
+	CYAML_FIELD_INT("size", CYAML_FLAG_DEFAULT,
+			struct test_patch_item, size),
+	CYAML_FIELD_END
+};
+
+/** Test document item schema. */
+static const struct cyaml_schema_value test_patch_item_schema = {
+	CYAML_VALUE_MAPPING(CYAML_FLAG_DEFAULT,
+			struct test_patch_item, test_patch_item_fields),
+};
+
+/** Test document mapping fields. */
+static const struct cyaml_schema_field test_patch_fields[] = {
+	CYAML_FIELD_STRING_PTR("name", CYAML_FLAG_POINTER,
+			struct test_patch_doc, name, 0, CYAML_UNLIMITED),
+	CYAML_FIELD_STRING_PTR("note", CYAML_FLAG_POINTER,
+			struct test_patch_doc, note, 0, CYAML_UNLIMITED),
+	CYAML_FIELD_INT("level", CYAML_FLAG_DEFAULT,
+			struct test_patch_doc, level),
+	CYAML_FIELD_FLOAT("ratio", CYAML_FLAG_DEFAULT,
+			struct test_patch_doc, ratio),
+	CYAML_FIELD_BOOL("enabled", CYAML_FLAG_DEFAULT,
+			struct test_patch_doc, enabled),
+	CYAML_FIELD_ENUM("mode", CYAML_FLAG_DEFAULT,
+			struct test_patch_doc, mode, test_patch_mode_strings,
+			CYAML_ARRAY_LEN(test_patch_mode_strings)),
+	CYAML_FIELD_MAPPING("server", CYAML_FLAG_DEFAULT,
+			struct test_patch_doc, server,
+			test_patch_server_fields),
+	CYAML_FIELD_SEQUENCE("items", CYAML_FLAG_POINTER,
+			struct test_patch_doc, items,
+			&test_patch_item_schema, 0, CYAML_UNLIMITED),
+	CYAML_FIELD_INT_PTR("limit",
+			CYAML_FLAG_POINTER | CYAML_FLAG_OPTIONAL,
+			struct test_patch_doc, limit),
+	CYAML_FIELD_END
+};
+
+/** Test document schema. */
+static const struct cyaml_schema_value test_patch_schema = {
+	CYAML_VALUE_MAPPING(CYAML_FLAG_POINTER,
+			struct test_patch_doc, test_patch_fields),
+};
+
+/** Test document. */
+static const unsigned char test_patch_yaml[] =
+	"# R\xc3\xa9glages.\n"
+	"name: Fish\n"
+	"note: 'It''s here'\n"
+	"level: 3     # Current level.\n"
+	"ratio: 0.5\n"
+	"enabled: false\n"
+	"mode: idle\n"
+	"server:\n"
+	"  host: \"example.org\"\n"
+	"  port: 80\n"
+	"items:\n"
+	"- label: first\n"
+	"  size: 1\n"
+	"- { label: second, size: 2 }\n";
+
+/**
+ * Replace a string in loaded test data.
+ *
+ * \param[in]  config  The CYAML config the data was loaded with.
+ * \param[in]  str     The string member to replace.
+ * \param[in]  value   The new value.
+ * \return true on success, false on allocation failure.
+ */
+static bool test_patch_set_str(
+		const cyaml_config_t *config,
+		char **str,
+		const char *value)
+{
+	size_t len = strlen(value) + 1;
+	char *copy = config->mem_fn(config->mem_ctx, NULL, len);
+
+	if (copy == NULL) {
+		return false;
+	}
+	memcpy(copy, value, len);
+
+	config->mem_fn(config->mem_ctx, *str, 0);
+	*str = copy;
+	return true;
+}
+
+/**
+ * Apply edits to a copy of the test document.
+ *
+ * \param[in]  config  The CYAML config to allocate with.
+ * \param[in]  input   The document to apply the edits to.
+ * \param[in]  len     Length of input in bytes.
+ * \param[in]  edits   The edits to apply.
+ * \param[in]  count   The number of edits.
+ * \param[out] len_out Returns the length of the edited document.
+ * \return the edited document, or NULL on failure.
+ */
+static char *test_patch_apply(
+		const cyaml_config_t *config,
+		const unsigned char *input,
+		size_t len,
+		const cyaml_patch_edit_t *edits,
+		unsigned count,
+		size_t *len_out)
+{
+	size_t size = len;
+	size_t used = 0;
+	size_t pos = 0;
+	char *output;
+
+	for (unsigned i = 0; i < count; i++) {
+		size += edits[i].text_len;
+	}
+
+	output = config->mem_fn(config->mem_ctx, NULL, size + 1);
+	if (output == NULL) {
+		return NULL;
+	}
+
+	for (unsigned i = 0; i < count; i++) {
+		if (edits[i].offset < pos ||
+		    edits[i].offset + edits[i].len > len) {
+			config->mem_fn(config->mem_ctx, output, 0);
+			return NULL;
+		}
+		memcpy(output + used, input + pos, edits[i].offset - pos);
+		used += edits[i].offset - pos;
+		memcpy(output + used, edits[i].text, edits[i].text_len);
+		used += edits[i].text_len;
+		pos = edits[i].offset + edits[i].len;
+	}
+	memcpy(output + used, input + pos, len - pos);
+	used += len - pos;
+	output[used] = '\0';
+
+	*len_out = used;
+	return output;
+}
+
+/**
+ * Check that two documents save to the same YAML.
+ *
+ * \param[in]  td     The test context data.
+ * \param[in]  tc     The test case.
+ * \param[in]  data   The first document.
+ * \param[in]  data2  The second document.
+ * \return true if the documents match, false otherwise.
+ */
+static bool test_patch_match(
+		test_data_t *td,
+		const ttest_ctx_t *tc,
+		const cyaml_data_t *data,
+		const cyaml_data_t *data2)
+{
+	size_t len;
+	size_t len2;
+	cyaml_err_t err;
+
+	err = cyaml_save_data(td->buffer, &len, td->config, td->schema,
+			data, 0);
+	if (err != CYAML_OK) {
+		return ttest_fail(tc, cyaml_strerror(err));
+	}
+
+	err = cyaml_save_data(td->buffer2, &len2, td->config, td->schema,
+			data2, 0);
+	if (err != CYAML_OK) {
+		return ttest_fail(tc, cyaml_strerror(err));
+	}
+
+	if (len != len2 || memcmp(*(td->buffer), *(td->buffer2), len) != 0) {
+		return ttest_fail(tc, "Documents differ");
+	}
+
+	return true;
+}
+
+/**
+ * Test patching changed scalar values into a document.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_patch_scalars(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	static const char expected[] =
+		"# R\xc3\xa9glages.\n"
+		"name: \"Big: fish\"\n"
+		"note: 'It''s a \"test\"'\n"
+		"level: -12     # Current level.\n"
+		"ratio: 0.25\n"
+		"enabled: true\n"
+		"mode: done\n"
+		"server:\n"
+		"  host: \"\\\"quoted\\\"\\n\"\n"
+		"  port: 8080\n"
+		"items:\n"
+		"- label: first\n"
+		"  size: 1\n"
+		"- { label: \"x, y\", size: 2 }\n";
+	struct test_patch_doc *data = NULL;
+	struct test_patch_doc *prev = NULL;
+	cyaml_patch_edit_t *edits = NULL;
+	unsigned count = 0;
+	char *buffer = NULL;
+	char *buffer2 = NULL;
+	char *patched = NULL;
+	size_t len;
+	test_data_t td = {
+		.data = (cyaml_data_t **) &data,
+		.data2 = (cyaml_data_t **) &prev,
+		.edits = &edits,
+		.count = &count,
+		.buffer = &buffer,
+		.buffer2 = &buffer2,
+		.config = config,
+		.schema = &test_patch_schema,
+	};
+	cyaml_err_t err;
+	ttest_ctx_t tc;
+
+	if (!ttest_start(report, __func__, cyaml_cleanup, &td, &tc)) {
+		return true;
+	}
+
+	err = cyaml_load_data(test_patch_yaml, YAML_LEN(test_patch_yaml),
+			config, &test_patch_schema, (cyaml_data_t **) &prev,
+			NULL);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	err = cyaml_copy(config, &test_patch_schema, prev, 0,
+			(cyaml_data_t **) &data);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	data->level = -12;
+	data->ratio = 0.25;
+	data->enabled = true;
+	data->mode = TEST_PATCH_DONE;
+	data->server.port = 8080;
+	if (!test_patch_set_str(config, &data->name, "Big: fish") ||
+	    !test_patch_set_str(config, &data->note, "It's a \"test\"") ||
+	    !test_patch_set_str(config, &data->server.host,
+			"\"quoted\"\n") ||
+	    !test_patch_set_str(config, &data->items[1].label, "x, y")) {
+		return ttest_fail(&tc, "Allocation failed");
+	}
+
+	err = cyaml_save_patch(&edits, &count,
+			test_patch_yaml, YAML_LEN(test_patch_yaml),
+			config, &test_patch_schema, prev, data);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	if (count != 9) {
+		return ttest_fail(&tc, "Unexpected edit count: %u", count);
+	}
+
+	patched = test_patch_apply(config, test_patch_yaml,
+			YAML_LEN(test_patch_yaml), edits, count, &len);
+	if (patched == NULL) {
+		return ttest_fail(&tc, "Bad edits");
+	}
+	buffer = patched;
+
+	if (len != YAML_LEN(expected) ||
+	    memcmp(patched, expected, len) != 0) {
+		return ttest_fail(&tc, "Unexpected output:\n%s", patched);
+	}
+
+	cyaml_free(config, &test_patch_schema, prev, 0);
+	prev = NULL;
+	err = cyaml_load_data((const uint8_t *)patched, len,
+			config, &test_patch_schema, (cyaml_data_t **) &prev,
+			NULL);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+	config->mem_fn(config->mem_ctx, patched, 0);
+	buffer = NULL;
+
+	if (!test_patch_match(&td, &tc, data, prev)) {
+		return false;
+	}
+
+	return ttest_pass(&tc);
+}
+
+/**
+ * Test patching a document that hasn't changed.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_patch_unchanged(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	struct test_patch_doc *data = NULL;
+	struct test_patch_doc *prev = NULL;
+	cyaml_patch_edit_t *edits = NULL;
+	unsigned count = 1;
+	test_data_t td = {
+		.data = (cyaml_data_t **) &data,
+		.data2 = (cyaml_data_t **) &prev,
+		.edits = &edits,
+		.count = &count,
+		.config = config,
+		.schema = &test_patch_schema,
+	};
+	cyaml_err_t err;
+	ttest_ctx_t tc;
+
+	if (!ttest_start(report, __func__, cyaml_cleanup, &td, &tc)) {
+		return true;
+	}
+
+	err = cyaml_load_data(test_patch_yaml, YAML_LEN(test_patch_yaml),
+			config, &test_patch_schema, (cyaml_data_t **) &prev,
+			NULL);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	err = cyaml_copy(config, &test_patch_schema, prev, 0,
+			(cyaml_data_t **) &data);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	err = cyaml_save_patch(&edits, &count,
+			test_patch_yaml, YAML_LEN(test_patch_yaml),
+			config, &test_patch_schema, prev, data);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	if (edits != NULL || count != 0) {
+		return ttest_fail(&tc, "Unexpected edits");
+	}
+
+	return ttest_pass(&tc);
+}
+
+/**
+ * Read the file used by the file patching tests.
+ *
+ * \param[out] buffer  Buffer to read the file into.
+ * \param[in]  size    Size of buffer in bytes.
+ * \return the number of bytes read.
+ */
+static size_t test_patch_read_file(
+		char *buffer,
+		size_t size)
+{
+	FILE *file = fopen(TEST_PATCH_FILE, "rb");
+	size_t len;
+
+	if (file == NULL) {
+		return 0;
+	}
+
+	len = fread(buffer, 1, size - 1, file);
+	buffer[len] = '\0';
+	fclose(file);
+
+	return len;
+}
+
+/**
+ * Test patching a file.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_patch_file(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	static const char same_len[] =
+		"# R\xc3\xa9glages.\n"
+		"name: Fish\n"
+		"note: 'It''s here'\n"
+		"level: 7     # Current level.\n"
+		"ratio: 0.5\n"
+		"enabled: false\n"
+		"mode: idle\n"
+		"server:\n"
+		"  host: \"example.org\"\n"
+		"  port: 80\n"
+		"items:\n"
+		"- label: first\n"
+		"  size: 1\n"
+		"- { label: second, size: 2 }\n";
+	static const char shorter[] =
+		"# R\xc3\xa9glages.\n"
+		"name: Fish\n"
+		"note: 'It''s here'\n"
+		"level: 7     # Current level.\n"
+		"ratio: 0.5\n"
+		"enabled: false\n"
+		"mode: idle\n"
+		"server:\n"
+		"  host: \"a.b\"\n"
+		"  port: 80\n"
+		"items:\n"
+		"- label: first\n"
+		"  size: 1\n"
+		"- { label: 2nd, size: 2 }\n";
+	struct test_patch_doc *data = NULL;
+	struct test_patch_doc *prev = NULL;
+	char buffer[1024];
+	test_data_t td = {
+		.data = (cyaml_data_t **) &data,
+		.data2 = (cyaml_data_t **) &prev,
+		.config = config,
+		.schema = &test_patch_schema,
+	};
+	cyaml_err_t err;
+	ttest_ctx_t tc;
+	FILE *file;
+	size_t len;
+
+	if (!ttest_start(report, __func__, cyaml_cleanup, &td, &tc)) {
+		return true;
+	}
+
+	file = fopen(TEST_PATCH_FILE, "wb");
+	if (file == NULL) {
+		return ttest_fail(&tc, "Couldn't create file");
+	}
+	len = fwrite(test_patch_yaml, 1, YAML_LEN(test_patch_yaml), file);
+	fclose(file);
+	if (len != YAML_LEN(test_patch_yaml)) {
+		return ttest_fail(&tc, "Couldn't write file");
+	}
+
+	err = cyaml_load_file(TEST_PATCH_FILE, config, &test_patch_schema,
+			(cyaml_data_t **) &prev, NULL);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	err = cyaml_copy(config, &test_patch_schema, prev, 0,
+			(cyaml_data_t **) &data);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	data->level = 7;
+	err = cyaml_save_file_patch(TEST_PATCH_FILE, config,
+			&test_patch_schema, prev, data);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	len = test_patch_read_file(buffer, sizeof(buffer));
+	if (len != YAML_LEN(same_len) ||
+	    memcmp(buffer, same_len, len) != 0) {
+		return ttest_fail(&tc, "Unexpected output:\n%s", buffer);
+	}
+
+	cyaml_free(config, &test_patch_schema, prev, 0);
+	prev = NULL;
+	err = cyaml_load_file(TEST_PATCH_FILE, config, &test_patch_schema,
+			(cyaml_data_t **) &prev, NULL);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	if (!test_patch_set_str(config, &data->server.host, "a.b") ||
+	    !test_patch_set_str(config, &data->items[1].label, "2nd")) {
+		return ttest_fail(&tc, "Allocation failed");
+	}
+	err = cyaml_save_file_patch(TEST_PATCH_FILE, config,
+			&test_patch_schema, prev, data);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	len = test_patch_read_file(buffer, sizeof(buffer));
+	if (len != YAML_LEN(shorter) ||
+	    memcmp(buffer, shorter, len) != 0) {
+		return ttest_fail(&tc, "Unexpected output:\n%s", buffer);
+	}
+
+	return ttest_pass(&tc);
+}
+
+/**
+ * Test that changes which can't be patched are reported.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \param[in]  name    Name of the test.
+ * \param[in]  yaml    The YAML input.
+ * \param[in]  len     Length of yaml in bytes.
+ * \param[in]  change  The change to make to the loaded data.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_patch_err_change(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config,
+		const char *name,
+		const unsigned char *yaml,
+		size_t len,
+		void (*change)(struct test_patch_doc *doc))
+{
+	struct test_patch_doc *data = NULL;
+	struct test_patch_doc *prev = NULL;
+	cyaml_patch_edit_t *edits = NULL;
+	unsigned items_count;
+	unsigned count = 0;
+	test_data_t td = {
+		.data = (cyaml_data_t **) &data,
+		.data2 = (cyaml_data_t **) &prev,
+		.edits = &edits,
+		.count = &count,
+		.config = config,
+		.schema = &test_patch_schema,
+	};
+	cyaml_err_t err;
+	ttest_ctx_t tc;
+
+	if (!ttest_start(report, name, cyaml_cleanup, &td, &tc)) {
+		return true;
+	}
+
+	err = cyaml_load_data(yaml, len, config, &test_patch_schema,
+			(cyaml_data_t **) &prev, NULL);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	err = cyaml_copy(config, &test_patch_schema, prev, 0,
+			(cyaml_data_t **) &data);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	items_count = data->items_count;
+	change(data);
+
+	err = cyaml_save_patch(&edits, &count, yaml, len,
+			config, &test_patch_schema, prev, data);
+
+	/* Changed entry counts must be restored so the data is freed. */
+	data->items_count = items_count;
+	if (err != CYAML_ERR_PATCH_UNSUPPORTED) {
+		return ttest_fail(&tc, "Unexpected result: %s",
+				cyaml_strerror(err));
+	}
+
+	return ttest_pass(&tc);
+}
+
+/**
+ * Remove the last entry of the test document's items.
+ *
+ * \param[in]  doc  The document to change.
+ */
+static void test_patch_change_count(struct test_patch_doc *doc)
+{
+	doc->items_count--;
+}
+
+/**
+ * Change the test document's level.
+ *
+ * \param[in]  doc  The document to change.
+ */
+static void test_patch_change_level(struct test_patch_doc *doc)
+{
+	doc->level++;
+}
+
+/**
+ * Test patching a value that is missing from the input.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_patch_err_missing(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	struct test_patch_doc *data = NULL;
+	struct test_patch_doc *prev = NULL;
+	cyaml_patch_edit_t *edits = NULL;
+	unsigned count = 0;
+	int limit = 5;
+	test_data_t td = {
+		.data = (cyaml_data_t **) &data,
+		.data2 = (cyaml_data_t **) &prev,
+		.edits = &edits,
+		.count = &count,
+		.config = config,
+		.schema = &test_patch_schema,
+	};
+	cyaml_err_t err;
+	ttest_ctx_t tc;
+
+	if (!ttest_start(report, __func__, cyaml_cleanup, &td, &tc)) {
+		return true;
+	}
+
+	err = cyaml_load_data(test_patch_yaml, YAML_LEN(test_patch_yaml),
+			config, &test_patch_schema, (cyaml_data_t **) &prev,
+			NULL);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	err = cyaml_copy(config, &test_patch_schema, prev, 0,
+			(cyaml_data_t **) &data);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	data->limit = &limit;
+	err = cyaml_save_patch(&edits, &count,
+			test_patch_yaml, YAML_LEN(test_patch_yaml),
+			config, &test_patch_schema, prev, data);
+	data->limit = NULL;
+	if (err != CYAML_ERR_PATCH_UNSUPPORTED) {
+		return ttest_fail(&tc, "Unexpected result: %s",
+				cyaml_strerror(err));
+	}
+
+	return ttest_pass(&tc);
+}
+
+/**
+ * Test patching with a top level sequence.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_patch_err_top_level_sequence(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	static const unsigned char yaml[] = "- label: a\n  size: 1\n";
+	static const struct cyaml_schema_value schema = {
+		CYAML_VALUE_SEQUENCE(CYAML_FLAG_POINTER,
+				struct test_patch_item,
+				&test_patch_item_schema, 0, CYAML_UNLIMITED),
+	};
+	struct test_patch_item item = { .size = 1 };
+	cyaml_patch_edit_t *edits = NULL;
+	unsigned count = 0;
+	test_data_t td = {
+		.config = config,
+	};
+	cyaml_err_t err;
+	ttest_ctx_t tc;
+
+	if (!ttest_start(report, __func__, cyaml_cleanup, &td, &tc)) {
+		return true;
+	}
+
+	err = cyaml_save_patch(&edits, &count, yaml, YAML_LEN(yaml),
+			config, &schema, &item, &item);
+	if (err != CYAML_ERR_BAD_TYPE_IN_SCHEMA) {
+		return ttest_fail(&tc, "Unexpected result: %s",
+				cyaml_strerror(err));
+	}
+
+	return ttest_pass(&tc);
+}
+
+/**
+ * Run the CYAML patch unit tests.
+ *
+ * \param[in]  rc         The ttest report context.
+ * \param[in]  log_level  CYAML log level.
+ * \param[in]  log_fn     CYAML logging function, or NULL.
+ * \return true iff all unit tests pass, otherwise false.
+ */
+bool patch_tests(
+		ttest_report_ctx_t *rc,
+		cyaml_log_t log_level,
+		cyaml_log_fn_t log_fn)
+{
+	static const unsigned char aliased[] =
+		"name: Fish\n"
+		"note: x\n"
+		"level: &level 3\n"
+		"ratio: 0.5\n"
+		"enabled: false\n"
+		"mode: idle\n"
+		"server: { host: h, port: *level }\n"
+		"items: [ { label: a, size: 1 } ]\n";
+	static const unsigned char literal[] =
+		"name: Fish\n"
+		"note: x\n"
+		"level: >-\n"
+		"  3\n"
+		"ratio: 0.5\n"
+		"enabled: false\n"
+		"mode: idle\n"
+		"server: { host: h, port: 1 }\n"
+		"items: [ { label: a, size: 1 } ]\n";
+	bool pass = true;
+	cyaml_config_t config = {
+		.log_fn = log_fn,
+		.mem_fn = cyaml_mem,
+		.log_level = log_level,
+		.flags = CYAML_CFG_DEFAULT,
+	};
+
+	ttest_heading(rc, "Patch tests");
+
+	pass &= test_patch_scalars(rc, &config);
+	pass &= test_patch_unchanged(rc, &config);
+	pass &= test_patch_file(rc, &config);
+
+	ttest_heading(rc, "Patch error tests");
+
+	pass &= test_patch_err_change(rc, &config, "test_patch_err_count",
+			test_patch_yaml, YAML_LEN(test_patch_yaml),
+			test_patch_change_count);
+	pass &= test_patch_err_change(rc, &config, "test_patch_err_anchor",
+			aliased, YAML_LEN(aliased),
+			test_patch_change_level);
+	pass &= test_patch_err_change(rc, &config, "test_patch_err_block",
+			literal, YAML_LEN(literal),
+			test_patch_change_level);
+	pass &= test_patch_err_missing(rc, &config);
+	pass &= test_patch_err_top_level_sequence(rc, &config);
+
+	return pass;
+}
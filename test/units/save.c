@@ -174,7 +174,7 @@ static bool test_save_mapping_entry_double(
 {
 	static const unsigned char ref[] =
 		"---\n"
-		"test_float: 3.1400000000000001e+00\n"
+		"test_float: 3.14\n"
 		"...\n";
 	static const struct target_struct {
 		double test_float;
@@ -4420,6 +4420,217 @@ static bool test_save_no_document_delimiters(
 	return ttest_pass(&tc);
 }
 
+/** Client write context for saving to a write callback. */
+struct test_save_write_ctx {
+	char data[256]; /**< Written output. */
+	size_t len;     /**< Number of bytes written. */
+	cyaml_err_t err; /**< Error for the write callback to return. */
+};
+
+/**
+ * Client write callback, which writes to a \ref test_save_write_ctx.
+ *
+ * \param[in]  ctx   The client write context.
+ * \param[in]  data  The bytes to write.
+ * \param[in]  len   Number of bytes to write.
+ * \return \ref CYAML_OK on success, or appropriate error code otherwise.
+ */
+static cyaml_err_t test_save_write(
+		void *ctx,
+		const uint8_t *data,
+		size_t len)
+{
+	struct test_save_write_ctx *write_ctx = ctx;
+
+	if (write_ctx->err != CYAML_OK) {
+		return write_ctx->err;
+	}
+
+	if (len > sizeof(write_ctx->data) - write_ctx->len) {
+		return CYAML_ERR_OOM;
+	}
+
+	memcpy(write_ctx->data + write_ctx->len, data, len);
+	write_ctx->len += len;
+
+	return CYAML_OK;
+}
+
+/** Target structure for save output tests. */
+struct test_save_output {
+	unsigned test_uint;
+	const char *test_string;
+};
+
+/** Mapping schema for save output tests. */
+static const struct cyaml_schema_field test_save_output_schema[] = {
+	CYAML_FIELD_UINT("test_uint", CYAML_FLAG_DEFAULT,
+			struct test_save_output, test_uint),
+	CYAML_FIELD_STRING_PTR("test_string", CYAML_FLAG_POINTER,
+			struct test_save_output, test_string,
+			0, CYAML_UNLIMITED),
+	CYAML_FIELD_END
+};
+
+/** Top level schema for save output tests. */
+static const struct cyaml_schema_value test_save_output_top_schema = {
+	CYAML_VALUE_MAPPING(CYAML_FLAG_POINTER,
+			struct test_save_output, test_save_output_schema),
+};
+
+/**
+ * Test saving to a client write callback.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_save_stream(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	static const unsigned char ref[] =
+		"---\n"
+		"test_uint: 555\n"
+		"test_string: streamed\n"
+		"...\n";
+	static const struct test_save_output data = {
+		.test_uint = 555,
+		.test_string = "streamed",
+	};
+	struct test_save_write_ctx write_ctx = {
+		.err = CYAML_OK,
+	};
+	cyaml_err_t err;
+	ttest_ctx_t tc;
+
+	if (!ttest_start(report, __func__, NULL, NULL, &tc)) {
+		return true;
+	}
+
+	err = cyaml_save_stream(test_save_write, &write_ctx, config,
+			&test_save_output_top_schema, &data, 0);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	if (write_ctx.len != YAML_LEN(ref) ||
+	    memcmp(ref, write_ctx.data, write_ctx.len) != 0) {
+		return ttest_fail(&tc, "Bad data:\n"
+				"EXPECTED (%zu):\n\n%.*s\n\n"
+				"GOT (%zu):\n\n%.*s\n",
+				YAML_LEN(ref), YAML_LEN(ref), ref,
+				write_ctx.len, write_ctx.len, write_ctx.data);
+	}
+
+	return ttest_pass(&tc);
+}
+
+/**
+ * Test saving to a client write callback that fails.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_save_stream_write_error(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	static const struct test_save_output data = {
+		.test_uint = 555,
+		.test_string = "streamed",
+	};
+	struct test_save_write_ctx write_ctx = {
+		.err = CYAML_ERR_FILE_OPEN,
+	};
+	cyaml_err_t err;
+	ttest_ctx_t tc;
+
+	if (!ttest_start(report, __func__, NULL, NULL, &tc)) {
+		return true;
+	}
+
+	err = cyaml_save_stream(test_save_write, &write_ctx, config,
+			&test_save_output_top_schema, &data, 0);
+	if (err != CYAML_ERR_FILE_OPEN) {
+		return ttest_fail(&tc, "Unexpected: %s", cyaml_strerror(err));
+	}
+
+	err = cyaml_save_stream(NULL, &write_ctx, config,
+			&test_save_output_top_schema, &data, 0);
+	if (err != CYAML_ERR_BAD_PARAM_NULL_CALLBACK) {
+		return ttest_fail(&tc, "Unexpected: %s", cyaml_strerror(err));
+	}
+
+	return ttest_pass(&tc);
+}
+
+/**
+ * Test saving into memory gives the same output with any size hint.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_save_data_size_hint(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	static const size_t hints[] = { 0, 1, 16, 4096 };
+	static const struct test_save_output data = {
+		.test_uint = 555,
+		.test_string = "a string that is long enough to make the "
+				"saved output larger than the smaller hints",
+	};
+	struct test_save_write_ctx write_ctx = {
+		.err = CYAML_OK,
+	};
+	cyaml_config_t cfg = *config;
+	char *buffer = NULL;
+	size_t len;
+	test_data_t td = {
+		.buffer = &buffer,
+		.config = &cfg,
+	};
+	cyaml_err_t err;
+	ttest_ctx_t tc;
+
+	if (!ttest_start(report, __func__, cyaml_cleanup, &td, &tc)) {
+		return true;
+	}
+
+	err = cyaml_save_stream(test_save_write, &write_ctx, config,
+			&test_save_output_top_schema, &data, 0);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	for (unsigned i = 0; i < CYAML_ARRAY_LEN(hints); i++) {
+		cfg.save_size_hint = hints[i];
+
+		err = cyaml_save_data(&buffer, &len, &cfg,
+				&test_save_output_top_schema, &data, 0);
+		if (err != CYAML_OK) {
+			return ttest_fail(&tc, cyaml_strerror(err));
+		}
+
+		if (len != write_ctx.len ||
+		    memcmp(write_ctx.data, buffer, len) != 0) {
+			return ttest_fail(&tc, "Bad data for hint %zu:\n"
+					"EXPECTED (%zu):\n\n%.*s\n\n"
+					"GOT (%zu):\n\n%.*s\n", hints[i],
+					write_ctx.len, write_ctx.len,
+					write_ctx.data, len, len, buffer);
+		}
+
+		cfg.mem_fn(cfg.mem_ctx, buffer, 0);
+		buffer = NULL;
+	}
+
+	return ttest_pass(&tc);
+}
+
 /**
  * Run the YAML saving unit tests.
  *
@@ -4526,5 +4737,20 @@ bool save_tests(
 	pass &= test_save_sequence_config_block_style(rc, &config);
 	pass &= test_save_schema_top_level_sequence_fixed(rc, &config);
 
+	ttest_heading(rc, "Save output tests");
+
+	pass &= test_save_stream(rc, &config);
+	pass &= test_save_data_size_hint(rc, &config);
+
+	/* Since we expect error logging for these tests,
+	 * suppress log output if required log level is greater
+	 * than \ref CYAML_LOG_INFO.
+	 */
+	if (log_level > CYAML_LOG_INFO) {
+		config.log_fn = NULL;
+	}
+
+	pass &= test_save_stream_write_error(rc, &config);
+
 	return pass;
 }
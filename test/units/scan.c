@@ -0,0 +1,660 @@
+/*
+ * SPDX-License-Identifier: ISC
+ *
+ * Copyright (C) 2026 Michael Drake <tlsa@netsurf-browser.org>
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdarg.h>
+#include <assert.h>
+#include <string.h>
+#include <stdio.h>
+
+#include <cyaml/cyaml.h>
+
+#include "ttest.h"
+#include "test.h"
+
+/** Macro to squash unused variable compiler warnings. */
+#define UNUSED(_x) ((void)(_x))
+
+/** Helper macro to count bytes of YAML input data. */
+#define YAML_LEN(_y) (sizeof(_y) - 1)
+
+#ifndef CYAML_LOG_MIN_LEVEL
+#define CYAML_LOG_MIN_LEVEL CYAML_LOG_DEBUG
+#endif
+
+#ifndef CYAML_STATS
+#define CYAML_STATS 1
+#endif
+
+/**
+ * Whether falling back to libyaml can be seen, from the library's debug
+ * logging.
+ *
+ * Checks of which parser was used are skipped when debug logging is
+ * compiled out of the library.
+ */
+#define TEST_SCAN_LOGGED (CYAML_LOG_MIN_LEVEL <= CYAML_LOG_DEBUG)
+
+/**
+ * Unit test context data.
+ */
+typedef struct test_data {
+	cyaml_data_t **data;
+	cyaml_data_t **other;
+	const struct cyaml_config *config;
+	const struct cyaml_schema_value *schema;
+	bool fallback;
+} test_data_t;
+
+/**
+ * Common clean up function to free data loaded by tests.
+ *
+ * \param[in]  data  The unit test context data.
+ */
+static void cyaml_cleanup(void *data)
+{
+	struct test_data *td = data;
+
+	if (td->data != NULL) {
+		cyaml_free(td->config, td->schema, *(td->data), 0);
+	}
+
+	if (td->other != NULL) {
+		cyaml_free(td->config, td->schema, *(td->other), 0);
+	}
+}
+
+/**
+ * Log function that notes whether a load fell back to libyaml.
+ *
+ * \param[in]  level  Log level of message.
+ * \param[in]  ctx    The unit test context data.
+ * \param[in]  fmt    Format string for message.
+ * \param[in]  args   Format string arguments.
+ */
+static void test_scan_log(
+		cyaml_log_t level,
+		void *ctx,
+		const char *fmt,
+		va_list args)
+{
+	struct test_data *td = ctx;
+
+	UNUSED(level);
+	UNUSED(args);
+
+	if (strstr(fmt, "Native scanner") != NULL) {
+		td->fallback = true;
+	}
+}
+
+/** Test document point structure. */
+struct test_scan_point {
+	int x;
+	int y;
+};
+
+/** Test document structure. */
+struct test_scan_doc {
+	char *name;
+	char *quoted;
+	int count;
+	bool enabled;
+	struct test_scan_point origin;
+	int *values;
+	unsigned values_count;
+	char **tags;
+	unsigned tags_count;
+	struct test_scan_point *points;
+	unsigned points_count;
+};
+
+/** Test document point mapping fields. */
+static const struct cyaml_schema_field test_scan_point_fields[] = {
+	CYAML_FIELD_INT("x", CYAML_FLAG_DEFAULT, struct test_scan_point, x),
+	CYAML_FIELD_INT("y", CYAML_FLAG_DEFAULT, struct test_scan_point, y),
+	CYAML_FIELD_END
+};
+
+/** Test document point schema. */
+static const struct cyaml_schema_value test_scan_point_schema = {
+	CYAML_VALUE_MAPPING(CYAML_FLAG_DEFAULT,
+			struct test_scan_point, test_scan_point_fields),
+};
+
+/** Test document value schema. */
+static const struct cyaml_schema_value test_scan_value_schema = {
+	CYAML_VALUE_INT(CYAML_FLAG_DEFAULT, int),
+};
+
+/** Test document tag schema. */
+static const struct cyaml_schema_value test_scan_tag_schema = {
+	CYAML_VALUE_STRING(CYAML_FLAG_POINTER, char, 0, CYAML_UNLIMITED),
+};
+
+/** Test document mapping fields. */
+static const struct cyaml_schema_field test_scan_fields[] = {
+	CYAML_FIELD_STRING_PTR("name", CYAML_FLAG_POINTER,
+			struct test_scan_doc, name, 0, CYAML_UNLIMITED),
+	CYAML_FIELD_STRING_PTR("quoted", CYAML_FLAG_POINTER,
+			struct test_scan_doc, quoted, 0, CYAML_UNLIMITED),
+	CYAML_FIELD_INT("count", CYAML_FLAG_DEFAULT,
+			struct test_scan_doc, count),
+	CYAML_FIELD_BOOL("enabled", CYAML_FLAG_DEFAULT,
+			struct test_scan_doc, enabled),
+	CYAML_FIELD_MAPPING("origin", CYAML_FLAG_DEFAULT,
+			struct test_scan_doc, origin, test_scan_point_fields),
+	CYAML_FIELD_SEQUENCE("values", CYAML_FLAG_POINTER,
+			struct test_scan_doc, values,
+			&test_scan_value_schema, 0, CYAML_UNLIMITED),
+	CYAML_FIELD_SEQUENCE("tags", CYAML_FLAG_POINTER,
+			struct test_scan_doc, tags,
+			&test_scan_tag_schema, 0, CYAML_UNLIMITED),
+	CYAML_FIELD_SEQUENCE("points", CYAML_FLAG_POINTER,
+			struct test_scan_doc, points,
+			&test_scan_point_schema, 0, CYAML_UNLIMITED),
+	CYAML_FIELD_END
+};
+
+/** Test document schema. */
+static const struct cyaml_schema_value test_scan_schema = {
+	CYAML_VALUE_MAPPING(CYAML_FLAG_POINTER,
+			struct test_scan_doc, test_scan_fields),
+};
+
+/** Test document the native scanner can handle. */
+static const unsigned char test_scan_yaml[] =
+	"\xef\xbb\xbf# Leading comment\r\n"
+	"---\r\n"
+	"name: plain  value  # Trailing comment\r\n"
+	"quoted: \"tab\\there \\u00e9\"\r\n"
+	"count: -12\r\n"
+	"enabled: true\r\n"
+	"\r\n"
+	"origin:\r\n"
+	"  # Indented comment\r\n"
+	"  x: 1\r\n"
+	"  'y':   2\r\n"
+	"values:\r\n"
+	"- 1\r\n"
+	"-   2\r\n"
+	"- 3\r\n"
+	"tags: ['it''s', \"b\", c d, ]\r\n"
+	"points:\r\n"
+	"  - x: 3\r\n"
+	"    y: 4\r\n"
+	"  - {x: 5, \"y\": 6}\r\n"
+	"  -\r\n"
+	"    x: 7\r\n"
+	"    y: 8\r\n";
+
+/** Test document the native scanner must give to libyaml. */
+static const unsigned char test_scan_fallback_yaml[] =
+	"name: &n hello\n"
+	"quoted: |\n"
+	"  tab\there \xc3\xa9\n"
+	"count: -12\n"
+	"enabled: true\n"
+	"origin: { x: 1,\n"
+	"          y: 2 }\n"
+	"values: [ 1, 2, 3 ]\n"
+	"tags:\n"
+	"  - it's\n"
+	"  - *n\n"
+	"points: []\n";
+
+/**
+ * Check a loaded test document.
+ *
+ * \param[in]  doc     The loaded document.
+ * \param[in]  quoted  The expected `quoted` string.
+ * \return true if the document is as expected, false otherwise.
+ */
+static bool test_scan_check_doc(
+		const struct test_scan_doc *doc,
+		const char *quoted)
+{
+	if (strcmp(doc->name, "plain  value") != 0 ||
+	    strcmp(doc->quoted, quoted) != 0 ||
+	    doc->count != -12 || doc->enabled != true ||
+	    doc->origin.x != 1 || doc->origin.y != 2) {
+		return false;
+	}
+
+	if (doc->values_count != 3 || doc->values[0] != 1 ||
+	    doc->values[1] != 2 || doc->values[2] != 3) {
+		return false;
+	}
+
+	if (doc->tags_count != 3 || strcmp(doc->tags[0], "it's") != 0 ||
+	    strcmp(doc->tags[1], "b") != 0 ||
+	    strcmp(doc->tags[2], "c d") != 0) {
+		return false;
+	}
+
+	if (doc->points_count != 3) {
+		return false;
+	}
+	for (unsigned i = 0; i < doc->points_count; i++) {
+		if (doc->points[i].x != (int)(i * 2 + 3) ||
+		    doc->points[i].y != (int)(i * 2 + 4)) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/**
+ * Test loading a document with the native scanner.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_scan_load(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	struct test_scan_doc *data_tgt = NULL;
+	cyaml_config_t cfg = *config;
+	test_data_t td = {
+		.data = (cyaml_data_t **) &data_tgt,
+		.config = config,
+		.schema = &test_scan_schema,
+	};
+	cyaml_err_t err;
+	ttest_ctx_t tc;
+
+	if (!ttest_start(report, __func__, cyaml_cleanup, &td, &tc)) {
+		return true;
+	}
+
+	cfg.flags |= CYAML_CFG_NATIVE_SCANNER;
+	cfg.log_fn = test_scan_log;
+	cfg.log_ctx = &td;
+	cfg.log_level = CYAML_LOG_DEBUG;
+
+	err = cyaml_load_data(test_scan_yaml, YAML_LEN(test_scan_yaml),
+			&cfg, &test_scan_schema,
+			(cyaml_data_t **) &data_tgt, NULL);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	if (TEST_SCAN_LOGGED && td.fallback) {
+		return ttest_fail(&tc, "Load fell back to libyaml");
+	}
+
+	if (!test_scan_check_doc(data_tgt, "tab\there \xc3\xa9")) {
+		return ttest_fail(&tc, "Incorrect value");
+	}
+
+	return ttest_pass(&tc);
+}
+
+/**
+ * Test loading a document the native scanner can't handle.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_scan_load_fallback(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	struct test_scan_doc *data_tgt = NULL;
+	cyaml_config_t cfg = *config;
+	test_data_t td = {
+		.data = (cyaml_data_t **) &data_tgt,
+		.config = config,
+		.schema = &test_scan_schema,
+	};
+	cyaml_err_t err;
+	ttest_ctx_t tc;
+
+	if (!ttest_start(report, __func__, cyaml_cleanup, &td, &tc)) {
+		return true;
+	}
+
+	cfg.flags |= CYAML_CFG_NATIVE_SCANNER;
+	cfg.log_fn = test_scan_log;
+	cfg.log_ctx = &td;
+	cfg.log_level = CYAML_LOG_DEBUG;
+
+	err = cyaml_load_data(test_scan_fallback_yaml,
+			YAML_LEN(test_scan_fallback_yaml),
+			&cfg, &test_scan_schema,
+			(cyaml_data_t **) &data_tgt, NULL);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	if (TEST_SCAN_LOGGED && !td.fallback) {
+		return ttest_fail(&tc, "Load didn't fall back to libyaml");
+	}
+
+	if (strcmp(data_tgt->name, "hello") != 0 ||
+	    strcmp(data_tgt->quoted, "tab\there \xc3\xa9\n") != 0 ||
+	    data_tgt->origin.y != 2 || data_tgt->values_count != 3 ||
+	    data_tgt->tags_count != 2 ||
+	    strcmp(data_tgt->tags[1], "hello") != 0 ||
+	    data_tgt->points_count != 0) {
+		return ttest_fail(&tc, "Incorrect value");
+	}
+
+	return ttest_pass(&tc);
+}
+
+/**
+ * Test the native scanner gives the same events as libyaml.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_scan_load_events(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	struct test_scan_doc *data_tgt = NULL;
+	struct test_scan_doc *other_tgt = NULL;
+	cyaml_config_t cfg = *config;
+	cyaml_stats_t native = { 0 };
+	cyaml_stats_t libyaml = { 0 };
+	test_data_t td = {
+		.data = (cyaml_data_t **) &data_tgt,
+		.other = (cyaml_data_t **) &other_tgt,
+		.config = config,
+		.schema = &test_scan_schema,
+	};
+	cyaml_err_t err;
+	ttest_ctx_t tc;
+
+	if (!ttest_start(report, __func__, cyaml_cleanup, &td, &tc)) {
+		return true;
+	}
+
+	cfg.stats = &libyaml;
+	err = cyaml_load_data(test_scan_yaml, YAML_LEN(test_scan_yaml),
+			&cfg, &test_scan_schema,
+			(cyaml_data_t **) &other_tgt, NULL);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	cfg.stats = &native;
+	cfg.flags |= CYAML_CFG_NATIVE_SCANNER;
+	err = cyaml_load_data(test_scan_yaml, YAML_LEN(test_scan_yaml),
+			&cfg, &test_scan_schema,
+			(cyaml_data_t **) &data_tgt, NULL);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	if (!test_scan_check_doc(data_tgt, "tab\there \xc3\xa9") ||
+	    !test_scan_check_doc(other_tgt, "tab\there \xc3\xa9")) {
+		return ttest_fail(&tc, "Native load differs from libyaml");
+	}
+
+	if (CYAML_STATS && memcmp(native.events, libyaml.events,
+			sizeof(native.events)) != 0) {
+		return ttest_fail(&tc, "Event counts differ from libyaml");
+	}
+
+	return ttest_pass(&tc);
+}
+
+/**
+ * Test loading invalid YAML with the native scanner.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_scan_err_load_invalid(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	static const unsigned char yaml[] =
+		"count: 1\n"
+		"name: 'unterminated\n";
+	struct test_scan_doc *data_tgt = NULL;
+	cyaml_config_t cfg = *config;
+	test_data_t td = {
+		.data = (cyaml_data_t **) &data_tgt,
+		.config = config,
+		.schema = &test_scan_schema,
+	};
+	cyaml_err_t err;
+	ttest_ctx_t tc;
+
+	if (!ttest_start(report, __func__, cyaml_cleanup, &td, &tc)) {
+		return true;
+	}
+
+	cfg.flags |= CYAML_CFG_NATIVE_SCANNER;
+
+	err = cyaml_load_data(yaml, YAML_LEN(yaml), &cfg, &test_scan_schema,
+			(cyaml_data_t **) &data_tgt, NULL);
+	if (err != CYAML_ERR_LIBYAML_PARSER) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	if (data_tgt != NULL) {
+		return ttest_fail(&tc, "Data non-NULL on error.");
+	}
+
+	return ttest_pass(&tc);
+}
+
+/**
+ * Test loading YAML with an invalid key with the native scanner.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_scan_err_load_invalid_key(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	static const unsigned char yaml[] =
+		"name: hello\n"
+		"unknown: [ 1, 2 ]\n";
+	struct test_scan_doc *data_tgt = NULL;
+	cyaml_config_t cfg = *config;
+	test_data_t td = {
+		.data = (cyaml_data_t **) &data_tgt,
+		.config = config,
+		.schema = &test_scan_schema,
+	};
+	cyaml_err_t err;
+	ttest_ctx_t tc;
+
+	if (!ttest_start(report, __func__, cyaml_cleanup, &td, &tc)) {
+		return true;
+	}
+
+	cfg.flags |= CYAML_CFG_NATIVE_SCANNER;
+
+	err = cyaml_load_data(yaml, YAML_LEN(yaml), &cfg, &test_scan_schema,
+			(cyaml_data_t **) &data_tgt, NULL);
+	if (err != CYAML_ERR_INVALID_KEY) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	if (data_tgt != NULL) {
+		return ttest_fail(&tc, "Data non-NULL on error.");
+	}
+
+	return ttest_pass(&tc);
+}
+
+/** Error log recorded by \ref test_scan_log_errors. */
+struct test_scan_errors {
+	char log[1024]; /**< Error messages, concatenated. */
+	size_t len;     /**< Length of the recorded messages. */
+	bool fallback;  /**< Whether the load fell back to libyaml. */
+};
+
+/**
+ * Log function that records error messages.
+ *
+ * \param[in]  level  Log level of message.
+ * \param[in]  ctx    The error log to record to.
+ * \param[in]  fmt    Format string for message.
+ * \param[in]  args   Format string arguments.
+ */
+static void test_scan_log_errors(
+		cyaml_log_t level,
+		void *ctx,
+		const char *fmt,
+		va_list args)
+{
+	struct test_scan_errors *errors = ctx;
+	int len;
+
+	if (strstr(fmt, "Native scanner") != NULL) {
+		errors->fallback = true;
+	}
+
+	if (level < CYAML_LOG_ERROR || errors->len >= sizeof(errors->log)) {
+		return;
+	}
+
+	len = vsnprintf(errors->log + errors->len,
+			sizeof(errors->log) - errors->len, fmt, args);
+	if (len > 0) {
+		errors->len += (size_t)len;
+	}
+}
+
+/**
+ * Test the native scanner reports errors at the same positions as libyaml.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_scan_err_load_positions(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	static const char * const docs[] = {
+		"name: x\n"
+		"points:\n"
+		"  - x: 1\n"
+		"    y: bad\n",
+
+		"---\n"
+		"values:\n"
+		"- 1\n"
+		"-\n",
+
+		"origin:\n"
+		"count: 1\n",
+
+		"name: \xc3\xa9\xc3\xa9\n"
+		"points: [ {x: 1}, { \xc3\xa9: 2 } ]\n",
+
+		"tags: [a, b]\n"
+		"origin: {x: 1, y: q}",
+	};
+	struct test_scan_doc *data_tgt = NULL;
+	cyaml_config_t cfg = *config;
+	test_data_t td = {
+		.data = (cyaml_data_t **) &data_tgt,
+		.config = config,
+		.schema = &test_scan_schema,
+	};
+	ttest_ctx_t tc;
+
+	if (!ttest_start(report, __func__, cyaml_cleanup, &td, &tc)) {
+		return true;
+	}
+
+	cfg.log_fn = test_scan_log_errors;
+	cfg.log_level = CYAML_LOG_DEBUG;
+
+	for (unsigned i = 0; i < CYAML_ARRAY_LEN(docs); i++) {
+		struct test_scan_errors native = { .len = 0 };
+		struct test_scan_errors libyaml = { .len = 0 };
+		const uint8_t *yaml = (const uint8_t *)docs[i];
+		cyaml_err_t err_native;
+		cyaml_err_t err_libyaml;
+
+		cfg.flags = config->flags;
+		cfg.log_ctx = &libyaml;
+		err_libyaml = cyaml_load_data(yaml, strlen(docs[i]), &cfg,
+				&test_scan_schema,
+				(cyaml_data_t **) &data_tgt, NULL);
+
+		cfg.flags |= CYAML_CFG_NATIVE_SCANNER;
+		cfg.log_ctx = &native;
+		err_native = cyaml_load_data(yaml, strlen(docs[i]), &cfg,
+				&test_scan_schema,
+				(cyaml_data_t **) &data_tgt, NULL);
+
+		if (err_libyaml == CYAML_OK || err_native != err_libyaml) {
+			return ttest_fail(&tc, "Document %u: %s / %s", i,
+					cyaml_strerror(err_native),
+					cyaml_strerror(err_libyaml));
+		}
+
+		if (TEST_SCAN_LOGGED && native.fallback) {
+			return ttest_fail(&tc, "Document %u fell back", i);
+		}
+
+		if (native.len != libyaml.len ||
+		    memcmp(native.log, libyaml.log, native.len) != 0) {
+			return ttest_fail(&tc, "Document %u errors differ:\n"
+					"NATIVE:\n%.*s\nLIBYAML:\n%.*s", i,
+					(int)native.len, native.log,
+					(int)libyaml.len, libyaml.log);
+		}
+	}
+
+	return ttest_pass(&tc);
+}
+
+/**
+ * Run the CYAML native scanner unit tests.
+ *
+ * \param[in]  rc         The ttest report context.
+ * \param[in]  log_level  CYAML log level.
+ * \param[in]  log_fn     CYAML logging function, or NULL.
+ * \return true iff all unit tests pass, otherwise false.
+ */
+bool scan_tests(
+		ttest_report_ctx_t *rc,
+		cyaml_log_t log_level,
+		cyaml_log_fn_t log_fn)
+{
+	bool pass = true;
+	cyaml_config_t config = {
+		.log_fn = log_fn,
+		.mem_fn = cyaml_mem,
+		.log_level = log_level,
+		.flags = CYAML_CFG_DEFAULT,
+	};
+
+	ttest_heading(rc, "Native scanner tests");
+
+	pass &= test_scan_load(rc, &config);
+	pass &= test_scan_load_fallback(rc, &config);
+	pass &= test_scan_load_events(rc, &config);
+
+	ttest_heading(rc, "Native scanner error tests");
+
+	pass &= test_scan_err_load_invalid(rc, &config);
+	pass &= test_scan_err_load_invalid_key(rc, &config);
+	pass &= test_scan_err_load_positions(rc, &config);
+
+	return pass;
+}
@@ -0,0 +1,1093 @@
+/*
+ * SPDX-License-Identifier: ISC
+ *
+ * Copyright (C) 2026 Michael Drake <tlsa@netsurf-browser.org>
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <assert.h>
+#include <string.h>
+#include <stdio.h>
+
+#include <cyaml/cyaml.h>
+
+#include "ttest.h"
+#include "test.h"
+
+/** Helper macro to count bytes of YAML input data. */
+#define YAML_LEN(_y) (sizeof(_y) - 1)
+
+/**
+ * Unit test context data.
+ */
+typedef struct test_data {
+	cyaml_data_t **data;
+	cyaml_data_t **copy;
+	char **buffer;
+	cyaml_schema_compiled_t **compiled;
+	const struct cyaml_config *config;
+	const struct cyaml_schema_value *schema;
+} test_data_t;
+
+/**
+ * Common clean up function to free data and compiled schemas used by tests.
+ *
+ * \param[in]  data  The unit test context data.
+ */
+static void cyaml_cleanup(void *data)
+{
+	struct test_data *td = data;
+
+	if (td->data != NULL) {
+		cyaml_free(td->config, td->schema, *(td->data), 0);
+	}
+
+	if (td->copy != NULL) {
+		cyaml_free(td->config, td->schema, *(td->copy), 0);
+	}
+
+	if (td->buffer != NULL) {
+		td->config->mem_fn(td->config->mem_ctx, *(td->buffer), 0);
+	}
+
+	if (td->compiled != NULL) {
+		cyaml_schema_compiled_free(td->config, *(td->compiled));
+	}
+}
+
+/**
+ * Test compiling a schema with bad parameters.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_schema_compile_bad_params(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	struct target_struct {
+		int value;
+	};
+	static const struct cyaml_schema_field mapping_schema[] = {
+		CYAML_FIELD_INT("value", CYAML_FLAG_DEFAULT,
+				struct target_struct, value),
+		CYAML_FIELD_END
+	};
+	static const struct cyaml_schema_value top_schema = {
+		CYAML_VALUE_MAPPING(CYAML_FLAG_POINTER,
+				struct target_struct, mapping_schema),
+	};
+	cyaml_schema_compiled_t *compiled = NULL;
+	cyaml_config_t cfg = *config;
+	test_data_t td = {
+		.compiled = &compiled,
+		.config = config,
+	};
+	cyaml_err_t err;
+	ttest_ctx_t tc;
+
+	if (!ttest_start(report, __func__, cyaml_cleanup, &td, &tc)) {
+		return true;
+	}
+
+	err = cyaml_schema_compile(NULL, &top_schema, &compiled);
+	if (err != CYAML_ERR_BAD_PARAM_NULL_CONFIG) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	cfg.mem_fn = NULL;
+	err = cyaml_schema_compile(&cfg, &top_schema, &compiled);
+	if (err != CYAML_ERR_BAD_CONFIG_NULL_MEMFN) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	err = cyaml_schema_compile(config, NULL, &compiled);
+	if (err != CYAML_ERR_BAD_PARAM_NULL_SCHEMA) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	err = cyaml_schema_compile(config, &top_schema, NULL);
+	if (err != CYAML_ERR_BAD_PARAM_NULL_DATA) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	if (compiled != NULL) {
+		return ttest_fail(&tc, "Compiled schema set on failure");
+	}
+
+	return ttest_pass(&tc);
+}
+
+/**
+ * Test loading a mapping with many fields, using a compiled schema.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_schema_load_mapping(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	struct target_struct {
+		int a, b, c, d, e, f, g, h;
+		char *name;
+	} *data_tgt = NULL;
+	static const unsigned char yaml[] =
+		"h: 8\n"
+		"name: cyaml\n"
+		"c: 3\n"
+		"a: 1\n"
+		"g: 7\n"
+		"e: 5\n"
+		"b: 2\n"
+		"f: 6\n"
+		"d: 4\n";
+	static const struct cyaml_schema_field mapping_schema[] = {
+		CYAML_FIELD_INT("g", CYAML_FLAG_DEFAULT,
+				struct target_struct, g),
+		CYAML_FIELD_INT("b", CYAML_FLAG_DEFAULT,
+				struct target_struct, b),
+		CYAML_FIELD_INT("h", CYAML_FLAG_DEFAULT,
+				struct target_struct, h),
+		CYAML_FIELD_STRING_PTR("name", CYAML_FLAG_POINTER,
+				struct target_struct, name,
+				0, CYAML_UNLIMITED),
+		CYAML_FIELD_INT("a", CYAML_FLAG_DEFAULT,
+				struct target_struct, a),
+		CYAML_FIELD_INT("f", CYAML_FLAG_DEFAULT,
+				struct target_struct, f),
+		CYAML_FIELD_INT("d", CYAML_FLAG_DEFAULT,
+				struct target_struct, d),
+		CYAML_FIELD_INT("c", CYAML_FLAG_DEFAULT,
+				struct target_struct, c),
+		CYAML_FIELD_INT("e", CYAML_FLAG_DEFAULT,
+				struct target_struct, e),
+		CYAML_FIELD_END
+	};
+	static const struct cyaml_schema_value top_schema = {
+		CYAML_VALUE_MAPPING(CYAML_FLAG_POINTER,
+				struct target_struct, mapping_schema),
+	};
+	cyaml_schema_compiled_t *compiled = NULL;
+	cyaml_config_t cfg = *config;
+	test_data_t td = {
+		.data = (cyaml_data_t **) &data_tgt,
+		.compiled = &compiled,
+		.config = &cfg,
+		.schema = &top_schema,
+	};
+	cyaml_err_t err;
+	ttest_ctx_t tc;
+
+	if (!ttest_start(report, __func__, cyaml_cleanup, &td, &tc)) {
+		return true;
+	}
+
+	err = cyaml_schema_compile(&cfg, &top_schema, &compiled);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+	cfg.compiled_schema = compiled;
+
+	err = cyaml_load_data(yaml, YAML_LEN(yaml), &cfg, &top_schema,
+			(cyaml_data_t **) &data_tgt, NULL);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	if (data_tgt->a != 1 || data_tgt->b != 2 ||
+	    data_tgt->c != 3 || data_tgt->d != 4 ||
+	    data_tgt->e != 5 || data_tgt->f != 6 ||
+	    data_tgt->g != 7 || data_tgt->h != 8) {
+		return ttest_fail(&tc, "Incorrect value");
+	}
+	if (strcmp(data_tgt->name, "cyaml") != 0) {
+		return ttest_fail(&tc, "Incorrect value for name");
+	}
+
+	return ttest_pass(&tc);
+}
+
+/**
+ * Test loading an unknown key, using a compiled schema.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_schema_load_unknown_key(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	struct target_struct {
+		int a;
+		int b;
+	} *data_tgt = NULL;
+	static const unsigned char yaml[] =
+		"a: 1\n"
+		"aa: 2\n";
+	static const struct cyaml_schema_field mapping_schema[] = {
+		CYAML_FIELD_INT("b", CYAML_FLAG_OPTIONAL,
+				struct target_struct, b),
+		CYAML_FIELD_INT("a", CYAML_FLAG_DEFAULT,
+				struct target_struct, a),
+		CYAML_FIELD_END
+	};
+	static const struct cyaml_schema_value top_schema = {
+		CYAML_VALUE_MAPPING(CYAML_FLAG_POINTER,
+				struct target_struct, mapping_schema),
+	};
+	cyaml_schema_compiled_t *compiled = NULL;
+	cyaml_config_t cfg = *config;
+	test_data_t td = {
+		.data = (cyaml_data_t **) &data_tgt,
+		.compiled = &compiled,
+		.config = &cfg,
+		.schema = &top_schema,
+	};
+	cyaml_err_t err;
+	ttest_ctx_t tc;
+
+	if (!ttest_start(report, __func__, cyaml_cleanup, &td, &tc)) {
+		return true;
+	}
+
+	err = cyaml_schema_compile(&cfg, &top_schema, &compiled);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+	cfg.compiled_schema = compiled;
+
+	err = cyaml_load_data(yaml, YAML_LEN(yaml), &cfg, &top_schema,
+			(cyaml_data_t **) &data_tgt, NULL);
+	if (err != CYAML_ERR_INVALID_KEY) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	cfg.flags |= CYAML_CFG_IGNORE_UNKNOWN_KEYS;
+	err = cyaml_load_data(yaml, YAML_LEN(yaml), &cfg, &top_schema,
+			(cyaml_data_t **) &data_tgt, NULL);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	if (data_tgt->a != 1 || data_tgt->b != 0) {
+		return ttest_fail(&tc, "Incorrect value");
+	}
+
+	return ttest_pass(&tc);
+}
+
+/**
+ * Test that the first of any duplicate schema keys is used.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_schema_load_duplicate_schema_key(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	struct target_struct {
+		int a;
+		int b;
+		int c;
+	} *data_tgt = NULL;
+	static const unsigned char yaml[] =
+		"dup: 1\n";
+	static const struct cyaml_schema_field mapping_schema[] = {
+		CYAML_FIELD_INT("other", CYAML_FLAG_OPTIONAL,
+				struct target_struct, a),
+		CYAML_FIELD_INT("dup", CYAML_FLAG_OPTIONAL,
+				struct target_struct, b),
+		CYAML_FIELD_INT("dup", CYAML_FLAG_OPTIONAL,
+				struct target_struct, c),
+		CYAML_FIELD_END
+	};
+	static const struct cyaml_schema_value top_schema = {
+		CYAML_VALUE_MAPPING(CYAML_FLAG_POINTER,
+				struct target_struct, mapping_schema),
+	};
+	cyaml_schema_compiled_t *compiled = NULL;
+	cyaml_config_t cfg = *config;
+	test_data_t td = {
+		.data = (cyaml_data_t **) &data_tgt,
+		.compiled = &compiled,
+		.config = &cfg,
+		.schema = &top_schema,
+	};
+	cyaml_err_t err;
+	ttest_ctx_t tc;
+
+	if (!ttest_start(report, __func__, cyaml_cleanup, &td, &tc)) {
+		return true;
+	}
+
+	err = cyaml_schema_compile(&cfg, &top_schema, &compiled);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+	cfg.compiled_schema = compiled;
+
+	err = cyaml_load_data(yaml, YAML_LEN(yaml), &cfg, &top_schema,
+			(cyaml_data_t **) &data_tgt, NULL);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	if (data_tgt->a != 0 || data_tgt->b != 1 || data_tgt->c != 0) {
+		return ttest_fail(&tc, "Incorrect value");
+	}
+
+	return ttest_pass(&tc);
+}
+
+/**
+ * Test loading with a schema compiled for case insensitive keys.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_schema_load_case_insensitive(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	struct target_struct {
+		int a;
+		int b;
+		int c;
+	} *data_tgt = NULL;
+	static const unsigned char yaml[] =
+		"Cheerful: 1\n"
+		"LOLLIPOP: 2\n"
+		"unicorns: 3\n";
+	static const struct cyaml_schema_field mapping_schema[] = {
+		CYAML_FIELD_INT("unicorns", CYAML_FLAG_DEFAULT,
+				struct target_struct, c),
+		CYAML_FIELD_INT("lollipop", CYAML_FLAG_DEFAULT,
+				struct target_struct, b),
+		CYAML_FIELD_INT("cheerful", CYAML_FLAG_DEFAULT,
+				struct target_struct, a),
+		CYAML_FIELD_END
+	};
+	static const struct cyaml_schema_value top_schema = {
+		CYAML_VALUE_MAPPING(CYAML_FLAG_POINTER,
+				struct target_struct, mapping_schema),
+	};
+	cyaml_schema_compiled_t *compiled = NULL;
+	cyaml_config_t cfg = *config;
+	test_data_t td = {
+		.data = (cyaml_data_t **) &data_tgt,
+		.compiled = &compiled,
+		.config = &cfg,
+		.schema = &top_schema,
+	};
+	cyaml_err_t err;
+	ttest_ctx_t tc;
+
+	if (!ttest_start(report, __func__, cyaml_cleanup, &td, &tc)) {
+		return true;
+	}
+
+	cfg.flags |= CYAML_CFG_CASE_INSENSITIVE;
+	err = cyaml_schema_compile(&cfg, &top_schema, &compiled);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+	cfg.compiled_schema = compiled;
+
+	err = cyaml_load_data(yaml, YAML_LEN(yaml), &cfg, &top_schema,
+			(cyaml_data_t **) &data_tgt, NULL);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	if (data_tgt->a != 1 || data_tgt->b != 2 || data_tgt->c != 3) {
+		return ttest_fail(&tc, "Incorrect value");
+	}
+
+	return ttest_pass(&tc);
+}
+
+/**
+ * Test case insensitive loading of keys that are prefixes of other keys.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_schema_load_case_insensitive_prefix(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	struct target_struct {
+		int a;
+		int b;
+		int c;
+		int d;
+		int e;
+	} *data_tgt = NULL;
+	static const unsigned char yaml[] =
+		"ABC: 3\n"
+		"a: 1\n"
+		"Unicorns-And-Lollipops: 4\n"
+		"aB: 2\n"
+		"UNICORNS: 5\n";
+	static const struct cyaml_schema_field mapping_schema[] = {
+		CYAML_FIELD_INT("unicorns", CYAML_FLAG_DEFAULT,
+				struct target_struct, e),
+		CYAML_FIELD_INT("abc", CYAML_FLAG_DEFAULT,
+				struct target_struct, c),
+		CYAML_FIELD_INT("Ab", CYAML_FLAG_DEFAULT,
+				struct target_struct, b),
+		CYAML_FIELD_INT("unicorns-and-LOLLIPOPS", CYAML_FLAG_DEFAULT,
+				struct target_struct, d),
+		CYAML_FIELD_INT("A", CYAML_FLAG_DEFAULT,
+				struct target_struct, a),
+		CYAML_FIELD_END
+	};
+	static const struct cyaml_schema_value top_schema = {
+		CYAML_VALUE_MAPPING(CYAML_FLAG_POINTER,
+				struct target_struct, mapping_schema),
+	};
+	cyaml_schema_compiled_t *compiled = NULL;
+	cyaml_config_t cfg = *config;
+	test_data_t td = {
+		.data = (cyaml_data_t **) &data_tgt,
+		.compiled = &compiled,
+		.config = &cfg,
+		.schema = &top_schema,
+	};
+	cyaml_err_t err;
+	ttest_ctx_t tc;
+
+	if (!ttest_start(report, __func__, cyaml_cleanup, &td, &tc)) {
+		return true;
+	}
+
+	cfg.flags |= CYAML_CFG_CASE_INSENSITIVE;
+	err = cyaml_schema_compile(&cfg, &top_schema, &compiled);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+	cfg.compiled_schema = compiled;
+
+	err = cyaml_load_data(yaml, YAML_LEN(yaml), &cfg, &top_schema,
+			(cyaml_data_t **) &data_tgt, NULL);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	if (data_tgt->a != 1 || data_tgt->b != 2 || data_tgt->c != 3 ||
+	    data_tgt->d != 4 || data_tgt->e != 5) {
+		return ttest_fail(&tc, "Incorrect value");
+	}
+
+	return ttest_pass(&tc);
+}
+
+/**
+ * Test case insensitive loading with non-ASCII keys.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_schema_load_case_insensitive_utf8(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	struct target_struct {
+		int a;
+		int b;
+	} *data_tgt = NULL;
+	static const unsigned char yaml[] =
+		"\xc3\x9cnicorn: 1\n"
+		"lollipop: 2\n";
+	static const struct cyaml_schema_field mapping_schema[] = {
+		CYAML_FIELD_INT("LOLLIPOP", CYAML_FLAG_DEFAULT,
+				struct target_struct, b),
+		CYAML_FIELD_INT("\xc3\xbcnicorn", CYAML_FLAG_DEFAULT,
+				struct target_struct, a),
+		CYAML_FIELD_END
+	};
+	static const struct cyaml_schema_value top_schema = {
+		CYAML_VALUE_MAPPING(CYAML_FLAG_POINTER,
+				struct target_struct, mapping_schema),
+	};
+	cyaml_schema_compiled_t *compiled = NULL;
+	cyaml_config_t cfg = *config;
+	test_data_t td = {
+		.data = (cyaml_data_t **) &data_tgt,
+		.compiled = &compiled,
+		.config = &cfg,
+		.schema = &top_schema,
+	};
+	cyaml_err_t err;
+	ttest_ctx_t tc;
+
+	if (!ttest_start(report, __func__, cyaml_cleanup, &td, &tc)) {
+		return true;
+	}
+
+	cfg.flags |= CYAML_CFG_CASE_INSENSITIVE;
+	err = cyaml_schema_compile(&cfg, &top_schema, &compiled);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+	cfg.compiled_schema = compiled;
+
+	err = cyaml_load_data(yaml, YAML_LEN(yaml), &cfg, &top_schema,
+			(cyaml_data_t **) &data_tgt, NULL);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	if (data_tgt->a != 1 || data_tgt->b != 2) {
+		return ttest_fail(&tc, "Incorrect value");
+	}
+
+	return ttest_pass(&tc);
+}
+
+/**
+ * Test loading with a config case sensitivity that differs from compile time.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_schema_load_case_mismatch(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	struct target_struct {
+		int a;
+		int b;
+	} *data_tgt = NULL;
+	static const unsigned char yaml[] =
+		"Cheerful: 1\n"
+		"LOLLIPOP: 2\n";
+	static const struct cyaml_schema_field mapping_schema[] = {
+		CYAML_FIELD_INT("lollipop", CYAML_FLAG_DEFAULT,
+				struct target_struct, b),
+		CYAML_FIELD_INT("cheerful", CYAML_FLAG_DEFAULT,
+				struct target_struct, a),
+		CYAML_FIELD_END
+	};
+	static const struct cyaml_schema_value top_schema = {
+		CYAML_VALUE_MAPPING(CYAML_FLAG_POINTER,
+				struct target_struct, mapping_schema),
+	};
+	cyaml_schema_compiled_t *compiled = NULL;
+	cyaml_config_t cfg = *config;
+	test_data_t td = {
+		.data = (cyaml_data_t **) &data_tgt,
+		.compiled = &compiled,
+		.config = &cfg,
+		.schema = &top_schema,
+	};
+	cyaml_err_t err;
+	ttest_ctx_t tc;
+
+	if (!ttest_start(report, __func__, cyaml_cleanup, &td, &tc)) {
+		return true;
+	}
+
+	err = cyaml_schema_compile(&cfg, &top_schema, &compiled);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+	cfg.compiled_schema = compiled;
+	cfg.flags |= CYAML_CFG_CASE_INSENSITIVE;
+
+	err = cyaml_load_data(yaml, YAML_LEN(yaml), &cfg, &top_schema,
+			(cyaml_data_t **) &data_tgt, NULL);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	if (data_tgt->a != 1 || data_tgt->b != 2) {
+		return ttest_fail(&tc, "Incorrect value");
+	}
+
+	return ttest_pass(&tc);
+}
+
+/**
+ * Test compiling a recursive schema and using it for load, copy and save.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_schema_recursive(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	struct node {
+		int value;
+		struct node *child;
+	} *data_tgt = NULL, *copy = NULL;
+	static const unsigned char yaml[] =
+		"value: 1\n"
+		"child:\n"
+		"  value: 2\n"
+		"  child:\n"
+		"    value: 3\n";
+	static const char expected[] =
+		"value: 1\n"
+		"child:\n"
+		"  value: 2\n"
+		"  child:\n"
+		"    value: 3\n";
+	static const struct cyaml_schema_field mapping_schema[] = {
+		CYAML_FIELD_INT("value", CYAML_FLAG_DEFAULT,
+				struct node, value),
+		{
+			.key = "child",
+			.data_offset = offsetof(struct node, child),
+			.value = {
+				.type = CYAML_MAPPING,
+				.flags = CYAML_FLAG_POINTER |
+				         CYAML_FLAG_OPTIONAL,
+				.data_size = sizeof(struct node),
+				.mapping = {
+					.fields = mapping_schema,
+				},
+			},
+		},
+		CYAML_FIELD_END
+	};
+	static const struct cyaml_schema_value node_schema = {
+		CYAML_VALUE_MAPPING(CYAML_FLAG_POINTER,
+				struct node, mapping_schema),
+	};
+	cyaml_schema_compiled_t *compiled = NULL;
+	cyaml_config_t cfg = *config;
+	char *buffer = NULL;
+	size_t len;
+	test_data_t td = {
+		.data = (cyaml_data_t **) &data_tgt,
+		.copy = (cyaml_data_t **) &copy,
+		.buffer = &buffer,
+		.compiled = &compiled,
+		.config = &cfg,
+		.schema = &node_schema,
+	};
+	cyaml_err_t err;
+	ttest_ctx_t tc;
+
+	if (!ttest_start(report, __func__, cyaml_cleanup, &td, &tc)) {
+		return true;
+	}
+
+	err = cyaml_schema_compile(&cfg, &node_schema, &compiled);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+	cfg.compiled_schema = compiled;
+
+	err = cyaml_load_data(yaml, YAML_LEN(yaml), &cfg, &node_schema,
+			(cyaml_data_t **) &data_tgt, NULL);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	err = cyaml_copy(&cfg, &node_schema, data_tgt, 0,
+			(cyaml_data_t **) &copy);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	if (copy->value != 1 ||
+	    copy->child == NULL || copy->child->value != 2 ||
+	    copy->child->child == NULL || copy->child->child->value != 3 ||
+	    copy->child->child->child != NULL) {
+		return ttest_fail(&tc, "Incorrect value");
+	}
+
+	err = cyaml_save_data(&buffer, &len, &cfg, &node_schema, copy, 0);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	if (len != sizeof(expected) - 1 ||
+	    memcmp(expected, buffer, len) != 0) {
+		return ttest_fail(&tc, "Bad saved data");
+	}
+
+	return ttest_pass(&tc);
+}
+
+/**
+ * Test loading and saving enums, flags, and bitfields with a compiled schema.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_schema_enum_round_trip(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	struct target_struct {
+		int first;
+		int second;
+		int third;
+		unsigned flags;
+		uint8_t bits;
+	} *data_tgt = NULL;
+	static const unsigned char yaml[] =
+		"first: red\n"
+		"second: crimson\n"
+		"third: blue\n"
+		"flags: [four, one]\n"
+		"bits: {high: 10, low: 3}\n";
+	static const char expected[] =
+		"---\n"
+		"first: red\n"
+		"second: red\n"
+		"third: blue\n"
+		"flags:\n"
+		"- one\n"
+		"- four\n"
+		"bits:\n"
+		"  low: 0x3\n"
+		"  high: 0xa\n"
+		"...\n";
+	static const cyaml_strval_t colours[] = {
+		{ "red", 0 },
+		{ "green", 1 },
+		{ "blue", 2 },
+		{ "crimson", 0 },
+		{ "red", 5 },
+	};
+	static const cyaml_strval_t flags[] = {
+		{ "one", 1 },
+		{ "two", 2 },
+		{ "four", 4 },
+	};
+	static const cyaml_bitdef_t bitdefs[] = {
+		{ .name = "low", .offset = 0, .bits = 4 },
+		{ .name = "high", .offset = 4, .bits = 4 },
+	};
+	static const struct cyaml_schema_field mapping_schema[] = {
+		CYAML_FIELD_ENUM("first", CYAML_FLAG_STRICT,
+				struct target_struct, first,
+				colours, CYAML_ARRAY_LEN(colours)),
+		CYAML_FIELD_ENUM("second", CYAML_FLAG_STRICT,
+				struct target_struct, second,
+				colours, CYAML_ARRAY_LEN(colours)),
+		CYAML_FIELD_ENUM("third", CYAML_FLAG_STRICT,
+				struct target_struct, third,
+				colours, CYAML_ARRAY_LEN(colours)),
+		CYAML_FIELD_FLAGS("flags", CYAML_FLAG_STRICT,
+				struct target_struct, flags,
+				flags, CYAML_ARRAY_LEN(flags)),
+		CYAML_FIELD_BITFIELD("bits", CYAML_FLAG_DEFAULT,
+				struct target_struct, bits,
+				bitdefs, CYAML_ARRAY_LEN(bitdefs)),
+		CYAML_FIELD_END
+	};
+	static const struct cyaml_schema_value top_schema = {
+		CYAML_VALUE_MAPPING(CYAML_FLAG_POINTER,
+				struct target_struct, mapping_schema),
+	};
+	cyaml_schema_compiled_t *compiled = NULL;
+	cyaml_config_t cfg = *config;
+	char *buffer = NULL;
+	size_t len;
+	test_data_t td = {
+		.data = (cyaml_data_t **) &data_tgt,
+		.buffer = &buffer,
+		.compiled = &compiled,
+		.config = &cfg,
+		.schema = &top_schema,
+	};
+	cyaml_err_t err;
+	ttest_ctx_t tc;
+
+	if (!ttest_start(report, __func__, cyaml_cleanup, &td, &tc)) {
+		return true;
+	}
+
+	cfg.flags |= CYAML_CFG_DOCUMENT_DELIM;
+	err = cyaml_schema_compile(&cfg, &top_schema, &compiled);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+	cfg.compiled_schema = compiled;
+
+	err = cyaml_load_data(yaml, YAML_LEN(yaml), &cfg, &top_schema,
+			(cyaml_data_t **) &data_tgt, NULL);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	if (data_tgt->first != 0 || data_tgt->second != 0 ||
+	    data_tgt->third != 2 || data_tgt->flags != 5 ||
+	    data_tgt->bits != 0xa3) {
+		return ttest_fail(&tc, "Incorrect value");
+	}
+
+	err = cyaml_save_data(&buffer, &len, &cfg, &top_schema, data_tgt, 0);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	if (len != sizeof(expected) - 1 ||
+	    memcmp(expected, buffer, len) != 0) {
+		return ttest_fail(&tc, "Bad saved data");
+	}
+
+	return ttest_pass(&tc);
+}
+
+/**
+ * Test loading and saving unknown enum values with a compiled schema.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_schema_enum_unknown(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	static const int data = 3;
+	static const unsigned char yaml[] =
+		"purple\n";
+	static const cyaml_strval_t colours[] = {
+		{ "red", 0 },
+		{ "green", 1 },
+		{ "blue", 2 },
+	};
+	static const struct cyaml_schema_value top_schema = {
+		CYAML_VALUE_ENUM(CYAML_FLAG_POINTER | CYAML_FLAG_STRICT,
+				int, colours, CYAML_ARRAY_LEN(colours)),
+	};
+	cyaml_schema_compiled_t *compiled = NULL;
+	cyaml_config_t cfg = *config;
+	int *data_tgt = NULL;
+	char *buffer = NULL;
+	size_t len;
+	test_data_t td = {
+		.data = (cyaml_data_t **) &data_tgt,
+		.buffer = &buffer,
+		.compiled = &compiled,
+		.config = &cfg,
+		.schema = &top_schema,
+	};
+	cyaml_err_t err;
+	ttest_ctx_t tc;
+
+	if (!ttest_start(report, __func__, cyaml_cleanup, &td, &tc)) {
+		return true;
+	}
+
+	err = cyaml_schema_compile(&cfg, &top_schema, &compiled);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+	cfg.compiled_schema = compiled;
+
+	err = cyaml_load_data(yaml, YAML_LEN(yaml), &cfg, &top_schema,
+			(cyaml_data_t **) &data_tgt, NULL);
+	if (err != CYAML_ERR_INVALID_VALUE) {
+		return ttest_fail(&tc, "Load: %s", cyaml_strerror(err));
+	}
+
+	err = cyaml_save_data(&buffer, &len, &cfg, &top_schema, &data, 0);
+	if (err != CYAML_ERR_INVALID_VALUE) {
+		return ttest_fail(&tc, "Save: %s", cyaml_strerror(err));
+	}
+
+	return ttest_pass(&tc);
+}
+
+/**
+ * Test loading case insensitive enums and flags with a compiled schema.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_schema_enum_case_insensitive(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	struct target_struct {
+		int colour;
+		unsigned flags;
+	} *data_tgt = NULL;
+	static const unsigned char yaml[] =
+		"colour: gREEN\n"
+		"flags: [\xc3\xbcNICORN, cheerful]\n";
+	static const cyaml_strval_t colours[] = {
+		{ "Red", 0 },
+		{ "Green", 1 },
+	};
+	static const cyaml_strval_t flags[] = {
+		{ "CHEERFUL", 1 },
+		{ "\xc3\x9cnicorn", 2 },
+	};
+	static const struct cyaml_schema_field mapping_schema[] = {
+		CYAML_FIELD_ENUM("colour", CYAML_FLAG_STRICT,
+				struct target_struct, colour,
+				colours, CYAML_ARRAY_LEN(colours)),
+		CYAML_FIELD_FLAGS("flags", CYAML_FLAG_STRICT,
+				struct target_struct, flags,
+				flags, CYAML_ARRAY_LEN(flags)),
+		CYAML_FIELD_END
+	};
+	static const struct cyaml_schema_value top_schema = {
+		CYAML_VALUE_MAPPING(CYAML_FLAG_POINTER,
+				struct target_struct, mapping_schema),
+	};
+	cyaml_schema_compiled_t *compiled = NULL;
+	cyaml_config_t cfg = *config;
+	test_data_t td = {
+		.data = (cyaml_data_t **) &data_tgt,
+		.compiled = &compiled,
+		.config = &cfg,
+		.schema = &top_schema,
+	};
+	cyaml_err_t err;
+	ttest_ctx_t tc;
+
+	if (!ttest_start(report, __func__, cyaml_cleanup, &td, &tc)) {
+		return true;
+	}
+
+	cfg.flags |= CYAML_CFG_CASE_INSENSITIVE;
+	err = cyaml_schema_compile(&cfg, &top_schema, &compiled);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+	cfg.compiled_schema = compiled;
+
+	err = cyaml_load_data(yaml, YAML_LEN(yaml), &cfg, &top_schema,
+			(cyaml_data_t **) &data_tgt, NULL);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	if (data_tgt->colour != 1 || data_tgt->flags != 3) {
+		return ttest_fail(&tc, "Incorrect value");
+	}
+
+	return ttest_pass(&tc);
+}
+
+/**
+ * Test a bitfield with a bitdef that doesn't fit, with a compiled schema.
+ *
+ * Bitdefs before the bad one can be loaded, but not ones after it.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_schema_bitfield_bad_bitdef(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	static const unsigned char yaml_good[] =
+		"{ good: 1 }\n";
+	static const unsigned char yaml_bad[] =
+		"{ after: 1 }\n";
+	static const cyaml_bitdef_t bitdefs[] = {
+		{ .name = "good", .offset = 0, .bits = 4 },
+		{ .name = "bad", .offset = 4, .bits = 8 },
+		{ .name = "after", .offset = 0, .bits = 1 },
+	};
+	static const struct cyaml_schema_value top_schema = {
+		CYAML_VALUE_BITFIELD(CYAML_FLAG_POINTER, uint8_t,
+				bitdefs, CYAML_ARRAY_LEN(bitdefs)),
+	};
+	cyaml_schema_compiled_t *compiled = NULL;
+	cyaml_config_t cfg = *config;
+	uint8_t *data_tgt = NULL;
+	test_data_t td = {
+		.data = (cyaml_data_t **) &data_tgt,
+		.compiled = &compiled,
+		.config = &cfg,
+		.schema = &top_schema,
+	};
+	cyaml_err_t err;
+	ttest_ctx_t tc;
+
+	if (!ttest_start(report, __func__, cyaml_cleanup, &td, &tc)) {
+		return true;
+	}
+
+	err = cyaml_schema_compile(&cfg, &top_schema, &compiled);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+	cfg.compiled_schema = compiled;
+
+	err = cyaml_load_data(yaml_bad, YAML_LEN(yaml_bad), &cfg,
+			&top_schema, (cyaml_data_t **) &data_tgt, NULL);
+	if (err != CYAML_ERR_BAD_BITVAL_IN_SCHEMA) {
+		return ttest_fail(&tc, "Load bad: %s", cyaml_strerror(err));
+	}
+
+	err = cyaml_load_data(yaml_good, YAML_LEN(yaml_good), &cfg,
+			&top_schema, (cyaml_data_t **) &data_tgt, NULL);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	if (*data_tgt != 1) {
+		return ttest_fail(&tc, "Incorrect value");
+	}
+
+	return ttest_pass(&tc);
+}
+
+/**
+ * Run the CYAML compiled schema unit tests.
+ *
+ * \param[in]  rc         The ttest report context.
+ * \param[in]  log_level  CYAML log level.
+ * \param[in]  log_fn     CYAML logging function, or NULL.
+ * \return true iff all unit tests pass, otherwise false.
+ */
+bool schema_tests(
+		ttest_report_ctx_t *rc,
+		cyaml_log_t log_level,
+		cyaml_log_fn_t log_fn)
+{
+	bool pass = true;
+	cyaml_config_t config = {
+		.log_fn = log_fn,
+		.mem_fn = cyaml_mem,
+		.log_level = log_level,
+		.flags = CYAML_CFG_DEFAULT,
+	};
+
+	ttest_heading(rc, "Compiled schema tests");
+
+	pass &= test_schema_recursive(rc, &config);
+	pass &= test_schema_load_mapping(rc, &config);
+	pass &= test_schema_load_unknown_key(rc, &config);
+	pass &= test_schema_compile_bad_params(rc, &config);
+	pass &= test_schema_load_case_mismatch(rc, &config);
+	pass &= test_schema_load_case_insensitive(rc, &config);
+	pass &= test_schema_load_case_insensitive_prefix(rc, &config);
+	pass &= test_schema_load_case_insensitive_utf8(rc, &config);
+	pass &= test_schema_load_duplicate_schema_key(rc, &config);
+	pass &= test_schema_enum_unknown(rc, &config);
+	pass &= test_schema_enum_round_trip(rc, &config);
+	pass &= test_schema_bitfield_bad_bitdef(rc, &config);
+	pass &= test_schema_enum_case_insensitive(rc, &config);
+
+	return pass;
+}
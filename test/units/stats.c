@@ -0,0 +1,408 @@
+/*
+ * SPDX-License-Identifier: ISC
+ *
+ * Copyright (C) 2026 Michael Drake <tlsa@netsurf-browser.org>
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <assert.h>
+#include <string.h>
+#include <stdio.h>
+
+#include <cyaml/cyaml.h>
+
+#include "ttest.h"
+#include "test.h"
+
+/** Helper macro to count bytes of YAML input data. */
+#define YAML_LEN(_y) (sizeof(_y) - 1)
+
+#ifndef CYAML_STATS
+#define CYAML_STATS 1
+#endif
+
+/**
+ * Unit test context data.
+ */
+typedef struct test_data {
+	cyaml_data_t **data;
+	cyaml_data_t **copy;
+	const struct cyaml_config *config;
+	const struct cyaml_schema_value *schema;
+} test_data_t;
+
+/**
+ * Common clean up function to free data loaded by tests.
+ *
+ * \param[in]  data  The unit test context data.
+ */
+static void cyaml_cleanup(void *data)
+{
+	struct test_data *td = data;
+
+	if (td->data != NULL) {
+		cyaml_free(td->config, td->schema, *(td->data), 0);
+	}
+
+	if (td->copy != NULL) {
+		cyaml_free(td->config, td->schema, *(td->copy), 0);
+	}
+}
+
+/** Test document structure. */
+struct test_stats_doc {
+	char *name;
+	char *alias;
+	int *values;
+	unsigned values_count;
+};
+
+/** Test document. */
+static const unsigned char test_stats_yaml[] =
+	"name: &n hello\n"
+	"alias: *n\n"
+	"ignored: 5\n"
+	"values: [ 1, 2, 3 ]\n";
+
+/** Test document sequence entry schema. */
+static const struct cyaml_schema_value test_stats_entry_schema = {
+	CYAML_VALUE_INT(CYAML_FLAG_DEFAULT, int),
+};
+
+/** Test document mapping fields. */
+static const struct cyaml_schema_field test_stats_fields[] = {
+	CYAML_FIELD_STRING_PTR("name", CYAML_FLAG_POINTER,
+			struct test_stats_doc, name, 0, CYAML_UNLIMITED),
+	CYAML_FIELD_STRING_PTR("alias", CYAML_FLAG_POINTER,
+			struct test_stats_doc, alias, 0, CYAML_UNLIMITED),
+	CYAML_FIELD_IGNORE("ignored", CYAML_FLAG_OPTIONAL),
+	CYAML_FIELD_SEQUENCE("values", CYAML_FLAG_POINTER,
+			struct test_stats_doc, values,
+			&test_stats_entry_schema, 0, CYAML_UNLIMITED),
+	CYAML_FIELD_END
+};
+
+/** Test document schema. */
+static const struct cyaml_schema_value test_stats_schema = {
+	CYAML_VALUE_MAPPING(CYAML_FLAG_POINTER,
+			struct test_stats_doc, test_stats_fields),
+};
+
+/**
+ * Test collecting statistics while loading.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_stats_load(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	struct test_stats_doc *data_tgt = NULL;
+	cyaml_config_t cfg = *config;
+	cyaml_stats_t stats = { 0 };
+	test_data_t td = {
+		.data = (cyaml_data_t **) &data_tgt,
+		.config = config,
+		.schema = &test_stats_schema,
+	};
+	cyaml_err_t err;
+	ttest_ctx_t tc;
+
+	if (!ttest_start(report, __func__, cyaml_cleanup, &td, &tc)) {
+		return true;
+	}
+
+	cfg.stats = &stats;
+
+	err = cyaml_load_data(test_stats_yaml, YAML_LEN(test_stats_yaml),
+			&cfg, &test_stats_schema,
+			(cyaml_data_t **) &data_tgt, NULL);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	if (!CYAML_STATS) {
+		return ttest_pass(&tc);
+	}
+
+	if (stats.events[CYAML_EVENT_STREAM_START] != 1 ||
+	    stats.events[CYAML_EVENT_DOC_START] != 1 ||
+	    stats.events[CYAML_EVENT_MAPPING_START] != 1 ||
+	    stats.events[CYAML_EVENT_SEQUENCE_START] != 1 ||
+	    stats.events[CYAML_EVENT_SCALAR] != 10) {
+		return ttest_fail(&tc, "Unexpected event counts");
+	}
+	if (stats.anchors != 1 || stats.aliases != 1) {
+		return ttest_fail(&tc, "Unexpected anchor counts: %llu, %llu",
+				(unsigned long long)stats.anchors,
+				(unsigned long long)stats.aliases);
+	}
+	if (stats.ignored_keys != 1) {
+		return ttest_fail(&tc, "Unexpected ignored key count");
+	}
+	if (stats.allocs == 0 || stats.alloc_bytes == 0) {
+		return ttest_fail(&tc, "No allocations counted");
+	}
+	if (stats.stack_max < 4) {
+		return ttest_fail(&tc, "Unexpected stack depth: %u",
+				stats.stack_max);
+	}
+	if (stats.libyaml_ns > stats.total_ns) {
+		return ttest_fail(&tc, "LibYAML time exceeds total time");
+	}
+
+	return ttest_pass(&tc);
+}
+
+/**
+ * Test collecting statistics while saving.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_stats_save(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	static int values[] = { 1, 2, 3 };
+	static struct test_stats_doc data = {
+		.name = (char *) "hello",
+		.alias = (char *) "world",
+		.values = values,
+		.values_count = CYAML_ARRAY_LEN(values),
+	};
+	cyaml_config_t cfg = *config;
+	cyaml_stats_t stats = { 0 };
+	char *buffer = NULL;
+	size_t len;
+	test_data_t td = {
+		.config = config,
+	};
+	cyaml_err_t err;
+	ttest_ctx_t tc;
+
+	if (!ttest_start(report, __func__, cyaml_cleanup, &td, &tc)) {
+		return true;
+	}
+
+	cfg.stats = &stats;
+
+	err = cyaml_save_data(&buffer, &len, &cfg, &test_stats_schema,
+			&data, 0);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+	cfg.mem_fn(cfg.mem_ctx, buffer, 0);
+
+	if (!CYAML_STATS) {
+		return ttest_pass(&tc);
+	}
+
+	if (stats.events[CYAML_EVENT_STREAM_START] != 1 ||
+	    stats.events[CYAML_EVENT_STREAM_END] != 1 ||
+	    stats.events[CYAML_EVENT_MAPPING_START] != 1 ||
+	    stats.events[CYAML_EVENT_MAPPING_END] != 1 ||
+	    stats.events[CYAML_EVENT_SEQUENCE_START] != 1 ||
+	    stats.events[CYAML_EVENT_SEQUENCE_END] != 1 ||
+	    stats.events[CYAML_EVENT_SCALAR] != 8) {
+		return ttest_fail(&tc, "Unexpected event counts");
+	}
+	if (stats.allocs == 0) {
+		return ttest_fail(&tc, "No allocations counted");
+	}
+	if (stats.stack_max < 4) {
+		return ttest_fail(&tc, "Unexpected stack depth: %u",
+				stats.stack_max);
+	}
+	if (stats.libyaml_ns > stats.total_ns) {
+		return ttest_fail(&tc, "LibYAML time exceeds total time");
+	}
+
+	return ttest_pass(&tc);
+}
+
+/**
+ * Test counting allocations while copying and freeing.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_stats_copy_free(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	struct test_stats_doc *data_tgt = NULL;
+	struct test_stats_doc *copy = NULL;
+	cyaml_config_t cfg = *config;
+	cyaml_stats_t stats = { 0 };
+	uint64_t frees;
+	test_data_t td = {
+		.data = (cyaml_data_t **) &data_tgt,
+		.copy = (cyaml_data_t **) &copy,
+		.config = config,
+		.schema = &test_stats_schema,
+	};
+	cyaml_err_t err;
+	ttest_ctx_t tc;
+
+	if (!ttest_start(report, __func__, cyaml_cleanup, &td, &tc)) {
+		return true;
+	}
+
+	err = cyaml_load_data(test_stats_yaml, YAML_LEN(test_stats_yaml),
+			config, &test_stats_schema,
+			(cyaml_data_t **) &data_tgt, NULL);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	cfg.stats = &stats;
+
+	err = cyaml_copy(&cfg, &test_stats_schema, data_tgt, 0,
+			(cyaml_data_t **) &copy);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	if (CYAML_STATS && stats.allocs == 0) {
+		return ttest_fail(&tc, "No allocations counted");
+	}
+
+	frees = stats.frees;
+	err = cyaml_free(&cfg, &test_stats_schema, copy, 0);
+	copy = NULL;
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	/* Name, alias, values, and the mapping itself. */
+	if (CYAML_STATS && stats.frees - frees != 4) {
+		return ttest_fail(&tc, "Unexpected free count: %llu",
+				(unsigned long long)(stats.frees - frees));
+	}
+
+	return ttest_pass(&tc);
+}
+
+/** Trace callback test context. */
+struct test_trace_ctx {
+	unsigned begin; /**< Number of begin calls. */
+	unsigned end;   /**< Number of end calls. */
+	bool nested;    /**< Whether calls were unbalanced. */
+};
+
+/**
+ * Trace callback that counts and checks calls.
+ *
+ * \param[in] trace  The trace point.
+ * \param[in] ctx    The \ref test_trace_ctx.
+ * \param[in] type   The type of event being handled.
+ */
+static void test_stats_trace_fn(
+		cyaml_trace_t trace,
+		void *ctx,
+		cyaml_event_type_t type)
+{
+	struct test_trace_ctx *t = ctx;
+
+	if (type <= CYAML_EVENT_NONE || type >= CYAML_EVENT__COUNT) {
+		t->nested = true;
+	}
+
+	switch (trace) {
+	case CYAML_TRACE_EVENT_BEGIN:
+		if (t->begin != t->end) {
+			t->nested = true;
+		}
+		t->begin++;
+		break;
+	case CYAML_TRACE_EVENT_END:
+		t->end++;
+		if (t->begin != t->end) {
+			t->nested = true;
+		}
+		break;
+	}
+}
+
+/**
+ * Test the trace callback while loading.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_stats_trace(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	struct test_stats_doc *data_tgt = NULL;
+	struct test_trace_ctx trace = { 0 };
+	cyaml_config_t cfg = *config;
+	test_data_t td = {
+		.data = (cyaml_data_t **) &data_tgt,
+		.config = config,
+		.schema = &test_stats_schema,
+	};
+	cyaml_err_t err;
+	ttest_ctx_t tc;
+
+	if (!ttest_start(report, __func__, cyaml_cleanup, &td, &tc)) {
+		return true;
+	}
+
+	cfg.trace_fn = test_stats_trace_fn;
+	cfg.trace_ctx = &trace;
+
+	err = cyaml_load_data(test_stats_yaml, YAML_LEN(test_stats_yaml),
+			&cfg, &test_stats_schema,
+			(cyaml_data_t **) &data_tgt, NULL);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	if (trace.begin == 0) {
+		return ttest_fail(&tc, "Trace callback not called");
+	}
+	if (trace.nested || trace.begin != trace.end) {
+		return ttest_fail(&tc, "Unbalanced trace callback calls");
+	}
+
+	return ttest_pass(&tc);
+}
+
+/**
+ * Run the CYAML statistics unit tests.
+ *
+ * \param[in]  rc         The ttest report context.
+ * \param[in]  log_level  CYAML log level.
+ * \param[in]  log_fn     CYAML logging function, or NULL.
+ * \return true iff all unit tests pass, otherwise false.
+ */
+bool stats_tests(
+		ttest_report_ctx_t *rc,
+		cyaml_log_t log_level,
+		cyaml_log_fn_t log_fn)
+{
+	bool pass = true;
+	cyaml_config_t config = {
+		.log_fn = log_fn,
+		.mem_fn = cyaml_mem,
+		.log_level = log_level,
+		.flags = CYAML_CFG_DEFAULT,
+	};
+
+	ttest_heading(rc, "Statistics tests");
+
+	pass &= test_stats_load(rc, &config);
+	pass &= test_stats_save(rc, &config);
+	pass &= test_stats_trace(rc, &config);
+	pass &= test_stats_copy_free(rc, &config);
+
+	return pass;
+}
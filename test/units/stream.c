@@ -0,0 +1,545 @@
+/*
+ * SPDX-License-Identifier: ISC
+ *
+ * Copyright (C) 2026 Michael Drake <tlsa@netsurf-browser.org>
+ */
+
+#include <stdbool.h>
+#include <assert.h>
+#include <string.h>
+#include <stdio.h>
+
+#include <cyaml/cyaml.h>
+
+#include "ttest.h"
+#include "test.h"
+
+/** Helper macro to count bytes of YAML input data. */
+#define YAML_LEN(_y) (sizeof(_y) - 1)
+
+/** Maximum number of documents a test stream may have. */
+#define TEST_STREAM_DOCS_MAX 8
+
+/**
+ * Unit test context data.
+ *
+ * This is also the stream document callback context.
+ */
+typedef struct test_data {
+	cyaml_data_t *docs[TEST_STREAM_DOCS_MAX];
+	unsigned seq_count[TEST_STREAM_DOCS_MAX];
+	unsigned count;
+	/** Number of documents to accept before failing, or zero. */
+	unsigned fail_after;
+	const struct cyaml_config *config;
+	const struct cyaml_schema_value *schema;
+} test_data_t;
+
+/**
+ * Free a document loaded by a test.
+ *
+ * \param[in]  td         The unit test context data.
+ * \param[in]  data       The loaded document.
+ * \param[in]  seq_count  The document's sequence entry count.
+ */
+static void test_stream_free_doc(
+		const struct test_data *td,
+		cyaml_data_t *data,
+		unsigned seq_count)
+{
+	if (td->config->flags & CYAML_CFG_ARENA) {
+		cyaml_arena_free(td->config, data);
+	} else {
+		cyaml_free(td->config, td->schema, data, seq_count);
+	}
+}
+
+/**
+ * Common clean up function to free documents loaded by tests.
+ *
+ * \param[in]  data  The unit test context data.
+ */
+static void cyaml_cleanup(void *data)
+{
+	struct test_data *td = data;
+
+	for (unsigned i = 0; i < td->count; i++) {
+		test_stream_free_doc(td, td->docs[i], td->seq_count[i]);
+	}
+}
+
+/**
+ * Stream document callback, which keeps the documents in the test data.
+ *
+ * \param[in]  ctx        The unit test context data.
+ * \param[in]  data       The loaded document.
+ * \param[in]  seq_count  The document's sequence entry count.
+ * \return \ref CYAML_OK, or an error once `fail_after` documents are given.
+ */
+static cyaml_err_t test_stream_doc(
+		void *ctx,
+		cyaml_data_t *data,
+		unsigned seq_count)
+{
+	struct test_data *td = ctx;
+
+	if (td->count == TEST_STREAM_DOCS_MAX) {
+		test_stream_free_doc(td, data, seq_count);
+		return CYAML_ERR_INTERNAL_ERROR;
+	}
+
+	td->docs[td->count] = data;
+	td->seq_count[td->count] = seq_count;
+	td->count++;
+
+	if (td->fail_after != 0 && td->count == td->fail_after) {
+		return CYAML_ERR_INVALID_VALUE;
+	}
+
+	return CYAML_OK;
+}
+
+/** Test document mapping. */
+struct test_stream_doc {
+	char *name;
+	int value;
+};
+
+/** Test document mapping schema. */
+static const struct cyaml_schema_field test_stream_doc_schema[] = {
+	CYAML_FIELD_STRING_PTR("name", CYAML_FLAG_POINTER,
+			struct test_stream_doc, name, 0, CYAML_UNLIMITED),
+	CYAML_FIELD_INT("value", CYAML_FLAG_DEFAULT,
+			struct test_stream_doc, value),
+	CYAML_FIELD_END
+};
+
+/** Test document top level schema. */
+static const struct cyaml_schema_value test_stream_top_schema = {
+	CYAML_VALUE_MAPPING(CYAML_FLAG_POINTER,
+			struct test_stream_doc, test_stream_doc_schema),
+};
+
+/**
+ * Check a loaded test document.
+ *
+ * \param[in]  data   The loaded document.
+ * \param[in]  name   The expected name.
+ * \param[in]  value  The expected value.
+ * \return true if the document is as expected, false otherwise.
+ */
+static bool test_stream_doc_check(
+		const cyaml_data_t *data,
+		const char *name,
+		int value)
+{
+	const struct test_stream_doc *doc = data;
+
+	return doc != NULL &&
+			strcmp(doc->name, name) == 0 &&
+			doc->value == value;
+}
+
+/**
+ * Test loading a stream of mapping documents.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_stream_load_mappings(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	static const unsigned char yaml[] =
+		"name: one\n"
+		"value: 1\n"
+		"---\n"
+		"name: two\n"
+		"value: 2\n"
+		"---\n"
+		"name: three\n"
+		"value: 3\n";
+	test_data_t td = {
+		.config = config,
+		.schema = &test_stream_top_schema,
+	};
+	cyaml_err_t err;
+	ttest_ctx_t tc;
+
+	if (!ttest_start(report, __func__, cyaml_cleanup, &td, &tc)) {
+		return true;
+	}
+
+	err = cyaml_load_stream_data(yaml, YAML_LEN(yaml), config,
+			&test_stream_top_schema, test_stream_doc, &td);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	if (td.count != 3) {
+		return ttest_fail(&tc, "Incorrect document count: %u",
+				td.count);
+	}
+	if (!test_stream_doc_check(td.docs[0], "one", 1) ||
+	    !test_stream_doc_check(td.docs[1], "two", 2) ||
+	    !test_stream_doc_check(td.docs[2], "three", 3)) {
+		return ttest_fail(&tc, "Incorrect document value");
+	}
+
+	return ttest_pass(&tc);
+}
+
+/**
+ * Test loading a stream of sequence documents.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_stream_load_sequences(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	static const unsigned char yaml[] =
+		"--- [1, 2, 3]\n"
+		"--- []\n"
+		"--- [4, 5]\n";
+	static const struct cyaml_schema_value entry_schema = {
+		CYAML_VALUE_INT(CYAML_FLAG_DEFAULT, int),
+	};
+	static const struct cyaml_schema_value top_schema = {
+		CYAML_VALUE_SEQUENCE(CYAML_FLAG_POINTER, int,
+				&entry_schema, 0, CYAML_UNLIMITED),
+	};
+	test_data_t td = {
+		.config = config,
+		.schema = &top_schema,
+	};
+	cyaml_err_t err;
+	const int *seq;
+	ttest_ctx_t tc;
+
+	if (!ttest_start(report, __func__, cyaml_cleanup, &td, &tc)) {
+		return true;
+	}
+
+	err = cyaml_load_stream_data(yaml, YAML_LEN(yaml), config,
+			&top_schema, test_stream_doc, &td);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	if (td.count != 3) {
+		return ttest_fail(&tc, "Incorrect document count: %u",
+				td.count);
+	}
+	if (td.seq_count[0] != 3 || td.seq_count[1] != 0 ||
+	    td.seq_count[2] != 2) {
+		return ttest_fail(&tc, "Incorrect sequence entry count");
+	}
+
+	seq = td.docs[2];
+	if (seq[0] != 4 || seq[1] != 5) {
+		return ttest_fail(&tc, "Incorrect sequence entry value");
+	}
+
+	return ttest_pass(&tc);
+}
+
+/**
+ * Test that anchors don't apply across documents in a stream.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_stream_load_anchor_scope(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	static const unsigned char yaml[] =
+		"name: &n one\n"
+		"value: 1\n"
+		"---\n"
+		"name: *n\n"
+		"value: 2\n";
+	test_data_t td = {
+		.config = config,
+		.schema = &test_stream_top_schema,
+	};
+	cyaml_err_t err;
+	ttest_ctx_t tc;
+
+	if (!ttest_start(report, __func__, cyaml_cleanup, &td, &tc)) {
+		return true;
+	}
+
+	err = cyaml_load_stream_data(yaml, YAML_LEN(yaml), config,
+			&test_stream_top_schema, test_stream_doc, &td);
+	if (err != CYAML_ERR_INVALID_ALIAS) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	if (td.count != 1) {
+		return ttest_fail(&tc, "Incorrect document count: %u",
+				td.count);
+	}
+	if (!test_stream_doc_check(td.docs[0], "one", 1)) {
+		return ttest_fail(&tc, "Incorrect document value");
+	}
+
+	return ttest_pass(&tc);
+}
+
+/**
+ * Test that a callback error stops loading a stream.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_stream_load_callback_error(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	static const unsigned char yaml[] =
+		"name: one\n"
+		"value: 1\n"
+		"---\n"
+		"name: two\n"
+		"value: 2\n"
+		"---\n"
+		"name: three\n"
+		"value: 3\n";
+	test_data_t td = {
+		.fail_after = 2,
+		.config = config,
+		.schema = &test_stream_top_schema,
+	};
+	cyaml_err_t err;
+	ttest_ctx_t tc;
+
+	if (!ttest_start(report, __func__, cyaml_cleanup, &td, &tc)) {
+		return true;
+	}
+
+	err = cyaml_load_stream_data(yaml, YAML_LEN(yaml), config,
+			&test_stream_top_schema, test_stream_doc, &td);
+	if (err != CYAML_ERR_INVALID_VALUE) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	if (td.count != 2) {
+		return ttest_fail(&tc, "Incorrect document count: %u",
+				td.count);
+	}
+	if (!test_stream_doc_check(td.docs[1], "two", 2)) {
+		return ttest_fail(&tc, "Incorrect document value");
+	}
+
+	return ttest_pass(&tc);
+}
+
+/**
+ * Test loading a stream of documents, with each allocated from an arena.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_stream_load_arena(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	static const unsigned char yaml[] =
+		"name: one\n"
+		"value: 1\n"
+		"---\n"
+		"name: two\n"
+		"value: 2\n";
+	cyaml_config_t cfg = *config;
+	test_data_t td = {
+		.config = &cfg,
+		.schema = &test_stream_top_schema,
+	};
+	cyaml_err_t err;
+	ttest_ctx_t tc;
+
+	cfg.flags |= CYAML_CFG_ARENA;
+
+	if (!ttest_start(report, __func__, cyaml_cleanup, &td, &tc)) {
+		return true;
+	}
+
+	err = cyaml_load_stream_data(yaml, YAML_LEN(yaml), &cfg,
+			&test_stream_top_schema, test_stream_doc, &td);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	if (td.count != 2) {
+		return ttest_fail(&tc, "Incorrect document count: %u",
+				td.count);
+	}
+	if (!test_stream_doc_check(td.docs[0], "one", 1) ||
+	    !test_stream_doc_check(td.docs[1], "two", 2)) {
+		return ttest_fail(&tc, "Incorrect document value");
+	}
+
+	return ttest_pass(&tc);
+}
+
+/**
+ * Test loading a stream from a file.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_stream_load_file(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	struct target_struct {
+		char **cakes;
+		unsigned cakes_count;
+	};
+	static const struct cyaml_schema_value cakes_entry_schema = {
+		CYAML_VALUE_STRING(CYAML_FLAG_POINTER, char, 0, CYAML_UNLIMITED),
+	};
+	static const struct cyaml_schema_field mapping_schema[] = {
+		CYAML_FIELD_IGNORE("animals", CYAML_FLAG_DEFAULT),
+		CYAML_FIELD_SEQUENCE("cakes", CYAML_FLAG_POINTER,
+				struct target_struct, cakes,
+				&cakes_entry_schema, 0, CYAML_UNLIMITED),
+		CYAML_FIELD_END
+	};
+	static const struct cyaml_schema_value top_schema = {
+		CYAML_VALUE_MAPPING(CYAML_FLAG_POINTER,
+				struct target_struct, mapping_schema),
+	};
+	const struct target_struct *doc;
+	test_data_t td = {
+		.config = config,
+		.schema = &top_schema,
+	};
+	cyaml_err_t err;
+	ttest_ctx_t tc;
+
+	if (!ttest_start(report, __func__, cyaml_cleanup, &td, &tc)) {
+		return true;
+	}
+
+	err = cyaml_load_stream_file("test/data/basic.yaml", config,
+			&top_schema, test_stream_doc, &td);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	if (td.count != 1) {
+		return ttest_fail(&tc, "Incorrect document count: %u",
+				td.count);
+	}
+
+	doc = td.docs[0];
+	if (doc == NULL || doc->cakes_count != 5 ||
+	    strcmp(doc->cakes[0], "salted caramel cake") != 0) {
+		return ttest_fail(&tc, "Incorrect document value");
+	}
+
+	return ttest_pass(&tc);
+}
+
+/**
+ * Test loading a stream with bad parameters.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_stream_bad_params(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	static const unsigned char yaml[] =
+		"name: one\n"
+		"value: 1\n";
+	test_data_t td = {
+		.config = config,
+		.schema = &test_stream_top_schema,
+	};
+	cyaml_err_t err;
+	ttest_ctx_t tc;
+
+	if (!ttest_start(report, __func__, cyaml_cleanup, &td, &tc)) {
+		return true;
+	}
+
+	err = cyaml_load_stream_data(yaml, YAML_LEN(yaml), config,
+			&test_stream_top_schema, NULL, &td);
+	if (err != CYAML_ERR_BAD_PARAM_NULL_CALLBACK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	err = cyaml_load_stream_data(yaml, YAML_LEN(yaml), NULL,
+			&test_stream_top_schema, test_stream_doc, &td);
+	if (err != CYAML_ERR_BAD_PARAM_NULL_CONFIG) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	err = cyaml_load_stream_data(yaml, YAML_LEN(yaml), config,
+			NULL, test_stream_doc, &td);
+	if (err != CYAML_ERR_BAD_PARAM_NULL_SCHEMA) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	if (td.count != 0) {
+		return ttest_fail(&tc, "Unexpected document");
+	}
+
+	return ttest_pass(&tc);
+}
+
+/**
+ * Run the CYAML stream loading unit tests.
+ *
+ * \param[in]  rc         The ttest report context.
+ * \param[in]  log_level  CYAML log level.
+ * \param[in]  log_fn     CYAML logging function, or NULL.
+ * \return true iff all unit tests pass, otherwise false.
+ */
+bool stream_tests(
+		ttest_report_ctx_t *rc,
+		cyaml_log_t log_level,
+		cyaml_log_fn_t log_fn)
+{
+	bool pass = true;
+	cyaml_config_t config = {
+		.log_fn = log_fn,
+		.mem_fn = cyaml_mem,
+		.log_level = log_level,
+		.flags = CYAML_CFG_DEFAULT,
+	};
+
+	ttest_heading(rc, "Stream loading tests");
+
+	pass &= test_stream_load_mappings(rc, &config);
+	pass &= test_stream_load_sequences(rc, &config);
+	pass &= test_stream_load_arena(rc, &config);
+	pass &= test_stream_load_file(rc, &config);
+
+	/* Since we expect error logging for these tests,
+	 * suppress log output if required log level is greater
+	 * than \ref CYAML_LOG_INFO.
+	 */
+	if (log_level > CYAML_LOG_INFO) {
+		config.log_fn = NULL;
+	}
+
+	pass &= test_stream_load_anchor_scope(rc, &config);
+	pass &= test_stream_load_callback_error(rc, &config);
+	pass &= test_stream_bad_params(rc, &config);
+
+	return pass;
+}
@@ -0,0 +1,234 @@
+/*
+ * SPDX-License-Identifier: ISC
+ *
+ * Copyright (C) 2026 Michael Drake <tlsa@netsurf-browser.org>
+ */
+
+#include <stdbool.h>
+#include <assert.h>
+#include <string.h>
+#include <stdio.h>
+
+#include <cyaml/cyaml.h>
+
+#include "../../src/strpool.h"
+
+#include "ttest.h"
+#include "test.h"
+
+/** Helper macro to get the length of string string literals. */
+#define SLEN(_s) (sizeof(_s) - 1)
+
+/**
+ * Unit test context data.
+ */
+typedef struct test_data {
+	cyaml_strpool_t *pool;
+	const struct cyaml_config *config;
+} test_data_t;
+
+/**
+ * Common clean up function to free string pools used by tests.
+ *
+ * \param[in]  data  The unit test context data.
+ */
+static void cyaml_cleanup(void *data)
+{
+	struct test_data *td = data;
+
+	cyaml__strpool_free(td->config, td->pool);
+}
+
+/**
+ * Test interning the same string twice.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_strpool_intern_duplicate(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	cyaml_strpool_t pool = { 0 };
+	test_data_t td = {
+		.pool = &pool,
+		.config = config,
+	};
+	uint32_t offset[3];
+	cyaml_err_t err;
+	ttest_ctx_t tc;
+
+	if (!ttest_start(report, __func__, cyaml_cleanup, &td, &tc)) {
+		return true;
+	}
+
+	err = cyaml__strpool_intern(config, &pool, "cat", SLEN("cat"),
+			&offset[0]);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+	err = cyaml__strpool_intern(config, &pool, "dog", SLEN("dog"),
+			&offset[1]);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+	err = cyaml__strpool_intern(config, &pool, "cat", SLEN("cat"),
+			&offset[2]);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	if (offset[0] != offset[2]) {
+		return ttest_fail(&tc, "Duplicate string stored twice");
+	}
+	if (offset[0] == offset[1]) {
+		return ttest_fail(&tc, "Different strings share an offset");
+	}
+	if (pool.count != 2) {
+		return ttest_fail(&tc, "Incorrect string count: %u",
+				pool.count);
+	}
+	if (strcmp(cyaml__strpool_get(&pool, offset[0]), "cat") != 0 ||
+	    strcmp(cyaml__strpool_get(&pool, offset[1]), "dog") != 0) {
+		return ttest_fail(&tc, "Incorrect string value");
+	}
+
+	return ttest_pass(&tc);
+}
+
+/**
+ * Test interning strings that only differ after a '\0' byte.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_strpool_intern_embedded_nul(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	static const char str[] = "a\0b";
+	cyaml_strpool_t pool = { 0 };
+	test_data_t td = {
+		.pool = &pool,
+		.config = config,
+	};
+	uint32_t offset[2];
+	cyaml_err_t err;
+	ttest_ctx_t tc;
+
+	if (!ttest_start(report, __func__, cyaml_cleanup, &td, &tc)) {
+		return true;
+	}
+
+	err = cyaml__strpool_intern(config, &pool, str, SLEN(str),
+			&offset[0]);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+	err = cyaml__strpool_intern(config, &pool, str, 1, &offset[1]);
+	if (err != CYAML_OK) {
+		return ttest_fail(&tc, cyaml_strerror(err));
+	}
+
+	if (offset[0] == offset[1]) {
+		return ttest_fail(&tc, "Different strings share an offset");
+	}
+	if (memcmp(cyaml__strpool_get(&pool, offset[0]), str,
+			sizeof(str)) != 0) {
+		return ttest_fail(&tc, "Incorrect string value");
+	}
+
+	return ttest_pass(&tc);
+}
+
+/**
+ * Test interning enough strings to grow the pool.
+ *
+ * \param[in]  report  The test report context.
+ * \param[in]  config  The CYAML config to use for the test.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_strpool_intern_many(
+		ttest_report_ctx_t *report,
+		const cyaml_config_t *config)
+{
+	enum { COUNT = 1000 };
+	static uint32_t offset[COUNT];
+	cyaml_strpool_t pool = { 0 };
+	test_data_t td = {
+		.pool = &pool,
+		.config = config,
+	};
+	cyaml_err_t err;
+	ttest_ctx_t tc;
+	char str[16];
+
+	if (!ttest_start(report, __func__, cyaml_cleanup, &td, &tc)) {
+		return true;
+	}
+
+	for (unsigned pass = 0; pass < 2; pass++) {
+		for (unsigned i = 0; i < COUNT; i++) {
+			uint32_t o;
+			int len = sprintf(str, "str%u", i);
+
+			err = cyaml__strpool_intern(config, &pool,
+					str, (size_t)len, &o);
+			if (err != CYAML_OK) {
+				return ttest_fail(&tc, cyaml_strerror(err));
+			}
+			if (pass == 0) {
+				offset[i] = o;
+			} else if (offset[i] != o) {
+				return ttest_fail(&tc, "Incorrect offset "
+						"for string %u", i);
+			}
+		}
+	}
+
+	if (pool.count != COUNT) {
+		return ttest_fail(&tc, "Incorrect string count: %u",
+				pool.count);
+	}
+	for (unsigned i = 0; i < COUNT; i++) {
+		sprintf(str, "str%u", i);
+		if (strcmp(cyaml__strpool_get(&pool, offset[i]), str) != 0) {
+			return ttest_fail(&tc, "Incorrect value for "
+					"string %u", i);
+		}
+	}
+
+	return ttest_pass(&tc);
+}
+
+/**
+ * Run the CYAML string pool unit tests.
+ *
+ * \param[in]  rc         The ttest report context.
+ * \param[in]  log_level  CYAML log level.
+ * \param[in]  log_fn     CYAML logging function, or NULL.
+ * \return true iff all unit tests pass, otherwise false.
+ */
+bool strpool_tests(
+		ttest_report_ctx_t *rc,
+		cyaml_log_t log_level,
+		cyaml_log_fn_t log_fn)
+{
+	bool pass = true;
+	cyaml_config_t config = {
+		.log_fn = log_fn,
+		.mem_fn = cyaml_mem,
+		.log_level = log_level,
+		.flags = CYAML_CFG_DEFAULT,
+	};
+
+	ttest_heading(rc, "String pool tests");
+
+	pass &= test_strpool_intern_duplicate(rc, &config);
+	pass &= test_strpool_intern_embedded_nul(rc, &config);
+	pass &= test_strpool_intern_many(rc, &config);
+
+	return pass;
+}
@@ -79,6 +79,21 @@ int main(int argc, char *argv[])
 	pass &= file_tests(&rc, log_level, log_fn);
 	pass &= save_tests(&rc, log_level, log_fn);
 	pass &= copy_tests(&rc, log_level, log_fn);
+	pass &= schema_tests(&rc, log_level, log_fn);
+	pass &= arena_tests(&rc, log_level, log_fn);
+	pass &= strpool_tests(&rc, log_level, log_fn);
+	pass &= number_tests(&rc, log_level, log_fn);
+	pass &= loader_tests(&rc, log_level, log_fn);
+	pass &= stream_tests(&rc, log_level, log_fn);
+	pass &= parallel_tests(&rc, log_level, log_fn);
+	pass &= columnar_tests(&rc, log_level, log_fn);
+	pass &= stats_tests(&rc, log_level, log_fn);
+	pass &= scan_tests(&rc, log_level, log_fn);
+	pass &= lazy_tests(&rc, log_level, log_fn);
+	pass &= binary_tests(&rc, log_level, log_fn);
+	pass &= limits_tests(&rc, log_level, log_fn);
+	pass &= emitter_tests(&rc, log_level, log_fn);
+	pass &= patch_tests(&rc, log_level, log_fn);
 
 	ttest_report(&rc);
 
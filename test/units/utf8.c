@@ -6,6 +6,7 @@
 
 #include <stdbool.h>
 #include <assert.h>
+#include <string.h>
 #include <stdio.h>
 
 #include <cyaml/cyaml.h>
@@ -248,6 +249,58 @@ static bool test_utf8_strcmp_mismatches(
 	return pass;
 }
 
+/**
+ * Test lower casing ASCII strings.
+ *
+ * \param[in]  report  The test report context.
+ * \return true if test passes, false otherwise.
+ */
+static bool test_utf8_ascii_fold(
+		ttest_report_ctx_t *report)
+{
+	char str[21];
+	char out[21];
+	ttest_ctx_t tc;
+
+	if (!ttest_start(report, __func__, NULL, NULL, &tc)) {
+		return true;
+	}
+
+	/* Put every ASCII character at every position of a string long
+	 * enough to be handled in words, and a tail of single bytes. */
+	for (unsigned c = 0; c < 0x80; c++) {
+		for (unsigned i = 0; i < sizeof(str); i++) {
+			unsigned expected;
+
+			memset(str, 'X', sizeof(str));
+			str[i] = (char)c;
+
+			if (!cyaml_utf8_ascii_fold(str, sizeof(str), out)) {
+				return ttest_fail(&tc, "Not ASCII: %u", c);
+			}
+
+			expected = (c >= 'A' && c <= 'Z') ? c + 32 : c;
+			if ((unsigned char)out[i] != expected ||
+			    out[(i + 1) % sizeof(str)] != 'x') {
+				return ttest_fail(&tc, "Bad fold: %u at %u",
+						c, i);
+			}
+		}
+	}
+
+	for (unsigned i = 0; i < sizeof(str); i++) {
+		memset(str, 'X', sizeof(str));
+		str[i] = (char)0xc3;
+
+		if (cyaml_utf8_ascii_fold(str, sizeof(str), out)) {
+			return ttest_fail(&tc, "Non-ASCII not detected at %u",
+					i);
+		}
+	}
+
+	return ttest_pass(&tc);
+}
+
 /**
  * Run the CYAML util unit tests.
  *
@@ -275,6 +328,7 @@ bool utf8_tests(
 	pass &= test_utf8_strcmp_same(rc);
 	pass &= test_utf8_strcmp_matches(rc);
 	pass &= test_utf8_strcmp_mismatches(rc);
+	pass &= test_utf8_ascii_fold(rc);
 
 	return pass;
 }